@@ -47,6 +47,7 @@
 #include "isrran/common/interfaces_common.h"
 #include "isrran/common/mac_pcap.h"
 #include "isrran/common/security.h"
+#include "isrran/common/thread_placement.h"
 #include "isrran/interfaces/enb_command_interface.h"
 #include "isrran/interfaces/enb_metrics_interface.h"
 #include "isrran/interfaces/enb_time_interface.h"
@@ -84,6 +85,7 @@ struct log_args_t {
   int         all_hex_limit;
   int         file_max_size;
   std::string filename;
+  bool        binary;
 };
 
 struct gui_args_t {
@@ -104,6 +106,12 @@ struct general_args_t {
   bool        tracing_enable;
   std::size_t tracing_buffcapacity;
   std::string tracing_filename;
+  bool        trace_ring_enable;
+  uint32_t    trace_ring_size;
+  std::string trace_ring_filename;
+  std::string hugepages;
+  uint32_t    hugepage_arena_mb;
+  uint32_t    hugepage_heap_mb;
   std::string eia_pref_list;
   std::string eea_pref_list;
   uint32_t    max_mac_dl_kos;
@@ -113,15 +121,16 @@ struct general_args_t {
 };
 
 struct all_args_t {
-  enb_args_t        enb;
-  enb_files_t       enb_files;
-  isrran::rf_args_t rf;
-  log_args_t        log;
-  gui_args_t        gui;
-  general_args_t    general;
-  phy_args_t        phy;
-  stack_args_t      stack;
-  gnb_stack_args_t  nr_stack;
+  enb_args_t                      enb;
+  enb_files_t                     enb_files;
+  isrran::rf_args_t               rf;
+  log_args_t                      log;
+  gui_args_t                      gui;
+  general_args_t                  general;
+  phy_args_t                      phy;
+  stack_args_t                    stack;
+  gnb_stack_args_t                nr_stack;
+  isrran::thread_placement_args_t threads;
 };
 
 struct rrc_cfg_t;
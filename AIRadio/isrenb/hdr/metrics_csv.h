@@ -48,6 +48,7 @@ public:
   void stop();
 
 private:
+  void        write_latency_metrics(const isrran::tti_latency_metrics_t& m);
   std::string float_to_string(float f, int digits, bool add_semicolon = true);
 
   float                  metrics_report_period;
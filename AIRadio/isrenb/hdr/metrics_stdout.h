@@ -47,6 +47,7 @@ public:
 
 private:
   void set_metrics_helper(uint32_t num_ue, const mac_metrics_t& mac, const std::vector<phy_metrics_t>& phy, bool is_nr);
+  void print_deadline_misses(const char* rat, const isrran::tti_latency_metrics_t& m);
   std::string float_to_string(float f, int digits, int field_width = 6);
   std::string float_to_eng_string(float f, int digits);
 
@@ -22,9 +22,12 @@
 #ifndef ISRENB_CC_WORKER_H
 #define ISRENB_CC_WORKER_H
 
+#include <atomic>
+#include <condition_variable>
 #include <string.h>
 
 #include "../phy_common.h"
+#include "isrran/common/metrics_counters.h"
 #include "isrran/isrlog/isrlog.h"
 
 #define LOG_EXECTIME
@@ -67,11 +70,23 @@ private:
   constexpr static float PUSCH_RL_SNR_DB_TH = 1.0f;
   constexpr static float PUCCH_RL_CORR_TH   = 0.15f;
 
+  /// PUSCH reception of a single UE. It is prepared and reported to the stack by the worker thread, whereas the
+  /// decoding itself may be carried out by any of the carrier PUSCH decoders
+  struct pusch_job_t {
+    stack_interface_phy_lte::ul_sched_grant_t* ul_grant     = nullptr;
+    isrran_ul_cfg_t                            ul_cfg       = {};
+    isrran_pusch_res_t                         pusch_res    = {};
+    isrran_chest_ul_res_t                      chest_res    = {};
+    bool                                       uci_required = false;
+    bool                                       decoded      = false;
+  };
+
   int  encode_pdsch(stack_interface_phy_lte::dl_sched_grant_t* grants, uint32_t nof_grants);
   int  encode_pmch(stack_interface_phy_lte::dl_sched_grant_t* grant, isrran_mbsfn_cfg_t* mbsfn_cfg);
-  bool decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
-                         isrran_ul_cfg_t&                           ul_cfg,
-                         isrran_pusch_res_t&                        pusch_res);
+  bool prepare_pusch_rnti(pusch_job_t& job);
+  void decode_pusch_job(pusch_job_t& job, isrran_enb_ul_pusch_t* decoder);
+  void run_pusch_jobs(isrran_enb_ul_pusch_t* decoder);
+  void report_pusch_rnti(pusch_job_t& job);
   void decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch);
   int  encode_phich(stack_interface_phy_lte::ul_sched_ack_t* acks, uint32_t nof_acks);
   int  encode_pdcch_dl(stack_interface_phy_lte::dl_sched_grant_t* grants, uint32_t nof_grants);
@@ -95,6 +110,15 @@ private:
 
   isrran_softbuffer_tx_t temp_mbsfn_softbuffer = {};
 
+  // Additional PUSCH decoders, they run in the PHY common job pool while the worker thread decodes with enb_ul
+  std::vector<isrran_enb_ul_pusch_t> pusch_decoders;
+  std::vector<pusch_job_t>           pusch_jobs;
+  std::atomic<uint32_t>              pusch_next_job         = {0};
+  uint32_t                           pusch_nof_jobs         = 0;
+  uint32_t                           pusch_pending_decoders = 0;
+  std::mutex                         pusch_job_mutex;
+  std::condition_variable            pusch_job_cvar;
+
   // Class to store user information
   class ue
   {
@@ -113,8 +137,25 @@ private:
     uint32_t get_rnti() const { return rnti; }
 
   private:
-    uint32_t      rnti    = 0;
-    phy_metrics_t metrics = {};
+    enum class counter {
+      dl_mcs_sum,
+      dl_samples,
+      ul_mcs_sum,
+      pusch_sinr_sum,
+      pusch_rssi_sum,
+      turbo_iters_sum,
+      ul_samples,
+      pucch_rssi_sum,
+      pucch_ni_sum,
+      pucch_sinr_sum,
+      pucch_samples,
+      nof_counters
+    };
+
+    uint32_t rnti = 0;
+    // Updated by the worker owning the user, which is serialized with the worker mutex, so one shard is enough
+    isrran::metrics_counters<counter, 1>        metrics_counters;
+    isrran::metrics_counters_reader<counter, 1> metrics_reader;
   };
 
   // Component carrier index
@@ -123,6 +164,8 @@ private:
   // Each worker keeps a local copy of the user database. Uses more memory but more efficient to manage concurrency
   std::map<uint16_t, ue*> ue_db;
   std::mutex              mutex;
+  // Protects the user database against the metrics thread. The workers do not take it while processing a subframe
+  std::mutex metrics_mutex;
 };
 
 } // namespace lte
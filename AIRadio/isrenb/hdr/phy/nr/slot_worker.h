@@ -22,11 +22,14 @@
 #ifndef ISRENB_NR_SLOT_WORKER_H
 #define ISRENB_NR_SLOT_WORKER_H
 
+#include "isrran/adt/accumulators.h"
 #include "isrran/common/thread_pool.h"
+#include "isrran/common/tti_latency.h"
 #include "isrran/interfaces/gnb_interfaces.h"
 #include "isrran/interfaces/phy_common_interface.h"
 #include "isrran/isrlog/isrlog.h"
 #include "isrran/isrran.h"
+#include <chrono>
 
 namespace isrenb {
 namespace nr {
@@ -35,6 +38,11 @@ namespace nr {
  * The slot_worker class handles the PHY processing, UL and DL procedures associated with 1 slot.
  *
  * A slot_worker object is executed by a thread within the thread_pool.
+ *
+ * If an UL task pool is provided, the worker runs in pipelined mode: the UL processing of slot n is handed over to the
+ * UL pool while the worker thread encodes and transmits DL slot n + FDD_HARQ_DELAY_UL_MS. The worker waits for the UL
+ * stage before being released, so the Rx buffers are not overwritten while they are decoded. In this mode the UL
+ * feedback of slot n may reach the scheduler after the DL scheduling of the slot n + FDD_HARQ_DELAY_UL_MS.
  */
 
 class slot_worker final : public isrran::thread_pool::worker
@@ -68,6 +76,19 @@ public:
     uint32_t                    pusch_max_its    = 10;
     float                       pusch_min_snr_dB = -10.0f;
     double                      srate_hz         = 0.0;
+    isrran::task_thread_pool*   ul_pool          = nullptr; ///< Optional UL task pool, enables pipelined mode
+    isrran::tti_latency*        latency          = nullptr; ///< Optional TTI pipeline latency histograms
+  };
+
+  /**
+   * @brief Processing latency of each stage, measured from the worker start
+   */
+  struct metrics_t {
+    uint32_t nof_slots = 0;
+    float    ul_avg_us = 0.0f;
+    float    ul_max_us = 0.0f;
+    float    dl_avg_us = 0.0f;
+    float    dl_max_us = 0.0f;
   };
 
   slot_worker(isrran::phy_common_interface& common_,
@@ -88,6 +109,9 @@ public:
   uint32_t get_buffer_len();
   void     set_context(const isrran::phy_common_interface::worker_context_t& w_ctx);
 
+  /* Functions used by the metrics thread, they reset the measurements */
+  void get_metrics(metrics_t& m);
+
 private:
   /**
    * @brief Inherited from thread_pool::worker. Function called every slot to run the DL/UL processing
@@ -106,6 +130,17 @@ private:
    */
   bool work_dl();
 
+  /**
+   * @brief Pipelined mode, runs the UL processing in the UL pool and waits for it after transmitting the DL slot
+   */
+  void work_pipelined(isrran::rf_buffer_t& tx_rf_buffer);
+
+  /**
+   * @brief Accumulates the latency of a stage, in microseconds since the worker start, and records the stage
+   * completion into the TTI latency histograms
+   */
+  void save_stage_latency(bool is_ul);
+
   isrran::phy_common_interface& common;
   stack_interface_phy_nr&       stack;
   isrlog::basic_logger&         logger;
@@ -123,6 +158,21 @@ private:
   std::vector<cf_t*>                             tx_buffer; ///< Baseband transmit buffers
   std::vector<cf_t*>                             rx_buffer; ///< Baseband receive buffers
   std::mutex mutex; ///< Protect concurrent access from workers (and main process that inits the class)
+
+  // Pipelined mode
+  isrran::task_thread_pool* ul_pool    = nullptr;
+  bool                      ul_pending = false;
+  std::mutex                ul_mutex;
+  std::condition_variable   ul_cvar;
+
+  // Stage latency metrics
+  std::chrono::steady_clock::time_point start_time = {};
+  std::mutex                            metrics_mutex;
+  isrran::rolling_average<float>        ul_latency_us;
+  isrran::rolling_average<float>        dl_latency_us;
+  float                                 ul_max_latency_us = 0.0f;
+  float                                 dl_max_latency_us = 0.0f;
+  isrran::tti_latency*                  latency           = nullptr;
 };
 
 } // namespace nr
@@ -92,6 +92,7 @@ private:
   isrlog::sink&                              log_sink;
   isrran::thread_pool                        pool;
   std::vector<std::unique_ptr<slot_worker> > workers;
+  std::unique_ptr<isrran::task_thread_pool>  ul_pool; ///< UL stage threads, only created in pipelined mode
   prach_worker_pool                          prach;
   uint32_t                                   current_tti = 0; ///< Current TTI, read and write from same thread
   isrlog::basic_logger&                      logger;
@@ -104,10 +105,12 @@ public:
     double                 srate_hz          = 0.0;
     uint32_t               nof_phy_threads   = 3;
     uint32_t               nof_prach_workers = 0;
+    uint32_t               nof_ul_threads    = 0; ///< Enables pipelined UL/DL processing if not zero
     uint32_t               prio              = 52;
     uint32_t               pusch_max_its     = 10;
     float                  pusch_min_snr_dB  = -10;
     isrran::phy_log_args_t log               = {};
+    isrran::tti_latency*   latency           = nullptr; ///< Optional TTI pipeline latency histograms
   };
   slot_worker* operator[](std::size_t pos) { return workers.at(pos).get(); }
 
@@ -121,6 +124,7 @@ public:
   void         start_worker(slot_worker* w);
   void         stop();
   int          set_common_cfg(const phy_interface_rrc_nr::common_cfg_t& common_cfg);
+  void         get_metrics(slot_worker::metrics_t& metrics);
 };
 
 } // namespace nr
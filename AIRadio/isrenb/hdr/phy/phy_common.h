@@ -29,6 +29,7 @@
 #include "isrran/common/standard_streams.h"
 #include "isrran/common/thread_pool.h"
 #include "isrran/common/threads.h"
+#include "isrran/common/tti_latency.h"
 #include "isrran/interfaces/enb_metrics_interface.h"
 #include "isrran/interfaces/phy_common_interface.h"
 #include "isrran/interfaces/radio_interfaces.h"
@@ -71,6 +72,12 @@ public:
   // Common objects
   phy_args_t params = {};
 
+  /**
+   * Task pool shared by all LTE carriers for decoding the PUSCH of several UEs of the same subframe in parallel. It is
+   * only created when nof_pusch_threads is not zero
+   */
+  std::unique_ptr<isrran::task_thread_pool> pusch_job_pool;
+
   uint32_t get_nof_carriers_lte() { return static_cast<uint32_t>(cell_list_lte.size()); }
   uint32_t get_nof_carriers_nr() { return static_cast<uint32_t>(cell_list_nr.size()); }
   uint32_t get_nof_carriers() { return static_cast<uint32_t>(cell_list_lte.size() + cell_list_nr.size()); }
@@ -181,6 +188,16 @@ public:
 
     return ret;
   }
+  uint32_t get_nof_pusch_decoders(uint32_t cc_idx)
+  {
+    uint32_t ret = 1;
+
+    if (pusch_job_pool != nullptr and cc_idx < cell_list_lte.size()) {
+      ret = std::max(1u, cell_list_lte[cc_idx].nof_pusch_decoders);
+    }
+
+    return ret;
+  }
   isrran_cell_t get_cell(uint32_t cc_idx)
   {
     isrran_cell_t c = {};
@@ -288,6 +305,13 @@ public:
    */
   phy_ue_db ue_db;
 
+  /**
+   * TTI pipeline latency of each RAT, measured from the start of the RF receive of the TTI samples. In real time the
+   * receive starts when the subframe starts on air, so the deadline is the transmission in TTI + FDD_HARQ_DELAY_UL_MS.
+   */
+  isrran::tti_latency lte_latency{FDD_HARQ_DELAY_UL_MS * 1000};
+  isrran::tti_latency nr_latency{FDD_HARQ_DELAY_UL_MS * 1000};
+
   void configure_mbsfn(isrran::phy_cfg_mbsfn_t* cfg);
   void build_mch_table();
   void build_mcch_table();
@@ -42,6 +42,7 @@ struct phy_cell_cfg_t {
   uint32_t      num_ra_preambles;
   float         gain_db;
   bool          dl_measure;
+  uint32_t      nof_pusch_decoders;
 };
 
 typedef std::vector<phy_cell_cfg_t> phy_cell_cfg_list_t;
@@ -63,6 +64,7 @@ struct phy_args_t {
   float                   max_prach_offset_us = 10;
   uint32_t                pusch_max_its       = 10;
   uint32_t                nr_pusch_max_its    = 10;
+  uint32_t                nr_nof_ul_threads   = 0;
   bool                    pusch_8bit_decoder  = false;
   float                   tx_amplitude        = 1.0f;
   uint32_t                nof_phy_threads     = 1;
@@ -73,6 +75,7 @@ struct phy_args_t {
   bool                    pusch_meas_ta       = true;
   bool                    pucch_meas_ta       = true;
   uint32_t                nof_prach_threads   = 1;
+  uint32_t                nof_pusch_threads   = 0;
   bool                    extended_cp         = false;
   isrran::channel::args_t dl_channel_args;
   isrran::channel::args_t ul_channel_args;
@@ -22,6 +22,7 @@
 #ifndef ISRENB_PHY_METRICS_H
 #define ISRENB_PHY_METRICS_H
 
+#include "isrran/common/tti_latency.h"
 #include <limits>
 
 namespace isrenb {
@@ -53,6 +54,12 @@ struct phy_metrics_t {
   ul_metrics_t ul;
 };
 
+// TTI pipeline latency per RAT
+struct phy_latency_metrics_t {
+  isrran::tti_latency_metrics_t lte;
+  isrran::tti_latency_metrics_t nr;
+};
+
 } // namespace isrenb
 
 #endif // ISRENB_PHY_METRICS_H
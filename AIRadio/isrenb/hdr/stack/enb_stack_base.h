@@ -33,6 +33,9 @@ namespace isrenb {
 typedef struct {
   bool        enable;
   std::string filename;
+  bool        pcapng;
+  uint32_t    rotate_size_mb;
+  uint32_t    rotate_period_s;
 } pcap_args_t;
 
 typedef struct {
@@ -71,6 +74,7 @@ typedef struct {
 typedef struct {
   uint32_t         sync_queue_size; // Max allowed difference between PHY and Stack clocks (in TTI)
   uint32_t         gtpu_indirect_tunnel_timeout_msec;
+  uint32_t         gtpu_tx_batch_size; // Max UL G-PDUs sent with one sendmmsg call, flushed every TTI (1 to disable)
   mac_args_t       mac;
   s1ap_args_t      s1ap;
   pcap_args_t      mac_pcap;
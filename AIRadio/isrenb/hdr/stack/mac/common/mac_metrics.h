@@ -22,6 +22,7 @@
 #ifndef ISRENB_MAC_METRICS_H
 #define ISRENB_MAC_METRICS_H
 
+#include "isrran/common/metrics_counters.h"
 #include <cstdint>
 #include <vector>
 
@@ -58,6 +59,56 @@ struct mac_ue_metrics_t {
   float ul_mcs;
   int   ul_mcs_samples;
 };
+
+/// Counters of the MAC metrics of a user, updated by the MAC and PHY workers.
+enum class mac_ue_counter {
+  nof_tti,
+  tx_pkts,
+  tx_errors,
+  tx_bits,
+  rx_pkts,
+  rx_errors,
+  rx_bits,
+  phr_sum,
+  phr_samples,
+  dl_cqi_sum,
+  dl_cqi_samples,
+  dl_pmi_sum,
+  dl_pmi_samples,
+  dl_mcs_sum,
+  dl_mcs_samples,
+  ul_mcs_sum,
+  ul_mcs_samples,
+  pucch_sinr_sum,
+  pucch_sinr_samples,
+  pusch_sinr_sum,
+  pusch_sinr_samples,
+  nof_counters
+};
+
+using mac_ue_counters_t        = isrran::metrics_counters<mac_ue_counter>;
+using mac_ue_counters_reader_t = isrran::metrics_counters_reader<mac_ue_counter>;
+
+/// Fills the metrics of a user kept in counters with the increments of the last period.
+inline void read_mac_ue_counters(const mac_ue_counters_reader_t& counters, mac_ue_metrics_t& metrics)
+{
+  metrics.nof_tti        = counters.get(mac_ue_counter::nof_tti);
+  metrics.tx_pkts        = counters.get(mac_ue_counter::tx_pkts);
+  metrics.tx_errors      = counters.get(mac_ue_counter::tx_errors);
+  metrics.tx_brate       = counters.get(mac_ue_counter::tx_bits);
+  metrics.rx_pkts        = counters.get(mac_ue_counter::rx_pkts);
+  metrics.rx_errors      = counters.get(mac_ue_counter::rx_errors);
+  metrics.rx_brate       = counters.get(mac_ue_counter::rx_bits);
+  metrics.phr            = counters.average(mac_ue_counter::phr_sum, mac_ue_counter::phr_samples);
+  metrics.dl_cqi         = counters.average(mac_ue_counter::dl_cqi_sum, mac_ue_counter::dl_cqi_samples);
+  metrics.dl_pmi         = counters.average(mac_ue_counter::dl_pmi_sum, mac_ue_counter::dl_pmi_samples);
+  metrics.dl_mcs         = counters.average(mac_ue_counter::dl_mcs_sum, mac_ue_counter::dl_mcs_samples);
+  metrics.dl_mcs_samples = counters.get(mac_ue_counter::dl_mcs_samples);
+  metrics.ul_mcs         = counters.average(mac_ue_counter::ul_mcs_sum, mac_ue_counter::ul_mcs_samples);
+  metrics.ul_mcs_samples = counters.get(mac_ue_counter::ul_mcs_samples);
+  metrics.pucch_sinr     = counters.average(mac_ue_counter::pucch_sinr_sum, mac_ue_counter::pucch_sinr_samples);
+  metrics.pusch_sinr     = counters.average(mac_ue_counter::pusch_sinr_sum, mac_ue_counter::pusch_sinr_samples);
+}
 /// MAC misc information for each cc.
 struct mac_cc_info_t {
   /// PCI value.
@@ -66,12 +117,26 @@ struct mac_cc_info_t {
   uint32_t cc_rach_counter;
 };
 
+/// Occupancy of the pool of UL softbuffer code blocks.
+struct mac_softbuffer_pool_metrics_t {
+  /// Code blocks allocated by the pool.
+  uint32_t nof_blocks;
+  /// Code blocks attached to a softbuffer.
+  uint32_t nof_used;
+  /// Maximum number of code blocks attached at the same time.
+  uint32_t peak_used;
+  /// Memory allocated by the pool in bytes.
+  uint64_t nof_bytes;
+};
+
 /// Main MAC metrics.
 struct mac_metrics_t {
   /// Per CC info.
   std::vector<mac_cc_info_t> cc_info;
   /// Per UE MAC metrics.
   std::vector<mac_ue_metrics_t> ues;
+  /// UL softbuffer pool, when the softbuffers take their code blocks from it.
+  mac_softbuffer_pool_metrics_t softbuffer_pool = {};
 };
 
 } // namespace isrenb
@@ -57,7 +57,11 @@ struct ue_cc_softbuffers {
   cc_softbuffer_tx_list_t softbuffer_tx_list;
   cc_softbuffer_rx_list_t softbuffer_rx_list;
 
-  ue_cc_softbuffers(uint32_t nof_prb, uint32_t nof_tx_harq_proc_, uint32_t nof_rx_harq_proc_);
+  ue_cc_softbuffers(uint32_t nof_prb,
+                    uint32_t nof_tx_harq_proc_,
+                    uint32_t nof_rx_harq_proc_,
+                    bool     rx_on_demand = false,
+                    bool     rx_llr_8bit  = false);
   ue_cc_softbuffers(ue_cc_softbuffers&&) noexcept = default;
   ~ue_cc_softbuffers();
   void clear();
@@ -176,15 +180,15 @@ public:
   isrran::unique_byte_buffer_t release_pdu(uint32_t tti, uint32_t enb_cc_idx);
   void                         clear_old_buffers(uint32_t tti);
 
-  std::mutex metrics_mutex = {};
-  void       metrics_read(mac_ue_metrics_t* metrics_);
-  void       metrics_rx(bool crc, uint32_t tbs);
-  void       metrics_tx(bool crc, uint32_t tbs);
-  void       metrics_phr(float phr);
-  void       metrics_dl_ri(uint32_t dl_cqi);
-  void       metrics_dl_pmi(uint32_t dl_cqi);
-  void       metrics_dl_cqi(uint32_t dl_cqi);
-  void       metrics_cnt();
+  /// Metrics are updated by the workers without locking, and read incrementally by the metrics thread.
+  void metrics_read(mac_ue_metrics_t* metrics_);
+  void metrics_rx(bool crc, uint32_t tbs);
+  void metrics_tx(bool crc, uint32_t tbs);
+  void metrics_phr(float phr);
+  void metrics_dl_ri(uint32_t dl_cqi);
+  void metrics_dl_pmi(uint32_t dl_cqi);
+  void metrics_dl_cqi(uint32_t dl_cqi);
+  void metrics_cnt();
 
   uint32_t read_pdu(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes) final;
 
@@ -208,11 +212,10 @@ private:
 
   std::atomic<bool> active_state{true};
 
-  uint32_t         phr_counter    = 0;
-  uint32_t         dl_cqi_counter = 0;
-  uint32_t         dl_ri_counter  = 0;
-  uint32_t         dl_pmi_counter = 0;
-  mac_ue_metrics_t ue_metrics     = {};
+  mac_ue_counters_t        metrics_counters;
+  mac_ue_counters_reader_t metrics_reader;
+  /// Moving average of the reported RI, restarted by every metrics read.
+  std::atomic<float> dl_ri_avg{0.0f};
 
   isrran::obj_pool_itf<ue_cc_softbuffers>* softbuffer_pool = nullptr;
 
@@ -25,6 +25,7 @@
 #include "rrc_bearer_cfg.h"
 #include "rrc_cell_cfg.h"
 #include "rrc_metrics.h"
+#include "rrc_msg_cache.h"
 #include "isrenb/hdr/common/common_enb.h"
 #include "isrenb/hdr/common/rnti_pool.h"
 #include "isrran/adt/circular_buffer.h"
@@ -184,6 +185,7 @@ private:
 
   // derived params
   std::unique_ptr<enb_cell_common_list> cell_common_list;
+  rrc_msg_cache                         msg_cache;
 
   // state
   std::unique_ptr<freq_res_common_list>    cell_res_list;
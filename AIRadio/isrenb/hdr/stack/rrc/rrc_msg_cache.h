@@ -0,0 +1,61 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRRAN_RRC_MSG_CACHE_H
+#define ISRRAN_RRC_MSG_CACHE_H
+
+#include "isrran/asn1/asn1_msg_template.h"
+#include "isrran/asn1/rrc/dl_ccch_msg.h"
+#include "isrran/isrlog/isrlog.h"
+
+namespace isrenb {
+
+/**
+ * Cache of pre-encoded RRC messages. Each message is encoded once for the current eNB configuration, and the
+ * encoding of every UE is obtained by patching its dedicated fields (transaction ID, SR and CQI resources) into a
+ * copy of it, instead of packing the whole ASN.1 structure again.
+ */
+class rrc_msg_cache
+{
+public:
+  rrc_msg_cache() : logger(isrlog::fetch_basic_logger("RRC")) {}
+
+  /// Drops the encoded messages. To be called whenever the eNB configuration they derive from changes
+  void invalidate();
+
+  /// Encodes a RRCConnectionSetup into pdu. If it returns false, the message has to be packed instead. With sanity
+  /// checks enabled, the encoding is compared with the packed message, and the cache is disabled on mismatch
+  bool encode_con_setup(const asn1::rrc::dl_ccch_msg_s& msg, isrran::byte_buffer_t& pdu);
+
+private:
+  using con_setup_template = asn1::encoded_msg_template<asn1::rrc::dl_ccch_msg_s>;
+
+  isrlog::basic_logger& logger;
+
+  uint32_t           cfg_version       = 0;
+  uint32_t           con_setup_version = std::numeric_limits<uint32_t>::max();
+  bool               con_setup_cqi     = false;
+  con_setup_template con_setup;
+};
+
+} // namespace isrenb
+
+#endif // ISRRAN_RRC_MSG_CACHE_H
@@ -26,13 +26,16 @@
 #include "isrran/adt/span.h"
 #include "isrran/asn1/rrc/paging.h"
 #include "isrran/common/tti_point.h"
+#include <atomic>
 
 namespace isrenb {
 
 /**
  * Class that handles the buffering of paging records and encoding of PCCH messages.
- * It's thread-safe, and, assuming that threads contend for pending PCCH messages using different subframe indexes,
- * should rarely blocking on mutexes
+ * The pending PCCH messages are kept in a wheel indexed by paging occasion subframe and paging frame. Paging records
+ * are staged in their (PF, PO) slot without locking, so the S1AP never contends with the scheduler. The scheduler
+ * appends the staged records to the encoded PCCH of the next paging frame, so that the message is ready before the
+ * paging occasion. Threads reading the PCCH messages of different subframe indexes do not block each other.
  */
 class paging_manager
 {
@@ -45,12 +48,26 @@ public:
     logger(isrlog::fetch_basic_logger("RRC"))
   {
     for (subframe_info& sf_obj : sf_pending_pcch) {
-      sf_obj.pending_paging.resize(T);
+      sf_obj.pending_paging = std::vector<pcch_info>(T);
       for (pcch_info& pcch : sf_obj.pending_paging) {
         pcch.pcch_msg.msg.set_c1().paging().paging_record_list_present = true;
       }
     }
   }
+  paging_manager(const paging_manager&) = delete;
+  paging_manager& operator=(const paging_manager&) = delete;
+  ~paging_manager()
+  {
+    for (subframe_info& sf_obj : sf_pending_pcch) {
+      for (pcch_info& pcch : sf_obj.pending_paging) {
+        staged_record* node = pcch.staged.exchange(nullptr, std::memory_order_acquire);
+        while (node != nullptr) {
+          std::unique_ptr<staged_record> rec(node);
+          node = node->next;
+        }
+      }
+    }
+  }
 
   /// add new IMSI paging record
   bool add_imsi_paging(uint32_t ueid, isrran::const_byte_span imsi);
@@ -74,23 +91,42 @@ public:
   bool read_pdu_pcch(tti_point tti_tx_dl, const Callable& callable);
 
 private:
+  /// Paging record added by the S1AP and not yet encoded in the PCCH of its slot
+  struct staged_record {
+    asn1::rrc::paging_record_s record;
+    uint32_t                   ueid = 0;
+    staged_record*             next = nullptr;
+  };
   struct pcch_info {
     tti_point                    tti_tx_dl;
     asn1::rrc::pcch_msg_s        pcch_msg;
     isrran::unique_byte_buffer_t pdu;
+    uint32_t                     nof_bits = 0; ///< Encoded bits of the PCCH, excluding the final padding
+
+    /// Records staged by the S1AP, most recent first
+    std::atomic<staged_record*> staged{nullptr};
+    /// Records accepted for the next transmission of this slot, either staged or encoded
+    std::atomic<uint32_t> nof_records{0};
 
     bool is_tx() const { return tti_tx_dl.is_valid(); }
     bool empty() const { return pdu == nullptr; }
     void clear()
     {
+      nof_records.fetch_sub(pcch_msg.msg.c1().paging().paging_record_list.size(), std::memory_order_relaxed);
       tti_tx_dl = tti_point();
       pcch_msg.msg.c1().paging().paging_record_list.clear();
       pdu.reset();
+      nof_bits = 0;
     }
   };
   const static size_t nof_paging_subframes = 4;
+  /// The PCCH-MessageType choice (1 bit) and the presence bitmap of Paging (4 bits) precede the record list size
+  const static uint32_t nof_records_bit_offset = 5;
+  const static uint32_t nof_records_bits       = 4;
 
   bool add_paging_record(uint32_t ueid, const asn1::rrc::paging_record_s& paging_record);
+  void encode_staged_records(pcch_info& pending_pcch);
+  void encode_paging_record(pcch_info& pending_pcch, uint32_t ueid, const asn1::rrc::paging_record_s& paging_record);
 
   static int get_sf_idx_key(uint32_t sf_idx)
   {
@@ -162,41 +198,87 @@ bool paging_manager::add_paging_record(uint32_t ueid, const asn1::rrc::paging_re
   }
   size_t sf_key = static_cast<size_t>(get_sf_idx_key(sf_idx));
 
-  subframe_info&              locked_sf = sf_pending_pcch[sf_key];
-  std::lock_guard<std::mutex> lock(locked_sf.mutex);
-
   size_t     sfn_cycle_idx = ((size_t)T / (size_t)N) * (size_t)(ueid % N);
-  pcch_info& pending_pcch  = locked_sf.pending_paging[sfn_cycle_idx];
-  auto&      record_list   = pending_pcch.pcch_msg.msg.c1().paging().paging_record_list;
+  pcch_info& pending_pcch  = sf_pending_pcch[sf_key].pending_paging[sfn_cycle_idx];
 
-  if (record_list.size() >= ASN1_RRC_MAX_PAGE_REC) {
+  if (pending_pcch.nof_records.fetch_add(1, std::memory_order_relaxed) >= ASN1_RRC_MAX_PAGE_REC) {
+    pending_pcch.nof_records.fetch_sub(1, std::memory_order_relaxed);
     logger.warning("Failed to add new paging record for ueid=%d. Cause: no paging record space left.", ueid);
     return false;
   }
-  if (pending_pcch.is_tx()) {
-    logger.error("Adding Paging records to ueid=%d PCCH that has been already sent but not cleared.", ueid);
-    pending_pcch.clear();
+
+  // Stage the record in the slot of its paging occasion. It is encoded by the scheduler
+  std::unique_ptr<staged_record> node(new staged_record);
+  node->record = paging_record;
+  node->ueid   = ueid;
+  node->next   = pending_pcch.staged.load(std::memory_order_relaxed);
+  while (not pending_pcch.staged.compare_exchange_weak(
+      node->next, node.get(), std::memory_order_release, std::memory_order_relaxed)) {
+  }
+  node.release();
+  return true;
+}
+
+/// Encodes the staged records of a PCCH that has not been transmitted yet. Called with the subframe mutex locked
+void paging_manager::encode_staged_records(pcch_info& pending_pcch)
+{
+  if (pending_pcch.is_tx() or pending_pcch.staged.load(std::memory_order_relaxed) == nullptr) {
+    return;
+  }
+
+  // Take all the staged records and restore their arrival order
+  staged_record* node = pending_pcch.staged.exchange(nullptr, std::memory_order_acquire);
+  staged_record* head = nullptr;
+  while (node != nullptr) {
+    staged_record* next = node->next;
+    node->next          = head;
+    head                = node;
+    node                = next;
   }
 
+  while (head != nullptr) {
+    std::unique_ptr<staged_record> rec(head);
+    head = head->next;
+    encode_paging_record(pending_pcch, rec->ueid, rec->record);
+  }
+}
+
+void paging_manager::encode_paging_record(pcch_info&                        pending_pcch,
+                                          uint32_t                          ueid,
+                                          const asn1::rrc::paging_record_s& paging_record)
+{
+  auto& record_list = pending_pcch.pcch_msg.msg.c1().paging().paging_record_list;
+
   if (pending_pcch.pdu == nullptr) {
     pending_pcch.pdu = isrran::make_byte_buffer();
     if (pending_pcch.pdu == nullptr) {
       logger.warning("Failed to add new paging record for ueid=%d. Cause: No buffers available", ueid);
-      return false;
+      pending_pcch.nof_records.fetch_sub(1, std::memory_order_relaxed);
+      return;
     }
   }
 
   record_list.push_back(paging_record);
 
+  // The record list is the last field of the PCCH. Further records are appended to the encoded message, which
+  // otherwise only changes in the list size
   asn1::bit_ref bref(pending_pcch.pdu->msg, pending_pcch.pdu->get_tailroom());
-  if (pending_pcch.pcch_msg.pack(bref) == asn1::ISRASN_ERROR_ENCODE_FAIL) {
+  if (record_list.size() > 1) {
+    bref.advance_bits(pending_pcch.nof_bits);
+    if (paging_record.pack(bref) == asn1::ISRASN_ERROR_ENCODE_FAIL) {
+      logger.error("Failed to pack PCCH message");
+      pending_pcch.clear();
+      return;
+    }
+    asn1::patch_bits(pending_pcch.pdu->msg, nof_records_bit_offset, record_list.size() - 1, nof_records_bits);
+  } else if (pending_pcch.pcch_msg.msg.pack(bref) == asn1::ISRASN_ERROR_ENCODE_FAIL) {
     logger.error("Failed to pack PCCH message");
     pending_pcch.clear();
-    return false;
+    return;
   }
+  pending_pcch.nof_bits = (uint32_t)bref.distance();
+  bref.align_bytes_zero();
   pending_pcch.pdu->N_bytes = (uint32_t)bref.distance_bytes();
-
-  return true;
 }
 
 size_t paging_manager::pending_pcch_bytes(tti_point tti_tx_dl)
@@ -220,7 +302,12 @@ size_t paging_manager::pending_pcch_bytes(tti_point tti_tx_dl)
     locked_sf.transmitted_pcch.pop_front();
   }
 
-  const pcch_info& pending_pcch = locked_sf.pending_paging[tti_tx_dl.sfn() % T];
+  // Encode the records that arrived since the previous frame, and those of the next paging frame ahead of its
+  // paging occasion
+  pcch_info& pending_pcch = locked_sf.pending_paging[tti_tx_dl.sfn() % T];
+  encode_staged_records(pending_pcch);
+  encode_staged_records(locked_sf.pending_paging[(tti_tx_dl.sfn() + 1) % T]);
+
   if (pending_pcch.empty()) {
     return 0;
   }
@@ -24,6 +24,7 @@
 #include <string.h>
 
 #include "isrenb/hdr/common/common_enb.h"
+#include "isrenb/hdr/stack/upper/gtpu_metrics.h"
 #include "isrran/adt/bounded_vector.h"
 #include "isrran/adt/circular_map.h"
 #include "isrran/common/buffer_pool.h"
@@ -149,6 +150,8 @@ public:
 
   int  init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_);
   void stop();
+  void tti_clock();
+  void get_metrics(gtpu_metrics_t& m);
 
   // gtpu_interface_rrc
   isrran::expected<uint32_t> add_bearer(uint16_t            rnti,
@@ -167,6 +170,7 @@ public:
 
   // stack interface
   void handle_gtpu_s1u_rx_packet(isrran::unique_byte_buffer_t pdu, const sockaddr_in& addr);
+  void handle_gtpu_s1u_rx_burst(isrran::recvfrom_burst_t& burst);
   void handle_gtpu_m1u_rx_packet(isrran::unique_byte_buffer_t pdu, const sockaddr_in& addr);
 
 private:
@@ -219,16 +223,65 @@ private:
   // Socket file descriptor
   int fd = -1;
 
-  void send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, isrran::unique_byte_buffer_t pdu, int pdcp_sn = -1);
+  // DL SDUs of a received S1-U burst, grouped by bearer
+  struct dl_sdu_group {
+    uint16_t                                  rnti          = ISRRAN_INVALID_RNTI;
+    uint32_t                                  eps_bearer_id = 0;
+    std::vector<isrran::unique_byte_buffer_t> sdus;
+    std::vector<int>                          pdcp_sns;
+  };
+  std::vector<dl_sdu_group> dl_sdu_groups;
+  size_t                    nof_dl_sdu_groups = 0;
+
+  // UL G-PDUs waiting to be sent with one sendmmsg call
+  struct tx_pdu_t {
+    isrran::unique_byte_buffer_t pdu;
+    sockaddr_in                  addr;
+  };
+  // Control message with the UDP GSO segment size
+  struct gso_cmsg_t {
+    alignas(cmsghdr) char buf[CMSG_SPACE(sizeof(uint16_t))];
+  };
+  static const uint32_t                   max_gso_segments = 64;
+  static const uint32_t                   max_gso_bytes    = 65000;
+  static const uint32_t                   udp_ip_hdr_size  = 28;
+  std::vector<tx_pdu_t>                   tx_batch;
+  std::vector<mmsghdr>                    tx_msgs;
+  std::vector<iovec>                      tx_iovs;
+  std::vector<gso_cmsg_t>                 tx_cmsgs;
+  bool                                    tx_gso = true;
+  std::unordered_map<in_addr_t, uint32_t> tx_path_mtu; ///< Path MTU towards each peer, 0 if it is unknown
+  gtpu_metrics_t                          metrics;
+
+  void     send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, isrran::unique_byte_buffer_t pdu, int pdcp_sn = -1);
+  void     send_pdu(isrran::unique_byte_buffer_t pdu, const sockaddr_in& addr);
+  void     flush_tx_batch();
+  size_t   send_tx_pdus(size_t first_pdu);
+  size_t   send_tx_segments(const msghdr& msg);
+  uint32_t get_path_mtu(in_addr_t addr);
 
   void echo_response(in_addr_t addr, in_port_t port, uint16_t seq);
   void error_indication(in_addr_t addr, in_port_t port, uint32_t err_teid);
   bool send_end_marker(uint32_t teidin);
 
+  const gtpu_tunnel* read_s1u_header(isrran::byte_buffer_t* pdu,
+                                     const sockaddr_in&     addr,
+                                     isrran::gtpu_header_t& header,
+                                     const gtpu_tunnel*     last_tunnel = nullptr);
+  void               handle_s1u_msg(const isrran::gtpu_header_t& header,
+                                    const gtpu_tunnel&           rx_tunnel,
+                                    isrran::unique_byte_buffer_t pdu);
+
   void handle_end_marker(const gtpu_tunnel& rx_tunnel);
+  bool read_data_pdu(const isrran::gtpu_header_t&  header,
+                     const gtpu_tunnel&            rx_tunnel,
+                     isrran::unique_byte_buffer_t& pdu,
+                     uint32_t&                     pdcp_sn);
   void handle_msg_data_pdu(const isrran::gtpu_header_t& header,
                            const gtpu_tunnel&           rx_tunnel,
                            isrran::unique_byte_buffer_t pdu);
+  void group_dl_sdu(const gtpu_tunnel& rx_tunnel, isrran::unique_byte_buffer_t sdu, uint32_t pdcp_sn);
+  void flush_dl_sdu_groups();
 
   int create_dl_fwd_tunnel(uint32_t rx_teid_in, uint32_t tx_teid_in);
 
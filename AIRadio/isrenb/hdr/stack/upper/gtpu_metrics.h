@@ -0,0 +1,40 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRENB_GTPU_METRICS_H
+#define ISRENB_GTPU_METRICS_H
+
+#include <stdint.h>
+
+namespace isrenb {
+
+/// UL transmit counters of the GTP-U entity since the previous metrics report
+struct gtpu_metrics_t {
+  uint64_t tx_pdus      = 0; ///< G-PDUs sent to the SGW/UPF
+  uint64_t tx_batches   = 0; ///< Non-empty transmit batches flushed
+  uint64_t tx_syscalls  = 0; ///< sendto/sendmmsg calls
+  uint64_t tx_gso_pdus  = 0; ///< G-PDUs sent as UDP GSO segments
+  uint32_t max_tx_batch = 0; ///< Largest transmit batch
+};
+
+} // namespace isrenb
+
+#endif // ISRENB_GTPU_METRICS_H
@@ -61,6 +61,21 @@ public:
       logger.warning("Can't deliver SDU for EPS bearer %d. Dropping it.", eps_bearer_id);
     }
   }
+  void write_sdus(uint16_t                                   rnti,
+                  uint32_t                                   eps_bearer_id,
+                  isrran::span<isrran::unique_byte_buffer_t> sdus,
+                  isrran::span<const int>                    pdcp_sns) override
+  {
+    auto bearer = bearers->get_radio_bearer(rnti, eps_bearer_id);
+    // route the SDUs to PDCP entity, with a single bearer lookup
+    if (bearer.rat == isrran::isrran_rat_t::lte) {
+      pdcp_lte_obj->write_sdus(rnti, bearer.lcid, sdus, pdcp_sns);
+    } else if (bearer.rat == isrran::isrran_rat_t::nr) {
+      pdcp_nr_obj->write_sdus(rnti, bearer.lcid, sdus, pdcp_sns);
+    } else {
+      logger.warning("Can't deliver %zd SDUs for EPS bearer %d. Dropping them.", sdus.size(), eps_bearer_id);
+    }
+  }
   std::map<uint32_t, isrran::unique_byte_buffer_t> get_buffered_pdus(uint16_t rnti, uint32_t eps_bearer_id) override
   {
     auto bearer = bearers->get_radio_bearer(rnti, eps_bearer_id);
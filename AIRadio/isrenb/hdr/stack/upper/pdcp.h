@@ -71,6 +71,10 @@ public:
 
   // pdcp_interface_gtpu
   std::map<uint32_t, isrran::unique_byte_buffer_t> get_buffered_pdus(uint16_t rnti, uint32_t lcid) override;
+  void write_sdus(uint16_t                                   rnti,
+                  uint32_t                                   lcid,
+                  isrran::span<isrran::unique_byte_buffer_t> sdus,
+                  isrran::span<const int>                    pdcp_sns) override;
 
   // Metrics
   void get_metrics(pdcp_metrics_t& m, const uint32_t nof_tti);
@@ -1501,6 +1501,7 @@ static int parse_cell_list(all_args_t* args, rrc_cfg_t* rrc_cfg, Setting& root)
     HANDLEPARSERCODE(parse_default_field(cell_cfg.enable_phr_handling, cellroot, "enable_phr_handling", false));
     HANDLEPARSERCODE(parse_default_field(cell_cfg.min_phr_thres, cellroot, "min_phr_thres", 0));
     parse_default_field(cell_cfg.meas_cfg.allowed_meas_bw, cellroot, "allowed_meas_bw", 6u);
+    parse_default_field(cell_cfg.nof_pusch_decoders, cellroot, "nof_pusch_decoders", 1u);
     isrran_assert(isrran::is_lte_cell_nof_prb(cell_cfg.meas_cfg.allowed_meas_bw), "Invalid measurement Bandwidth");
     HANDLEPARSERCODE(asn1_parsers::default_number_to_enum(
         cell_cfg.t304, cellroot, "t304", asn1::rrc::mob_ctrl_info_s::t304_opts::ms2000));
@@ -1832,6 +1833,7 @@ int parse_cfg_files(all_args_t* args_, rrc_cfg_t* rrc_cfg_, rrc_nr_cfg_t* rrc_nr
       args_->nr_stack.ngap.gtp_advertise_addr = args_->stack.s1ap.gtp_advertise_addr;
       args_->nr_stack.ngap.amf_addr           = args_->stack.s1ap.mme_addr;
       args_->nr_stack.ngap.ngc_bind_addr      = args_->stack.s1ap.gtp_bind_addr;
+      args_->nr_stack.gtpu_tx_batch_size      = args_->stack.gtpu_tx_batch_size;
 
       // Parse NIA/NEA preference list (use same as LTE for now)
       for (uint32_t i = 0; i < rrc_cfg_->eea_preference_list.size(); i++) {
@@ -1902,14 +1904,15 @@ int set_derived_args(all_args_t* args_, rrc_cfg_t* rrc_cfg_, phy_cfg_t* phy_cfg_
 
   // Create dedicated cell configuration from RRC configuration
   for (auto it = rrc_cfg_->cell_list.begin(); it != rrc_cfg_->cell_list.end(); ++it) {
-    cell_cfg_t&    cfg          = *it;
-    phy_cell_cfg_t phy_cell_cfg = {};
-    phy_cell_cfg.cell           = cell_cfg_;
-    phy_cell_cfg.cell.id        = cfg.pci;
-    phy_cell_cfg.cell_id        = cfg.cell_id;
-    phy_cell_cfg.root_seq_idx   = cfg.root_seq_idx;
-    phy_cell_cfg.rf_port        = cfg.rf_port;
-    phy_cell_cfg.gain_db        = cfg.tx_gain;
+    cell_cfg_t&    cfg              = *it;
+    phy_cell_cfg_t phy_cell_cfg     = {};
+    phy_cell_cfg.cell               = cell_cfg_;
+    phy_cell_cfg.cell.id            = cfg.pci;
+    phy_cell_cfg.cell_id            = cfg.cell_id;
+    phy_cell_cfg.root_seq_idx       = cfg.root_seq_idx;
+    phy_cell_cfg.rf_port            = cfg.rf_port;
+    phy_cell_cfg.gain_db            = cfg.tx_gain;
+    phy_cell_cfg.nof_pusch_decoders = cfg.nof_pusch_decoders;
     phy_cell_cfg.num_ra_preambles =
         rrc_cfg_->sibs[1].sib2().rr_cfg_common.rach_cfg_common.preamb_info.nof_ra_preambs.to_number();
 
@@ -2085,8 +2088,9 @@ int set_derived_args(all_args_t* args_, rrc_cfg_t* rrc_cfg_, phy_cfg_t* phy_cfg_
   // Patch certain args that are not exposed yet
   args_->rf.nof_antennas = args_->enb.nof_ports;
 
-  // MAC needs to know the cell bandwidth to dimension softbuffers
-  args_->stack.mac.nof_prb = args_->enb.n_prb;
+  // MAC needs to know the cell bandwidth to dimension softbuffers, and the LLR width of the PUSCH decoder
+  args_->stack.mac.nof_prb             = args_->enb.n_prb;
+  args_->stack.mac.softbuffer_llr_8bit = args_->phy.pusch_8bit_decoder;
 
   // RRC needs eNB id for SIB1 packing
   rrc_cfg_->enb_id = args_->stack.s1ap.enb_id;
@@ -2174,8 +2178,11 @@ int set_derived_args_nr(all_args_t* args_, rrc_nr_cfg_t* rrc_nr_cfg_, phy_cfg_t*
   }
 
   // MAC-NR PCAP options
-  args_->nr_stack.mac.pcap.enable = args_->stack.mac_pcap.enable;
-  args_->nr_stack.log             = args_->stack.log;
+  args_->nr_stack.mac.pcap.enable          = args_->stack.mac_pcap.enable;
+  args_->nr_stack.mac.pcap.pcapng          = args_->stack.mac_pcap.pcapng;
+  args_->nr_stack.mac.pcap.rotate_size_mb  = args_->stack.mac_pcap.rotate_size_mb;
+  args_->nr_stack.mac.pcap.rotate_period_s = args_->stack.mac_pcap.rotate_period_s;
+  args_->nr_stack.log                      = args_->stack.log;
 
   // Sanity check for unsupported/untested configuration
   for (auto& cfg : rrc_nr_cfg_->cell_list) {
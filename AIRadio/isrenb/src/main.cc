@@ -31,7 +31,9 @@
 #include "isrran/common/crash_handler.h"
 #include "isrran/common/tsan_options.h"
 #include "isrran/isrlog/event_trace.h"
+#include "isrran/isrlog/trace_ring.h"
 #include "isrran/isrlog/isrlog.h"
+#include "isrran/phy/utils/hugepage.h"
 #include "isrran/support/emergency_handlers.h"
 #include "isrran/support/signal_handler.h"
 
@@ -140,10 +142,14 @@ void parse_args(all_args_t* args, int argc, char* argv[])
 
     ("log.filename",      bpo::value<string>(&args->log.filename)->default_value("/tmp/ue.log"),"Log filename")
     ("log.file_max_size", bpo::value<int>(&args->log.file_max_size)->default_value(-1), "Maximum file size (in kilobytes). When passed, multiple files are created. Default -1 (single file)")
+    ("log.binary",        bpo::value<bool>(&args->log.binary)->default_value(false), "Write the log file in binary form, to be rendered with isrlog_decode. Ignores file_max_size")
 
     /* PCAP */
     ("pcap.enable",    bpo::value<bool>(&args->stack.mac_pcap.enable)->default_value(false),         "Enable MAC packet captures for wireshark")
     ("pcap.filename",  bpo::value<string>(&args->stack.mac_pcap.filename)->default_value("/tmp/enb_mac.pcap"), "MAC layer capture filename")
+    ("pcap.pcapng",    bpo::value<bool>(&args->stack.mac_pcap.pcapng)->default_value(false),         "Write the MAC capture in pcapng format")
+    ("pcap.rotate_size_mb",  bpo::value<uint32_t>(&args->stack.mac_pcap.rotate_size_mb)->default_value(0),   "Start a new MAC capture file every given number of MB (0 disables)")
+    ("pcap.rotate_period_s", bpo::value<uint32_t>(&args->stack.mac_pcap.rotate_period_s)->default_value(0),  "Start a new MAC capture file every given number of seconds (0 disables)")
     ("pcap.nr_filename",  bpo::value<string>(&args->nr_stack.mac.pcap.filename)->default_value("/tmp/enb_mac_nr.pcap"), "NR MAC layer capture filename")
     ("pcap.s1ap_enable",   bpo::value<bool>(&args->stack.s1ap_pcap.enable)->default_value(false),         "Enable S1AP packet captures for wireshark")
     ("pcap.s1ap_filename", bpo::value<string>(&args->stack.s1ap_pcap.filename)->default_value("/tmp/enb_s1ap.pcap"), "S1AP layer capture filename")
@@ -230,6 +236,14 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("cfr.auto_target_papr", bpo::value<float>(&args->phy.cfr_args.auto_target_papr)->default_value(args->phy.cfr_args.auto_target_papr), "Signal PAPR target (in dB) in CFR auto modes")
     ("cfr.ema_alpha", bpo::value<float>(&args->phy.cfr_args.ema_alpha)->default_value(args->phy.cfr_args.ema_alpha), "Alpha coefficient for the power average in auto_ema mode (0 to 1)")
 
+    /* Thread placement section */
+    ("threads.rf_cpus",           bpo::value<string>(&args->threads.rf_cpus)->default_value(""),          "CPU list of the RF thread, e.g. 2 or 0-3,8 (empty leaves it unpinned)")
+    ("threads.phy_cpus",          bpo::value<string>(&args->threads.phy_cpus)->default_value(""),         "CPU list of the PHY worker threads")
+    ("threads.stack_cpus",        bpo::value<string>(&args->threads.stack_cpus)->default_value(""),       "CPU list of the stack thread")
+    ("threads.gtpu_cpus",         bpo::value<string>(&args->threads.gtpu_cpus)->default_value(""),        "CPU list of the GTP-U/S1 socket thread")
+    ("threads.log_cpus",          bpo::value<string>(&args->threads.log_cpus)->default_value(""),         "CPU list of the log backend thread")
+    ("threads.numa_local_memory", bpo::value<bool>(&args->threads.numa_local_memory)->default_value(true), "Allocate the memory of the pinned threads and the byte buffer pool on their NUMA nodes")
+
       /* Expert section */
     ("expert.metrics_period_secs", bpo::value<float>(&args->general.metrics_period_secs)->default_value(1.0), "Periodicity for metrics in seconds.")
     ("expert.metrics_csv_enable",  bpo::value<bool>(&args->general.metrics_csv_enable)->default_value(false), "Write metrics to CSV file.")
@@ -239,6 +253,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.pusch_meas_evm", bpo::value<bool>(&args->phy.pusch_meas_evm)->default_value(false), "Enable/Disable PUSCH EVM measure.")
     ("expert.tx_amplitude", bpo::value<float>(&args->phy.tx_amplitude)->default_value(0.6), "Transmit amplitude factor.")
     ("expert.nof_phy_threads", bpo::value<uint32_t>(&args->phy.nof_phy_threads)->default_value(3), "Number of PHY threads.")
+    ("expert.nof_pusch_threads", bpo::value<uint32_t>(&args->phy.nof_pusch_threads)->default_value(0), "Number of threads shared by all LTE cells for decoding PUSCH of several UEs in parallel (0 disables it).")
     ("expert.nof_prach_threads", bpo::value<uint32_t>(&args->phy.nof_prach_threads)->default_value(1), "Number of PRACH workers per carrier. Only 1 or 0 is supported.")
     ("expert.max_prach_offset_us", bpo::value<float>(&args->phy.max_prach_offset_us)->default_value(30), "Maximum allowed RACH offset (in us).")
     ("expert.equalizer_mode", bpo::value<string>(&args->phy.equalizer_mode)->default_value("mmse"), "Equalizer mode.")
@@ -252,16 +267,24 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.tracing_enable",  bpo::value<bool>(&args->general.tracing_enable)->default_value(false), "Events tracing.")
     ("expert.tracing_filename", bpo::value<string>(&args->general.tracing_filename)->default_value("/tmp/enb_tracing.log"), "Tracing events filename.")
     ("expert.tracing_buffcapacity", bpo::value<std::size_t>(&args->general.tracing_buffcapacity)->default_value(1000000), "Tracing buffer capcity.")
+    ("expert.trace_ring_enable",  bpo::value<bool>(&args->general.trace_ring_enable)->default_value(false), "Record real time events into per-thread trace rings.")
+    ("expert.trace_ring_filename", bpo::value<string>(&args->general.trace_ring_filename)->default_value("/tmp/enb_trace.json"), "Trace ring dump filename, written on SIGUSR2 and at exit.")
+    ("expert.trace_ring_size", bpo::value<uint32_t>(&args->general.trace_ring_size)->default_value(65536), "Number of events held by each thread trace ring.")
+    ("expert.hugepages", bpo::value<string>(&args->general.hugepages)->default_value("none"), "Huge pages backing the PHY buffers: none, thp or hugetlb.")
+    ("expert.hugepage_arena_mb", bpo::value<uint32_t>(&args->general.hugepage_arena_mb)->default_value(256), "Size in MB of the huge page arena holding the HARQ softbuffers.")
+    ("expert.hugepage_heap_mb", bpo::value<uint32_t>(&args->general.hugepage_heap_mb)->default_value(0), "Size in MB of the heap reserved for the PHY buffers, changes the process-wide malloc thresholds (0 disables).")
     ("expert.stdout_ts_enable", bpo::value<bool>(&stdout_ts_enable)->default_value(false), "Prints once per second the timestamp into stdout.")
     ("expert.rrc_inactivity_timer", bpo::value<uint32_t>(&args->general.rrc_inactivity_timer)->default_value(30000), "Inactivity timer in ms.")
     ("expert.print_buffer_state", bpo::value<bool>(&args->general.print_buffer_state)->default_value(false), "Prints on the console the buffer state every 10 seconds.")
     ("expert.eea_pref_list", bpo::value<string>(&args->general.eea_pref_list)->default_value("EEA0, EEA2, EEA1"), "Ordered preference list for the selection of encryption algorithm (EEA) (default: EEA0, EEA2, EEA1).")
     ("expert.eia_pref_list", bpo::value<string>(&args->general.eia_pref_list)->default_value("EIA2, EIA1, EIA0"), "Ordered preference list for the selection of integrity algorithm (EIA) (default: EIA2, EIA1, EIA0).")
     ("expert.nof_prealloc_ues", bpo::value<uint32_t>(&args->stack.mac.nof_prealloc_ues)->default_value(8), "Number of UE resources to preallocate during eNB initialization.")
+    ("expert.softbuffer_pool", bpo::value<bool>(&args->stack.mac.softbuffer_pool)->default_value(false), "UL softbuffers take their code blocks from a shared pool only while receiving a TB.")
     ("expert.lcid_padding", bpo::value<int>(&args->stack.mac.lcid_padding)->default_value(3), "LCID on which to put MAC padding")
     ("expert.max_mac_dl_kos", bpo::value<uint32_t>(&args->general.max_mac_dl_kos)->default_value(100), "Maximum number of consecutive KOs in DL before triggering the UE's release (default 100).")
     ("expert.max_mac_ul_kos", bpo::value<uint32_t>(&args->general.max_mac_ul_kos)->default_value(100), "Maximum number of consecutive KOs in UL before triggering the UE's release (default 100).")
     ("expert.gtpu_tunnel_timeout", bpo::value<uint32_t>(&args->stack.gtpu_indirect_tunnel_timeout_msec)->default_value(0), "Maximum time that GTPU takes to release indirect forwarding tunnel since the last received GTPU PDU (0 for infinity).")
+    ("expert.gtpu_tx_batch", bpo::value<uint32_t>(&args->stack.gtpu_tx_batch_size)->default_value(64), "Maximum number of UL GTP-U PDUs queued and sent with one system call, flushed every TTI (1 sends each PDU immediately).")
     ("expert.rlf_release_timer_ms", bpo::value<uint32_t>(&args->general.rlf_release_timer_ms)->default_value(4000), "Time taken by eNB to release UE context after it detects an RLF.")
     ("expert.extended_cp", bpo::value<bool>(&args->phy.extended_cp)->default_value(false), "Use extended cyclic prefix")
     ("expert.ts1_reloc_prep_timeout", bpo::value<uint32_t>(&args->stack.s1ap.ts1_reloc_prep_timeout)->default_value(10000), "S1AP TS 36.413 TS1RelocPrep Expiry Timeout value in milliseconds.")
@@ -287,6 +310,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("scheduler.nr_pdsch_mcs", bpo::value<int>(&args->nr_stack.mac.sched_cfg.fixed_dl_mcs)->default_value(28), "Fixed NR DL MCS (-1 for dynamic).")
     ("scheduler.nr_pusch_mcs", bpo::value<int>(&args->nr_stack.mac.sched_cfg.fixed_ul_mcs)->default_value(28), "Fixed NR UL MCS (-1 for dynamic).")
     ("expert.nr_pusch_max_its", bpo::value<uint32_t>(&args->phy.nr_pusch_max_its)->default_value(10),     "Maximum number of LDPC iterations for NR.")
+    ("expert.nr_nof_ul_threads", bpo::value<uint32_t>(&args->phy.nr_nof_ul_threads)->default_value(0),      "Number of NR UL threads, if not zero the NR uplink is decoded in parallel to the downlink encoding.")
   ;
 
   // Positional options - config file location
@@ -614,10 +638,14 @@ int main(int argc, char* argv[])
   parse_args(&args, argc, argv);
 
   // Setup the default log sink.
-  isrlog::set_default_sink(
-      (args.log.filename == "stdout")
-          ? isrlog::fetch_stdout_sink()
-          : isrlog::fetch_file_sink(args.log.filename, fixup_log_file_maxsize(args.log.file_max_size)));
+  if (args.log.filename == "stdout") {
+    isrlog::set_default_sink(isrlog::fetch_stdout_sink());
+  } else if (args.log.binary) {
+    isrlog::set_default_sink(isrlog::fetch_binary_file_sink(args.log.filename));
+  } else {
+    isrlog::set_default_sink(
+        isrlog::fetch_file_sink(args.log.filename, fixup_log_file_maxsize(args.log.file_max_size)));
+  }
 
   // Alarms log channel creation.
   isrlog::sink&        alarm_sink     = isrlog::fetch_file_sink(args.general.alarms_filename, 0, true);
@@ -632,8 +660,21 @@ int main(int argc, char* argv[])
   }
 #endif
 
-  // Start the log backend.
-  isrlog::init();
+  if (args.general.trace_ring_enable) {
+    isrlog::trace_ring_init(args.general.trace_ring_size);
+    isrlog::trace_ring_dump_on_signal(args.general.trace_ring_filename);
+  }
+
+  // Place the threads before any of them is created.
+  if (not isrran::thread_placement::get_instance().configure(args.threads)) {
+    return ISRRAN_ERROR;
+  }
+
+  // Start the log backend, which inherits the placement of the logging threads.
+  {
+    isrran::scoped_thread_placement log_placement(isrran::thread_role::log);
+    isrlog::init();
+  }
 
   isrlog::fetch_basic_logger("ALL").set_level(isrlog::basic_levels::warning);
   isrlog::fetch_basic_logger("POOL").set_level(isrlog::basic_levels::warning);
@@ -655,6 +696,18 @@ int main(int argc, char* argv[])
     event_logger::configure(json_channel, format);
   }
 
+  // Back the PHY buffers with huge pages before they are allocated and locked.
+  isrran_hugepage_mode_t hugepage_mode = ISRRAN_HUGEPAGE_NONE;
+  if (isrran_hugepage_mode_parse(args.general.hugepages.c_str(), &hugepage_mode) != ISRRAN_SUCCESS) {
+    cout << "Error, invalid huge page mode: " << args.general.hugepages << endl;
+    return ISRRAN_ERROR;
+  }
+  if (isrran_hugepage_init(hugepage_mode,
+                           (size_t)args.general.hugepage_arena_mb * 1024 * 1024,
+                           (size_t)args.general.hugepage_heap_mb * 1024 * 1024) != ISRRAN_SUCCESS) {
+    return ISRRAN_ERROR;
+  }
+
   if (mlockall((uint32_t)MCL_CURRENT | (uint32_t)MCL_FUTURE) == -1) {
     isrran::console("Failed to `mlockall`: {}", errno);
   }
@@ -666,6 +719,16 @@ int main(int argc, char* argv[])
     return ISRRAN_ERROR;
   }
 
+  if (isrran::thread_placement::get_instance().is_configured()) {
+    cout << isrran::thread_placement::get_instance().get_report();
+  }
+
+  if (hugepage_mode != ISRRAN_HUGEPAGE_NONE) {
+    char hugepage_str[256];
+    isrran_hugepage_stats_info(hugepage_str, sizeof(hugepage_str));
+    cout << hugepage_str << endl;
+  }
+
   // Set metrics
   metricshub.init(enb.get(), args.general.metrics_period_secs);
   metricshub.add_listener(&metrics_screen);
@@ -714,6 +777,11 @@ int main(int argc, char* argv[])
   input.join();
   metricshub.stop();
   enb->stop();
+
+  if (args.general.trace_ring_enable) {
+    isrlog::trace_ring_stop();
+    isrlog::trace_ring_dump(args.general.trace_ring_filename);
+  }
   cout << "---  exiting  ---" << endl;
 
   return ISRRAN_SUCCESS;
@@ -63,6 +63,16 @@ void metrics_csv::set_metrics(const enb_metrics_t& metrics, const uint32_t perio
       file << "time;nof_ue;dl_brate;ul_brate;"
               "proc_rmem;proc_rmem_kB;proc_vmem_kB;sys_mem;system_load;thread_count";
 
+      // Add the TTI latency percentiles of each stage, in microseconds
+      for (const char* rat : {"lte", "nr"}) {
+        for (uint32_t s = 0; s < isrran::nof_tti_stages; s++) {
+          const char* stage = isrran::to_string((isrran::tti_stage)s);
+          file << ";" << rat << "_" << stage << "_p50;" << rat << "_" << stage << "_p99;" << rat << "_" << stage
+               << "_p999";
+        }
+        file << ";" << rat << "_deadline_misses";
+      }
+
       // Add the cpus
       for (uint32_t i = 0, e = metrics.sys.cpu_count; i != e; ++i) {
         file << ";cpu_" << std::to_string(i);
@@ -108,6 +118,10 @@ void metrics_csv::set_metrics(const enb_metrics_t& metrics, const uint32_t perio
     file << float_to_string(m.process_cpu_usage, 2);
     file << std::to_string(m.thread_count) << ";";
 
+    // Write the TTI latency metrics.
+    write_latency_metrics(metrics.phy_latency.lte);
+    write_latency_metrics(metrics.phy_latency.nr);
+
     // Write the cpu metrics.
     for (uint32_t i = 0, e = m.cpu_count, last_cpu_index = e - 1; i != e; ++i) {
       file << float_to_string(m.cpu_load[i], 2, (i != last_cpu_index));
@@ -121,6 +135,16 @@ void metrics_csv::set_metrics(const enb_metrics_t& metrics, const uint32_t perio
   }
 }
 
+void metrics_csv::write_latency_metrics(const isrran::tti_latency_metrics_t& m)
+{
+  for (const isrran::tti_stage_latency_t& stage : m.stages) {
+    file << std::to_string((uint32_t)stage.p50_us) << ";";
+    file << std::to_string((uint32_t)stage.p99_us) << ";";
+    file << std::to_string((uint32_t)stage.p999_us) << ";";
+  }
+  file << std::to_string(m[isrran::tti_stage::rf_tx].nof_deadline_misses) << ";";
+}
+
 std::string metrics_csv::float_to_string(float f, int digits, bool add_semicolon)
 {
   std::ostringstream os;
@@ -95,13 +95,71 @@ DECLARE_METRIC("nof_rach", metric_nof_rach, uint32_t, "");
 DECLARE_METRIC_LIST("ue_list", mlist_ues, std::vector<mset_ue_container>);
 DECLARE_METRIC_SET("cell_container", mset_cell_container, metric_carrier_id, metric_pci, metric_nof_rach, mlist_ues);
 
+/// TTI latency stage container metrics.
+DECLARE_METRIC("stage", metric_stage, std::string, "");
+DECLARE_METRIC("nof_samples", metric_nof_samples, uint64_t, "");
+DECLARE_METRIC("p50", metric_p50, float, "us");
+DECLARE_METRIC("p99", metric_p99, float, "us");
+DECLARE_METRIC("p99_9", metric_p999, float, "us");
+DECLARE_METRIC("max", metric_max, float, "us");
+DECLARE_METRIC("deadline_misses", metric_deadline_misses, uint64_t, "");
+DECLARE_METRIC_SET("stage_container",
+                   mset_stage_container,
+                   metric_stage,
+                   metric_nof_samples,
+                   metric_p50,
+                   metric_p99,
+                   metric_p999,
+                   metric_max,
+                   metric_deadline_misses);
+
+/// TTI latency container metrics.
+DECLARE_METRIC("rat", metric_rat, std::string, "");
+DECLARE_METRIC("deadline", metric_deadline, uint32_t, "us");
+DECLARE_METRIC_LIST("stage_list", mlist_stages, std::vector<mset_stage_container>);
+DECLARE_METRIC_SET("tti_latency_container", mset_tti_latency_container, metric_rat, metric_deadline, mlist_stages);
+
+/// UL softbuffer pool metrics.
+DECLARE_METRIC("nof_blocks", metric_sb_nof_blocks, uint32_t, "");
+DECLARE_METRIC("nof_used", metric_sb_nof_used, uint32_t, "");
+DECLARE_METRIC("peak_used", metric_sb_peak_used, uint32_t, "");
+DECLARE_METRIC("memory", metric_sb_memory, uint64_t, "bytes");
+DECLARE_METRIC_SET("softbuffer_pool",
+                   mset_softbuffer_pool,
+                   metric_sb_nof_blocks,
+                   metric_sb_nof_used,
+                   metric_sb_peak_used,
+                   metric_sb_memory);
+
+/// UL GTP-U transmit batching metrics.
+DECLARE_METRIC("tx_pdus", metric_gtpu_tx_pdus, uint64_t, "");
+DECLARE_METRIC("tx_batches", metric_gtpu_tx_batches, uint64_t, "");
+DECLARE_METRIC("tx_syscalls", metric_gtpu_tx_syscalls, uint64_t, "");
+DECLARE_METRIC("tx_gso_pdus", metric_gtpu_tx_gso_pdus, uint64_t, "");
+DECLARE_METRIC("mean_tx_batch", metric_gtpu_mean_tx_batch, float, "");
+DECLARE_METRIC("max_tx_batch", metric_gtpu_max_tx_batch, uint32_t, "");
+DECLARE_METRIC_SET("gtpu",
+                   mset_gtpu,
+                   metric_gtpu_tx_pdus,
+                   metric_gtpu_tx_batches,
+                   metric_gtpu_tx_syscalls,
+                   metric_gtpu_tx_gso_pdus,
+                   metric_gtpu_mean_tx_batch,
+                   metric_gtpu_max_tx_batch);
+
 /// Metrics root object.
 DECLARE_METRIC("type", metric_type_tag, std::string, "");
 DECLARE_METRIC("timestamp", metric_timestamp_tag, double, "");
 DECLARE_METRIC_LIST("cell_list", mlist_cell, std::vector<mset_cell_container>);
+DECLARE_METRIC_LIST("tti_latency_list", mlist_tti_latency, std::vector<mset_tti_latency_container>);
 
 /// Metrics context.
-using metric_context_t = isrlog::build_context_type<metric_type_tag, metric_timestamp_tag, mlist_cell>;
+using metric_context_t = isrlog::build_context_type<metric_type_tag,
+                                                    metric_timestamp_tag,
+                                                    mlist_cell,
+                                                    mlist_tti_latency,
+                                                    mset_softbuffer_pool,
+                                                    mset_gtpu>;
 
 } // namespace
 
@@ -174,6 +232,32 @@ static void fill_ue_metrics(mset_ue_container& ue, const enb_metrics_t& m, unsig
   }
 }
 
+/// Fill the TTI latency metrics of a RAT, only the stages with samples in the period are reported.
+static void fill_tti_latency_metrics(mset_tti_latency_container&          container,
+                                     const char*                          rat,
+                                     const isrran::tti_latency_metrics_t& m)
+{
+  container.write<metric_rat>(rat);
+  container.write<metric_deadline>(m.deadline_us);
+
+  auto& stage_list = container.get<mlist_stages>();
+  for (uint32_t s = 0; s < isrran::nof_tti_stages; s++) {
+    const isrran::tti_stage_latency_t& stage = m.stages[s];
+    if (stage.nof_samples == 0) {
+      continue;
+    }
+    stage_list.emplace_back();
+    auto& stage_container = stage_list.back();
+    stage_container.write<metric_stage>(isrran::to_string((isrran::tti_stage)s));
+    stage_container.write<metric_nof_samples>(stage.nof_samples);
+    stage_container.write<metric_p50>(stage.p50_us);
+    stage_container.write<metric_p99>(stage.p99_us);
+    stage_container.write<metric_p999>(stage.p999_us);
+    stage_container.write<metric_max>(stage.max_us);
+    stage_container.write<metric_deadline_misses>(stage.nof_deadline_misses);
+  }
+}
+
 /// Returns the current time in seconds with ms precision since UNIX epoch.
 static double get_time_stamp()
 {
@@ -238,6 +322,31 @@ void metrics_json::set_metrics(const enb_metrics_t& m, const uint32_t period_use
     }
   }
 
+  // TTI pipeline latency of each RAT.
+  auto& latency_list = ctx.get<mlist_tti_latency>();
+  latency_list.resize(2);
+  fill_tti_latency_metrics(latency_list[0], "lte", m.phy_latency.lte);
+  fill_tti_latency_metrics(latency_list[1], "nr", m.phy_latency.nr);
+
+  // UL softbuffer code block pool.
+  auto& sb_pool = ctx.get<mset_softbuffer_pool>();
+  sb_pool.write<metric_sb_nof_blocks>(m.stack.mac.softbuffer_pool.nof_blocks);
+  sb_pool.write<metric_sb_nof_used>(m.stack.mac.softbuffer_pool.nof_used);
+  sb_pool.write<metric_sb_peak_used>(m.stack.mac.softbuffer_pool.peak_used);
+  sb_pool.write<metric_sb_memory>(m.stack.mac.softbuffer_pool.nof_bytes);
+
+  // UL GTP-U transmit batches of the LTE and NR stacks.
+  const gtpu_metrics_t& lte_gtpu = m.stack.gtpu;
+  const gtpu_metrics_t& nr_gtpu  = m.nr_stack.gtpu;
+  uint64_t              batches  = lte_gtpu.tx_batches + nr_gtpu.tx_batches;
+  auto&                 gtpu     = ctx.get<mset_gtpu>();
+  gtpu.write<metric_gtpu_tx_pdus>(lte_gtpu.tx_pdus + nr_gtpu.tx_pdus);
+  gtpu.write<metric_gtpu_tx_batches>(batches);
+  gtpu.write<metric_gtpu_tx_syscalls>(lte_gtpu.tx_syscalls + nr_gtpu.tx_syscalls);
+  gtpu.write<metric_gtpu_tx_gso_pdus>(lte_gtpu.tx_gso_pdus + nr_gtpu.tx_gso_pdus);
+  gtpu.write<metric_gtpu_mean_tx_batch>(batches > 0 ? (lte_gtpu.tx_pdus + nr_gtpu.tx_pdus) / (float)batches : 0);
+  gtpu.write<metric_gtpu_max_tx_batch>(std::max(lte_gtpu.max_tx_batch, nr_gtpu.max_tx_batch));
+
   // Log the context.
   ctx.write<metric_timestamp_tag>(get_time_stamp());
   log_c(ctx);
@@ -188,6 +188,9 @@ void metrics_stdout::set_metrics(const enb_metrics_t& metrics, const uint32_t pe
     fmt::print("RF status: O={}, U={}, L={}\n", metrics.rf.rf_o, metrics.rf.rf_u, metrics.rf.rf_l);
   }
 
+  print_deadline_misses("LTE", metrics.phy_latency.lte);
+  print_deadline_misses("NR", metrics.phy_latency.nr);
+
   if (metrics.stack.rrc.ues.size() == 0 && metrics.nr_stack.mac.ues.size() == 0) {
     return;
   }
@@ -205,6 +208,22 @@ void metrics_stdout::set_metrics(const enb_metrics_t& metrics, const uint32_t pe
   set_metrics_helper(metrics.nr_stack.mac.ues.size(), metrics.nr_stack.mac, metrics.phy, true);
 }
 
+void metrics_stdout::print_deadline_misses(const char* rat, const isrran::tti_latency_metrics_t& m)
+{
+  const isrran::tti_stage_latency_t& tx = m[isrran::tti_stage::rf_tx];
+  if (tx.nof_deadline_misses == 0) {
+    return;
+  }
+  fmt::print("{} TTI deadline misses: {}/{} (rf_tx latency p50={:.0f}, p99={:.0f}, p99.9={:.0f}, max={:.0f} us)\n",
+             rat,
+             tx.nof_deadline_misses,
+             tx.nof_samples,
+             tx.p50_us,
+             tx.p99_us,
+             tx.p999_us,
+             tx.max_us);
+}
+
 std::string metrics_stdout::float_to_string(float f, int digits, int field_width)
 {
   std::ostringstream os;
@@ -22,6 +22,7 @@
 #include <iomanip>
 
 #include "isrran/common/threads.h"
+#include "isrran/isrlog/trace_ring.h"
 #include "isrran/isrran.h"
 
 #include "isrenb/hdr/phy/lte/cc_worker.h"
@@ -66,6 +67,9 @@ cc_worker::~cc_worker()
   isrran_softbuffer_tx_free(&temp_mbsfn_softbuffer);
   isrran_enb_dl_free(&enb_dl);
   isrran_enb_ul_free(&enb_ul);
+  for (isrran_enb_ul_pusch_t& decoder : pusch_decoders) {
+    isrran_enb_ul_pusch_free(&decoder);
+  }
 
   for (int p = 0; p < ISRRAN_MAX_PORTS; p++) {
     if (signal_buffer_rx[p]) {
@@ -156,6 +160,20 @@ void cc_worker::init(phy_common* phy_, uint32_t cc_idx_)
     enb_ul.pusch.llr_is_8bit        = true;
     enb_ul.pusch.ul_sch.llr_is_8bit = true;
   }
+
+  // Additional PUSCH decoders for decoding several UEs in parallel
+  pusch_jobs.resize(stack_interface_phy_lte::MAX_GRANTS);
+  pusch_decoders.resize(phy->get_nof_pusch_decoders(cc_idx) - 1);
+  for (isrran_enb_ul_pusch_t& decoder : pusch_decoders) {
+    if (isrran_enb_ul_pusch_init(&decoder, nof_prb)) {
+      ERROR("Error initiating PUSCH decoder");
+      return;
+    }
+    if (isrran_enb_ul_pusch_set_cell(&decoder, &enb_ul, &phy->dmrs_pusch_cfg, nullptr)) {
+      ERROR("Error initiating PUSCH decoder");
+      return;
+    }
+  }
   initiated = true;
 
 #ifdef DEBUG_WRITE_FILE
@@ -189,6 +207,7 @@ void cc_worker::set_tti(uint32_t tti_)
 int cc_worker::add_rnti(uint16_t rnti)
 {
   std::unique_lock<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex>  metrics_lock(metrics_mutex);
 
   // Create user unless already exists
   if (ue_db.count(rnti) == 0) {
@@ -200,6 +219,7 @@ int cc_worker::add_rnti(uint16_t rnti)
 void cc_worker::rem_rnti(uint16_t rnti)
 {
   std::lock_guard<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex> metrics_lock(metrics_mutex);
   if (ue_db.count(rnti)) {
     delete ue_db[rnti];
     ue_db.erase(rnti);
@@ -214,6 +234,7 @@ uint32_t cc_worker::get_nof_rnti()
 
 void cc_worker::work_ul(const isrran_ul_sf_cfg_t& ul_sf_cfg, stack_interface_phy_lte::ul_sched_t& ul_grants)
 {
+  trace_ring_event("phy", "lte_work_ul", ul_sf_cfg.tti);
   std::lock_guard<std::mutex> lock(mutex);
   ul_sf = ul_sf_cfg;
   logger.set_context(ul_sf.tti);
@@ -233,6 +254,7 @@ void cc_worker::work_dl(const isrran_dl_sf_cfg_t&            dl_sf_cfg,
                         stack_interface_phy_lte::ul_sched_t& ul_grants,
                         isrran_mbsfn_cfg_t*                  mbsfn_cfg)
 {
+  trace_ring_event("phy", "lte_work_dl", dl_sf_cfg.tti);
   std::lock_guard<std::mutex> lock(mutex);
   dl_sf = dl_sf_cfg;
 
@@ -283,11 +305,11 @@ void cc_worker::work_dl(const isrran_dl_sf_cfg_t&            dl_sf_cfg,
   }
 }
 
-bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
-                                  isrran_ul_cfg_t&                           ul_cfg,
-                                  isrran_pusch_res_t&                        pusch_res)
+bool cc_worker::prepare_pusch_rnti(pusch_job_t& job)
 {
-  uint16_t rnti = ul_grant.dci.rnti;
+  stack_interface_phy_lte::ul_sched_grant_t& ul_grant = *job.ul_grant;
+  isrran_ul_cfg_t&                           ul_cfg   = job.ul_cfg;
+  uint16_t                                   rnti     = ul_grant.dci.rnti;
 
   // Invalid RNTI
   if (rnti == ISRRAN_INVALID_RNTI) {
@@ -307,7 +329,7 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
   }
 
   // Fill UCI configuration
-  bool uci_required =
+  job.uci_required =
       phy->ue_db.fill_uci_cfg(tti_rx, cc_idx, rnti, ul_grant.dci.cqi_request, true, ul_cfg.pusch.uci_cfg);
 
   // Compute UL grant
@@ -338,20 +360,60 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
     Error("Error setting last UL TB for RNTI %x, CC %d, PID %d", rnti, cc_idx, ul_grant.pid);
   }
 
-  // Run PUSCH decoder
   ul_cfg.pusch.softbuffers.rx = ul_grant.softbuffer_rx;
-  pusch_res.data              = ul_grant.data;
-  if (pusch_res.data) {
-    if (isrran_enb_ul_get_pusch(&enb_ul, &ul_sf, &ul_cfg.pusch, &pusch_res)) {
-      Error("Decoding PUSCH for RNTI %x", rnti);
-      return false;
-    }
-  }
+  job.pusch_res.data          = ul_grant.data;
+
   // Save PHICH scheduling for this user. Each user can have just 1 PUSCH dci per TTI
   ue_db[rnti]->phich_grant.n_prb_lowest = grant.n_prb_tilde[0];
   ue_db[rnti]->phich_grant.n_dmrs       = ul_grant.dci.n_dmrs;
 
-  float snr_db = enb_ul.chest_res.snr_db;
+  return true;
+}
+
+void cc_worker::decode_pusch_job(pusch_job_t& job, isrran_enb_ul_pusch_t* decoder)
+{
+  job.decoded = true;
+
+  if (job.pusch_res.data == nullptr) {
+    return;
+  }
+
+  // Run PUSCH decoder, the worker thread uses the main eNb UL object
+  int                    ret       = ISRRAN_SUCCESS;
+  isrran_chest_ul_res_t* chest_res = nullptr;
+  if (decoder == nullptr) {
+    ret       = isrran_enb_ul_get_pusch(&enb_ul, &ul_sf, &job.ul_cfg.pusch, &job.pusch_res);
+    chest_res = &enb_ul.chest_res;
+  } else {
+    ret       = isrran_enb_ul_pusch_decode(decoder, &ul_sf, &job.ul_cfg.pusch, &job.pusch_res);
+    chest_res = &decoder->chest_res;
+  }
+
+  if (ret < ISRRAN_SUCCESS) {
+    job.decoded = false;
+    return;
+  }
+
+  // Keep the measurements, the channel estimates are overwritten by the next job of the same decoder
+  job.chest_res    = *chest_res;
+  job.chest_res.ce = nullptr;
+}
+
+void cc_worker::run_pusch_jobs(isrran_enb_ul_pusch_t* decoder)
+{
+  for (uint32_t i = pusch_next_job++; i < pusch_nof_jobs; i = pusch_next_job++) {
+    decode_pusch_job(pusch_jobs[i], decoder);
+  }
+}
+
+void cc_worker::report_pusch_rnti(pusch_job_t& job)
+{
+  stack_interface_phy_lte::ul_sched_grant_t& ul_grant  = *job.ul_grant;
+  isrran_ul_cfg_t&                           ul_cfg    = job.ul_cfg;
+  isrran_pusch_res_t&                        pusch_res = job.pusch_res;
+  uint16_t                                   rnti      = ul_grant.dci.rnti;
+
+  float snr_db = job.chest_res.snr_db;
 
   // Notify MAC of RL status
   if (snr_db >= PUSCH_RL_SNR_DB_TH) {
@@ -359,13 +421,13 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
     phy->stack->snr_info(ul_sf.tti, rnti, cc_idx, snr_db, mac_interface_phy_lte::PUSCH);
 
     // Notify MAC of Time Alignment only if it enabled and valid measurement, ignore value otherwise
-    if (ul_cfg.pusch.meas_ta_en and not std::isnan(enb_ul.chest_res.ta_us) and not std::isinf(enb_ul.chest_res.ta_us)) {
-      phy->stack->ta_info(ul_sf.tti, rnti, enb_ul.chest_res.ta_us);
+    if (ul_cfg.pusch.meas_ta_en and not std::isnan(job.chest_res.ta_us) and not std::isinf(job.chest_res.ta_us)) {
+      phy->stack->ta_info(ul_sf.tti, rnti, job.chest_res.ta_us);
     }
   }
 
   // Send UCI data to MAC
-  if (uci_required) {
+  if (job.uci_required) {
     phy->ue_db.send_uci_data(tti_rx, rnti, cc_idx, ul_cfg.pusch.uci_cfg, pusch_res.uci);
   }
 
@@ -373,43 +435,76 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
   if (ul_grant.data != nullptr) {
     // Save metrics stats
     ue_db[rnti]->metrics_ul(ul_grant.dci.tb.mcs_idx,
-                            enb_ul.chest_res.epre_dBfs - phy->params.rx_gain_offset,
-                            enb_ul.chest_res.snr_db,
+                            job.chest_res.epre_dBfs - phy->params.rx_gain_offset,
+                            job.chest_res.snr_db,
                             pusch_res.avg_iterations_block);
   }
-  return true;
+
+  // Notify MAC new received data and HARQ Indication value
+  if (ul_grant.data != nullptr) {
+    // Inform MAC about the CRC result
+    phy->stack->crc_info(tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc);
+    // Push PDU buffer
+    phy->stack->push_pdu(tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc, ul_cfg.pusch.grant.L_prb);
+    // Logging
+    if (logger.info.enabled()) {
+      char str[512];
+      isrran_pusch_rx_info(&ul_cfg.pusch, &pusch_res, &job.chest_res, str, sizeof(str));
+      logger.info("PUSCH: cc=%d, %s", cc_idx, str);
+    }
+  }
 }
 
 void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch)
 {
-  // Iterate over all the grants, all the grants need to report MAC the CRC status
-  for (uint32_t i = 0; i < nof_pusch; i++) {
-    // Get grant itself and RNTI
-    stack_interface_phy_lte::ul_sched_grant_t& ul_grant = grants[i];
-    uint16_t                                   rnti     = ul_grant.dci.rnti;
-
-    isrran_pusch_res_t pusch_res = {};
-    isrran_ul_cfg_t    ul_cfg    = {};
+  // Prepare all the grants, all the grants need to report MAC the CRC status
+  uint32_t nof_jobs = 0;
+  for (uint32_t i = 0; i < nof_pusch and nof_jobs < pusch_jobs.size(); i++) {
+    pusch_job_t& job = pusch_jobs[nof_jobs];
+    job              = {};
+    job.ul_grant     = &grants[i];
+
+    if (!prepare_pusch_rnti(job)) {
+      break;
+    }
+    nof_jobs++;
+  }
+
+  // Dispatch the decoding of the prepared grants to the additional decoders, if available. The jobs are pulled in
+  // order by the worker thread and the decoders, so the latency is the one of the slowest UE rather than the sum.
+  uint32_t nof_helpers   = std::min(static_cast<uint32_t>(pusch_decoders.size()), nof_jobs > 0 ? nof_jobs - 1 : 0);
+  pusch_nof_jobs         = nof_jobs;
+  pusch_next_job         = 0;
+  pusch_pending_decoders = nof_helpers;
+  for (uint32_t i = 0; i < nof_helpers; i++) {
+    isrran_enb_ul_pusch_t* decoder = &pusch_decoders[i];
+    phy->pusch_job_pool->push_task([this, decoder]() {
+      run_pusch_jobs(decoder);
+
+      std::lock_guard<std::mutex> lock(pusch_job_mutex);
+      pusch_pending_decoders--;
+      if (pusch_pending_decoders == 0) {
+        pusch_job_cvar.notify_one();
+      }
+    });
+  }
+  run_pusch_jobs(nullptr);
 
-    // Decodes PUSCH for the given grant
-    if (!decode_pusch_rnti(ul_grant, ul_cfg, pusch_res)) {
-      return;
+  // Wait for all the decoders to finish before sending any indication to MAC
+  if (nof_helpers > 0) {
+    std::unique_lock<std::mutex> lock(pusch_job_mutex);
+    while (pusch_pending_decoders > 0) {
+      pusch_job_cvar.wait(lock);
     }
+  }
 
-    // Notify MAC new received data and HARQ Indication value
-    if (ul_grant.data != nullptr) {
-      // Inform MAC about the CRC result
-      phy->stack->crc_info(tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc);
-      // Push PDU buffer
-      phy->stack->push_pdu(
-          tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc, ul_cfg.pusch.grant.L_prb);
-      // Logging
-      if (logger.info.enabled()) {
-        char str[512];
-        isrran_pusch_rx_info(&ul_cfg.pusch, &pusch_res, &enb_ul.chest_res, str, sizeof(str));
-        logger.info("PUSCH: cc=%d, %s", cc_idx, str);
-      }
+  // Report in grant order, stop at the first decoding error
+  for (uint32_t i = 0; i < nof_jobs; i++) {
+    if (!pusch_jobs[i].decoded) {
+      Error("Decoding PUSCH for RNTI %x", pusch_jobs[i].ul_grant->dci.rnti);
+      return;
     }
+    report_pusch_rnti(pusch_jobs[i]);
   }
 }
 
@@ -654,7 +749,7 @@ int cc_worker::encode_pdsch(stack_interface_phy_lte::dl_sched_grant_t* grants, u
 /************ METRICS interface ********************/
 uint32_t cc_worker::get_metrics(std::vector<phy_metrics_t>& metrics)
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  std::lock_guard<std::mutex> lock(metrics_mutex);
   uint32_t                    cnt = 0;
   metrics.resize(ue_db.size());
   for (auto& ue : ue_db) {
@@ -668,39 +763,44 @@ uint32_t cc_worker::get_metrics(std::vector<phy_metrics_t>& metrics)
 
 void cc_worker::ue::metrics_read(phy_metrics_t* metrics_)
 {
-  if (metrics_) {
-    *metrics_ = metrics;
+  metrics_reader.update(metrics_counters);
+  if (metrics_ == nullptr) {
+    return;
   }
-  metrics = {};
+  *metrics_                    = {};
+  metrics_->dl.n_samples       = metrics_reader.get(counter::dl_samples);
+  metrics_->dl.mcs             = metrics_reader.average(counter::dl_mcs_sum, counter::dl_samples);
+  metrics_->ul.n_samples       = metrics_reader.get(counter::ul_samples);
+  metrics_->ul.mcs             = metrics_reader.average(counter::ul_mcs_sum, counter::ul_samples);
+  metrics_->ul.pusch_sinr      = metrics_reader.average(counter::pusch_sinr_sum, counter::ul_samples);
+  metrics_->ul.pusch_rssi      = metrics_reader.average(counter::pusch_rssi_sum, counter::ul_samples);
+  metrics_->ul.turbo_iters     = metrics_reader.average(counter::turbo_iters_sum, counter::ul_samples);
+  metrics_->ul.n_samples_pucch = metrics_reader.get(counter::pucch_samples);
+  metrics_->ul.pucch_rssi      = metrics_reader.average(counter::pucch_rssi_sum, counter::pucch_samples);
+  metrics_->ul.pucch_ni        = metrics_reader.average(counter::pucch_ni_sum, counter::pucch_samples);
+  metrics_->ul.pucch_sinr      = metrics_reader.average(counter::pucch_sinr_sum, counter::pucch_samples);
 }
 
 void cc_worker::ue::metrics_dl(uint32_t mcs)
 {
-  metrics.dl.mcs = ISRRAN_VEC_CMA(mcs, metrics.dl.mcs, metrics.dl.n_samples);
-  metrics.dl.n_samples++;
+  metrics_counters.add_sample(counter::dl_mcs_sum, counter::dl_samples, mcs);
 }
 
 void cc_worker::ue::metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters)
 {
-  if (isnan(rssi)) {
-    rssi = 0;
-  }
-  metrics.ul.mcs         = ISRRAN_VEC_CMA((float)mcs, metrics.ul.mcs, metrics.ul.n_samples);
-  metrics.ul.pusch_sinr  = ISRRAN_VEC_CMA((float)sinr, metrics.ul.pusch_sinr, metrics.ul.n_samples);
-  metrics.ul.pusch_rssi  = ISRRAN_VEC_CMA((float)rssi, metrics.ul.pusch_rssi, metrics.ul.n_samples);
-  metrics.ul.turbo_iters = ISRRAN_VEC_CMA((float)turbo_iters, metrics.ul.turbo_iters, metrics.ul.n_samples);
-  metrics.ul.n_samples++;
+  metrics_counters.add_sample(counter::ul_mcs_sum, mcs);
+  metrics_counters.add_sample(counter::pusch_sinr_sum, sinr);
+  metrics_counters.add_sample(counter::pusch_rssi_sum, rssi);
+  metrics_counters.add_sample(counter::turbo_iters_sum, turbo_iters);
+  metrics_counters.add(counter::ul_samples);
 }
 
 void cc_worker::ue::metrics_ul_pucch(float rssi, float ni, float sinr)
 {
-  if (isnan(rssi)) {
-    rssi = 0;
-  }
-  metrics.ul.pucch_rssi = ISRRAN_VEC_CMA((float)rssi, metrics.ul.pucch_rssi, metrics.ul.n_samples_pucch);
-  metrics.ul.pucch_ni   = ISRRAN_VEC_CMA((float)ni, metrics.ul.pucch_ni, metrics.ul.n_samples_pucch);
-  metrics.ul.pucch_sinr = ISRRAN_VEC_CMA((float)sinr, metrics.ul.pucch_sinr, metrics.ul.n_samples_pucch);
-  metrics.ul.n_samples_pucch++;
+  metrics_counters.add_sample(counter::pucch_rssi_sum, rssi);
+  metrics_counters.add_sample(counter::pucch_ni_sum, ni);
+  metrics_counters.add_sample(counter::pucch_sinr_sum, sinr);
+  metrics_counters.add(counter::pucch_samples);
 }
 
 int cc_worker::read_ce_abs(float* ce_abs)
@@ -162,6 +162,7 @@ void sf_worker::work_imp()
     phy->worker_end(context, true, tx_buffer);
     return;
   }
+  phy->lte_latency.record(isrran::tti_stage::worker_start, tti_rx);
 
   isrran_mbsfn_cfg_t mbsfn_cfg;
   isrran_sf_t        sf_type = phy->is_mbsfn_sf(&mbsfn_cfg, tti_tx_dl) ? ISRRAN_SF_MBSFN : ISRRAN_SF_NORM;
@@ -192,6 +193,7 @@ void sf_worker::work_imp()
   for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
     cc_workers[cc]->work_ul(ul_sf, ul_grants[cc]);
   }
+  phy->lte_latency.record(isrran::tti_stage::ul_decode, tti_rx);
 
   // Get DL scheduling for the TX TTI from MAC
   if (sf_type == ISRRAN_SF_NORM) {
@@ -215,6 +217,7 @@ void sf_worker::work_imp()
     phy->worker_end(context, true, tx_buffer);
     return;
   }
+  phy->lte_latency.record(isrran::tti_stage::mac_sched, tti_rx);
 
   // Configure DL subframe
   dl_sf.tti              = tti_tx_dl;
@@ -233,6 +236,7 @@ void sf_worker::work_imp()
 
     cc_workers[cc]->work_dl(dl_sf, dl_grants[cc], ul_grants_tx[cc], &mbsfn_cfg);
   }
+  phy->lte_latency.record(isrran::tti_stage::dl_encode, tti_rx);
 
   // Save grants
   phy->set_ul_grants(tti_tx_ul, ul_grants_tx);
@@ -19,6 +19,7 @@
  *
  */
 #include "isrenb/hdr/phy/lte/worker_pool.h"
+#include "isrran/isrlog/trace_ring.h"
 
 namespace isrenb {
 namespace lte {
@@ -27,6 +28,9 @@ worker_pool::worker_pool(uint32_t max_workers) : pool(max_workers) {}
 
 bool worker_pool::init(const phy_args_t& args, phy_common* common, isrlog::sink& log_sink, int prio)
 {
+  // Allocate the worker buffers on the NUMA node of the PHY workers
+  isrran::scoped_thread_placement placement(isrran::thread_role::phy_worker);
+
   // Add workers to workers pool and start threads.
   isrlog::basic_levels log_level = isrlog::str_to_basic_level(args.log.phy_level);
   for (uint32_t i = 0; i < args.nof_phy_threads; i++) {
@@ -36,6 +40,7 @@ bool worker_pool::init(const phy_args_t& args, phy_common* common, isrlog::sink&
 
     auto w = std::unique_ptr<lte::sf_worker>(new sf_worker(log));
     w->init(common);
+    w->set_role(isrran::thread_role::phy_worker);
     pool.init_worker(i, w.get(), prio);
     workers.push_back(std::move(w));
   }
@@ -45,11 +50,13 @@ bool worker_pool::init(const phy_args_t& args, phy_common* common, isrlog::sink&
 
 void worker_pool::start_worker(sf_worker* w)
 {
+  trace_ring_instant("phy", "lte_start_worker", w->get_id());
   pool.start_worker(w);
 }
 
 sf_worker* worker_pool::wait_worker(uint32_t tti)
 {
+  trace_ring_event("phy", "lte_wait_worker", tti);
   return (sf_worker*)pool.wait_worker(tti);
 }
 
@@ -22,6 +22,7 @@
 #include "isrenb/hdr/phy/nr/slot_worker.h"
 #include "isrran/common/buffer_pool.h"
 #include "isrran/common/common.h"
+#include "isrran/isrlog/trace_ring.h"
 
 //#define DEBUG_WRITE_FILE
 
@@ -52,6 +53,8 @@ bool slot_worker::init(const args_t& args)
   // Copy common configurations
   cell_index = args.cell_index;
   rf_port    = args.rf_port;
+  ul_pool    = args.ul_pool;
+  latency    = args.latency;
 
   // Allocate Tx buffers
   tx_buffer.resize(args.nof_tx_ports);
@@ -166,6 +169,7 @@ void slot_worker::set_context(const isrran::phy_common_interface::worker_context
 
 bool slot_worker::work_ul()
 {
+  trace_ring_event("phy", "nr_work_ul", ul_slot_cfg.idx);
   stack_interface_phy_nr::ul_sched_t* ul_sched = stack.get_ul_sched(ul_slot_cfg);
   if (ul_sched == nullptr) {
     logger.error("Error retrieving UL scheduling");
@@ -285,11 +289,15 @@ bool slot_worker::work_ul()
 
 bool slot_worker::work_dl()
 {
+  trace_ring_event("phy", "nr_work_dl", dl_slot_cfg.idx);
   // The Scheduler interface needs to be called synchronously, wait for the sync to be available
   sync.wait(this);
 
   // Retrieve Scheduling for the current processing DL slot
   const stack_interface_phy_nr::dl_sched_t* dl_sched_ptr = stack.get_dl_sched(dl_slot_cfg);
+  if (latency != nullptr) {
+    latency->record(isrran::tti_stage::mac_sched, ul_slot_cfg.idx);
+  }
 
   // Releases synchronization lock and allow next worker to retrieve scheduling results
   sync.release();
@@ -401,8 +409,75 @@ bool slot_worker::work_dl()
   return true;
 }
 
+void slot_worker::save_stage_latency(bool is_ul)
+{
+  float latency_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+  if (latency != nullptr) {
+    latency->record(is_ul ? isrran::tti_stage::ul_decode : isrran::tti_stage::dl_encode, ul_slot_cfg.idx);
+  }
+
+  std::lock_guard<std::mutex> lock(metrics_mutex);
+  if (is_ul) {
+    ul_latency_us.push(latency_us);
+    ul_max_latency_us = std::max(ul_max_latency_us, latency_us);
+  } else {
+    dl_latency_us.push(latency_us);
+    dl_max_latency_us = std::max(dl_max_latency_us, latency_us);
+  }
+}
+
+void slot_worker::get_metrics(metrics_t& m)
+{
+  std::lock_guard<std::mutex> lock(metrics_mutex);
+  m.nof_slots = dl_latency_us.count();
+  m.ul_avg_us = ul_latency_us.value();
+  m.ul_max_us = ul_max_latency_us;
+  m.dl_avg_us = dl_latency_us.value();
+  m.dl_max_us = dl_max_latency_us;
+
+  ul_latency_us.reset();
+  dl_latency_us.reset();
+  ul_max_latency_us = 0.0f;
+  dl_max_latency_us = 0.0f;
+}
+
+void slot_worker::work_pipelined(isrran::rf_buffer_t& tx_rf_buffer)
+{
+  // Hand over the UL slot to the UL pool. The slot configurations are not modified until the worker is released
+  {
+    std::lock_guard<std::mutex> lock(ul_mutex);
+    ul_pending = true;
+  }
+  ul_pool->push_task([this]() {
+    work_ul();
+    save_stage_latency(true);
+
+    std::lock_guard<std::mutex> lock(ul_mutex);
+    ul_pending = false;
+    ul_cvar.notify_one();
+  });
+
+  // Process downlink and transmit without waiting for the UL decoding
+  bool dl_ok = work_dl();
+  save_stage_latency(false);
+  common.worker_end(context, dl_ok, tx_rf_buffer);
+
+  // Wait for the UL stage before releasing the worker
+  std::unique_lock<std::mutex> lock(ul_mutex);
+  while (ul_pending) {
+    ul_cvar.wait(lock);
+  }
+}
+
 void slot_worker::work_imp()
 {
+  trace_ring_event("phy", "nr_work_imp", dl_slot_cfg.idx);
+  start_time = std::chrono::steady_clock::now();
+  if (latency != nullptr) {
+    latency->record(isrran::tti_stage::worker_start, ul_slot_cfg.idx);
+  }
+
   // Inform Scheduler about new slot
   stack.slot_indication(dl_slot_cfg);
 
@@ -414,8 +489,16 @@ void slot_worker::work_imp()
     tx_rf_buffer.set(rf_port, a, nof_ant, tx_buffer[a]);
   }
 
+  // Process uplink and downlink concurrently
+  if (ul_pool != nullptr) {
+    work_pipelined(tx_rf_buffer);
+    return;
+  }
+
   // Process uplink
-  if (not work_ul()) {
+  bool ul_ok = work_ul();
+  save_stage_latency(true);
+  if (not ul_ok) {
     // Wait and release synchronization
     sync.wait(this);
     sync.release();
@@ -424,7 +507,9 @@ void slot_worker::work_imp()
   }
 
   // Process downlink
-  if (not work_dl()) {
+  bool dl_ok = work_dl();
+  save_stage_latency(false);
+  if (not dl_ok) {
     common.worker_end(context, false, tx_rf_buffer);
     return;
   }
@@ -20,6 +20,7 @@
  */
 #include "isrenb/hdr/phy/nr/worker_pool.h"
 #include "isrran/common/band_helper.h"
+#include "isrran/isrlog/trace_ring.h"
 
 namespace isrenb {
 namespace nr {
@@ -53,6 +54,15 @@ bool worker_pool::init(const args_t& args, const phy_cell_cfg_list_nr_t& cell_li
   isrlog::basic_levels log_level = isrlog::str_to_basic_level(args.log.phy_level);
   logger.set_level(log_level);
 
+  // Allocate the worker buffers on the NUMA node of the PHY workers
+  isrran::scoped_thread_placement placement(isrran::thread_role::phy_worker);
+
+  // Create UL stage threads for pipelined UL/DL processing
+  if (args.nof_ul_threads > 0) {
+    ul_pool.reset(
+        new isrran::task_thread_pool(args.nof_ul_threads, false, args.prio, 255, isrran::thread_role::phy_worker));
+  }
+
   // Add workers to workers pool and start threads
   for (uint32_t i = 0; i < args.nof_phy_threads; i++) {
     auto& log = isrlog::fetch_basic_logger(fmt::format("{}PHY{}-NR", args.log.id_preamble, i), log_sink);
@@ -60,6 +70,7 @@ bool worker_pool::init(const args_t& args, const phy_cell_cfg_list_nr_t& cell_li
     log.set_hex_dump_max_size(args.log.phy_hex_limit);
 
     auto w = new slot_worker(common, stack, *this, log);
+    w->set_role(isrran::thread_role::phy_worker);
     pool.init_worker(i, w, args.prio);
     workers.push_back(std::unique_ptr<slot_worker>(w));
 
@@ -73,6 +84,8 @@ bool worker_pool::init(const args_t& args, const phy_cell_cfg_list_nr_t& cell_li
     w_args.srate_hz                = srate_hz;
     w_args.pusch_max_its           = args.pusch_max_its;
     w_args.pusch_min_snr_dB        = args.pusch_min_snr_dB;
+    w_args.ul_pool                 = ul_pool.get();
+    w_args.latency                 = args.latency;
 
     if (not w->init(w_args)) {
       return false;
@@ -84,6 +97,8 @@ bool worker_pool::init(const args_t& args, const phy_cell_cfg_list_nr_t& cell_li
 
 void worker_pool::start_worker(slot_worker* w)
 {
+  trace_ring_instant("phy", "nr_start_worker", w->get_id());
+
   // Push worker into synchronization queue
   slot_sync.push(w);
 
@@ -96,7 +111,11 @@ void worker_pool::start_worker(slot_worker* w)
 
 slot_worker* worker_pool::wait_worker(uint32_t tti)
 {
-  slot_worker* w = (slot_worker*)pool.wait_worker(tti);
+  slot_worker* w = nullptr;
+  {
+    trace_ring_event("phy", "nr_wait_worker", tti);
+    w = (slot_worker*)pool.wait_worker(tti);
+  }
 
   // Save current TTI
   current_tti = tti;
@@ -113,9 +132,33 @@ slot_worker* worker_pool::wait_worker_id(uint32_t id)
 void worker_pool::stop()
 {
   pool.stop();
+  if (ul_pool != nullptr) {
+    ul_pool->stop();
+  }
   prach.stop();
 }
 
+void worker_pool::get_metrics(slot_worker::metrics_t& metrics)
+{
+  metrics = {};
+  for (std::unique_ptr<slot_worker>& w : workers) {
+    slot_worker::metrics_t m = {};
+    w->get_metrics(m);
+
+    if (m.nof_slots == 0) {
+      continue;
+    }
+
+    // Weight the averages by the number of slots processed by each worker
+    uint32_t nof_slots = metrics.nof_slots + m.nof_slots;
+    metrics.ul_avg_us  = (metrics.ul_avg_us * metrics.nof_slots + m.ul_avg_us * m.nof_slots) / nof_slots;
+    metrics.dl_avg_us  = (metrics.dl_avg_us * metrics.nof_slots + m.dl_avg_us * m.nof_slots) / nof_slots;
+    metrics.ul_max_us  = std::max(metrics.ul_max_us, m.ul_max_us);
+    metrics.dl_max_us  = std::max(metrics.dl_max_us, m.dl_max_us);
+    metrics.nof_slots  = nof_slots;
+  }
+}
+
 int worker_pool::set_common_cfg(const phy_interface_rrc_nr::common_cfg_t& common_cfg)
 {
   // Best effort to convert NR carrier into LTE cell
@@ -173,6 +173,12 @@ int phy::init_lte(const phy_args_t&            args,
 
   workers_common.params = args;
 
+  // Create the PUSCH job pool before the workers so they can allocate their decoders
+  if (args.nof_pusch_threads > 0 and not cfg.phy_cell_cfg.empty()) {
+    workers_common.pusch_job_pool.reset(new isrran::task_thread_pool(
+        args.nof_pusch_threads, false, WORKERS_THREAD_PRIO, 255, isrran::thread_role::phy_worker));
+  }
+
   workers_common.init(cfg.phy_cell_cfg, cfg.phy_cell_cfg_nr, radio, stack_lte_);
   if (cfg.cfr_config.cfr_enable) {
     workers_common.set_cfr_config(cfg.cfr_config);
@@ -207,6 +213,9 @@ void phy::stop()
     tx_rx.stop();
     workers_common.stop();
     lte_workers.stop();
+    if (workers_common.pusch_job_pool != nullptr) {
+      workers_common.pusch_job_pool->stop();
+    }
     if (nr_workers != nullptr) {
       nr_workers->stop();
     }
@@ -284,6 +293,24 @@ void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
       metrics[j].ul.turbo_iters /= metrics[j].ul.n_samples;
     }
   }
+
+  // NR slot processing latency per stage
+  if (nr_workers != nullptr) {
+    nr::slot_worker::metrics_t nr_metrics = {};
+    nr_workers->get_metrics(nr_metrics);
+    Info("NR slot latency: nof_slots=%d, ul_avg=%.1f us, ul_max=%.1f us, dl_avg=%.1f us, dl_max=%.1f us",
+         nr_metrics.nof_slots,
+         nr_metrics.ul_avg_us,
+         nr_metrics.ul_max_us,
+         nr_metrics.dl_avg_us,
+         nr_metrics.dl_max_us);
+  }
+}
+
+void phy::get_latency_metrics(phy_latency_metrics_t& metrics)
+{
+  workers_common.lte_latency.get_metrics(metrics.lte);
+  workers_common.nr_latency.get_metrics(metrics.nr);
 }
 
 void phy::cmd_cell_gain(uint32_t cell_id, float gain_db)
@@ -376,6 +403,8 @@ int phy::init_nr(const phy_args_t& args, const phy_cfg_t& cfg, stack_interface_p
   worker_args.log.phy_level           = args.log.phy_level;
   worker_args.log.phy_hex_limit       = args.log.phy_hex_limit;
   worker_args.pusch_max_its           = args.nr_pusch_max_its;
+  worker_args.nof_ul_threads          = args.nr_nof_ul_threads;
+  worker_args.latency                 = &workers_common.nr_latency;
 
   if (not nr_workers->init(worker_args, cfg.phy_cell_cfg_nr)) {
     return ISRRAN_ERROR;
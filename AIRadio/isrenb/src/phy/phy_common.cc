@@ -156,6 +156,8 @@ void phy_common::worker_end(const worker_context_t& w_ctx, const bool& tx_enable
 
   // Always transmit on single radio
   radio->tx(tx_buffer, tx_time);
+  lte_latency.record(isrran::tti_stage::rf_tx, w_ctx.sf_idx);
+  nr_latency.record(isrran::tti_stage::rf_tx, w_ctx.sf_idx);
 
   // Reset transmit buffer
   tx_buffer = {};
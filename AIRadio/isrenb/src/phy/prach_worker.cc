@@ -52,6 +52,7 @@ int prach_worker::init(const isrran_cell_t&      cell_,
   nof_sf = (uint32_t)ceilf(prach.T_tot * 1000);
 
   if (nof_workers > 0) {
+    set_role(isrran::thread_role::phy_worker);
     start(priority);
   }
 
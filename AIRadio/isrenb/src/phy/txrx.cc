@@ -24,6 +24,7 @@
 #include "isrenb/hdr/phy/txrx.h"
 #include "isrran/common/band_helper.h"
 #include "isrran/common/threads.h"
+#include "isrran/isrlog/trace_ring.h"
 #include "isrran/isrran.h"
 
 #define Error(fmt, ...)                                                                                                \
@@ -68,6 +69,7 @@ bool txrx::init(enb_time_interface*          enb_,
         new isrran::channel(worker_com->params.ul_channel_args, worker_com->get_nof_rf_channels(), logger));
   }
 
+  set_role(isrran::thread_role::rf);
   start(prio_);
   return true;
 }
@@ -185,8 +187,24 @@ void txrx::run_thread()
       }
     }
 
+    // The TTI clock starts with the receive, so that the RF RX stage is the time spent waiting for the samples
+    if (lte_worker != nullptr) {
+      worker_com->lte_latency.tti_start(tti);
+    }
+    if (nr_worker != nullptr) {
+      worker_com->nr_latency.tti_start(tti);
+    }
     buffer.set_nof_samples(sf_len);
-    radio_h->rx_now(buffer, timestamp);
+    {
+      trace_ring_event("txrx", "rx_now", tti);
+      radio_h->rx_now(buffer, timestamp);
+    }
+    if (lte_worker != nullptr) {
+      worker_com->lte_latency.record(isrran::tti_stage::rf_rx, tti);
+    }
+    if (nr_worker != nullptr) {
+      worker_com->nr_latency.record(isrran::tti_stage::rf_rx, tti);
+    }
 
     if (ul_channel) {
       ul_channel->run(buffer.to_cf_t(), buffer.to_cf_t(), sf_len, timestamp.get(0));
@@ -237,7 +255,10 @@ void txrx::run_thread()
     }
 
     // Advance in time
-    enb->tti_clock();
+    {
+      trace_ring_event("txrx", "tti_clock", tti);
+      enb->tti_clock();
+    }
   }
 }
 
@@ -100,7 +100,11 @@ int enb_stack_lte::init(const stack_args_t&      args_,
 
   // Set up pcap and trace
   if (args.mac_pcap.enable) {
-    mac_pcap.open(args.mac_pcap.filename);
+    isrran::pcap_writer_args writer_args = {};
+    writer_args.pcapng                   = args.mac_pcap.pcapng;
+    writer_args.rotate_size              = (uint64_t)args.mac_pcap.rotate_size_mb * 1024 * 1024;
+    writer_args.rotate_period_s          = args.mac_pcap.rotate_period_s;
+    mac_pcap.open(args.mac_pcap.filename, 0, writer_args);
     mac.start_pcap(&mac_pcap);
   }
 
@@ -151,12 +155,14 @@ int enb_stack_lte::init(const stack_args_t&      args_,
   gtpu_args.mme_addr                     = args.s1ap.mme_addr;
   gtpu_args.gtp_bind_addr                = args.s1ap.gtp_bind_addr;
   gtpu_args.indirect_tunnel_timeout_msec = args.gtpu_indirect_tunnel_timeout_msec;
+  gtpu_args.tx_batch_size                = args.gtpu_tx_batch_size;
   if (gtpu.init(gtpu_args, gtpu_adapter.get()) != ISRRAN_SUCCESS) {
     stack_logger.error("Couldn't initialize GTPU");
     return ISRRAN_ERROR;
   }
 
   started = true;
+  set_role(isrran::thread_role::stack);
   start(STACK_MAIN_THREAD_PRIO);
 
   return ISRRAN_SUCCESS;
@@ -173,6 +179,7 @@ void enb_stack_lte::tti_clock_impl()
 {
   task_sched.tic();
   rrc.tti_clock();
+  gtpu.tti_clock();
 }
 
 void enb_stack_lte::stop()
@@ -224,6 +231,7 @@ bool enb_stack_lte::get_metrics(stack_metrics_t* metrics)
     }
     rrc.get_metrics(metrics.rrc);
     s1ap.get_metrics(metrics.s1ap);
+    gtpu.get_metrics(metrics.gtpu);
     if (not pending_stack_metrics.try_push(metrics)) {
       stack_logger.error("Unable to push metrics to queue");
     }
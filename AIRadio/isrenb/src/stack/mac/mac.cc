@@ -31,6 +31,7 @@
 #include "isrran/interfaces/enb_rlc_interfaces.h"
 #include "isrran/interfaces/enb_rrc_interface_mac.h"
 #include "isrran/isrlog/event_trace.h"
+#include "isrran/isrlog/trace_ring.h"
 
 // #define WRITE_SIB_PCAP
 using namespace asn1::rrc;
@@ -81,8 +82,10 @@ bool mac::init(const mac_args_t&        args_,
 
   // Initiate common pool of softbuffers
   uint32_t nof_prb          = args.nof_prb;
-  auto     init_softbuffers = [nof_prb](void* ptr) {
-    new (ptr) ue_cc_softbuffers(nof_prb, ISRRAN_FDD_NOF_HARQ, ISRRAN_FDD_NOF_HARQ);
+  bool     rx_on_demand     = args.softbuffer_pool;
+  bool     rx_llr_8bit      = args.softbuffer_llr_8bit;
+  auto     init_softbuffers = [nof_prb, rx_on_demand, rx_llr_8bit](void* ptr) {
+    new (ptr) ue_cc_softbuffers(nof_prb, ISRRAN_FDD_NOF_HARQ, ISRRAN_FDD_NOF_HARQ, rx_on_demand, rx_llr_8bit);
   };
   auto recycle_softbuffers = [](ue_cc_softbuffers& softbuffers) { softbuffers.clear(); };
   softbuffer_pool.reset(new isrran::background_obj_pool<ue_cc_softbuffers>(
@@ -261,6 +264,13 @@ void mac::get_metrics(mac_metrics_t& metrics)
     metrics.cc_info[cc].cc_rach_counter = detected_rachs[cc];
     metrics.cc_info[cc].pci             = (cc < cell_config.size()) ? cell_config[cc].cell.id : 0;
   }
+
+  isrran_softbuffer_pool_stats_t pool_stats = {};
+  isrran_softbuffer_pool_get_stats(&pool_stats);
+  metrics.softbuffer_pool.nof_blocks = pool_stats.nof_blocks;
+  metrics.softbuffer_pool.nof_used   = pool_stats.nof_used;
+  metrics.softbuffer_pool.peak_used  = pool_stats.peak_used;
+  metrics.softbuffer_pool.nof_bytes  = pool_stats.nof_bytes;
 }
 
 void mac::toggle_padding()
@@ -637,6 +647,7 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
   }
 
   trace_threshold_complete_event("mac::get_dl_sched", "total_time", std::chrono::microseconds(100));
+  trace_ring_event("mac", "get_dl_sched", tti_tx_dl);
   logger.set_context(TTI_SUB(tti_tx_dl, FDD_HARQ_DELAY_UL_MS));
   if (do_padding) {
     add_padding();
@@ -964,6 +975,8 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
     return ISRRAN_SUCCESS;
   }
 
+  trace_ring_event("mac", "get_ul_sched", tti_tx_ul);
+
   logger.set_context(TTI_SUB(tti_tx_ul, FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS));
 
   isrran::rwlock_read_guard lock(rwlock);
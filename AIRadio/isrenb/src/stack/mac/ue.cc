@@ -32,13 +32,23 @@
 
 namespace isrenb {
 
-ue_cc_softbuffers::ue_cc_softbuffers(uint32_t nof_prb, uint32_t nof_tx_harq_proc_, uint32_t nof_rx_harq_proc_) :
+ue_cc_softbuffers::ue_cc_softbuffers(uint32_t nof_prb,
+                                     uint32_t nof_tx_harq_proc_,
+                                     uint32_t nof_rx_harq_proc_,
+                                     bool     rx_on_demand,
+                                     bool     rx_llr_8bit) :
   nof_tx_harq_proc(nof_tx_harq_proc_), nof_rx_harq_proc(nof_rx_harq_proc_)
 {
   // Create and init Rx buffers
+  int                         max_tbs = isrran_ra_tbs_from_idx(ISRRAN_RA_NOF_TBS_IDX - 1, nof_prb);
+  isrran_softbuffer_rx_args_t rx_args = {};
+  rx_args.max_cb                      = (uint32_t)max_tbs / (ISRRAN_TCOD_MAX_LEN_CB - 24) + 1;
+  rx_args.max_cb_size                 = SOFTBUFFER_SIZE;
+  rx_args.on_demand                   = rx_on_demand;
+  rx_args.llr_8bit                    = rx_llr_8bit;
   softbuffer_rx_list.resize(nof_rx_harq_proc);
   for (isrran_softbuffer_rx_t& buffer : softbuffer_rx_list) {
-    isrran_softbuffer_rx_init(&buffer, nof_prb);
+    isrran_softbuffer_rx_init_args(&buffer, &rx_args);
   }
 
   // Create and init Tx buffers
@@ -214,10 +224,6 @@ ue::~ue() {}
 
 void ue::reset()
 {
-  {
-    std::lock_guard<std::mutex> lock(metrics_mutex);
-    ue_metrics = {};
-  }
   nof_failures = 0;
 
   for (auto& cc : cc_buffers) {
@@ -608,84 +614,68 @@ uint8_t* ue::generate_mch_pdu(uint32_t                             harq_pid,
 /******* METRICS interface ***************/
 void ue::metrics_read(mac_ue_metrics_t* metrics_)
 {
-  uint32_t ul_buffer = sched->get_ul_buffer(rnti);
-  uint32_t dl_buffer = sched->get_dl_buffer(rnti);
+  *metrics_ = {};
+  metrics_reader.update(metrics_counters);
+  read_mac_ue_counters(metrics_reader, *metrics_);
+  metrics_->dl_ri = dl_ri_avg.exchange(0.0f, std::memory_order_relaxed);
 
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  ue_metrics.rnti      = rnti;
-  ue_metrics.ul_buffer = ul_buffer;
-  ue_metrics.dl_buffer = dl_buffer;
+  metrics_->rnti      = rnti;
+  metrics_->ul_buffer = sched->get_ul_buffer(rnti);
+  metrics_->dl_buffer = sched->get_dl_buffer(rnti);
 
   // set PCell sector id
   std::array<int, ISRRAN_MAX_CARRIERS> cc_list = sched->get_enb_ue_cc_map(rnti);
   auto                                 it      = std::find(cc_list.begin(), cc_list.end(), 0);
-  ue_metrics.cc_idx                            = std::distance(cc_list.begin(), it);
-
-  *metrics_ = ue_metrics;
-
-  phr_counter    = 0;
-  dl_cqi_counter = 0;
-  ue_metrics     = {};
+  metrics_->cc_idx                             = std::distance(cc_list.begin(), it);
 }
 
 void ue::metrics_phr(float phr)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  ue_metrics.phr = ISRRAN_VEC_CMA(phr, ue_metrics.phr, phr_counter);
-  phr_counter++;
+  metrics_counters.add_sample(mac_ue_counter::phr_sum, mac_ue_counter::phr_samples, phr);
 }
 
 void ue::metrics_dl_ri(uint32_t dl_ri)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  if (ue_metrics.dl_ri == 0.0f) {
-    ue_metrics.dl_ri = (float)dl_ri + 1.0f;
-  } else {
-    ue_metrics.dl_ri = ISRRAN_VEC_EMA((float)dl_ri + 1.0f, ue_metrics.dl_ri, 0.5f);
+  float ri  = (float)dl_ri + 1.0f;
+  float avg = dl_ri_avg.load(std::memory_order_relaxed);
+  while (not dl_ri_avg.compare_exchange_weak(
+      avg, avg == 0.0f ? ri : ISRRAN_VEC_EMA(ri, avg, 0.5f), std::memory_order_relaxed)) {
   }
-  dl_ri_counter++;
 }
 
 void ue::metrics_dl_pmi(uint32_t dl_ri)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  ue_metrics.dl_pmi = ISRRAN_VEC_CMA((float)dl_ri, ue_metrics.dl_pmi, dl_pmi_counter);
-  dl_pmi_counter++;
+  metrics_counters.add_sample(mac_ue_counter::dl_pmi_sum, mac_ue_counter::dl_pmi_samples, dl_ri);
 }
 
 void ue::metrics_dl_cqi(uint32_t dl_cqi)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  ue_metrics.dl_cqi = ISRRAN_VEC_CMA((float)dl_cqi, ue_metrics.dl_cqi, dl_cqi_counter);
-  dl_cqi_counter++;
+  metrics_counters.add_sample(mac_ue_counter::dl_cqi_sum, mac_ue_counter::dl_cqi_samples, dl_cqi);
 }
 
 void ue::metrics_rx(bool crc, uint32_t tbs)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
   if (crc) {
-    ue_metrics.rx_brate += tbs * 8;
+    metrics_counters.add(mac_ue_counter::rx_bits, tbs * 8);
   } else {
-    ue_metrics.rx_errors++;
+    metrics_counters.add(mac_ue_counter::rx_errors);
   }
-  ue_metrics.rx_pkts++;
+  metrics_counters.add(mac_ue_counter::rx_pkts);
 }
 
 void ue::metrics_tx(bool crc, uint32_t tbs)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
   if (crc) {
-    ue_metrics.tx_brate += tbs * 8;
+    metrics_counters.add(mac_ue_counter::tx_bits, tbs * 8);
   } else {
-    ue_metrics.tx_errors++;
+    metrics_counters.add(mac_ue_counter::tx_errors);
   }
-  ue_metrics.tx_pkts++;
+  metrics_counters.add(mac_ue_counter::tx_pkts);
 }
 
 void ue::metrics_cnt()
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  ue_metrics.nof_tti++;
+  metrics_counters.add(mac_ue_counter::nof_tti);
 }
 
 void ue::tic()
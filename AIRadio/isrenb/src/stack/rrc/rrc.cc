@@ -78,6 +78,7 @@ int32_t rrc::init(const rrc_cfg_t&       cfg_,
   rrc_nr = rrc_nr_;
 
   cfg = cfg_;
+  msg_cache.invalidate();
 
   if (cfg.sibs[12].type() == asn1::rrc::sys_info_r8_ies_s::sib_type_and_info_item_c_::types::sib13_v920 &&
       cfg.enable_mbsfn) {
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include "isrenb/hdr/stack/rrc/rrc_msg_cache.h"
+#include "isrran/support/isrran_assert.h"
+
+using namespace asn1::rrc;
+
+namespace isrenb {
+
+namespace {
+
+template <typename Msg>
+auto& con_setup_phy_cfg(Msg& msg)
+{
+  return msg.msg.c1().rrc_conn_setup().crit_exts.c1().rrc_conn_setup_r8().rr_cfg_ded.phys_cfg_ded;
+}
+
+/// Dedicated fields of the RRCConnectionSetup, with or without periodic CQI resources
+const std::vector<asn1::encoded_msg_template<dl_ccch_msg_s>::field_t>& con_setup_fields(bool periodic_cqi)
+{
+  using field_t = asn1::encoded_msg_template<dl_ccch_msg_s>::field_t;
+  auto set_transaction_id = [](dl_ccch_msg_s& msg, uint32_t v) {
+    msg.msg.c1().rrc_conn_setup().rrc_transaction_id = v;
+  };
+  auto set_sr_pucch_res = [](dl_ccch_msg_s& msg, uint32_t v) {
+    con_setup_phy_cfg(msg).sched_request_cfg.setup().sr_pucch_res_idx = v;
+  };
+  auto set_sr_cfg_idx = [](dl_ccch_msg_s& msg, uint32_t v) {
+    con_setup_phy_cfg(msg).sched_request_cfg.setup().sr_cfg_idx = v;
+  };
+  auto set_cqi_pucch_res = [](dl_ccch_msg_s& msg, uint32_t v) {
+    con_setup_phy_cfg(msg).cqi_report_cfg.cqi_report_periodic.setup().cqi_pucch_res_idx = v;
+  };
+  auto set_cqi_pmi_idx = [](dl_ccch_msg_s& msg, uint32_t v) {
+    con_setup_phy_cfg(msg).cqi_report_cfg.cqi_report_periodic.setup().cqi_pmi_cfg_idx = v;
+  };
+
+  static const std::vector<field_t> sr_fields  = {{set_transaction_id, 0, 3},
+                                                  {set_sr_pucch_res, 0, 2047},
+                                                  {set_sr_cfg_idx, 0, 157}};
+  static const std::vector<field_t> cqi_fields = {{set_transaction_id, 0, 3},
+                                                  {set_sr_pucch_res, 0, 2047},
+                                                  {set_sr_cfg_idx, 0, 157},
+                                                  {set_cqi_pucch_res, 0, 1185},
+                                                  {set_cqi_pmi_idx, 0, 1023}};
+  return periodic_cqi ? cqi_fields : sr_fields;
+}
+
+} // namespace
+
+void rrc_msg_cache::invalidate()
+{
+  cfg_version++;
+  con_setup.clear();
+}
+
+bool rrc_msg_cache::encode_con_setup(const dl_ccch_msg_s& msg, isrran::byte_buffer_t& pdu)
+{
+  const phys_cfg_ded_s& phy_cfg = con_setup_phy_cfg(msg);
+  if (not phy_cfg.sched_request_cfg_present or phy_cfg.sched_request_cfg.type().value != setup_e::setup) {
+    return false;
+  }
+  const cqi_report_cfg_s& cqi_cfg      = phy_cfg.cqi_report_cfg;
+  bool                    periodic_cqi = phy_cfg.cqi_report_cfg_present and cqi_cfg.cqi_report_periodic_present and
+                      cqi_cfg.cqi_report_periodic.type().value == setup_e::setup;
+
+  // The first RRCConnectionSetup of each configuration becomes the template of the following ones
+  if (con_setup_version != cfg_version or con_setup_cqi != periodic_cqi) {
+    con_setup_version = cfg_version;
+    con_setup_cqi     = periodic_cqi;
+    if (not con_setup.build(msg, con_setup_fields(periodic_cqi))) {
+      logger.warning("RRCConnectionSetup could not be pre-encoded. It will be packed for every UE");
+    }
+  }
+  if (con_setup.empty()) {
+    return false;
+  }
+
+  std::array<uint32_t, 5> values = {msg.msg.c1().rrc_conn_setup().rrc_transaction_id,
+                                    phy_cfg.sched_request_cfg.setup().sr_pucch_res_idx,
+                                    phy_cfg.sched_request_cfg.setup().sr_cfg_idx,
+                                    0,
+                                    0};
+  if (periodic_cqi) {
+    values[3] = cqi_cfg.cqi_report_periodic.setup().cqi_pucch_res_idx;
+    values[4] = cqi_cfg.cqi_report_periodic.setup().cqi_pmi_cfg_idx;
+  }
+  if (not con_setup.encode(pdu, isrran::span<const uint32_t>(values.data(), con_setup_fields(periodic_cqi).size()))) {
+    return false;
+  }
+
+#ifdef SANITY_CHECKS_ENABLED
+  // Only the SR/CQI presence is checked above, the other fields must be the ones of the template
+  if (not con_setup.matches(msg, pdu)) {
+    logger.error("RRCConnectionSetup differs from the pre-encoded one in fields that are not patched. It will be "
+                 "packed for every UE");
+    con_setup.clear();
+    return false;
+  }
+#endif
+  return true;
+}
+
+} // namespace isrenb
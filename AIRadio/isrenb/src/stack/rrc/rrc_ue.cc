@@ -330,9 +330,11 @@ bool rrc::ue::is_idle()
 
 void rrc::ue::parse_ul_dcch(uint32_t lcid, isrran::unique_byte_buffer_t pdu)
 {
+  // The members of the decoded message are allocated from the arena, which is released after the message
+  asn1::arena    msg_arena;
   ul_dcch_msg_s  ul_dcch_msg;
   asn1::cbit_ref bref(pdu->msg, pdu->N_bytes);
-  if (ul_dcch_msg.unpack(bref) != asn1::ISRASN_SUCCESS or
+  if (asn1::unpack_in_arena(ul_dcch_msg, bref, msg_arena) != asn1::ISRASN_SUCCESS or
       ul_dcch_msg.msg.type().value != ul_dcch_msg_type_c::types_opts::c1) {
     parent->log_rx_pdu_fail(rnti, lcid, *pdu, "Failed to unpack UL-DCCH message");
     return;
@@ -1302,12 +1304,16 @@ void rrc::ue::send_dl_ccch(dl_ccch_msg_s* dl_ccch_msg, std::string* octet_str)
   // Allocate a new PDU buffer, pack the message and send to PDCP
   isrran::unique_byte_buffer_t pdu = isrran::make_byte_buffer();
   if (pdu) {
-    asn1::bit_ref bref(pdu->msg, pdu->get_tailroom());
-    if (dl_ccch_msg->pack(bref) != asn1::ISRASN_SUCCESS) {
-      parent->logger.error(pdu->msg, pdu->N_bytes, "Failed to pack DL-CCCH-Msg:");
-      return;
+    // RRCConnectionSetup is patched into the message pre-encoded for the current configuration
+    bool is_con_setup = dl_ccch_msg->msg.c1().type().value == dl_ccch_msg_type_c::c1_c_::types_opts::rrc_conn_setup;
+    if (not is_con_setup or not parent->msg_cache.encode_con_setup(*dl_ccch_msg, *pdu)) {
+      asn1::bit_ref bref(pdu->msg, pdu->get_tailroom());
+      if (dl_ccch_msg->pack(bref) != asn1::ISRASN_SUCCESS) {
+        parent->logger.error(pdu->msg, pdu->N_bytes, "Failed to pack DL-CCCH-Msg:");
+        return;
+      }
+      pdu->N_bytes = (uint32_t)bref.distance_bytes();
     }
-    pdu->N_bytes = (uint32_t)bref.distance_bytes();
 
     // Log Tx message
     parent->log_rrc_message(
@@ -686,10 +686,12 @@ bool s1ap::handle_s1ap_rx_pdu(isrran::byte_buffer_t* pdu)
     pcap->write_s1ap(pdu->msg, pdu->N_bytes);
   }
 
+  // The members of the decoded message are allocated from the arena, which is released after the message
+  asn1::arena    msg_arena;
   s1ap_pdu_c     rx_pdu;
   asn1::cbit_ref bref(pdu->msg, pdu->N_bytes);
 
-  if (rx_pdu.unpack(bref) != asn1::ISRASN_SUCCESS) {
+  if (asn1::unpack_in_arena(rx_pdu, bref, msg_arena) != asn1::ISRASN_SUCCESS) {
     logger.error(pdu->msg, pdu->N_bytes, "Failed to unpack received PDU");
     cause_c cause;
     cause.set_protocol().value = cause_protocol_opts::transfer_syntax_error;
@@ -411,11 +411,20 @@ int gtpu::init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_)
     return ISRRAN_ERROR;
   }
 
-  // Assign a handler to rx S1U packets
-  auto rx_callback = [this](isrran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
-    handle_gtpu_s1u_rx_packet(std::move(pdu), from);
-  };
-  rx_socket_handler->add_socket_handler(fd, isrran::make_sdu_handler(logger, gtpu_queue, rx_callback));
+  // UL PDUs are queued and sent with one sendmmsg call per batch
+  if (args.tx_batch_size > 1) {
+    tx_batch.reserve(args.tx_batch_size);
+    tx_msgs.resize(args.tx_batch_size);
+    tx_iovs.resize(args.tx_batch_size);
+    tx_cmsgs.resize(args.tx_batch_size);
+  }
+#ifndef UDP_SEGMENT
+  tx_gso = false;
+#endif
+
+  // Assign a handler to rx S1U packets. Bursts of datagrams are read with one system call and handled in one task
+  auto rx_callback = [this](isrran::recvfrom_burst_t& burst) { handle_gtpu_s1u_rx_burst(burst); };
+  rx_socket_handler->add_edge_socket_handler(fd, isrran::make_sdu_burst_handler(logger, gtpu_queue, rx_callback));
 
   // Start MCH socket if enabled
   if (args.embms_enable) {
@@ -429,6 +438,7 @@ int gtpu::init(const gtpu_args_t& gtpu_args, pdcp_interface_gtpu* pdcp_)
 void gtpu::stop()
 {
   if (fd > 0) {
+    flush_tx_batch();
     close(fd);
     fd = -1;
   }
@@ -481,9 +491,193 @@ void gtpu::send_pdu_to_tunnel(const gtpu_tunnel& tx_tun, isrran::unique_byte_buf
     logger.error("Error writing GTP-U Header. Flags 0x%x, Message Type 0x%x", header.flags, header.message_type);
     return;
   }
-  if (sendto(fd, pdu->msg, pdu->N_bytes, MSG_EOR, (struct sockaddr*)&servaddr, sizeof(struct sockaddr_in)) < 0) {
-    perror("sendto");
+  send_pdu(std::move(pdu), servaddr);
+}
+
+void gtpu::send_pdu(isrran::unique_byte_buffer_t pdu, const sockaddr_in& addr)
+{
+  if (args.tx_batch_size <= 1) {
+    metrics.tx_batches++;
+    metrics.tx_syscalls++;
+    metrics.max_tx_batch = 1;
+    if (sendto(fd, pdu->msg, pdu->N_bytes, MSG_EOR, (struct sockaddr*)&addr, sizeof(struct sockaddr_in)) < 0) {
+      perror("sendto");
+    } else {
+      metrics.tx_pdus++;
+    }
+    return;
+  }
+
+  tx_batch.push_back(tx_pdu_t{std::move(pdu), addr});
+  if (tx_batch.size() >= args.tx_batch_size) {
+    flush_tx_batch();
+  }
+}
+
+void gtpu::flush_tx_batch()
+{
+  if (tx_batch.empty()) {
+    return;
+  }
+  metrics.tx_batches++;
+  metrics.max_tx_batch = std::max(metrics.max_tx_batch, (uint32_t)tx_batch.size());
+
+  size_t first_pdu = 0;
+  while (first_pdu < tx_batch.size()) {
+    first_pdu += send_tx_pdus(first_pdu);
   }
+  tx_batch.clear();
+}
+
+/// Sends the queued PDUs from first_pdu on with one sendmmsg call, and returns the number of PDUs that were handled,
+/// i.e. either sent or dropped. Consecutive PDUs to the same peer are coalesced into one UDP GSO message while they
+/// have the size of the first, the last segment being allowed to be shorter, and while the segments fit in the path
+/// MTU towards the peer
+size_t gtpu::send_tx_pdus(size_t first_pdu)
+{
+  size_t nof_msgs = 0;
+  size_t seg_size = 0;
+  size_t msg_size = 0;
+  bool   seg_fits = false;
+  for (size_t i = first_pdu; i < tx_batch.size(); ++i) {
+    tx_pdu_t& tx        = tx_batch[i];
+    tx_iovs[i].iov_base = tx.pdu->msg;
+    tx_iovs[i].iov_len  = tx.pdu->N_bytes;
+
+    if (seg_fits and nof_msgs > 0) {
+      msghdr&            prev      = tx_msgs[nof_msgs - 1].msg_hdr;
+      const sockaddr_in& prev_addr = *(const sockaddr_in*)prev.msg_name;
+      if (tx.addr.sin_addr.s_addr == prev_addr.sin_addr.s_addr and tx.addr.sin_port == prev_addr.sin_port and
+          tx.pdu->N_bytes <= seg_size and prev.msg_iovlen < max_gso_segments and
+          msg_size + tx.pdu->N_bytes <= max_gso_bytes) {
+        prev.msg_iovlen++;
+        msg_size += tx.pdu->N_bytes;
+        if (tx.pdu->N_bytes < seg_size) {
+          // A shorter segment ends the message
+          seg_fits = false;
+        }
+        continue;
+      }
+    }
+
+    msghdr& msg     = tx_msgs[nof_msgs++].msg_hdr;
+    msg             = {};
+    msg.msg_name    = &tx.addr;
+    msg.msg_namelen = sizeof(sockaddr_in);
+    msg.msg_iov     = &tx_iovs[i];
+    msg.msg_iovlen  = 1;
+    seg_size        = tx.pdu->N_bytes;
+    msg_size        = tx.pdu->N_bytes;
+    seg_fits        = tx_gso and seg_size + udp_ip_hdr_size <= get_path_mtu(tx.addr.sin_addr.s_addr);
+  }
+
+#ifdef UDP_SEGMENT
+  for (size_t k = 0; k < nof_msgs; ++k) {
+    msghdr& msg = tx_msgs[k].msg_hdr;
+    if (msg.msg_iovlen > 1) {
+      msg.msg_control           = tx_cmsgs[k].buf;
+      msg.msg_controllen        = sizeof(tx_cmsgs[k].buf);
+      cmsghdr* cm               = CMSG_FIRSTHDR(&msg);
+      cm->cmsg_level            = SOL_UDP;
+      cm->cmsg_type             = UDP_SEGMENT;
+      cm->cmsg_len              = CMSG_LEN(sizeof(uint16_t));
+      *(uint16_t*)CMSG_DATA(cm) = msg.msg_iov[0].iov_len;
+    }
+  }
+#endif
+
+  int ret = sendmmsg(fd, tx_msgs.data(), nof_msgs, 0);
+  metrics.tx_syscalls++;
+  if (ret > 0) {
+    size_t nof_pdus = 0;
+    for (int k = 0; k < ret; ++k) {
+      size_t nof_segs = tx_msgs[k].msg_hdr.msg_iovlen;
+      nof_pdus += nof_segs;
+      if (nof_segs > 1) {
+        metrics.tx_gso_pdus += nof_segs;
+      }
+    }
+    metrics.tx_pdus += nof_pdus;
+    return nof_pdus;
+  }
+
+  // The first message could not be sent. Only its PDUs may be dropped, the following ones are sent by the next call
+  const msghdr& msg = tx_msgs[0].msg_hdr;
+  if (msg.msg_iovlen == 1) {
+    logger.error("Failed to send UL GTP-U PDU. Cause: %s", strerror(errno));
+    return 1;
+  }
+  if (errno == EIO or errno == EINVAL or errno == ENOPROTOOPT) {
+    // The kernel or the output device does not support UDP GSO
+    logger.warning("Disabling UDP GSO for GTP-U. Cause: %s", strerror(errno));
+    tx_gso = false;
+    return send_tx_pdus(first_pdu);
+  }
+  if (errno == EMSGSIZE) {
+    // The path MTU towards the peer is smaller than the cached one, query it again for the next messages
+    tx_path_mtu.erase(((const sockaddr_in*)msg.msg_name)->sin_addr.s_addr);
+  }
+  logger.warning("Failed to send UL GTP-U GSO message, sending its PDUs one by one. Cause: %s", strerror(errno));
+  return send_tx_segments(msg);
+}
+
+/// Sends the PDUs of a GSO message with one sendto each, and returns their number
+size_t gtpu::send_tx_segments(const msghdr& msg)
+{
+  for (size_t k = 0; k < msg.msg_iovlen; ++k) {
+    metrics.tx_syscalls++;
+    if (sendto(fd, msg.msg_iov[k].iov_base, msg.msg_iov[k].iov_len, 0, (const sockaddr*)msg.msg_name, msg.msg_namelen) <
+        0) {
+      logger.error("Failed to send UL GTP-U PDU. Cause: %s", strerror(errno));
+    } else {
+      metrics.tx_pdus++;
+    }
+  }
+  return msg.msg_iovlen;
+}
+
+/// Returns the path MTU towards the peer, read from a socket connected to it the first time. Returns 0 if it could not
+/// be read, in which case no PDUs are coalesced towards the peer
+uint32_t gtpu::get_path_mtu(in_addr_t addr)
+{
+  auto it = tx_path_mtu.find(addr);
+  if (it != tx_path_mtu.end()) {
+    return it->second;
+  }
+
+  uint32_t    mtu      = 0;
+  sockaddr_in peer     = {};
+  peer.sin_family      = AF_INET;
+  peer.sin_addr.s_addr = addr;
+  peer.sin_port        = htons(GTPU_PORT);
+  int probe_fd         = socket(AF_INET, SOCK_DGRAM, 0);
+  if (probe_fd >= 0) {
+    int       value = 0;
+    socklen_t len   = sizeof(value);
+    if (connect(probe_fd, (const sockaddr*)&peer, sizeof(peer)) == 0 and
+        getsockopt(probe_fd, IPPROTO_IP, IP_MTU, &value, &len) == 0 and value > 0) {
+      mtu = (uint32_t)value;
+    }
+    close(probe_fd);
+  }
+  if (mtu == 0) {
+    fmt::memory_buffer addrbuf;
+    isrran::gtpu_ntoa(addrbuf, addr);
+    logger.warning("Could not read the path MTU towards %s, UL GTP-U PDUs are sent without GSO", isrran::to_c_str(addrbuf));
+  }
+  tx_path_mtu[addr] = mtu;
+  return mtu;
+}
+
+void gtpu::tti_clock()
+{
+  flush_tx_batch();
+}
+
+void gtpu::get_metrics(gtpu_metrics_t& m)
+{
+  m       = metrics;
+  metrics = {};
 }
 
 isrran::expected<uint32_t> gtpu::add_bearer(uint16_t            rnti,
@@ -616,42 +810,98 @@ void gtpu::handle_gtpu_s1u_rx_packet(isrran::unique_byte_buffer_t pdu, const soc
   isrran_assert(pdu != nullptr, "Called with null PDU");
 
   logger.debug("Received %d bytes from S1-U interface", pdu->N_bytes);
+
+  gtpu_header_t      header;
+  const gtpu_tunnel* tun_ptr = read_s1u_header(pdu.get(), addr, header);
+  if (tun_ptr == nullptr) {
+    return;
+  }
+  handle_s1u_msg(header, *tun_ptr, std::move(pdu));
+}
+
+void gtpu::handle_gtpu_s1u_rx_burst(isrran::recvfrom_burst_t& burst)
+{
+  logger.debug("Received burst of %zd PDUs from S1-U interface", burst.pdus.size());
+
+  // G-PDUs of tunnels with active PDCP are grouped by bearer and written to PDCP at once. Any other message is
+  // handled after the SDUs grouped so far, as it may change the state of the tunnels
+  const gtpu_tunnel* last_tun = nullptr;
+  for (size_t i = 0; i < burst.pdus.size(); ++i) {
+    isrran::unique_byte_buffer_t& pdu = burst.pdus[i];
+    isrran_assert(pdu != nullptr, "Called with null PDU");
+
+    gtpu_header_t      header;
+    const gtpu_tunnel* tun_ptr = read_s1u_header(pdu.get(), burst.from[i], header, last_tun);
+    if (tun_ptr == nullptr) {
+      continue;
+    }
+
+    if (header.message_type == GTPU_MSG_DATA_PDU and
+        tun_ptr->state == gtpu_tunnel_manager::tunnel_state::pdcp_active) {
+      uint32_t pdcp_sn = undefined_pdcp_sn;
+      if (read_data_pdu(header, *tun_ptr, pdu, pdcp_sn)) {
+        if (tun_ptr != last_tun) {
+          tunnels.handle_rx_pdcp_sdu(tun_ptr->teid_in);
+        }
+        group_dl_sdu(*tun_ptr, std::move(pdu), pdcp_sn);
+      }
+      last_tun = tun_ptr;
+      continue;
+    }
+
+    flush_dl_sdu_groups();
+    last_tun = nullptr;
+    handle_s1u_msg(header, *tun_ptr, std::move(pdu));
+  }
+  flush_dl_sdu_groups();
+}
+
+const gtpu_tunnel* gtpu::read_s1u_header(isrran::byte_buffer_t* pdu,
+                                         const sockaddr_in&     addr,
+                                         gtpu_header_t&         header,
+                                         const gtpu_tunnel*     last_tunnel)
+{
   pdu->set_timestamp();
 
   // Decode GTPU Header
-  gtpu_header_t header;
-  if (not gtpu_read_header(pdu.get(), &header, logger)) {
-    return;
+  if (not gtpu_read_header(pdu, &header, logger)) {
+    return nullptr;
   }
 
   if (header.message_type == GTPU_MSG_ECHO_REQUEST) {
     // Echo request - send response
     echo_response(addr.sin_addr.s_addr, addr.sin_port, header.seq_number);
-    return;
+    return nullptr;
   }
   if (header.message_type == GTPU_MSG_ERROR_INDICATION) {
     logger.warning("Received Error Indication");
-    return;
+    return nullptr;
   }
   if (header.teid == 0) {
     logger.warning("Received GTPU S1-U message with " TEID_IN_FMT, header.teid);
   }
 
-  // Find TEID present in GTPU Header
+  // Find TEID present in GTPU Header. Consecutive PDUs of a burst usually belong to the same tunnel
+  if (last_tunnel != nullptr and last_tunnel->teid_in == header.teid) {
+    return last_tunnel;
+  }
   const gtpu_tunnel* tun_ptr = tunnels.find_tunnel(header.teid);
   if (tun_ptr == nullptr) {
     // Received G-PDU for non-existing and non-zero TEID.
     // Sending GTP-U error indication
     error_indication(addr.sin_addr.s_addr, addr.sin_port, header.teid);
-    return;
   }
+  return tun_ptr;
+}
 
+void gtpu::handle_s1u_msg(const gtpu_header_t& header, const gtpu_tunnel& rx_tunnel, isrran::unique_byte_buffer_t pdu)
+{
   switch (header.message_type) {
     case GTPU_MSG_DATA_PDU: {
-      handle_msg_data_pdu(header, *tun_ptr, std::move(pdu));
+      handle_msg_data_pdu(header, rx_tunnel, std::move(pdu));
     } break;
     case GTPU_MSG_END_MARKER:
-      handle_end_marker(*tun_ptr);
+      handle_end_marker(rx_tunnel);
       break;
     default:
       logger.warning("Unhandled GTPU message type=%d", header.message_type);
@@ -659,27 +909,39 @@ void gtpu::handle_gtpu_s1u_rx_packet(isrran::unique_byte_buffer_t pdu, const soc
   }
 }
 
-void gtpu::handle_msg_data_pdu(const gtpu_header_t&         header,
-                               const gtpu_tunnel&           rx_tunnel,
-                               isrran::unique_byte_buffer_t pdu)
+bool gtpu::read_data_pdu(const gtpu_header_t&          header,
+                         const gtpu_tunnel&            rx_tunnel,
+                         isrran::unique_byte_buffer_t& pdu,
+                         uint32_t&                     pdcp_sn)
 {
   struct iphdr* ip_pkt = (struct iphdr*)pdu->msg;
   if (ip_pkt->version != 4 && ip_pkt->version != 6) {
     logger.error("Received SDU with invalid IP version=%d", (int)ip_pkt->version);
-    return;
+    return false;
   }
 
-  // Forward SDU to PDCP or buffer it if tunnel is disabled
-  uint32_t pdcp_sn = undefined_pdcp_sn;
+  pdcp_sn = undefined_pdcp_sn;
   if ((header.flags & GTPU_FLAGS_EXTENDED_HDR) != 0 and header.next_ext_hdr_type == GTPU_EXT_HEADER_PDCP_PDU_NUMBER) {
     pdcp_sn = (header.ext_buffer[1] << 8U) + header.ext_buffer[2];
   }
 
+  log_message(rx_tunnel, true, isrran::make_span(pdu));
+  return true;
+}
+
+void gtpu::handle_msg_data_pdu(const gtpu_header_t&         header,
+                               const gtpu_tunnel&           rx_tunnel,
+                               isrran::unique_byte_buffer_t pdu)
+{
+  uint32_t pdcp_sn = undefined_pdcp_sn;
+  if (not read_data_pdu(header, rx_tunnel, pdu, pdcp_sn)) {
+    return;
+  }
+
+  // Forward SDU to PDCP or buffer it if tunnel is disabled
   uint16_t rnti          = rx_tunnel.rnti;
   uint16_t eps_bearer_id = rx_tunnel.eps_bearer_id;
 
-  log_message(rx_tunnel, true, isrran::make_span(pdu));
-
   tunnels.handle_rx_pdcp_sdu(rx_tunnel.teid_in);
 
   switch (rx_tunnel.state) {
@@ -703,6 +965,39 @@ void gtpu::handle_msg_data_pdu(const gtpu_header_t&         header,
   }
 }
 
+void gtpu::group_dl_sdu(const gtpu_tunnel& rx_tunnel, isrran::unique_byte_buffer_t sdu, uint32_t pdcp_sn)
+{
+  dl_sdu_group* group = nullptr;
+  for (size_t i = 0; i < nof_dl_sdu_groups; ++i) {
+    if (dl_sdu_groups[i].rnti == rx_tunnel.rnti and dl_sdu_groups[i].eps_bearer_id == rx_tunnel.eps_bearer_id) {
+      group = &dl_sdu_groups[i];
+      break;
+    }
+  }
+  if (group == nullptr) {
+    // groups and their SDU vectors are reused across bursts
+    if (nof_dl_sdu_groups == dl_sdu_groups.size()) {
+      dl_sdu_groups.emplace_back();
+    }
+    group                = &dl_sdu_groups[nof_dl_sdu_groups++];
+    group->rnti          = rx_tunnel.rnti;
+    group->eps_bearer_id = rx_tunnel.eps_bearer_id;
+  }
+  group->sdus.push_back(std::move(sdu));
+  group->pdcp_sns.push_back(pdcp_sn == undefined_pdcp_sn ? -1 : (int)pdcp_sn);
+}
+
+void gtpu::flush_dl_sdu_groups()
+{
+  for (size_t i = 0; i < nof_dl_sdu_groups; ++i) {
+    dl_sdu_group& group = dl_sdu_groups[i];
+    pdcp->write_sdus(group.rnti, group.eps_bearer_id, group.sdus, group.pdcp_sns);
+    group.sdus.clear();
+    group.pdcp_sns.clear();
+  }
+  nof_dl_sdu_groups = 0;
+}
+
 void gtpu::handle_gtpu_m1u_rx_packet(isrran::unique_byte_buffer_t pdu, const sockaddr_in& addr)
 {
   m1u.handle_rx_packet(std::move(pdu), addr);
@@ -830,6 +1125,9 @@ bool gtpu::send_end_marker(uint32_t teidin)
   servaddr.sin_addr.s_addr    = htonl(tx_tun->spgw_addr);
   servaddr.sin_port           = htons(GTPU_PORT);
 
+  // The End Marker must follow the last G-PDU of the tunnel
+  flush_tx_batch();
+
   bool success =
       sendto(fd, pdu->msg, pdu->N_bytes, MSG_EOR, (struct sockaddr*)&servaddr, sizeof(struct sockaddr_in)) > 0;
   if (success) {
@@ -184,6 +184,24 @@ void pdcp::write_sdu(uint16_t rnti, uint32_t lcid, isrran::unique_byte_buffer_t
   }
 }
 
+void pdcp::write_sdus(uint16_t                                   rnti,
+                      uint32_t                                   lcid,
+                      isrran::span<isrran::unique_byte_buffer_t> sdus,
+                      isrran::span<const int>                    pdcp_sns)
+{
+  auto user_it = users.find(rnti);
+  if (user_it == users.end()) {
+    return;
+  }
+  for (size_t i = 0; i < sdus.size(); ++i) {
+    if (rnti != ISRRAN_MRNTI) {
+      user_it->second.pdcp->write_sdu(lcid, std::move(sdus[i]), pdcp_sns[i]);
+    } else {
+      user_it->second.pdcp->write_sdu_mch(lcid, std::move(sdus[i]));
+    }
+  }
+}
+
 void pdcp::send_status_report(uint16_t rnti, uint32_t lcid)
 {
   if (users.count(rnti)) {
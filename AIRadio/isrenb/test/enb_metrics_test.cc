@@ -151,6 +151,16 @@ public:
     metrics[3].stack.mac.ues[0].dl_pmi    = 1.0;
     metrics[3].stack.mac.ues[0].phr       = 12.0;
     metrics[3].phy.resize(0); // no PHY metrics for this UE
+
+    // TTI latency with a deadline miss
+    isrran::tti_stage_latency_t& tx_latency = metrics[1].phy_latency.lte.stages[(uint32_t)isrran::tti_stage::rf_tx];
+    metrics[1].phy_latency.lte.deadline_us  = 3000;
+    tx_latency.nof_samples                  = 1000;
+    tx_latency.nof_deadline_misses          = 1;
+    tx_latency.p50_us                       = 850;
+    tx_latency.p99_us                       = 1900;
+    tx_latency.p999_us                      = 2800;
+    tx_latency.max_us                       = 3400;
   }
 
   bool get_metrics(enb_metrics_t* m)
@@ -28,6 +28,7 @@
 #include <boost/program_options/parsers.hpp>
 #include <iostream>
 #include <mutex>
+#include <set>
 #include <isrenb/hdr/phy/phy.h>
 #include <isrran/common/string_helpers.h>
 #include <isrran/common/test_common.h>
@@ -275,17 +276,21 @@ private:
   static constexpr float    prob_dl_grant = 0.50f;
   static constexpr float    prob_ul_grant = 0.10f;
   static constexpr uint32_t cfi           = 2;
+  static constexpr uint32_t max_nof_ues   = 4;
+
+  typedef isrran_softbuffer_rx_t ue_softbuffer_rx_t[ISRRAN_MAX_CARRIERS][ISRRAN_FDD_NOF_HARQ];
 
   isrenb::phy_cell_cfg_list_t                       phy_cell_cfg;
   isrenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t phy_rrc;
   std::mutex                                        mutex;
   std::condition_variable                           cvar;
   isrlog::basic_logger&                             logger;
-  isrran_softbuffer_tx_t                            softbuffer_tx                                           = {};
-  isrran_softbuffer_rx_t                            softbuffer_rx[ISRRAN_MAX_CARRIERS][ISRRAN_FDD_NOF_HARQ] = {};
-  uint8_t*                                          data                                                    = nullptr;
-  uint16_t                                          ue_rnti                                                 = 0;
-  isrran_random_t                                   random_gen                                              = nullptr;
+  isrran_softbuffer_tx_t                            softbuffer_tx              = {};
+  ue_softbuffer_rx_t                                softbuffer_rx[max_nof_ues] = {};
+  uint8_t*                                          data                       = nullptr;
+  uint16_t                                          ue_rnti                    = 0;
+  uint32_t                                          nof_ues                    = 1;
+  isrran_random_t                                   random_gen                 = nullptr;
 
   CALLBACK(sr_detected);
   CALLBACK(rach_detected);
@@ -314,6 +319,7 @@ private:
   typedef struct {
     uint32_t tti;
     uint32_t cc_idx;
+    uint16_t rnti;
     bool     crc;
   } tti_ul_info_t;
 
@@ -336,26 +342,34 @@ private:
   std::queue<tti_cqi_info_t> tti_cqi_info_queue;
   std::vector<uint32_t>      active_cell_list;
 
-  uint32_t              nof_locations[ISRRAN_NOF_SF_X_FRAME]                           = {};
-  isrran_dci_location_t dci_locations[ISRRAN_NOF_SF_X_FRAME][ISRRAN_MAX_CANDIDATES_UE] = {};
-  uint32_t              ul_riv                                                         = 0;
+  // PDCCH locations of the DL grants of the first UE and of the UL grants of every UE, which do not overlap
+  bool                  dl_location_valid[ISRRAN_NOF_SF_X_FRAME]              = {};
+  isrran_dci_location_t dl_locations[ISRRAN_NOF_SF_X_FRAME]                   = {};
+  bool                  ul_location_valid[max_nof_ues][ISRRAN_NOF_SF_X_FRAME] = {};
+  isrran_dci_location_t ul_locations[max_nof_ues][ISRRAN_NOF_SF_X_FRAME]      = {};
+  uint32_t              ul_riv[max_nof_ues]                                   = {};
+  uint32_t              nof_additional_ue_crc                                 = 0;
 
 public:
   explicit dummy_stack(const isrenb::phy_cfg_t&                                 phy_cfg_,
                        const isrenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t& phy_rrc_,
                        const std::string&                                       log_level,
-                       uint16_t                                                 rnti_) :
+                       uint16_t                                                 rnti_,
+                       uint32_t                                                 nof_ues_) :
     logger(isrlog::fetch_basic_logger("STACK", false)),
     ue_rnti(rnti_),
+    nof_ues(std::min(nof_ues_, max_nof_ues)),
     random_gen(isrran_random_init(rnti_)),
     phy_cell_cfg(phy_cfg_.phy_cell_cfg),
     phy_rrc(phy_rrc_)
   {
     logger.set_level(isrlog::str_to_basic_level(log_level));
     isrran_softbuffer_tx_init(&softbuffer_tx, ISRRAN_MAX_PRB);
-    for (uint32_t i = 0; i < phy_rrc.size(); i++) {
-      for (auto& sb : softbuffer_rx[i]) {
-        isrran_softbuffer_rx_init(&sb, ISRRAN_MAX_PRB);
+    for (uint32_t ue_idx = 0; ue_idx < nof_ues; ue_idx++) {
+      for (uint32_t i = 0; i < phy_rrc.size(); i++) {
+        for (auto& sb : softbuffer_rx[ue_idx][i]) {
+          isrran_softbuffer_rx_init(&sb, ISRRAN_MAX_PRB);
+        }
       }
     }
 
@@ -371,30 +385,55 @@ public:
       sf_cfg_dl.cfi     = cfi;
       sf_cfg_dl.sf_type = ISRRAN_SF_NORM;
 
-      uint32_t              _nof_locations                           = {};
-      isrran_dci_location_t _dci_locations[ISRRAN_MAX_CANDIDATES_UE] = {};
-      _nof_locations = isrran_pdcch_ue_locations(&pdcch, &sf_cfg_dl, _dci_locations, ISRRAN_MAX_CANDIDATES_UE, ue_rnti);
+      std::set<uint32_t> used_ncce;
+      for (uint32_t ue_idx = 0; ue_idx < nof_ues; ue_idx++) {
+        uint32_t              _nof_locations                           = {};
+        isrran_dci_location_t _dci_locations[ISRRAN_MAX_CANDIDATES_UE] = {};
+        _nof_locations = isrran_pdcch_ue_locations(
+            &pdcch, &sf_cfg_dl, _dci_locations, ISRRAN_MAX_CANDIDATES_UE, ue_rnti + ue_idx);
+
+        // Take L == 0 aggregation levels
+        uint32_t              nof_locations                           = 0;
+        isrran_dci_location_t dci_locations[ISRRAN_MAX_CANDIDATES_UE] = {};
+        for (uint32_t j = 0; j < _nof_locations; j++) {
+          if (_dci_locations[j].L == 0) {
+            dci_locations[nof_locations++] = _dci_locations[j];
+          }
+        }
 
-      // Take L == 0 aggregation levels
-      for (uint32_t j = 0; j < _nof_locations && nof_locations[i] < ISRRAN_MAX_CANDIDATES_UE; j++) {
-        if (_dci_locations[j].L == 0) {
-          dci_locations[i][nof_locations[i]] = _dci_locations[j];
-          nof_locations[i]++;
+        if (ue_idx == 0) {
+          // The first UE needs two locations, as it may get a DL and an UL grant in the same subframe
+          if (nof_locations > 1) {
+            dl_location_valid[i]    = true;
+            dl_locations[i]         = dci_locations[i % nof_locations];
+            ul_location_valid[0][i] = true;
+            ul_locations[0][i]      = dci_locations[(i + 1) % nof_locations];
+            used_ncce.insert(dl_locations[i].ncce);
+            used_ncce.insert(ul_locations[0][i].ncce);
+          }
+        } else {
+          // The additional UEs take the first location not used by the previous ones
+          for (uint32_t j = 0; j < nof_locations and not ul_location_valid[ue_idx][i]; j++) {
+            if (used_ncce.count(dci_locations[j].ncce) == 0) {
+              ul_location_valid[ue_idx][i] = true;
+              ul_locations[ue_idx][i]      = dci_locations[j];
+              used_ncce.insert(dci_locations[j].ncce);
+            }
+          }
         }
       }
     }
     isrran_pdcch_free(&pdcch);
     isrran_regs_free(&regs);
 
-    // Find a valid UL DCI RIV
-    uint32_t L_prb = phy_cell_cfg[0].cell.nof_prb - 2;
-    do {
-      if (isrran_dft_precoding_valid_prb(L_prb)) {
-        ul_riv = isrran_ra_type2_to_riv(L_prb, 1, phy_cell_cfg[0].cell.nof_prb);
-      } else {
-        L_prb--;
-      }
-    } while (ul_riv == 0);
+    // Find a valid UL DCI RIV, the UEs share the UL bandwidth except the edge PRB
+    uint32_t L_prb = (phy_cell_cfg[0].cell.nof_prb - 2) / nof_ues;
+    while (not isrran_dft_precoding_valid_prb(L_prb)) {
+      L_prb--;
+    }
+    for (uint32_t ue_idx = 0; ue_idx < nof_ues; ue_idx++) {
+      ul_riv[ue_idx] = isrran_ra_type2_to_riv(L_prb, 1 + ue_idx * L_prb, phy_cell_cfg[0].cell.nof_prb);
+    }
 
     data = isrran_vec_u8_malloc(150000);
     memset(data, 0, 150000);
@@ -403,9 +442,11 @@ public:
   ~dummy_stack()
   {
     isrran_softbuffer_tx_free(&softbuffer_tx);
-    for (auto& v : softbuffer_rx) {
-      for (auto& sb : v) {
-        isrran_softbuffer_rx_free(&sb);
+    for (auto& u : softbuffer_rx) {
+      for (auto& v : u) {
+        for (auto& sb : v) {
+          isrran_softbuffer_rx_free(&sb);
+        }
       }
     }
     if (data) {
@@ -513,6 +554,7 @@ public:
     tti_ul_info_t tti_ul_info = {};
     tti_ul_info.tti           = tti;
     tti_ul_info.cc_idx        = cc_idx;
+    tti_ul_info.rnti          = rnti;
     tti_ul_info.crc           = crc_res;
     tti_ul_info_ack_queue.push(tti_ul_info);
 
@@ -563,12 +605,11 @@ public:
       sched &= (ue_rnti != 0);
 
       // Number of locations needs to be more than 2
-      sched &= (nof_locations[tti % ISRRAN_NOF_SF_X_FRAME] > 1);
+      sched &= dl_location_valid[tti % ISRRAN_NOF_SF_X_FRAME];
 
       // Schedule grant
       if (sched) {
-        uint32_t              location_idx = tti % nof_locations[tti % ISRRAN_NOF_SF_X_FRAME];
-        isrran_dci_location_t location     = dci_locations[tti % ISRRAN_NOF_SF_X_FRAME][location_idx];
+        isrran_dci_location_t location = dl_locations[tti % ISRRAN_NOF_SF_X_FRAME];
 
         dl_sched.nof_grants                           = 1;
         dl_sched.pdsch[0].softbuffer_tx[0]            = &softbuffer_tx;
@@ -659,7 +700,7 @@ public:
         }
       }
 
-      // Random decision on whether transmit or not
+      // Random decision on whether transmit or not, all the UEs are scheduled in the same subframe
       bool sched = isrran_random_bool(random_gen, prob_ul_grant);
 
       sched &= (scell_idx < active_cell_list.size());
@@ -667,52 +708,50 @@ public:
       // RNTI needs to be valid
       sched &= (ue_rnti != 0);
 
-      // Number of locations needs to be more than 2
-      sched &= (nof_locations[tti % ISRRAN_NOF_SF_X_FRAME] > 1);
-
       // Avoid giving grants when SR is expected
       sched &= (tti % 20 != 0);
 
-      // Schedule grant
-      if (sched) {
-        uint32_t              tti_pdcch    = TTI_SUB(tti, FDD_HARQ_DELAY_DL_MS);
-        uint32_t              location_idx = (tti_pdcch + 1) % nof_locations[tti_pdcch % ISRRAN_NOF_SF_X_FRAME];
-        isrran_dci_location_t location     = dci_locations[tti_pdcch % ISRRAN_NOF_SF_X_FRAME][location_idx];
-
-        ul_sched.nof_grants                       = 1;
-        ul_sched.pusch[0]                         = {};
-        ul_sched.pusch[0].dci.rnti                = ue_rnti;
-        ul_sched.pusch[0].dci.format              = ISRRAN_DCI_FORMAT0;
-        ul_sched.pusch[0].dci.location            = location;
-        ul_sched.pusch[0].dci.type2_alloc.riv     = ul_riv;
-        ul_sched.pusch[0].dci.type2_alloc.n_prb1a = isrran_ra_type2_t::ISRRAN_RA_TYPE2_NPRB1A_2;
-        ul_sched.pusch[0].dci.type2_alloc.n_gap   = isrran_ra_type2_t::ISRRAN_RA_TYPE2_NG1;
-        ul_sched.pusch[0].dci.type2_alloc.mode    = isrran_ra_type2_t::ISRRAN_RA_TYPE2_LOC;
-        ul_sched.pusch[0].dci.freq_hop_fl         = isrran_dci_ul_t::ISRRAN_RA_PUSCH_HOP_DISABLED;
-        ul_sched.pusch[0].dci.tb.mcs_idx          = 20; // Can't set it too high for grants with CQI and long ACK/NACK
-        ul_sched.pusch[0].dci.tb.rv               = 0;
-        ul_sched.pusch[0].dci.tb.ndi              = false;
-        ul_sched.pusch[0].dci.tb.cw_idx           = 0;
-        ul_sched.pusch[0].dci.n_dmrs              = 0;
-        ul_sched.pusch[0].dci.cqi_request         = false;
-        ul_sched.pusch[0].data                    = data;
-
-        ul_sched.pusch[0].needs_pdcch   = true;
-        ul_sched.pusch[0].softbuffer_rx = &softbuffer_rx[scell_idx][tti % ISRRAN_FDD_NOF_HARQ];
+      // Schedule a grant for each UE with a PDCCH location
+      ul_sched.nof_grants = 0;
+      uint32_t sf_pdcch   = TTI_SUB(tti, FDD_HARQ_DELAY_DL_MS) % ISRRAN_NOF_SF_X_FRAME;
+      for (uint32_t ue_idx = 0; ue_idx < nof_ues and sched; ue_idx++) {
+        if (not ul_location_valid[ue_idx][sf_pdcch]) {
+          continue;
+        }
+
+        auto& pusch                   = ul_sched.pusch[ul_sched.nof_grants++];
+        pusch                         = {};
+        pusch.dci.rnti                = ue_rnti + ue_idx;
+        pusch.dci.format              = ISRRAN_DCI_FORMAT0;
+        pusch.dci.location            = ul_locations[ue_idx][sf_pdcch];
+        pusch.dci.type2_alloc.riv     = ul_riv[ue_idx];
+        pusch.dci.type2_alloc.n_prb1a = isrran_ra_type2_t::ISRRAN_RA_TYPE2_NPRB1A_2;
+        pusch.dci.type2_alloc.n_gap   = isrran_ra_type2_t::ISRRAN_RA_TYPE2_NG1;
+        pusch.dci.type2_alloc.mode    = isrran_ra_type2_t::ISRRAN_RA_TYPE2_LOC;
+        pusch.dci.freq_hop_fl         = isrran_dci_ul_t::ISRRAN_RA_PUSCH_HOP_DISABLED;
+        pusch.dci.tb.mcs_idx          = 20; // Can't set it too high for grants with CQI and long ACK/NACK
+        pusch.dci.tb.rv               = 0;
+        pusch.dci.tb.ndi              = false;
+        pusch.dci.tb.cw_idx           = 0;
+        pusch.dci.n_dmrs              = 0;
+        pusch.dci.cqi_request         = false;
+        pusch.data                    = data;
+
+        pusch.needs_pdcch   = true;
+        pusch.softbuffer_rx = &softbuffer_rx[ue_idx][scell_idx][tti % ISRRAN_FDD_NOF_HARQ];
 
         // Reset Rx softbuffer
-        isrran_softbuffer_rx_reset(ul_sched.pusch[0].softbuffer_rx);
+        isrran_softbuffer_rx_reset(pusch.softbuffer_rx);
 
         // Push grant info in queue
         tti_ul_info_t tti_ul_info = {};
         tti_ul_info.tti           = tti;
         tti_ul_info.cc_idx        = cc_idx;
+        tti_ul_info.rnti          = pusch.dci.rnti;
         tti_ul_info.crc           = true;
 
         // Push to queue
         tti_ul_info_sched_queue.push(tti_ul_info);
-      } else {
-        ul_sched.nof_grants = 0;
       }
     }
 
@@ -754,7 +793,9 @@ public:
       if (enable_assert) {
         TESTASSERT(tti_ul_sched.tti == tti_ul_ack.tti);
         TESTASSERT(tti_ul_sched.cc_idx == tti_ul_ack.cc_idx);
+        TESTASSERT(tti_ul_sched.rnti == tti_ul_ack.rnti);
         TESTASSERT(tti_ul_sched.crc == tti_ul_ack.crc);
+        nof_additional_ue_crc += (tti_ul_ack.rnti != ue_rnti) ? 1 : 0;
       }
 
       tti_ul_info_sched_queue.pop();
@@ -788,6 +829,11 @@ public:
 
     return ISRRAN_SUCCESS;
   }
+  uint32_t get_nof_additional_ue_crc()
+  {
+    std::lock_guard<std::mutex> lock(phy_mac_mutex);
+    return nof_additional_ue_crc;
+  }
 };
 
 typedef std::unique_ptr<dummy_stack> unique_dummy_stack_t;
@@ -888,12 +934,14 @@ public:
       tx_data[i] = static_cast<uint8_t>(((i + 257) * (i + 373)) % 255); ///< Creative random data generator
     }
 
-    // Push HARQ delay to radio
+    // Push HARQ delay to radio, additional UEs have no radio as their UL is added to the one of the first UE
     for (uint32_t i = 0; i < FDD_HARQ_DELAY_DL_MS; i++) {
-      radio->write_rx(buffers, sf_len);
+      if (radio != nullptr) {
+        radio->write_rx(buffers, sf_len);
+      }
       sf_ul_cfg.tti = TTI_ADD(sf_ul_cfg.tti, 1); // Advance UL TTI too
     }
-    for (uint32_t i = 0; i < FDD_HARQ_DELAY_UL_MS; i++) {
+    for (uint32_t i = 0; i < FDD_HARQ_DELAY_UL_MS and radio != nullptr; i++) {
       radio->write_rx(buffers, sf_len);
     }
   }
@@ -934,11 +982,28 @@ public:
     }
   }
 
-  int work_dl(isrran_pdsch_ack_t& pdsch_ack, isrran_uci_data_t& uci_data)
+  int read_dl() { return radio->read_tx(buffers, sf_len); }
+
+  void write_ul() { radio->write_rx(buffers, sf_len); }
+
+  // Receives the same DL signal as another UE
+  void copy_dl(const dummy_ue& ue)
+  {
+    for (uint32_t i = 0; i < buffers.size(); i++) {
+      isrran_vec_cf_copy(buffers[i], ue.buffers[i], sf_len);
+    }
+  }
+
+  // Adds the UL signal of another UE to the one sent to the radio
+  void add_ul(const dummy_ue& ue)
   {
-    // Read DL
-    TESTASSERT(radio->read_tx(buffers, sf_len) >= ISRRAN_SUCCESS);
+    for (uint32_t i = 0; i < buffers.size(); i++) {
+      isrran_vec_sum_ccc(buffers[i], ue.buffers[i], buffers[i], sf_len);
+    }
+  }
 
+  int work_dl(isrran_pdsch_ack_t& pdsch_ack, isrran_uci_data_t& uci_data)
+  {
     // Get grants DL/UL, we do not care about Decoding PDSCH
     for (uint32_t ue_cc_idx = 0; ue_cc_idx < phy_rrc_cfg.size(); ue_cc_idx++) {
       uint32_t           cc_idx    = phy_rrc_cfg[ue_cc_idx].enb_cc_idx;
@@ -1127,9 +1192,6 @@ public:
       }
     }
 
-    // Write eNb Rx
-    radio->write_rx(buffers, sf_len);
-
     return ISRRAN_SUCCESS;
   }
 
@@ -1175,6 +1237,8 @@ public:
     uint32_t              period_pcell_rotate = 0;
     isrran_tm_t           tm                  = ISRRAN_TM1;
     bool                  extended_cp         = false;
+    uint32_t              nof_pusch_threads   = 0;
+    uint32_t              nof_ues             = 1;
     args_t()
     {
       cell.nof_prb   = 6;
@@ -1214,7 +1278,7 @@ private:
   unique_dummy_radio_t  radio;
   unique_dummy_stack_t  stack;
   unique_isrenb_phy_t   enb_phy;
-  unique_dummy_ue_phy_t ue_phy;
+  std::vector<unique_dummy_ue_phy_t> ue_phy;
   isrlog::basic_logger& logger;
 
   args_t                                            args = {};   ///< Test arguments
@@ -1241,8 +1305,9 @@ public:
     logger.set_level(isrlog::str_to_basic_level(args.log_level));
 
     // PHY arguments
-    phy_args.log.phy_level   = args.log_level;
-    phy_args.nof_phy_threads = 1; ///< Set number of phy threads to 1 for avoiding concurrency issues
+    phy_args.log.phy_level     = args.log_level;
+    phy_args.nof_phy_threads   = 1; ///< Set number of phy threads to 1 for avoiding concurrency issues
+    phy_args.nof_pusch_threads = args.nof_pusch_threads;
 
     // Create cell configuration
     phy_cfg.phy_cell_cfg.resize(args.nof_enb_cells);
@@ -1256,6 +1321,8 @@ public:
       q.ul_freq_hz   = 0.0f;
       q.root_seq_idx = 25 + i; ///< Different PRACH root sequences
       q.rf_port      = i;
+
+      q.nof_pusch_decoders = args.nof_pusch_threads + 1;
     }
 
     phy_cfg.pucch_cnfg.delta_pucch_shift                = asn1::rrc::pucch_cfg_common_s::delta_pucch_shift_e_::ds3;
@@ -1333,26 +1400,61 @@ public:
         new dummy_radio(args.nof_enb_cells * args.cell.nof_ports, args.cell.nof_prb, args.log_level));
 
     /// Create Dummy Stack instance
-    stack = unique_dummy_stack_t(new dummy_stack(phy_cfg, phy_rrc_cfg, args.log_level, args.rnti));
+    stack = unique_dummy_stack_t(new dummy_stack(phy_cfg, phy_rrc_cfg, args.log_level, args.rnti, args.nof_ues));
     stack->set_active_cell_list(args.ue_cell_list);
 
     /// Initiate eNb PHY with the given RNTI
     if (enb_phy->init(phy_args, phy_cfg, radio.get(), stack.get(), this) < 0) {
       return ISRRAN_ERROR;
     }
-    enb_phy->set_config(args.rnti, phy_rrc_cfg);
-    enb_phy->complete_config(args.rnti);
-    enb_phy->set_activation_deactivation_scell(args.rnti, activation);
 
-    /// Create dummy UE instance
-    ue_phy = unique_dummy_ue_phy_t(new dummy_ue(radio.get(), phy_cfg.phy_cell_cfg, args.log_level, args.rnti));
+    /// Configure eNb PHY for every UE
+    configure_enb(activation);
 
-    /// Configure UE with initial configuration
-    ue_phy->reconfigure(phy_rrc_cfg);
+    /// Create dummy UE instances, the additional UEs send their UL through the radio of the first one
+    for (uint32_t ue_idx = 0; ue_idx < args.nof_ues; ue_idx++) {
+      dummy_radio* ue_radio = (ue_idx == 0) ? radio.get() : nullptr;
+      ue_phy.emplace_back(new dummy_ue(ue_radio, phy_cfg.phy_cell_cfg, args.log_level, args.rnti + ue_idx));
+    }
+
+    /// Configure UEs with initial configuration
+    configure_ues();
 
     return ISRRAN_SUCCESS;
   }
 
+  /// The additional UEs are only scheduled in the UL, without SR nor CQI reports
+  isrenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t get_ue_cfg(uint32_t ue_idx)
+  {
+    isrenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t ue_cfg = phy_rrc_cfg;
+    for (auto& q : ue_cfg) {
+      if (ue_idx > 0) {
+        q.phy_cfg.ul_cfg.pucch.sr_configured            = false;
+        q.phy_cfg.dl_cfg.cqi_report.periodic_configured = false;
+      }
+    }
+    return ue_cfg;
+  }
+
+  void configure_enb(const std::array<bool, ISRRAN_MAX_CARRIERS>& activation)
+  {
+    for (uint32_t ue_idx = 0; ue_idx < args.nof_ues; ue_idx++) {
+      uint16_t rnti = args.rnti + ue_idx;
+      enb_phy->set_config(rnti, get_ue_cfg(ue_idx));
+      enb_phy->complete_config(rnti);
+      enb_phy->set_activation_deactivation_scell(rnti, activation);
+    }
+  }
+
+  void configure_ues()
+  {
+    for (uint32_t ue_idx = 0; ue_idx < ue_phy.size(); ue_idx++) {
+      ue_phy[ue_idx]->reconfigure(get_ue_cfg(ue_idx));
+    }
+  }
+
+  uint32_t get_nof_additional_ue_crc() { return stack->get_nof_additional_ue_crc(); }
+
   void stop()
   {
     radio->stop();
@@ -1365,7 +1467,18 @@ public:
   {
     int ret = ISRRAN_SUCCESS;
 
-    TESTASSERT(ue_phy->run_tti() >= ISRRAN_SUCCESS);
+    // The first UE receives the DL from the radio and sends the UL of all the UEs to it
+    TESTASSERT(ue_phy[0]->read_dl() >= ISRRAN_SUCCESS);
+    for (uint32_t i = 1; i < ue_phy.size(); i++) {
+      ue_phy[i]->copy_dl(*ue_phy[0]);
+    }
+    for (auto& ue : ue_phy) {
+      TESTASSERT(ue->run_tti() >= ISRRAN_SUCCESS);
+    }
+    for (uint32_t i = 1; i < ue_phy.size(); i++) {
+      ue_phy[0]->add_ul(*ue_phy[i]);
+    }
+    ue_phy[0]->write_ul();
     TESTASSERT(stack->run_tti(change_state == change_state_assert) >= ISRRAN_SUCCESS);
 
     // Change state FSM
@@ -1397,12 +1510,10 @@ public:
           }
 
           // Reconfigure eNb PHY
-          enb_phy->set_config(args.rnti, phy_rrc_cfg);
-          enb_phy->complete_config(args.rnti);
-          enb_phy->set_activation_deactivation_scell(args.rnti, activation);
+          configure_enb(activation);
 
           // Reconfigure UE PHY
-          ue_phy->reconfigure(phy_rrc_cfg);
+          configure_ues();
 
           change_state = change_state_wait_steady;
           tti_counter  = 0;
@@ -1462,6 +1573,8 @@ int parse_args(int argc, char** argv, phy_test_bench::args_t& args)
       ("cell.cp",        bpo::value<bool>(&args.extended_cp)->default_value(false),                      "use extended CP")
       ("tm", bpo::value<uint32_t>(&args.tm_u32)->default_value(args.tm_u32),                             "Transmission mode")
       ("rotation", bpo::value<uint32_t>(&args.period_pcell_rotate),                      "Serving cells rotation period in ms, set to zero to disable")
+      ("nof_pusch_threads", bpo::value<uint32_t>(&args.nof_pusch_threads),               "Number of PUSCH job threads, set to zero to decode PUSCH in the worker thread")
+      ("nof_ues",        bpo::value<uint32_t>(&args.nof_ues),                                            "Number of UEs (up to 4), the additional UEs are scheduled in the same UL subframes as the first")
       ;
   options.add(common).add_options()("help", "Show this message");
   // clang-format on
@@ -1524,6 +1637,11 @@ int main(int argc, char** argv)
     err_code = test_bench->run_tti();
   }
 
+  // The PUSCH of the additional UEs must have been received along with the one of the first UE
+  if (err_code >= ISRRAN_SUCCESS and test_args.nof_ues > 1) {
+    TESTASSERT(test_bench->get_nof_additional_ue_crc() > 0);
+  }
+
   test_bench->stop();
 
   isrlog::flush();
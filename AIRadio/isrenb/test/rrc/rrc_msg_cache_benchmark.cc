@@ -0,0 +1,166 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * RRC encoding benchmark, in procedures per second:
+ * - RRCConnectionSetup of UEs with different SR and CQI resources, packed from the ASN.1 structure or patched into
+ *   the message pre-encoded by rrc_msg_cache.
+ * - Paging of full paging occasions, repacking the PCCH for every record or appending each record to the encoding.
+ */
+
+#include "isrenb/hdr/stack/rrc/rrc_msg_cache.h"
+#include "isrenb/hdr/stack/rrc/rrc_paging.h"
+#include <chrono>
+#include <getopt.h>
+
+using namespace isrenb;
+using namespace asn1::rrc;
+
+static uint32_t nof_procedures = 1000000;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [n]\n", prog);
+  printf("\t-n Number of procedures [Default %d]\n", nof_procedures);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "n")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_procedures = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static void print_result(const char* name, std::chrono::steady_clock::duration elapsed, uint32_t nof_bytes)
+{
+  double secs = std::chrono::duration<double>(elapsed).count();
+  printf("%-22s %10.0f procedures/s %8.3f us/procedure (%d bytes)\n",
+         name,
+         nof_procedures / secs,
+         secs * 1e6 / nof_procedures,
+         nof_bytes);
+}
+
+static void run_con_setup_bench(bool cached)
+{
+  // RRCConnectionSetup with periodic CQI
+  uint8_t        rrc_msg[] = {0x60, 0x12, 0x98, 0x0b, 0xfd, 0xd2, 0x04, 0xfa, 0x18, 0x3e, 0xd5, 0xe6, 0xc2,
+                              0x59, 0x90, 0xc1, 0xa6, 0x00, 0x01, 0x31, 0x40, 0x42, 0x50, 0x80, 0x00, 0xf8};
+  asn1::cbit_ref bref(rrc_msg, sizeof(rrc_msg));
+  dl_ccch_msg_s  msg;
+  if (msg.unpack(bref) != asn1::ISRASN_SUCCESS) {
+    printf("Error unpacking RRCConnectionSetup\n");
+    exit(-1);
+  }
+  rrc_conn_setup_s& setup   = msg.msg.c1().rrc_conn_setup();
+  phys_cfg_ded_s&   phy_cfg = setup.crit_exts.c1().rrc_conn_setup_r8().rr_cfg_ded.phys_cfg_ded;
+
+  rrc_msg_cache         cache;
+  isrran::byte_buffer_t pdu;
+  auto                  tstart = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_procedures; ++i) {
+    setup.rrc_transaction_id                                             = i % 4;
+    phy_cfg.sched_request_cfg.setup().sr_pucch_res_idx                   = i % 2048;
+    phy_cfg.sched_request_cfg.setup().sr_cfg_idx                         = i % 158;
+    phy_cfg.cqi_report_cfg.cqi_report_periodic.setup().cqi_pucch_res_idx = i % 1186;
+    phy_cfg.cqi_report_cfg.cqi_report_periodic.setup().cqi_pmi_cfg_idx   = i % 1024;
+    if (not cached or not cache.encode_con_setup(msg, pdu)) {
+      asn1::bit_ref pack_bref(pdu.msg, pdu.get_tailroom());
+      msg.pack(pack_bref);
+      pdu.N_bytes = pack_bref.distance_bytes();
+    }
+  }
+  print_result(
+      cached ? "ConnSetup pre-encoded" : "ConnSetup pack", std::chrono::steady_clock::now() - tstart, pdu.N_bytes);
+}
+
+static void run_paging_bench(bool incremental)
+{
+  const uint32_t paging_cycle = 32;
+  uint8_t        m_tmsi[4]    = {0x64, 0x04, 0x00, 0x02};
+
+  // Baseline, the whole PCCH is packed again after each record is added
+  pcch_msg_s pcch;
+  auto&      records = pcch.msg.set_c1().paging().paging_record_list;
+  pcch.msg.c1().paging().paging_record_list_present = true;
+
+  paging_manager        pcch_manager{paging_cycle, 1};
+  isrran::byte_buffer_t pdu;
+  tti_point             tti{0};
+  auto                  tstart = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_procedures; ++i) {
+    uint32_t ue_id = (i / ASN1_RRC_MAX_PAGE_REC) % paging_cycle;
+    m_tmsi[3]      = i;
+    if (incremental) {
+      pcch_manager.add_tmsi_paging(ue_id, 1, m_tmsi);
+    } else {
+      if (records.size() == ASN1_RRC_MAX_PAGE_REC) {
+        records.clear();
+      }
+      records.push_back({});
+      records.back().ue_id.set_s_tmsi().mmec.from_number(1);
+      records.back().ue_id.s_tmsi().m_tmsi.from_number(i);
+      records.back().cn_domain = paging_record_s::cn_domain_e_::ps;
+      asn1::bit_ref bref(pdu.msg, pdu.get_tailroom());
+      pcch.pack(bref);
+      pdu.N_bytes = bref.distance_bytes();
+    }
+
+    // Transmit the PCCH of every paging frame once all the paging occasions have been filled. The extra frame
+    // releases the PCCH transmitted last
+    if (incremental and (i + 1) % (paging_cycle * ASN1_RRC_MAX_PAGE_REC) == 0) {
+      for (uint32_t j = 0; j < (paging_cycle + 1) * 10; ++j, ++tti) {
+        if (pcch_manager.pending_pcch_bytes(tti) > 0) {
+          pcch_manager.read_pdu_pcch(tti, [&pdu](isrran::const_byte_span pcch_pdu, const pcch_msg_s&, bool) {
+            pdu.N_bytes = pcch_pdu.size();
+            return true;
+          });
+        }
+      }
+    }
+  }
+  print_result(incremental ? "Paging record append" : "Paging record repack",
+               std::chrono::steady_clock::now() - tstart,
+               pdu.N_bytes);
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  isrlog::init();
+
+  run_con_setup_bench(false);
+  run_con_setup_bench(true);
+  run_paging_bench(false);
+  run_paging_bench(true);
+
+  return 0;
+}
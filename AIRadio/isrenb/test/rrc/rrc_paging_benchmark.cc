@@ -0,0 +1,144 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Paging load benchmark. An S1AP thread floods the paging manager with S-TMSI paging records of idle UEs, while a
+ * scheduler thread runs through the TTIs, checking every paging subframe for a pending PCCH and transmitting it.
+ * Reports the insertion rate of the S1AP, the time spent by the scheduler per paging subframe and the number of
+ * records that were transmitted.
+ */
+
+#include "isrenb/hdr/stack/rrc/rrc_paging.h"
+#include <atomic>
+#include <chrono>
+#include <getopt.h>
+#include <thread>
+
+using namespace isrenb;
+
+static uint32_t nof_records  = 1000000;
+static uint32_t nof_ues      = 10000;
+static uint32_t paging_cycle = 32;
+static float    nb           = 4;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [nuTb]\n", prog);
+  printf("\t-n Number of paging records sent by the S1AP [Default %d]\n", nof_records);
+  printf("\t-u Number of paged UEs [Default %d]\n", nof_ues);
+  printf("\t-T Default paging cycle in radio frames [Default %d]\n", paging_cycle);
+  printf("\t-b nB, as a multiple of the paging cycle [Default %.2f]\n", nb);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nuTb")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_records = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'u':
+        nof_ues = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'T':
+        paging_cycle = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'b':
+        nb = strtof(argv[optind], nullptr);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  isrlog::fetch_basic_logger("RRC", false).set_level(isrlog::basic_levels::error);
+  isrlog::init();
+
+  // The byte buffer pool is allocated outside of the measurements
+  isrran::byte_buffer_pool::get_instance();
+
+  paging_manager    pcch_manager{paging_cycle, nb};
+  std::atomic<bool> s1ap_done{false};
+  uint32_t          nof_accepted = 0;
+
+  // S1AP, paging the UEs round-robin
+  auto        s1ap_tstart = std::chrono::steady_clock::now();
+  double      s1ap_secs   = 0;
+  std::thread s1ap([&pcch_manager, &s1ap_done, &nof_accepted, &s1ap_secs, s1ap_tstart]() {
+    uint8_t m_tmsi[4] = {};
+    for (uint32_t i = 0; i < nof_records; ++i) {
+      uint32_t ueid = i % nof_ues;
+      m_tmsi[2]     = (ueid >> 8u) & 0xffu;
+      m_tmsi[3]     = ueid & 0xffu;
+      nof_accepted += pcch_manager.add_tmsi_paging(ueid, 1, m_tmsi) ? 1 : 0;
+    }
+    s1ap_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - s1ap_tstart).count();
+    s1ap_done = true;
+  });
+
+  // Scheduler. It keeps running for a full paging cycle after the S1AP has finished, to transmit the last records
+  tti_point                           tti{0};
+  uint32_t                            nof_paging_sfs = 0, nof_pcch = 0, nof_tx_records = 0;
+  std::chrono::steady_clock::duration sched_elapsed{}, sched_max{};
+  uint32_t                            nof_ttis_after_s1ap = 0;
+  while (nof_ttis_after_s1ap < (paging_cycle + 1) * 10) {
+    if (s1ap_done) {
+      nof_ttis_after_s1ap++;
+    }
+    if (tti.sf_idx() == 0 or tti.sf_idx() == 4 or tti.sf_idx() == 5 or tti.sf_idx() == 9) {
+      auto tstart = std::chrono::steady_clock::now();
+      if (pcch_manager.pending_pcch_bytes(tti) > 0) {
+        pcch_manager.read_pdu_pcch(
+            tti, [&nof_tx_records](isrran::const_byte_span pdu, const asn1::rrc::pcch_msg_s& msg, bool first_tx) {
+              nof_tx_records += msg.msg.c1().paging().paging_record_list.size();
+              return true;
+            });
+        nof_pcch++;
+      }
+      auto elapsed = std::chrono::steady_clock::now() - tstart;
+      sched_elapsed += elapsed;
+      sched_max = std::max(sched_max, elapsed);
+      nof_paging_sfs++;
+    }
+    ++tti;
+  }
+  s1ap.join();
+
+  printf("%d paging records for %d UEs, T=%d, nB=%.2fT\n", nof_records, nof_ues, paging_cycle, nb);
+  printf("S1AP:      %10.0f records/s %8.3f us/record (%d accepted)\n",
+         nof_records / s1ap_secs,
+         s1ap_secs * 1e6 / nof_records,
+         nof_accepted);
+  printf("Scheduler: %8.3f us/paging subframe, max %8.3f us (%d PCCH, %d records transmitted)\n",
+         std::chrono::duration<double>(sched_elapsed).count() * 1e6 / nof_paging_sfs,
+         std::chrono::duration<double>(sched_max).count() * 1e6,
+         nof_pcch,
+         nof_tx_records);
+
+  return nof_tx_records == nof_accepted ? 0 : -1;
+}
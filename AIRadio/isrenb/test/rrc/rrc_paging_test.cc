@@ -51,7 +51,94 @@ void test_paging()
   }
 }
 
+/// Paging records appended to the encoded PCCH produce the same PDU as packing the whole message
+void test_paging_incremental_encoding()
+{
+  unsigned       paging_cycle = 32;
+  paging_manager pcch_manager{paging_cycle, 1};
+
+  unsigned ue_id     = 4780;
+  uint8_t  imsi[15]  = {0, 0, 1, 0, 1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  uint8_t  m_tmsi[4] = {0x64, 0x04, 0x00, 0x02};
+  for (unsigned i = 0; i < ASN1_RRC_MAX_PAGE_REC; ++i) {
+    m_tmsi[3] = i;
+    imsi[14]  = i % 10;
+    TESTASSERT(i % 3 == 0 ? pcch_manager.add_imsi_paging(ue_id, imsi) : pcch_manager.add_tmsi_paging(ue_id, i, m_tmsi));
+  }
+  TESTASSERT(not pcch_manager.add_tmsi_paging(ue_id, 1, m_tmsi));
+
+  tti_point t{0};
+  while (pcch_manager.pending_pcch_bytes(t) == 0) {
+    ++t;
+  }
+  bool read = pcch_manager.read_pdu_pcch(t, [](isrran::const_byte_span pdu, const asn1::rrc::pcch_msg_s& msg, bool) {
+    TESTASSERT_EQ(ASN1_RRC_MAX_PAGE_REC, msg.msg.c1().paging().paging_record_list.size());
+    isrran::byte_buffer_t expected;
+    asn1::bit_ref         bref(expected.msg, expected.get_tailroom());
+    TESTASSERT(msg.pack(bref) == asn1::ISRASN_SUCCESS);
+    TESTASSERT_EQ((size_t)bref.distance_bytes(), pdu.size());
+    TESTASSERT(std::equal(pdu.begin(), pdu.end(), expected.msg));
+
+    asn1::rrc::pcch_msg_s decoded;
+    asn1::cbit_ref        cbref(pdu.data(), pdu.size());
+    TESTASSERT(decoded.unpack(cbref) == asn1::ISRASN_SUCCESS);
+    const auto& records    = decoded.msg.c1().paging().paging_record_list;
+    uint32_t    m_tmsi_val = records[ASN1_RRC_MAX_PAGE_REC - 2].ue_id.s_tmsi().m_tmsi.to_number();
+    TESTASSERT_EQ(ASN1_RRC_MAX_PAGE_REC, records.size());
+    TESTASSERT_EQ(ASN1_RRC_MAX_PAGE_REC - 2, (m_tmsi_val & 0xffu));
+    TESTASSERT_EQ(15, records.back().ue_id.imsi().size());
+    return true;
+  });
+  TESTASSERT(read);
+}
+
+/// Paging records added once the PCCH of their paging occasion has been transmitted wait for the next paging cycle
+void test_paging_after_tx()
+{
+  unsigned       paging_cycle = 32;
+  paging_manager pcch_manager{paging_cycle, 1};
+
+  unsigned ue_id     = 4780;
+  uint8_t  m_tmsi[4] = {0x64, 0x04, 0x00, 0x02};
+  TESTASSERT(pcch_manager.add_tmsi_paging(ue_id, 1, m_tmsi));
+
+  tti_point t{0};
+  while (pcch_manager.pending_pcch_bytes(t) == 0) {
+    ++t;
+  }
+  auto tx_func = [](size_t nof_records) {
+    return [nof_records](isrran::const_byte_span pdu, const asn1::rrc::pcch_msg_s& msg, bool first_tx) {
+      TESTASSERT(first_tx);
+      TESTASSERT_EQ(nof_records, msg.msg.c1().paging().paging_record_list.size());
+      return true;
+    };
+  };
+  TESTASSERT(pcch_manager.read_pdu_pcch(t, tx_func(1)));
+
+  // Second carrier transmitting the same PCCH, after a new record has been added
+  m_tmsi[3] = 0x03;
+  TESTASSERT(pcch_manager.add_tmsi_paging(ue_id, 1, m_tmsi));
+  m_tmsi[3] = 0x04;
+  TESTASSERT(pcch_manager.add_tmsi_paging(ue_id, 1, m_tmsi));
+  TESTASSERT(pcch_manager.pending_pcch_bytes(t) > 0);
+  TESTASSERT(pcch_manager.read_pdu_pcch(
+      t, [](isrran::const_byte_span pdu, const asn1::rrc::pcch_msg_s& msg, bool first_tx) {
+        TESTASSERT(not first_tx);
+        TESTASSERT_EQ(1, msg.msg.c1().paging().paging_record_list.size());
+        return true;
+      }));
+
+  tti_point t_next = t + paging_cycle * 10;
+  for (++t; t < t_next; ++t) {
+    TESTASSERT_EQ(0, pcch_manager.pending_pcch_bytes(t));
+  }
+  TESTASSERT(pcch_manager.pending_pcch_bytes(t) > 0);
+  TESTASSERT(pcch_manager.read_pdu_pcch(t, tx_func(2)));
+}
+
 int main()
 {
   test_paging();
+  test_paging_incremental_encoding();
+  test_paging_after_tx();
 }
\ No newline at end of file
@@ -0,0 +1,284 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * GTP-U throughput benchmark.
+ * - Downlink: a synthetic S1-U source generates G-PDUs for a number of UEs, which go through the GTP-U task queue into
+ *   the eNB GTP-U and PDCP interface, either one task per PDU or one task per received burst.
+ * - Uplink: IP packets of the UEs are written by PDCP into the eNB GTP-U, which sends them to a local SGW socket either
+ *   with one sendto per PDU or in batches flushed every TTI with sendmmsg and UDP GSO.
+ */
+
+#include "isrenb/hdr/stack/upper/gtpu.h"
+#include "isrenb/test/common/dummy_classes_common.h"
+#include "isrran/upper/gtpu.h"
+#include <chrono>
+#include <cinttypes>
+#include <getopt.h>
+#include <linux/ip.h>
+
+using namespace isrenb;
+
+static uint32_t nof_pdus   = 1000000;
+static uint32_t pdu_size   = 100;
+static uint32_t nof_ues    = 16;
+static uint32_t burst_size = 32;
+static uint32_t tti_size   = 64;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [nsubt]\n", prog);
+  printf("\t-n Number of G-PDUs [Default %d]\n", nof_pdus);
+  printf("\t-s IP packet size in bytes [Default %d]\n", pdu_size);
+  printf("\t-u Number of UEs, with one DRB each [Default %d]\n", nof_ues);
+  printf("\t-b Number of G-PDUs per S1-U burst [Default %d]\n", burst_size);
+  printf("\t-t Number of UL G-PDUs per TTI [Default %d]\n", tti_size);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nsubt")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_pdus = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 's':
+        pdu_size = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'u':
+        nof_ues = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'b':
+        burst_size = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 't':
+        tti_size = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+class pdcp_counter : public pdcp_dummy
+{
+public:
+  void write_sdu(uint16_t rnti, uint32_t lcid, isrran::unique_byte_buffer_t sdu, int pdcp_sn) override
+  {
+    nof_sdus++;
+  }
+  uint64_t nof_sdus = 0;
+};
+
+class dummy_socket_manager : public isrran::socket_manager_itf
+{
+public:
+  dummy_socket_manager() : isrran::socket_manager_itf(isrlog::fetch_basic_logger("TEST")) {}
+  bool add_socket_handler(int fd, recv_callback_t handler) final { return true; }
+  bool remove_socket(int fd) final { return true; }
+};
+
+/// Synthetic S1-U source, which generates IPv4 G-PDUs round-robin across the UE tunnels
+class s1u_source
+{
+public:
+  explicit s1u_source(std::vector<uint32_t> teids_) : teids(std::move(teids_)) {}
+
+  isrran::unique_byte_buffer_t next_pdu()
+  {
+    isrran::unique_byte_buffer_t pdu = isrran::make_byte_buffer();
+    if (pdu == nullptr) {
+      return nullptr;
+    }
+    struct iphdr ip_pkt = {};
+    ip_pkt.version      = 4;
+    ip_pkt.tot_len      = htons(pdu_size);
+    pdu->append_bytes((uint8_t*)&ip_pkt, sizeof(struct iphdr));
+    pdu->N_bytes = std::max(pdu_size, (uint32_t)sizeof(struct iphdr));
+
+    isrran::gtpu_header_t header = {};
+    header.flags                 = GTPU_FLAGS_VERSION_V1 | GTPU_FLAGS_GTP_PROTOCOL;
+    header.message_type          = GTPU_MSG_DATA_PDU;
+    header.length                = pdu->N_bytes;
+    header.teid                  = teids[count++ % teids.size()];
+    isrran::gtpu_write_header(&header, pdu.get(), isrlog::fetch_basic_logger("GTPU"));
+    return pdu;
+  }
+
+private:
+  std::vector<uint32_t> teids;
+  uint64_t              count = 0;
+};
+
+static void run_bench(const char* name, bool burst_mode)
+{
+  sockaddr_in sgw_sockaddr = {};
+  isrran::net_utils::set_sockaddr(&sgw_sockaddr, "127.0.0.1", 2152);
+
+  isrran::task_scheduler    task_sched;
+  isrran::task_queue_handle queue = task_sched.make_task_queue();
+  dummy_socket_manager      rx_sockets;
+  gtpu                      enb_gtpu(&task_sched, isrlog::fetch_basic_logger("GTPU"), &rx_sockets);
+  pdcp_counter              pdcp;
+  gtpu_args_t               args;
+  args.gtp_bind_addr = "127.0.4.1";
+  args.mme_addr      = "127.0.0.1";
+  if (enb_gtpu.init(args, &pdcp) != ISRRAN_SUCCESS) {
+    printf("Error initiating GTP-U\n");
+    exit(-1);
+  }
+  std::vector<uint32_t> teids;
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    uint32_t addr_in;
+    teids.push_back(enb_gtpu.add_bearer(0x46 + i, 5, ntohl(sgw_sockaddr.sin_addr.s_addr), i + 1, addr_in).value());
+  }
+  s1u_source source(teids);
+
+  auto handle_pdu = [&enb_gtpu, &sgw_sockaddr](isrran::unique_byte_buffer_t& pdu) {
+    enb_gtpu.handle_gtpu_s1u_rx_packet(std::move(pdu), sgw_sockaddr);
+  };
+  auto handle_burst = [&enb_gtpu](isrran::recvfrom_burst_t& burst) { enb_gtpu.handle_gtpu_s1u_rx_burst(burst); };
+
+  // The PDUs of each round are generated before being timed
+  const uint32_t                        round_size = 64 * burst_size;
+  std::chrono::steady_clock::duration   elapsed{};
+  std::vector<isrran::recvfrom_burst_t> bursts;
+  for (uint32_t nof_sent = 0; nof_sent < nof_pdus; nof_sent += round_size) {
+    bursts.clear();
+    for (uint32_t i = 0; i < round_size and nof_sent + i < nof_pdus; ++i) {
+      if (i % burst_size == 0) {
+        bursts.emplace_back();
+      }
+      bursts.back().pdus.push_back(source.next_pdu());
+      bursts.back().from.push_back(sgw_sockaddr);
+    }
+
+    auto tstart = std::chrono::steady_clock::now();
+    for (isrran::recvfrom_burst_t& burst : bursts) {
+      if (burst_mode) {
+        queue.push(std::bind(handle_burst, std::move(burst)));
+      } else {
+        for (isrran::unique_byte_buffer_t& pdu : burst.pdus) {
+          queue.push(std::bind(handle_pdu, std::move(pdu)));
+        }
+      }
+      task_sched.run_pending_tasks();
+    }
+    elapsed += std::chrono::steady_clock::now() - tstart;
+  }
+
+  double secs = std::chrono::duration<double>(elapsed).count();
+  printf("%-10s %10.0f PDU/s %8.1f Mbit/s %8.3f us/PDU (%" PRIu64 " SDUs to PDCP)\n",
+         name,
+         pdcp.nof_sdus / secs,
+         pdcp.nof_sdus * pdu_size * 8 / secs / 1e6,
+         secs * 1e6 / pdcp.nof_sdus,
+         pdcp.nof_sdus);
+  enb_gtpu.stop();
+}
+
+static void run_ul_bench(const char* name, uint32_t tx_batch_size)
+{
+  // Local SGW, which does not read the PDUs
+  isrran::unique_socket sgw_socket;
+  if (not sgw_socket.open_socket(isrran::net_utils::addr_family::ipv4,
+                                 isrran::net_utils::socket_type::datagram,
+                                 isrran::net_utils::protocol_type::UDP) or
+      not sgw_socket.bind_addr("127.0.0.1", 2152)) {
+    printf("Error opening SGW socket\n");
+    exit(-1);
+  }
+
+  isrran::task_scheduler task_sched;
+  dummy_socket_manager   rx_sockets;
+  gtpu                   enb_gtpu(&task_sched, isrlog::fetch_basic_logger("GTPU"), &rx_sockets);
+  pdcp_counter           pdcp;
+  gtpu_args_t            args;
+  args.gtp_bind_addr = "127.0.4.1";
+  args.mme_addr      = "127.0.0.1";
+  args.tx_batch_size = tx_batch_size;
+  if (enb_gtpu.init(args, &pdcp) != ISRRAN_SUCCESS) {
+    printf("Error initiating GTP-U\n");
+    exit(-1);
+  }
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    uint32_t addr_in;
+    enb_gtpu.add_bearer(0x46 + i, 5, ntohl(sgw_socket.get_addr_in().sin_addr.s_addr), i + 1, addr_in);
+  }
+
+  // The IP packets of each round are generated before being timed
+  const uint32_t                            round_size = 64 * tti_size;
+  std::chrono::steady_clock::duration       elapsed{};
+  std::vector<isrran::unique_byte_buffer_t> pdus;
+  for (uint32_t nof_sent = 0; nof_sent < nof_pdus; nof_sent += round_size) {
+    pdus.clear();
+    for (uint32_t i = 0; i < round_size and nof_sent + i < nof_pdus; ++i) {
+      pdus.push_back(isrran::make_byte_buffer());
+      struct iphdr ip_pkt = {};
+      ip_pkt.version      = 4;
+      ip_pkt.tot_len      = htons(pdu_size);
+      pdus.back()->append_bytes((uint8_t*)&ip_pkt, sizeof(struct iphdr));
+      pdus.back()->N_bytes = std::max(pdu_size, (uint32_t)sizeof(struct iphdr));
+    }
+
+    auto tstart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < pdus.size(); ++i) {
+      enb_gtpu.write_pdu(0x46 + i % nof_ues, 5, std::move(pdus[i]));
+      if ((i + 1) % tti_size == 0) {
+        enb_gtpu.tti_clock();
+      }
+    }
+    enb_gtpu.tti_clock();
+    elapsed += std::chrono::steady_clock::now() - tstart;
+  }
+
+  gtpu_metrics_t metrics;
+  enb_gtpu.get_metrics(metrics);
+  double secs = std::chrono::duration<double>(elapsed).count();
+  printf("%-10s %10.0f PDU/s %8.1f Mbit/s %8.3f us/PDU (%" PRIu64 " syscalls, %" PRIu64 " GSO PDUs)\n",
+         name,
+         metrics.tx_pdus / secs,
+         metrics.tx_pdus * pdu_size * 8 / secs / 1e6,
+         secs * 1e6 / metrics.tx_pdus,
+         metrics.tx_syscalls,
+         metrics.tx_gso_pdus);
+  enb_gtpu.stop();
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  isrlog::fetch_basic_logger("GTPU", false).set_level(isrlog::basic_levels::warning);
+  isrlog::init();
+
+  printf("DL: %d G-PDUs of %d bytes, %d UEs, bursts of %d\n", nof_pdus, pdu_size, nof_ues, burst_size);
+  run_bench("per-PDU", false);
+  run_bench("burst", true);
+
+  printf("UL: %d G-PDUs of %d bytes, %d UEs, %d per TTI\n", nof_pdus, pdu_size, nof_ues, tti_size);
+  run_ul_bench("sendto", 1);
+  run_ul_bench("sendmmsg", 64);
+
+  return 0;
+}
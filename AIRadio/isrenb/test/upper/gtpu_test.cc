@@ -40,11 +40,20 @@ class pdcp_tester : public pdcp_dummy
 public:
   void write_sdu(uint16_t rnti, uint32_t eps_bearer_id, isrran::unique_byte_buffer_t sdu, int pdcp_sn) override
   {
+    rx_sdus.emplace_back(rnti, sdu->msg[PDU_HEADER_SIZE]);
     last_sdu           = std::move(sdu);
     last_pdcp_sn       = pdcp_sn;
     last_rnti          = rnti;
     last_eps_bearer_id = eps_bearer_id;
   }
+  void write_sdus(uint16_t                                   rnti,
+                  uint32_t                                   eps_bearer_id,
+                  isrran::span<isrran::unique_byte_buffer_t> sdus,
+                  isrran::span<const int>                    pdcp_sns) override
+  {
+    nof_write_sdus++;
+    pdcp_dummy::write_sdus(rnti, eps_bearer_id, sdus, pdcp_sns);
+  }
   std::map<uint32_t, isrran::unique_byte_buffer_t> get_buffered_pdus(uint16_t rnti, uint32_t eps_bearer_id) override
   {
     return std::move(buffered_pdus);
@@ -63,6 +72,8 @@ public:
   }
 
   std::map<uint32_t, isrran::unique_byte_buffer_t> buffered_pdus;
+  std::vector<std::pair<uint16_t, uint8_t> >       rx_sdus; ///< RNTI and first payload byte of each SDU
+  uint32_t                                         nof_write_sdus = 0;
   isrran::unique_byte_buffer_t                     last_sdu;
   int                                              last_pdcp_sn       = -1;
   uint16_t                                         last_rnti          = ISRRAN_INVALID_RNTI;
@@ -381,6 +392,148 @@ int test_gtpu_direct_tunneling(tunnel_test_event event)
   return ISRRAN_SUCCESS;
 }
 
+int test_gtpu_s1u_burst()
+{
+  uint16_t           rnti = 0x46, rnti2 = 0x47;
+  uint32_t           drb1_bearer_id = 5;
+  const char *       sgw_addr_str = "127.0.0.1", *enb_addr_str = "127.0.1.3";
+  struct sockaddr_in sgw_sockaddr = {}, enb_sockaddr = {};
+  isrran::net_utils::set_sockaddr(&sgw_sockaddr, sgw_addr_str, GTPU_PORT);
+  isrran::net_utils::set_sockaddr(&enb_sockaddr, enb_addr_str, GTPU_PORT);
+  uint32_t sgw_addr = ntohl(sgw_sockaddr.sin_addr.s_addr);
+
+  isrran::task_scheduler task_sched;
+  dummy_socket_manager   rx_sockets;
+  isrenb::gtpu           enb_gtpu(&task_sched, isrlog::fetch_basic_logger("GTPU"), &rx_sockets);
+  pdcp_tester            enb_pdcp;
+  gtpu_args_t            gtpu_args;
+  gtpu_args.gtp_bind_addr = enb_addr_str;
+  gtpu_args.mme_addr      = sgw_addr_str;
+  TESTASSERT(enb_gtpu.init(gtpu_args, &enb_pdcp) == ISRRAN_SUCCESS);
+  uint32_t addr_in;
+  uint32_t teid_in1 = enb_gtpu.add_bearer(rnti, drb1_bearer_id, sgw_addr, 1, addr_in).value();
+  uint32_t teid_in2 = enb_gtpu.add_bearer(rnti2, drb1_bearer_id, sgw_addr, 2, addr_in).value();
+
+  // Burst with G-PDUs of two UEs interleaved, and a G-PDU for an unknown TEID in the middle
+  isrran::recvfrom_burst_t burst;
+  std::vector<uint8_t>     data(10);
+  const uint8_t            nof_pdus = 10;
+  for (uint8_t i = 0; i < nof_pdus; ++i) {
+    std::fill(data.begin(), data.end(), i);
+    burst.pdus.push_back(encode_gtpu_packet(data, i % 3 == 0 ? teid_in2 : teid_in1, sgw_sockaddr, enb_sockaddr));
+    burst.from.push_back(sgw_sockaddr);
+    if (i == nof_pdus / 2) {
+      burst.pdus.push_back(encode_gtpu_packet(data, teid_in2 + 100, sgw_sockaddr, enb_sockaddr));
+      burst.from.push_back(sgw_sockaddr);
+    }
+  }
+  enb_gtpu.handle_gtpu_s1u_rx_burst(burst);
+
+  // TEST: PDCP receives one burst per bearer, with the SDUs of each bearer in order
+  TESTASSERT(enb_pdcp.nof_write_sdus == 2);
+  TESTASSERT(enb_pdcp.rx_sdus.size() == nof_pdus);
+  int last_sdu[2] = {-1, -1};
+  for (const auto& rx_sdu : enb_pdcp.rx_sdus) {
+    TESTASSERT(rx_sdu.first == (rx_sdu.second % 3 == 0 ? rnti2 : rnti));
+    int& last = last_sdu[rx_sdu.first == rnti2 ? 1 : 0];
+    TESTASSERT(rx_sdu.second > last);
+    last = rx_sdu.second;
+  }
+
+  // TEST: an End Marker is handled after the SDUs received before it, and the tunnel it removes is not used for the
+  //       rest of the burst
+  enb_pdcp.rx_sdus.clear();
+  enb_pdcp.nof_write_sdus = 0;
+  burst                   = {};
+  std::fill(data.begin(), data.end(), 0);
+  burst.pdus.push_back(encode_gtpu_packet(data, teid_in1, sgw_sockaddr, enb_sockaddr));
+  burst.pdus.push_back(encode_end_marker(teid_in1));
+  std::fill(data.begin(), data.end(), 1);
+  burst.pdus.push_back(encode_gtpu_packet(data, teid_in1, sgw_sockaddr, enb_sockaddr));
+  burst.from.assign(burst.pdus.size(), sgw_sockaddr);
+  enb_gtpu.handle_gtpu_s1u_rx_burst(burst);
+  TESTASSERT(enb_pdcp.nof_write_sdus == 1);
+  TESTASSERT(enb_pdcp.rx_sdus.size() == 1 and enb_pdcp.rx_sdus[0].second == 0);
+
+  enb_gtpu.stop();
+  return ISRRAN_SUCCESS;
+}
+
+int test_gtpu_ul_tx_batch()
+{
+  uint16_t           rnti = 0x46, rnti2 = 0x47;
+  uint32_t           drb1_bearer_id = 5;
+  const char *       sgw_addr_str = "127.0.1.5", *enb_addr_str = "127.0.1.4";
+  struct sockaddr_in sgw_sockaddr = {}, enb_sockaddr = {};
+  isrran::net_utils::set_sockaddr(&enb_sockaddr, enb_addr_str, GTPU_PORT);
+  uint32_t sgw_addr = ntohl(inet_addr(sgw_addr_str));
+
+  // SGW socket
+  isrran::unique_socket sgw_socket;
+  TESTASSERT(sgw_socket.open_socket(isrran::net_utils::addr_family::ipv4,
+                                    isrran::net_utils::socket_type::datagram,
+                                    isrran::net_utils::protocol_type::UDP));
+  TESTASSERT(sgw_socket.bind_addr(sgw_addr_str, GTPU_PORT));
+  sgw_sockaddr = sgw_socket.get_addr_in();
+
+  isrran::task_scheduler task_sched;
+  dummy_socket_manager   rx_sockets;
+  isrenb::gtpu           enb_gtpu(&task_sched, isrlog::fetch_basic_logger("GTPU"), &rx_sockets);
+  pdcp_tester            enb_pdcp;
+  gtpu_args_t            gtpu_args;
+  gtpu_args.gtp_bind_addr = enb_addr_str;
+  gtpu_args.mme_addr      = sgw_addr_str;
+  gtpu_args.tx_batch_size = 8;
+  TESTASSERT(enb_gtpu.init(gtpu_args, &enb_pdcp) == ISRRAN_SUCCESS);
+  uint32_t addr_in;
+  TESTASSERT(enb_gtpu.add_bearer(rnti, drb1_bearer_id, sgw_addr, 1, addr_in).has_value());
+  TESTASSERT(enb_gtpu.add_bearer(rnti2, drb1_bearer_id, sgw_addr, 2, addr_in).has_value());
+
+  // UL PDUs of two UEs, with a shorter and a longer one that end a run of equal sized PDUs
+  const uint8_t        nof_pdus             = 7;
+  const size_t         data_sizes[nof_pdus] = {10, 10, 10, 5, 10, 10, 20};
+  std::vector<uint8_t> data;
+  for (uint8_t i = 0; i < nof_pdus; ++i) {
+    data.assign(data_sizes[i], i);
+    uint16_t ue_rnti = i % 2 == 0 ? rnti : rnti2;
+    enb_gtpu.write_pdu(ue_rnti, drb1_bearer_id, encode_ipv4_packet(data, 0, enb_sockaddr, sgw_sockaddr));
+  }
+  isrran::unique_byte_buffer_t pdu = isrran::make_byte_buffer();
+
+  // TEST: the PDUs are held until the next TTI
+  TESTASSERT(recv(sgw_socket.fd(), pdu->msg, pdu->get_tailroom(), MSG_DONTWAIT) < 0);
+  enb_gtpu.tti_clock();
+
+  // TEST: the SGW receives every PDU as a separate datagram, in order
+  for (uint8_t i = 0; i < nof_pdus; ++i) {
+    ssize_t n = recv(sgw_socket.fd(), pdu->msg, pdu->get_tailroom(), MSG_DONTWAIT);
+    TESTASSERT(n == (ssize_t)(8 + sizeof(struct iphdr) + data_sizes[i]));
+    TESTASSERT(pdu->msg[4] == 0 and pdu->msg[7] == (i % 2 == 0 ? 1 : 2));
+    TESTASSERT(pdu->msg[n - 1] == i);
+  }
+  TESTASSERT(recv(sgw_socket.fd(), pdu->msg, pdu->get_tailroom(), MSG_DONTWAIT) < 0);
+
+  // TEST: a full batch is sent without waiting for the TTI
+  for (uint8_t i = 0; i < gtpu_args.tx_batch_size; ++i) {
+    data.assign(10, i);
+    enb_gtpu.write_pdu(rnti, drb1_bearer_id, encode_ipv4_packet(data, 0, enb_sockaddr, sgw_sockaddr));
+  }
+  for (uint8_t i = 0; i < gtpu_args.tx_batch_size; ++i) {
+    ssize_t n = recv(sgw_socket.fd(), pdu->msg, pdu->get_tailroom(), MSG_DONTWAIT);
+    TESTASSERT(n == (ssize_t)(8 + sizeof(struct iphdr) + 10) and pdu->msg[n - 1] == i);
+  }
+
+  gtpu_metrics_t metrics;
+  enb_gtpu.get_metrics(metrics);
+  TESTASSERT(metrics.tx_pdus == nof_pdus + gtpu_args.tx_batch_size);
+  TESTASSERT(metrics.tx_batches == 2);
+  TESTASSERT(metrics.max_tx_batch == gtpu_args.tx_batch_size);
+  TESTASSERT(metrics.tx_syscalls >= 2);
+
+  enb_gtpu.stop();
+  return ISRRAN_SUCCESS;
+}
+
 } // namespace isrenb
 
 int main(int argc, char** argv)
@@ -398,6 +551,8 @@ int main(int argc, char** argv)
   TESTASSERT(isrenb::test_gtpu_direct_tunneling(isrenb::tunnel_test_event::wait_end_marker_timeout) == ISRRAN_SUCCESS);
   TESTASSERT(isrenb::test_gtpu_direct_tunneling(isrenb::tunnel_test_event::ue_removal_no_marker) == ISRRAN_SUCCESS);
   TESTASSERT(isrenb::test_gtpu_direct_tunneling(isrenb::tunnel_test_event::reest_senb) == ISRRAN_SUCCESS);
+  TESTASSERT(isrenb::test_gtpu_s1u_burst() == ISRRAN_SUCCESS);
+  TESTASSERT(isrenb::test_gtpu_ul_tx_batch() == ISRRAN_SUCCESS);
 
   isrlog::flush();
 
@@ -30,11 +30,14 @@
 
 #include "isrran/common/buffer_pool.h"
 #include "isrran/common/standard_streams.h"
+#include "isrran/common/thread_pool.h"
 #include "isrran/interfaces/epc_interfaces.h"
 #include "isrran/isrlog/isrlog.h"
+#include <atomic>
 #include <cstddef>
-
+#include <deque>
 #include <map>
+#include <mutex>
 
 #define LTE_FDD_ENB_IND_HE_N_BITS 5
 #define LTE_FDD_ENB_IND_HE_MASK 0x1FUL
@@ -47,10 +50,27 @@ struct hss_args_t {
   std::string db_file;
   uint16_t    mcc;
   uint16_t    mnc;
+  uint32_t    av_pool_size; // Precomputed authentication vectors per subscriber, 0 to generate them on demand
+};
+
+struct hss_metrics_t {
+  uint64_t av_pool_hits;   // Authentication requests served from the AV pool
+  uint64_t av_pool_misses; // Authentication requests with an empty pool, generated on demand
+  uint64_t av_generated;   // AVs generated by the background generator
+  uint64_t av_discarded;   // Pooled AVs invalidated by a SQN re-synchronization
+  uint64_t av_pooled;      // AVs currently in the pools
 };
 
 enum hss_auth_algo { HSS_ALGO_XOR, HSS_ALGO_MILENAGE };
 
+/// Authentication vector, as returned to the MME in the Authentication Information Answer
+struct hss_auth_vector_t {
+  uint8_t k_asme[32];
+  uint8_t autn[16];
+  uint8_t rand[16];
+  uint8_t xres[16];
+};
+
 struct hss_ue_ctx_t {
   // Members
   std::string        name;
@@ -66,6 +86,12 @@ struct hss_ue_ctx_t {
   uint8_t            last_rand[16];
   std::string        static_ip_addr;
 
+  // Precomputed AVs, in SQN order. The generation is increased whenever the SQN is re-synchronized, so that AVs
+  // computed in the background with the old SQN are discarded.
+  std::deque<hss_auth_vector_t> av_pool;
+  uint32_t                      av_generation     = 0;
+  bool                          av_refill_pending = false;
+
   // Helper getters/setters
   void set_sqn(const uint8_t* sqn_);
   void set_last_rand(const uint8_t* rand_);
@@ -86,6 +112,7 @@ public:
   virtual bool resync_sqn(uint64_t imsi, uint8_t* auts);
 
   std::map<std::string, uint64_t> get_ip_to_imsi() const;
+  void                            get_metrics(hss_metrics_t& metrics) const;
 
 private:
   hss();
@@ -96,9 +123,23 @@ private:
 
   void gen_rand(uint8_t rand_[16]);
 
-  void
-       gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
-  void gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
+  void gen_auth_vector(hss_ue_ctx_t* ue_ctx, uint8_t* sqn, hss_auth_vector_t* av);
+  void gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx,
+                                     uint8_t*      sqn,
+                                     uint8_t*      k_asme,
+                                     uint8_t*      autn,
+                                     uint8_t*      rand,
+                                     uint8_t*      xres);
+  void gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx,
+                                uint8_t*      sqn,
+                                uint8_t*      k_asme,
+                                uint8_t*      autn,
+                                uint8_t*      rand,
+                                uint8_t*      xres);
+
+  // AV pool
+  void request_av_refill(hss_ue_ctx_t* ue_ctx);
+  void refill_av_pool(hss_ue_ctx_t* ue_ctx);
 
   void resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts);
   void resync_sqn_xor(hss_ue_ctx_t* ue_ctx, uint8_t* auts);
@@ -125,6 +166,17 @@ private:
   uint16_t mnc;
 
   std::map<std::string, uint64_t> m_ip_to_imsi;
+
+  /* Authentication vector pool. m_mutex protects the SQN, last RAND and AV pool of the UE contexts, which are
+   * accessed by the MME UE workers and the AV generator. */
+  std::mutex                           m_mutex;
+  uint32_t                             m_av_pool_size = 0;
+  std::unique_ptr<isrran::task_worker> m_av_generator;
+  std::atomic<uint64_t>                m_av_pool_hits{0};
+  std::atomic<uint64_t>                m_av_pool_misses{0};
+  std::atomic<uint64_t>                m_av_generated{0};
+  std::atomic<uint64_t>                m_av_discarded{0};
+  std::atomic<uint64_t>                m_av_pooled{0};
 };
 
 inline void hss_ue_ctx_t::set_sqn(const uint8_t* sqn_)
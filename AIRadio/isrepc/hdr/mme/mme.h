@@ -33,6 +33,7 @@
 #include "isrran/common/standard_streams.h"
 #include "isrran/common/threads.h"
 #include <cstddef>
+#include <mutex>
 
 namespace isrepc {
 
@@ -46,6 +47,7 @@ typedef struct {
   int                 fd;
   uint64_t            imsi;
   enum nas_timer_type type;
+  uint32_t            ue_worker; // UE worker that handles the expiry
 } mme_timer_t;
 
 class mme : public isrran::thread, public mme_interface_nas
@@ -74,8 +76,10 @@ private:
   bool   m_running;
   fd_set m_set;
 
-  // Timer map
+  // Timer map. The timers are started and stopped by the UE workers, which wake up the MME thread through the pipe
   std::vector<mme_timer_t> timers;
+  std::mutex               timers_mutex;
+  int                      timers_pipe[2] = {-1, -1};
 
   // Timer Methods
   void handle_timer_expire(int timer_fd);
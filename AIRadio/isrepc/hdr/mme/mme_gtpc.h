@@ -24,6 +24,7 @@
 #include "nas.h"
 #include "isrran/asn1/gtpc.h"
 #include "isrran/common/buffer_pool.h"
+#include <mutex>
 #include <sys/socket.h>
 #include <sys/un.h>
 
@@ -66,22 +67,19 @@ private:
   isrlog::basic_logger& m_logger = isrlog::fetch_basic_logger("MME GTPC");
   s1ap*                 m_s1ap;
 
-  uint32_t                            m_next_ctrl_teid;
+  std::vector<uint32_t>               m_next_ctrl_teid; // Next TEID of each UE worker
   std::map<uint32_t, uint64_t>        m_mme_ctr_teid_to_imsi;
   std::map<uint64_t, struct gtpc_ctx> m_imsi_to_gtpc_ctx;
+  std::mutex                          m_mutex; // Protects the GTP-C contexts, which are shared by the UE workers
 
   int                m_s11;
   struct sockaddr_un m_mme_addr, m_spgw_addr;
 
   bool     init_s11();
   uint32_t get_new_ctrl_teid();
+  void     handle_s11_msg(isrran::gtpc_pdu* pdu);
 };
 
-inline uint32_t mme_gtpc::get_new_ctrl_teid()
-{
-  return m_next_ctrl_teid++;
-}
-
 inline int mme_gtpc::get_s11()
 {
   return m_s11;
@@ -35,10 +35,12 @@
 #include "isrran/common/common.h"
 #include "isrran/common/s1ap_pcap.h"
 #include "isrran/common/standard_streams.h"
+#include "isrran/common/thread_pool.h"
 #include "isrran/interfaces/epc_interfaces.h"
 #include "isrran/isrlog/isrlog.h"
 #include <arpa/inet.h>
 #include <map>
+#include <mutex>
 #include <netinet/sctp.h>
 #include <set>
 #include <strings.h>
@@ -82,6 +84,8 @@ public:
   void       add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinfo* enb_sri);
   void       get_enb_ctx(uint16_t sctp_stream);
 
+  std::map<uint16_t, struct sctp_sndrcvinfo> get_enb_sris();
+
   bool add_nas_ctx_to_imsi_map(nas* nas_ctx);
   bool add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx);
   bool add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id);
@@ -128,12 +132,34 @@ public:
 
   virtual bool expire_nas_timer(enum nas_timer_type type, uint64_t imsi);
 
+  // UE workers. The procedures of a UE run in order in the worker selected by its MME-UE-S1AP-ID or MME control TEID,
+  // which are allocated so that they map back to the worker of the UE. Initial UE Messages of a UE with a context are
+  // sent to the worker that owns it. Without workers, tasks run in the caller.
+  using ue_task_t = isrran::move_callback<void(), isrran::default_move_callback_buffer_size, true>;
+  uint32_t get_nof_ue_workers() const { return m_ue_workers.size(); }
+  uint32_t get_current_ue_worker() const;
+  void     push_ue_task(uint32_t ue_id, ue_task_t&& task);
+
 private:
   s1ap();
   virtual ~s1ap();
 
   static s1ap* m_instance;
 
+  static const uint32_t ue_worker_queue_size = 4096;
+
+  struct rx_msg_t {
+    asn1::arena            msg_arena;
+    s1ap_pdu_t             pdu;
+    struct sctp_sndrcvinfo enb_sri;
+  };
+
+  void handle_rx_msg(rx_msg_t& msg);
+  bool get_rx_msg_ue_id(const rx_msg_t& msg, uint32_t* ue_id);
+  bool find_init_ue_msg_worker(const asn1::s1ap::init_ue_msg_s& init_ue, uint32_t* ue_worker);
+  void release_enb_ue_ecm_ctx(uint32_t mme_ue_s1ap_id);
+  void delete_nas_ctx(nas* nas_ctx);
+
   uint32_t m_plmn;
 
   hss_interface_nas*                     m_hss;
@@ -141,11 +167,17 @@ private:
   std::map<int32_t, uint16_t>            m_sctp_to_enb_id;
   std::map<int32_t, std::set<uint32_t> > m_enb_assoc_to_ue_ids;
 
-  std::map<uint64_t, nas*> m_imsi_to_nas_ctx;
-  std::map<uint32_t, nas*> m_mme_ue_s1ap_id_to_nas_ctx;
+  std::map<uint64_t, nas*>     m_imsi_to_nas_ctx;
+  std::map<uint64_t, uint32_t> m_imsi_to_ue_worker; // UE worker that created each NAS context
+  std::map<uint32_t, nas*>     m_mme_ue_s1ap_id_to_nas_ctx;
+
+  // Protects the eNB and UE context maps and the M-TMSI allocation, which are shared by the UE workers
+  std::mutex m_ctx_mutex;
+
+  std::vector<uint32_t> m_next_mme_ue_s1ap_id; // Next ID of each UE worker
+  uint32_t              m_next_m_tmsi;
 
-  uint32_t m_next_mme_ue_s1ap_id;
-  uint32_t m_next_m_tmsi;
+  std::vector<std::unique_ptr<isrran::task_worker> > m_ue_workers;
 
   // GTP-C Interface
   mme_gtpc* m_mme_gtpc;
@@ -153,6 +185,7 @@ private:
   // PCAP
   bool              m_pcap_enable;
   isrran::s1ap_pcap m_pcap;
+  std::mutex        m_pcap_mutex;
 };
 
 inline uint32_t s1ap::get_plmn()
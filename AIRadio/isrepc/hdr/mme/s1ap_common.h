@@ -53,6 +53,7 @@ typedef struct {
   isrran::INTEGRITY_ALGORITHM_ID_ENUM integrity_algo;
   bool                                request_imeisv;
   uint16_t                            lac;
+  uint32_t                            nof_workers; // Number of UE worker threads, 0 to run the UEs in the MME thread
 } s1ap_args_t;
 
 typedef struct {
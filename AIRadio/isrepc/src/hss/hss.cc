@@ -79,13 +79,49 @@ int hss::init(hss_args_t* hss_args)
 
   db_file = hss_args->db_file;
 
-  m_logger.info("HSS Initialized. DB file %s, MCC: %d, MNC: %d", hss_args->db_file.c_str(), mcc, mnc);
+  // AVs may be used out of order after an on-demand generation, which the UE only accepts within the IND range
+  m_av_pool_size = hss_args->av_pool_size;
+  if (m_av_pool_size > LTE_FDD_ENB_IND_HE_MAX_VALUE) {
+    m_logger.warning(
+        "AV pool size %d exceeds the SQN IND range. Using %d", m_av_pool_size, LTE_FDD_ENB_IND_HE_MAX_VALUE);
+    m_av_pool_size = LTE_FDD_ENB_IND_HE_MAX_VALUE;
+  }
+  if (m_av_pool_size > 0) {
+    // There is at most one pending refill per subscriber, so the generator queue never overflows
+    m_av_generator.reset(new isrran::task_worker("HSS_AV", m_imsi_to_ue_ctx.size() + 1));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it = m_imsi_to_ue_ctx.begin();
+         it != m_imsi_to_ue_ctx.end();
+         ++it) {
+      request_av_refill(it->second.get());
+    }
+  }
+
+  m_logger.info("HSS Initialized. DB file %s, MCC: %d, MNC: %d, AV pool size: %d",
+                hss_args->db_file.c_str(),
+                mcc,
+                mnc,
+                m_av_pool_size);
   isrran::console("HSS Initialized.\n");
   return 0;
 }
 
 void hss::stop()
 {
+  // The SQNs consumed by the discarded pooled AVs are skipped, which the UE accepts
+  if (m_av_generator != nullptr) {
+    m_av_generator->stop();
+    hss_metrics_t metrics;
+    get_metrics(metrics);
+    uint64_t nof_requests = metrics.av_pool_hits + metrics.av_pool_misses;
+    m_logger.info("AV pool: %" PRIu64 " hits, %" PRIu64 " misses (%.1f%% hit rate), %" PRIu64
+                  " generated, %" PRIu64 " discarded",
+                  metrics.av_pool_hits,
+                  metrics.av_pool_misses,
+                  nof_requests > 0 ? 100.0 * metrics.av_pool_hits / nof_requests : 0.0,
+                  metrics.av_generated,
+                  metrics.av_discarded);
+  }
   write_db_file(db_file);
   return;
 }
@@ -265,29 +301,106 @@ bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, ui
     return false;
   }
 
+  // Take a precomputed AV, or reserve a SQN to generate one when the pool is empty
+  hss_auth_vector_t av;
+  uint8_t           sqn[6];
+  bool              pool_hit = false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (not ue_ctx->av_pool.empty()) {
+      av = ue_ctx->av_pool.front();
+      ue_ctx->av_pool.pop_front();
+      m_av_pooled--;
+      pool_hit = true;
+    } else {
+      memcpy(sqn, ue_ctx->sqn, 6);
+      increment_ue_sqn(ue_ctx);
+    }
+  }
+  if (pool_hit) {
+    m_av_pool_hits++;
+    m_logger.debug("Using precomputed AV -- IMSI: %015" PRIu64 "", imsi);
+  } else {
+    m_av_pool_misses++;
+    gen_auth_vector(ue_ctx, sqn, &av);
+  }
+
+  memcpy(k_asme, av.k_asme, sizeof(av.k_asme));
+  memcpy(autn, av.autn, sizeof(av.autn));
+  memcpy(rand, av.rand, sizeof(av.rand));
+  memcpy(xres, av.xres, sizeof(av.xres));
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ue_ctx->set_last_rand(av.rand);
+  request_av_refill(ue_ctx);
+  return true;
+}
+
+void hss::gen_auth_vector(hss_ue_ctx_t* ue_ctx, uint8_t* sqn, hss_auth_vector_t* av)
+{
   switch (ue_ctx->algo) {
     case HSS_ALGO_XOR:
-      gen_auth_info_answer_xor(ue_ctx, k_asme, autn, rand, xres);
+      gen_auth_info_answer_xor(ue_ctx, sqn, av->k_asme, av->autn, av->rand, av->xres);
       break;
     case HSS_ALGO_MILENAGE:
-      gen_auth_info_answer_milenage(ue_ctx, k_asme, autn, rand, xres);
+      gen_auth_info_answer_milenage(ue_ctx, sqn, av->k_asme, av->autn, av->rand, av->xres);
       break;
   }
-  increment_ue_sqn(ue_ctx);
-  return true;
+}
+
+// Schedules the refill of the AV pool of the UE in the background generator. Must be called with m_mutex held.
+void hss::request_av_refill(hss_ue_ctx_t* ue_ctx)
+{
+  if (m_av_generator == nullptr or ue_ctx->av_refill_pending or ue_ctx->av_pool.size() >= m_av_pool_size) {
+    return;
+  }
+  ue_ctx->av_refill_pending = true;
+  m_av_generator->push_task([this, ue_ctx]() { refill_av_pool(ue_ctx); });
+}
+
+void hss::refill_av_pool(hss_ue_ctx_t* ue_ctx)
+{
+  while (true) {
+    // Each AV consumes the next SQN of the UE, so the SQN written to the DB file is never reused after a restart
+    uint8_t  sqn[6];
+    uint32_t generation;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (ue_ctx->av_pool.size() >= m_av_pool_size) {
+        ue_ctx->av_refill_pending = false;
+        return;
+      }
+      memcpy(sqn, ue_ctx->sqn, 6);
+      increment_ue_sqn(ue_ctx);
+      generation = ue_ctx->av_generation;
+    }
+
+    hss_auth_vector_t av;
+    gen_auth_vector(ue_ctx, sqn, &av);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (generation != ue_ctx->av_generation) {
+      // The SQN was re-synchronized while the AV was being computed
+      m_av_discarded++;
+      continue;
+    }
+    ue_ctx->av_pool.push_back(av);
+    m_av_generated++;
+    m_av_pooled++;
+  }
 }
 
 void hss::gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx,
+                                        uint8_t*      sqn,
                                         uint8_t*      k_asme,
                                         uint8_t*      autn,
                                         uint8_t*      rand,
                                         uint8_t*      xres)
 {
-  // Get K, AMF, OPC and SQN
+  // Get K, AMF and OPC
   uint8_t* k   = ue_ctx->key;
   uint8_t* amf = ue_ctx->amf;
   uint8_t* opc = ue_ctx->opc;
-  uint8_t* sqn = ue_ctx->sqn;
 
   // Temp variables
   uint8_t ck[16];
@@ -333,19 +446,20 @@ void hss::gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx,
     autn[8 + i] = mac[i];
   }
   m_logger.debug(autn, 16, "User AUTN: ");
-
-  // Set last RAND
-  ue_ctx->set_last_rand(rand);
   return;
 }
 
-void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
+void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx,
+                                   uint8_t*      sqn,
+                                   uint8_t*      k_asme,
+                                   uint8_t*      autn,
+                                   uint8_t*      rand,
+                                   uint8_t*      xres)
 {
-  // Get K, AMF, OPC and SQN
+  // Get K, AMF and OPC
   uint8_t* k   = ue_ctx->key;
   uint8_t* amf = ue_ctx->amf;
   uint8_t* opc = ue_ctx->opc;
-  uint8_t* sqn = ue_ctx->sqn;
 
   // Temp variables
   uint8_t xdout[16];
@@ -432,9 +546,6 @@ void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_
   }
 
   m_logger.debug(autn, 8, "User AUTN: ");
-
-  // Set last RAND
-  ue_ctx->set_last_rand(rand);
   return;
 }
 
@@ -462,6 +573,7 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
     return false;
   }
 
+  std::lock_guard<std::mutex> lock(m_mutex);
   switch (ue_ctx->algo) {
     case HSS_ALGO_XOR:
       resync_sqn_xor(ue_ctx, auts);
@@ -472,6 +584,13 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
   }
 
   increment_seq_after_resync(ue_ctx);
+
+  // The pooled AVs were computed with the old SQN
+  m_av_discarded += ue_ctx->av_pool.size();
+  m_av_pooled -= ue_ctx->av_pool.size();
+  ue_ctx->av_pool.clear();
+  ue_ctx->av_generation++;
+  request_av_refill(ue_ctx);
   return true;
 }
 
@@ -626,4 +745,13 @@ std::map<std::string, uint64_t> hss::get_ip_to_imsi(void) const
   return m_ip_to_imsi;
 }
 
+void hss::get_metrics(hss_metrics_t& metrics) const
+{
+  metrics.av_pool_hits   = m_av_pool_hits;
+  metrics.av_pool_misses = m_av_pool_misses;
+  metrics.av_generated   = m_av_generated;
+  metrics.av_discarded   = m_av_discarded;
+  metrics.av_pooled      = m_av_pooled;
+}
+
 } // namespace isrepc
@@ -77,6 +77,12 @@ int mme::init(mme_args_t* args)
     exit(-1);
   }
 
+  /*Init timer wake-up pipe*/
+  if (pipe(timers_pipe) == -1) {
+    m_s1ap_logger.error("Error creating timer pipe: %s", strerror(errno));
+    exit(-1);
+  }
+
   /*Log successful initialization*/
   m_s1ap_logger.info("MME Initialized. MCC: 0x%x, MNC: 0x%x", args->s1ap_args.mcc, args->s1ap_args.mnc);
   isrran::console("MME Initialized. MCC: 0x%x, MNC: 0x%x\n", args->s1ap_args.mcc, args->s1ap_args.mnc);
@@ -92,6 +98,12 @@ void mme::stop()
     thread_cancel();
     wait_thread_finish();
   }
+  if (timers_pipe[0] != -1) {
+    close(timers_pipe[0]);
+    close(timers_pipe[1]);
+    timers_pipe[0] = -1;
+    timers_pipe[1] = -1;
+  }
   return;
 }
 
@@ -120,18 +132,21 @@ void mme::run_thread()
 
   while (m_running) {
     pdu->clear();
-    int max_fd = std::max(s1mme, s11);
+    int max_fd = std::max(std::max(s1mme, s11), timers_pipe[0]);
 
     FD_ZERO(&m_set);
     FD_SET(s1mme, &m_set);
     FD_SET(s11, &m_set);
+    FD_SET(timers_pipe[0], &m_set);
 
     // Add timers to select
+    std::unique_lock<std::mutex> timers_lock(timers_mutex);
     for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end(); ++it) {
       FD_SET(it->fd, &m_set);
       max_fd = std::max(max_fd, it->fd);
       m_s1ap_logger.debug("Adding Timer fd %d to fd_set", it->fd);
     }
+    timers_lock.unlock();
 
     m_s1ap_logger.debug("Waiting for S1-MME or S11 Message");
     int n = select(max_fd + 1, &m_set, NULL, NULL, NULL);
@@ -168,19 +183,32 @@ void mme::run_thread()
         pdu->N_bytes = recvfrom(s11, pdu->msg, sz, 0, NULL, NULL);
         m_mme_gtpc->handle_s11_pdu(pdu.get());
       }
-      // Handle NAS Timers
+      // Handle timer changes
+      if (FD_ISSET(timers_pipe[0], &m_set)) {
+        uint8_t wakeup;
+        rd_sz = read(timers_pipe[0], &wakeup, sizeof(wakeup));
+      }
+      // Handle NAS Timers. The expiry is handled by the UE worker that started the timer
+      std::vector<mme_timer_t> expired_timers;
+      timers_lock.lock();
       for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end();) {
         if (FD_ISSET(it->fd, &m_set)) {
           m_s1ap_logger.info("Timer expired");
           uint64_t exp;
           rd_sz = read(it->fd, &exp, sizeof(uint64_t));
-          m_s1ap->expire_nas_timer(it->type, it->imsi);
           close(it->fd);
-          timers.erase(it);
+          expired_timers.push_back(*it);
+          it = timers.erase(it);
         } else {
           ++it;
         }
       }
+      timers_lock.unlock();
+      for (const mme_timer_t& timer : expired_timers) {
+        nas_timer_type type = timer.type;
+        uint64_t       imsi = timer.imsi;
+        m_s1ap->push_ue_task(timer.ue_worker, [this, type, imsi]() { m_s1ap->expire_nas_timer(type, imsi); });
+      }
     } else {
       m_s1ap_logger.debug("No data from select.");
     }
@@ -196,16 +224,25 @@ bool mme::add_nas_timer(int timer_fd, nas_timer_type type, uint64_t imsi)
   m_s1ap_logger.debug("Adding NAS timer to MME. IMSI %" PRIu64 ", Type %d, Fd: %d", imsi, type, timer_fd);
 
   mme_timer_t timer;
-  timer.fd   = timer_fd;
-  timer.type = type;
-  timer.imsi = imsi;
+  timer.fd        = timer_fd;
+  timer.type      = type;
+  timer.imsi      = imsi;
+  timer.ue_worker = m_s1ap->get_current_ue_worker();
 
+  std::lock_guard<std::mutex> lock(timers_mutex);
   timers.push_back(timer);
+
+  // Wake up the MME thread to add the timer to select
+  uint8_t wakeup = 0;
+  if (write(timers_pipe[1], &wakeup, sizeof(wakeup)) != sizeof(wakeup)) {
+    m_s1ap_logger.error("Error waking up the MME thread: %s", strerror(errno));
+  }
   return true;
 }
 
 bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 {
+  std::lock_guard<std::mutex>        lock(timers_mutex);
   std::vector<mme_timer_t>::iterator it;
   for (it = timers.begin(); it != timers.end(); ++it) {
     if (it->type == type && it->imsi == imsi) {
@@ -217,6 +254,7 @@ bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 
 bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
 {
+  std::lock_guard<std::mutex>        lock(timers_mutex);
   std::vector<mme_timer_t>::iterator it;
   for (it = timers.begin(); it != timers.end(); ++it) {
     if (it->type == type && it->imsi == imsi) {
@@ -230,7 +268,6 @@ bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
 
   // removing timer
   m_s1ap_logger.debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d, Fd: %d", imsi, type, it->fd);
-  FD_CLR(it->fd, &m_set);
   close(it->fd);
   timers.erase(it);
   return true;
@@ -35,10 +35,15 @@ mme_gtpc* mme_gtpc::get_instance()
 
 bool mme_gtpc::init()
 {
-  m_next_ctrl_teid = 1;
-
   m_s1ap = s1ap::get_instance();
 
+  // The MME control TEIDs allocated by each UE worker are congruent to its index, so that the responses return to it
+  uint32_t nof_teid_ranges = std::max(m_s1ap->get_nof_ue_workers(), 1u);
+  m_next_ctrl_teid.resize(nof_teid_ranges);
+  for (uint32_t i = 0; i < nof_teid_ranges; ++i) {
+    m_next_ctrl_teid[i] = nof_teid_ranges + i;
+  }
+
   if (!init_s11()) {
     m_logger.error("Error Initializing MME S11 Interface");
     return false;
@@ -107,12 +112,37 @@ bool mme_gtpc::send_s11_pdu(const isrran::gtpc_pdu& pdu)
   return true;
 }
 
+uint32_t mme_gtpc::get_new_ctrl_teid()
+{
+  uint32_t& next_teid = m_next_ctrl_teid[m_s1ap->get_current_ue_worker()];
+  uint32_t  teid      = next_teid;
+  next_teid += m_next_ctrl_teid.size();
+  return teid;
+}
+
 void mme_gtpc::handle_s11_pdu(isrran::byte_buffer_t* msg)
 {
   m_logger.debug("Received S11 message");
 
-  isrran::gtpc_pdu* pdu;
-  pdu = (isrran::gtpc_pdu*)msg->msg;
+  // The messages are handled in the worker of the UE, selected by the MME control TEID
+  isrran::gtpc_pdu* pdu = (isrran::gtpc_pdu*)msg->msg;
+  if (m_s1ap->get_nof_ue_workers() == 0) {
+    handle_s11_msg(pdu);
+    return;
+  }
+  isrran::unique_byte_buffer_t rx_msg = isrran::make_byte_buffer();
+  if (rx_msg == nullptr || msg->N_bytes > rx_msg->get_tailroom()) {
+    m_logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+    return;
+  }
+  memcpy(rx_msg->msg, msg->msg, msg->N_bytes);
+  rx_msg->N_bytes = msg->N_bytes;
+  m_s1ap->push_ue_task(pdu->header.teid,
+                       [this, rx = std::move(rx_msg)]() { handle_s11_msg((isrran::gtpc_pdu*)rx->msg); });
+}
+
+void mme_gtpc::handle_s11_msg(isrran::gtpc_pdu* pdu)
+{
   m_logger.debug("MME Received GTP-C PDU. Message type %s", isrran::gtpc_msg_type_to_str(pdu->header.type));
   switch (pdu->header.type) {
     case isrran::GTPC_MSG_TYPE_CREATE_SESSION_RESPONSE:
@@ -151,7 +181,6 @@ bool mme_gtpc::send_create_session_request(uint64_t imsi)
   // Control TEID allocated
   cs_req->sender_f_teid.teid = get_new_ctrl_teid();
 
-  m_logger.info("Next MME control TEID: %d", m_next_ctrl_teid);
   m_logger.info("Allocated MME control TEID: %d", cs_req->sender_f_teid.teid);
   isrran::console("Creating Session Response -- IMSI: %" PRIu64 "\n", imsi);
   isrran::console("Creating Session Response -- MME control TEID: %d\n", cs_req->sender_f_teid.teid);
@@ -167,6 +196,7 @@ bool mme_gtpc::send_create_session_request(uint64_t imsi)
   cs_req->eps_bearer_context_created.ebi = 5;
 
   // Check whether this UE is already registed
+  std::lock_guard<std::mutex>                   lock(m_mutex);
   std::map<uint64_t, struct gtpc_ctx>::iterator it = m_imsi_to_gtpc_ctx.find(imsi);
   if (it != m_imsi_to_gtpc_ctx.end()) {
     m_logger.warning("Create Session Request being called for an UE with an active GTP-C connection.");
@@ -213,12 +243,16 @@ bool mme_gtpc::handle_create_session_response(isrran::gtpc_pdu* cs_resp_pdu)
   }
 
   // Get IMSI from the control TEID
-  std::map<uint32_t, uint64_t>::iterator id_it = m_mme_ctr_teid_to_imsi.find(cs_resp_pdu->header.teid);
-  if (id_it == m_mme_ctr_teid_to_imsi.end()) {
-    m_logger.warning("Could not find IMSI from Ctrl TEID.");
-    return false;
+  uint64_t imsi;
+  {
+    std::lock_guard<std::mutex>            lock(m_mutex);
+    std::map<uint32_t, uint64_t>::iterator id_it = m_mme_ctr_teid_to_imsi.find(cs_resp_pdu->header.teid);
+    if (id_it == m_mme_ctr_teid_to_imsi.end()) {
+      m_logger.warning("Could not find IMSI from Ctrl TEID.");
+      return false;
+    }
+    imsi = id_it->second;
   }
-  uint64_t imsi = id_it->second;
 
   m_logger.info("MME GTPC Ctrl TEID %" PRIu64 ", IMSI %" PRIu64 "", cs_resp_pdu->header.teid, imsi);
 
@@ -263,14 +297,17 @@ bool mme_gtpc::handle_create_session_response(isrran::gtpc_pdu* cs_resp_pdu)
   isrran::console("SPGW Allocated IP %s to IMSI %015" PRIu64 "\n", inet_ntoa(emm_ctx->ue_ip), emm_ctx->imsi);
 
   // Save SGW ctrl F-TEID in GTP-C context
-  std::map<uint64_t, struct gtpc_ctx>::iterator it_g = m_imsi_to_gtpc_ctx.find(imsi);
-  if (it_g == m_imsi_to_gtpc_ctx.end()) {
-    // Could not find GTP-C Context
-    m_logger.error("Could not find GTP-C context");
-    return false;
+  {
+    std::lock_guard<std::mutex>                   lock(m_mutex);
+    std::map<uint64_t, struct gtpc_ctx>::iterator it_g = m_imsi_to_gtpc_ctx.find(imsi);
+    if (it_g == m_imsi_to_gtpc_ctx.end()) {
+      // Could not find GTP-C Context
+      m_logger.error("Could not find GTP-C context");
+      return false;
+    }
+    gtpc_ctx_t* gtpc_ctx    = &it_g->second;
+    gtpc_ctx->sgw_ctr_fteid = sgw_ctr_fteid;
   }
-  gtpc_ctx_t* gtpc_ctx    = &it_g->second;
-  gtpc_ctx->sgw_ctr_fteid = sgw_ctr_fteid;
 
   // Set EPS bearer context
   // TODO default EPS bearer is hard-coded
@@ -288,6 +325,7 @@ bool mme_gtpc::send_modify_bearer_request(uint64_t imsi, uint16_t erab_to_modify
   isrran::gtpc_pdu mb_req_pdu;
   std::memset(&mb_req_pdu, 0, sizeof(mb_req_pdu));
 
+  std::lock_guard<std::mutex>              lock(m_mutex);
   std::map<uint64_t, gtpc_ctx_t>::iterator it = m_imsi_to_gtpc_ctx.find(imsi);
   if (it == m_imsi_to_gtpc_ctx.end()) {
     m_logger.error("Modify bearer request for UE without GTP-C connection");
@@ -317,16 +355,21 @@ bool mme_gtpc::send_modify_bearer_request(uint64_t imsi, uint16_t erab_to_modify
 
 void mme_gtpc::handle_modify_bearer_response(isrran::gtpc_pdu* mb_resp_pdu)
 {
-  uint32_t                               mme_ctrl_teid = mb_resp_pdu->header.teid;
-  std::map<uint32_t, uint64_t>::iterator imsi_it       = m_mme_ctr_teid_to_imsi.find(mme_ctrl_teid);
-  if (imsi_it == m_mme_ctr_teid_to_imsi.end()) {
-    m_logger.error("Could not find IMSI from control TEID");
-    return;
+  uint32_t mme_ctrl_teid = mb_resp_pdu->header.teid;
+  uint64_t imsi;
+  {
+    std::lock_guard<std::mutex>            lock(m_mutex);
+    std::map<uint32_t, uint64_t>::iterator imsi_it = m_mme_ctr_teid_to_imsi.find(mme_ctrl_teid);
+    if (imsi_it == m_mme_ctr_teid_to_imsi.end()) {
+      m_logger.error("Could not find IMSI from control TEID");
+      return;
+    }
+    imsi = imsi_it->second;
   }
 
   uint8_t ebi = mb_resp_pdu->choice.modify_bearer_response.eps_bearer_context_modified.ebi;
   m_logger.debug("Activating EPS bearer with id %d", ebi);
-  m_s1ap->activate_eps_bearer(imsi_it->second, ebi);
+  m_s1ap->activate_eps_bearer(imsi, ebi);
 
   return;
 }
@@ -340,6 +383,7 @@ bool mme_gtpc::send_delete_session_request(uint64_t imsi)
   isrran::gtp_fteid_t mme_ctr_fteid;
 
   // Get S-GW Ctr TEID
+  std::lock_guard<std::mutex>              lock(m_mutex);
   std::map<uint64_t, gtpc_ctx_t>::iterator it_ctx = m_imsi_to_gtpc_ctx.find(imsi);
   if (it_ctx == m_imsi_to_gtpc_ctx.end()) {
     m_logger.error("Could not find GTP-C context to remove");
@@ -380,6 +424,7 @@ void mme_gtpc::send_release_access_bearers_request(uint64_t imsi)
   isrran::gtp_fteid_t sgw_ctr_fteid;
 
   // Get S-GW Ctr TEID
+  std::lock_guard<std::mutex>              lock(m_mutex);
   std::map<uint64_t, gtpc_ctx_t>::iterator it_ctx = m_imsi_to_gtpc_ctx.find(imsi);
   if (it_ctx == m_imsi_to_gtpc_ctx.end()) {
     m_logger.error("Could not find GTP-C context to remove");
@@ -406,10 +451,15 @@ bool mme_gtpc::handle_downlink_data_notification(isrran::gtpc_pdu* dl_not_pdu)
 {
   uint32_t                                 mme_ctrl_teid = dl_not_pdu->header.teid;
   isrran::gtpc_downlink_data_notification* dl_not        = &dl_not_pdu->choice.downlink_data_notification;
-  std::map<uint32_t, uint64_t>::iterator   imsi_it       = m_mme_ctr_teid_to_imsi.find(mme_ctrl_teid);
-  if (imsi_it == m_mme_ctr_teid_to_imsi.end()) {
-    m_logger.error("Could not find IMSI from control TEID");
-    return false;
+  uint64_t                                 imsi;
+  {
+    std::lock_guard<std::mutex>            lock(m_mutex);
+    std::map<uint32_t, uint64_t>::iterator imsi_it = m_mme_ctr_teid_to_imsi.find(mme_ctrl_teid);
+    if (imsi_it == m_mme_ctr_teid_to_imsi.end()) {
+      m_logger.error("Could not find IMSI from control TEID");
+      return false;
+    }
+    imsi = imsi_it->second;
   }
 
   if (!dl_not->eps_bearer_id_present) {
@@ -417,9 +467,9 @@ bool mme_gtpc::handle_downlink_data_notification(isrran::gtpc_pdu* dl_not_pdu)
     return false;
   }
   uint8_t ebi = dl_not->eps_bearer_id;
-  m_logger.debug("Downlink Data Notification -- IMSI: %015" PRIu64 ", EBI %d", imsi_it->second, ebi);
+  m_logger.debug("Downlink Data Notification -- IMSI: %015" PRIu64 ", EBI %d", imsi, ebi);
 
-  m_s1ap->send_paging(imsi_it->second, ebi);
+  m_s1ap->send_paging(imsi, ebi);
   return true;
 }
 
@@ -431,6 +481,7 @@ void mme_gtpc::send_downlink_data_notification_acknowledge(uint64_t imsi, enum i
   std::memset(&not_ack_pdu, 0, sizeof(not_ack_pdu));
 
   // get s-gw ctr teid
+  std::lock_guard<std::mutex>              lock(m_mutex);
   std::map<uint64_t, gtpc_ctx_t>::iterator it_ctx = m_imsi_to_gtpc_ctx.find(imsi);
   if (it_ctx == m_imsi_to_gtpc_ctx.end()) {
     m_logger.error("could not find gtp-c context to remove");
@@ -461,6 +512,7 @@ bool mme_gtpc::send_downlink_data_notification_failure_indication(uint64_t imsi,
   std::memset(&not_fail_pdu, 0, sizeof(not_fail_pdu));
 
   // get s-gw ctr teid
+  std::lock_guard<std::mutex>              lock(m_mutex);
   std::map<uint64_t, gtpc_ctx_t>::iterator it_ctx = m_imsi_to_gtpc_ctx.find(imsi);
   if (it_ctx == m_imsi_to_gtpc_ctx.end()) {
     m_logger.error("could not find gtp-c context to send paging failure");
@@ -22,6 +22,7 @@
 #include "isrepc/hdr/mme/s1ap.h"
 #include "isrran/asn1/gtpc.h"
 #include "isrran/common/bcd_helpers.h"
+#include "isrran/common/int_helpers.h"
 #include "isrran/common/liblte_security.h"
 #include "isrran/common/network_utils.h"
 #include <cmath>
@@ -33,7 +34,10 @@ namespace isrepc {
 s1ap*           s1ap::m_instance    = NULL;
 pthread_mutex_t s1ap_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-s1ap::s1ap() : m_s1mme(-1), m_next_mme_ue_s1ap_id(1), m_mme_gtpc(NULL) {}
+// Index of the UE worker running in this thread
+static thread_local uint32_t current_ue_worker = 0;
+
+s1ap::s1ap() : m_s1mme(-1), m_mme_gtpc(NULL) {}
 
 s1ap::~s1ap()
 {
@@ -88,6 +92,17 @@ int s1ap::init(const s1ap_args_t& s1ap_args)
   // Get pointer to GTP-C class
   m_mme_gtpc = mme_gtpc::get_instance();
 
+  // Init UE workers. The MME-UE-S1AP-IDs allocated by each worker are congruent to its index
+  uint32_t nof_id_ranges = std::max(s1ap_args.nof_workers, 1u);
+  m_next_mme_ue_s1ap_id.resize(nof_id_ranges);
+  for (uint32_t i = 0; i < nof_id_ranges; ++i) {
+    m_next_mme_ue_s1ap_id[i] = nof_id_ranges + i;
+  }
+  for (uint32_t i = 0; i < s1ap_args.nof_workers; ++i) {
+    m_ue_workers.emplace_back(new isrran::task_worker("MME_UE" + std::to_string(i), ue_worker_queue_size));
+    m_ue_workers.back()->push_task([i]() { current_ue_worker = i; });
+  }
+
   // Initialize S1-MME
   m_s1mme = enb_listen();
   if (m_s1mme == ISRRAN_ERROR) {
@@ -108,6 +123,13 @@ void s1ap::stop()
   if (m_s1mme != -1) {
     close(m_s1mme);
   }
+
+  // Finish the pending UE procedures before deleting the contexts
+  for (std::unique_ptr<isrran::task_worker>& worker : m_ue_workers) {
+    worker->stop();
+  }
+  m_ue_workers.clear();
+
   std::map<uint16_t, enb_ctx_t*>::iterator enb_it = m_active_enbs.begin();
   while (enb_it != m_active_enbs.end()) {
     m_logger.info("Deleting eNB context. eNB Id: 0x%x", enb_it->second->enb_id);
@@ -123,6 +145,7 @@ void s1ap::stop()
     delete ue_it->second;
     m_imsi_to_nas_ctx.erase(ue_it++);
   }
+  m_imsi_to_ue_worker.clear();
 
   // Cleanup message handlers
   s1ap_mngmt_proc::cleanup();
@@ -143,7 +166,10 @@ int s1ap::get_s1_mme()
 
 uint32_t s1ap::get_next_mme_ue_s1ap_id()
 {
-  return m_next_mme_ue_s1ap_id++;
+  uint32_t& next_id = m_next_mme_ue_s1ap_id[current_ue_worker];
+  uint32_t  id      = next_id;
+  next_id += m_next_mme_ue_s1ap_id.size();
+  return id;
 }
 
 int s1ap::enb_listen()
@@ -223,6 +249,7 @@ bool s1ap::s1ap_tx_pdu(const asn1::s1ap::s1ap_pdu_c& pdu, struct sctp_sndrcvinfo
   }
 
   if (m_pcap_enable) {
+    std::lock_guard<std::mutex> lock(m_pcap_mutex);
     m_pcap.write_s1ap(buf->msg, buf->N_bytes);
   }
 
@@ -233,33 +260,141 @@ void s1ap::handle_s1ap_rx_pdu(isrran::byte_buffer_t* pdu, struct sctp_sndrcvinfo
 {
   // Save PCAP
   if (m_pcap_enable) {
+    std::lock_guard<std::mutex> lock(m_pcap_mutex);
     m_pcap.write_s1ap(pdu->msg, pdu->N_bytes);
   }
 
-  // Get PDU type
-  s1ap_pdu_t     rx_pdu;
+  // Get PDU type. The members of the decoded message are allocated from the arena, which is released after the message
+  std::unique_ptr<rx_msg_t> rx_msg(new rx_msg_t);
+  rx_msg->enb_sri = *enb_sri;
   asn1::cbit_ref bref(pdu->msg, pdu->N_bytes);
-  if (rx_pdu.unpack(bref) != asn1::ISRASN_SUCCESS) {
+  if (asn1::unpack_in_arena(rx_msg->pdu, bref, rx_msg->msg_arena) != asn1::ISRASN_SUCCESS) {
     m_logger.error("Failed to unpack received PDU");
     return;
   }
 
-  switch (rx_pdu.type().value) {
+  // UE-associated messages are handled in the worker of the UE, the rest in the calling thread
+  uint32_t ue_id;
+  if (m_ue_workers.empty() or not get_rx_msg_ue_id(*rx_msg, &ue_id)) {
+    handle_rx_msg(*rx_msg);
+    return;
+  }
+  push_ue_task(ue_id, [this, msg = std::move(rx_msg)]() { handle_rx_msg(*msg); });
+}
+
+void s1ap::handle_rx_msg(rx_msg_t& msg)
+{
+  switch (msg.pdu.type().value) {
     case s1ap_pdu_t::types_opts::init_msg:
       m_logger.info("Received Initiating PDU");
-      handle_initiating_message(rx_pdu.init_msg(), enb_sri);
+      handle_initiating_message(msg.pdu.init_msg(), &msg.enb_sri);
       break;
     case s1ap_pdu_t::types_opts::successful_outcome:
       m_logger.info("Received Succeseful Outcome PDU");
-      handle_successful_outcome(rx_pdu.successful_outcome());
+      handle_successful_outcome(msg.pdu.successful_outcome());
       break;
     case s1ap_pdu_t::types_opts::unsuccessful_outcome:
       m_logger.info("Received Unsucceseful Outcome PDU");
       // TODO handle_unsuccessfuloutcome(&rx_pdu.choice.unsuccessfulOutcome);
       break;
     default:
-      m_logger.warning("Unhandled PDU type %d", rx_pdu.type().value);
+      m_logger.warning("Unhandled PDU type %d", msg.pdu.type().value);
+  }
+}
+
+/*
+ * Gets the ID that selects the UE worker of UE-associated messages. The Initial UE Message goes to the worker of the
+ * UE context if there is one, and is otherwise identified by the eNB association and eNB-UE-S1AP-ID. The later
+ * messages are identified by the MME-UE-S1AP-ID that was allocated while handling it.
+ */
+bool s1ap::get_rx_msg_ue_id(const rx_msg_t& msg, uint32_t* ue_id)
+{
+  using init_msg_type_opts_t           = asn1::s1ap::s1ap_elem_procs_o::init_msg_c::types_opts;
+  using successful_outcome_type_opts_t = asn1::s1ap::s1ap_elem_procs_o::successful_outcome_c::types_opts;
+
+  if (msg.pdu.type().value == s1ap_pdu_t::types_opts::init_msg) {
+    const asn1::s1ap::init_msg_s& init_msg = msg.pdu.init_msg();
+    switch (init_msg.value.type().value) {
+      case init_msg_type_opts_t::init_ue_msg:
+        if (not find_init_ue_msg_worker(init_msg.value.init_ue_msg(), ue_id)) {
+          *ue_id = (uint32_t)msg.enb_sri.sinfo_assoc_id + init_msg.value.init_ue_msg()->enb_ue_s1ap_id.value.value;
+        }
+        return true;
+      case init_msg_type_opts_t::ul_nas_transport:
+        *ue_id = init_msg.value.ul_nas_transport()->mme_ue_s1ap_id.value.value;
+        return true;
+      case init_msg_type_opts_t::ue_context_release_request:
+        *ue_id = init_msg.value.ue_context_release_request()->mme_ue_s1ap_id.value.value;
+        return true;
+      default:
+        return false;
+    }
+  }
+  if (msg.pdu.type().value == s1ap_pdu_t::types_opts::successful_outcome) {
+    const asn1::s1ap::successful_outcome_s& outcome = msg.pdu.successful_outcome();
+    switch (outcome.value.type().value) {
+      case successful_outcome_type_opts_t::init_context_setup_resp:
+        *ue_id = outcome.value.init_context_setup_resp()->mme_ue_s1ap_id.value.value;
+        return true;
+      case successful_outcome_type_opts_t::ue_context_release_complete:
+        *ue_id = outcome.value.ue_context_release_complete()->mme_ue_s1ap_id.value.value;
+        return true;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+/*
+ * Gets the worker that owns the context of the UE sending an Initial UE Message, so that the NAS context is never used
+ * by two workers. The UE is identified by the IMSI or GUTI of an Attach Request, or else by the S-TMSI.
+ */
+bool s1ap::find_init_ue_msg_worker(const asn1::s1ap::init_ue_msg_s& init_ue, uint32_t* ue_worker)
+{
+  uint64_t imsi       = 0;
+  uint32_t m_tmsi     = 0;
+  bool     has_m_tmsi = false;
+
+  isrran::unique_byte_buffer_t nas_msg = isrran::make_byte_buffer();
+  if (nas_msg == nullptr) {
+    return false;
+  }
+  memcpy(nas_msg->msg, init_ue->nas_pdu.value.data(), init_ue->nas_pdu.value.size());
+  nas_msg->N_bytes = init_ue->nas_pdu.value.size();
+  uint8_t pd, msg_type;
+  liblte_mme_parse_msg_header((LIBLTE_BYTE_MSG_STRUCT*)nas_msg.get(), &pd, &msg_type);
+
+  LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT attach_req = {};
+  if (msg_type == LIBLTE_MME_MSG_TYPE_ATTACH_REQUEST and
+      liblte_mme_unpack_attach_request_msg((LIBLTE_BYTE_MSG_STRUCT*)nas_msg.get(), &attach_req) == LIBLTE_SUCCESS) {
+    if (attach_req.eps_mobile_id.type_of_id == LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI) {
+      for (int i = 0; i <= 14; i++) {
+        imsi += attach_req.eps_mobile_id.imsi[i] * std::pow(10, 14 - i);
+      }
+    } else if (attach_req.eps_mobile_id.type_of_id == LIBLTE_MME_EPS_MOBILE_ID_TYPE_GUTI) {
+      m_tmsi     = attach_req.eps_mobile_id.guti.m_tmsi;
+      has_m_tmsi = true;
+    }
+  } else if (init_ue->s_tmsi_present) {
+    isrran::uint8_to_uint32(init_ue->s_tmsi.value.m_tmsi.data(), &m_tmsi);
+    has_m_tmsi = true;
+  }
+
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  if (has_m_tmsi) {
+    std::map<uint32_t, uint64_t>::iterator it = m_tmsi_to_imsi.find(m_tmsi);
+    if (it == m_tmsi_to_imsi.end()) {
+      return false;
+    }
+    imsi = it->second;
   }
+  std::map<uint64_t, uint32_t>::iterator it = m_imsi_to_ue_worker.find(imsi);
+  if (it == m_imsi_to_ue_worker.end()) {
+    return false;
+  }
+  *ue_worker = it->second;
+  return true;
 }
 
 void s1ap::handle_initiating_message(const asn1::s1ap::init_msg_s& msg, struct sctp_sndrcvinfo* enb_sri)
@@ -314,9 +449,10 @@ void s1ap::handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg
 void s1ap::add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinfo* enb_sri)
 {
   m_logger.info("Adding new eNB context. eNB ID %d", enb_ctx.enb_id);
-  std::set<uint32_t> ue_set;
-  enb_ctx_t*         enb_ptr = new enb_ctx_t;
-  *enb_ptr                   = enb_ctx;
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  std::set<uint32_t>          ue_set;
+  enb_ctx_t*                  enb_ptr = new enb_ctx_t;
+  *enb_ptr                            = enb_ctx;
   m_active_enbs.insert(std::pair<uint16_t, enb_ctx_t*>(enb_ptr->enb_id, enb_ptr));
   m_sctp_to_enb_id.insert(std::pair<int32_t, uint16_t>(enb_sri->sinfo_assoc_id, enb_ptr->enb_id));
   m_enb_assoc_to_ue_ids.insert(std::pair<int32_t, std::set<uint32_t> >(enb_sri->sinfo_assoc_id, ue_set));
@@ -324,6 +460,7 @@ void s1ap::add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinf
 
 enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
 {
+  std::lock_guard<std::mutex>              lock(m_ctx_mutex);
   std::map<uint16_t, enb_ctx_t*>::iterator it = m_active_enbs.find(enb_id);
   if (it == m_active_enbs.end()) {
     return nullptr;
@@ -334,13 +471,15 @@ enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
 
 void s1ap::delete_enb_ctx(int32_t assoc_id)
 {
-  std::map<int32_t, uint16_t>::iterator it_assoc = m_sctp_to_enb_id.find(assoc_id);
-  uint16_t                              enb_id   = it_assoc->second;
-
-  std::map<uint16_t, enb_ctx_t*>::iterator it_ctx = m_active_enbs.find(enb_id);
-  if (it_ctx == m_active_enbs.end() || it_assoc == m_sctp_to_enb_id.end()) {
-    m_logger.error("Could not find eNB to delete. Association: %d", assoc_id);
-    return;
+  uint16_t enb_id;
+  {
+    std::lock_guard<std::mutex>           lock(m_ctx_mutex);
+    std::map<int32_t, uint16_t>::iterator it_assoc = m_sctp_to_enb_id.find(assoc_id);
+    if (it_assoc == m_sctp_to_enb_id.end() || m_active_enbs.count(it_assoc->second) == 0) {
+      m_logger.error("Could not find eNB to delete. Association: %d", assoc_id);
+      return;
+    }
+    enb_id = it_assoc->second;
   }
 
   m_logger.info("Deleting eNB context. eNB Id: 0x%x", enb_id);
@@ -350,15 +489,28 @@ void s1ap::delete_enb_ctx(int32_t assoc_id)
   release_ues_ecm_ctx_in_enb(assoc_id);
 
   // Delete eNB
+  std::lock_guard<std::mutex>              lock(m_ctx_mutex);
+  std::map<uint16_t, enb_ctx_t*>::iterator it_ctx = m_active_enbs.find(enb_id);
   delete it_ctx->second;
   m_active_enbs.erase(it_ctx);
-  m_sctp_to_enb_id.erase(it_assoc);
+  m_sctp_to_enb_id.erase(assoc_id);
   return;
 }
 
+std::map<uint16_t, struct sctp_sndrcvinfo> s1ap::get_enb_sris()
+{
+  std::lock_guard<std::mutex>                lock(m_ctx_mutex);
+  std::map<uint16_t, struct sctp_sndrcvinfo> enb_sris;
+  for (const std::pair<const uint16_t, enb_ctx_t*>& enb : m_active_enbs) {
+    enb_sris.emplace(enb.first, enb.second->sri);
+  }
+  return enb_sris;
+}
+
 // UE Context Management
 bool s1ap::add_nas_ctx_to_imsi_map(nas* nas_ctx)
 {
+  std::lock_guard<std::mutex>        lock(m_ctx_mutex);
   std::map<uint64_t, nas*>::iterator ctx_it = m_imsi_to_nas_ctx.find(nas_ctx->m_emm_ctx.imsi);
   if (ctx_it != m_imsi_to_nas_ctx.end()) {
     m_logger.error("UE Context already exists. IMSI %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
@@ -372,12 +524,14 @@ bool s1ap::add_nas_ctx_to_imsi_map(nas* nas_ctx)
     }
   }
   m_imsi_to_nas_ctx.insert(std::pair<uint64_t, nas*>(nas_ctx->m_emm_ctx.imsi, nas_ctx));
+  m_imsi_to_ue_worker[nas_ctx->m_emm_ctx.imsi] = current_ue_worker;
   m_logger.debug("Saved UE context corresponding to IMSI %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
   return true;
 }
 
 bool s1ap::add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx)
 {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   if (nas_ctx->m_ecm_ctx.mme_ue_s1ap_id == 0) {
     m_logger.error("Could not add UE context to MME UE S1AP map. MME UE S1AP ID 0 is not valid.");
     return false;
@@ -401,6 +555,7 @@ bool s1ap::add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx)
 
 bool s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 {
+  std::lock_guard<std::mutex>                      lock(m_ctx_mutex);
   std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
   if (ues_in_enb == m_enb_assoc_to_ue_ids.end()) {
     m_logger.error("Could not find eNB from eNB SCTP association %d", enb_assoc);
@@ -418,6 +573,7 @@ bool s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 
 nas* s1ap::find_nas_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 {
+  std::lock_guard<std::mutex>        lock(m_ctx_mutex);
   std::map<uint32_t, nas*>::iterator it = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
   if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
     return NULL;
@@ -428,6 +584,7 @@ nas* s1ap::find_nas_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 
 nas* s1ap::find_nas_ctx_from_imsi(uint64_t imsi)
 {
+  std::lock_guard<std::mutex>        lock(m_ctx_mutex);
   std::map<uint64_t, nas*>::iterator it = m_imsi_to_nas_ctx.find(imsi);
   if (it == m_imsi_to_nas_ctx.end()) {
     return NULL;
@@ -439,29 +596,45 @@ nas* s1ap::find_nas_ctx_from_imsi(uint64_t imsi)
 void s1ap::release_ues_ecm_ctx_in_enb(int32_t enb_assoc)
 {
   isrran::console("Releasing UEs context\n");
-  std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
-  std::set<uint32_t>::iterator                     ue_id      = ues_in_enb->second.begin();
-  if (ue_id == ues_in_enb->second.end()) {
-    isrran::console("No UEs to be released\n");
-  } else {
-    while (ue_id != ues_in_enb->second.end()) {
-      std::map<uint32_t, nas*>::iterator nas_ctx = m_mme_ue_s1ap_id_to_nas_ctx.find(*ue_id);
-      emm_ctx_t*                         emm_ctx = &nas_ctx->second->m_emm_ctx;
-      ecm_ctx_t*                         ecm_ctx = &nas_ctx->second->m_ecm_ctx;
-
-      m_logger.info(
-          "Releasing UE context. IMSI: %015" PRIu64 ", UE-MME S1AP Id: %d", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
-      if (emm_ctx->state == EMM_STATE_REGISTERED) {
-        m_mme_gtpc->send_delete_session_request(emm_ctx->imsi);
-        emm_ctx->state = EMM_STATE_DEREGISTERED;
-      }
-      isrran::console("Releasing UE ECM context. UE-MME S1AP Id: %d\n", ecm_ctx->mme_ue_s1ap_id);
-      ecm_ctx->state          = ECM_STATE_IDLE;
-      ecm_ctx->mme_ue_s1ap_id = 0;
-      ecm_ctx->enb_ue_s1ap_id = 0;
-      ues_in_enb->second.erase(ue_id++);
+  std::set<uint32_t> ue_ids;
+  {
+    std::lock_guard<std::mutex>                      lock(m_ctx_mutex);
+    std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
+    if (ues_in_enb != m_enb_assoc_to_ue_ids.end()) {
+      ue_ids.swap(ues_in_enb->second);
     }
   }
+  if (ue_ids.empty()) {
+    isrran::console("No UEs to be released\n");
+    return;
+  }
+
+  // Each UE is released by its worker, in order with its pending procedures
+  for (uint32_t mme_ue_s1ap_id : ue_ids) {
+    push_ue_task(mme_ue_s1ap_id, [this, mme_ue_s1ap_id]() { release_enb_ue_ecm_ctx(mme_ue_s1ap_id); });
+  }
+}
+
+void s1ap::release_enb_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
+{
+  nas* nas_ctx = find_nas_ctx_from_mme_ue_s1ap_id(mme_ue_s1ap_id);
+  if (nas_ctx == NULL) {
+    m_logger.error("Cannot release UE ECM context, UE not found. MME-UE S1AP Id: %d", mme_ue_s1ap_id);
+    return;
+  }
+  emm_ctx_t* emm_ctx = &nas_ctx->m_emm_ctx;
+  ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
+
+  m_logger.info(
+      "Releasing UE context. IMSI: %015" PRIu64 ", UE-MME S1AP Id: %d", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
+  if (emm_ctx->state == EMM_STATE_REGISTERED) {
+    m_mme_gtpc->send_delete_session_request(emm_ctx->imsi);
+    emm_ctx->state = EMM_STATE_DEREGISTERED;
+  }
+  isrran::console("Releasing UE ECM context. UE-MME S1AP Id: %d\n", ecm_ctx->mme_ue_s1ap_id);
+  ecm_ctx->state          = ECM_STATE_IDLE;
+  ecm_ctx->mme_ue_s1ap_id = 0;
+  ecm_ctx->enb_ue_s1ap_id = 0;
 }
 
 bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
@@ -474,6 +647,7 @@ bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
   ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
 
   // Delete UE within eNB UE set
+  std::lock_guard<std::mutex>           lock(m_ctx_mutex);
   std::map<int32_t, uint16_t>::iterator it = m_sctp_to_enb_id.find(ecm_ctx->enb_sri.sinfo_assoc_id);
   if (it == m_sctp_to_enb_id.end()) {
     m_logger.error("Could not find eNB for UE release request.");
@@ -499,42 +673,63 @@ bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
 
 bool s1ap::delete_ue_ctx(uint64_t imsi)
 {
-  nas* nas_ctx = find_nas_ctx_from_imsi(imsi);
+  // The IMSI is unmapped right away, so that a new context can take it
+  nas*     nas_ctx   = nullptr;
+  uint32_t ue_worker = current_ue_worker;
+  {
+    std::lock_guard<std::mutex>        lock(m_ctx_mutex);
+    std::map<uint64_t, nas*>::iterator it = m_imsi_to_nas_ctx.find(imsi);
+    if (it != m_imsi_to_nas_ctx.end()) {
+      nas_ctx = it->second;
+      m_imsi_to_nas_ctx.erase(it);
+    }
+    std::map<uint64_t, uint32_t>::iterator worker_it = m_imsi_to_ue_worker.find(imsi);
+    if (worker_it != m_imsi_to_ue_worker.end()) {
+      ue_worker = worker_it->second;
+      m_imsi_to_ue_worker.erase(worker_it);
+    }
+  }
   if (nas_ctx == NULL) {
     m_logger.info("Cannot delete UE context, UE not found. IMSI: %" PRIu64 "", imsi);
     return false;
   }
 
+  // The context is deleted by the worker that owns it, in order with its pending procedures
+  if (ue_worker != current_ue_worker) {
+    push_ue_task(ue_worker, [this, nas_ctx]() { delete_nas_ctx(nas_ctx); });
+  } else {
+    delete_nas_ctx(nas_ctx);
+  }
+  return true;
+}
+
+void s1ap::delete_nas_ctx(nas* nas_ctx)
+{
   // Make sure to release ECM ctx
   if (nas_ctx->m_ecm_ctx.mme_ue_s1ap_id != 0) {
     release_ue_ecm_ctx(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
   }
-
-  // Delete UE context
-  m_imsi_to_nas_ctx.erase(imsi);
   delete nas_ctx;
   m_logger.info("Deleted UE Context.");
-  return true;
 }
 
 // UE Bearer Managment
 void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 {
-  std::map<uint64_t, nas*>::iterator ue_ctx_it = m_imsi_to_nas_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_nas_ctx.end()) {
+  nas* nas_ctx = find_nas_ctx_from_imsi(imsi);
+  if (nas_ctx == NULL) {
     m_logger.error("Could not activate EPS bearer: Could not find UE context");
     return;
   }
   // Make sure NAS is active
-  uint32_t                           mme_ue_s1ap_id = ue_ctx_it->second->m_ecm_ctx.mme_ue_s1ap_id;
-  std::map<uint32_t, nas*>::iterator it             = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
-  if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
+  uint32_t mme_ue_s1ap_id = nas_ctx->m_ecm_ctx.mme_ue_s1ap_id;
+  if (find_nas_ctx_from_mme_ue_s1ap_id(mme_ue_s1ap_id) == NULL) {
     m_logger.error("Could not activate EPS bearer: ECM context seems to be missing");
     return;
   }
 
-  ecm_ctx_t* ecm_ctx = &ue_ctx_it->second->m_ecm_ctx;
-  esm_ctx_t* esm_ctx = &ue_ctx_it->second->m_esm_ctx[ebi];
+  ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
+  esm_ctx_t* esm_ctx = &nas_ctx->m_esm_ctx[ebi];
   if (esm_ctx->state != ERAB_CTX_SETUP) {
     m_logger.error(
         "Could not be activate EPS Bearer, bearer in wrong state: MME S1AP Id %d, EPS Bearer id %d, state %d",
@@ -557,8 +752,9 @@ void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 
 uint32_t s1ap::allocate_m_tmsi(uint64_t imsi)
 {
-  uint32_t m_tmsi = m_next_m_tmsi;
-  m_next_m_tmsi   = (m_next_m_tmsi + 1) % UINT32_MAX;
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  uint32_t                    m_tmsi = m_next_m_tmsi;
+  m_next_m_tmsi                      = (m_next_m_tmsi + 1) % UINT32_MAX;
 
   m_tmsi_to_imsi.insert(std::pair<uint32_t, uint64_t>(m_tmsi, imsi));
   m_logger.debug("Allocated M-TMSI 0x%x to IMSI %015" PRIu64 ",", m_tmsi, imsi);
@@ -567,6 +763,7 @@ uint32_t s1ap::allocate_m_tmsi(uint64_t imsi)
 
 uint64_t s1ap::find_imsi_from_m_tmsi(uint32_t m_tmsi)
 {
+  std::lock_guard<std::mutex>            lock(m_ctx_mutex);
   std::map<uint32_t, uint64_t>::iterator it = m_tmsi_to_imsi.find(m_tmsi);
   if (it != m_tmsi_to_imsi.end()) {
     m_logger.debug("Found IMSI %015" PRIu64 " from M-TMSI 0x%x", it->second, m_tmsi);
@@ -675,4 +872,21 @@ bool s1ap::expire_nas_timer(enum nas_timer_type type, uint64_t imsi)
   return err;
 }
 
+/*
+ * UE workers
+ */
+uint32_t s1ap::get_current_ue_worker() const
+{
+  return current_ue_worker;
+}
+
+void s1ap::push_ue_task(uint32_t ue_id, ue_task_t&& task)
+{
+  if (m_ue_workers.empty()) {
+    task();
+    return;
+  }
+  m_ue_workers[ue_id % m_ue_workers.size()]->push_task(std::move(task));
+}
+
 } // namespace isrepc
@@ -85,11 +85,10 @@ bool s1ap_paging::send_paging(uint64_t imsi, uint16_t erab_to_setup)
     return false;
   }
 
-  for (std::map<uint16_t, enb_ctx_t*>::iterator it = m_s1ap->m_active_enbs.begin(); it != m_s1ap->m_active_enbs.end();
-       it++) {
-    enb_ctx_t* enb_ctx = it->second;
-    if (!m_s1ap->s1ap_tx_pdu(tx_pdu, &enb_ctx->sri)) {
-      m_logger.error("Error paging to eNB. eNB Id: 0x%x.", enb_ctx->enb_id);
+  std::map<uint16_t, struct sctp_sndrcvinfo> enb_sris = m_s1ap->get_enb_sris();
+  for (std::map<uint16_t, struct sctp_sndrcvinfo>::iterator it = enb_sris.begin(); it != enb_sris.end(); it++) {
+    if (!m_s1ap->s1ap_tx_pdu(tx_pdu, &it->second)) {
+      m_logger.error("Error paging to eNB. eNB Id: 0x%x.", it->first);
       return false;
     }
   }
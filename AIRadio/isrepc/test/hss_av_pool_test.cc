@@ -0,0 +1,245 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrepc/hdr/hss/hss.h"
+#include "isrran/common/bcd_helpers.h"
+#include "isrran/common/security.h"
+#include "isrran/common/test_common.h"
+#include <chrono>
+#include <inttypes.h>
+#include <map>
+#include <thread>
+#include <unistd.h>
+
+using namespace isrepc;
+
+static const uint32_t pool_size  = 8;
+static const uint64_t imsi       = 1010000000001;
+static uint8_t        ue_key[16] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+static uint8_t        ue_opc[16] = {0x63, 0xbf, 0xa5, 0x0e, 0xe6, 0x52, 0x33, 0x65,
+                                    0xff, 0x14, 0xc1, 0xf4, 0x5f, 0x88, 0x73, 0x7d};
+
+/// Checks that the SQNs handed out to the UE are unique and increasing within each IND
+class sqn_checker
+{
+public:
+  int check(uint64_t sqn)
+  {
+    uint64_t seq = sqn >> LTE_FDD_ENB_IND_HE_N_BITS;
+    uint64_t ind = sqn & LTE_FDD_ENB_IND_HE_MASK;
+    auto     it  = last_seq.find(ind);
+    TESTASSERT(it == last_seq.end() or seq > it->second);
+    last_seq[ind] = seq;
+    return ISRRAN_SUCCESS;
+  }
+
+private:
+  std::map<uint64_t, uint64_t> last_seq;
+};
+
+struct auth_vector_t {
+  uint8_t  k_asme[32];
+  uint8_t  autn[16];
+  uint8_t  rand[16];
+  uint8_t  xres[16];
+  uint64_t sqn;
+};
+
+static bool write_user_db(const std::string& filename)
+{
+  FILE* f = fopen(filename.c_str(), "w");
+  if (f == nullptr) {
+    return false;
+  }
+  fprintf(f, "ue1,mil,%015" PRIu64 ",", imsi);
+  for (uint8_t b : ue_key) {
+    fprintf(f, "%02x", b);
+  }
+  fprintf(f, ",opc,");
+  for (uint8_t b : ue_opc) {
+    fprintf(f, "%02x", b);
+  }
+  fprintf(f, ",8000,000000001234,9,dynamic\n");
+  fclose(f);
+  return true;
+}
+
+static hss* init_hss(const char* db_file, uint32_t av_pool_size)
+{
+  hss_args_t args   = {};
+  args.db_file      = db_file;
+  args.av_pool_size = av_pool_size;
+  isrran::string_to_mcc("001", &args.mcc);
+  isrran::string_to_mnc("01", &args.mnc);
+  hss* h = hss::get_instance();
+  return h->init(&args) == 0 ? h : nullptr;
+}
+
+static hss_metrics_t get_metrics(hss* h)
+{
+  hss_metrics_t metrics = {};
+  h->get_metrics(metrics);
+  return metrics;
+}
+
+/// Waits for the background generator to fill the pool of the UE
+static int wait_pool_full(hss* h)
+{
+  for (uint32_t i = 0; i < 10000 and get_metrics(h).av_pooled < pool_size; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  TESTASSERT_EQ(pool_size, get_metrics(h).av_pooled);
+  return ISRRAN_SUCCESS;
+}
+
+/// Gets an AV and the SQN that it carries, recovered from the AUTN with the anonymity key
+static int get_auth_vector(hss* h, auth_vector_t& av)
+{
+  TESTASSERT(h->gen_auth_info_answer(imsi, av.k_asme, av.autn, av.rand, av.xres));
+
+  uint8_t res[16], ck[16], ik[16], ak[6];
+  isrran::security_milenage_f2345(ue_key, ue_opc, av.rand, res, ck, ik, ak);
+  TESTASSERT(memcmp(res, av.xres, 8) == 0);
+  av.sqn = 0;
+  for (int i = 0; i < 6; i++) {
+    av.sqn |= (uint64_t)(av.autn[i] ^ ak[i]) << (5 - i) * 8;
+  }
+  return ISRRAN_SUCCESS;
+}
+
+/// Re-synchronizes the SQN of the UE to sqn_ms, as reported in the AUTS of an Authentication Failure to the AV
+static int resync_sqn(hss* h, const auth_vector_t& av, uint64_t sqn_ms)
+{
+  uint8_t auts[14] = {};
+  uint8_t ak[6];
+  uint8_t rand[16];
+  memcpy(rand, av.rand, sizeof(rand));
+  isrran::security_milenage_f5_star(ue_key, ue_opc, rand, ak);
+  for (int i = 0; i < 6; i++) {
+    auts[i] = ((sqn_ms >> (5 - i) * 8) & 0xFF) ^ ak[i];
+  }
+  TESTASSERT(h->resync_sqn(imsi, auts));
+  return ISRRAN_SUCCESS;
+}
+
+int test_av_pool_hits(hss* h, sqn_checker& checker)
+{
+  // The pool is warmed up at init
+  TESTASSERT(wait_pool_full(h) == ISRRAN_SUCCESS);
+  TESTASSERT_EQ(pool_size, get_metrics(h).av_generated);
+
+  // Each AV is served from the pool, which is refilled in the background
+  for (uint32_t i = 0; i < 2 * pool_size; ++i) {
+    auth_vector_t av;
+    TESTASSERT(get_auth_vector(h, av) == ISRRAN_SUCCESS);
+    TESTASSERT(checker.check(av.sqn) == ISRRAN_SUCCESS);
+    TESTASSERT(wait_pool_full(h) == ISRRAN_SUCCESS);
+  }
+
+  hss_metrics_t metrics = get_metrics(h);
+  TESTASSERT_EQ(2 * pool_size, metrics.av_pool_hits);
+  TESTASSERT_EQ(0, metrics.av_pool_misses);
+  TESTASSERT_EQ(3 * pool_size, metrics.av_generated);
+  TESTASSERT_EQ(0, metrics.av_discarded);
+  return ISRRAN_SUCCESS;
+}
+
+int test_av_pool_resync(hss* h, sqn_checker& checker)
+{
+  uint64_t last_seq = 0;
+  for (uint32_t n = 0; n < 20; ++n) {
+    hss_metrics_t before = get_metrics(h);
+
+    // The AV taken from the pool triggers a refill, which may be in progress when the SQN is re-synchronized
+    auth_vector_t av;
+    TESTASSERT(get_auth_vector(h, av) == ISRRAN_SUCCESS);
+    TESTASSERT(checker.check(av.sqn) == ISRRAN_SUCCESS);
+    uint64_t seq_ms = (av.sqn >> LTE_FDD_ENB_IND_HE_N_BITS) + 1000;
+    TESTASSERT(resync_sqn(h, av, seq_ms << LTE_FDD_ENB_IND_HE_N_BITS) == ISRRAN_SUCCESS);
+    TESTASSERT(wait_pool_full(h) == ISRRAN_SUCCESS);
+
+    // None of the AVs computed with the old SQN is handed out
+    for (uint32_t i = 0; i < pool_size; ++i) {
+      TESTASSERT(get_auth_vector(h, av) == ISRRAN_SUCCESS);
+      TESTASSERT(checker.check(av.sqn) == ISRRAN_SUCCESS);
+      TESTASSERT((av.sqn >> LTE_FDD_ENB_IND_HE_N_BITS) > seq_ms);
+      TESTASSERT((av.sqn >> LTE_FDD_ENB_IND_HE_N_BITS) > last_seq);
+      last_seq = av.sqn >> LTE_FDD_ENB_IND_HE_N_BITS;
+      TESTASSERT(wait_pool_full(h) == ISRRAN_SUCCESS);
+    }
+
+    // The pooled AVs are discarded, and so is the refilled one unless it was computed after the re-synchronization
+    hss_metrics_t after = get_metrics(h);
+    TESTASSERT_EQ(before.av_pool_hits + 1 + pool_size, after.av_pool_hits);
+    TESTASSERT_EQ(before.av_pool_misses, after.av_pool_misses);
+    uint64_t nof_discarded = after.av_discarded - before.av_discarded;
+    TESTASSERT(nof_discarded == pool_size - 1 or nof_discarded == pool_size);
+  }
+  return ISRRAN_SUCCESS;
+}
+
+int test_av_on_demand(hss* h, sqn_checker& checker)
+{
+  const uint32_t nof_avs = 2 * pool_size;
+  for (uint32_t i = 0; i < nof_avs; ++i) {
+    auth_vector_t av;
+    TESTASSERT(get_auth_vector(h, av) == ISRRAN_SUCCESS);
+    TESTASSERT(checker.check(av.sqn) == ISRRAN_SUCCESS);
+  }
+
+  hss_metrics_t metrics = get_metrics(h);
+  TESTASSERT_EQ(0, metrics.av_pool_hits);
+  TESTASSERT_EQ(nof_avs, metrics.av_pool_misses);
+  TESTASSERT_EQ(0, metrics.av_generated);
+  TESTASSERT_EQ(0, metrics.av_pooled);
+  return ISRRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  isrlog::init();
+
+  char db_file[] = "/tmp/hss_av_pool_test_XXXXXX";
+  int  db_fd     = mkstemp(db_file);
+  TESTASSERT(db_fd != -1 and write_user_db(db_file));
+  close(db_fd);
+
+  // The SQN stored in the DB file on stop carries on where the first HSS left
+  sqn_checker checker;
+  hss*        h = init_hss(db_file, pool_size);
+  TESTASSERT(h != nullptr);
+  TESTASSERT(test_av_pool_hits(h, checker) == ISRRAN_SUCCESS);
+  TESTASSERT(test_av_pool_resync(h, checker) == ISRRAN_SUCCESS);
+  h->stop();
+  hss::cleanup();
+
+  h = init_hss(db_file, 0);
+  TESTASSERT(h != nullptr);
+  TESTASSERT(test_av_on_demand(h, checker) == ISRRAN_SUCCESS);
+  h->stop();
+  hss::cleanup();
+
+  unlink(db_file);
+  isrlog::flush();
+  printf("Success\n");
+  return ISRRAN_SUCCESS;
+}
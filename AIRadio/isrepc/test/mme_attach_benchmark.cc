@@ -0,0 +1,644 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * MME attach benchmark. The HSS and the MME run as in isrepc, with the given number of UE workers, while a dummy
+ * SP-GW answers the S11 requests. A number of simulated eNBs connect through SCTP and attach their UEs with the IMSI,
+ * keeping a window of attaches in progress each. The UEs run the milenage authentication and the NAS security mode
+ * procedure, and an attach is complete when the EMM Information is received.
+ */
+
+#include "isrepc/hdr/hss/hss.h"
+#include "isrepc/hdr/mme/mme.h"
+#include "isrran/asn1/gtpc.h"
+#include "isrran/asn1/liblte_mme.h"
+#include "isrran/asn1/s1ap.h"
+#include "isrran/common/bcd_helpers.h"
+#include "isrran/common/network_utils.h"
+#include "isrran/common/security.h"
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <getopt.h>
+#include <thread>
+
+using namespace isrepc;
+
+static uint32_t nof_ues      = 1000;
+static uint32_t nof_enbs     = 4;
+static uint32_t nof_workers  = 4;
+static uint32_t window_size  = 32;
+static uint32_t av_pool_size = 0;
+
+static const char*    mme_bind_addr = "127.0.1.100";
+static const int      s1ap_ppid     = 18;
+static const uint64_t first_imsi    = 1010000000001;
+static uint8_t        ue_key[16]    = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                       0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+static uint8_t        ue_opc[16]    = {0x63, 0xbf, 0xa5, 0x0e, 0xe6, 0x52, 0x33, 0x65,
+                                       0xff, 0x14, 0xc1, 0xf4, 0x5f, 0x88, 0x73, 0x7d};
+static uint16_t       mcc, mnc;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [uewcp]\n", prog);
+  printf("\t-u Number of UEs [Default %d]\n", nof_ues);
+  printf("\t-e Number of simulated eNBs [Default %d]\n", nof_enbs);
+  printf("\t-w Number of MME UE workers, 0 to run the UEs in the MME thread [Default %d]\n", nof_workers);
+  printf("\t-c Number of attaches in progress per eNB [Default %d]\n", window_size);
+  printf("\t-p Number of authentication vectors precomputed per UE by the HSS [Default %d]\n", av_pool_size);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "uewcp")) != -1) {
+    switch (opt) {
+      case 'u':
+        nof_ues = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'e':
+        nof_enbs = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'w':
+        nof_workers = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'c':
+        window_size = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'p':
+        av_pool_size = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+/// Writes the HSS database with one milenage subscriber per simulated UE
+static bool write_user_db(const std::string& filename)
+{
+  FILE* f = fopen(filename.c_str(), "w");
+  if (f == nullptr) {
+    return false;
+  }
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    fprintf(f, "ue%d,mil,%015" PRIu64 ",", i, first_imsi + i);
+    for (uint8_t b : ue_key) {
+      fprintf(f, "%02x", b);
+    }
+    fprintf(f, ",opc,");
+    for (uint8_t b : ue_opc) {
+      fprintf(f, "%02x", b);
+    }
+    fprintf(f, ",8000,000000001234,9,dynamic\n");
+  }
+  fclose(f);
+  return true;
+}
+
+/// SP-GW that accepts every session on the S11 socket, without any user plane
+class dummy_spgw
+{
+public:
+  bool init()
+  {
+    sockaddr_un spgw_addr = {};
+    spgw_addr.sun_family  = AF_UNIX;
+    snprintf(spgw_addr.sun_path, sizeof(spgw_addr.sun_path), "%s", "@spgw_s11");
+    spgw_addr.sun_path[0] = '\0';
+    mme_addr              = spgw_addr;
+    snprintf(mme_addr.sun_path, sizeof(mme_addr.sun_path), "%s", "@mme_s11");
+    mme_addr.sun_path[0] = '\0';
+
+    s11 = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (s11 < 0 or bind(s11, (const sockaddr*)&spgw_addr, sizeof(spgw_addr)) == -1) {
+      return false;
+    }
+    timeval timeout = {0, 100000};
+    setsockopt(s11, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    thread = std::thread([this]() { run(); });
+    return true;
+  }
+
+  void stop()
+  {
+    running = false;
+    thread.join();
+    close(s11);
+  }
+
+private:
+  void run()
+  {
+    isrran::gtpc_pdu req = {};
+    uint32_t         n   = 0;
+    while (running) {
+      if (recv(s11, &req, sizeof(req), 0) != sizeof(req)) {
+        continue;
+      }
+      isrran::gtpc_pdu resp    = {};
+      resp.header.teid_present = true;
+      if (req.header.type == isrran::GTPC_MSG_TYPE_CREATE_SESSION_REQUEST) {
+        resp.header.teid = req.choice.create_session_request.sender_f_teid.teid;
+        resp.header.type = isrran::GTPC_MSG_TYPE_CREATE_SESSION_RESPONSE;
+
+        isrran::gtpc_create_session_response* cs_resp = &resp.choice.create_session_response;
+        cs_resp->cause.cause_value                    = isrran::GTPC_CAUSE_VALUE_REQUEST_ACCEPTED;
+        cs_resp->paa_present                          = true;
+        cs_resp->paa.pdn_type                         = isrran::GTPC_PDN_TYPE_IPV4;
+        cs_resp->paa.ipv4_present                     = true;
+        cs_resp->paa.ipv4                             = htonl(0xac100002 + n);
+
+        isrran::gtpc_create_session_response::gtpc_bearer_context_created_ie& bearer =
+            cs_resp->eps_bearer_context_created;
+        bearer.ebi                     = 5;
+        bearer.cause.cause_value       = isrran::GTPC_CAUSE_VALUE_REQUEST_ACCEPTED;
+        bearer.s1_u_sgw_f_teid_present = true;
+        bearer.s1_u_sgw_f_teid.teid    = ++n;
+        bearer.s1_u_sgw_f_teid.ipv4    = htonl(INADDR_LOOPBACK);
+      } else if (req.header.type == isrran::GTPC_MSG_TYPE_MODIFY_BEARER_REQUEST) {
+        resp.header.teid = req.header.teid;
+        resp.header.type = isrran::GTPC_MSG_TYPE_MODIFY_BEARER_RESPONSE;
+
+        isrran::gtpc_modify_bearer_response* mb_resp = &resp.choice.modify_bearer_response;
+        mb_resp->cause.cause_value                   = isrran::GTPC_CAUSE_VALUE_REQUEST_ACCEPTED;
+        mb_resp->eps_bearer_context_modified.ebi = req.choice.modify_bearer_request.eps_bearer_context_to_modify.ebi;
+        mb_resp->eps_bearer_context_modified.cause.cause_value = isrran::GTPC_CAUSE_VALUE_REQUEST_ACCEPTED;
+      } else {
+        continue;
+      }
+      sendto(s11, &resp, sizeof(resp), 0, (const sockaddr*)&mme_addr, sizeof(mme_addr));
+    }
+  }
+
+  int               s11 = -1;
+  sockaddr_un       mme_addr;
+  std::atomic<bool> running{true};
+  std::thread       thread;
+};
+
+/// eNB that attaches its UEs through one SCTP association with the MME
+class sim_enb
+{
+public:
+  sim_enb(uint32_t enb_id_, uint32_t first_ue_, uint32_t nof_ues_) :
+    enb_id(enb_id_), first_ue(first_ue_), ues(nof_ues_)
+  {}
+
+  /// Connects to the MME and runs the S1 Setup
+  bool connect()
+  {
+    if (not mme_socket.open_socket(isrran::net_utils::addr_family::ipv4,
+                                   isrran::net_utils::socket_type::seqpacket,
+                                   isrran::net_utils::protocol_type::SCTP) or
+        not mme_socket.connect_to(mme_bind_addr, 36412, &mme_addr)) {
+      return false;
+    }
+    timeval timeout = {5, 0};
+    setsockopt(mme_socket.fd(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    uint32_t plmn;
+    isrran::s1ap_mccmnc_to_plmn(mcc, mnc, &plmn);
+    plmn            = htonl(plmn);
+    uint16_t tac_be = htons(7);
+
+    asn1::s1ap::s1ap_pdu_c pdu;
+    pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_S1_SETUP);
+    asn1::s1ap::s1_setup_request_s& container = pdu.init_msg().value.s1_setup_request();
+    container->global_enb_id.value.plm_nid[0] = ((uint8_t*)&plmn)[1];
+    container->global_enb_id.value.plm_nid[1] = ((uint8_t*)&plmn)[2];
+    container->global_enb_id.value.plm_nid[2] = ((uint8_t*)&plmn)[3];
+    container->global_enb_id.value.enb_id.set_macro_enb_id().from_number(enb_id);
+    container->supported_tas.value.resize(1);
+    memcpy(container->supported_tas.value[0].tac.data(), &tac_be, 2);
+    container->supported_tas.value[0].broadcast_plmns.resize(1);
+    memcpy(container->supported_tas.value[0].broadcast_plmns[0].data(), &((uint8_t*)&plmn)[1], 3);
+    container->default_paging_drx.value.value = asn1::s1ap::paging_drx_opts::v128;
+    if (not send_s1ap(pdu) or not recv_s1ap(pdu)) {
+      return false;
+    }
+    tai.plm_nid.from_number(ntohl(plmn));
+    tai.tac.from_number(7);
+    eutran_cgi.plm_nid.from_number(ntohl(plmn));
+    eutran_cgi.cell_id.from_number(enb_id << 8);
+    return pdu.type().value == asn1::s1ap::s1ap_pdu_c::types_opts::successful_outcome;
+  }
+
+  /// Attaches all the UEs, with at most window_size attaches in progress
+  void run()
+  {
+    for (uint32_t i = 0; i < std::min(window_size, (uint32_t)ues.size()); ++i) {
+      start_attach();
+    }
+    asn1::s1ap::s1ap_pdu_c pdu;
+    while (nof_attached + nof_failed < ues.size()) {
+      if (not recv_s1ap(pdu)) {
+        printf("eNB %d: timeout with %zd attaches in progress\n", enb_id, next_ue - nof_attached - nof_failed);
+        return;
+      }
+      handle_s1ap(pdu);
+    }
+  }
+
+  uint32_t nof_attached  = 0;
+  uint32_t nof_failed    = 0;
+  double   total_latency = 0;
+
+private:
+  struct sim_ue_t {
+    uint32_t                              mme_ue_s1ap_id = 0;
+    uint8_t                               k_asme[32]     = {};
+    uint8_t                               k_nas_enc[32]  = {};
+    uint8_t                               k_nas_int[32]  = {};
+    std::chrono::steady_clock::time_point tstart;
+  };
+
+  bool send_s1ap(const asn1::s1ap::s1ap_pdu_c& pdu)
+  {
+    uint8_t       buf[2048];
+    asn1::bit_ref bref(buf, sizeof(buf));
+    if (pdu.pack(bref) != asn1::ISRASN_SUCCESS) {
+      return false;
+    }
+    return sctp_sendmsg(mme_socket.fd(),
+                        buf,
+                        bref.distance_bytes(),
+                        (sockaddr*)&mme_addr,
+                        sizeof(mme_addr),
+                        htonl(s1ap_ppid),
+                        0,
+                        0,
+                        0,
+                        0) != -1;
+  }
+
+  bool recv_s1ap(asn1::s1ap::s1ap_pdu_c& pdu)
+  {
+    uint8_t buf[2048];
+    ssize_t n = recv(mme_socket.fd(), buf, sizeof(buf), 0);
+    if (n <= 0) {
+      return false;
+    }
+    asn1::cbit_ref bref(buf, n);
+    return pdu.unpack(bref) == asn1::ISRASN_SUCCESS;
+  }
+
+  void send_ul_nas(uint32_t ue_idx, const LIBLTE_BYTE_MSG_STRUCT& nas)
+  {
+    asn1::s1ap::s1ap_pdu_c pdu;
+    pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UL_NAS_TRANSPORT);
+    asn1::s1ap::ul_nas_transport_s& container = pdu.init_msg().value.ul_nas_transport();
+    container->mme_ue_s1ap_id.value           = ues[ue_idx].mme_ue_s1ap_id;
+    container->enb_ue_s1ap_id.value           = ue_idx + 1;
+    container->nas_pdu.value.resize(nas.N_bytes);
+    memcpy(container->nas_pdu.value.data(), nas.msg, nas.N_bytes);
+    container->eutran_cgi.value = eutran_cgi;
+    container->tai.value        = tai;
+    send_s1ap(pdu);
+  }
+
+  /// Fills in the MAC of an uplink NAS message with the EIA2 NAS integrity key of the UE
+  void integrity_protect(uint32_t ue_idx, uint32_t count, LIBLTE_BYTE_MSG_STRUCT* nas)
+  {
+    isrran::security_128_eia2(&ues[ue_idx].k_nas_int[16],
+                              count,
+                              0,
+                              isrran::SECURITY_DIRECTION_UPLINK,
+                              &nas->msg[5],
+                              nas->N_bytes - 5,
+                              &nas->msg[1]);
+  }
+
+  void start_attach()
+  {
+    uint32_t ue_idx    = next_ue++;
+    ues[ue_idx].tstart = std::chrono::steady_clock::now();
+    uint64_t imsi      = first_imsi + first_ue + ue_idx;
+    uint8_t  imsi_digits[15];
+    for (int i = 14; i >= 0; --i) {
+      imsi_digits[i] = imsi % 10;
+      imsi /= 10;
+    }
+
+    LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT attach_req = {};
+    attach_req.eps_attach_type                      = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+    for (uint32_t i = 0; i < 3; ++i) {
+      attach_req.ue_network_cap.eea[i] = true;
+      attach_req.ue_network_cap.eia[i] = true;
+    }
+    attach_req.nas_ksi.tsc_flag         = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+    attach_req.nas_ksi.nas_ksi          = LIBLTE_MME_NAS_KEY_SET_IDENTIFIER_NO_KEY_AVAILABLE;
+    attach_req.eps_mobile_id.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+    memcpy(attach_req.eps_mobile_id.imsi, imsi_digits, 15);
+
+    LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT pdn_con_req = {};
+    pdn_con_req.proc_transaction_id                            = 1;
+    pdn_con_req.request_type                                   = LIBLTE_MME_REQUEST_TYPE_INITIAL_REQUEST;
+    pdn_con_req.pdn_type                                       = LIBLTE_MME_PDN_TYPE_IPV4;
+    liblte_mme_pack_pdn_connectivity_request_msg(&pdn_con_req, &attach_req.esm_msg);
+
+    LIBLTE_BYTE_MSG_STRUCT nas = {};
+    liblte_mme_pack_attach_request_msg(&attach_req, &nas);
+
+    asn1::s1ap::s1ap_pdu_c pdu;
+    pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_INIT_UE_MSG);
+    asn1::s1ap::init_ue_msg_s& container = pdu.init_msg().value.init_ue_msg();
+    container->enb_ue_s1ap_id.value      = ue_idx + 1;
+    container->nas_pdu.value.resize(nas.N_bytes);
+    memcpy(container->nas_pdu.value.data(), nas.msg, nas.N_bytes);
+    container->tai.value                           = tai;
+    container->eutran_cgi.value                    = eutran_cgi;
+    container->rrc_establishment_cause.value = asn1::s1ap::rrc_establishment_cause_opts::mo_sig;
+    send_s1ap(pdu);
+  }
+
+  void finish_attach(uint32_t ue_idx, bool success)
+  {
+    if (success) {
+      nof_attached++;
+      total_latency += std::chrono::duration<double>(std::chrono::steady_clock::now() - ues[ue_idx].tstart).count();
+    } else {
+      nof_failed++;
+    }
+    if (next_ue < ues.size()) {
+      start_attach();
+    }
+  }
+
+  void handle_s1ap(const asn1::s1ap::s1ap_pdu_c& pdu)
+  {
+    using init_msg_types = asn1::s1ap::s1ap_elem_procs_o::init_msg_c::types_opts;
+    if (pdu.type().value != asn1::s1ap::s1ap_pdu_c::types_opts::init_msg) {
+      return;
+    }
+    switch (pdu.init_msg().value.type().value) {
+      case init_msg_types::dl_nas_transport: {
+        const asn1::s1ap::dl_nas_transport_s& dl_nas = pdu.init_msg().value.dl_nas_transport();
+        uint32_t                              ue_idx = dl_nas->enb_ue_s1ap_id.value.value - 1;
+        if (ue_idx < next_ue) {
+          ues[ue_idx].mme_ue_s1ap_id = dl_nas->mme_ue_s1ap_id.value.value;
+          handle_dl_nas(ue_idx, dl_nas->nas_pdu.value.data(), dl_nas->nas_pdu.value.size());
+        }
+        break;
+      }
+      case init_msg_types::init_context_setup_request: {
+        const asn1::s1ap::init_context_setup_request_s& ics    = pdu.init_msg().value.init_context_setup_request();
+        uint32_t                                        ue_idx = ics->enb_ue_s1ap_id.value.value - 1;
+        if (ue_idx < next_ue and ics->erab_to_be_setup_list_ctxt_su_req.value.size() > 0) {
+          uint8_t erab_id =
+              ics->erab_to_be_setup_list_ctxt_su_req.value[0]->erab_to_be_setup_item_ctxt_su_req().erab_id;
+          send_initial_context_setup_response(ue_idx, erab_id);
+          send_attach_complete(ue_idx, erab_id);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  void handle_dl_nas(uint32_t ue_idx, const uint8_t* data, uint32_t len)
+  {
+    LIBLTE_BYTE_MSG_STRUCT nas = {};
+    memcpy(nas.msg, data, len);
+    nas.N_bytes = len;
+    uint8_t pd, msg_type;
+    liblte_mme_parse_msg_header(&nas, &pd, &msg_type);
+    switch (msg_type) {
+      case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REQUEST:
+        send_authentication_response(ue_idx, &nas);
+        break;
+      case LIBLTE_MME_MSG_TYPE_SECURITY_MODE_COMMAND:
+        send_security_mode_complete(ue_idx, &nas);
+        break;
+      case LIBLTE_MME_MSG_TYPE_EMM_INFORMATION:
+        finish_attach(ue_idx, true);
+        break;
+      default:
+        // Authentication or attach reject
+        finish_attach(ue_idx, false);
+        break;
+    }
+  }
+
+  void send_authentication_response(uint32_t ue_idx, LIBLTE_BYTE_MSG_STRUCT* nas)
+  {
+    LIBLTE_MME_AUTHENTICATION_REQUEST_MSG_STRUCT auth_req = {};
+    liblte_mme_unpack_authentication_request_msg(nas, &auth_req);
+
+    // The first 6 bytes of AUTN are SQN xor AK, which is all the UE needs to derive K_ASME
+    LIBLTE_MME_AUTHENTICATION_RESPONSE_MSG_STRUCT auth_resp = {};
+    uint8_t                                       ck[16], ik[16], ak[6];
+    isrran::security_milenage_f2345(ue_key, ue_opc, auth_req.rand, auth_resp.res, ck, ik, ak);
+    isrran::security_generate_k_asme(ck, ik, auth_req.autn, mcc, mnc, ues[ue_idx].k_asme);
+    auth_resp.res_len = 8;
+
+    LIBLTE_BYTE_MSG_STRUCT nas_tx = {};
+    liblte_mme_pack_authentication_response_msg(&auth_resp, LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS, 0, &nas_tx);
+    send_ul_nas(ue_idx, nas_tx);
+  }
+
+  void send_security_mode_complete(uint32_t ue_idx, LIBLTE_BYTE_MSG_STRUCT* nas)
+  {
+    LIBLTE_MME_SECURITY_MODE_COMMAND_MSG_STRUCT sm_cmd = {};
+    liblte_mme_unpack_security_mode_command_msg(nas, &sm_cmd);
+    isrran::security_generate_k_nas(ues[ue_idx].k_asme,
+                                    (isrran::CIPHERING_ALGORITHM_ID_ENUM)sm_cmd.selected_nas_sec_algs.type_of_eea,
+                                    (isrran::INTEGRITY_ALGORITHM_ID_ENUM)sm_cmd.selected_nas_sec_algs.type_of_eia,
+                                    ues[ue_idx].k_nas_enc,
+                                    ues[ue_idx].k_nas_int);
+
+    LIBLTE_MME_SECURITY_MODE_COMPLETE_MSG_STRUCT sm_comp = {};
+    LIBLTE_BYTE_MSG_STRUCT                       nas_tx  = {};
+    liblte_mme_pack_security_mode_complete_msg(
+        &sm_comp, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT, 0, &nas_tx);
+    integrity_protect(ue_idx, 0, &nas_tx);
+    send_ul_nas(ue_idx, nas_tx);
+  }
+
+  void send_initial_context_setup_response(uint32_t ue_idx, uint8_t erab_id)
+  {
+    asn1::s1ap::s1ap_pdu_c pdu;
+    pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_INIT_CONTEXT_SETUP);
+    asn1::s1ap::init_context_setup_resp_s& container = pdu.successful_outcome().value.init_context_setup_resp();
+    container->mme_ue_s1ap_id.value                  = ues[ue_idx].mme_ue_s1ap_id;
+    container->enb_ue_s1ap_id.value                  = ue_idx + 1;
+    container->erab_setup_list_ctxt_su_res.value.resize(1);
+    container->erab_setup_list_ctxt_su_res.value[0].load_info_obj(ASN1_S1AP_ID_ERAB_SETUP_ITEM_CTXT_SU_RES);
+    asn1::s1ap::erab_setup_item_ctxt_su_res_s& item =
+        container->erab_setup_list_ctxt_su_res.value[0]->erab_setup_item_ctxt_su_res();
+    item.erab_id = erab_id;
+    item.transport_layer_address.resize(32);
+    item.transport_layer_address.from_number(INADDR_LOOPBACK);
+    item.gtp_teid.from_number(first_ue + ue_idx + 1);
+    send_s1ap(pdu);
+  }
+
+  void send_attach_complete(uint32_t ue_idx, uint8_t erab_id)
+  {
+    LIBLTE_MME_ATTACH_COMPLETE_MSG_STRUCT                            attach_comp = {};
+    LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_ACCEPT_MSG_STRUCT act_bearer  = {};
+    act_bearer.eps_bearer_id                                                     = erab_id;
+    act_bearer.proc_transaction_id                                               = 1;
+    liblte_mme_pack_activate_default_eps_bearer_context_accept_msg(&act_bearer, &attach_comp.esm_msg);
+
+    // Second uplink NAS message after the security mode complete. EEA0 is selected by the MME, so it is not ciphered
+    LIBLTE_BYTE_MSG_STRUCT nas_tx = {};
+    liblte_mme_pack_attach_complete_msg(&attach_comp, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED, 1, &nas_tx);
+    integrity_protect(ue_idx, 1, &nas_tx);
+    send_ul_nas(ue_idx, nas_tx);
+  }
+
+  uint32_t                 enb_id;
+  uint32_t                 first_ue;
+  std::vector<sim_ue_t>    ues;
+  size_t                   next_ue = 0;
+  isrran::unique_socket    mme_socket;
+  sockaddr_in              mme_addr = {};
+  asn1::s1ap::tai_s        tai;
+  asn1::s1ap::eutran_cgi_s eutran_cgi;
+};
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  isrlog::fetch_basic_logger("NAS", false).set_level(isrlog::basic_levels::error);
+  isrlog::fetch_basic_logger("S1AP", false).set_level(isrlog::basic_levels::error);
+  isrlog::fetch_basic_logger("MME GTPC", false).set_level(isrlog::basic_levels::error);
+  isrlog::fetch_basic_logger("HSS", false).set_level(isrlog::basic_levels::error);
+  isrlog::init();
+
+  isrran::string_to_mcc("001", &mcc);
+  isrran::string_to_mnc("01", &mnc);
+
+  char db_file[] = "/tmp/mme_attach_benchmark_XXXXXX";
+  int  db_fd     = mkstemp(db_file);
+  if (db_fd == -1 or not write_user_db(db_file)) {
+    printf("Error writing the user database\n");
+    return -1;
+  }
+  close(db_fd);
+
+  hss_args_t hss_args   = {};
+  hss_args.db_file      = db_file;
+  hss_args.mcc          = mcc;
+  hss_args.mnc          = mnc;
+  hss_args.av_pool_size = av_pool_size;
+  hss* hss              = hss::get_instance();
+  if (hss->init(&hss_args)) {
+    printf("Error initializing HSS\n");
+    return -1;
+  }
+
+  dummy_spgw spgw;
+  if (not spgw.init()) {
+    printf("Error opening the S11 socket of the SP-GW\n");
+    return -1;
+  }
+
+  mme_args_t mme_args                = {};
+  mme_args.s1ap_args.mme_code        = 0x01;
+  mme_args.s1ap_args.mme_group       = 0x0001;
+  mme_args.s1ap_args.tac             = 7;
+  mme_args.s1ap_args.mcc             = mcc;
+  mme_args.s1ap_args.mnc             = mnc;
+  mme_args.s1ap_args.paging_timer    = 2;
+  mme_args.s1ap_args.mme_bind_addr   = mme_bind_addr;
+  mme_args.s1ap_args.mme_name        = "isrmme01";
+  mme_args.s1ap_args.dns_addr        = "8.8.8.8";
+  mme_args.s1ap_args.full_net_name   = "Software Radio Systems RAN";
+  mme_args.s1ap_args.short_net_name  = "isrRAN";
+  mme_args.s1ap_args.mme_apn         = "israpn";
+  mme_args.s1ap_args.pcap_enable     = false;
+  mme_args.s1ap_args.encryption_algo = isrran::CIPHERING_ALGORITHM_ID_EEA0;
+  mme_args.s1ap_args.integrity_algo  = isrran::INTEGRITY_ALGORITHM_ID_128_EIA2;
+  mme_args.s1ap_args.request_imeisv  = false;
+  mme_args.s1ap_args.lac             = 0x0001;
+  mme_args.s1ap_args.nof_workers     = nof_workers;
+
+  // The MME prints every procedure to the console, which is discarded while the attaches run
+  int stdout_fd = dup(STDOUT_FILENO);
+  int null_fd   = open("/dev/null", O_WRONLY);
+  dup2(null_fd, STDOUT_FILENO);
+
+  mme* mme = mme::get_instance();
+  if (mme->init(&mme_args)) {
+    return -1;
+  }
+  mme->start();
+
+  std::vector<std::unique_ptr<sim_enb> > enbs;
+  for (uint32_t i = 0; i < nof_enbs; ++i) {
+    uint32_t first_ue = i * nof_ues / nof_enbs;
+    enbs.emplace_back(new sim_enb(i + 1, first_ue, (i + 1) * nof_ues / nof_enbs - first_ue));
+    if (not enbs.back()->connect()) {
+      dup2(stdout_fd, STDOUT_FILENO);
+      printf("Error connecting eNB %d to the MME\n", i + 1);
+      exit(-1);
+    }
+  }
+
+  auto                     tstart = std::chrono::steady_clock::now();
+  std::vector<std::thread> enb_threads;
+  for (std::unique_ptr<sim_enb>& enb : enbs) {
+    enb_threads.emplace_back([&enb]() { enb->run(); });
+  }
+  for (std::thread& t : enb_threads) {
+    t.join();
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - tstart).count();
+
+  fflush(stdout);
+  mme->stop();
+  mme->cleanup();
+  spgw.stop();
+  hss_metrics_t hss_metrics;
+  hss->get_metrics(hss_metrics);
+  hss->cleanup();
+  unlink(db_file);
+  dup2(stdout_fd, STDOUT_FILENO);
+  close(null_fd);
+
+  uint32_t nof_attached = 0, nof_failed = 0;
+  double   total_latency = 0;
+  for (std::unique_ptr<sim_enb>& enb : enbs) {
+    nof_attached += enb->nof_attached;
+    nof_failed += enb->nof_failed;
+    total_latency += enb->total_latency;
+  }
+  printf("%d UEs, %d eNBs, %d attaches in progress per eNB, %d UE workers, %d AVs per UE\n",
+         nof_ues,
+         nof_enbs,
+         window_size,
+         nof_workers,
+         av_pool_size);
+  printf("%d attached, %d failed, %8.0f attaches/s, %8.3f ms per attach\n",
+         nof_attached,
+         nof_failed,
+         nof_attached / secs,
+         nof_attached > 0 ? total_latency * 1e3 / nof_attached : 0.0);
+  printf("AV pool: %" PRIu64 " hits, %" PRIu64 " misses\n", hss_metrics.av_pool_hits, hss_metrics.av_pool_misses);
+
+  return nof_attached == nof_ues ? 0 : -1;
+}
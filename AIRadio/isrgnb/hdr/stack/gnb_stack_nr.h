@@ -50,6 +50,7 @@ struct gnb_stack_args_t {
   mac_nr_args_t    mac;
   ngap_args_t      ngap;
   pcap_args_t      ngap_pcap;
+  uint32_t         gtpu_tx_batch_size = 1;
 };
 
 class gnb_stack_nr final : public isrenb::enb_stack_base,
@@ -81,8 +81,14 @@ public:
   rx_harq_softbuffer() { bzero(&buffer, sizeof(buffer)); }
   explicit rx_harq_softbuffer(uint32_t nof_prb_)
   {
-    // Note: for now we use same size regardless of nof_prb_
-    isrran_softbuffer_rx_init_guru(&buffer, ISRRAN_SCH_NR_MAX_NOF_CB_LDPC, ISRRAN_LDPC_MAX_LEN_ENCODED_CB);
+    // Note: for now we use same size regardless of nof_prb_. The LDPC decoder stores 8-bit soft bits, and the code
+    // blocks are only allocated for the TBS of the current transmission
+    isrran_softbuffer_rx_args_t args = {};
+    args.max_cb                      = ISRRAN_SCH_NR_MAX_NOF_CB_LDPC;
+    args.max_cb_size                 = ISRRAN_LDPC_MAX_LEN_ENCODED_CB;
+    args.llr_8bit                    = true;
+    args.on_demand                   = true;
+    isrran_softbuffer_rx_init_args(&buffer, &args);
   }
   rx_harq_softbuffer(const rx_harq_softbuffer&) = delete;
   rx_harq_softbuffer(rx_harq_softbuffer&& other) noexcept
@@ -103,7 +109,12 @@ public:
   ~rx_harq_softbuffer() { destroy(); }
 
   void reset() { isrran_softbuffer_rx_reset(&buffer); }
-  void reset(uint32_t tbs_bits) { isrran_softbuffer_rx_reset_tbs(&buffer, tbs_bits); }
+  void reset(uint32_t tbs_bits)
+  {
+    // Upper bound of the number of LDPC code blocks, given by the base graph with the smallest code blocks
+    uint32_t nof_cb = ISRRAN_CEIL(tbs_bits + 24, ISRRAN_LDPC_BG2_MAX_LEN_CB - 24);
+    isrran_softbuffer_rx_reset_cb(&buffer, ISRRAN_MIN(nof_cb, buffer.max_cb));
+  }
 
   isrran_softbuffer_rx_t&       operator*() { return buffer; }
   const isrran_softbuffer_rx_t& operator*() const { return buffer; }
@@ -61,19 +61,19 @@ public:
 
   int generate_pdu(isrran::byte_buffer_t* pdu, uint32_t grant_size, isrran::const_span<uint32_t> subpdu_lcids);
 
-  std::mutex metrics_mutex = {};
-  void       metrics_read(mac_ue_metrics_t* metrics_);
-  void       metrics_rx(bool crc, uint32_t tbs);
-  void       metrics_tx(bool crc, uint32_t tbs);
-  void       metrics_phr(float phr);
-  void       metrics_dl_ri(uint32_t dl_cqi);
-  void       metrics_dl_pmi(uint32_t dl_cqi);
-  void       metrics_dl_cqi(const isrran_uci_cfg_nr_t& cfg_, uint32_t dl_cqi);
-  void       metrics_dl_mcs(uint32_t mcs);
-  void       metrics_ul_mcs(uint32_t mcs);
-  void       metrics_pucch_sinr(float sinr);
-  void       metrics_pusch_sinr(float sinr);
-  void       metrics_cnt();
+  /// Metrics are updated by the workers without locking, and read incrementally by the metrics thread.
+  void metrics_read(mac_ue_metrics_t* metrics_);
+  void metrics_rx(bool crc, uint32_t tbs);
+  void metrics_tx(bool crc, uint32_t tbs);
+  void metrics_phr(float phr);
+  void metrics_dl_ri(uint32_t dl_cqi);
+  void metrics_dl_pmi(uint32_t dl_cqi);
+  void metrics_dl_cqi(const isrran_uci_cfg_nr_t& cfg_, uint32_t dl_cqi);
+  void metrics_dl_mcs(uint32_t mcs);
+  void metrics_ul_mcs(uint32_t mcs);
+  void metrics_pucch_sinr(float sinr);
+  void metrics_pusch_sinr(float sinr);
+  void metrics_cnt();
 
   uint32_t read_pdu(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes) final;
 
@@ -91,15 +91,8 @@ private:
 
   std::atomic<bool> active_state{true};
 
-  // TODO: some counters are kept as members of class ue_nr, while some others (i.e., mcs) are kept in the ue_metrics
-  // We should make these counters more uniform
-  uint32_t         phr_counter          = 0;
-  uint32_t         dl_cqi_valid_counter = 0;
-  uint32_t         dl_ri_counter        = 0;
-  uint32_t         dl_pmi_counter       = 0;
-  uint32_t         pucch_sinr_counter   = 0;
-  uint32_t         pusch_sinr_counter   = 0;
-  mac_ue_metrics_t ue_metrics           = {};
+  mac_ue_counters_t        metrics_counters;
+  mac_ue_counters_reader_t metrics_reader;
 
   // UE-specific buffer for MAC PDU packing, unpacking and handling
   isrran::mac_sch_pdu_nr                    mac_pdu_dl, mac_pdu_ul;
@@ -122,6 +122,7 @@ int gnb_stack_nr::init(const gnb_stack_args_t& args_,
     gtpu_args.embms_enable  = false;
     gtpu_args.mme_addr      = args.ngap.amf_addr;
     gtpu_args.gtp_bind_addr = args.ngap.gtp_bind_addr;
+    gtpu_args.tx_batch_size = args.gtpu_tx_batch_size;
     gtpu->init(gtpu_args, gtpu_adapter.get());
   } else {
     pdcp.init(&rlc, &rrc, x2_);
@@ -180,6 +181,9 @@ void gnb_stack_nr::tti_clock_impl()
 {
   //  m_ngap->run_tti();
   task_sched.tic();
+  if (gtpu != nullptr) {
+    gtpu->tti_clock();
+  }
 }
 
 void gnb_stack_nr::process_pdus() {}
@@ -197,6 +201,9 @@ bool gnb_stack_nr::get_metrics(isrenb::stack_metrics_t* metrics)
   // use stack thread to query RRC metrics
   auto ret = metrics_task_queue.try_push([this, metrics, &metrics_ready]() {
     rrc.get_metrics(metrics->rrc);
+    if (gtpu != nullptr) {
+      gtpu->get_metrics(metrics->gtpu);
+    }
     {
       std::lock_guard<std::mutex> lock(metrics_mutex);
       metrics_ready = true;
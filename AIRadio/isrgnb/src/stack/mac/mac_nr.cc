@@ -242,7 +242,11 @@ int mac_nr::init(const mac_nr_args_t&    args_,
 
   if (args.pcap.enable) {
     pcap = std::unique_ptr<isrran::mac_pcap>(new isrran::mac_pcap());
-    pcap->open(args.pcap.filename);
+    isrran::pcap_writer_args writer_args = {};
+    writer_args.pcapng                   = args.pcap.pcapng;
+    writer_args.rotate_size              = (uint64_t)args.pcap.rotate_size_mb * 1024 * 1024;
+    writer_args.rotate_period_s          = args.pcap.rotate_period_s;
+    pcap->open(args.pcap.filename, 0, writer_args);
   }
 
   logger.info("Started");
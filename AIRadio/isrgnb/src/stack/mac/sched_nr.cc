@@ -27,6 +27,7 @@
 #include "isrran/common/phy_cfg_nr_default.h"
 #include "isrran/common/string_helpers.h"
 #include "isrran/common/thread_pool.h"
+#include "isrran/isrlog/trace_ring.h"
 
 namespace isrenb {
 
@@ -370,6 +371,7 @@ int sched_nr::ue_cfg_impl(uint16_t rnti, const ue_cfg_t& uecfg)
 // NOTE: there is no parallelism in these operations
 void sched_nr::slot_indication(slot_point slot_tx)
 {
+  trace_ring_event("sched", "slot_indication", slot_tx.to_uint());
   isrran_assert(worker_count.load(std::memory_order_relaxed) == 0,
                 "Call of sched slot_indication when previous TTI has not been completed");
   // mark the start of slot.
@@ -395,6 +397,7 @@ void sched_nr::slot_indication(slot_point slot_tx)
 /// Generate {pdcch_slot,cc} scheduling decision
 sched_nr::dl_res_t* sched_nr::get_dl_sched(slot_point pdsch_tti, uint32_t cc)
 {
+  trace_ring_event("sched", "get_dl_sched", pdsch_tti.to_uint());
   isrran_assert(pdsch_tti == current_slot_tx, "Unexpected pdsch_tti slot received");
 
   // process non-cc specific feedback if pending (e.g. SRs, buffer state updates, UE config) for non-CA UEs
@@ -424,6 +427,7 @@ sched_nr::dl_res_t* sched_nr::get_dl_sched(slot_point pdsch_tti, uint32_t cc)
 /// Fetch {ul_slot,cc} UL scheduling decision
 sched_nr::ul_res_t* sched_nr::get_ul_sched(slot_point slot_ul, uint32_t cc)
 {
+  trace_ring_event("sched", "get_ul_sched", slot_ul.to_uint());
   return cc_workers[cc]->get_ul_sched(slot_ul);
 }
 
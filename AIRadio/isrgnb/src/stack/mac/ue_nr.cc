@@ -51,10 +51,6 @@ ue_nr::~ue_nr() {}
 
 void ue_nr::reset()
 {
-  {
-    std::lock_guard<std::mutex> lock(metrics_mutex);
-    ue_metrics = {};
-  }
   nof_failures = 0;
 }
 
@@ -163,30 +159,21 @@ int ue_nr::generate_pdu(isrran::byte_buffer_t* pdu, uint32_t grant_size, isrran:
 /******* METRICS interface ***************/
 void ue_nr::metrics_read(mac_ue_metrics_t* metrics_)
 {
-  uint32_t ul_buffer = 0; // sched->get_ul_buffer(rnti);
-  uint32_t dl_buffer = 0; // sched->get_dl_buffer(rnti);
+  *metrics_ = {};
+  metrics_reader.update(metrics_counters);
+  read_mac_ue_counters(metrics_reader, *metrics_);
 
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  ue_metrics.rnti      = rnti;
-  ue_metrics.ul_buffer = ul_buffer;
-  ue_metrics.dl_buffer = dl_buffer;
+  metrics_->rnti      = rnti;
+  metrics_->ul_buffer = 0; // sched->get_ul_buffer(rnti);
+  metrics_->dl_buffer = 0; // sched->get_dl_buffer(rnti);
 
   // set PCell sector id
   // TODO: use ue_cfg when multiple NR carriers are supported
-  ue_metrics.cc_idx = 0;
-
-  *metrics_            = ue_metrics;
-  phr_counter          = 0;
-  dl_cqi_valid_counter = 0;
-  pucch_sinr_counter   = 0;
-  pusch_sinr_counter   = 0;
-  ue_metrics           = {};
+  metrics_->cc_idx = 0;
 }
 
 void ue_nr::metrics_dl_cqi(const isrran_uci_cfg_nr_t& cfg_, uint32_t dl_cqi)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-
   // Process CQI
   for (uint32_t i = 0; i < cfg_.nof_csi; i++) {
     // Skip if invalid or not supported CSI report
@@ -196,71 +183,55 @@ void ue_nr::metrics_dl_cqi(const isrran_uci_cfg_nr_t& cfg_, uint32_t dl_cqi)
     }
 
     // Add statistics
-    ue_metrics.dl_cqi = ISRRAN_VEC_SAFE_CMA(dl_cqi, ue_metrics.dl_cqi, dl_cqi_valid_counter);
-    dl_cqi_valid_counter++;
+    metrics_counters.add_sample(mac_ue_counter::dl_cqi_sum, mac_ue_counter::dl_cqi_samples, dl_cqi);
   }
 }
 
 void ue_nr::metrics_rx(bool crc, uint32_t tbs)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
   if (crc) {
-    ue_metrics.rx_brate += tbs * 8;
+    metrics_counters.add(mac_ue_counter::rx_bits, tbs * 8);
   } else {
-    ue_metrics.rx_errors++;
+    metrics_counters.add(mac_ue_counter::rx_errors);
   }
-  ue_metrics.rx_pkts++;
+  metrics_counters.add(mac_ue_counter::rx_pkts);
 }
 
 void ue_nr::metrics_tx(bool crc, uint32_t tbs)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
   if (crc) {
-    ue_metrics.tx_brate += tbs * 8;
+    metrics_counters.add(mac_ue_counter::tx_bits, tbs * 8);
   } else {
-    ue_metrics.tx_errors++;
+    metrics_counters.add(mac_ue_counter::tx_errors);
   }
-  ue_metrics.tx_pkts++;
+  metrics_counters.add(mac_ue_counter::tx_pkts);
 }
 
 void ue_nr::metrics_dl_mcs(uint32_t mcs)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  ue_metrics.dl_mcs = ISRRAN_VEC_CMA((float)mcs, ue_metrics.dl_mcs, ue_metrics.dl_mcs_samples);
-  ue_metrics.dl_mcs_samples++;
+  metrics_counters.add_sample(mac_ue_counter::dl_mcs_sum, mac_ue_counter::dl_mcs_samples, mcs);
 }
 
 void ue_nr::metrics_ul_mcs(uint32_t mcs)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  ue_metrics.ul_mcs = ISRRAN_VEC_CMA((float)mcs, ue_metrics.ul_mcs, ue_metrics.ul_mcs_samples);
-  ue_metrics.ul_mcs_samples++;
+  metrics_counters.add_sample(mac_ue_counter::ul_mcs_sum, mac_ue_counter::ul_mcs_samples, mcs);
 }
 
 void ue_nr::metrics_cnt()
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  ue_metrics.nof_tti++;
+  metrics_counters.add(mac_ue_counter::nof_tti);
 }
 
 void ue_nr::metrics_pucch_sinr(float sinr)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  // discard nan or inf values for average SINR
-  if (!std::isinf(sinr) && !std::isnan(sinr)) {
-    ue_metrics.pucch_sinr = ISRRAN_VEC_SAFE_CMA((float)sinr, ue_metrics.pucch_sinr, pucch_sinr_counter);
-    pucch_sinr_counter++;
-  }
+  // nan or inf values are discarded for average SINR
+  metrics_counters.add_sample(mac_ue_counter::pucch_sinr_sum, mac_ue_counter::pucch_sinr_samples, sinr);
 }
 
 void ue_nr::metrics_pusch_sinr(float sinr)
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  // discard nan or inf values for average SINR
-  if (!std::isinf(sinr) && !std::isnan(sinr)) {
-    ue_metrics.pusch_sinr = ISRRAN_VEC_SAFE_CMA((float)sinr, ue_metrics.pusch_sinr, pusch_sinr_counter);
-    pusch_sinr_counter++;
-  }
+  // nan or inf values are discarded for average SINR
+  metrics_counters.add_sample(mac_ue_counter::pusch_sinr_sum, mac_ue_counter::pusch_sinr_samples, sinr);
 }
 
 // Called from Stack thread when demuxing UL PDUs
@@ -54,8 +54,9 @@ public:
 
   void set_uci_periodic_cqi(isrran_uci_data_t* uci_data);
 
-  bool work_dl_regular();
-  bool work_dl_mbsfn(isrran_mbsfn_cfg_t mbsfn_cfg);
+  // A non-null host is a worker of another UE camping on the same cell that has already demodulated this subframe
+  bool work_dl_regular(const cc_worker* host = nullptr);
+  bool work_dl_mbsfn(isrran_mbsfn_cfg_t mbsfn_cfg, const cc_worker* host = nullptr);
   bool work_ul(isrran_uci_data_t* uci_data);
 
   int read_ce_abs(float* ce_abs, uint32_t tx_antenna, uint32_t rx_antenna);
@@ -76,6 +77,7 @@ private:
                            mac_interface_phy_lte::mac_grant_ul_t* mac_grant);
 
   /* Methods for DL... */
+  int decode_fft_estimate(const cc_worker* host);
   int decode_pdcch_ul();
   int decode_pdcch_dl();
 
@@ -58,6 +58,11 @@ public:
   void set_tdd_config_nolock(isrran_tdd_config_t config);
   void set_config_nolock(uint32_t cc_idx, const isrran::phy_cfg_t& phy_cfg);
 
+  /* Functions used when several UEs share the PHY pipeline. A guest worker decodes the subframe from the channel
+   * estimates of the host worker with the same id and keeps its uplink signal for the host to combine it */
+  void  work_guest(sf_worker* host_);
+  cf_t* get_guest_tx(uint32_t cc_idx) const;
+
   ///< Methods for plotting called from GUI thread
   int      read_ce_abs(float* ce_abs, uint32_t tx_antenna, uint32_t rx_antenna);
   uint32_t get_cell_nof_ports()
@@ -78,6 +83,11 @@ private:
   /* Inherited from thread_pool::worker. Function called every subframe to run the DL/UL processing */
   void work_imp() final;
 
+  bool work_dl(sf_worker* host_);
+  bool work_ul(isrran::rf_buffer_t& tx_signal_ptr);
+  void run_guests();
+  bool combine_guest_tx(sf_worker* guest, isrran::rf_buffer_t& tx_signal_ptr);
+
   void update_measurements();
   void reset_uci(isrran_uci_data_t* uci_data);
 
@@ -97,6 +107,21 @@ private:
   cf_t* prach_ptr   = nullptr;
   float prach_power = 0;
 
+  // Carriers processed in the last subframe, read by the guests of this worker
+  bool dl_processed[ISRRAN_MAX_CARRIERS] = {};
+  bool dl_mbsfn                          = false;
+  bool tx_cc_ready[ISRRAN_MAX_CARRIERS]  = {};
+
+  // Host worker state while running as a guest
+  sf_worker*          host           = nullptr;
+  isrran::rf_buffer_t guest_tx_signal;
+  bool                guest_tx_ready = false;
+
+  // Guests still running for the current subframe
+  std::mutex              guest_mutex;
+  std::condition_variable guest_cvar;
+  uint32_t                guest_pending = 0;
+
   isrran::phy_common_interface::worker_context_t context = {};
 };
 
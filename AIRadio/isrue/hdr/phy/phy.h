@@ -25,6 +25,7 @@
 #include "phy_common.h"
 #include "phy_metrics.h"
 #include "isrran/common/block_queue.h"
+#include "isrran/common/thread_pool.h"
 #include "isrran/common/threads.h"
 #include "isrran/common/trace.h"
 #include "isrran/interfaces/phy_interface_types.h"
@@ -136,6 +137,12 @@ public:
 
   void start_plot() final;
 
+  /********** Shared PHY pipeline ********************/
+  // Registers an additional UE decoding from the DL estimates of this PHY and transmitting through its radio. Must be
+  // called before switching on
+  void add_guest(phy_guest* guest);
+  void get_current_cell(isrran_cell_t* cell, uint32_t* earfcn = nullptr);
+
   const static int MAX_WORKERS     = 4;
   const static int DEFAULT_WORKERS = 4;
 
@@ -198,6 +205,9 @@ private:
   // in parallel and avoid accumulating in the queue
   phy_cmd_proc cmd_worker_cell, cmd_worker;
 
+  // Runs the subframes of the guest UEs in parallel
+  std::unique_ptr<isrran::task_thread_pool> guest_pool;
+
   // Tracks the current selected cell (last call to cell_select)
   isrran_cell_t selected_cell = {};
 
@@ -26,6 +26,7 @@
 #include "isrran/adt/circular_array.h"
 #include "isrran/common/block_queue.h"
 #include "isrran/common/gen_mch_tables.h"
+#include "isrran/common/thread_pool.h"
 #include "isrran/common/threads.h"
 #include "isrran/common/tti_sempahore.h"
 #include "isrran/interfaces/phy_common_interface.h"
@@ -46,6 +47,7 @@
 namespace isrue {
 
 class stack_interface_phy_lte;
+class phy_guest;
 
 class rsrp_insync_itf
 {
@@ -117,6 +119,10 @@ public:
   // Last reported RI
   std::atomic<uint32_t> last_ri = {0};
 
+  // UEs sharing the DL demodulation and UL transmission of this PHY. Set before switching on, not modified after
+  std::vector<phy_guest*>   guests;
+  isrran::task_thread_pool* guest_pool = nullptr;
+
   phy_common(isrlog::basic_logger& logger);
 
   ~phy_common();
@@ -0,0 +1,133 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRUE_PHY_GUEST_H
+#define ISRUE_PHY_GUEST_H
+
+#include "phy_common.h"
+#include "prach.h"
+#include "isrran/interfaces/ue_phy_interfaces.h"
+#include "isrue/hdr/phy/lte/sf_worker.h"
+#include <array>
+#include <memory>
+#include <mutex>
+
+namespace isrue {
+
+class phy;
+
+/**
+ * LTE PHY of an additional UE simulated in the same process as a host UE. It has no radio nor synchronization of its
+ * own: it camps on the cell of the host and its workers run inside the host workers, decoding the DL from the host
+ * channel estimates and handing their UL signal back to be combined into a single transmission.
+ *
+ * Cell search and selection complete as soon as the host is camping on the requested cell. Timing advance and SCell
+ * frequencies are those of the host.
+ */
+class phy_guest final : public phy_interface_stack_lte, public rsrp_insync_itf
+{
+public:
+  explicit phy_guest(uint32_t ue_idx);
+  ~phy_guest() { stop(); }
+
+  int  init(const phy_args_t& args_, stack_interface_phy_lte* stack_, phy* host_, isrran::radio_interface_phy* radio_);
+  void stop();
+
+  /* Functions used by the host PHY */
+  void            set_context(uint32_t worker_id, const isrran::phy_common_interface::worker_context_t& ctx, float cfo);
+  void            work(uint32_t worker_id, lte::sf_worker* host_worker);
+  lte::sf_worker* get_worker(uint32_t worker_id);
+  void            run_stack_tti(uint32_t tti, int32_t tti_jump);
+
+  /********** RRC INTERFACE ********************/
+  bool cell_search(int earfcn) final;
+  bool cell_select(phy_cell_t cell) final;
+  bool cell_is_camping() final;
+  bool set_config(const isrran::phy_cfg_t& config, uint32_t cc_idx) final;
+  bool set_scell(isrran_cell_t cell_info, uint32_t cc_idx, uint32_t earfcn) final;
+  void set_config_tdd(isrran_tdd_config_t& tdd_config) final;
+  void set_config_mbsfn_sib2(isrran::mbsfn_sf_cfg_t* cfg_list, uint32_t nof_cfgs) final;
+  void set_config_mbsfn_sib13(const isrran::sib13_t& sib13) final;
+  void set_config_mbsfn_mcch(const isrran::mcch_msg_t& mcch) final;
+  void deactivate_scells() final;
+  void set_cells_to_meas(uint32_t earfcn, const std::set<uint32_t>& pci) final {}
+  void meas_stop() final {}
+
+  /********** MAC INTERFACE ********************/
+  void         prach_send(uint32_t preamble_idx, int allowed_subframe, float target_power_dbm, float ta_base_sec) final;
+  prach_info_t prach_get_info() final;
+  void         sr_send() final;
+  int          sr_last_tx_tti() final;
+  void         set_mch_period_stop(uint32_t stop) final;
+  void         set_timeadv_rar(uint32_t tti, uint32_t ta_cmd) final;
+  void         set_timeadv(uint32_t tti, uint32_t ta_cmd) final;
+  void         set_activation_deactivation_scell(uint32_t cmd, uint32_t tti) final;
+  void         set_rar_grant(uint8_t grant_payload[ISRRAN_RAR_GRANT_LEN], uint16_t rnti) final;
+  uint32_t     get_current_tti() final;
+  float        get_phr() final;
+  float        get_pathloss_db() final;
+
+  /********** Worker feedback ********************/
+  void in_sync() final;
+  void out_of_sync() final;
+  void set_cfo(float cfo) final {}
+
+private:
+  const static int MAX_WORKERS            = 4;
+  const static int CELL_SEARCH_TIMEOUT_MS = 5000;
+
+  void configure_prach_params();
+  void reset();
+
+  isrlog::basic_logger&        logger;
+  phy_args_t                   args      = {};
+  stack_interface_phy_lte*     stack     = nullptr;
+  phy*                         host      = nullptr;
+  isrran::radio_interface_phy* radio     = nullptr;
+  bool                         initiated = false;
+
+  phy_common                                   common;
+  prach                                        prach_buffer;
+  std::vector<std::unique_ptr<lte::sf_worker>> workers;
+
+  // Held while a worker runs or is configured, plays the role of the worker pool reservation in the host
+  std::array<std::mutex, MAX_WORKERS> worker_mutex;
+
+  // PRACH state, only accessed from the host synchronization thread
+  cf_t*    prach_ptr    = nullptr;
+  uint32_t prach_nof_sf = 0;
+  uint32_t prach_sf_cnt = 0;
+  float    prach_power  = 0;
+
+  isrran_prach_cfg_t  prach_cfg     = {};
+  isrran_tdd_config_t tdd_config    = {};
+  isrran_cell_t       selected_cell = {};
+  std::atomic<bool>   camping       = {false};
+
+  std::atomic<uint32_t> in_sync_cnt     = {0};
+  std::atomic<uint32_t> out_of_sync_cnt = {0};
+
+  phy_cmd_proc cmd_worker_cell, cmd_worker;
+};
+
+} // namespace isrue
+
+#endif // ISRUE_PHY_GUEST_H
@@ -160,8 +160,9 @@ private:
   isrran::mac_pcap* pcap = nullptr;
   std::atomic<bool> is_first_ul_grant{false};
 
-  std::mutex    metrics_mutex                = {};
-  mac_metrics_t metrics[ISRRAN_MAX_CARRIERS] = {};
+  // Updated without locking, and read incrementally by the metrics thread
+  std::array<mac_counters_t, ISRRAN_MAX_CARRIERS>        metrics_counters;
+  std::array<mac_counters_reader_t, ISRRAN_MAX_CARRIERS> metrics_readers;
 
   std::atomic<bool> initialized = {false};
 
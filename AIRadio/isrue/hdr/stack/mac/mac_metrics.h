@@ -22,6 +22,8 @@
 #ifndef ISRUE_MAC_METRICS_H
 #define ISRUE_MAC_METRICS_H
 
+#include "isrran/common/metrics_counters.h"
+
 namespace isrue {
 
 struct mac_metrics_t {
@@ -37,6 +39,12 @@ struct mac_metrics_t {
   float    ul_retx_avg;
 };
 
+/// Counters of the MAC metrics of a carrier, updated by the PHY workers and the stack.
+enum class mac_counter { nof_tti, tx_pkts, tx_errors, tx_bits, rx_pkts, rx_errors, rx_bits, nof_counters };
+
+using mac_counters_t        = isrran::metrics_counters<mac_counter>;
+using mac_counters_reader_t = isrran::metrics_counters_reader<mac_counter>;
+
 } // namespace isrue
 
 #endif // ISRUE_MAC_METRICS_H
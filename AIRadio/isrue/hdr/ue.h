@@ -43,6 +43,9 @@
 
 namespace isrue {
 
+class phy;
+class phy_guest;
+
 /*******************************************************************************
   UE Parameters
 *******************************************************************************/
@@ -58,6 +61,7 @@ typedef struct {
   int         all_hex_limit;
   int         file_max_size;
   std::string filename;
+  bool        binary;
 } log_args_t;
 
 typedef struct {
@@ -77,6 +81,10 @@ typedef struct {
   std::size_t tracing_buffcapacity;
 } general_args_t;
 
+typedef struct {
+  uint32_t nof_ues;
+} multi_ue_args_t;
+
 typedef struct {
   isrran::rf_args_t rf;
   trace_args_t      trace;
@@ -87,7 +95,8 @@ typedef struct {
   stack_args_t stack;
   gw_args_t    gw;
 
-  general_args_t general;
+  general_args_t  general;
+  multi_ue_args_t multi_ue;
 } all_args_t;
 
 /*******************************************************************************
@@ -119,6 +128,14 @@ private:
   std::unique_ptr<ue_stack_base>      stack;
   std::unique_ptr<gw>                 gw_inst;
 
+  // Additional UEs sharing the radio and the PHY pipeline of the first one
+  struct guest_ue_t {
+    std::unique_ptr<phy_guest>     phy;
+    std::unique_ptr<ue_stack_base> stack;
+    std::unique_ptr<gw>            gw_inst;
+  };
+  std::vector<guest_ue_t> guests;
+
   // Generic logger members
   isrlog::basic_logger& logger;
 
@@ -129,6 +146,7 @@ private:
 
   // Helper functions
   int parse_args(const all_args_t& args); // parse and validate arguments
+  int init_guests(isrue::phy* host, isrran::radio* host_radio);
 
   std::string get_build_mode();
   std::string get_build_info();
@@ -194,6 +194,7 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
 
     ("log.filename", bpo::value<string>(&args->log.filename)->default_value("/tmp/ue.log"), "Log filename")
     ("log.file_max_size", bpo::value<int>(&args->log.file_max_size)->default_value(-1), "Maximum file size (in kilobytes). When passed, multiple files are created. Default -1 (single file)")
+    ("log.binary", bpo::value<bool>(&args->log.binary)->default_value(false), "Write the log file in binary form, to be rendered with isrlog_decode. Ignores file_max_size")
 
     ("usim.mode", bpo::value<string>(&args->stack.usim.mode)->default_value("soft"), "USIM mode (soft or pcsc)")
     ("usim.algo", bpo::value<string>(&args->stack.usim.algo), "USIM authentication algorithm")
@@ -451,6 +452,14 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
      bpo::value<int>(&args->stack.nas.sim.airplane_t_off_ms)->default_value(-1),
      "Off-time for airplane mode (in ms)")
 
+    ("sim.nof_ues",
+     bpo::value<uint32_t>(&args->multi_ue.nof_ues)->default_value(1),
+     "Number of UEs simulated in this process sharing the radio")
+
+    ("sim.nof_ue_threads",
+     bpo::value<uint32_t>(&args->phy.nof_ue_threads)->default_value(2),
+     "Number of threads decoding the additional UEs (0 runs them in the PHY workers)")
+
      /* general options */
     ("general.metrics_period_secs",
        bpo::value<float>(&args->general.metrics_period_secs)->default_value(1.0),
@@ -729,9 +738,13 @@ int main(int argc, char* argv[])
   }
 
   // Setup logging.
-  log_sink = (args.log.filename == "stdout")
-                 ? isrlog::create_stdout_sink()
-                 : isrlog::create_file_sink(args.log.filename, fixup_log_file_maxsize(args.log.file_max_size));
+  if (args.log.filename == "stdout") {
+    log_sink = isrlog::create_stdout_sink();
+  } else if (args.log.binary) {
+    log_sink = &isrlog::fetch_binary_file_sink(args.log.filename);
+  } else {
+    log_sink = isrlog::create_file_sink(args.log.filename, fixup_log_file_maxsize(args.log.file_max_size));
+  }
   if (!log_sink) {
     return ISRRAN_ERROR;
   }
@@ -211,7 +211,18 @@ void cc_worker::set_tdd_config_nolock(isrran_tdd_config_t config)
  *
  */
 
-bool cc_worker::work_dl_regular()
+int cc_worker::decode_fft_estimate(const cc_worker* host)
+{
+  if (host == nullptr) {
+    return isrran_ue_dl_decode_fft_estimate(&ue_dl, &sf_cfg_dl, &ue_dl_cfg);
+  }
+
+  // Reuse the grid and channel estimates of the UE sharing this cell, only the PDCCH is extracted again
+  sf_cfg_dl.cfi = host->sf_cfg_dl.cfi;
+  return isrran_ue_dl_copy_estimate(&ue_dl, &host->ue_dl, &sf_cfg_dl);
+}
+
+bool cc_worker::work_dl_regular(const cc_worker* host)
 {
   bool dl_ack[ISRRAN_MAX_CODEWORDS] = {};
 
@@ -248,7 +259,7 @@ bool cc_worker::work_dl_regular()
     }
 
     /* Do FFT and extract PDCCH LLR, or quit if no actions are required in this subframe */
-    if (isrran_ue_dl_decode_fft_estimate(&ue_dl, &sf_cfg_dl, &ue_dl_cfg) < 0) {
+    if (decode_fft_estimate(host) < 0) {
       Error("Getting PDCCH FFT estimate");
       return false;
     }
@@ -318,7 +329,7 @@ bool cc_worker::work_dl_regular()
   return true;
 }
 
-bool cc_worker::work_dl_mbsfn(isrran_mbsfn_cfg_t mbsfn_cfg)
+bool cc_worker::work_dl_mbsfn(isrran_mbsfn_cfg_t mbsfn_cfg, const cc_worker* host)
 {
   mac_interface_phy_lte::tb_action_dl_t dl_action = {};
 
@@ -338,7 +349,7 @@ bool cc_worker::work_dl_mbsfn(isrran_mbsfn_cfg_t mbsfn_cfg)
   ue_dl_cfg.chest_cfg           = chest_mbsfn_cfg;
 
   /* Do FFT and extract PDCCH LLR, or quit if no actions are required in this subframe */
-  if (isrran_ue_dl_decode_fft_estimate(&ue_dl, &sf_cfg_dl, &ue_dl_cfg) < 0) {
+  if (decode_fft_estimate(host) < 0) {
     Error("Getting PDCCH FFT estimate");
     return false;
   }
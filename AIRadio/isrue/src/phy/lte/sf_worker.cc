@@ -23,6 +23,7 @@
 
 #include "isrran/common/standard_streams.h"
 #include "isrue/hdr/phy/lte/sf_worker.h"
+#include "isrue/hdr/phy/phy_guest.h"
 #include <string.h>
 
 #define Error(fmt, ...)                                                                                                \
@@ -157,39 +158,100 @@ void sf_worker::set_config_nolock(uint32_t cc_idx, const isrran::phy_cfg_t& phy_
 
 void sf_worker::work_imp()
 {
-  uint32_t            tti           = context.sf_idx;
   isrran::rf_buffer_t tx_signal_ptr = {};
   if (!cell_initiated) {
     phy->worker_end(context, false, tx_signal_ptr);
     return;
   }
 
-  bool     rx_signal_ok    = false;
-  bool     tx_signal_ready = false;
-  uint32_t nof_samples     = ISRRAN_SF_LEN_PRB(cell.nof_prb);
-
   /***** Downlink Processing *******/
+  bool rx_signal_ok = work_dl(nullptr);
+
+  // Guest UEs decode from the estimates of this worker while it generates its own uplink
+  run_guests();
+
+  /***** Uplink Generation + Transmission *******/
+  bool tx_signal_ready = work_ul(tx_signal_ptr);
+
+  // Wait for the guests and combine their uplink into a single signal
+  if (not phy->guests.empty()) {
+    std::unique_lock<std::mutex> lock(guest_mutex);
+    while (guest_pending > 0) {
+      guest_cvar.wait(lock);
+    }
+  }
+  for (phy_guest* guest : phy->guests) {
+    tx_signal_ready |= combine_guest_tx(guest->get_worker(get_id()), tx_signal_ptr);
+  }
+
+  // Call worker_end to transmit the signal
+  phy->worker_end(context, tx_signal_ready, tx_signal_ptr);
+
+  if (rx_signal_ok) {
+    update_measurements();
+  }
+
+  /* Tell the plotting thread to draw the plots */
+#ifdef ENABLE_GUI
+  if ((int)get_id() == plot_worker_id) {
+    sem_post(&plot_sem);
+  }
+#endif
+}
+
+bool sf_worker::work_dl(sf_worker* host_)
+{
+  uint32_t tti          = context.sf_idx;
+  bool     rx_signal_ok = false;
+
+  dl_mbsfn = false;
 
   // Loop through all carriers. carrier_idx=0 is PCell
   for (uint32_t carrier_idx = 0; carrier_idx < cc_workers.size(); carrier_idx++) {
+    dl_processed[carrier_idx] = false;
+
+    // A guest can only decode the carriers demodulated by its host
+    if (host_ != nullptr && not host_->dl_processed[carrier_idx]) {
+      continue;
+    }
+    const cc_worker* host_cc = (host_ != nullptr) ? host_->cc_workers[carrier_idx] : nullptr;
+
     // Process all DL and special subframes
     if (isrran_sfidx_tdd_type(tdd_config, tti % 10) != ISRRAN_TDD_SF_U || cell.frame_type == ISRRAN_FDD) {
       isrran_mbsfn_cfg_t mbsfn_cfg;
       ZERO_OBJECT(mbsfn_cfg);
 
       if (carrier_idx == 0 && phy->is_mbsfn_sf(&mbsfn_cfg, tti)) {
-        rx_signal_ok =
-            cc_workers[0]->work_dl_mbsfn(mbsfn_cfg); // Don't do chest_ok in mbsfn since it trigger measurements
+        if (host_ == nullptr || host_->dl_mbsfn) {
+          // Don't do chest_ok in mbsfn since it trigger measurements
+          rx_signal_ok    = cc_workers[0]->work_dl_mbsfn(mbsfn_cfg, host_cc);
+          dl_mbsfn        = true;
+          dl_processed[0] = true;
+        }
+      } else if (host_ != nullptr && carrier_idx == 0 && host_->dl_mbsfn) {
+        // The host estimated a MBSFN subframe, which this UE does not know about yet
+        continue;
       } else {
         if (phy->cell_state.is_configured(carrier_idx)) {
-          rx_signal_ok = cc_workers[carrier_idx]->work_dl_regular();
+          rx_signal_ok              = cc_workers[carrier_idx]->work_dl_regular(host_cc);
+          dl_processed[carrier_idx] = true;
         }
       }
     }
   }
-  tx_signal_ptr.set_nof_samples(nof_samples);
 
-  /***** Uplink Generation + Transmission *******/
+  return rx_signal_ok;
+}
+
+bool sf_worker::work_ul(isrran::rf_buffer_t& tx_signal_ptr)
+{
+  uint32_t tti             = context.sf_idx;
+  bool     tx_signal_ready = false;
+
+  tx_signal_ptr.set_nof_samples(ISRRAN_SF_LEN_PRB(cell.nof_prb));
+  for (bool& ready : tx_cc_ready) {
+    ready = false;
+  }
 
   /* If TTI+4 is an uplink subframe (TODO: Support short PRACH and ISR in UpPts special subframes) */
   if ((isrran_sfidx_tdd_type(tdd_config, TTI_TX(tti) % 10) == ISRRAN_TDD_SF_U) || cell.frame_type == ISRRAN_FDD) {
@@ -214,7 +276,8 @@ void sf_worker::work_imp()
       // Loop through all carriers
       for (uint32_t carrier_idx = 0; carrier_idx < phy->args->nof_lte_carriers; carrier_idx++) {
         if (phy->cell_state.is_active(carrier_idx, tti)) {
-          tx_signal_ready |= cc_workers[carrier_idx]->work_ul(uci_cc_idx == carrier_idx ? &uci_data : nullptr);
+          tx_cc_ready[carrier_idx] = cc_workers[carrier_idx]->work_ul(uci_cc_idx == carrier_idx ? &uci_data : nullptr);
+          tx_signal_ready |= tx_cc_ready[carrier_idx];
 
           // Set signal pointer based on offset
           tx_signal_ptr.set(carrier_idx, 0, phy->args->nof_rx_ant, cc_workers[carrier_idx]->get_tx_buffer(0));
@@ -226,23 +289,109 @@ void sf_worker::work_imp()
   // Set PRACH buffer signal pointer
   if (prach_ptr) {
     tx_signal_ready = true;
+    tx_cc_ready[0]  = true;
     tx_signal_ptr.set(0, prach_ptr);
     prach_ptr = nullptr;
   }
 
-  // Call worker_end to transmit the signal
-  phy->worker_end(context, tx_signal_ready, tx_signal_ptr);
+  return tx_signal_ready;
+}
+
+/********************* Shared PHY pipeline ****************************/
+
+void sf_worker::run_guests()
+{
+  if (phy->guests.empty()) {
+    return;
+  }
+
+  uint32_t worker_id = get_id();
+
+  // Without a pool the guests run sequentially in this thread
+  if (phy->guest_pool == nullptr) {
+    for (phy_guest* guest : phy->guests) {
+      guest->work(worker_id, this);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(guest_mutex);
+    guest_pending = phy->guests.size();
+  }
+  for (phy_guest* guest : phy->guests) {
+    phy->guest_pool->push_task([this, guest, worker_id]() {
+      guest->work(worker_id, this);
+
+      std::lock_guard<std::mutex> lock(guest_mutex);
+      guest_pending--;
+      if (guest_pending == 0) {
+        guest_cvar.notify_all();
+      }
+    });
+  }
+}
+
+void sf_worker::work_guest(sf_worker* host_)
+{
+  host           = host_;
+  guest_tx_ready = false;
+  for (bool& ready : tx_cc_ready) {
+    ready = false;
+  }
+
+  if (!cell_initiated) {
+    return;
+  }
+
+  bool rx_signal_ok = work_dl(host);
+  guest_tx_ready    = work_ul(guest_tx_signal);
 
   if (rx_signal_ok) {
     update_measurements();
   }
+}
 
-  /* Tell the plotting thread to draw the plots */
-#ifdef ENABLE_GUI
-  if ((int)get_id() == plot_worker_id) {
-    sem_post(&plot_sem);
+cf_t* sf_worker::get_guest_tx(uint32_t cc_idx) const
+{
+  if (not guest_tx_ready or cc_idx >= ISRRAN_MAX_CARRIERS or not tx_cc_ready[cc_idx]) {
+    return nullptr;
   }
-#endif
+  return guest_tx_signal.get(cc_idx, 0, phy->args->nof_rx_ant);
+}
+
+bool sf_worker::combine_guest_tx(sf_worker* guest, isrran::rf_buffer_t& tx_signal_ptr)
+{
+  bool     tx_signal_ready = false;
+  uint32_t nof_samples     = tx_signal_ptr.get_nof_samples();
+
+  if (guest == nullptr) {
+    return false;
+  }
+
+  for (uint32_t carrier_idx = 0; carrier_idx < phy->args->nof_lte_carriers; carrier_idx++) {
+    cf_t* guest_ptr = guest->get_guest_tx(carrier_idx);
+    if (guest_ptr == nullptr) {
+      continue;
+    }
+
+    cf_t* own_ptr     = cc_workers[carrier_idx]->get_tx_buffer(0);
+    cf_t* current_ptr = tx_signal_ptr.get(carrier_idx, 0, phy->args->nof_rx_ant);
+    if (tx_cc_ready[carrier_idx] && current_ptr == own_ptr) {
+      isrran_vec_sum_ccc(own_ptr, guest_ptr, own_ptr, nof_samples);
+    } else if (tx_cc_ready[carrier_idx] && current_ptr != nullptr) {
+      // The PRACH buffer is left untouched since it is transmitted again in later subframes
+      isrran_vec_sum_ccc(current_ptr, guest_ptr, own_ptr, nof_samples);
+    } else {
+      isrran_vec_cf_copy(own_ptr, guest_ptr, nof_samples);
+    }
+
+    tx_signal_ptr.set(carrier_idx, 0, phy->args->nof_rx_ant, own_ptr);
+    tx_cc_ready[carrier_idx] = true;
+    tx_signal_ready          = true;
+  }
+
+  return tx_signal_ready;
 }
 
 /********************* Uplink common control functions ****************************/
@@ -259,9 +408,10 @@ void sf_worker::update_measurements()
   std::vector<phy_meas_t> serving_cells = {};
   for (uint32_t cc_idx = 0; cc_idx < cc_workers.size(); cc_idx++) {
     cf_t* rssi_power_buffer = nullptr;
-    // Setting rssi_power_buffer to nullptr disables RSSI update. Do it only by worker 0
-    if (cc_idx == 0 && get_id() == 0) {
-      rssi_power_buffer = cc_workers[0]->get_rx_buffer(0);
+    // Setting rssi_power_buffer to nullptr disables RSSI update. Do it only by worker 0, guests use the host signal
+    sf_worker* rx_worker = (host != nullptr) ? host : this;
+    if (cc_idx == 0 && rx_worker->get_id() == 0) {
+      rssi_power_buffer = rx_worker->cc_workers[0]->get_rx_buffer(0);
     }
     cc_workers[cc_idx]->update_measurements(serving_cells, rssi_power_buffer);
   }
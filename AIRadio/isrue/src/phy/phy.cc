@@ -176,6 +176,9 @@ void phy::stop()
     lte_workers.stop();
     nr_workers.stop();
     prach_buffer.stop();
+    if (guest_pool != nullptr) {
+      guest_pool->stop();
+    }
     wait_thread_finish();
 
     is_configured = false;
@@ -459,6 +462,24 @@ void phy::start_plot()
   }
 }
 
+void phy::add_guest(phy_guest* guest)
+{
+  std::unique_lock<std::mutex> lock(config_mutex);
+
+  // Without threads the guests are run sequentially by the LTE workers
+  if (guest_pool == nullptr && args.nof_ue_threads > 0) {
+    guest_pool.reset(
+        new isrran::task_thread_pool(args.nof_ue_threads, false, WORKERS_THREAD_PRIO, args.worker_cpu_mask));
+    common.guest_pool = guest_pool.get();
+  }
+  common.guests.push_back(guest);
+}
+
+void phy::get_current_cell(isrran_cell_t* cell, uint32_t* earfcn)
+{
+  sfsync.get_current_cell(cell, earfcn);
+}
+
 bool phy::set_config(const isrran::phy_cfg_t& config_, uint32_t cc_idx)
 {
   if (!is_initialized()) {
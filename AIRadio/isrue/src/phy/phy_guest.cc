@@ -0,0 +1,454 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrue/hdr/phy/phy_guest.h"
+#include "isrran/common/standard_streams.h"
+#include "isrue/hdr/phy/phy.h"
+#include <chrono>
+#include <thread>
+
+#define Error(fmt, ...)                                                                                                \
+  if (ISRRAN_DEBUG_ENABLED)                                                                                            \
+  logger.error(fmt, ##__VA_ARGS__)
+#define Warning(fmt, ...)                                                                                              \
+  if (ISRRAN_DEBUG_ENABLED)                                                                                            \
+  logger.warning(fmt, ##__VA_ARGS__)
+#define Info(fmt, ...)                                                                                                 \
+  if (ISRRAN_DEBUG_ENABLED)                                                                                            \
+  logger.info(fmt, ##__VA_ARGS__)
+#define Debug(fmt, ...)                                                                                                \
+  if (ISRRAN_DEBUG_ENABLED)                                                                                            \
+  logger.debug(fmt, ##__VA_ARGS__)
+
+namespace isrue {
+
+phy_guest::phy_guest(uint32_t ue_idx) :
+  logger(isrlog::fetch_basic_logger(fmt::format("PHY-UE{}", ue_idx))), common(logger), prach_buffer(logger)
+{}
+
+int phy_guest::init(const phy_args_t&            args_,
+                    stack_interface_phy_lte*     stack_,
+                    phy*                         host_,
+                    isrran::radio_interface_phy* radio_)
+{
+  if (host_ == nullptr || stack_ == nullptr) {
+    return ISRRAN_ERROR_INVALID_INPUTS;
+  }
+
+  args  = args_;
+  stack = stack_;
+  host  = host_;
+  radio = radio_;
+
+  // The UL channel is emulated once by the host over the combined signal
+  args.ul_channel_args.enable = false;
+
+  if (args.nof_phy_threads > MAX_WORKERS) {
+    isrran::console("Error in PHY args: nof_phy_threads must be 1, 2 or 3\n");
+    return ISRRAN_ERROR;
+  }
+
+  logger.set_level(isrlog::str_to_basic_level(args.log.phy_level));
+  logger.set_hex_dump_max_size(args.log.phy_hex_limit);
+
+  prach_buffer.init(ISRRAN_MAX_PRB);
+  common.init(&args, radio, stack, this);
+
+  // The workers have no thread, they are executed by the host workers with the same index
+  for (uint32_t i = 0; i < args.nof_phy_threads; i++) {
+    workers.push_back(std::unique_ptr<lte::sf_worker>(new lte::sf_worker(ISRRAN_MAX_PRB, &common, logger)));
+  }
+
+  initiated = true;
+  return ISRRAN_SUCCESS;
+}
+
+void phy_guest::stop()
+{
+  cmd_worker.stop();
+  cmd_worker_cell.stop();
+  if (initiated) {
+    prach_buffer.stop();
+    initiated = false;
+  }
+}
+
+/********** Host interface ********************/
+
+void phy_guest::set_context(uint32_t worker_id, const isrran::phy_common_interface::worker_context_t& ctx, float cfo)
+{
+  if (worker_id >= workers.size()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(worker_mutex[worker_id]);
+  lte::sf_worker*             w   = workers[worker_id].get();
+  uint32_t                    tti = ctx.sf_idx;
+
+  // Check if we need to TX a PRACH
+  if (prach_ptr == nullptr && prach_buffer.is_ready_to_send(tti, selected_cell.id)) {
+    prach_ptr = prach_buffer.generate(cfo, &prach_nof_sf, &prach_power);
+    if (prach_ptr == nullptr) {
+      Error("Generating PRACH");
+    }
+  }
+  w->set_prach(prach_ptr ? &prach_ptr[prach_sf_cnt * ISRRAN_SF_LEN_PRB(selected_cell.nof_prb)] : nullptr, prach_power);
+
+  // Advance/reset prach subframe pointer
+  if (prach_ptr) {
+    prach_sf_cnt++;
+    if (prach_sf_cnt == prach_nof_sf) {
+      prach_sf_cnt = 0;
+      prach_ptr    = nullptr;
+    }
+  }
+
+  // Execute Serving Cell state FSM
+  common.cell_state.run_tti(tti);
+
+  // The CFO is common to all the UEs since they share the radio
+  for (uint32_t cc = 0; cc < args.nof_lte_carriers; cc++) {
+    w->set_cfo_nolock(cc, cfo);
+  }
+
+  w->set_context(ctx);
+}
+
+void phy_guest::work(uint32_t worker_id, lte::sf_worker* host_worker)
+{
+  if (worker_id >= workers.size()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(worker_mutex[worker_id]);
+  workers[worker_id]->work_guest(host_worker);
+}
+
+lte::sf_worker* phy_guest::get_worker(uint32_t worker_id)
+{
+  if (worker_id >= workers.size()) {
+    return nullptr;
+  }
+  return workers[worker_id].get();
+}
+
+void phy_guest::run_stack_tti(uint32_t tti, int32_t tti_jump)
+{
+  stack->run_tti(tti, tti_jump);
+}
+
+/********** RRC interface ********************/
+
+bool phy_guest::cell_search(int earfcn)
+{
+  camping = false;
+  cmd_worker_cell.add_cmd([this, earfcn]() {
+    rrc_interface_phy_lte::cell_search_ret_t ret        = {};
+    phy_cell_t                               found_cell = {};
+    ret.found     = rrc_interface_phy_lte::cell_search_ret_t::CELL_NOT_FOUND;
+    ret.last_freq = rrc_interface_phy_lte::cell_search_ret_t::NO_MORE_FREQS;
+
+    // There is no receiver of its own, the host finds the cell for all the UEs
+    for (uint32_t i = 0; i < CELL_SEARCH_TIMEOUT_MS && not host->cell_is_camping(); i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    isrran_cell_t cell        = {};
+    uint32_t      host_earfcn = 0;
+    host->get_current_cell(&cell, &host_earfcn);
+    if (host->cell_is_camping() && (earfcn < 0 || (uint32_t)earfcn == host_earfcn)) {
+      // Deliver the MIB of the host cell as if it had been decoded
+      std::array<uint8_t, ISRRAN_BCH_PAYLOAD_LEN>     mib        = {};
+      std::array<uint8_t, ISRRAN_BCH_PAYLOAD_LEN / 8> mib_packed = {};
+      isrran_pbch_mib_pack(&cell, host->get_current_tti() / 10, mib.data());
+      isrran_bit_pack_vector(mib.data(), mib_packed.data(), ISRRAN_BCH_PAYLOAD_LEN);
+      stack->bch_decoded_ok(0, mib_packed.data(), mib_packed.size());
+
+      found_cell.pci    = cell.id;
+      found_cell.earfcn = host_earfcn;
+      ret.found         = rrc_interface_phy_lte::cell_search_ret_t::CELL_FOUND;
+      logger.info("Cell Search: Found host cell with PCI=%d with %d PRB", cell.id, cell.nof_prb);
+    } else {
+      logger.info("Cell Search: Host is not camping on EARFCN=%d", earfcn);
+    }
+
+    stack->cell_search_complete(ret, found_cell);
+  });
+  return true;
+}
+
+bool phy_guest::cell_select(phy_cell_t cell)
+{
+  camping = false;
+
+  // Indicate workers that cell selection is in progress
+  common.cell_is_selecting = true;
+
+  cmd_worker_cell.add_cmd([this, cell]() {
+    bool ret = false;
+
+    for (uint32_t i = 0; i < CELL_SEARCH_TIMEOUT_MS && not host->cell_is_camping(); i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    isrran_cell_t host_cell   = {};
+    uint32_t      host_earfcn = 0;
+    host->get_current_cell(&host_cell, &host_earfcn);
+    if (host->cell_is_camping() && host_cell.id == cell.pci && host_earfcn == cell.earfcn) {
+      // Flush any PHY state including measurements, pending ACKs and pending grants
+      reset();
+      common.set_cell(host_cell);
+
+      ret = true;
+      for (uint32_t i = 0; i < workers.size(); i++) {
+        std::lock_guard<std::mutex> lock(worker_mutex[i]);
+        workers[i]->reset_cell_nolock(0);
+        ret &= workers[i]->set_cell_nolock(0, host_cell);
+        workers[i]->set_tdd_config_nolock(tdd_config);
+      }
+
+      selected_cell = host_cell;
+      configure_prach_params();
+    } else {
+      logger.warning("Cell Select: Host is not camping on PCI=%d, EARFCN=%d", cell.pci, cell.earfcn);
+    }
+
+    camping = ret;
+    stack->cell_select_complete(ret);
+
+    // Indicate workers that cell selection has finished
+    common.cell_is_selecting = false;
+  });
+  return true;
+}
+
+bool phy_guest::cell_is_camping()
+{
+  return camping && host->cell_is_camping();
+}
+
+bool phy_guest::set_config(const isrran::phy_cfg_t& config, uint32_t cc_idx)
+{
+  if (!initiated) {
+    fprintf(stderr, "Error calling set_config(): PHY not initialized\n");
+    return false;
+  }
+
+  if (cc_idx >= args.nof_lte_carriers) {
+    isrran::console("Received SCell configuration for index %d but there are not enough CC workers available\n",
+                    cc_idx);
+    return true;
+  }
+
+  // Apply configurations asynchronously to avoid race conditions
+  cmd_worker.add_cmd([this, config, cc_idx]() {
+    if (!cc_idx && config.prach_cfg_present) {
+      prach_cfg            = config.prach_cfg;
+      prach_cfg.tdd_config = tdd_config;
+    }
+
+    logger.info("Setting new PHY configuration cc_idx=%d...", cc_idx);
+    for (uint32_t i = 0; i < workers.size(); i++) {
+      std::lock_guard<std::mutex> lock(worker_mutex[i]);
+      workers[i]->set_config_nolock(cc_idx, config);
+    }
+
+    configure_prach_params();
+    stack->set_config_complete(true);
+  });
+  return true;
+}
+
+bool phy_guest::set_scell(isrran_cell_t cell_info, uint32_t cc_idx, uint32_t earfcn)
+{
+  if (cc_idx == 0 || cc_idx >= args.nof_lte_carriers || !isrran_cell_isvalid(&cell_info)) {
+    logger.error("Received invalid SCell configuration for cc_idx=%d", cc_idx);
+    return false;
+  }
+
+  // Prevents this component carrier from executing any new PHY processing
+  common.cell_state.reset(cc_idx);
+
+  // The carrier is decoded only while the host has it configured, no radio retuning is done here
+  cmd_worker.add_cmd([this, cell_info, cc_idx, earfcn]() {
+    logger.info("Setting new SCell configuration cc_idx=%d, earfcn=%d, pci=%d...", cc_idx, earfcn, cell_info.id);
+    for (uint32_t i = 0; i < workers.size(); i++) {
+      std::lock_guard<std::mutex> lock(worker_mutex[i]);
+      workers[i]->reset_cell_nolock(cc_idx);
+      workers[i]->set_cell_nolock(cc_idx, cell_info);
+    }
+
+    common.reset_measurements(cc_idx);
+    common.cell_state.configure(cc_idx, earfcn, cell_info.id);
+    stack->set_scell_complete(true);
+  });
+  return true;
+}
+
+void phy_guest::set_config_tdd(isrran_tdd_config_t& tdd_config_)
+{
+  tdd_config            = tdd_config_;
+  tdd_config.configured = true;
+
+  cmd_worker.add_cmd([this]() {
+    for (uint32_t i = 0; i < workers.size(); i++) {
+      std::lock_guard<std::mutex> lock(worker_mutex[i]);
+      workers[i]->set_tdd_config_nolock(tdd_config);
+    }
+  });
+}
+
+void phy_guest::set_config_mbsfn_sib2(isrran::mbsfn_sf_cfg_t* cfg_list, uint32_t nof_cfgs)
+{
+  if (nof_cfgs > 0) {
+    common.mbsfn_config.mbsfn_subfr_cnfg = cfg_list[0];
+    common.build_mch_table();
+  }
+}
+
+void phy_guest::set_config_mbsfn_sib13(const isrran::sib13_t& sib13)
+{
+  common.mbsfn_config.mbsfn_notification_cnfg = sib13.notif_cfg;
+  if (sib13.nof_mbsfn_area_info > 0) {
+    common.mbsfn_config.mbsfn_area_info = sib13.mbsfn_area_info_list[0];
+    common.build_mcch_table();
+  }
+}
+
+void phy_guest::set_config_mbsfn_mcch(const isrran::mcch_msg_t& mcch)
+{
+  common.mbsfn_config.mcch = mcch;
+  stack->set_mbsfn_config(common.mbsfn_config.mcch.pmch_info_list[0].nof_mbms_session_info);
+  common.set_mch_period_stop(common.mbsfn_config.mcch.pmch_info_list[0].sf_alloc_end);
+  common.set_mcch();
+}
+
+void phy_guest::deactivate_scells()
+{
+  common.cell_state.deactivate_all();
+}
+
+/********** MAC interface ********************/
+
+void phy_guest::prach_send(uint32_t preamble_idx, int allowed_subframe, float target_power_dbm, float ta_base_sec)
+{
+  common.ta.set_base_sec(ta_base_sec);
+  if (!prach_buffer.prepare_to_send(preamble_idx, allowed_subframe, target_power_dbm)) {
+    Error("Preparing PRACH to send");
+  }
+}
+
+phy_interface_mac_lte::prach_info_t phy_guest::prach_get_info()
+{
+  return prach_buffer.get_info();
+}
+
+void phy_guest::sr_send()
+{
+  common.sr.trigger();
+  Debug("SR is triggered");
+}
+
+int phy_guest::sr_last_tx_tti()
+{
+  return common.sr.get_last_tx_tti();
+}
+
+void phy_guest::set_mch_period_stop(uint32_t stop)
+{
+  common.set_mch_period_stop(stop);
+}
+
+// The commands are tracked for the metrics but the transmission follows the host timing
+void phy_guest::set_timeadv_rar(uint32_t tti, uint32_t ta_cmd)
+{
+  common.ta.add_ta_cmd_rar(tti, ta_cmd);
+}
+
+void phy_guest::set_timeadv(uint32_t tti, uint32_t ta_cmd)
+{
+  common.ta.add_ta_cmd_new(tti, ta_cmd);
+}
+
+void phy_guest::set_activation_deactivation_scell(uint32_t cmd, uint32_t tti)
+{
+  common.cell_state.set_activation_deactivation(cmd, tti);
+}
+
+void phy_guest::set_rar_grant(uint8_t grant_payload[ISRRAN_RAR_GRANT_LEN], uint16_t rnti)
+{
+  common.set_rar_grant(grant_payload, rnti, tdd_config);
+}
+
+uint32_t phy_guest::get_current_tti()
+{
+  return host->get_current_tti();
+}
+
+float phy_guest::get_phr()
+{
+  return radio->get_info()->max_tx_gain - common.get_pusch_power();
+}
+
+float phy_guest::get_pathloss_db()
+{
+  return common.get_pathloss();
+}
+
+/********** Worker feedback ********************/
+
+void phy_guest::in_sync()
+{
+  in_sync_cnt++;
+  if (in_sync_cnt == args.nof_in_sync_events) {
+    stack->in_sync();
+    in_sync_cnt     = 0;
+    out_of_sync_cnt = 0;
+  }
+}
+
+void phy_guest::out_of_sync()
+{
+  out_of_sync_cnt++;
+  if (out_of_sync_cnt == args.nof_out_of_sync_events) {
+    stack->out_of_sync();
+    out_of_sync_cnt = 0;
+    in_sync_cnt     = 0;
+  }
+}
+
+/********** Private ********************/
+
+void phy_guest::configure_prach_params()
+{
+  if (!prach_buffer.set_cell(selected_cell, prach_cfg)) {
+    Error("Configuring PRACH parameters");
+  }
+}
+
+void phy_guest::reset()
+{
+  Info("Resetting PHY...");
+  common.ta.set_base_sec(0);
+  common.reset();
+}
+
+} // namespace isrue
@@ -24,6 +24,7 @@
 #include "isrran/phy/channel/channel.h"
 #include "isrran/isrran.h"
 #include "isrue/hdr/phy/lte/sf_worker.h"
+#include "isrue/hdr/phy/phy_guest.h"
 
 #include <algorithm>
 #include <unistd.h>
@@ -582,6 +583,11 @@ void sync::run_camping_in_sync_state(lte::sf_worker*      lte_worker,
 
     lte_worker->set_context(context);
 
+    // The guest UEs run within this worker, prepare them for the same subframe
+    for (phy_guest* guest : worker_com->guests) {
+      guest->set_context(lte_worker->get_id(), context, get_tx_cfo());
+    }
+
     // NR worker needs to be launched first, phy_common::worker_end expects first the NR worker and the LTE worker.
     worker_com->semaphore.push(lte_worker);
     lte_worker_pool->start_worker(lte_worker);
@@ -1054,6 +1060,9 @@ void sync::run_stack_tti()
     // Run stack
     Debug("run_stack_tti: calling stack tti=%d, tti_jump=%d", tti, tti_jump);
     stack->run_tti(tti, tti_jump);
+    for (phy_guest* guest : worker_com->guests) {
+      guest->run_stack_tti(tti, tti_jump);
+    }
     Debug("run_stack_tti: stack called");
   }
 
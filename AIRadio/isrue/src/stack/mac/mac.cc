@@ -52,7 +52,6 @@ mac::mac(const char* logname, ext_task_sched_handle task_sched_) :
   isrran_softbuffer_rx_init(&pch_softbuffer, 100);
 
   // Keep initialising members
-  bzero(&metrics, sizeof(mac_metrics_t));
   clear_rntis();
 }
 
@@ -153,11 +152,6 @@ void mac::reconfiguration(const uint32_t& cc_idx, const bool& enable)
 // Implement Section 5.9
 void mac::reset()
 {
-  {
-    std::lock_guard<std::mutex> lock(metrics_mutex);
-    bzero(&metrics, sizeof(mac_metrics_t));
-  }
-
   Info("Resetting MAC");
 
   timer_alignment.stop();
@@ -211,9 +205,8 @@ void mac::run_tti(const uint32_t tti)
   ra_procedure.update_rar_window(ra_window);
 
   // Count TTI for metrics
-  std::lock_guard<std::mutex> lock(metrics_mutex);
   for (uint32_t i = 0; i < ISRRAN_MAX_CARRIERS; i++) {
-    metrics[i].nof_tti++;
+    metrics_counters[i].add(mac_counter::nof_tti);
   }
 }
 
@@ -357,14 +350,11 @@ void mac::mch_decoded(uint32_t len, bool crc, uint8_t* payload)
       pcap->write_dl_mch(payload, len, true, phy_h->get_current_tti(), 0);
     }
 
-    std::lock_guard<std::mutex> lock(metrics_mutex);
-    metrics[0].rx_brate += len * 8;
+    metrics_counters[0].add(mac_counter::rx_bits, len * 8);
   } else {
-    std::lock_guard<std::mutex> lock(metrics_mutex);
-    metrics[0].rx_errors++;
+    metrics_counters[0].add(mac_counter::rx_errors);
   }
-  std::lock_guard<std::mutex> lock(metrics_mutex);
-  metrics[0].rx_pkts++;
+  metrics_counters[0].add(mac_counter::rx_pkts);
 }
 
 void mac::tb_decoded(uint32_t cc_idx, mac_grant_dl_t grant, bool ack[ISRRAN_MAX_CODEWORDS])
@@ -407,15 +397,14 @@ void mac::tb_decoded(uint32_t cc_idx, mac_grant_dl_t grant, bool ack[ISRRAN_MAX_
     process_pdus();
 
     {
-      std::lock_guard<std::mutex> lock(metrics_mutex);
       for (uint32_t tb = 0; tb < ISRRAN_MAX_CODEWORDS; tb++) {
         if (grant.tb[tb].tbs) {
           if (ack[tb]) {
-            metrics[cc_idx].rx_brate += grant.tb[tb].tbs * 8;
+            metrics_counters[cc_idx].add(mac_counter::rx_bits, grant.tb[tb].tbs * 8);
           } else {
-            metrics[cc_idx].rx_errors++;
+            metrics_counters[cc_idx].add(mac_counter::rx_errors);
           }
-          metrics[cc_idx].rx_pkts++;
+          metrics_counters[cc_idx].add(mac_counter::rx_pkts);
         }
       }
     }
@@ -514,18 +503,15 @@ void mac::new_grant_ul(uint32_t                               cc_idx,
 
   ul_harq.at(cc_idx)->new_grant_ul(grant, action);
 
-  {
-    std::lock_guard<std::mutex> lock(metrics_mutex);
-    metrics[cc_idx].tx_pkts++;
+  metrics_counters[cc_idx].add(mac_counter::tx_pkts);
 
-    if (grant.phich_available) {
-      if (!grant.hi_value) {
-        metrics[cc_idx].tx_errors++;
-      } else {
-        metrics[cc_idx].tx_brate += ul_harq.at(cc_idx)->get_current_tbs(grant.pid) * 8;
-      }
+  if (grant.phich_available) {
+    if (!grant.hi_value) {
+      metrics_counters[cc_idx].add(mac_counter::tx_errors);
+    } else {
+      metrics_counters[cc_idx].add(mac_counter::tx_bits, ul_harq.at(cc_idx)->get_current_tbs(grant.pid) * 8);
     }
-  } // end of holding metrics mutex
+  }
 }
 
 
@@ -639,7 +625,17 @@ void mac::mch_start_rx(uint32_t lcid)
 
 void mac::get_metrics(mac_metrics_t m[ISRRAN_MAX_CARRIERS])
 {
-  std::lock_guard<std::mutex> lock(metrics_mutex);
+  mac_metrics_t metrics[ISRRAN_MAX_CARRIERS] = {};
+  for (uint32_t r = 0; r < ISRRAN_MAX_CARRIERS; r++) {
+    metrics_readers[r].update(metrics_counters[r]);
+    metrics[r].nof_tti   = metrics_readers[r].get(mac_counter::nof_tti);
+    metrics[r].tx_pkts   = metrics_readers[r].get(mac_counter::tx_pkts);
+    metrics[r].tx_errors = metrics_readers[r].get(mac_counter::tx_errors);
+    metrics[r].tx_brate  = metrics_readers[r].get(mac_counter::tx_bits);
+    metrics[r].rx_pkts   = metrics_readers[r].get(mac_counter::rx_pkts);
+    metrics[r].rx_errors = metrics_readers[r].get(mac_counter::rx_errors);
+    metrics[r].rx_brate  = metrics_readers[r].get(mac_counter::rx_bits);
+  }
 
   int   tx_pkts          = 0;
   int   tx_errors        = 0;
@@ -678,8 +674,6 @@ void mac::get_metrics(mac_metrics_t m[ISRRAN_MAX_CARRIERS])
 
   metrics[PCELL_CC_IDX].ul_buffer = (int)bsr_procedure.get_buffer_state();
   memcpy(m, metrics, sizeof(mac_metrics_t) * ISRRAN_MAX_CARRIERS);
-  m = metrics;
-  bzero(&metrics, sizeof(mac_metrics_t) * ISRRAN_MAX_CARRIERS);
 }
 
 } // namespace isrue
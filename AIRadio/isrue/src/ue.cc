@@ -28,10 +28,12 @@
 #include "isrran/isrran.h"
 #include "isrue/hdr/phy/dummy_phy.h"
 #include "isrue/hdr/phy/phy.h"
+#include "isrue/hdr/phy/phy_guest.h"
 #include "isrue/hdr/phy/phy_nr_sa.h"
 #include "isrue/hdr/stack/ue_stack_lte.h"
 #include "isrue/hdr/stack/ue_stack_nr.h"
 #include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <string>
 
@@ -47,6 +49,7 @@ ue::ue() : logger(isrlog::fetch_basic_logger("UE", false)), sys_proc(logger)
 
 ue::~ue()
 {
+  guests.clear();
   stack.reset();
 }
 
@@ -153,6 +156,10 @@ int ue::init(const all_args_t& args_)
       isrran::console("Error initializing stack.\n");
       ret = ISRRAN_ERROR;
     }
+    if (init_guests(lte_phy.get(), lte_radio.get())) {
+      isrran::console("Error initializing additional UEs.\n");
+      ret = ISRRAN_ERROR;
+    }
     phy = std::move(lte_phy);
   }
 
@@ -174,12 +181,96 @@ int ue::init(const all_args_t& args_)
   return ret;
 }
 
+// Adds an offset to a string of digits, like an IMSI, keeping its length
+static std::string add_to_digits(const std::string& digits, uint32_t offset)
+{
+  std::string ret   = digits;
+  uint32_t    carry = offset;
+  for (auto it = ret.rbegin(); it != ret.rend() && carry > 0; ++it) {
+    if (not std::isdigit(*it)) {
+      return digits;
+    }
+    uint32_t d = (uint32_t)(*it - '0') + carry;
+    *it        = (char)('0' + d % 10);
+    carry      = d / 10;
+  }
+  return ret;
+}
+
+// Inserts the UE index before the file extension
+static std::string add_filename_suffix(const std::string& filename, uint32_t ue_idx)
+{
+  std::string suffix = "_" + std::to_string(ue_idx);
+  size_t      dot    = filename.find_last_of('.');
+  size_t      slash  = filename.find_last_of('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return filename + suffix;
+  }
+  return filename.substr(0, dot) + suffix + filename.substr(dot);
+}
+
+int ue::init_guests(isrue::phy* host, isrran::radio* host_radio)
+{
+  int ret = ISRRAN_SUCCESS;
+
+  for (uint32_t i = 1; i < args.multi_ue.nof_ues; i++) {
+    // Each UE needs its own identity, TUN device and capture files
+    stack_args_t stack_args                   = args.stack;
+    stack_args.usim.imsi                      = add_to_digits(args.stack.usim.imsi, i);
+    stack_args.usim.imei                      = add_to_digits(args.stack.usim.imei, i);
+    stack_args.pkt_trace.mac_pcap.filename    = add_filename_suffix(args.stack.pkt_trace.mac_pcap.filename, i);
+    stack_args.pkt_trace.nas_pcap.filename    = add_filename_suffix(args.stack.pkt_trace.nas_pcap.filename, i);
+    stack_args.pkt_trace.mac_nr_pcap.filename = add_filename_suffix(args.stack.pkt_trace.mac_nr_pcap.filename, i);
+
+    gw_args_t gw_args = args.gw;
+    gw_args.tun_dev_name += "_" + std::to_string(i);
+    if (not gw_args.netns.empty()) {
+      gw_args.netns += "_" + std::to_string(i);
+    }
+
+    guest_ue_t                    guest = {};
+    std::unique_ptr<ue_stack_lte> guest_stack(new ue_stack_lte);
+    guest.phy     = std::unique_ptr<phy_guest>(new phy_guest(i));
+    guest.gw_inst = std::unique_ptr<gw>(new gw(isrlog::fetch_basic_logger(fmt::format("GW{}", i), false)));
+
+    // from here onwards do not exit immediately if something goes wrong as sub-layers may already use interfaces
+    if (guest.phy->init(args.phy, guest_stack.get(), host, host_radio)) {
+      isrran::console("Error initializing PHY of UE %d.\n", i);
+      ret = ISRRAN_ERROR;
+    }
+    if (guest_stack->init(stack_args, guest.phy.get(), guest.gw_inst.get())) {
+      isrran::console("Error initializing stack of UE %d.\n", i);
+      ret = ISRRAN_ERROR;
+    }
+    if (guest.gw_inst->init(gw_args, guest_stack.get())) {
+      isrran::console("Error initializing GW of UE %d.\n", i);
+      ret = ISRRAN_ERROR;
+    }
+    host->add_guest(guest.phy.get());
+
+    guest.stack = std::move(guest_stack);
+    guests.push_back(std::move(guest));
+    logger.info("Added UE %d with IMSI %s", i, stack_args.usim.imsi.c_str());
+  }
+
+  return ret;
+}
+
 int ue::parse_args(const all_args_t& args_)
 {
   // set member variable
   args = args_;
 
   // carry out basic sanity checks
+  if (args.multi_ue.nof_ues == 0) {
+    args.multi_ue.nof_ues = 1;
+  }
+  if (args.multi_ue.nof_ues > 1 && args.phy.nof_nr_carriers > 0) {
+    logger.error("nof_ues = %d, Simulating several UEs is only supported with LTE carriers", args.multi_ue.nof_ues);
+    isrran::console("Error: simulating several UEs is only supported with LTE carriers\n");
+    return ISRRAN_ERROR;
+  }
+
   if (args.stack.rrc.mbms_service_id > -1) {
     if (!args.phy.interpolate_subframe_enabled) {
       logger.error("interpolate_subframe_enabled = %d, While using MBMS, "
@@ -329,14 +420,24 @@ void ue::stop()
   if (stack) {
     stack->stop();
   }
+  for (auto& guest : guests) {
+    guest.stack->stop();
+  }
 
   if (gw_inst) {
     gw_inst->stop();
   }
+  for (auto& guest : guests) {
+    guest.gw_inst->stop();
+  }
 
+  // The guests run within the host PHY, stop it first
   if (phy) {
     phy->stop();
   }
+  for (auto& guest : guests) {
+    guest.phy->stop();
+  }
 
   if (radio) {
     radio->stop();
@@ -345,7 +446,11 @@ void ue::stop()
 
 bool ue::switch_on()
 {
-  return stack->switch_on();
+  bool ret = stack->switch_on();
+  for (auto& guest : guests) {
+    ret &= guest.stack->switch_on();
+  }
+  return ret;
 }
 
 bool ue::switch_off()
@@ -354,6 +459,11 @@ bool ue::switch_off()
     gw_inst->stop();
   }
 
+  for (auto& guest : guests) {
+    guest.gw_inst->stop();
+    guest.stack->switch_off();
+  }
+
   // send switch off
   stack->switch_off();
 
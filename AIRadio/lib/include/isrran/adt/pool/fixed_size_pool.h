@@ -24,6 +24,7 @@
 
 #include "memblock_cache.h"
 #include "isrran/adt/circular_buffer.h"
+#include "isrran/common/numa.h"
 #include <thread>
 
 namespace isrran {
@@ -36,6 +37,9 @@ namespace isrran {
  * Since there is no stealing of blocks between workers, it is possible that a worker can't allocate while another
  * worker still has blocks in its own cache. To minimize the impact of this event, an upper bound is place on a worker
  * thread cache size. Once a worker reaches that upper bound, it sends half of its stored blocks to the central cache.
+ * If NUMA nodes are set for the memory pools (see numa::set_memory_nodes()), the blocks are split among the nodes,
+ * each node with its own central cache. A worker refills its cache from the node it runs on, and only falls back to
+ * the other nodes when the local one is depleted. Blocks are always returned to the central cache of their node.
  * Note: Taking into account the usage of thread_local, this class is made a singleton
  * Note2: No considerations were made regarding false sharing between threads. It is assumed that the blocks are big
  *        enough to fill a cache line.
@@ -53,20 +57,30 @@ class concurrent_fixed_memory_pool
   };
 
   const static size_t batch_steal_size = 16;
+  const static size_t max_arenas       = 8;
 
   // ctor only accessible from singleton get_instance()
-  explicit concurrent_fixed_memory_pool(size_t nof_objects_)
+  explicit concurrent_fixed_memory_pool(size_t nof_objects_) : nof_objects(nof_objects_)
   {
     isrran_assert(nof_objects_ > batch_steal_size, "A positive pool size must be provided");
 
-    std::lock_guard<std::mutex> lock(mutex);
-    allocated_blocks.resize(nof_objects_);
-    for (std::unique_ptr<obj_storage_t>& b : allocated_blocks) {
-      b.reset(new obj_storage_t());
-      isrran_assert(b.get() != nullptr, "Failed to instantiate fixed memory pool");
-      central_mem_cache.push(static_cast<void*>(b.get()));
+    // One arena of contiguous blocks per NUMA node, or a single arena if the pool is not NUMA aware
+    std::vector<uint32_t> nodes      = numa::get_memory_nodes();
+    size_t                nof_arenas = std::max<size_t>(1, std::min<size_t>(nodes.size(), (size_t)max_arenas));
+    for (size_t i = 0; i < nof_arenas; ++i) {
+      size_t                   nof_arena_objs = nof_objects_ / nof_arenas + (i < nof_objects_ % nof_arenas ? 1 : 0);
+      size_t                   len            = nof_arena_objs * sizeof(obj_storage_t);
+      std::unique_ptr<arena_t> arena(new arena_t());
+      arena->node  = nodes.empty() ? -1 : (int)nodes[i];
+      arena->begin = static_cast<uint8_t*>(numa::alloc_on_node(len, arena->node));
+      isrran_assert(arena->begin != nullptr, "Failed to instantiate fixed memory pool");
+      arena->end = arena->begin + len;
+      for (uint8_t* b = arena->begin; b < arena->end; b += sizeof(obj_storage_t)) {
+        arena->central_mem_cache.push(static_cast<void*>(new (b) obj_storage_t()));
+      }
+      arenas.push_back(std::move(arena));
     }
-    local_growth_thres = allocated_blocks.size() / 16;
+    local_growth_thres = nof_objects / 16;
     local_growth_thres = local_growth_thres < batch_steal_size ? batch_steal_size : local_growth_thres;
   }
 
@@ -80,8 +94,11 @@ public:
 
   ~concurrent_fixed_memory_pool()
   {
-    std::lock_guard<std::mutex> lock(mutex);
-    allocated_blocks.clear();
+    for (std::unique_ptr<arena_t>& arena : arenas) {
+      arena->central_mem_cache.clear();
+      numa::free_on_node(arena->begin, arena->end - arena->begin);
+    }
+    arenas.clear();
   }
 
   static concurrent_fixed_memory_pool<ObjSize, DebugSanitizeAddress>* get_instance(size_t size = 4096)
@@ -90,7 +107,7 @@ public:
     return &pool;
   }
 
-  size_t size() { return allocated_blocks.size(); }
+  size_t size() { return nof_objects; }
 
   void* allocate_node(size_t sz)
   {
@@ -99,9 +116,12 @@ public:
 
     void* node = worker_ctxt->cache.try_pop();
     if (node == nullptr) {
-      // fill the thread local cache enough for this and next allocations
+      // fill the thread local cache enough for this and next allocations, preferring the blocks of the local node
       std::array<void*, batch_steal_size> popped_blocks;
-      size_t                              n = central_mem_cache.try_pop(popped_blocks);
+      size_t                              n = 0;
+      for (size_t i = 0; i < arenas.size() and n == 0; ++i) {
+        n = arenas[(worker_ctxt->home_arena + i) % arenas.size()]->central_mem_cache.try_pop(popped_blocks);
+      }
       for (size_t i = 0; i < n; ++i) {
         new (popped_blocks[i]) obj_storage_t();
         worker_ctxt->cache.push(static_cast<void*>(popped_blocks[i]));
@@ -124,10 +144,9 @@ public:
     obj_storage_t* block_ptr   = static_cast<obj_storage_t*>(p);
 
     if (DebugSanitizeAddress) {
-      std::lock_guard<std::mutex> lock(mutex);
-      isrran_assert(std::any_of(allocated_blocks.begin(),
-                                allocated_blocks.end(),
-                                [block_ptr](const std::unique_ptr<obj_storage_t>& b) { return b.get() == block_ptr; }),
+      size_t idx = get_arena_idx(p);
+      isrran_assert(idx < arenas.size() and
+                        (static_cast<uint8_t*>(p) - arenas[idx]->begin) % sizeof(obj_storage_t) == 0,
                     "Error deallocating block with address 0x%lx",
                     (long unsigned)block_ptr);
     }
@@ -137,7 +156,7 @@ public:
 
     if (worker_ctxt->cache.size() >= local_growth_thres) {
       // if local cache reached max capacity, send half of the blocks to central cache
-      central_mem_cache.steal_blocks(worker_ctxt->cache, worker_ctxt->cache.size() / 2);
+      release_blocks(worker_ctxt->cache, worker_ctxt->cache.size() / 2);
     }
   }
 
@@ -153,29 +172,41 @@ public:
 
   void print_all_buffers()
   {
-    auto*  worker     = get_worker_cache();
-    size_t tot_blocks = 0;
-    {
-      std::lock_guard<std::mutex> lock(mutex);
-      tot_blocks = allocated_blocks.size();
+    auto*  worker       = get_worker_cache();
+    size_t central_size = 0;
+    for (std::unique_ptr<arena_t>& arena : arenas) {
+      central_size += arena->central_mem_cache.size();
     }
     printf("There are %zd/%zd buffers in shared block container. This thread contains %zd in its local cache\n",
-           central_mem_cache.size(),
-           tot_blocks,
+           central_size,
+           nof_objects,
            worker->cache.size());
+    if (arenas.size() > 1) {
+      for (std::unique_ptr<arena_t>& arena : arenas) {
+        printf("  NUMA node %d: %zd/%zd buffers in shared block container\n",
+               arena->node,
+               arena->central_mem_cache.size(),
+               (size_t)(arena->end - arena->begin) / sizeof(obj_storage_t));
+      }
+    }
   }
 
 private:
+  /// Contiguous blocks placed on a NUMA node, with their central cache
+  struct arena_t {
+    int                           node  = -1;
+    uint8_t*                      begin = nullptr;
+    uint8_t*                      end   = nullptr;
+    concurrent_free_memblock_list central_mem_cache;
+  };
+
   struct worker_ctxt {
     std::thread::id    id;
+    size_t             home_arena;
     free_memblock_list cache;
 
-    worker_ctxt() : id(std::this_thread::get_id()) {}
-    ~worker_ctxt()
-    {
-      concurrent_free_memblock_list& central_cache = pool_type::get_instance()->central_mem_cache;
-      central_cache.steal_blocks(cache, cache.size());
-    }
+    worker_ctxt() : id(std::this_thread::get_id()), home_arena(pool_type::get_instance()->get_home_arena()) {}
+    ~worker_ctxt() { pool_type::get_instance()->release_blocks(cache, cache.size()); }
   };
 
   worker_ctxt* get_worker_cache()
@@ -184,6 +215,48 @@ private:
     return &worker_cache;
   }
 
+  /// Arena of the NUMA node the calling thread runs on
+  size_t get_home_arena() const
+  {
+    if (arenas.size() > 1) {
+      int node = (int)numa::current_node();
+      for (size_t i = 0; i < arenas.size(); ++i) {
+        if (arenas[i]->node == node) {
+          return i;
+        }
+      }
+    }
+    return 0;
+  }
+
+  size_t get_arena_idx(void* p) const
+  {
+    uint8_t* b = static_cast<uint8_t*>(p);
+    for (size_t i = 0; i < arenas.size(); ++i) {
+      if (b >= arenas[i]->begin and b < arenas[i]->end) {
+        return i;
+      }
+    }
+    return arenas.size();
+  }
+
+  /// Sends blocks of a local cache back to the central caches of their nodes
+  void release_blocks(free_memblock_list& cache, size_t max_n)
+  {
+    if (arenas.size() == 1) {
+      arenas[0]->central_mem_cache.steal_blocks(cache, max_n);
+      return;
+    }
+    std::array<free_memblock_list, max_arenas> arena_blocks;
+    for (size_t i = 0; i < max_n and not cache.empty(); ++i) {
+      void* block = cache.pop();
+      arena_blocks[get_arena_idx(block)].push(block);
+    }
+    for (size_t i = 0; i < arenas.size(); ++i) {
+      arenas[i]->central_mem_cache.steal_blocks(arena_blocks[i], arena_blocks[i].size());
+    }
+  }
+
   /// Formats and prints the input string and arguments into the configured output stream.
   template <typename... Args>
   void print_error(const char* str, Args&&... args)
@@ -195,12 +268,11 @@ private:
     }
   }
 
+  const size_t          nof_objects;
   size_t                local_growth_thres = 0;
   isrlog::basic_logger* logger             = nullptr;
 
-  concurrent_free_memblock_list                central_mem_cache;
-  std::mutex                                   mutex;
-  std::vector<std::unique_ptr<obj_storage_t> > allocated_blocks;
+  std::vector<std::unique_ptr<arena_t> > arenas;
 };
 
 } // namespace isrran
@@ -0,0 +1,175 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRRAN_ASN1_ARENA_H
+#define ISRRAN_ASN1_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace asn1 {
+
+/**
+ * Bump allocator for the heap storage of decoded ASN.1 messages, i.e. the dyn_array, ext_array and copy_ptr members
+ * that are created while unpacking. All the memory is released in one shot when the arena is destroyed, and the
+ * deallocations of the message members are no-ops.
+ *
+ * The first allocations are served from storage inside the arena, so an arena on the stack decodes small messages
+ * without any malloc. The message must be destroyed before the arena:
+ *
+ *   asn1::arena            arena;
+ *   asn1::rrc::ul_dcch_msg_s msg;
+ *   {
+ *     asn1::arena_scope scope(arena);
+ *     msg.unpack(bref);
+ *   }
+ *
+ * Copies of the message members that are made outside the arena_scope, and moves out of arena storage, allocate
+ * from the heap, so they can outlive the arena.
+ */
+class arena
+{
+public:
+  static const size_t inline_size = 4096;
+  static const size_t chunk_size  = 16384;
+
+  arena() = default;
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+
+  /// Returns 16-byte aligned storage, valid until the arena is destroyed
+  void* allocate(size_t size);
+
+  size_t nof_allocations() const { return nof_allocs; }
+  size_t nof_bytes() const { return nof_allocated_bytes; }
+  size_t nof_chunks() const { return chunks.size(); }
+
+private:
+  static const size_t alignment = 16;
+
+  alignas(alignment) uint8_t              inline_buffer[inline_size];
+  uint8_t*                                cur = inline_buffer;
+  uint8_t*                                end = inline_buffer + inline_size;
+  std::vector<std::unique_ptr<uint8_t[]>> chunks;
+  size_t                                  nof_allocs          = 0;
+  size_t                                  nof_allocated_bytes = 0;
+};
+
+namespace detail {
+
+inline arena*& current_arena()
+{
+  static thread_local arena* a = nullptr;
+  return a;
+}
+
+} // namespace detail
+
+/// Makes the ASN.1 types allocate from an arena in the current thread, until the scope is destroyed
+class arena_scope
+{
+public:
+  explicit arena_scope(arena& a) : prev(detail::current_arena()) { detail::current_arena() = &a; }
+  ~arena_scope() { detail::current_arena() = prev; }
+  arena_scope(const arena_scope&) = delete;
+  arena_scope& operator=(const arena_scope&) = delete;
+
+private:
+  arena* prev;
+};
+
+namespace detail {
+
+/// Each allocation is preceded by a header that records the arena it comes from, or nullptr for the heap
+const size_t mem_header_size = 16;
+
+inline void* mem_allocate(size_t size)
+{
+  arena* a   = current_arena();
+  void*  hdr = a != nullptr ? a->allocate(size + mem_header_size) : ::operator new(size + mem_header_size);
+  *static_cast<arena**>(hdr) = a;
+  return static_cast<uint8_t*>(hdr) + mem_header_size;
+}
+
+inline void mem_deallocate(void* p)
+{
+  if (p == nullptr) {
+    return;
+  }
+  void* hdr = static_cast<uint8_t*>(p) - mem_header_size;
+  if (*static_cast<arena**>(hdr) == nullptr) {
+    ::operator delete(hdr);
+  }
+}
+
+inline bool is_arena_allocated(const void* p)
+{
+  return p != nullptr and *reinterpret_cast<arena* const*>(static_cast<const uint8_t*>(p) - mem_header_size) != nullptr;
+}
+
+template <typename T>
+T* new_array(size_t n)
+{
+  static_assert(alignof(T) <= mem_header_size, "Unsupported alignment for ASN.1 storage");
+  T* ptr = static_cast<T*>(mem_allocate(n * sizeof(T)));
+  for (size_t i = 0; i < n; ++i) {
+    new (ptr + i) T;
+  }
+  return ptr;
+}
+
+template <typename T>
+void delete_array(T* ptr, size_t n)
+{
+  if (ptr == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    ptr[i].~T();
+  }
+  mem_deallocate(ptr);
+}
+
+template <typename T, typename... Args>
+T* new_object(Args&&... args)
+{
+  static_assert(alignof(T) <= mem_header_size, "Unsupported alignment for ASN.1 storage");
+  return new (mem_allocate(sizeof(T))) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void delete_object(T* ptr)
+{
+  if (ptr != nullptr) {
+    ptr->~T();
+    mem_deallocate(ptr);
+  }
+}
+
+} // namespace detail
+
+} // namespace asn1
+
+#endif // ISRRAN_ASN1_ARENA_H
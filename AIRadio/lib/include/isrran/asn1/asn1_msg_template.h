@@ -0,0 +1,177 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRRAN_ASN1_MSG_TEMPLATE_H
+#define ISRRAN_ASN1_MSG_TEMPLATE_H
+
+#include "isrran/adt/span.h"
+#include "isrran/asn1/asn1_utils.h"
+#include <functional>
+#include <vector>
+
+namespace asn1 {
+
+/**
+ * Pre-encoded ASN.1 message, for messages that are sent many times with only a few fields changing, e.g. the
+ * dedicated resources of each UE. The message is packed once, and every new message is obtained by copying the
+ * encoding and overwriting the bits of the variable fields.
+ *
+ * Only fields whose UPER encoding has a fixed position and width can be patched, i.e. constrained integers and
+ * enumerations that are present in every message. The position of each field is found when the template is built,
+ * by packing the message once for each bit of the field value.
+ */
+template <typename Msg>
+class encoded_msg_template
+{
+public:
+  /// Variable field of the message, within [lb, ub]. "set" writes a value of the field into the message
+  struct field_t {
+    std::function<void(Msg&, uint32_t)> set;
+    uint32_t                            lb;
+    uint32_t                            ub;
+  };
+
+  /// Packs msg and finds where each field is encoded. Returns false if a field does not have a fixed width encoding
+  bool build(const Msg& msg, isrran::span<const field_t> fields_)
+  {
+    clear();
+
+    Msg base = msg;
+    for (const field_t& f : fields_) {
+      f.set(base, f.lb);
+    }
+    std::vector<uint8_t> base_buf;
+    uint32_t             base_bits = 0;
+    if (not pack(base, base_buf, base_bits)) {
+      return false;
+    }
+
+    std::vector<uint8_t> buf;
+    uint32_t             nof_bits_ = 0;
+    for (const field_t& f : fields_) {
+      encoded_field_t pos = {};
+      pos.lb              = f.lb;
+      pos.ub              = f.ub;
+      while (((f.ub - f.lb) >> pos.nof_bits) > 0) {
+        pos.nof_bits++;
+      }
+      // Setting bit k of the value must flip only the bit (nof_bits - 1 - k) of the field
+      for (uint32_t k = 0; k < pos.nof_bits; ++k) {
+        Msg m = base;
+        f.set(m, f.lb + (1u << k));
+        if (not pack(m, buf, nof_bits_) or nof_bits_ != base_bits) {
+          return false;
+        }
+        int      diff_bit = single_diff_bit(base_buf, buf);
+        uint32_t msb_dist = pos.nof_bits - 1 - k;
+        if (diff_bit < (int)msb_dist or (k > 0 and (uint32_t)diff_bit - msb_dist != pos.bit_offset)) {
+          return false;
+        }
+        pos.bit_offset = (uint32_t)diff_bit - msb_dist;
+      }
+      fields.push_back(pos);
+    }
+
+    encoded = std::move(base_buf);
+    return true;
+  }
+
+  bool empty() const { return encoded.empty(); }
+  void clear()
+  {
+    encoded.clear();
+    fields.clear();
+  }
+
+  /// Writes the message with the given values of the fields into pdu
+  bool encode(isrran::byte_buffer_t& pdu, isrran::span<const uint32_t> values) const
+  {
+    if (empty() or values.size() != fields.size() or encoded.size() > pdu.get_tailroom()) {
+      return false;
+    }
+    for (uint32_t i = 0; i < fields.size(); ++i) {
+      if (values[i] < fields[i].lb or values[i] > fields[i].ub) {
+        return false;
+      }
+    }
+    memcpy(pdu.msg, encoded.data(), encoded.size());
+    for (uint32_t i = 0; i < fields.size(); ++i) {
+      patch_bits(pdu.msg, fields[i].bit_offset, values[i] - fields[i].lb, fields[i].nof_bits);
+    }
+    pdu.N_bytes = encoded.size();
+    return true;
+  }
+
+  /// Checks that pdu, as written by encode(), is the packing of msg, i.e. that msg only differs from the template in
+  /// the patched fields. It packs msg, so it is meant for sanity checks
+  bool matches(const Msg& msg, const isrran::byte_buffer_t& pdu) const
+  {
+    std::vector<uint8_t> buf;
+    uint32_t             nof_bits_ = 0;
+    return pack(msg, buf, nof_bits_) and buf.size() == pdu.N_bytes and memcmp(buf.data(), pdu.msg, pdu.N_bytes) == 0;
+  }
+
+private:
+  static const uint32_t max_msg_size = 4096;
+
+  struct encoded_field_t {
+    uint32_t bit_offset = 0;
+    uint32_t nof_bits   = 0;
+    uint32_t lb         = 0;
+    uint32_t ub         = 0;
+  };
+
+  static bool pack(const Msg& msg, std::vector<uint8_t>& buf, uint32_t& nof_bits)
+  {
+    buf.assign(max_msg_size, 0);
+    bit_ref bref(buf.data(), buf.size());
+    if (msg.pack(bref) != ISRASN_SUCCESS) {
+      return false;
+    }
+    nof_bits = bref.distance();
+    buf.resize(bref.distance_bytes());
+    return true;
+  }
+
+  /// Position of the only bit that differs between two encodings of the same length, or -1
+  static int single_diff_bit(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b)
+  {
+    int diff_bit = -1;
+    for (uint32_t i = 0; i < a.size(); ++i) {
+      uint8_t diff = a[i] ^ b[i];
+      if (diff == 0) {
+        continue;
+      }
+      if (diff_bit >= 0 or (diff & (diff - 1)) != 0) {
+        return -1;
+      }
+      diff_bit = i * 8 + __builtin_clz(diff) - 24;
+    }
+    return diff_bit;
+  }
+
+  std::vector<uint8_t>         encoded;
+  std::vector<encoded_field_t> fields;
+};
+
+} // namespace asn1
+
+#endif // ISRRAN_ASN1_MSG_TEMPLATE_H
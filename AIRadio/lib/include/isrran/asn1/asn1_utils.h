@@ -22,6 +22,7 @@
 #ifndef ISRASN_COMMON_UTILS_H
 #define ISRASN_COMMON_UTILS_H
 
+#include "isrran/asn1/asn1_arena.h"
 #include "isrran/common/buffer_pool.h"
 #include "isrran/isrlog/isrlog.h"
 #include "isrran/support/isrran_assert.h"
@@ -153,6 +154,12 @@ public:
   template <class T>
   ISRASN_CODE unpack(T& val, uint32_t n_bits)
   {
+    // Fast path for flags and small integers that do not cross the current octet
+    if (n_bits > 0 and offset + n_bits < 8 and ptr < max_ptr) {
+      val = static_cast<T>((*ptr >> (8u - offset - n_bits)) & ((1u << n_bits) - 1u));
+      offset += n_bits;
+      return ISRASN_SUCCESS;
+    }
     return unpack_bits(val, ptr, offset, max_ptr, n_bits);
   }
   ISRASN_CODE unpack_bytes(uint8_t* buf, uint32_t n_bytes);
@@ -179,11 +186,28 @@ public:
   bit_ref() = default;
   bit_ref(uint8_t* start_ptr_, uint32_t max_size_) : bit_ref_impl(start_ptr_, max_size_) {}
 
-  ISRASN_CODE pack(uint64_t val, uint32_t n_bits);
+  ISRASN_CODE pack(uint64_t val, uint32_t n_bits)
+  {
+    // Fast path for flags and small integers that do not cross the current octet
+    if (n_bits > 0 and offset + n_bits < 8 and ptr < max_ptr) {
+      auto keepmask = static_cast<uint8_t>(0xffu << (8u - offset));
+      auto bits     = static_cast<uint8_t>((val & ((1u << n_bits) - 1u)) << (8u - offset - n_bits));
+      *ptr          = (*ptr & keepmask) | bits;
+      offset += n_bits;
+      return ISRASN_SUCCESS;
+    }
+    return pack_bits(val, n_bits);
+  }
   ISRASN_CODE pack_bytes(const uint8_t* buf, uint32_t n_bytes);
   ISRASN_CODE align_bytes_zero();
+
+private:
+  ISRASN_CODE pack_bits(uint64_t val, uint32_t n_bits);
 };
 
+/// Overwrites n_bits of an encoded message, starting at bit_offset, with val. The surrounding bits are preserved
+void patch_bits(uint8_t* buf, uint32_t bit_offset, uint64_t val, uint32_t n_bits);
+
 /*********************
   function helpers
 *********************/
@@ -196,25 +220,20 @@ public:
   using const_iterator = const T*;
 
   dyn_array() = default;
-  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size) { data_ = new T[size_]; }
+  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size) { data_ = detail::new_array<T>(size_); }
   dyn_array(const dyn_array<T>& other) : dyn_array(&other[0], other.size_) {}
   dyn_array(const T* ptr, uint32_t nof_items)
   {
     size_ = nof_items;
     cap_  = nof_items;
     if (ptr != NULL) {
-      data_ = new T[cap_];
+      data_ = detail::new_array<T>(cap_);
       std::copy(ptr, ptr + size_, data_);
     } else {
       data_ = NULL;
     }
   }
-  ~dyn_array()
-  {
-    if (data_ != NULL) {
-      delete[] data_;
-    }
-  }
+  ~dyn_array() { detail::delete_array(data_, cap_); }
   uint32_t      size() const { return size_; }
   uint32_t      capacity() const { return cap_; }
   T&            operator[](uint32_t idx) { return data_[idx]; }
@@ -238,10 +257,11 @@ public:
       return;
     }
 
-    T* old_data = data_;
-    cap_        = new_size > new_cap ? new_size : new_cap;
+    T*       old_data = data_;
+    uint32_t old_cap  = cap_;
+    cap_              = new_size > new_cap ? new_size : new_cap;
     if (cap_ > 0) {
-      data_ = new T[cap_];
+      data_ = detail::new_array<T>(cap_);
       if (old_data != NULL) {
         isrran_assert(cap_ > size_, "Old size larger than new capacity in dyn_array\n");
         std::copy(&old_data[0], &old_data[size_], data_);
@@ -250,9 +270,7 @@ public:
       data_ = NULL;
     }
     size_ = new_size;
-    if (old_data != NULL) {
-      delete[] old_data;
-    }
+    detail::delete_array(old_data, old_cap);
   }
   iterator erase(iterator it)
   {
@@ -356,6 +374,12 @@ public:
     if (other.is_in_small_buffer()) {
       head = &small_buffer.data[0];
       std::copy(other.data(), other.data() + other.size(), head);
+    } else if (detail::is_arena_allocated(other.head)) {
+      // arena storage is not stolen, as the moved-to array may outlive the arena
+      size_ = 0;
+      head  = &small_buffer.data[0];
+      resize(other.size());
+      std::copy(other.data(), other.data() + other.size(), head);
     } else {
       head              = other.head;
       small_buffer.cap_ = other.small_buffer.cap_;
@@ -366,7 +390,7 @@ public:
   ~ext_array()
   {
     if (not is_in_small_buffer()) {
-      delete[] head;
+      detail::delete_array(head, small_buffer.cap_);
     }
   }
   ext_array<T, Nthres>& operator=(const ext_array<T, Nthres>& other)
@@ -405,12 +429,13 @@ public:
       return;
     }
     T*       old_data = head;
+    uint32_t old_cap  = capacity();
     uint32_t newcap   = new_size + 5;
-    head              = new T[newcap];
-    std::copy(&small_buffer.data[0], &small_buffer.data[size_], head);
+    head              = detail::new_array<T>(newcap);
+    std::copy(old_data, old_data + size_, head);
     size_ = new_size;
     if (old_data != &small_buffer.data[0]) {
-      delete[] old_data;
+      detail::delete_array(old_data, old_cap);
     }
     small_buffer.cap_ = newcap;
   }
@@ -711,9 +736,7 @@ ISRASN_CODE fixed_octstring<N, aligned>::pack(bit_ref& bref) const
   if (aligned and N > 2) {
     bref.align_bytes_zero();
   }
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.pack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.pack_bytes(octets_.data(), size()));
   return ISRASN_SUCCESS;
 }
 
@@ -723,9 +746,7 @@ ISRASN_CODE fixed_octstring<N, aligned>::unpack(cbit_ref& bref)
   if (aligned and N > 2) {
     bref.align_bytes();
   }
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.unpack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.unpack_bytes(octets_.data(), size()));
   return ISRASN_SUCCESS;
 }
 
@@ -769,9 +790,7 @@ public:
     if (aligned) {
       bref.align_bytes_zero();
     }
-    for (uint32_t i = 0; i < size(); ++i) {
-      HANDLE_CODE(bref.pack(octets_[i], 8));
-    }
+    HANDLE_CODE(bref.pack_bytes(octets_.data(), size()));
     return ISRASN_SUCCESS;
   }
   ISRASN_CODE unpack(cbit_ref& bref)
@@ -782,9 +801,7 @@ public:
     if (aligned) {
       bref.align_bytes();
     }
-    for (uint32_t i = 0; i < size(); ++i) {
-      HANDLE_CODE(bref.unpack(octets_[i], 8));
-    }
+    HANDLE_CODE(bref.unpack_bytes(octets_.data(), size()));
     return ISRASN_SUCCESS;
   }
 
@@ -1165,22 +1182,23 @@ class copy_ptr
 {
 public:
   copy_ptr() : ptr(nullptr) {}
-  explicit copy_ptr(T* ptr_) : ptr(ptr_) {}
-  copy_ptr(copy_ptr<T>&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
-  copy_ptr(const copy_ptr<T>& other) { ptr = (other.ptr == nullptr) ? nullptr : new T(*other.ptr); }
+  /// Takes ownership of ptr_, which must be allocated with new
+  explicit copy_ptr(T* ptr_) : ptr(ptr_), from_new(true) {}
+  copy_ptr(copy_ptr<T>&& other) noexcept : ptr(nullptr) { steal_(other); }
+  copy_ptr(const copy_ptr<T>& other) { ptr = (other.ptr == nullptr) ? nullptr : detail::new_object<T>(*other.ptr); }
   ~copy_ptr() { destroy_(); }
   copy_ptr<T>& operator=(const copy_ptr<T>& other)
   {
     if (this != &other) {
-      reset((other.ptr == nullptr) ? nullptr : new T(*other.ptr));
+      reset_((other.ptr == nullptr) ? nullptr : detail::new_object<T>(*other.ptr));
     }
     return *this;
   }
   copy_ptr<T>& operator=(copy_ptr<T>&& other) noexcept
   {
     if (this != &other) {
-      ptr       = other.ptr;
-      other.ptr = nullptr;
+      reset_(nullptr);
+      steal_(other);
     }
     return *this;
   }
@@ -1191,42 +1209,69 @@ public:
   const T& operator*() const { return *ptr; } // like pointers, don't call this if ptr==NULL
   T*       get() { return ptr; }
   const T* get() const { return ptr; }
-  T*       release()
+  /// Returns the object, which must be deleted with delete
+  T* release()
   {
     T* ret = ptr;
-    ptr    = nullptr;
+    if (ret != nullptr and not from_new) {
+      ret = new T(std::move(*ptr));
+      destroy_();
+    }
+    ptr = nullptr;
     return ret;
   }
+  /// Takes ownership of ptr_, which must be allocated with new
   void reset(T* ptr_ = nullptr)
   {
     destroy_();
-    ptr = ptr_;
-  }
-  void set_present(bool flag = true)
-  {
-    if (flag) {
-      reset(new T());
-    } else {
-      reset();
-    }
+    ptr      = ptr_;
+    from_new = true;
   }
+  void set_present(bool flag = true) { reset_(flag ? detail::new_object<T>() : nullptr); }
   bool is_present() const { return get() != nullptr; }
 
 private:
+  template <class U>
+  friend copy_ptr<typename std::decay<U>::type> make_copy_ptr(U&& t);
+
   void destroy_()
   {
-    if (ptr != NULL) {
+    if (from_new) {
       delete ptr;
+    } else {
+      detail::delete_object(ptr);
     }
   }
-  T* ptr;
+  /// Takes ownership of ptr_, which must be allocated with detail::new_object
+  void reset_(T* ptr_)
+  {
+    destroy_();
+    ptr      = ptr_;
+    from_new = false;
+  }
+  // arena storage is copied rather than stolen, as the moved-to pointer may outlive the arena
+  void steal_(copy_ptr<T>& other)
+  {
+    if (not other.from_new and detail::is_arena_allocated(other.ptr)) {
+      ptr      = detail::new_object<T>(std::move(*other.ptr));
+      from_new = false;
+      return;
+    }
+    ptr       = other.ptr;
+    from_new  = other.from_new;
+    other.ptr = nullptr;
+  }
+  T*   ptr;
+  bool from_new = false; ///< ptr was allocated with new rather than with detail::new_object
 };
 
 template <class T>
 copy_ptr<typename std::decay<T>::type> make_copy_ptr(T&& t)
 {
   using T2 = typename std::decay<T>::type;
-  return copy_ptr<T2>(new T2(std::forward<T>(t)));
+  copy_ptr<T2> ret;
+  ret.reset_(detail::new_object<T2>(std::forward<T>(t)));
+  return ret;
 }
 
 /*********************
@@ -1412,6 +1457,18 @@ inline void to_json(json_writer& j, int64_t number)
   j.write_int(number);
 }
 
+/*******************
+   Arena unpacking
+*******************/
+
+/// Unpacks msg with its heap members allocated from the arena, which must outlive msg
+template <class Msg>
+ISRASN_CODE unpack_in_arena(Msg& msg, cbit_ref& bref, arena& msg_arena)
+{
+  arena_scope scope(msg_arena);
+  return msg.unpack(bref);
+}
+
 /*******************
   Test pack/unpack
 *******************/
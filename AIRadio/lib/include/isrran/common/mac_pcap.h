@@ -24,6 +24,7 @@
 
 #include "isrran/common/common.h"
 #include "isrran/common/mac_pcap_base.h"
+#include "isrran/common/pcap_writer.h"
 #include "isrran/isrran.h"
 
 namespace isrran {
@@ -32,14 +33,15 @@ class mac_pcap : public mac_pcap_base
 public:
   mac_pcap();
   ~mac_pcap();
-  uint32_t open(std::string filename, uint32_t ue_id = 0);
+  uint32_t open(std::string filename, uint32_t ue_id = 0, const pcap_writer_args& args = {});
   uint32_t close();
 
 private:
   void write_pdu(isrran::mac_pcap_base::pcap_pdu_t& pdu);
+  void write_idle() override;
 
-  FILE*       pcap_file = nullptr;
-  uint32_t    dlt       = 0; // The DLT used for the PCAP file
+  pcap_writer writer;
+  uint32_t    dlt = 0; // The DLT used for the PCAP file
   std::string filename;
 };
 } // namespace isrran
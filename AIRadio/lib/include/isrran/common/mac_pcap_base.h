@@ -106,6 +106,8 @@ protected:
   } pcap_pdu_t;
 
   virtual void write_pdu(pcap_pdu_t& pdu) = 0;
+  /// Called by the writer thread, with the mutex held, once no PDU has been queued for a while.
+  virtual void write_idle() {}
   void         run_thread() final;
 
   std::mutex                              mutex;
@@ -0,0 +1,161 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#ifndef ISRRAN_METRICS_COUNTERS_H
+#define ISRRAN_METRICS_COUNTERS_H
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <stdint.h>
+
+namespace isrran {
+
+namespace detail {
+
+/// Index of the calling thread, used to pick its shard of the metrics counters. Threads are numbered on first use.
+inline uint32_t metrics_thread_index()
+{
+  static std::atomic<uint32_t> nof_threads{0};
+  static thread_local uint32_t index = nof_threads.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+} // namespace detail
+
+/**
+ * Block of metrics counters, updated by the worker threads on the hot path and aggregated by the metrics thread
+ * without any lock.
+ *
+ * The counters are split in shards living in separate cache lines, and each thread adds into the shard of its thread
+ * index, so that the workers updating the metrics of the same entity do not share a cache line. An update is a relaxed
+ * atomic add. The counters are never reset: read() sums the shards into the totals since construction, and
+ * metrics_counters_reader turns the totals into the increments of each report period.
+ *
+ * Averages are kept as a sum of samples and a number of samples. Samples are added in fixed point, with a resolution of
+ * 1/sample_scale.
+ *
+ * @tparam Counter enum class of the counters, whose last value must be nof_counters.
+ */
+template <typename Counter, uint32_t NofShards = 4>
+class metrics_counters
+{
+  static constexpr size_t cache_line_size = 64;
+
+public:
+  static constexpr uint32_t nof_counters = (uint32_t)Counter::nof_counters;
+  static constexpr float    sample_scale = 1000.0f;
+
+  using totals_t = std::array<uint64_t, nof_counters>;
+
+  metrics_counters()
+  {
+    for (shard_t& shard : shards) {
+      for (std::atomic<uint64_t>& value : shard.values) {
+        value.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+  metrics_counters(const metrics_counters&) = delete;
+  metrics_counters& operator=(const metrics_counters&) = delete;
+
+  void add(Counter counter, uint64_t value = 1)
+  {
+    shards[detail::metrics_thread_index() % NofShards].values[(uint32_t)counter].fetch_add(value,
+                                                                                            std::memory_order_relaxed);
+  }
+
+  /// Adds a sample to the given sum, for averages sharing their number of samples. Non finite samples count as zero.
+  void add_sample(Counter sum, float sample)
+  {
+    if (std::isfinite(sample)) {
+      add(sum, (uint64_t)(int64_t)std::lround(sample * sample_scale));
+    }
+  }
+
+  /// Adds a sample to the average kept in the given sum and number of samples. Non finite samples are discarded.
+  void add_sample(Counter sum, Counter nof_samples, float sample)
+  {
+    if (std::isfinite(sample)) {
+      add_sample(sum, sample);
+      add(nof_samples);
+    }
+  }
+
+  /// Sums the shards of all the threads.
+  totals_t read() const
+  {
+    totals_t totals = {};
+    for (const shard_t& shard : shards) {
+      for (uint32_t i = 0; i < nof_counters; ++i) {
+        totals[i] += shard.values[i].load(std::memory_order_relaxed);
+      }
+    }
+    return totals;
+  }
+
+private:
+  struct shard_t {
+    std::array<std::atomic<uint64_t>, nof_counters> values;
+    // Padding is used instead of alignas since over-aligned heap allocations are not supported before C++17.
+    char pad[cache_line_size];
+  };
+
+  char                           pad0[cache_line_size];
+  std::array<shard_t, NofShards> shards;
+};
+
+/// Increments of a block of metrics counters over the report periods. It is owned by the metrics thread.
+template <typename Counter, uint32_t NofShards = 4>
+class metrics_counters_reader
+{
+public:
+  using counters_t = metrics_counters<Counter, NofShards>;
+
+  /// Reads the counters and computes their increments since the previous update.
+  void update(const counters_t& counters)
+  {
+    typename counters_t::totals_t totals = counters.read();
+    for (uint32_t i = 0; i < counters_t::nof_counters; ++i) {
+      delta[i] = totals[i] - last[i];
+    }
+    last = totals;
+  }
+
+  /// Increment of the counter in the last period.
+  uint64_t get(Counter counter) const { return delta[(uint32_t)counter]; }
+
+  /// Average of the samples added in the last period, or zero if there were none.
+  float average(Counter sum, Counter nof_samples) const
+  {
+    uint64_t n = get(nof_samples);
+    return n > 0 ? (float)(int64_t)get(sum) / counters_t::sample_scale / n : 0.0f;
+  }
+
+private:
+  typename counters_t::totals_t last  = {};
+  typename counters_t::totals_t delta = {};
+};
+
+} // namespace isrran
+
+#endif // ISRRAN_METRICS_COUNTERS_H
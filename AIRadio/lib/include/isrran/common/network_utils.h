@@ -35,6 +35,7 @@
 #include <netinet/udp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <vector>
 
 namespace isrran {
 
@@ -124,6 +125,13 @@ public:
   /// Register (fd, callback). callback is called within socket thread when fd has data.
   virtual bool add_socket_handler(int fd, recv_callback_t handler) = 0;
 
+  /// Register (fd, callback) edge-triggered. callback is only called when new data arrives in fd, so it must read fd
+  /// until it would block (e.g. the callbacks created with make_sdu_batch_handler).
+  virtual bool add_edge_socket_handler(int fd, recv_callback_t handler)
+  {
+    return add_socket_handler(fd, std::move(handler));
+  }
+
   /// remove registered socket fd
   virtual bool remove_socket(int fd) = 0;
 
@@ -132,7 +140,7 @@ protected:
 };
 
 /**
- * Description - Instantiates a thread that will block waiting for IO from multiple sockets, via a select
+ * Description - Instantiates a thread that will block waiting for IO from multiple sockets, via epoll
  *               The user can register their own (socket fd, data handler) in this class via the
  *               add_socket_handler(fd, task) API or its other variants
  */
@@ -148,27 +156,32 @@ public:
   bool remove_socket_nonblocking(int fd, bool signal_completion = false);
   bool remove_socket(int fd) final;
   bool add_socket_handler(int fd, recv_callback_t handler) final;
+  bool add_edge_socket_handler(int fd, recv_callback_t handler) final;
 
   void run_thread() override;
 
 private:
-  const int thread_prio = 65;
+  const int thread_prio    = 65;
+  const int max_nof_events = 32;
 
-  // used to unlock select
+  // used to unlock epoll_wait
   struct ctrl_cmd_t {
     enum class cmd_id_t { EXIT, NEW_FD, RM_FD };
     cmd_id_t cmd;
     int      new_fd;
+    bool     edge_triggered;
     bool     signal_rm_complete;
     ctrl_cmd_t() { bzero(this, sizeof(ctrl_cmd_t)); }
   };
-  std::map<int, recv_callback_t>::iterator remove_socket_unprotected(int fd, fd_set* total_fd_set, int* max_fd);
+  bool add_socket_handler_unprotected(int fd, recv_callback_t handler, bool edge_triggered);
+  bool remove_socket_unprotected(int fd);
 
   // state
   std::mutex                     socket_mutex;
   std::map<int, recv_callback_t> active_sockets;
   std::atomic<bool>              running   = {false};
   int                            pipefd[2] = {-1, -1};
+  int                            epoll_fd  = -1;
   std::vector<int>               rem_fd_tmp_list;
   std::condition_variable        rem_cvar;
 };
@@ -180,6 +193,15 @@ using sctp_recv_callback_t =
 /// Function signature for SDU byte buffers received from any sockaddr_in-based socket
 using recvfrom_callback_t = isrran::move_callback<void(isrran::unique_byte_buffer_t, const sockaddr_in&)>;
 
+/// SDU byte buffers received with a single system call, and their source addresses
+struct recvfrom_burst_t {
+  std::vector<isrran::unique_byte_buffer_t> pdus;
+  std::vector<sockaddr_in>                  from;
+};
+
+/// Function signature for bursts of SDU byte buffers received from any sockaddr_in-based socket
+using recvfrom_burst_callback_t = isrran::move_callback<void(recvfrom_burst_t&)>;
+
 /**
  * Helper function that creates a callback that is called when a SCTP socket has data, and does the following tasks:
  * 1. receive SDU byte buffer from SCTP socket and associated metadata - sockaddr_in, sctp_sndrcvinfo, flags
@@ -200,6 +222,25 @@ make_sctp_sdu_handler(isrlog::basic_logger& logger, isrran::task_queue_handle& q
 socket_manager_itf::recv_callback_t
 make_sdu_handler(isrlog::basic_logger& logger, isrran::task_queue_handle& queue, recvfrom_callback_t rx_callback);
 
+/**
+ * Similar to make_sdu_handler, but the datagrams are read with recvmmsg(...) into a batch of pre-allocated byte
+ * buffers, until the socket has no more data. The returned callback must be registered as edge-triggered.
+ * @param batch_size maximum number of datagrams read per system call
+ */
+socket_manager_itf::recv_callback_t make_sdu_batch_handler(isrlog::basic_logger&      logger,
+                                                           isrran::task_queue_handle& queue,
+                                                           recvfrom_callback_t        rx_callback,
+                                                           uint32_t                   batch_size = 32);
+
+/**
+ * Similar to make_sdu_batch_handler, but the datagrams read with each recvmmsg(...) call are dispatched to the queue
+ * as a single task, so that the receiver can process the burst at once
+ */
+socket_manager_itf::recv_callback_t make_sdu_burst_handler(isrlog::basic_logger&      logger,
+                                                           isrran::task_queue_handle& queue,
+                                                           recvfrom_burst_callback_t  rx_callback,
+                                                           uint32_t                   batch_size = 32);
+
 inline socket_manager& get_rx_io_manager()
 {
   static socket_manager io;
@@ -0,0 +1,79 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRRAN_NUMA_H
+#define ISRRAN_NUMA_H
+
+#include <sched.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Minimal NUMA helpers on top of sysfs and the memory policy system calls, so no libnuma is required. On systems
+ * without NUMA support all the CPUs belong to node 0 and the memory policy calls have no effect.
+ */
+
+namespace isrran {
+namespace numa {
+
+/// Number of NUMA nodes of the system.
+uint32_t nof_nodes();
+
+/// NUMA node of a CPU, 0 if unknown.
+uint32_t cpu_node(uint32_t cpu);
+
+/// CPUs of a NUMA node.
+cpu_set_t node_cpus(uint32_t node);
+
+/// NUMA node of the CPU the calling thread is currently running on.
+uint32_t current_node();
+
+/// Sets the preferred memory node of the calling thread, a negative node restores the default local policy.
+bool set_preferred_node(int node);
+
+/// Preferred memory node of the calling thread, -1 if it follows the default local policy.
+int get_preferred_node();
+
+/// Allocates page aligned memory placed on the given node, or following the default policy if node is negative.
+void* alloc_on_node(size_t len, int node);
+
+/// Releases memory obtained with alloc_on_node().
+void free_on_node(void* ptr, size_t len);
+
+/// Parses a CPU list in the kernel format, e.g. "0-3,8,10-11". Returns false if the list is malformed.
+bool parse_cpu_list(const std::string& list, cpu_set_t& cpus);
+
+/// Formats a CPU set as a CPU list in the kernel format.
+std::string cpu_list_to_string(const cpu_set_t& cpus);
+
+/// NUMA node shared by all the CPUs of the set, -1 if the set is empty or spans several nodes.
+int cpu_set_node(const cpu_set_t& cpus);
+
+/// Nodes the memory pools distribute their blocks on, empty if the pools are not NUMA aware.
+void                  set_memory_nodes(const std::vector<uint32_t>& nodes);
+std::vector<uint32_t> get_memory_nodes();
+
+} // namespace numa
+} // namespace isrran
+
+#endif // ISRRAN_NUMA_H
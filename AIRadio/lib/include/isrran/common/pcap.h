@@ -211,6 +211,14 @@ int LTE_PCAP_MAC_WritePDU(FILE* fd, MAC_Context_Info_t* context, const unsigned
 int LTE_PCAP_MAC_UDP_WritePDU(FILE* fd, MAC_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
 int LTE_PCAP_PACK_MAC_CONTEXT_TO_BUFFER(MAC_Context_Info_t* context, uint8_t* PDU, unsigned int length);
 
+/* Pack the headers preceding a PDU into a buffer of at least PCAP_CONTEXT_HEADER_MAX bytes, return the header length */
+int LTE_PCAP_MAC_UDP_PACK_HEADER(MAC_Context_Info_t* context, unsigned int pdu_length, uint8_t* buffer, unsigned int length);
+int LTE_PCAP_RLC_PACK_HEADER(RLC_Context_Info_t* context, unsigned int pdu_length, uint8_t* buffer, unsigned int length);
+int NR_PCAP_MAC_UDP_PACK_HEADER(mac_nr_context_info_t* context,
+                                unsigned int           pdu_length,
+                                uint8_t*               buffer,
+                                unsigned int           length);
+
 /* Write an individual NAS PDU (PCAP packet header + nas-context + nas-pdu) */
 int LTE_PCAP_NAS_WritePDU(FILE* fd, NAS_Context_Info_t* context, const unsigned char* PDU, unsigned int length);
 
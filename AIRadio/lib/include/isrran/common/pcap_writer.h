@@ -0,0 +1,133 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRRAN_PCAP_WRITER_H
+#define ISRRAN_PCAP_WRITER_H
+
+#include "isrran/isrlog/isrlog.h"
+#include <chrono>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace isrran {
+
+/// Configuration of a pcap_writer.
+struct pcap_writer_args {
+  /// Write pcapng files, with one interface description block per interface, instead of classic pcap files.
+  bool pcapng = false;
+  /// Start a new file once the current one reaches this size in bytes, zero disables size based rotation.
+  uint64_t rotate_size = 0;
+  /// Start a new file once the current one covers this period in seconds, zero disables time based rotation.
+  uint32_t rotate_period_s = 0;
+  /// Size of each of the buffers records are assembled into.
+  uint32_t buffer_size = 1024 * 1024;
+  /// Number of buffers, a full buffer is written while the next ones are being filled.
+  uint32_t nof_buffers = 4;
+  /// Write full buffers asynchronously with io_uring when the kernel supports it, otherwise use writev.
+  bool use_io_uring = true;
+};
+
+/// Interface of a capture, classic pcap files hold a single one.
+struct pcap_interface {
+  uint32_t    dlt;
+  std::string name;
+};
+
+/**
+ * Writes capture records into large buffers that are written to the file once full, instead of issuing several
+ * stdio writes per PDU. Full buffers are submitted to an io_uring instance so the writing thread keeps assembling
+ * records while the kernel copies them, falling back to writing the pending buffers with a single writev() call.
+ *
+ * Files are rotated by size or by time: the first file uses the given name and the following ones are numbered
+ * before the extension (e.g. mac.pcap, mac_1.pcap, mac_2.pcap...).
+ *
+ * The class is not thread safe, it is meant to be driven by the writer thread of a pcap class.
+ */
+class pcap_writer
+{
+public:
+  explicit pcap_writer(isrlog::basic_logger& logger);
+  ~pcap_writer();
+
+  pcap_writer(const pcap_writer& other) = delete;
+  pcap_writer& operator=(const pcap_writer& other) = delete;
+
+  /// Opens the capture file for the given interfaces. Classic pcap files use the DLT of the first interface.
+  int open(const std::string& filename, const std::vector<pcap_interface>& interfaces, const pcap_writer_args& args);
+  /// Writes the pending records and closes the current file.
+  void close();
+  bool is_open() const { return fd >= 0; }
+
+  /// Appends a record made of a pseudo header followed by the PDU, timestamped with the current time.
+  int write_pdu(uint32_t if_idx, const uint8_t* header, uint32_t header_len, const uint8_t* pdu, uint32_t pdu_len);
+
+  /// Writes the records held in the buffers to the file.
+  void flush();
+
+  bool        is_io_uring_enabled() const { return ring != nullptr; }
+  uint64_t    get_nof_records() const { return nof_records; }
+  uint32_t    get_nof_files() const { return file_idx + 1; }
+  std::string get_filename(uint32_t idx) const;
+
+private:
+  struct buffer_t {
+    uint8_t* data      = nullptr;
+    uint32_t len       = 0;
+    uint64_t offset    = 0; ///< Position of the buffer in the file
+    bool     in_flight = false;
+  };
+  class io_ring;
+
+  int      open_file();
+  void     close_file();
+  int      write_file_header();
+  uint8_t* reserve(uint32_t len);
+  void     submit_current();
+  void     write_pending();
+  void     write_all(const uint8_t* data, size_t len, uint64_t offset);
+  void     wait_buffer(uint32_t idx);
+  void     wait_all();
+
+  isrlog::basic_logger&       logger;
+  pcap_writer_args            args;
+  std::vector<pcap_interface> interfaces;
+  std::string                 base_filename;
+
+  int                                   fd           = -1;
+  uint32_t                              file_idx     = 0;
+  uint64_t                              file_offset  = 0;
+  uint64_t                              file_bytes   = 0;
+  uint64_t                              file_records = 0;
+  uint64_t                              nof_records  = 0;
+  std::chrono::steady_clock::time_point file_start;
+
+  std::vector<buffer_t>    buffers;
+  uint32_t                 current = 0;
+  std::vector<uint32_t>    pending;
+  std::unique_ptr<io_ring> ring;
+  bool                     ring_write_error = false; ///< A write through the ring failed, stop using it
+};
+
+} // namespace isrran
+
+#endif // ISRRAN_PCAP_WRITER_H
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRRAN_THREAD_PLACEMENT_H
+#define ISRRAN_THREAD_PLACEMENT_H
+
+#include <array>
+#include <mutex>
+#include <sched.h>
+#include <string>
+#include <vector>
+
+namespace isrran {
+
+/// Roles of the threads that can be placed on a set of CPUs.
+enum class thread_role { none = 0, rf, phy_worker, stack, gtpu, log, nof_roles };
+
+const char* to_string(thread_role role);
+
+constexpr uint32_t nof_thread_roles = (uint32_t)thread_role::nof_roles;
+
+/// CPU lists in the kernel format (e.g. "0-3,8") of each role. An empty list leaves the threads of the role unpinned.
+struct thread_placement_args_t {
+  std::string rf_cpus;
+  std::string phy_cpus;
+  std::string stack_cpus;
+  std::string gtpu_cpus;
+  std::string log_cpus;
+  bool        numa_local_memory = true;
+};
+
+/**
+ * Process wide placement of the threads on CPUs and NUMA nodes, by thread role.
+ *
+ * A thread applies the placement of its role when it starts: it is pinned to the CPU set of the role and, if all the
+ * CPUs of the set belong to the same NUMA node, its memory is preferably allocated from that node. The nodes hosting
+ * the roles are handed over to the memory pools, which then keep the blocks of each node in a separate cache.
+ *
+ * Threads with no role, or with a role without CPU set, keep the affinity given by their creator.
+ */
+class thread_placement
+{
+public:
+  static thread_placement& get_instance();
+
+  /// Parses and validates the CPU lists. Returns false if a list is malformed or has no online CPU.
+  bool configure(const thread_placement_args_t& args);
+
+  /// True if any role has a CPU set.
+  bool is_configured() const;
+
+  /// Places the calling thread according to its role. It has no effect for thread_role::none.
+  void apply(thread_role role);
+
+  /// NUMA node of the role, -1 if the role is not pinned to a single node.
+  int get_node(thread_role role) const;
+
+  /// Returns the NUMA topology, the CPU set of each role and the threads placed so far.
+  std::string get_report() const;
+
+private:
+  friend class scoped_thread_placement;
+
+  thread_placement() = default;
+
+  struct role_cfg_t {
+    bool      enabled = false;
+    cpu_set_t cpus;
+    int       node = -1;
+  };
+  struct placed_thread_t {
+    std::string name;
+    thread_role role;
+    int         cpu;
+    int         node;
+  };
+
+  /// Pins the calling thread and sets its memory policy, recording it for the report if requested.
+  void place(thread_role role, bool record);
+
+  mutable std::mutex                       mutex;
+  std::array<role_cfg_t, nof_thread_roles> roles             = {};
+  bool                                     numa_local_memory = true;
+  std::vector<placed_thread_t>             placed_threads;
+};
+
+/**
+ * Temporarily places the calling thread as a thread of the given role, restoring its affinity and memory policy on
+ * destruction. Used to allocate memory on the node of a role, and to place threads created by third party code, which
+ * inherit the affinity and memory policy of their creator.
+ */
+class scoped_thread_placement
+{
+public:
+  explicit scoped_thread_placement(thread_role role);
+  ~scoped_thread_placement();
+
+  scoped_thread_placement(const scoped_thread_placement&) = delete;
+  scoped_thread_placement& operator=(const scoped_thread_placement&) = delete;
+
+private:
+  bool      restore_affinity = false;
+  cpu_set_t prev_cpus;
+  int       prev_node = -1;
+};
+
+} // namespace isrran
+
+#endif // ISRRAN_THREAD_PLACEMENT_H
@@ -108,7 +108,11 @@ class task_thread_pool
   static constexpr uint32_t max_task_num   = 1u << max_task_shift;
 
 public:
-  task_thread_pool(uint32_t nof_workers = 1, bool start_deferred = false, int32_t prio_ = -1, uint32_t mask_ = 255);
+  task_thread_pool(uint32_t    nof_workers    = 1,
+                   bool        start_deferred = false,
+                   int32_t     prio_          = -1,
+                   uint32_t    mask_          = 255,
+                   thread_role role_          = thread_role::none);
   task_thread_pool(const task_thread_pool&) = delete;
   task_thread_pool(task_thread_pool&&)      = delete;
   task_thread_pool& operator=(const task_thread_pool&) = delete;
@@ -144,6 +148,7 @@ private:
 
   int32_t               prio = -1;
   uint32_t              mask = 255;
+  thread_role           role = thread_role::none;
   isrlog::basic_logger& logger;
 
   isrran::dyn_circular_buffer<task_t>     pending_tasks;
@@ -182,6 +187,7 @@ private:
   // args
   int32_t               prio = -1;
   uint32_t              mask = 255;
+  thread_role           role = thread_role::none;
   isrlog::basic_logger& logger;
 
   isrran::dyn_blocking_queue<task_t> pending_tasks;
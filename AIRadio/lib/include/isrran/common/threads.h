@@ -44,6 +44,7 @@ void threads_print_self();
 #ifdef __cplusplus
 }
 
+#include "isrran/common/thread_placement.h"
 #include <atomic>
 #include <string>
 
@@ -60,6 +61,7 @@ public:
   {
     _thread       = other._thread;
     name          = std::move(other.name);
+    role          = other.role;
     other._thread = 0;
     other.name    = "";
   }
@@ -81,6 +83,9 @@ public:
 
   void print_priority() { threads_print_self(); }
 
+  /// Sets the role used to place the thread on the CPUs and NUMA node configured for it, must be called before start.
+  void set_role(thread_role role_) { role = role_; }
+
   void set_name(const std::string& name_)
   {
     name = name_;
@@ -109,12 +114,14 @@ private:
   static void* thread_function_entry(void* _this)
   {
     pthread_setname_np(pthread_self(), ((thread*)_this)->name.c_str());
+    thread_placement::get_instance().apply(((thread*)_this)->role);
     ((thread*)_this)->run_thread();
     return NULL;
   }
 
   pthread_t   _thread;
   std::string name;
+  thread_role role = thread_role::none;
 };
 
 class periodic_thread : public thread
@@ -0,0 +1,125 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRRAN_TTI_LATENCY_H
+#define ISRRAN_TTI_LATENCY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
+namespace isrran {
+
+/// Stages of the processing of a TTI, in pipeline order.
+enum class tti_stage { rf_rx = 0, worker_start, ul_decode, mac_sched, dl_encode, rf_tx, nof_stages };
+
+const char* to_string(tti_stage stage);
+
+constexpr uint32_t nof_tti_stages = (uint32_t)tti_stage::nof_stages;
+
+/// Latency statistics of a stage over a metrics period, in microseconds.
+struct tti_stage_latency_t {
+  uint64_t nof_samples         = 0;
+  uint64_t nof_deadline_misses = 0;
+  float    p50_us              = 0.0f;
+  float    p99_us              = 0.0f;
+  float    p999_us             = 0.0f;
+  float    max_us              = 0.0f;
+};
+
+struct tti_latency_metrics_t {
+  uint32_t                                        deadline_us = 0;
+  std::array<tti_stage_latency_t, nof_tti_stages> stages      = {};
+
+  const tti_stage_latency_t& operator[](tti_stage stage) const { return stages[(uint32_t)stage]; }
+};
+
+/**
+ * Always-on latency histograms of the TTI processing pipeline.
+ *
+ * The latency of a stage is the time elapsed between the start of the TTI, signalled with tti_start() before the RF
+ * receive of its samples, and the completion of the stage, signalled with record(). A sample beyond the deadline,
+ * i.e. the time budget from the start to the transmission of the TTI, counts as a deadline miss of the stage.
+ *
+ * Recording takes a clock read and a couple of relaxed atomic increments on a histogram owned by the calling thread,
+ * there are no locks or allocations after the first record of each thread. The histograms have logarithmic buckets
+ * with 8 linear sub-buckets per power of two, so percentiles are accurate within 12.5%.
+ *
+ * get_metrics() merges the histograms of all the threads and returns the statistics since its previous call.
+ */
+class tti_latency
+{
+public:
+  explicit tti_latency(uint32_t deadline_us_);
+  ~tti_latency();
+
+  tti_latency(const tti_latency&) = delete;
+  tti_latency& operator=(const tti_latency&) = delete;
+
+  /// Marks the start of the TTI, before its samples are received, the reference of the stage latencies.
+  void tti_start(uint32_t tti);
+
+  /// Records the completion of a stage of the given TTI. It is ignored if the TTI start is no longer known.
+  void record(tti_stage stage, uint32_t tti);
+
+  /// Computes the statistics of the period since the previous call.
+  void get_metrics(tti_latency_metrics_t& metrics);
+
+  uint32_t get_deadline_us() const { return deadline_us; }
+
+  /// Histogram bucket helpers, exposed for testing.
+  static uint32_t latency_to_bucket(uint32_t latency_us);
+  static uint32_t bucket_to_latency(uint32_t bucket);
+
+  static const uint32_t nof_buckets = 160;
+
+private:
+  static const uint32_t max_threads  = 64;
+  static const uint32_t nof_tti_ring = 64;
+
+  struct histogram_t {
+    std::array<std::array<std::atomic<uint64_t>, nof_buckets>, nof_tti_stages> buckets;
+    std::array<std::atomic<uint64_t>, nof_tti_stages>                          misses;
+  };
+  using counters_t = std::array<std::array<uint64_t, nof_buckets + 1>, nof_tti_stages>;
+
+  uint64_t     now_us() const;
+  histogram_t& get_thread_histogram();
+
+  const uint32_t                              deadline_us;
+  const std::chrono::steady_clock::time_point epoch;
+
+  /// Start time of the latest TTIs, tagged with the TTI number in the upper bits.
+  std::array<std::atomic<uint64_t>, nof_tti_ring> tti_start_us;
+
+  std::array<std::atomic<histogram_t*>, max_threads> histograms;
+
+  /// Totals at the previous get_metrics() call, the last bucket of each stage holds the deadline misses.
+  std::mutex metrics_mutex;
+  counters_t last_counters = {};
+};
+
+} // namespace isrran
+
+#endif // ISRRAN_TTI_LATENCY_H
@@ -34,6 +34,7 @@ struct gtpu_args_t {
   std::string embms_m1u_if_addr;
   bool        embms_enable                 = false;
   uint32_t    indirect_tunnel_timeout_msec = 0;
+  uint32_t    tx_batch_size                = 1; ///< Max UL PDUs sent per sendmmsg call. 1 sends each PDU immediately
 };
 
 // GTPU interface for PDCP
@@ -35,6 +35,8 @@ struct mac_args_t {
   uint32_t                      nof_prealloc_ues; ///< Number of UE resources to pre-allocate at eNB startup
   uint32_t                      max_nof_kos;
   int                           rlf_min_ul_snr_estim;
+  bool                          softbuffer_pool;     ///< UL softbuffers take their code blocks from a shared pool
+  bool                          softbuffer_llr_8bit; ///< UL softbuffers store 8-bit soft bits for the 8-bit PUSCH decoder
 };
 
 /* Interface PHY -> MAC */
@@ -29,6 +29,7 @@
 #include "isrenb/hdr/stack/mac/common/mac_metrics.h"
 #include "isrenb/hdr/stack/rrc/rrc_metrics.h"
 #include "isrenb/hdr/stack/s1ap/s1ap_metrics.h"
+#include "isrenb/hdr/stack/upper/gtpu_metrics.h"
 #include "isrran/common/metrics_hub.h"
 #include "isrran/radio/radio_metrics.h"
 #include "isrran/rlc/rlc_metrics.h"
@@ -52,11 +53,13 @@ struct stack_metrics_t {
   rlc_metrics_t  rlc;
   pdcp_metrics_t pdcp;
   s1ap_metrics_t s1ap;
+  gtpu_metrics_t gtpu;
 };
 
 struct enb_metrics_t {
   isrran::rf_metrics_t       rf;
   std::vector<phy_metrics_t> phy;
+  phy_latency_metrics_t      phy_latency;
   stack_metrics_t            stack;
   stack_metrics_t            nr_stack;
   isrran::sys_metrics_t      sys;
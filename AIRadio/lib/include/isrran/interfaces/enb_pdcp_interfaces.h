@@ -19,6 +19,7 @@
  *
  */
 
+#include "isrran/adt/span.h"
 #include "isrran/common/byte_buffer.h"
 #include "isrran/interfaces/pdcp_interface_types.h"
 #include <map>
@@ -34,6 +35,17 @@ class pdcp_interface_gtpu
 public:
   virtual void write_sdu(uint16_t rnti, uint32_t lcid, isrran::unique_byte_buffer_t sdu, int pdcp_sn = -1) = 0;
   virtual std::map<uint32_t, isrran::unique_byte_buffer_t> get_buffered_pdus(uint16_t rnti, uint32_t lcid) = 0;
+
+  /// Write a burst of SDUs of the same bearer, in order. pdcp_sns holds the PDCP SN of each SDU, or -1 if unknown
+  virtual void write_sdus(uint16_t                                   rnti,
+                          uint32_t                                   lcid,
+                          isrran::span<isrran::unique_byte_buffer_t> sdus,
+                          isrran::span<const int>                    pdcp_sns)
+  {
+    for (size_t i = 0; i < sdus.size(); ++i) {
+      write_sdu(rnti, lcid, std::move(sdus[i]), pdcp_sns[i]);
+    }
+  }
 };
 
 // PDCP interface for RRC
@@ -64,6 +64,7 @@ struct phy_args_t {
   uint32_t pdsch_max_its   = 8;
   bool     meas_evm        = false;
   uint32_t nof_phy_threads = 3;
+  uint32_t nof_ue_threads  = 2; ///< Threads decoding the additional UEs of a multi-UE simulation
 
   int worker_cpu_mask   = -1;
   int sync_cpu_affinity = -1;
@@ -27,4 +27,15 @@
 #define ISRLOG_QUEUE_CAPACITY 8192
 #endif
 
+/// Capacity of the queue owned by each thread that pushes log entries into the backend.
+#ifndef ISRLOG_PRODUCER_QUEUE_CAPACITY
+#define ISRLOG_PRODUCER_QUEUE_CAPACITY 2048
+#endif
+
+/// Maximum number of threads owning a dedicated queue in the backend. Entries from additional threads, or from threads
+/// whose queue is full, go through a shared queue of ISRLOG_QUEUE_CAPACITY elements.
+#ifndef ISRLOG_MAX_PRODUCER_THREADS
+#define ISRLOG_MAX_PRODUCER_THREADS 64
+#endif
+
 #endif // ISRLOG_DETAIL_SUPPORT_BACKEND_CAPACITY_H
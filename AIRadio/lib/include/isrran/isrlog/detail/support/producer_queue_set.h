@@ -0,0 +1,185 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRLOG_DETAIL_SUPPORT_PRODUCER_QUEUE_SET_H
+#define ISRLOG_DETAIL_SUPPORT_PRODUCER_QUEUE_SET_H
+
+#include "isrran/isrlog/detail/support/backend_capacity.h"
+#include "isrran/isrlog/detail/support/spsc_queue.h"
+#include "isrran/isrlog/detail/support/work_queue.h"
+#include <memory>
+#include <thread>
+
+namespace isrlog {
+
+namespace detail {
+
+/// Returns a process wide unique identifier for a producer_queue_set instance.
+inline uint64_t next_producer_queue_set_id()
+{
+  static std::atomic<uint64_t> counter{0};
+  return ++counter;
+}
+
+/// Multiple producer, single consumer queue built from one lock free SPSC queue per producer thread. The first push of
+/// a thread registers a queue for it, later pushes reach it through a thread local cache without any locking.
+/// The consumer merges the heads of all queues, always popping the element that compares lowest according to the
+/// Compare functor, so that the output follows a global order (e.g. timestamps) across threads.
+/// Threads beyond max_producers, or whose queue is full, fall back to a shared mutex guarded queue.
+/// NOTE: push is thread safe, try_pop must only be called from a single consumer thread.
+template <typename T, typename Compare>
+class producer_queue_set
+{
+public:
+  explicit producer_queue_set(size_t queue_capacity = ISRLOG_PRODUCER_QUEUE_CAPACITY,
+                              size_t max_producers  = ISRLOG_MAX_PRODUCER_THREADS) :
+    queue_capacity(queue_capacity)
+  {
+    queues.resize(max_producers);
+    owners.resize(max_producers);
+  }
+
+  producer_queue_set(const producer_queue_set&) = delete;
+  producer_queue_set& operator=(const producer_queue_set&) = delete;
+
+  /// Inserts a new element into the queue of the calling thread. Returns false when there is no room left for it,
+  /// in which case the value is left untouched.
+  bool push(T&& value)
+  {
+    spsc_queue<T>* q = get_thread_queue();
+    if (q && q->push(std::move(value))) {
+      return true;
+    }
+    return overflow.push(std::move(value));
+  }
+
+  /// Extracts the lowest ordered element amongst the heads of all the queues if it exists.
+  /// Returns a pair with a bool indicating if the pop has been successful.
+  std::pair<bool, T> try_pop()
+  {
+    if (!overflow_staged) {
+      auto item = overflow.try_pop();
+      if (item.first) {
+        overflow_head   = std::move(item.second);
+        overflow_staged = true;
+      }
+    }
+
+    T*             best       = overflow_staged ? &overflow_head : nullptr;
+    spsc_queue<T>* best_queue = nullptr;
+    size_t         n          = nof_queues.load(std::memory_order_acquire);
+    for (size_t i = 0; i != n; ++i) {
+      T* head = queues[i]->front();
+      if (head && (!best || cmp(*head, *best))) {
+        best       = head;
+        best_queue = queues[i].get();
+      }
+    }
+
+    if (!best) {
+      return {false, T()};
+    }
+
+    T item = std::move(*best);
+    if (best_queue) {
+      best_queue->pop();
+    } else {
+      overflow_head   = T();
+      overflow_staged = false;
+    }
+    return {true, std::move(item)};
+  }
+
+  /// Capacity of each producer queue.
+  size_t get_capacity() const { return queue_capacity; }
+
+  /// Returns true when any of the queues is almost full, otherwise returns false.
+  bool is_almost_full() const
+  {
+    size_t n = nof_queues.load(std::memory_order_acquire);
+    for (size_t i = 0; i != n; ++i) {
+      if (queues[i]->size() > threshold * queues[i]->get_capacity()) {
+        return true;
+      }
+    }
+    return overflow.is_almost_full();
+  }
+
+private:
+  /// Returns the queue owned by the calling thread, registering a new one on its first call. Returns nullptr when the
+  /// maximum number of producers has been reached.
+  spsc_queue<T>* get_thread_queue()
+  {
+    struct cache_entry {
+      uint64_t       owner_id = 0;
+      spsc_queue<T>* queue    = nullptr;
+    };
+    static thread_local cache_entry cache;
+
+    if (cache.owner_id == id) {
+      return cache.queue;
+    }
+
+    scoped_lock    lock(registration_mutex);
+    spsc_queue<T>* q   = nullptr;
+    size_t         n   = nof_queues.load(std::memory_order_relaxed);
+    auto           tid = std::this_thread::get_id();
+    for (size_t i = 0; i != n; ++i) {
+      if (owners[i] == tid) {
+        q = queues[i].get();
+        break;
+      }
+    }
+    if (!q && n != queues.size()) {
+      queues[n] = std::unique_ptr<spsc_queue<T> >(new spsc_queue<T>(queue_capacity));
+      owners[n] = tid;
+      q         = queues[n].get();
+      // Publish the new queue to the consumer.
+      nof_queues.store(n + 1, std::memory_order_release);
+    }
+
+    cache.owner_id = id;
+    cache.queue    = q;
+    return q;
+  }
+
+private:
+  static constexpr double threshold = 0.98;
+
+  const uint64_t                               id = next_producer_queue_set_id();
+  const size_t                                 queue_capacity;
+  std::vector<std::unique_ptr<spsc_queue<T> > > queues;
+  std::vector<std::thread::id>                 owners;
+  std::atomic<size_t>                          nof_queues{0};
+  mutex                                        registration_mutex;
+  work_queue<T>                                overflow;
+  Compare                                      cmp;
+
+  // Element extracted from the overflow queue waiting to be merged, only accessed by the consumer.
+  bool overflow_staged = false;
+  T    overflow_head;
+};
+
+} // namespace detail
+
+} // namespace isrlog
+
+#endif // ISRLOG_DETAIL_SUPPORT_PRODUCER_QUEUE_SET_H
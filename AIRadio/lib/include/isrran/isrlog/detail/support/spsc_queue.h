@@ -0,0 +1,123 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRLOG_DETAIL_SUPPORT_SPSC_QUEUE_H
+#define ISRLOG_DETAIL_SUPPORT_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+namespace isrlog {
+
+namespace detail {
+
+/// Bounded lock free queue for exactly one producer thread and one consumer thread. The capacity is rounded up to the
+/// next power of two. Read and write indexes live in separate cache lines, and each side caches the last observed index
+/// of the other side so that the shared cache line is only touched when the cached value says the queue looks full
+/// (producer) or empty (consumer).
+template <typename T>
+class spsc_queue
+{
+  static constexpr size_t cache_line_size = 64;
+
+public:
+  explicit spsc_queue(size_t capacity_) : mask(round_up_pow2(capacity_) - 1), buffer(mask + 1) {}
+
+  spsc_queue(const spsc_queue&) = delete;
+  spsc_queue& operator=(const spsc_queue&) = delete;
+
+  /// Inserts a new element into the back of the queue. Returns false when the queue is full, in which case the value
+  /// is left untouched. Must only be called from the producer thread.
+  bool push(T&& value)
+  {
+    size_t w = write_idx.load(std::memory_order_relaxed);
+    if (w - cached_read_idx > mask) {
+      cached_read_idx = read_idx.load(std::memory_order_acquire);
+      if (w - cached_read_idx > mask) {
+        return false;
+      }
+    }
+    buffer[w & mask] = std::move(value);
+    write_idx.store(w + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Returns a pointer to the oldest element of the queue, or nullptr when it is empty. The element stays valid until
+  /// pop() is called. Must only be called from the consumer thread.
+  T* front()
+  {
+    size_t r = read_idx.load(std::memory_order_relaxed);
+    if (r == cached_write_idx) {
+      cached_write_idx = write_idx.load(std::memory_order_acquire);
+      if (r == cached_write_idx) {
+        return nullptr;
+      }
+    }
+    return &buffer[r & mask];
+  }
+
+  /// Removes the oldest element of the queue. front() must have returned a valid pointer before calling this function.
+  /// Must only be called from the consumer thread.
+  void pop()
+  {
+    size_t r = read_idx.load(std::memory_order_relaxed);
+    assert(r != cached_write_idx && "Queue is empty");
+    // Release the resources held by the element now instead of when the slot gets overwritten.
+    buffer[r & mask] = T();
+    read_idx.store(r + 1, std::memory_order_release);
+  }
+
+  /// Number of elements in the queue. The value is approximate when called concurrently with push or pop.
+  size_t size() const { return write_idx.load(std::memory_order_acquire) - read_idx.load(std::memory_order_acquire); }
+
+  /// Capacity of the queue.
+  size_t get_capacity() const { return mask + 1; }
+
+private:
+  static size_t round_up_pow2(size_t n)
+  {
+    size_t v = 1;
+    while (v < n) {
+      v <<= 1;
+    }
+    return v;
+  }
+
+private:
+  const size_t   mask;
+  std::vector<T> buffer;
+
+  // Padding is used instead of alignas since over-aligned heap allocations are not supported before C++17.
+  char                pad0[cache_line_size];
+  std::atomic<size_t> write_idx{0};
+  size_t              cached_read_idx = 0;
+  char                pad1[cache_line_size];
+  std::atomic<size_t> read_idx{0};
+  size_t              cached_write_idx = 0;
+  char                pad2[cache_line_size];
+};
+
+} // namespace detail
+
+} // namespace isrlog
+
+#endif // ISRLOG_DETAIL_SUPPORT_SPSC_QUEUE_H
@@ -156,6 +156,11 @@ std::unique_ptr<log_formatter> create_text_formatter();
 /// Creates a new instance of a JSON formatter.
 std::unique_ptr<log_formatter> create_json_formatter();
 
+/// Creates a new instance of a binary formatter. Entries are stored as compact
+/// records with their raw arguments, leaving the formatting to the
+/// isrlog_decode tool.
+std::unique_ptr<log_formatter> create_binary_formatter();
+
 ///
 /// Sink management functions.
 ///
@@ -195,6 +200,12 @@ sink& fetch_file_sink(const std::string&             path,
                       bool                           force_flush = false,
                       std::unique_ptr<log_formatter> f           = get_default_log_formatter());
 
+/// Returns an instance of a sink that writes log entries in binary form into a
+/// memory mapped file in the specified path. No formatting takes place when
+/// logging, use the isrlog_decode tool to render the file as text or JSON.
+/// The file grows in steps of chunk_size bytes.
+sink& fetch_binary_file_sink(const std::string& path, size_t chunk_size = 64 * 1024 * 1024);
+
 /// Returns an instance of a sink that writes into syslog
 /// preamble: The string  prepended to every message, If ident is "", the program name is used.
 /// log_local: custom unused facilities that syslog provides which can be used by the user
@@ -0,0 +1,129 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRLOG_TRACE_RING_H
+#define ISRLOG_TRACE_RING_H
+
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <string>
+
+namespace isrlog {
+
+/// The trace ring is a low overhead alternative to the event trace framework meant to be left enabled in real time
+/// code. Each thread records events into its own fixed size ring, overwriting the oldest events, so recording an event
+/// is a couple of stores: no locks, no formatting, no memory allocation. Event names are registered once per
+/// instrumentation point and referenced by a numeric id, and timestamps are read from the CPU time stamp counter when
+/// available.
+/// The rings are exported on demand to the Chrome trace event JSON format, which can be opened with Perfetto
+/// (ui.perfetto.dev) or chrome://tracing to look at the latest events of every thread in a single timeline.
+///
+/// Usage:
+///   trace_ring_event("phy", "work_dl", tti);   // Scoped event, ends at the end of the enclosing scope.
+///   trace_ring_instant("mac", "rach", rnti);   // Single point in time event.
+/// The argument is an optional 32 bit value attached to the event (e.g. a TTI or an RNTI).
+
+/// Enables event recording. Each thread that records events gets a ring with room for the specified number of
+/// events, rounded up to a power of two. Calling this function more than once has no effect.
+void trace_ring_init(uint32_t nof_events_per_thread = 1u << 16u);
+
+/// Returns true when event recording is enabled.
+bool trace_ring_is_enabled();
+
+/// Writes the events currently held in all the rings into the specified file in Chrome trace event JSON format.
+/// Recording continues while the file is written, and the oldest event of each ring is left out as it may be under
+/// overwrite. Returns true on success, otherwise false.
+bool trace_ring_dump(const std::string& filename);
+
+/// Starts a helper thread that dumps the rings into the specified file each time the process receives the specified
+/// signal. Calling this function more than once has no effect.
+void trace_ring_dump_on_signal(const std::string& filename, int signum = SIGUSR2);
+
+/// Stops the helper thread started by trace_ring_dump_on_signal.
+void trace_ring_stop();
+
+namespace detail {
+
+/// Event types, matching the Chrome trace event phases.
+enum class trace_ring_phase : uint8_t { begin, end, instant };
+
+/// Global enable flag, checked before recording an event.
+extern std::atomic<bool> trace_ring_enabled;
+
+/// Registers an instrumentation point returning its id. The strings must outlive the trace ring (e.g. literals).
+uint16_t trace_ring_register(const char* category, const char* name);
+
+/// Records an event into the ring of the calling thread.
+void trace_ring_push(uint16_t id, trace_ring_phase phase, uint32_t arg);
+
+/// Scoped type object recording the begin and end of an event.
+class scoped_trace_ring_event
+{
+public:
+  scoped_trace_ring_event(uint16_t id, uint32_t arg) :
+    id(id), arg(arg), active(trace_ring_enabled.load(std::memory_order_relaxed))
+  {
+    if (active) {
+      trace_ring_push(id, trace_ring_phase::begin, arg);
+    }
+  }
+
+  ~scoped_trace_ring_event()
+  {
+    if (active) {
+      trace_ring_push(id, trace_ring_phase::end, arg);
+    }
+  }
+
+  scoped_trace_ring_event(const scoped_trace_ring_event&) = delete;
+  scoped_trace_ring_event& operator=(const scoped_trace_ring_event&) = delete;
+
+private:
+  const uint16_t id;
+  const uint32_t arg;
+  const bool     active;
+};
+
+} // namespace detail
+
+} // namespace isrlog
+
+#define ISRLOG_TRACE_RING_COMBINE1(X, Y) X##Y
+#define ISRLOG_TRACE_RING_COMBINE(X, Y) ISRLOG_TRACE_RING_COMBINE1(X, Y)
+
+/// Records a scoped event with the given category and name literals and an integer argument.
+#define trace_ring_event(C, N, ARG)                                                                                    \
+  static const uint16_t ISRLOG_TRACE_RING_COMBINE(trace_ring_id, __LINE__) =                                           \
+      isrlog::detail::trace_ring_register(C, N);                                                                       \
+  isrlog::detail::scoped_trace_ring_event ISRLOG_TRACE_RING_COMBINE(trace_ring_event, __LINE__)(                      \
+      ISRLOG_TRACE_RING_COMBINE(trace_ring_id, __LINE__), ARG)
+
+/// Records an instant event with the given category and name literals and an integer argument.
+#define trace_ring_instant(C, N, ARG)                                                                                  \
+  do {                                                                                                                 \
+    if (isrlog::detail::trace_ring_enabled.load(std::memory_order_relaxed)) {                                          \
+      static const uint16_t trace_ring_id = isrlog::detail::trace_ring_register(C, N);                                \
+      isrlog::detail::trace_ring_push(trace_ring_id, isrlog::detail::trace_ring_phase::instant, ARG);                 \
+    }                                                                                                                  \
+  } while (0)
+
+#endif // ISRLOG_TRACE_RING_H
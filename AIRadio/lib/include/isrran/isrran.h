@@ -38,6 +38,7 @@ extern "C" {
 #include "isrran/phy/utils/cexptab.h"
 #include "isrran/phy/utils/convolution.h"
 #include "isrran/phy/utils/debug.h"
+#include "isrran/phy/utils/hugepage.h"
 #include "isrran/phy/utils/ringbuffer.h"
 #include "isrran/phy/utils/vector.h"
 
@@ -34,6 +34,8 @@
 
 namespace isrran {
 
+class task_thread_pool;
+
 class channel
 {
 public:
@@ -69,25 +71,47 @@ public:
     uint32_t rlf_t_off_ms = 2000;
   };
 
+  /// One call to run() of a channel instance, see run_batch()
+  struct batch_item_t {
+    channel*           ch                       = nullptr;
+    cf_t*              in[ISRRAN_MAX_CHANNELS]  = {};
+    cf_t*              out[ISRRAN_MAX_CHANNELS] = {};
+    uint32_t           len                      = 0;
+    isrran_timestamp_t t                        = {};
+  };
+
   channel(const args_t& channel_args, uint32_t _nof_channels, isrlog::basic_logger& logger);
   ~channel();
   void set_srate(uint32_t srate);
   void set_signal_power_dBfs(float power_dBfs);
+
+  /// If a pool is given, run() processes the RF channels of this instance concurrently in it
+  void set_thread_pool(task_thread_pool* pool_) { pool = pool_; }
+
   void run(cf_t* in[ISRRAN_MAX_CHANNELS], cf_t* out[ISRRAN_MAX_CHANNELS], uint32_t len, const isrran_timestamp_t& t);
 
+  /// Runs several channel instances at once, every RF channel of every instance is a separate task in the pool.
+  /// Returns when all of them are done. An instance must not appear more than once in the batch.
+  static void run_batch(task_thread_pool& batch_pool, batch_item_t* items, uint32_t nof_items);
+
 private:
+  void run_begin(const isrran_timestamp_t& t);
+  void run_port(uint32_t i, const cf_t* in, cf_t* out, uint32_t len, const isrran_timestamp_t& t);
+  void run_end(uint32_t len, const isrran_timestamp_t& t);
+
   isrlog::basic_logger&    logger;
-  float                    hst_init_phase              = 0.0f;
-  isrran_channel_fading_t* fading[ISRRAN_MAX_CHANNELS] = {};
-  isrran_channel_delay_t*  delay[ISRRAN_MAX_CHANNELS]  = {};
-  isrran_channel_awgn_t*   awgn                        = nullptr;
-  isrran_channel_hst_t*    hst                         = nullptr;
-  isrran_channel_rlf_t*    rlf                         = nullptr;
-  cf_t*                    buffer_in                   = nullptr;
-  cf_t*                    buffer_out                  = nullptr;
-  uint32_t                 nof_channels                = 0;
-  uint32_t                 current_srate               = 0;
-  args_t                   args                        = {};
+  float                    hst_init_phase                  = 0.0f;
+  isrran_channel_fading_t* fading[ISRRAN_MAX_CHANNELS]     = {};
+  isrran_channel_delay_t*  delay[ISRRAN_MAX_CHANNELS]      = {};
+  isrran_channel_awgn_t*   awgn[ISRRAN_MAX_CHANNELS]       = {};
+  isrran_channel_hst_t*    hst                             = nullptr;
+  isrran_channel_rlf_t*    rlf                             = nullptr;
+  cf_t*                    buffer_in[ISRRAN_MAX_CHANNELS]  = {};
+  cf_t*                    buffer_out[ISRRAN_MAX_CHANNELS] = {};
+  uint32_t                 nof_channels                    = 0;
+  uint32_t                 current_srate                   = 0;
+  args_t                   args                            = {};
+  task_thread_pool*        pool                            = nullptr;
 };
 
 typedef std::unique_ptr<channel> channel_ptr;
@@ -37,8 +37,11 @@ typedef struct {
   float    delay_us;
   uint32_t delay_nsamples;
 
-  isrran_ringbuffer_t rb;
-  cf_t*               zero_buffer;
+  // Delay line, a circular buffer owned by a single thread
+  cf_t*    line;
+  uint32_t line_size;  // Capacity in samples
+  uint32_t line_head;  // Index of the oldest sample
+  uint32_t line_count; // Number of buffered samples
 } isrran_channel_delay_t;
 
 #ifdef __cplusplus
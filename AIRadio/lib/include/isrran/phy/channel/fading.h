@@ -52,7 +52,7 @@ typedef struct {
   float coeff_alpha[ISRRAN_CHANNEL_FADING_MAXTAPS][ISRRAN_CHANNEL_FADING_NTERMS]; // Angle of arrival
   float coeff_a[ISRRAN_CHANNEL_FADING_MAXTAPS][ISRRAN_CHANNEL_FADING_NTERMS];     // Random phase
   float coeff_b[ISRRAN_CHANNEL_FADING_MAXTAPS][ISRRAN_CHANNEL_FADING_NTERMS];     // Random phase
-  cf_t* h_tap[ISRRAN_CHANNEL_FADING_MAXTAPS]; // Static tap signal in frequency domain
+  cf_t* h_tap[ISRRAN_CHANNEL_FADING_MAXTAPS]; // Static tap signal in frequency domain, FFT-shifted
 
   // Utils
   isrran_dft_plan_t fft;             // DFT to frequency domain
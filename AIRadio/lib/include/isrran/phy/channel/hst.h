@@ -49,6 +49,12 @@ ISRRAN_API int isrran_channel_hst_init(isrran_channel_hst_t* q, float fd_hz, flo
 
 ISRRAN_API void isrran_channel_hst_update_srate(isrran_channel_hst_t* q, uint32_t srate);
 
+/* Computes the doppler shift at the given time, stored in fs_hz */
+ISRRAN_API void isrran_channel_hst_update(isrran_channel_hst_t* q, const isrran_timestamp_t* ts);
+
+/* Applies the doppler shift computed by the last isrran_channel_hst_update(), does not modify q */
+ISRRAN_API void isrran_channel_hst_apply(const isrran_channel_hst_t* q, const cf_t* in, cf_t* out, uint32_t len);
+
 ISRRAN_API void
 isrran_channel_hst_execute(isrran_channel_hst_t* q, cf_t* in, cf_t* out, uint32_t len, const isrran_timestamp_t* ts);
 
@@ -63,6 +63,16 @@ typedef struct ISRRAN_API {
 
 } isrran_enb_ul_t;
 
+/* Additional PUSCH decoder that works on the resource grid of an eNB UL object. It has its own channel estimator and
+ * PUSCH decoder so that several users of the same subframe can be decoded concurrently after a single FFT. */
+typedef struct ISRRAN_API {
+  isrran_enb_ul_t*      enb_ul;
+  isrran_chest_ul_res_t chest_res;
+
+  isrran_chest_ul_t chest;
+  isrran_pusch_t    pusch;
+} isrran_enb_ul_pusch_t;
+
 /* This function shall be called just after the initial synchronization */
 ISRRAN_API int isrran_enb_ul_init(isrran_enb_ul_t* q, cf_t* in_buffer, uint32_t max_prb);
 
@@ -85,4 +95,18 @@ ISRRAN_API int isrran_enb_ul_get_pusch(isrran_enb_ul_t*    q,
                                        isrran_pusch_cfg_t* cfg,
                                        isrran_pusch_res_t* res);
 
+ISRRAN_API int isrran_enb_ul_pusch_init(isrran_enb_ul_pusch_t* q, uint32_t max_prb);
+
+ISRRAN_API void isrran_enb_ul_pusch_free(isrran_enb_ul_pusch_t* q);
+
+ISRRAN_API int isrran_enb_ul_pusch_set_cell(isrran_enb_ul_pusch_t*             q,
+                                            isrran_enb_ul_t*                   enb_ul,
+                                            isrran_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
+                                            isrran_refsignal_isr_cfg_t*        isr_cfg);
+
+ISRRAN_API int isrran_enb_ul_pusch_decode(isrran_enb_ul_pusch_t* q,
+                                          isrran_ul_sf_cfg_t*    ul_sf,
+                                          isrran_pusch_cfg_t*    cfg,
+                                          isrran_pusch_res_t*    res);
+
 #endif // ISRRAN_ENB_UL_H
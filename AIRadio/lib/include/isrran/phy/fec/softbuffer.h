@@ -25,6 +25,15 @@
  *  Description:  Buffer for RX and TX soft bits. This should be provided by MAC.
  *                Provided here basically for the examples.
  *
+ *                The RX soft-buffers may store the soft bits with 8 bits, when the
+ *                decoder uses 8-bit LLRs, and may take their code block buffers on
+ *                demand from a pool shared by all the soft-buffers. On-demand
+ *                soft-buffers only hold the code blocks of the transport block
+ *                being decoded, between isrran_softbuffer_rx_reset_tbs() and
+ *                isrran_softbuffer_rx_reset(). Each thread caches the free code block
+ *                buffers it releases, so that the pool is only locked to refill or
+ *                spill a cache.
+ *
  *  Reference:
  *****************************************************************************/
 
@@ -32,6 +41,7 @@
 #define ISRRAN_SOFTBUFFER_H
 
 #include "isrran/config.h"
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -45,8 +55,24 @@ typedef struct ISRRAN_API {
   uint8_t** data;
   bool*     cb_crc;
   bool      tb_crc;
+  bool      llr_8bit;  // Soft bits are stored as int8_t, buffer_f must be cast
+  bool      on_demand; // Code block buffers are taken from the shared pool when needed
 } isrran_softbuffer_rx_t;
 
+typedef struct ISRRAN_API {
+  uint32_t max_cb;
+  uint32_t max_cb_size;
+  bool     llr_8bit;
+  bool     on_demand;
+} isrran_softbuffer_rx_args_t;
+
+typedef struct ISRRAN_API {
+  uint32_t nof_blocks; // Code block buffers allocated by the pool
+  uint32_t nof_used;   // Code block buffers attached to a soft-buffer
+  uint32_t peak_used;  // Maximum number of code block buffers attached at the same time
+  uint64_t nof_bytes;  // Memory allocated by the pool
+} isrran_softbuffer_pool_stats_t;
+
 typedef struct ISRRAN_API {
   uint32_t  max_cb;
   uint32_t  max_cb_size;
@@ -67,6 +93,15 @@ ISRRAN_API int isrran_softbuffer_rx_init(isrran_softbuffer_rx_t* q, uint32_t nof
  */
 ISRRAN_API int isrran_softbuffer_rx_init_guru(isrran_softbuffer_rx_t* q, uint32_t max_cb, uint32_t max_cb_size);
 
+/**
+ * @brief Initialises Rx soft-buffer with the soft bit width and the allocation mode of its code blocks
+ * @param q The Rx soft-buffer pointer
+ * @param args The soft-buffer arguments
+ * @return It returns ISRRAN_SUCCESS if it initialises the soft-buffer successfully, otherwise it returns ISRRAN_ERROR
+ * code
+ */
+ISRRAN_API int isrran_softbuffer_rx_init_args(isrran_softbuffer_rx_t* q, const isrran_softbuffer_rx_args_t* args);
+
 ISRRAN_API void isrran_softbuffer_rx_reset(isrran_softbuffer_rx_t* p);
 
 ISRRAN_API void isrran_softbuffer_rx_reset_tbs(isrran_softbuffer_rx_t* q, uint32_t tbs);
@@ -84,6 +119,17 @@ ISRRAN_API void isrran_softbuffer_rx_free(isrran_softbuffer_rx_t* p);
  */
 ISRRAN_API void isrran_softbuffer_rx_reset_cb_crc(isrran_softbuffer_rx_t* q, uint32_t nof_cb);
 
+/**
+ * @brief Pre-allocates code block buffers in the pool of the on-demand soft-buffers
+ * @param max_cb_size The code block size of the soft-buffers using them
+ * @param llr_8bit Whether the soft-buffers using them store 8-bit soft bits
+ * @param nof_cb Number of code block buffers to add to the pool
+ * @return ISRRAN_SUCCESS if the buffers are allocated, ISRRAN_ERROR otherwise
+ */
+ISRRAN_API int isrran_softbuffer_pool_reserve(uint32_t max_cb_size, bool llr_8bit, uint32_t nof_cb);
+
+ISRRAN_API void isrran_softbuffer_pool_get_stats(isrran_softbuffer_pool_stats_t* stats);
+
 ISRRAN_API int isrran_softbuffer_tx_init(isrran_softbuffer_tx_t* q, uint32_t nof_prb);
 
 /**
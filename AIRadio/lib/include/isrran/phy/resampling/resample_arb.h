@@ -49,10 +49,25 @@ typedef struct ISRRAN_API {
   bool  interpolate;
   cf_t  reg[ISRRAN_RESAMPLE_ARB_M]; // Our window of samples
 
+  // Rational ratio mode, only used if initialised with isrran_resample_arb_init_ratio()
+  uint32_t  up;         // Interpolation factor, number of output phases
+  uint32_t  down;       // Decimation factor, input samples consumed every up outputs
+  uint32_t  phase;      // Next output phase
+  uint32_t  skip;       // Input index of the next output relative to the start of the next block
+  uint32_t* phase_cnt;  // Input offset of every output phase
+  float*    phase_taps; // Precomputed (and interpolated) taps of every output phase, interleaved for complex input
+
 } isrran_resample_arb_t;
 
 ISRRAN_API void isrran_resample_arb_init(isrran_resample_arb_t* q, float rate, bool interpolate);
 
+/* Initialises the resampler for a rational rate up/down. The filter taps of every output phase are computed once,
+ * blending adjacent polyphase rows if interpolate is set, so every output costs a single dot product. The sample
+ * history is kept between calls to isrran_resample_arb_compute(). */
+ISRRAN_API int isrran_resample_arb_init_ratio(isrran_resample_arb_t* q, uint32_t up, uint32_t down, bool interpolate);
+
+ISRRAN_API void isrran_resample_arb_free(isrran_resample_arb_t* q);
+
 ISRRAN_API int isrran_resample_arb_compute(isrran_resample_arb_t* q, cf_t* input, cf_t* output, int n_in);
 
 #endif // ISRRAN_RESAMPLE_ARB_
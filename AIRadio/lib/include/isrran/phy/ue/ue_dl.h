@@ -180,6 +180,10 @@ ISRRAN_API int isrran_ue_dl_decode_fft_estimate_noguru(isrran_ue_dl_t*     q,
                                                        isrran_ue_dl_cfg_t* cfg,
                                                        cf_t*               input[ISRRAN_MAX_PORTS]);
 
+/* Imports the resource grid and channel estimates produced by decode_fft_estimate() on another object configured
+ * for the same cell, so that several UEs can share the demodulation. sf->cfi must be the CFI decoded by src */
+ISRRAN_API int isrran_ue_dl_copy_estimate(isrran_ue_dl_t* q, const isrran_ue_dl_t* src, isrran_dl_sf_cfg_t* sf);
+
 /* Finds UL/DL DCI in the signal processed in a previous call to decode_fft_estimate() */
 ISRRAN_API int isrran_ue_dl_find_ul_dci(isrran_ue_dl_t*     q,
                                         isrran_dl_sf_cfg_t* sf,
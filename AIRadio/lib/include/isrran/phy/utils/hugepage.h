@@ -0,0 +1,108 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         hugepage.h
+ *
+ *  Description:  Huge page backing of the PHY buffers.
+ *
+ *                The softbuffers, the largest per UE buffers, are allocated from
+ *                an arena of huge pages with isrran_hugepage_malloc() and released
+ *                with isrran_hugepage_free(). The arena is made of hugetlbfs pages
+ *                in HUGETLB mode, falling back to transparent huge pages if none
+ *                are reserved in the system.
+ *
+ *                The buffers allocated with isrran_vec_malloc() are released with
+ *                free(), so they can not come from the arena. Optionally, a range of
+ *                the heap is reserved and advised for transparent huge pages once at
+ *                init, so that the large buffers allocated next by the main thread
+ *                are carved from it. This changes the process-wide malloc mmap and
+ *                trim thresholds, hence it is only done when requested.
+ *
+ *                Huge pages are disabled by default.
+ *****************************************************************************/
+
+#ifndef ISRRAN_HUGEPAGE_H
+#define ISRRAN_HUGEPAGE_H
+
+#include "isrran/config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ISRRAN_HUGEPAGE_SIZE (2UL * 1024UL * 1024UL)
+
+typedef enum { ISRRAN_HUGEPAGE_NONE = 0, ISRRAN_HUGEPAGE_THP, ISRRAN_HUGEPAGE_HUGETLB } isrran_hugepage_mode_t;
+
+typedef struct {
+  isrran_hugepage_mode_t mode;
+  bool                   arena_hugetlb;   // The arena is made of hugetlbfs pages, otherwise transparent huge pages
+  uint64_t               arena_size;      // Arena size in bytes
+  uint64_t               arena_used;      // Bytes currently allocated from the arena
+  uint64_t               arena_peak;      // Maximum number of bytes allocated from the arena
+  uint64_t               nof_allocs;      // Allocations served by the arena
+  uint64_t               nof_frees;       // Blocks returned to the arena
+  uint64_t               nof_fallbacks;   // Allocations served by the heap because the arena was full
+  uint64_t               advised_bytes;   // Heap bytes reserved and advised for transparent huge pages at init
+  uint64_t               anon_huge_bytes; // Anonymous memory of the process backed by transparent huge pages
+} isrran_hugepage_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ISRRAN_API const char* isrran_hugepage_mode_string(isrran_hugepage_mode_t mode);
+
+/* Parses "none", "thp" or "hugetlb". Returns ISRRAN_ERROR if the string is not a valid mode */
+ISRRAN_API int isrran_hugepage_mode_parse(const char* str, isrran_hugepage_mode_t* mode);
+
+/* Enables the huge pages with an arena of arena_size bytes. If heap_size is not 0, also reserves heap_size bytes of the
+ * heap for the isrran_vec_malloc() buffers, raising M_MMAP_THRESHOLD and M_TRIM_THRESHOLD for the whole process. Must be
+ * called by the main thread before the PHY objects are initialised */
+ISRRAN_API int isrran_hugepage_init(isrran_hugepage_mode_t mode, size_t arena_size, size_t heap_size);
+
+/* Disables the huge pages and releases the arena. All the arena blocks must have been freed */
+ISRRAN_API void isrran_hugepage_exit(void);
+
+ISRRAN_API isrran_hugepage_mode_t isrran_hugepage_get_mode(void);
+
+/* Allocates an aligned buffer from the arena, or with isrran_vec_malloc() if the arena is disabled or full */
+ISRRAN_API void* isrran_hugepage_malloc(size_t size);
+
+/* Releases a buffer obtained with isrran_hugepage_malloc() */
+ISRRAN_API void isrran_hugepage_free(void* ptr);
+
+ISRRAN_API void isrran_hugepage_get_stats(isrran_hugepage_stats_t* stats);
+
+/* Writes a one line summary of the statistics into str. Returns the number of characters written */
+ISRRAN_API uint32_t isrran_hugepage_stats_info(char* str, uint32_t str_len);
+
+/* Data TLB load miss counter of the calling thread, used to measure the effect of huge pages. Returns -1 if the
+ * performance counters are not available */
+ISRRAN_API int      isrran_dtlb_counter_open(void);
+ISRRAN_API uint64_t isrran_dtlb_counter_read(int fd);
+ISRRAN_API void     isrran_dtlb_counter_close(int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ISRRAN_HUGEPAGE_H
@@ -0,0 +1,44 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/asn1/asn1_arena.h"
+#include <algorithm>
+
+namespace asn1 {
+
+void* arena::allocate(size_t size)
+{
+  size = (size + alignment - 1) & ~(alignment - 1);
+  if (static_cast<size_t>(end - cur) < size) {
+    // The remainder of the current chunk is left unused
+    size_t new_chunk_size = std::max(size, chunk_size);
+    chunks.emplace_back(new uint8_t[new_chunk_size]);
+    cur = chunks.back().get();
+    end = cur + new_chunk_size;
+  }
+  void* ptr = cur;
+  cur += size;
+  nof_allocs++;
+  nof_allocated_bytes += size;
+  return ptr;
+}
+
+} // namespace asn1
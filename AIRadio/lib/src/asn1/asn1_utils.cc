@@ -144,12 +144,48 @@ int bit_ref_impl<Ptr>::distance_bytes_end() const
   return ((int)(max_ptr - ptr)) - ((offset) ? 1 : 0);
 }
 
-ISRASN_CODE bit_ref::pack(uint64_t val, uint32_t n_bits)
+/// Reads the 8 octets starting at ptr as a big endian word, in which the first bit of the buffer is the MSB
+static inline uint64_t load_be64(const uint8_t* ptr)
+{
+  uint64_t word = 0;
+  for (uint32_t i = 0; i < 8; ++i) {
+    word = (word << 8u) | ptr[i];
+  }
+  return word;
+}
+
+static inline void store_be64(uint8_t* ptr, uint64_t word)
+{
+  for (uint32_t i = 0; i < 8; ++i) {
+    ptr[i] = static_cast<uint8_t>(word >> (56u - 8u * i));
+  }
+}
+
+ISRASN_CODE bit_ref::pack_bits(uint64_t val, uint32_t n_bits)
 {
   if (n_bits >= 64) {
     log_error("This method only supports packing up to 64 bits");
     return ISRASN_ERROR_ENCODE_FAIL;
   }
+  if (n_bits == 0) {
+    return ISRASN_SUCCESS;
+  }
+  uint32_t end_bit = offset + n_bits;
+  if (end_bit <= 64 and max_ptr - ptr >= 8) {
+    // Word access. The bits of the last written octet that follow the packed value are zeroed, and the next octets
+    // are left untouched
+    const uint64_t ones       = std::numeric_limits<uint64_t>::max();
+    uint32_t       nof_octets = (end_bit + 7) / 8;
+    uint64_t       write_mask = (ones >> offset) & (nof_octets == 8 ? ones : ~(ones >> (8 * nof_octets)));
+    uint64_t       word       = load_be64(ptr) & ~write_mask;
+    word |= (val & (ones >> (64 - n_bits))) << (64 - end_bit);
+    store_be64(ptr, word);
+    ptr += end_bit / 8;
+    offset = end_bit % 8;
+    return ISRASN_SUCCESS;
+  }
+
+  // Octet access, close to the end of the buffer
   uint64_t mask;
   while (n_bits > 0) {
     if (ptr >= max_ptr) {
@@ -183,6 +219,19 @@ ISRASN_CODE unpack_bits(T& val, Ptr& ptr, uint8_t& offset, const uint8_t* max_pt
     return ISRASN_ERROR_DECODE_FAIL;
   }
   val = 0;
+  if (n_bits == 0) {
+    return ISRASN_SUCCESS;
+  }
+  uint32_t end_bit = offset + n_bits;
+  if (end_bit <= 64 and max_ptr - ptr >= 8) {
+    // Word access
+    val = static_cast<T>((load_be64(ptr) << offset) >> (64 - n_bits));
+    ptr += end_bit / 8;
+    offset = end_bit % 8;
+    return ISRASN_SUCCESS;
+  }
+
+  // Octet access, close to the end of the buffer
   while (n_bits > 0) {
     if (ptr >= max_ptr) {
       log_error("unpack_bits: Buffer size limit was achieved");
@@ -255,12 +304,20 @@ ISRASN_CODE bit_ref_impl<Ptr>::unpack_bytes(uint8_t* buf, uint32_t n_bytes)
     memcpy(buf, ptr, n_bytes);
     ptr += n_bytes;
   } else {
-    // Unaligned case
+    // Unaligned case, in chunks of 7 octets that fit in a word together with the bit offset
     if (ptr + n_bytes >= max_ptr) {
       log_error("unpack_bytes (unaligned): Buffer size limit was achieved");
       return ISRASN_ERROR_DECODE_FAIL;
     }
-    for (uint32_t i = 0; i < n_bytes; ++i) {
+    uint32_t i = 0;
+    for (; i + 7 <= n_bytes; i += 7) {
+      uint64_t chunk;
+      HANDLE_CODE(unpack(chunk, 56));
+      for (uint32_t j = 0; j < 7; ++j) {
+        buf[i + j] = static_cast<uint8_t>(chunk >> (48u - 8u * j));
+      }
+    }
+    for (; i < n_bytes; ++i) {
       HANDLE_CODE(unpack(buf[i], 8));
     }
   }
@@ -285,8 +342,8 @@ template <typename Ptr>
 ISRASN_CODE bit_ref_impl<Ptr>::advance_bits(uint32_t n_bits)
 {
   uint32_t extra_bits     = (offset + n_bits) % 8;
-  uint32_t bytes_required = ceilf((offset + n_bits) / 8.0f);
-  uint32_t bytes_offset   = floorf((offset + n_bits) / 8.0f);
+  uint32_t bytes_required = (offset + n_bits + 7) / 8;
+  uint32_t bytes_offset   = (offset + n_bits) / 8;
 
   if (ptr + bytes_required > max_ptr) {
     log_error("advance_bytes: Buffer size limit was achieved");
@@ -314,7 +371,8 @@ ISRASN_CODE bit_ref::pack_bytes(const uint8_t* buf, uint32_t n_bytes)
   if (n_bytes == 0) {
     return ISRASN_SUCCESS;
   }
-  if (ptr + n_bytes >= max_ptr) {
+  // The unaligned case writes the first bits of one more octet
+  if (ptr + n_bytes + (offset > 0 ? 1 : 0) > max_ptr) {
     log_error("pack_bytes: Buffer size limit was achieved");
     return ISRASN_ERROR_ENCODE_FAIL;
   }
@@ -323,7 +381,16 @@ ISRASN_CODE bit_ref::pack_bytes(const uint8_t* buf, uint32_t n_bytes)
     memcpy(ptr, buf, n_bytes);
     ptr += n_bytes;
   } else {
-    for (uint32_t i = 0; i < n_bytes; ++i) {
+    // Unaligned case, in chunks of 7 octets that fit in a word together with the bit offset
+    uint32_t i = 0;
+    for (; i + 7 <= n_bytes; i += 7) {
+      uint64_t chunk = 0;
+      for (uint32_t j = 0; j < 7; ++j) {
+        chunk = (chunk << 8u) | buf[i + j];
+      }
+      pack(chunk, 56);
+    }
+    for (; i < n_bytes; ++i) {
       pack(buf[i], 8);
     }
   }
@@ -345,6 +412,22 @@ ISRASN_CODE bit_ref::align_bytes_zero()
   return ISRASN_SUCCESS;
 }
 
+void patch_bits(uint8_t* buf, uint32_t bit_offset, uint64_t val, uint32_t n_bits)
+{
+  uint8_t* ptr    = buf + bit_offset / 8;
+  uint32_t offset = bit_offset % 8;
+  while (n_bits > 0) {
+    uint32_t nof_bits = std::min(n_bits, 8 - offset);
+    uint32_t shift    = 8 - offset - nof_bits;
+    auto     mask     = static_cast<uint8_t>(((1u << nof_bits) - 1u) << shift);
+    auto     bits     = static_cast<uint8_t>(((val >> (n_bits - nof_bits)) << shift) & mask);
+    *ptr              = (*ptr & ~mask) | bits;
+    n_bits -= nof_bits;
+    offset = 0;
+    ptr++;
+  }
+}
+
 /*********************
      ext packing
 *********************/
@@ -1021,9 +1104,7 @@ template <bool Al>
 ISRASN_CODE unbounded_octstring<Al>::pack(bit_ref& bref) const
 {
   HANDLE_CODE(pack_length(bref, size(), aligned));
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.pack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.pack_bytes(data(), size()));
   return ISRASN_SUCCESS;
 }
 
@@ -1033,9 +1114,7 @@ ISRASN_CODE unbounded_octstring<Al>::unpack(cbit_ref& bref)
   uint32_t len;
   HANDLE_CODE(unpack_length(len, bref, aligned));
   resize(len);
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.unpack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.unpack_bytes(data(), size()));
   return ISRASN_SUCCESS;
 }
 
@@ -1452,9 +1531,7 @@ varlength_field_pack_guard::~varlength_field_pack_guard()
   pack_length(brefstart, nof_bytes, align);
 
   // pack encoded bytes
-  for (uint32_t i = 0; i < nof_bytes; ++i) {
-    brefstart.pack((*buffer_ptr)[i], 8);
-  }
+  brefstart.pack_bytes(buffer_ptr->data(), nof_bytes);
   *bref_tracker = brefstart;
 }
 
@@ -24,25 +24,24 @@
 #include "isrran/common/threads.h"
 
 namespace isrran {
-mac_pcap::mac_pcap() : mac_pcap_base() {}
+mac_pcap::mac_pcap() : mac_pcap_base(), writer(logger) {}
 
 mac_pcap::~mac_pcap()
 {
   close();
 }
 
-uint32_t mac_pcap::open(std::string filename_, uint32_t ue_id_)
+uint32_t mac_pcap::open(std::string filename_, uint32_t ue_id_, const pcap_writer_args& args)
 {
   std::lock_guard<std::mutex> lock(mutex);
-  if (pcap_file != nullptr) {
+  if (writer.is_open()) {
     logger.error("PCAP writer for %s already running. Close first.", filename_.c_str());
     return ISRRAN_ERROR;
   }
 
-  // set UDP DLT
-  dlt       = UDP_DLT;
-  pcap_file = DLT_PCAP_Open(dlt, filename_.c_str());
-  if (pcap_file == nullptr) {
+  // set UDP DLT, both RATs are written to the same file but are kept as separate interfaces in pcapng files
+  dlt = UDP_DLT;
+  if (writer.open(filename_, {{dlt, "mac-lte"}, {dlt, "mac-nr"}}, args) != ISRRAN_SUCCESS) {
     logger.error("Couldn't open %s to write PCAP", filename_.c_str());
     return ISRRAN_ERROR;
   }
@@ -61,7 +60,7 @@ uint32_t mac_pcap::close()
 {
   {
     std::lock_guard<std::mutex> lock(mutex);
-    if (running == false || pcap_file == nullptr) {
+    if (running == false || not writer.is_open()) {
       return ISRRAN_ERROR;
     }
 
@@ -77,8 +76,7 @@ uint32_t mac_pcap::close()
   {
     std::lock_guard<std::mutex> lock(mutex);
     isrran::console("Saving MAC PCAP (DLT=%d) to %s\n", dlt, filename.c_str());
-    DLT_PCAP_Close(pcap_file);
-    pcap_file = nullptr;
+    writer.close();
   }
 
   return ISRRAN_SUCCESS;
@@ -87,12 +85,16 @@ uint32_t mac_pcap::close()
 void mac_pcap::write_pdu(isrran::mac_pcap_base::pcap_pdu_t& pdu)
 {
   if (pdu.pdu != nullptr) {
+    uint8_t header[PCAP_CONTEXT_HEADER_MAX];
+    int     header_len = 0;
     switch (pdu.rat) {
       case isrran_rat_t::lte:
-        LTE_PCAP_MAC_UDP_WritePDU(pcap_file, &pdu.context, pdu.pdu->msg, pdu.pdu->N_bytes);
+        header_len = LTE_PCAP_MAC_UDP_PACK_HEADER(&pdu.context, pdu.pdu->N_bytes, header, sizeof(header));
+        writer.write_pdu(0, header, header_len, pdu.pdu->msg, pdu.pdu->N_bytes);
         break;
       case isrran_rat_t::nr:
-        NR_PCAP_MAC_UDP_WritePDU(pcap_file, &pdu.context_nr, pdu.pdu->msg, pdu.pdu->N_bytes);
+        header_len = NR_PCAP_MAC_UDP_PACK_HEADER(&pdu.context_nr, pdu.pdu->N_bytes, header, sizeof(header));
+        writer.write_pdu(1, header, header_len, pdu.pdu->msg, pdu.pdu->N_bytes);
         break;
       default:
         logger.error("Error writing PDU to PCAP. Unsupported RAT selected.");
@@ -100,4 +102,10 @@ void mac_pcap::write_pdu(isrran::mac_pcap_base::pcap_pdu_t& pdu)
   }
 }
 
+void mac_pcap::write_idle()
+{
+  // Make the records visible to readers of the file while the traffic is low
+  writer.flush();
+}
+
 } // namespace isrran
\ No newline at end of file
@@ -27,6 +27,11 @@
 
 namespace isrran {
 
+/// Maximum number of PDUs written by the writer thread without releasing the mutex.
+static const uint32_t max_pdus_per_batch = 64;
+/// Time without new PDUs after which the writer thread lets the pcap class flush its records.
+static const std::chrono::milliseconds idle_period(500);
+
 /// Try to flush the contents of the pcap class before the application is killed.
 static void emergency_cleanup_handler(void* data)
 {
@@ -59,11 +64,18 @@ void mac_pcap_base::set_ue_id(uint16_t ue_id_)
 
 void mac_pcap_base::run_thread()
 {
-  // blocking write until stopped
+  // blocking write until stopped, draining the queue in batches
   while (running) {
-    pcap_pdu_t pdu = queue.pop_blocking();
-    {
+    pcap_pdu_t pdu = {};
+    if (not queue.pop_wait_until(pdu, std::chrono::steady_clock::now() + idle_period)) {
       std::lock_guard<std::mutex> lock(mutex);
+      write_idle();
+      continue;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    write_pdu(pdu);
+    for (uint32_t i = 1; i < max_pdus_per_batch && queue.try_pop(pdu); ++i) {
       write_pdu(pdu);
     }
   }
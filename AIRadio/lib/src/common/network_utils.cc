@@ -22,6 +22,7 @@
 #include "isrran/common/network_utils.h"
 
 #include <netinet/sctp.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h> // for the pipe
@@ -400,6 +401,9 @@ socket_manager::socket_manager() : thread("RXsockets"), socket_manager_itf(isrlo
   // register control pipe fd
   int fd = pipe(pipefd);
   isrran_assert(fd != -1, "Failed to open control pipe");
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  isrran_assert(epoll_fd != -1, "Failed to create epoll instance");
+  set_role(thread_role::gtpu);
   start(thread_prio);
 }
 
@@ -431,11 +435,26 @@ void socket_manager::stop()
     pipefd[1] = -1;
     rxSockDebug("closed.");
   }
+  if (epoll_fd >= 0) {
+    close(epoll_fd);
+    epoll_fd = -1;
+  }
 }
 
 bool socket_manager::add_socket_handler(int fd, recv_callback_t handler)
 {
   std::lock_guard<std::mutex> lock(socket_mutex);
+  return add_socket_handler_unprotected(fd, std::move(handler), false);
+}
+
+bool socket_manager::add_edge_socket_handler(int fd, recv_callback_t handler)
+{
+  std::lock_guard<std::mutex> lock(socket_mutex);
+  return add_socket_handler_unprotected(fd, std::move(handler), true);
+}
+
+bool socket_manager::add_socket_handler_unprotected(int fd, recv_callback_t handler, bool edge_triggered)
+{
   if (fd < 0) {
     rxSockError("Provided SCTP socket must be already open");
     return false;
@@ -449,8 +468,9 @@ bool socket_manager::add_socket_handler(int fd, recv_callback_t handler)
 
   // this unlocks the reading thread to add new connections
   ctrl_cmd_t msg;
-  msg.cmd    = ctrl_cmd_t::cmd_id_t::NEW_FD;
-  msg.new_fd = fd;
+  msg.cmd            = ctrl_cmd_t::cmd_id_t::NEW_FD;
+  msg.new_fd         = fd;
+  msg.edge_triggered = edge_triggered;
   if (write(pipefd[1], &msg, sizeof(msg)) != sizeof(msg)) {
     rxSockError("while writing to control pipe");
     return false;
@@ -495,68 +515,75 @@ bool socket_manager::remove_socket(int fd)
   return result;
 }
 
-std::map<int, socket_manager::recv_callback_t>::iterator
-socket_manager::remove_socket_unprotected(int fd, fd_set* total_fd_set, int* max_fd)
+bool socket_manager::remove_socket_unprotected(int fd)
 {
   if (fd < 0) {
     rxSockError("fd to be removed is not valid");
-    return active_sockets.end();
+    return false;
+  }
+  active_sockets.erase(fd);
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr) == -1 and errno != EBADF and errno != ENOENT) {
+    rxSockError("Unable to remove fd=%d from epoll: %s", fd, strerror(errno));
   }
-  auto it = active_sockets.find(fd);
-  it      = active_sockets.erase(it);
-  FD_CLR(fd, total_fd_set);
-  // assumes ordering
-  *max_fd = (active_sockets.empty()) ? pipefd[0] : std::max(pipefd[0], active_sockets.rbegin()->first);
   rxSockDebug("Socket fd=%d has been successfully removed", fd);
-  return it;
+  return true;
 }
 
 void socket_manager::run_thread()
 {
   running = true;
-  fd_set total_fd_set, read_fd_set;
-  FD_ZERO(&total_fd_set);
-  int max_fd = 0;
 
-  FD_SET(pipefd[0], &total_fd_set);
-  max_fd = std::max(pipefd[0], max_fd);
+  epoll_event ctrl_ev = {};
+  ctrl_ev.events      = EPOLLIN;
+  ctrl_ev.data.fd     = pipefd[0];
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipefd[0], &ctrl_ev) == -1) {
+    rxSockError("Unable to register control pipe in epoll: %s", strerror(errno));
+    running = false;
+    return;
+  }
 
+  std::vector<epoll_event> events(max_nof_events);
   while (running.load(std::memory_order_relaxed)) {
-    memcpy(&read_fd_set, &total_fd_set, sizeof(total_fd_set));
-    int n = select(max_fd + 1, &read_fd_set, nullptr, nullptr, nullptr);
+    int n = epoll_wait(epoll_fd, events.data(), max_nof_events, -1);
 
-    // handle select return
+    // handle epoll_wait return
     if (n == -1) {
-      rxSockError("Error from select(%d,...). Number of rx sockets: %d", max_fd + 1, (int)active_sockets.size() + 1);
+      if (errno != EINTR) {
+        rxSockError("Error from epoll_wait(). Number of rx sockets: %d", (int)active_sockets.size() + 1);
+      }
       continue;
     }
     if (n == 0) {
-      rxSockDebug("No data from select.");
+      rxSockDebug("No data from epoll_wait.");
       continue;
     }
 
     // Shared state area
     std::lock_guard<std::mutex> lock(socket_mutex);
 
-    // call read callback for all SCTP/TCP/UDP connections
-    for (auto handler_it = active_sockets.begin(); handler_it != active_sockets.end();) {
-      int              fd       = handler_it->first;
-      recv_callback_t& callback = handler_it->second;
-      if (not FD_ISSET(fd, &read_fd_set)) {
-        ++handler_it;
+    // call read callback for all ready SCTP/TCP/UDP connections. Ctrl messages are handled last, as in the event list
+    // order they could remove a socket that still has pending events in this batch
+    bool ctrl_pending = false;
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == pipefd[0]) {
+        ctrl_pending = true;
+        continue;
+      }
+      auto handler_it = active_sockets.find(fd);
+      if (handler_it == active_sockets.end()) {
+        // removed by a previous callback of this batch
         continue;
       }
-      bool socket_valid = callback(fd);
+      bool socket_valid = handler_it->second(fd);
       if (not socket_valid) {
         rxSockInfo("The socket fd=%d has been closed by peer", fd);
-        handler_it = remove_socket_unprotected(fd, &total_fd_set, &max_fd);
-      } else {
-        ++handler_it;
+        remove_socket_unprotected(fd);
       }
     }
 
     // handle ctrl messages
-    if (FD_ISSET(pipefd[0], &read_fd_set)) {
+    if (ctrl_pending) {
       ctrl_cmd_t msg;
       ssize_t    nrd = read(pipefd[0], &msg, sizeof(msg));
       if (nrd <= 0) {
@@ -569,19 +596,28 @@ void socket_manager::run_thread()
           return;
         case ctrl_cmd_t::cmd_id_t::NEW_FD:
           if (msg.new_fd >= 0) {
-            FD_SET(msg.new_fd, &total_fd_set);
-            max_fd = std::max(max_fd, msg.new_fd);
+            epoll_event ev = {};
+            ev.events      = msg.edge_triggered ? (EPOLLIN | EPOLLET) : EPOLLIN;
+            ev.data.fd     = msg.new_fd;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, msg.new_fd, &ev) == -1) {
+              rxSockError("Unable to add fd=%d to epoll: %s", msg.new_fd, strerror(errno));
+            } else if (msg.edge_triggered) {
+              // data that arrived before registration does not generate an edge
+              auto handler_it = active_sockets.find(msg.new_fd);
+              if (handler_it != active_sockets.end() and not handler_it->second(msg.new_fd)) {
+                remove_socket_unprotected(msg.new_fd);
+              }
+            }
           } else {
             rxSockError("added fd is not valid");
           }
           break;
         case ctrl_cmd_t::cmd_id_t::RM_FD:
-          remove_socket_unprotected(msg.new_fd, &total_fd_set, &max_fd);
+          remove_socket_unprotected(msg.new_fd);
           if (msg.signal_rm_complete) {
             rem_fd_tmp_list.push_back(msg.new_fd);
             rem_cvar.notify_one();
           }
-          rxSockDebug("Socket fd=%d has been successfully removed", msg.new_fd);
           break;
         default:
           rxSockError("ctrl message command %d is not valid", (int)msg.cmd);
@@ -701,4 +737,178 @@ make_sdu_handler(isrlog::basic_logger& logger, isrran::task_queue_handle& queue,
   return socket_manager_itf::recv_callback_t(recvfrom_pdu_task(logger, queue, std::move(rx_callback)));
 }
 
+/**
+ * Description: Reads the datagrams pending in a socket with recvmmsg(...), in batches of up to batch_size, into byte
+ * buffers that are allocated ahead of the system call and refilled after each batch
+ */
+class recvmmsg_reader
+{
+public:
+  explicit recvmmsg_reader(isrlog::basic_logger& logger, uint32_t batch_size) :
+    logger(logger), pdus(std::max(batch_size, 1U)), from(pdus.size()), iovs(pdus.size()), msgs(pdus.size())
+  {}
+
+  /// Received datagram i of the last batch, which must be moved out by the caller
+  isrran::unique_byte_buffer_t& pdu(int i) { return pdus[i]; }
+  const sockaddr_in&            addr(int i) const { return from[i]; }
+
+  /// Reads the next batch of n_recv datagrams. Returns false when the socket has no more data.
+  bool recv(int fd, int& n_recv)
+  {
+    n_recv = 0;
+
+    // Refill the byte buffers consumed by the previous batch
+    uint32_t nof_bufs = 0;
+    for (; nof_bufs < pdus.size(); ++nof_bufs) {
+      if (pdus[nof_bufs] == nullptr) {
+        pdus[nof_bufs] = isrran::make_byte_buffer();
+        if (pdus[nof_bufs] == nullptr) {
+          logger.error("Unable to allocate byte buffer");
+          break;
+        }
+      }
+      iovs[nof_bufs].iov_base            = pdus[nof_bufs]->msg;
+      iovs[nof_bufs].iov_len             = pdus[nof_bufs]->get_tailroom();
+      msgs[nof_bufs]                     = {};
+      msgs[nof_bufs].msg_hdr.msg_name    = &from[nof_bufs];
+      msgs[nof_bufs].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      msgs[nof_bufs].msg_hdr.msg_iov     = &iovs[nof_bufs];
+      msgs[nof_bufs].msg_hdr.msg_iovlen  = 1;
+    }
+    if (nof_bufs == 0) {
+      // The pending datagrams are dropped, otherwise the edge would be lost
+      drain(fd);
+      return false;
+    }
+
+    int ret = recvmmsg(fd, msgs.data(), nof_bufs, MSG_DONTWAIT, nullptr);
+    if (ret == -1) {
+      if (errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR) {
+        logger.error("Error reading from socket: %s", strerror(errno));
+      }
+      return false;
+    }
+    for (int i = 0; i < ret; ++i) {
+      pdus[i]->N_bytes = msgs[i].msg_len;
+    }
+    n_recv = ret;
+
+    // a partial batch means the socket was drained
+    return (uint32_t)ret == nof_bufs;
+  }
+
+private:
+  void drain(int fd)
+  {
+    uint8_t dummy;
+    while (::recv(fd, &dummy, sizeof(dummy), MSG_DONTWAIT) >= 0) {
+    }
+  }
+
+  isrlog::basic_logger&                     logger;
+  std::vector<isrran::unique_byte_buffer_t> pdus;
+  std::vector<sockaddr_in>                  from;
+  std::vector<iovec>                        iovs;
+  std::vector<mmsghdr>                      msgs;
+};
+
+/**
+ * Description: Functor that reads all the datagrams pending in the socket with recvmmsg(...), and dispatches each of
+ * them as a separate task
+ */
+class recvmmsg_pdu_task
+{
+public:
+  using callback_t = recvfrom_callback_t;
+  explicit recvmmsg_pdu_task(isrlog::basic_logger&      logger,
+                             isrran::task_queue_handle& queue_,
+                             callback_t                 func_,
+                             uint32_t                   batch_size) :
+    reader(logger, batch_size), queue(queue_), func(std::move(func_))
+  {}
+
+  bool operator()(int fd)
+  {
+    bool more   = true;
+    int  n_recv = 0;
+    while (more) {
+      more = reader.recv(fd, n_recv);
+
+      // Defer handling of received packets to provided queue
+      for (int i = 0; i < n_recv; ++i) {
+        queue.push(std::bind(
+            [this, addr = reader.addr(i)](isrran::unique_byte_buffer_t& sdu) { func(std::move(sdu), addr); },
+            std::move(reader.pdu(i))));
+      }
+    }
+    return true;
+  }
+
+private:
+  recvmmsg_reader            reader;
+  isrran::task_queue_handle& queue;
+  callback_t                 func;
+};
+
+/**
+ * Description: Functor that reads all the datagrams pending in the socket with recvmmsg(...), and dispatches the
+ * datagrams of each system call as a single task
+ */
+class recvmmsg_burst_task
+{
+public:
+  using callback_t = recvfrom_burst_callback_t;
+  explicit recvmmsg_burst_task(isrlog::basic_logger&      logger,
+                               isrran::task_queue_handle& queue_,
+                               callback_t                 func_,
+                               uint32_t                   batch_size) :
+    reader(logger, batch_size), queue(queue_), func(std::move(func_))
+  {}
+
+  bool operator()(int fd)
+  {
+    bool more   = true;
+    int  n_recv = 0;
+    while (more) {
+      more = reader.recv(fd, n_recv);
+      if (n_recv == 0) {
+        continue;
+      }
+
+      recvfrom_burst_t burst;
+      burst.pdus.reserve(n_recv);
+      burst.from.reserve(n_recv);
+      for (int i = 0; i < n_recv; ++i) {
+        burst.pdus.push_back(std::move(reader.pdu(i)));
+        burst.from.push_back(reader.addr(i));
+      }
+
+      // Defer handling of the burst to provided queue
+      queue.push(std::bind([this](recvfrom_burst_t& b) { func(b); }, std::move(burst)));
+    }
+    return true;
+  }
+
+private:
+  recvmmsg_reader            reader;
+  isrran::task_queue_handle& queue;
+  callback_t                 func;
+};
+
+socket_manager_itf::recv_callback_t make_sdu_batch_handler(isrlog::basic_logger&      logger,
+                                                           isrran::task_queue_handle& queue,
+                                                           recvfrom_callback_t        rx_callback,
+                                                           uint32_t                   batch_size)
+{
+  return socket_manager_itf::recv_callback_t(recvmmsg_pdu_task(logger, queue, std::move(rx_callback), batch_size));
+}
+
+socket_manager_itf::recv_callback_t make_sdu_burst_handler(isrlog::basic_logger&      logger,
+                                                           isrran::task_queue_handle& queue,
+                                                           recvfrom_burst_callback_t  rx_callback,
+                                                           uint32_t                   batch_size)
+{
+  return socket_manager_itf::recv_callback_t(recvmmsg_burst_task(logger, queue, std::move(rx_callback), batch_size));
+}
+
 } // namespace isrran
@@ -0,0 +1,274 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/common/numa.h"
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace isrran;
+
+namespace {
+
+// Memory policy modes, see linux/mempolicy.h
+const int mpol_default   = 0;
+const int mpol_preferred = 1;
+
+// Node masks are limited to one word, the kernel ignores the last bit of maxnode
+const uint32_t      max_nodes    = 8 * sizeof(unsigned long);
+const unsigned long mask_maxnode = max_nodes + 1;
+
+struct topology_t {
+  std::vector<cpu_set_t> nodes;
+  std::vector<uint32_t>  cpu_to_node;
+
+  topology_t()
+  {
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string   list;
+    cpu_set_t     node_set;
+    if (online and std::getline(online, list) and numa::parse_cpu_list(list, node_set)) {
+      for (uint32_t n = 0; n < max_nodes; n++) {
+        if (not CPU_ISSET(n, &node_set)) {
+          continue;
+        }
+        nodes.resize(n + 1);
+        CPU_ZERO(&nodes[n]);
+        std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+        std::string   cpus;
+        if (cpulist and std::getline(cpulist, cpus)) {
+          numa::parse_cpu_list(cpus, nodes[n]);
+        }
+      }
+    }
+
+    // Without NUMA information, all the CPUs belong to node 0
+    if (nodes.empty()) {
+      nodes.resize(1);
+      CPU_ZERO(&nodes[0]);
+      long nof_cpus = sysconf(_SC_NPROCESSORS_CONF);
+      for (long cpu = 0; cpu < nof_cpus and cpu < CPU_SETSIZE; cpu++) {
+        CPU_SET(cpu, &nodes[0]);
+      }
+    }
+
+    cpu_to_node.assign(CPU_SETSIZE, 0);
+    for (uint32_t n = 0; n < nodes.size(); n++) {
+      for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &nodes[n])) {
+          cpu_to_node[cpu] = n;
+        }
+      }
+    }
+  }
+};
+
+const topology_t& get_topology()
+{
+  static topology_t topology;
+  return topology;
+}
+
+std::mutex            memory_nodes_mutex;
+std::vector<uint32_t> memory_nodes;
+
+} // namespace
+
+uint32_t numa::nof_nodes()
+{
+  return get_topology().nodes.size();
+}
+
+uint32_t numa::cpu_node(uint32_t cpu)
+{
+  return (cpu < CPU_SETSIZE) ? get_topology().cpu_to_node[cpu] : 0;
+}
+
+cpu_set_t numa::node_cpus(uint32_t node)
+{
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (node < nof_nodes()) {
+    cpus = get_topology().nodes[node];
+  }
+  return cpus;
+}
+
+uint32_t numa::current_node()
+{
+  int cpu = sched_getcpu();
+  return (cpu < 0) ? 0 : cpu_node(cpu);
+}
+
+bool numa::set_preferred_node(int node)
+{
+  if (nof_nodes() <= 1) {
+    return true;
+  }
+  if (node < 0) {
+    return syscall(SYS_set_mempolicy, mpol_default, nullptr, 0) == 0;
+  }
+  if ((uint32_t)node >= max_nodes) {
+    return false;
+  }
+  unsigned long mask = 1UL << (uint32_t)node;
+  return syscall(SYS_set_mempolicy, mpol_preferred, &mask, mask_maxnode) == 0;
+}
+
+int numa::get_preferred_node()
+{
+  if (nof_nodes() <= 1) {
+    return -1;
+  }
+  int           mode = mpol_default;
+  unsigned long mask = 0;
+  if (syscall(SYS_get_mempolicy, &mode, &mask, mask_maxnode, nullptr, 0) != 0 or mode != mpol_preferred or
+      mask == 0) {
+    return -1;
+  }
+  return __builtin_ctzl(mask);
+}
+
+void* numa::alloc_on_node(size_t len, int node)
+{
+  // The policy of the thread is changed while mapping, as the pages are populated by mmap when memory is locked
+  bool bind = node >= 0 and nof_nodes() > 1;
+  int  prev = bind ? get_preferred_node() : -1;
+  if (bind) {
+    set_preferred_node(node);
+  }
+
+  void* ptr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) {
+    ptr = nullptr;
+  } else if (bind) {
+    unsigned long mask = 1UL << (uint32_t)node;
+    syscall(SYS_mbind, ptr, len, mpol_preferred, &mask, mask_maxnode, 0);
+  }
+
+  if (bind) {
+    set_preferred_node(prev);
+  }
+  return ptr;
+}
+
+void numa::free_on_node(void* ptr, size_t len)
+{
+  if (ptr != nullptr) {
+    munmap(ptr, len);
+  }
+}
+
+bool numa::parse_cpu_list(const std::string& list, cpu_set_t& cpus)
+{
+  CPU_ZERO(&cpus);
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    std::string range = list.substr(pos, end - pos);
+    pos               = end + 1;
+
+    // Ignore blanks around the ranges
+    size_t first = range.find_first_not_of(" \t\n");
+    if (first == std::string::npos) {
+      continue;
+    }
+    range = range.substr(first, range.find_last_not_of(" \t\n") - first + 1);
+
+    char*         str_end = nullptr;
+    unsigned long lo      = strtoul(range.c_str(), &str_end, 10);
+    unsigned long hi      = lo;
+    if (str_end == range.c_str()) {
+      return false;
+    }
+    if (*str_end == '-') {
+      const char* hi_str = str_end + 1;
+      hi                 = strtoul(hi_str, &str_end, 10);
+      if (str_end == hi_str) {
+        return false;
+      }
+    }
+    if (*str_end != '\0' or lo > hi or hi >= CPU_SETSIZE) {
+      return false;
+    }
+    for (unsigned long cpu = lo; cpu <= hi; cpu++) {
+      CPU_SET(cpu, &cpus);
+    }
+  }
+  return true;
+}
+
+std::string numa::cpu_list_to_string(const cpu_set_t& cpus)
+{
+  std::string str;
+  for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (not CPU_ISSET(cpu, &cpus)) {
+      continue;
+    }
+    uint32_t last = cpu;
+    while (last + 1 < CPU_SETSIZE and CPU_ISSET(last + 1, &cpus)) {
+      last++;
+    }
+    if (not str.empty()) {
+      str += ",";
+    }
+    str += std::to_string(cpu);
+    if (last > cpu) {
+      str += "-" + std::to_string(last);
+    }
+    cpu = last;
+  }
+  return str;
+}
+
+int numa::cpu_set_node(const cpu_set_t& cpus)
+{
+  int node = -1;
+  for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (not CPU_ISSET(cpu, &cpus)) {
+      continue;
+    }
+    int cpu_node_idx = (int)cpu_node(cpu);
+    if (node >= 0 and node != cpu_node_idx) {
+      return -1;
+    }
+    node = cpu_node_idx;
+  }
+  return node;
+}
+
+void numa::set_memory_nodes(const std::vector<uint32_t>& nodes)
+{
+  std::lock_guard<std::mutex> lock(memory_nodes_mutex);
+  memory_nodes = nodes;
+}
+
+std::vector<uint32_t> numa::get_memory_nodes()
+{
+  std::lock_guard<std::mutex> lock(memory_nodes_mutex);
+  return memory_nodes;
+}
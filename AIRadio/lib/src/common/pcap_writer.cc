@@ -0,0 +1,639 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/common/pcap_writer.h"
+#include "isrran/common/pcap.h"
+#include "isrran/config.h"
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace isrran {
+
+namespace {
+
+/// pcapng block types and constants.
+const uint32_t pcapng_shb_type      = 0x0a0d0d0a;
+const uint32_t pcapng_idb_type      = 0x00000001;
+const uint32_t pcapng_epb_type      = 0x00000006;
+const uint32_t pcapng_byte_order    = 0x1a2b3c4d;
+const uint16_t pcapng_opt_endofopt  = 0;
+const uint16_t pcapng_opt_if_name   = 2;
+const uint32_t pcapng_epb_fixed_len = 32;
+const uint32_t pcap_snaplen         = 65535;
+const uint32_t min_buffer_size      = 128 * 1024;
+const uint32_t buffer_alignment     = 4096;
+
+uint32_t pad4(uint32_t len)
+{
+  return (len + 3) & ~3u;
+}
+
+template <typename T>
+uint8_t* put(uint8_t* ptr, T value)
+{
+  memcpy(ptr, &value, sizeof(T));
+  return ptr + sizeof(T);
+}
+
+} // namespace
+
+/// Minimal io_uring instance submitting buffer writes and reaping their completions, driven through the raw system
+/// calls so that no additional library is required.
+class pcap_writer::io_ring
+{
+public:
+  io_ring() = default;
+  io_ring(const io_ring&) = delete;
+  io_ring& operator=(const io_ring&) = delete;
+  ~io_ring();
+
+  bool init(uint32_t entries);
+  bool submit_write(int fd, const uint8_t* data, uint32_t len, uint64_t offset, uint64_t user_data);
+  bool wait_completion(uint64_t& user_data, int32_t& res);
+
+private:
+#ifdef HAVE_IO_URING
+  int           ring_fd  = -1;
+  uint8_t*      sq_ptr   = nullptr;
+  uint8_t*      cq_ptr   = nullptr;
+  size_t        sq_size  = 0;
+  size_t        cq_size  = 0;
+  io_uring_sqe* sqes     = nullptr;
+  size_t        sqe_size = 0;
+  uint32_t*     sq_tail  = nullptr;
+  uint32_t*     sq_mask  = nullptr;
+  uint32_t*     sq_array = nullptr;
+  uint32_t*     cq_head  = nullptr;
+  uint32_t*     cq_tail  = nullptr;
+  uint32_t*     cq_mask  = nullptr;
+  io_uring_cqe* cqes     = nullptr;
+#endif
+};
+
+#ifdef HAVE_IO_URING
+
+pcap_writer::io_ring::~io_ring()
+{
+  if (sqes != nullptr) {
+    ::munmap(sqes, sqe_size);
+  }
+  if (cq_ptr != nullptr && cq_ptr != sq_ptr) {
+    ::munmap(cq_ptr, cq_size);
+  }
+  if (sq_ptr != nullptr) {
+    ::munmap(sq_ptr, sq_size);
+  }
+  if (ring_fd >= 0) {
+    ::close(ring_fd);
+  }
+}
+
+bool pcap_writer::io_ring::init(uint32_t entries)
+{
+  io_uring_params params = {};
+  ring_fd                = (int)::syscall(__NR_io_uring_setup, entries, &params);
+  if (ring_fd < 0) {
+    return false;
+  }
+
+  sq_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_size = cq_size = std::max(sq_size, cq_size);
+  }
+
+  void* ptr = ::mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (ptr == MAP_FAILED) {
+    return false;
+  }
+  sq_ptr = (uint8_t*)ptr;
+
+  if (single_mmap) {
+    cq_ptr = sq_ptr;
+  } else {
+    ptr = ::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+    if (ptr == MAP_FAILED) {
+      return false;
+    }
+    cq_ptr = (uint8_t*)ptr;
+  }
+
+  sqe_size = params.sq_entries * sizeof(io_uring_sqe);
+  ptr      = ::mmap(nullptr, sqe_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+  if (ptr == MAP_FAILED) {
+    return false;
+  }
+  sqes = (io_uring_sqe*)ptr;
+
+  sq_tail  = (uint32_t*)(sq_ptr + params.sq_off.tail);
+  sq_mask  = (uint32_t*)(sq_ptr + params.sq_off.ring_mask);
+  sq_array = (uint32_t*)(sq_ptr + params.sq_off.array);
+  cq_head  = (uint32_t*)(cq_ptr + params.cq_off.head);
+  cq_tail  = (uint32_t*)(cq_ptr + params.cq_off.tail);
+  cq_mask  = (uint32_t*)(cq_ptr + params.cq_off.ring_mask);
+  cqes     = (io_uring_cqe*)(cq_ptr + params.cq_off.cqes);
+
+  // Kernels before 5.6 create the ring but do not support IORING_OP_WRITE, nor the probe
+  const uint32_t       nof_probe_ops = 256;
+  std::vector<uint8_t> probe_buffer(sizeof(io_uring_probe) + nof_probe_ops * sizeof(io_uring_probe_op), 0);
+  io_uring_probe*      probe = (io_uring_probe*)probe_buffer.data();
+  if (::syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, nof_probe_ops) < 0 ||
+      probe->last_op < IORING_OP_WRITE || (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED) == 0) {
+    return false;
+  }
+
+  return true;
+}
+
+bool pcap_writer::io_ring::submit_write(int fd, const uint8_t* data, uint32_t len, uint64_t offset, uint64_t user_data)
+{
+  // This is the only thread producing entries, so the tail can be read without synchronization
+  uint32_t      tail = *sq_tail;
+  uint32_t      idx  = tail & *sq_mask;
+  io_uring_sqe& sqe  = sqes[idx];
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode    = IORING_OP_WRITE;
+  sqe.fd        = fd;
+  sqe.addr      = (uint64_t)(uintptr_t)data;
+  sqe.len       = len;
+  sqe.off       = offset;
+  sqe.user_data = user_data;
+  sq_array[idx] = idx;
+  __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+  int ret;
+  do {
+    ret = (int)::syscall(__NR_io_uring_enter, ring_fd, 1, 0, 0, nullptr, 0);
+  } while (ret < 0 && errno == EINTR);
+
+  return ret == 1;
+}
+
+bool pcap_writer::io_ring::wait_completion(uint64_t& user_data, int32_t& res)
+{
+  while (true) {
+    uint32_t head = *cq_head;
+    if (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+      const io_uring_cqe& cqe = cqes[head & *cq_mask];
+      user_data               = cqe.user_data;
+      res                     = cqe.res;
+      __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+      return true;
+    }
+
+    int ret = (int)::syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+    if (ret < 0 && errno != EINTR) {
+      return false;
+    }
+  }
+}
+
+#else
+
+pcap_writer::io_ring::~io_ring() {}
+
+bool pcap_writer::io_ring::init(uint32_t entries)
+{
+  return false;
+}
+
+bool pcap_writer::io_ring::submit_write(int fd, const uint8_t* data, uint32_t len, uint64_t offset, uint64_t user_data)
+{
+  return false;
+}
+
+bool pcap_writer::io_ring::wait_completion(uint64_t& user_data, int32_t& res)
+{
+  return false;
+}
+
+#endif // HAVE_IO_URING
+
+pcap_writer::pcap_writer(isrlog::basic_logger& logger) : logger(logger) {}
+
+pcap_writer::~pcap_writer()
+{
+  close();
+  for (buffer_t& b : buffers) {
+    free(b.data);
+  }
+}
+
+std::string pcap_writer::get_filename(uint32_t idx) const
+{
+  if (idx == 0) {
+    return base_filename;
+  }
+
+  // Insert the file index before the extension, if any
+  size_t dot   = base_filename.find_last_of('.');
+  size_t slash = base_filename.find_last_of('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return base_filename + "_" + std::to_string(idx);
+  }
+  return base_filename.substr(0, dot) + "_" + std::to_string(idx) + base_filename.substr(dot);
+}
+
+int pcap_writer::open(const std::string&                 filename,
+                      const std::vector<pcap_interface>& interfaces_,
+                      const pcap_writer_args&            args_)
+{
+  if (fd >= 0) {
+    logger.error("PCAP writer for %s already open. Close first.", base_filename.c_str());
+    return ISRRAN_ERROR;
+  }
+  if (interfaces_.empty()) {
+    logger.error("Opening PCAP file %s without interfaces", filename.c_str());
+    return ISRRAN_ERROR;
+  }
+
+  args             = args_;
+  args.buffer_size = std::max(args.buffer_size, min_buffer_size);
+  args.buffer_size = (args.buffer_size + buffer_alignment - 1) / buffer_alignment * buffer_alignment;
+  args.nof_buffers = std::max(args.nof_buffers, 2u);
+  interfaces       = interfaces_;
+  base_filename    = filename;
+
+  // (Re)allocate the buffers
+  for (buffer_t& b : buffers) {
+    free(b.data);
+  }
+  buffers.assign(args.nof_buffers, {});
+  for (buffer_t& b : buffers) {
+    if (posix_memalign((void**)&b.data, buffer_alignment, args.buffer_size) != 0) {
+      b.data = nullptr;
+      logger.error("Error allocating %d bytes for the PCAP writer", args.buffer_size);
+      return ISRRAN_ERROR;
+    }
+  }
+  current = 0;
+  pending.clear();
+
+  ring.reset();
+  ring_write_error = false;
+  if (args.use_io_uring) {
+    ring.reset(new io_ring);
+    if (not ring->init(args.nof_buffers)) {
+      logger.info("io_uring not available, writing PCAP file %s with writev()", filename.c_str());
+      ring.reset();
+    }
+  }
+
+  file_idx    = 0;
+  nof_records = 0;
+  return open_file();
+}
+
+int pcap_writer::open_file()
+{
+  std::string name = get_filename(file_idx);
+  fd               = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    logger.error("Couldn't open %s to write PCAP: %s", name.c_str(), strerror(errno));
+    return ISRRAN_ERROR;
+  }
+
+  file_offset  = 0;
+  file_bytes   = 0;
+  file_records = 0;
+  file_start   = std::chrono::steady_clock::now();
+  return write_file_header();
+}
+
+int pcap_writer::write_file_header()
+{
+  if (not args.pcapng) {
+    pcap_hdr_t header    = {};
+    header.magic_number  = 0xa1b2c3d4;
+    header.version_major = 2;
+    header.version_minor = 4;
+    header.snaplen       = pcap_snaplen;
+    header.network       = interfaces[0].dlt;
+    memcpy(reserve(sizeof(header)), &header, sizeof(header));
+    file_bytes += sizeof(header);
+    return ISRRAN_SUCCESS;
+  }
+
+  // Section header block
+  const uint32_t shb_len = 28;
+  uint8_t*       ptr     = reserve(shb_len);
+  ptr                    = put<uint32_t>(ptr, pcapng_shb_type);
+  ptr                    = put<uint32_t>(ptr, shb_len);
+  ptr                    = put<uint32_t>(ptr, pcapng_byte_order);
+  ptr                    = put<uint16_t>(ptr, 1);
+  ptr                    = put<uint16_t>(ptr, 0);
+  ptr                    = put<int64_t>(ptr, -1);
+  put<uint32_t>(ptr, shb_len);
+  file_bytes += shb_len;
+
+  // One interface description block per interface, with its name as option
+  for (const pcap_interface& itf : interfaces) {
+    uint32_t name_len = std::min((uint32_t)itf.name.size(), 256u);
+    uint32_t opts_len = (name_len > 0) ? 4 + pad4(name_len) + 4 : 0;
+    uint32_t idb_len  = 20 + opts_len;
+    ptr               = reserve(idb_len);
+    ptr               = put<uint32_t>(ptr, pcapng_idb_type);
+    ptr               = put<uint32_t>(ptr, idb_len);
+    ptr               = put<uint16_t>(ptr, (uint16_t)itf.dlt);
+    ptr               = put<uint16_t>(ptr, 0);
+    ptr               = put<uint32_t>(ptr, pcap_snaplen);
+    if (opts_len > 0) {
+      ptr = put<uint16_t>(ptr, pcapng_opt_if_name);
+      ptr = put<uint16_t>(ptr, (uint16_t)name_len);
+      memset(ptr, 0, pad4(name_len));
+      memcpy(ptr, itf.name.data(), name_len);
+      ptr += pad4(name_len);
+      ptr = put<uint16_t>(ptr, pcapng_opt_endofopt);
+      ptr = put<uint16_t>(ptr, 0);
+    }
+    put<uint32_t>(ptr, idb_len);
+    file_bytes += idb_len;
+  }
+
+  return ISRRAN_SUCCESS;
+}
+
+void pcap_writer::close_file()
+{
+  if (fd < 0) {
+    return;
+  }
+  flush();
+  ::close(fd);
+  fd = -1;
+}
+
+void pcap_writer::close()
+{
+  close_file();
+  ring.reset();
+}
+
+int pcap_writer::write_pdu(uint32_t       if_idx,
+                           const uint8_t* header,
+                           uint32_t       header_len,
+                           const uint8_t* pdu,
+                           uint32_t       pdu_len)
+{
+  if (fd < 0) {
+    return ISRRAN_ERROR;
+  }
+  if (if_idx >= interfaces.size()) {
+    logger.error("Writing PCAP record for invalid interface %d", if_idx);
+    return ISRRAN_ERROR;
+  }
+
+  uint32_t data_len = header_len + pdu_len;
+  uint32_t rec_len  = args.pcapng ? pcapng_epb_fixed_len + pad4(data_len) : sizeof(pcaprec_hdr_t) + data_len;
+  if (rec_len > args.buffer_size) {
+    logger.error("Dropping PDU (%d B) in PCAP. Record larger than the write buffer.", pdu_len);
+    return ISRRAN_ERROR;
+  }
+
+  // Rotate the file once it is full or old enough, never leaving a file without records
+  if (file_records > 0) {
+    bool rotate = args.rotate_size > 0 && file_bytes + rec_len > args.rotate_size;
+    rotate |= args.rotate_period_s > 0 &&
+              std::chrono::steady_clock::now() - file_start >= std::chrono::seconds(args.rotate_period_s);
+    if (rotate) {
+      close_file();
+      file_idx++;
+      if (open_file() != ISRRAN_SUCCESS) {
+        return ISRRAN_ERROR;
+      }
+    }
+  }
+
+  struct timespec ts = {};
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  uint8_t* ptr = reserve(rec_len);
+  if (args.pcapng) {
+    uint64_t ts_us = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    ptr            = put<uint32_t>(ptr, pcapng_epb_type);
+    ptr            = put<uint32_t>(ptr, rec_len);
+    ptr            = put<uint32_t>(ptr, if_idx);
+    ptr            = put<uint32_t>(ptr, (uint32_t)(ts_us >> 32u));
+    ptr            = put<uint32_t>(ptr, (uint32_t)ts_us);
+    ptr            = put<uint32_t>(ptr, data_len);
+    ptr            = put<uint32_t>(ptr, data_len);
+  } else {
+    pcaprec_hdr_t rec_header = {};
+    rec_header.ts_sec        = ts.tv_sec;
+    rec_header.ts_usec       = ts.tv_nsec / 1000;
+    rec_header.incl_len      = data_len;
+    rec_header.orig_len      = data_len;
+    memcpy(ptr, &rec_header, sizeof(rec_header));
+    ptr += sizeof(rec_header);
+  }
+
+  if (header_len > 0) {
+    memcpy(ptr, header, header_len);
+    ptr += header_len;
+  }
+  if (pdu_len > 0) {
+    memcpy(ptr, pdu, pdu_len);
+    ptr += pdu_len;
+  }
+
+  if (args.pcapng) {
+    uint32_t padding = pad4(data_len) - data_len;
+    memset(ptr, 0, padding);
+    put<uint32_t>(ptr + padding, rec_len);
+  }
+
+  file_bytes += rec_len;
+  file_records++;
+  nof_records++;
+
+  return ISRRAN_SUCCESS;
+}
+
+uint8_t* pcap_writer::reserve(uint32_t len)
+{
+  if (buffers[current].len + len > args.buffer_size) {
+    submit_current();
+  }
+
+  buffer_t& b   = buffers[current];
+  uint8_t*  ptr = b.data + b.len;
+  b.len += len;
+  return ptr;
+}
+
+void pcap_writer::submit_current()
+{
+  buffer_t& b = buffers[current];
+  if (b.len == 0) {
+    return;
+  }
+
+  b.offset = file_offset;
+  file_offset += b.len;
+
+  if (ring != nullptr && ring_write_error) {
+    logger.warning("Error writing PCAP file through io_uring, falling back to writev()");
+    wait_all();
+    ring.reset();
+  }
+
+  if (ring != nullptr) {
+    if (ring->submit_write(fd, b.data, b.len, b.offset, current)) {
+      b.in_flight = true;
+    } else {
+      // Give up on io_uring once the submission fails, the entry left in the ring is never consumed
+      logger.warning("Error submitting PCAP write to io_uring, falling back to writev()");
+      wait_all();
+      ring.reset();
+      pending.push_back(current);
+    }
+  } else {
+    pending.push_back(current);
+  }
+
+  // Move to the next buffer, making sure its previous contents are already in the file
+  current = (current + 1) % buffers.size();
+  if (ring != nullptr) {
+    wait_buffer(current);
+  } else if (not pending.empty() && pending.front() == current) {
+    write_pending();
+  }
+  buffers[current].len = 0;
+}
+
+void pcap_writer::write_pending()
+{
+  if (pending.empty()) {
+    return;
+  }
+
+  std::vector<struct iovec> iov;
+  iov.reserve(pending.size());
+  for (uint32_t idx : pending) {
+    iov.push_back({buffers[idx].data, buffers[idx].len});
+  }
+
+  uint64_t offset = buffers[pending.front()].offset;
+  size_t   first  = 0;
+  while (first < iov.size()) {
+    ssize_t n = ::pwritev(fd, &iov[first], std::min(iov.size() - first, (size_t)IOV_MAX), offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      logger.error("Error writing PCAP file %s: %s", get_filename(file_idx).c_str(), strerror(errno));
+      break;
+    }
+
+    // Skip the written bytes, which may end in the middle of a buffer
+    offset += n;
+    while (first < iov.size() && (size_t)n >= iov[first].iov_len) {
+      n -= iov[first].iov_len;
+      first++;
+    }
+    if (first < iov.size()) {
+      iov[first].iov_base = (uint8_t*)iov[first].iov_base + n;
+      iov[first].iov_len -= n;
+    }
+  }
+
+  pending.clear();
+}
+
+void pcap_writer::write_all(const uint8_t* data, size_t len, uint64_t offset)
+{
+  while (len > 0) {
+    ssize_t n = ::pwrite(fd, data, len, offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      logger.error("Error writing PCAP file %s: %s", get_filename(file_idx).c_str(), strerror(errno));
+      return;
+    }
+    data += n;
+    len -= n;
+    offset += n;
+  }
+}
+
+void pcap_writer::wait_buffer(uint32_t idx)
+{
+  while (buffers[idx].in_flight) {
+    uint64_t user_data = 0;
+    int32_t  res       = 0;
+    if (ring == nullptr || not ring->wait_completion(user_data, res) || user_data >= buffers.size()) {
+      logger.error("Error waiting for PCAP write completion");
+      for (buffer_t& b : buffers) {
+        b.in_flight = false;
+      }
+      return;
+    }
+
+    buffer_t& b = buffers[user_data];
+    b.in_flight = false;
+    if (res < 0) {
+      // Rewrite the buffer synchronously, the following ones are written without io_uring
+      logger.info("Error writing PCAP file %s through io_uring: %s", get_filename(file_idx).c_str(), strerror(-res));
+      ring_write_error = true;
+      write_all(b.data, b.len, b.offset);
+    } else if ((uint32_t)res < b.len) {
+      // Complete short writes synchronously
+      write_all(b.data + res, b.len - res, b.offset + res);
+    }
+  }
+}
+
+void pcap_writer::wait_all()
+{
+  for (uint32_t i = 0; i < buffers.size(); i++) {
+    wait_buffer(i);
+  }
+}
+
+void pcap_writer::flush()
+{
+  if (fd < 0) {
+    return;
+  }
+  submit_current();
+  if (ring != nullptr) {
+    wait_all();
+  } else {
+    write_pending();
+  }
+}
+
+} // namespace isrran
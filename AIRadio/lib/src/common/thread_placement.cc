@@ -0,0 +1,224 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/common/thread_placement.h"
+#include "isrran/common/numa.h"
+#include "isrran/common/standard_streams.h"
+#include "isrran/isrlog/bundled/fmt/format.h"
+#include <algorithm>
+#include <pthread.h>
+
+using namespace isrran;
+
+const char* isrran::to_string(thread_role role)
+{
+  switch (role) {
+    case thread_role::none:
+      return "none";
+    case thread_role::rf:
+      return "rf";
+    case thread_role::phy_worker:
+      return "phy_worker";
+    case thread_role::stack:
+      return "stack";
+    case thread_role::gtpu:
+      return "gtpu";
+    case thread_role::log:
+      return "log";
+    default:
+      break;
+  }
+  return "invalid";
+}
+
+thread_placement& thread_placement::get_instance()
+{
+  static thread_placement placement;
+  return placement;
+}
+
+bool thread_placement::configure(const thread_placement_args_t& args)
+{
+  const std::array<std::pair<thread_role, const std::string*>, 5> lists = {{{thread_role::rf, &args.rf_cpus},
+                                                                            {thread_role::phy_worker, &args.phy_cpus},
+                                                                            {thread_role::stack, &args.stack_cpus},
+                                                                            {thread_role::gtpu, &args.gtpu_cpus},
+                                                                            {thread_role::log, &args.log_cpus}}};
+
+  // CPUs of the system
+  cpu_set_t system_cpus;
+  CPU_ZERO(&system_cpus);
+  for (uint32_t n = 0; n < numa::nof_nodes(); n++) {
+    cpu_set_t node_cpus = numa::node_cpus(n);
+    CPU_OR(&system_cpus, &system_cpus, &node_cpus);
+  }
+
+  std::array<role_cfg_t, nof_thread_roles> new_roles = {};
+  for (const auto& l : lists) {
+    if (l.second->empty()) {
+      continue;
+    }
+    role_cfg_t& cfg = new_roles[(uint32_t)l.first];
+    if (not numa::parse_cpu_list(*l.second, cfg.cpus)) {
+      console_stderr("Error: Invalid CPU list \"%s\" for the %s threads\n", l.second->c_str(), to_string(l.first));
+      return false;
+    }
+    CPU_AND(&cfg.cpus, &cfg.cpus, &system_cpus);
+    if (CPU_COUNT(&cfg.cpus) == 0) {
+      console_stderr("Error: The CPU list \"%s\" for the %s threads has no online CPU\n",
+                     l.second->c_str(),
+                     to_string(l.first));
+      return false;
+    }
+    cfg.enabled = true;
+    cfg.node    = numa::cpu_set_node(cfg.cpus);
+  }
+
+  // The memory pools split their blocks among the nodes hosting the pinned roles
+  std::vector<uint32_t> memory_nodes;
+  if (args.numa_local_memory and numa::nof_nodes() > 1) {
+    for (const role_cfg_t& cfg : new_roles) {
+      if (cfg.enabled and cfg.node >= 0 and
+          std::find(memory_nodes.begin(), memory_nodes.end(), (uint32_t)cfg.node) == memory_nodes.end()) {
+        memory_nodes.push_back(cfg.node);
+      }
+    }
+    std::sort(memory_nodes.begin(), memory_nodes.end());
+  }
+  numa::set_memory_nodes(memory_nodes);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  roles             = new_roles;
+  numa_local_memory = args.numa_local_memory;
+  return true;
+}
+
+bool thread_placement::is_configured() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return std::any_of(roles.begin(), roles.end(), [](const role_cfg_t& cfg) { return cfg.enabled; });
+}
+
+void thread_placement::apply(thread_role role)
+{
+  place(role, true);
+}
+
+void thread_placement::place(thread_role role, bool record)
+{
+  if (role == thread_role::none or role >= thread_role::nof_roles) {
+    return;
+  }
+
+  role_cfg_t cfg;
+  bool       local_memory;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    cfg          = roles[(uint32_t)role];
+    local_memory = numa_local_memory;
+  }
+  if (not cfg.enabled) {
+    return;
+  }
+
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cfg.cpus) != 0) {
+    console_stderr("Error: Setting the affinity of the %s thread\n", to_string(role));
+    return;
+  }
+  if (local_memory and cfg.node >= 0) {
+    numa::set_preferred_node(cfg.node);
+  }
+
+  if (record) {
+    char name[16] = {};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    int cpu = sched_getcpu();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    placed_threads.push_back({name, role, cpu, (cpu < 0) ? -1 : (int)numa::cpu_node(cpu)});
+  }
+}
+
+int thread_placement::get_node(thread_role role) const
+{
+  if (role == thread_role::none or role >= thread_role::nof_roles) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  const role_cfg_t&           cfg = roles[(uint32_t)role];
+  return cfg.enabled ? cfg.node : -1;
+}
+
+std::string thread_placement::get_report() const
+{
+  fmt::memory_buffer buffer;
+
+  fmt::format_to(buffer, "NUMA topology: {} node(s)\n", numa::nof_nodes());
+  for (uint32_t n = 0; n < numa::nof_nodes(); n++) {
+    fmt::format_to(buffer, "  node {}: cpus {}\n", n, numa::cpu_list_to_string(numa::node_cpus(n)));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  fmt::format_to(buffer, "Thread placement:\n");
+  for (uint32_t r = 1; r < nof_thread_roles; r++) {
+    const role_cfg_t& cfg  = roles[r];
+    const char*       name = to_string((thread_role)r);
+    if (not cfg.enabled) {
+      fmt::format_to(buffer, "  {:<10} unpinned\n", name);
+    } else if (cfg.node < 0) {
+      fmt::format_to(buffer, "  {:<10} cpus {} (several nodes)\n", name, numa::cpu_list_to_string(cfg.cpus));
+    } else {
+      fmt::format_to(buffer, "  {:<10} cpus {} (node {})\n", name, numa::cpu_list_to_string(cfg.cpus), cfg.node);
+    }
+  }
+
+  std::vector<uint32_t> memory_nodes = numa::get_memory_nodes();
+  if (memory_nodes.empty()) {
+    fmt::format_to(buffer, "Memory pools: shared by all nodes\n");
+  } else {
+    fmt::format_to(buffer, "Memory pools: NUMA local on node(s) {}\n", fmt::join(memory_nodes, ","));
+  }
+
+  if (not placed_threads.empty()) {
+    fmt::format_to(buffer, "Placed threads:\n");
+    for (const placed_thread_t& t : placed_threads) {
+      fmt::format_to(buffer, "  {:<16} {:<10} cpu {} node {}\n", t.name, to_string(t.role), t.cpu, t.node);
+    }
+  }
+
+  return fmt::to_string(buffer);
+}
+
+scoped_thread_placement::scoped_thread_placement(thread_role role)
+{
+  CPU_ZERO(&prev_cpus);
+  restore_affinity = pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &prev_cpus) == 0;
+  prev_node        = numa::get_preferred_node();
+  thread_placement::get_instance().place(role, false);
+}
+
+scoped_thread_placement::~scoped_thread_placement()
+{
+  if (restore_affinity) {
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &prev_cpus);
+  }
+  numa::set_preferred_node(prev_node);
+}
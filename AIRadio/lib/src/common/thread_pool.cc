@@ -272,8 +272,15 @@ std::string thread_pool::get_id()
  *  once a worker is available
  *************************************************************************/
 
-task_thread_pool::task_thread_pool(uint32_t nof_workers, bool start_deferred, int32_t prio_, uint32_t mask_) :
-  logger(isrlog::fetch_basic_logger("POOL")), pending_tasks(max_task_num), workers(std::max(1u, nof_workers))
+task_thread_pool::task_thread_pool(uint32_t    nof_workers,
+                                   bool        start_deferred,
+                                   int32_t     prio_,
+                                   uint32_t    mask_,
+                                   thread_role role_) :
+  role(role_),
+  logger(isrlog::fetch_basic_logger("POOL")),
+  pending_tasks(max_task_num),
+  workers(std::max(1u, nof_workers))
 {
   if (not start_deferred) {
     start(prio_, mask_);
@@ -360,6 +367,7 @@ uint32_t task_thread_pool::nof_pending_tasks() const
 task_thread_pool::worker_t::worker_t(isrran::task_thread_pool* parent_, uint32_t my_id) :
   parent(parent_), thread(std::string("TASKWORKER") + std::to_string(my_id)), id_(my_id), running(true)
 {
+  set_role(parent->role);
   if (parent->mask == 255) {
     start(parent->prio);
   } else {
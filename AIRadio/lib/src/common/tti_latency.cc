@@ -0,0 +1,202 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/common/tti_latency.h"
+#include <algorithm>
+
+using namespace isrran;
+
+namespace {
+
+// Timestamps of the TTI ring are tagged with the 14 LSB of the TTI number in the upper bits
+const uint32_t tti_tag_shift = 50;
+const uint64_t tti_time_mask = (1ULL << tti_tag_shift) - 1;
+const uint32_t tti_tag_mask  = 0x3fff;
+
+// Linear buckets below 16 us, then 8 sub-buckets per power of two
+const uint32_t linear_limit    = 16;
+const uint32_t sub_bucket_bits = 3;
+
+std::atomic<uint32_t> next_thread_idx = {0};
+
+} // namespace
+
+const char* isrran::to_string(tti_stage stage)
+{
+  switch (stage) {
+    case tti_stage::rf_rx:
+      return "rf_rx";
+    case tti_stage::worker_start:
+      return "worker_start";
+    case tti_stage::ul_decode:
+      return "ul_decode";
+    case tti_stage::mac_sched:
+      return "mac_sched";
+    case tti_stage::dl_encode:
+      return "dl_encode";
+    case tti_stage::rf_tx:
+      return "rf_tx";
+    default:
+      break;
+  }
+  return "invalid";
+}
+
+tti_latency::tti_latency(uint32_t deadline_us_) : deadline_us(deadline_us_), epoch(std::chrono::steady_clock::now())
+{
+  for (auto& t : tti_start_us) {
+    t.store(UINT64_MAX, std::memory_order_relaxed);
+  }
+  for (auto& h : histograms) {
+    h.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+tti_latency::~tti_latency()
+{
+  for (auto& h : histograms) {
+    delete h.load(std::memory_order_relaxed);
+  }
+}
+
+uint32_t tti_latency::latency_to_bucket(uint32_t latency_us)
+{
+  if (latency_us < linear_limit) {
+    return latency_us;
+  }
+  uint32_t msb    = 31 - __builtin_clz(latency_us);
+  uint32_t bucket = linear_limit + ((msb - 4) << sub_bucket_bits) + ((latency_us >> (msb - sub_bucket_bits)) - 8);
+  return std::min(bucket, nof_buckets - 1);
+}
+
+uint32_t tti_latency::bucket_to_latency(uint32_t bucket)
+{
+  if (bucket < linear_limit) {
+    return bucket;
+  }
+  // Middle of the bucket range
+  uint32_t shift = ((bucket - linear_limit) >> sub_bucket_bits) + 1;
+  uint32_t sub   = (bucket - linear_limit) & ((1u << sub_bucket_bits) - 1);
+  return ((8 + sub) << shift) + (1u << (shift - 1));
+}
+
+uint64_t tti_latency::now_us() const
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+tti_latency::histogram_t& tti_latency::get_thread_histogram()
+{
+  // Threads beyond max_threads share histograms, which is safe as the counters are atomic
+  static thread_local uint32_t thread_idx = next_thread_idx.fetch_add(1, std::memory_order_relaxed) % max_threads;
+
+  histogram_t* h = histograms[thread_idx].load(std::memory_order_acquire);
+  if (h == nullptr) {
+    std::unique_ptr<histogram_t> new_h(new histogram_t);
+    for (auto& stage : new_h->buckets) {
+      for (auto& b : stage) {
+        b.store(0, std::memory_order_relaxed);
+      }
+    }
+    for (auto& m : new_h->misses) {
+      m.store(0, std::memory_order_relaxed);
+    }
+    if (histograms[thread_idx].compare_exchange_strong(h, new_h.get(), std::memory_order_acq_rel)) {
+      h = new_h.release();
+    }
+  }
+  return *h;
+}
+
+void tti_latency::tti_start(uint32_t tti)
+{
+  uint64_t value = ((uint64_t)(tti & tti_tag_mask) << tti_tag_shift) | (now_us() & tti_time_mask);
+  tti_start_us[tti % nof_tti_ring].store(value, std::memory_order_release);
+}
+
+void tti_latency::record(tti_stage stage, uint32_t tti)
+{
+  uint64_t start = tti_start_us[tti % nof_tti_ring].load(std::memory_order_acquire);
+  if ((start >> tti_tag_shift) != (tti & tti_tag_mask)) {
+    return;
+  }
+  uint64_t now = now_us();
+  start &= tti_time_mask;
+  uint32_t latency_us = (now > start) ? (uint32_t)std::min<uint64_t>(now - start, UINT32_MAX) : 0;
+
+  histogram_t& h = get_thread_histogram();
+  h.buckets[(uint32_t)stage][latency_to_bucket(latency_us)].fetch_add(1, std::memory_order_relaxed);
+  if (latency_us > deadline_us) {
+    h.misses[(uint32_t)stage].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void tti_latency::get_metrics(tti_latency_metrics_t& metrics)
+{
+  std::lock_guard<std::mutex> lock(metrics_mutex);
+
+  // Merge the histograms of all the threads
+  counters_t totals = {};
+  for (auto& hptr : histograms) {
+    histogram_t* h = hptr.load(std::memory_order_acquire);
+    if (h == nullptr) {
+      continue;
+    }
+    for (uint32_t s = 0; s < nof_tti_stages; s++) {
+      for (uint32_t b = 0; b < nof_buckets; b++) {
+        totals[s][b] += h->buckets[s][b].load(std::memory_order_relaxed);
+      }
+      totals[s][nof_buckets] += h->misses[s].load(std::memory_order_relaxed);
+    }
+  }
+
+  metrics.deadline_us = deadline_us;
+  for (uint32_t s = 0; s < nof_tti_stages; s++) {
+    std::array<uint64_t, nof_buckets> period = {};
+    uint64_t                          count  = 0;
+    uint32_t                          max_b  = 0;
+    for (uint32_t b = 0; b < nof_buckets; b++) {
+      period[b] = totals[s][b] - last_counters[s][b];
+      count += period[b];
+      max_b = (period[b] > 0) ? b : max_b;
+    }
+
+    tti_stage_latency_t& m = metrics.stages[s];
+    m                      = {};
+    m.nof_samples          = count;
+    m.nof_deadline_misses  = totals[s][nof_buckets] - last_counters[s][nof_buckets];
+    if (count > 0) {
+      // Smallest bucket at which the cumulative count reaches each percentile
+      const std::array<double, 3> percentiles = {0.5, 0.99, 0.999};
+      std::array<float*, 3>       outputs     = {&m.p50_us, &m.p99_us, &m.p999_us};
+      uint64_t                    cumulative  = 0;
+      uint32_t                    p           = 0;
+      for (uint32_t b = 0; b < nof_buckets and p < percentiles.size(); b++) {
+        cumulative += period[b];
+        while (p < percentiles.size() and cumulative >= percentiles[p] * count) {
+          *outputs[p++] = bucket_to_latency(b);
+        }
+      }
+      m.max_us = bucket_to_latency(max_b);
+    }
+  }
+  last_counters = totals;
+}
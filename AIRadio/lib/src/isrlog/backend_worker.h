@@ -24,19 +24,23 @@
 
 #include "isrran/isrlog/detail/log_entry.h"
 #include "isrran/isrlog/detail/support/dyn_arg_store_pool.h"
-#include "isrran/isrlog/detail/support/work_queue.h"
+#include "isrran/isrlog/detail/support/producer_queue_set.h"
 #include "isrran/isrlog/shared_types.h"
 #include <mutex>
 #include <thread>
 
 namespace isrlog {
 
+/// Queue used to pass log entries from the application threads to the backend worker.
+using log_entry_queue = detail::producer_queue_set<detail::log_entry, detail::log_entry_time_order>;
+
 /// The backend worker runs in a secondary thread a routine that endlessly pops
 /// log entries from a work queue and dispatches them to the selected sinks.
+/// Entries coming from different threads are processed in timestamp order.
 class backend_worker
 {
 public:
-  backend_worker(detail::work_queue<detail::log_entry>& queue, detail::dyn_arg_store_pool& arg_pool) :
+  backend_worker(log_entry_queue& queue, detail::dyn_arg_store_pool& arg_pool) :
     queue(queue), arg_pool(arg_pool), running_flag(false)
   {}
 
@@ -111,9 +115,9 @@ private:
   void set_thread_priority(backend_priority priority) const;
 
 private:
-  detail::work_queue<detail::log_entry>& queue;
-  detail::dyn_arg_store_pool&            arg_pool;
-  detail::shared_variable<bool>          running_flag;
+  log_entry_queue&              queue;
+  detail::dyn_arg_store_pool&   arg_pool;
+  detail::shared_variable<bool> running_flag;
   error_handler      err_handler = [](const std::string& error) { fmt::print(stderr, "isrLog error - {}\n", error); };
   std::once_flag     start_once_flag;
   std::thread        worker_thread;
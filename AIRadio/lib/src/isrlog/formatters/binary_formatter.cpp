@@ -0,0 +1,239 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "binary_formatter.h"
+#include "binary_log_format.h"
+#include "isrran/isrlog/detail/log_entry_metadata.h"
+
+using namespace isrlog;
+using namespace isrlog::binary_log;
+
+std::unique_ptr<log_formatter> binary_formatter::clone() const
+{
+  // A clone starts a new stream, so none of the state is carried over.
+  return std::unique_ptr<log_formatter>(new binary_formatter);
+}
+
+/// Appends the raw bytes of the input value into the buffer.
+template <typename T>
+static void put(fmt::memory_buffer& buffer, T value)
+{
+  const char* p = reinterpret_cast<const char*>(&value);
+  buffer.append(p, p + sizeof(T));
+}
+
+/// Appends a length prefixed string into the buffer.
+static void put_string(fmt::memory_buffer& buffer, fmt::string_view str)
+{
+  put<uint32_t>(buffer, str.size());
+  buffer.append(str.data(), str.data() + str.size());
+}
+
+/// Appends a record header with an empty size field, returning the offset of the record.
+static size_t begin_record(fmt::memory_buffer& buffer, record_type type)
+{
+  size_t offset = buffer.size();
+  put<uint32_t>(buffer, 0);
+  put<uint8_t>(buffer, static_cast<uint8_t>(type));
+  return offset;
+}
+
+/// Fills in the size field of the record starting at the specified offset.
+static void end_record(fmt::memory_buffer& buffer, size_t offset)
+{
+  uint32_t size = buffer.size() - offset;
+  std::memcpy(buffer.data() + offset, &size, sizeof(size));
+}
+
+static int64_t to_nanoseconds(std::chrono::high_resolution_clock::time_point tp)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+namespace {
+
+/// Serializes format arguments keeping their original type so that the decoder renders exactly the same output.
+struct arg_serializer {
+  fmt::memory_buffer&                        buffer;
+  fmt::basic_format_arg<fmt::printf_context> arg;
+
+  template <typename T>
+  void tagged(arg_type type, T value)
+  {
+    put<uint8_t>(buffer, static_cast<uint8_t>(type));
+    put<T>(buffer, value);
+  }
+
+  void operator()(int v) { tagged<int32_t>(arg_type::int32, v); }
+  void operator()(unsigned v) { tagged<uint32_t>(arg_type::uint32, v); }
+  void operator()(long long v) { tagged<int64_t>(arg_type::int64, v); }
+  void operator()(unsigned long long v) { tagged<uint64_t>(arg_type::uint64, v); }
+  void operator()(bool v) { tagged<uint8_t>(arg_type::boolean, v); }
+  void operator()(char v) { tagged<char>(arg_type::character, v); }
+  void operator()(float v) { tagged<double>(arg_type::float64, v); }
+  void operator()(double v) { tagged<double>(arg_type::float64, v); }
+  void operator()(long double v) { tagged<double>(arg_type::float64, v); }
+  void operator()(const void* v) { tagged<uint64_t>(arg_type::pointer, reinterpret_cast<uintptr_t>(v)); }
+  void operator()(const char* v) { operator()(fmt::string_view(v ? v : "")); }
+  void operator()(fmt::string_view v)
+  {
+    put<uint8_t>(buffer, static_cast<uint8_t>(arg_type::string));
+    put_string(buffer, v);
+  }
+#if FMT_USE_INT128
+  void operator()(fmt::detail::int128_t v) { operator()(static_cast<long long>(v)); }
+  void operator()(fmt::detail::uint128_t v) { operator()(static_cast<unsigned long long>(v)); }
+#endif
+
+  /// User defined types can only be rendered by their formatter, this is the only case where formatting happens. The
+  /// argument being visited is formatted on its own and stored as a string.
+  void operator()(fmt::basic_format_arg<fmt::printf_context>::handle)
+  {
+    fmt::memory_buffer                          str;
+    fmt::basic_format_args<fmt::printf_context> args(&arg, 1);
+    fmt::vprintf(str, fmt::to_string_view("%s"), args);
+    operator()(fmt::string_view(str.data(), str.size()));
+  }
+
+  /// Called for empty arguments, which are never stored.
+  void operator()(fmt::monostate) {}
+};
+
+} // namespace
+
+void binary_formatter::write_stream_header(fmt::memory_buffer& buffer)
+{
+  if (is_header_written) {
+    return;
+  }
+  is_header_written = true;
+  buffer.append(file_magic, file_magic + file_magic_size);
+}
+
+uint32_t binary_formatter::define_string(fmt::string_view str, fmt::memory_buffer& buffer)
+{
+  uint32_t id     = next_id++;
+  size_t   offset = begin_record(buffer, record_type::string_def);
+  put<uint32_t>(buffer, id);
+  buffer.append(str.data(), str.data() + str.size());
+  end_record(buffer, offset);
+  return id;
+}
+
+uint32_t binary_formatter::get_fmt_string_id(const char* str, fmt::memory_buffer& buffer)
+{
+  if (!str) {
+    return 0;
+  }
+
+  // Format strings are normally literals, so the pointer identifies them. The contents are checked anyway in case the
+  // memory got reused for a different string.
+  auto it = fmt_ids.find(str);
+  if (it != fmt_ids.end()) {
+    const std::string& known = fmt_strings[it->second];
+    if (std::strcmp(known.c_str(), str) == 0) {
+      return it->second;
+    }
+    fmt_strings.erase(it->second);
+  }
+
+  uint32_t id     = define_string(str, buffer);
+  fmt_ids[str]    = id;
+  fmt_strings[id] = str;
+  return id;
+}
+
+uint32_t binary_formatter::get_name_id(const std::string& name, fmt::memory_buffer& buffer)
+{
+  if (name.empty()) {
+    return 0;
+  }
+
+  auto it = name_ids.find(name);
+  if (it != name_ids.end()) {
+    return it->second;
+  }
+
+  uint32_t id    = define_string(name, buffer);
+  name_ids[name] = id;
+  return id;
+}
+
+void binary_formatter::format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer)
+{
+  write_stream_header(buffer);
+
+  // String definitions go before the record that references them.
+  uint32_t fmt_id  = get_fmt_string_id(metadata.fmtstring, buffer);
+  uint32_t name_id = get_name_id(metadata.log_name, buffer);
+
+  fmt::basic_format_args<fmt::printf_context> args;
+  if (metadata.store) {
+    args = fmt::basic_format_args<fmt::printf_context>(*metadata.store);
+  }
+  uint16_t nof_args = metadata.store ? args.max_size() : 0;
+
+  uint8_t flags = 0;
+  flags |= metadata.context.enabled ? flag_context_enabled : 0;
+  flags |= metadata.store ? flag_has_args : 0;
+
+  size_t offset = begin_record(buffer, record_type::entry);
+  put<int64_t>(buffer, to_nanoseconds(metadata.tp));
+  put<uint32_t>(buffer, fmt_id);
+  put<uint32_t>(buffer, name_id);
+  put<char>(buffer, metadata.log_tag);
+  put<uint8_t>(buffer, flags);
+  put<uint32_t>(buffer, metadata.context.value);
+  put<uint16_t>(buffer, nof_args);
+  put<uint32_t>(buffer, metadata.hex_dump.size());
+
+  arg_serializer serializer{buffer, {}};
+  for (uint16_t i = 0; i != nof_args; ++i) {
+    serializer.arg = args.get(i);
+    fmt::visit_format_arg(serializer, serializer.arg);
+  }
+
+  buffer.append(metadata.hex_dump.data(), metadata.hex_dump.data() + metadata.hex_dump.size());
+  end_record(buffer, offset);
+}
+
+void binary_formatter::format_context_begin(const detail::log_entry_metadata& md,
+                                            fmt::string_view                  ctx_name,
+                                            unsigned                          size,
+                                            fmt::memory_buffer&               buffer)
+{
+  write_stream_header(buffer);
+
+  uint32_t name_id  = get_name_id(md.log_name, buffer);
+  text_record_start = begin_record(buffer, record_type::text);
+  put<int64_t>(buffer, to_nanoseconds(md.tp));
+  put<uint32_t>(buffer, name_id);
+
+  text_formatter::format_context_begin(md, ctx_name, size, buffer);
+}
+
+void binary_formatter::format_context_end(const detail::log_entry_metadata& md,
+                                          fmt::string_view                  ctx_name,
+                                          fmt::memory_buffer&               buffer)
+{
+  text_formatter::format_context_end(md, ctx_name, buffer);
+  end_record(buffer, text_record_start);
+}
@@ -0,0 +1,78 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRLOG_BINARY_FORMATTER_H
+#define ISRLOG_BINARY_FORMATTER_H
+
+#include "text_formatter.h"
+#include <unordered_map>
+
+namespace isrlog {
+
+/// Binary formatter implementation class. Instead of rendering the message, log entries are serialized as compact
+/// records holding the format string id, the raw arguments, the timestamp and the channel name, so that no formatting
+/// takes place in the backend. Format strings and channel names are emitted once as string definitions the first time
+/// they are seen. The resulting stream is rendered offline by the isrlog_decode tool, see binary_log_format.h.
+/// Context entries are not on the hot path, they are rendered as text by the base class and stored as text records.
+/// NOTE: the output of a formatter instance is a single stream, so it should not be used with sinks that rotate files.
+class binary_formatter : public text_formatter
+{
+public:
+  binary_formatter() = default;
+
+  std::unique_ptr<log_formatter> clone() const override;
+
+  void format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) override;
+
+private:
+  void format_context_begin(const detail::log_entry_metadata& md,
+                            fmt::string_view                  ctx_name,
+                            unsigned                          size,
+                            fmt::memory_buffer&               buffer) override;
+
+  void format_context_end(const detail::log_entry_metadata& md,
+                          fmt::string_view                  ctx_name,
+                          fmt::memory_buffer&               buffer) override;
+
+  /// Writes the stream magic into the buffer if it has not been done yet.
+  void write_stream_header(fmt::memory_buffer& buffer);
+
+  /// Returns the id of the given format string, emitting its definition into the buffer when it is new.
+  uint32_t get_fmt_string_id(const char* str, fmt::memory_buffer& buffer);
+
+  /// Returns the id of the given channel name, emitting its definition into the buffer when it is new.
+  uint32_t get_name_id(const std::string& name, fmt::memory_buffer& buffer);
+
+  /// Emits a new string definition into the buffer and returns its id.
+  uint32_t define_string(fmt::string_view str, fmt::memory_buffer& buffer);
+
+private:
+  bool                                      is_header_written = false;
+  uint32_t                                  next_id           = 1;
+  std::unordered_map<const char*, uint32_t> fmt_ids;
+  std::unordered_map<uint32_t, std::string> fmt_strings;
+  std::unordered_map<std::string, uint32_t> name_ids;
+  size_t                                    text_record_start = 0;
+};
+
+} // namespace isrlog
+
+#endif // ISRLOG_BINARY_FORMATTER_H
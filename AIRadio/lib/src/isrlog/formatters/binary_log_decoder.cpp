@@ -0,0 +1,255 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "binary_log_decoder.h"
+#include "binary_log_format.h"
+#include "isrran/isrlog/detail/log_entry_metadata.h"
+
+using namespace isrlog;
+using namespace isrlog::binary_log;
+
+namespace {
+
+/// Bounds checked reader over a record payload.
+class record_reader
+{
+public:
+  record_reader(const char* data, size_t size) : data(data), end(data + size) {}
+
+  template <typename T>
+  bool read(T& value)
+  {
+    if (size_t(end - data) < sizeof(T)) {
+      return false;
+    }
+    value = load<T>(data);
+    data += sizeof(T);
+    return true;
+  }
+
+  bool read_bytes(size_t len, const char*& ptr)
+  {
+    if (size_t(end - data) < len) {
+      return false;
+    }
+    ptr = data;
+    data += len;
+    return true;
+  }
+
+  size_t remaining() const { return end - data; }
+
+private:
+  const char* data;
+  const char* end;
+};
+
+/// Converts a value read from the stream into the type pushed into the arg store.
+template <typename T, typename U>
+static U convert_arg(T value)
+{
+  return static_cast<U>(value);
+}
+
+template <>
+const void* convert_arg<uint64_t, const void*>(uint64_t value)
+{
+  return reinterpret_cast<const void*>(uintptr_t(value));
+}
+
+/// Reads a value stored as type T and pushes it into the store as type U.
+template <typename T, typename U>
+static bool read_arg(record_reader& r, fmt::dynamic_format_arg_store<fmt::printf_context>& store)
+{
+  T value;
+  if (!r.read(value)) {
+    return false;
+  }
+  store.push_back(convert_arg<T, U>(value));
+  return true;
+}
+
+} // namespace
+
+const std::string* binary_log_decoder::find_string(uint32_t id) const
+{
+  auto it = strings.find(id);
+  return (it != strings.end()) ? &it->second : nullptr;
+}
+
+detail::error_string binary_log_decoder::decode_entry(const char* data, size_t size, fmt::memory_buffer& output)
+{
+  record_reader r(data, size);
+
+  int64_t  ts;
+  uint32_t fmt_id, name_id, ctx_value, hex_len;
+  char     tag;
+  uint8_t  flags;
+  uint16_t nof_args;
+  if (!r.read(ts) || !r.read(fmt_id) || !r.read(name_id) || !r.read(tag) || !r.read(flags) || !r.read(ctx_value) ||
+      !r.read(nof_args) || !r.read(hex_len)) {
+    return "Malformed log entry record";
+  }
+
+  const std::string* fmtstring = find_string(fmt_id);
+  const std::string* name      = find_string(name_id);
+  if ((fmt_id && !fmtstring) || (name_id && !name)) {
+    return "Log entry references an undefined string id";
+  }
+
+  fmt::dynamic_format_arg_store<fmt::printf_context> store;
+  for (uint16_t i = 0; i != nof_args; ++i) {
+    uint8_t type;
+    if (!r.read(type)) {
+      return "Malformed log entry argument";
+    }
+    bool ok;
+    switch (static_cast<arg_type>(type)) {
+      case arg_type::int32:
+        ok = read_arg<int32_t, int32_t>(r, store);
+        break;
+      case arg_type::uint32:
+        ok = read_arg<uint32_t, uint32_t>(r, store);
+        break;
+      case arg_type::int64:
+        ok = read_arg<int64_t, long long>(r, store);
+        break;
+      case arg_type::uint64:
+        ok = read_arg<uint64_t, unsigned long long>(r, store);
+        break;
+      case arg_type::float64:
+        ok = read_arg<double, double>(r, store);
+        break;
+      case arg_type::character:
+        ok = read_arg<char, char>(r, store);
+        break;
+      case arg_type::boolean:
+        ok = read_arg<uint8_t, bool>(r, store);
+        break;
+      case arg_type::pointer:
+        ok = read_arg<uint64_t, const void*>(r, store);
+        break;
+      case arg_type::string: {
+        uint32_t    len;
+        const char* str = nullptr;
+        ok              = r.read(len) && r.read_bytes(len, str);
+        if (ok) {
+          store.push_back(std::string(str, len));
+        }
+        break;
+      }
+      default:
+        return fmt::format("Unknown argument type {}", type);
+    }
+    if (!ok) {
+      return "Malformed log entry argument";
+    }
+  }
+
+  const char* hex = nullptr;
+  if (!r.read_bytes(hex_len, hex)) {
+    return "Malformed log entry hex dump";
+  }
+
+  detail::log_entry_metadata metadata = {
+      std::chrono::high_resolution_clock::time_point(
+          std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::nanoseconds(ts))),
+      {ctx_value, (flags & flag_context_enabled) != 0},
+      fmtstring ? fmtstring->c_str() : nullptr,
+      (flags & flag_has_args) ? &store : nullptr,
+      name ? *name : std::string(),
+      tag,
+      std::vector<uint8_t>(hex, hex + hex_len)};
+
+  formatter->format(std::move(metadata), output);
+  ++nof_entries;
+
+  return {};
+}
+
+detail::error_string binary_log_decoder::decode(detail::memory_buffer input, const output_callback& out)
+{
+  if (input.size() < file_magic_size || std::memcmp(input.data(), file_magic, file_magic_size) != 0) {
+    return "Input is not an isrlog binary stream";
+  }
+
+  fmt::memory_buffer output;
+  size_t             pos = file_magic_size;
+  while (pos + record_header_size <= input.size()) {
+    const char* p    = input.data() + pos;
+    uint32_t    size = load<uint32_t>(p);
+    auto        type = static_cast<record_type>(load<uint8_t>(p + sizeof(uint32_t)));
+
+    // Zero padding marks the end of the data written before the log file was closed.
+    if (size == 0) {
+      break;
+    }
+    if (size < record_header_size) {
+      return fmt::format("Invalid record size {} at offset {}", size, pos);
+    }
+    if (pos + size > input.size()) {
+      break;
+    }
+
+    const char* payload      = p + record_header_size;
+    size_t      payload_size = size - record_header_size;
+    output.clear();
+    switch (type) {
+      case record_type::string_def: {
+        if (payload_size < sizeof(uint32_t)) {
+          return fmt::format("Malformed string record at offset {}", pos);
+        }
+        strings[load<uint32_t>(payload)].assign(payload + sizeof(uint32_t), payload_size - sizeof(uint32_t));
+        break;
+      }
+      case record_type::entry:
+        if (auto err = decode_entry(payload, payload_size, output)) {
+          return fmt::format("{} at offset {}", err.get_error(), pos);
+        }
+        break;
+      case record_type::text: {
+        if (payload_size < sizeof(int64_t) + sizeof(uint32_t)) {
+          return fmt::format("Malformed text record at offset {}", pos);
+        }
+        size_t hdr = sizeof(int64_t) + sizeof(uint32_t);
+        output.append(payload + hdr, payload + payload_size);
+        ++nof_entries;
+        break;
+      }
+      default:
+        return fmt::format("Unknown record type {} at offset {}", static_cast<unsigned>(type), pos);
+    }
+
+    if (output.size()) {
+      out(output);
+    }
+    pos += size;
+  }
+
+  // Anything left that is not zero padding belongs to a record that was cut while being written.
+  size_t last = input.size();
+  while (last > pos && input.data()[last - 1] == 0) {
+    --last;
+  }
+  nof_truncated_bytes = last - pos;
+
+  return {};
+}
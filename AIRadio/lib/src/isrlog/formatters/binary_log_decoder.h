@@ -0,0 +1,71 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRLOG_BINARY_LOG_DECODER_H
+#define ISRLOG_BINARY_LOG_DECODER_H
+
+#include "isrran/isrlog/detail/support/error_string.h"
+#include "isrran/isrlog/detail/support/memory_buffer.h"
+#include "isrran/isrlog/formatter.h"
+#include <functional>
+#include <unordered_map>
+
+namespace isrlog {
+
+/// Renders a stream produced by binary_formatter using the specified formatter, e.g. a text or JSON formatter, giving
+/// the same output the formatter would have produced if it had been installed in the sink when logging.
+/// Context entries were already rendered as text when logged, so they are output verbatim.
+class binary_log_decoder
+{
+public:
+  /// Receives the rendered output of each record.
+  using output_callback = std::function<void(const fmt::memory_buffer& output)>;
+
+  explicit binary_log_decoder(std::unique_ptr<log_formatter> f) : formatter(std::move(f)) {}
+
+  /// Decodes all the records in the input stream. The stream may end with zero padding or a truncated record, as
+  /// left behind by a process that did not terminate cleanly, in which case decoding stops there without error.
+  /// Returns an error when the stream is malformed.
+  detail::error_string decode(detail::memory_buffer input, const output_callback& out);
+
+  /// Number of log entries decoded so far.
+  size_t get_nof_entries() const { return nof_entries; }
+
+  /// Number of trailing bytes that could not be decoded because the stream was truncated.
+  size_t get_nof_truncated_bytes() const { return nof_truncated_bytes; }
+
+private:
+  /// Decodes an entry record, the input points past the record header.
+  detail::error_string decode_entry(const char* data, size_t size, fmt::memory_buffer& output);
+
+  /// Returns the string with the specified id, or nullptr if it is unknown.
+  const std::string* find_string(uint32_t id) const;
+
+private:
+  std::unique_ptr<log_formatter>            formatter;
+  std::unordered_map<uint32_t, std::string> strings;
+  size_t                                    nof_entries         = 0;
+  size_t                                    nof_truncated_bytes = 0;
+};
+
+} // namespace isrlog
+
+#endif // ISRLOG_BINARY_LOG_DECODER_H
@@ -0,0 +1,72 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRLOG_BINARY_LOG_FORMAT_H
+#define ISRLOG_BINARY_LOG_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace isrlog {
+
+/// Layout of the binary log stream produced by binary_formatter.
+///
+/// The stream starts with the 8 byte magic "ISRLOGB1" followed by a sequence of records. All integers are stored in
+/// host byte order. Each record begins with a header:
+///   u32 size  -> total record size in bytes, header included
+///   u8  type  -> record_type
+///
+/// string_def: u32 id, string bytes (no terminator).
+///   Defines a format string or a channel name referenced by later records. Id 0 is reserved for "no string".
+/// entry: i64 timestamp (ns since epoch), u32 fmt id, u32 channel name id, u8 tag, u8 flags, u32 context value,
+///   u16 number of arguments, u32 hex dump length, arguments, hex dump bytes.
+///   Each argument is an arg_type byte followed by its value, strings are prefixed by a u32 length.
+/// text: i64 timestamp, u32 channel name id, text bytes.
+///   Already formatted output, used for context (metrics) entries.
+namespace binary_log {
+
+constexpr char     file_magic[]    = "ISRLOGB1";
+constexpr unsigned file_magic_size = 8;
+
+enum class record_type : uint8_t { string_def = 1, entry = 2, text = 3 };
+
+enum class arg_type : uint8_t { int32 = 1, uint32, int64, uint64, float64, character, boolean, string, pointer };
+
+/// Entry flags.
+constexpr uint8_t flag_context_enabled = 1u << 0u;
+constexpr uint8_t flag_has_args        = 1u << 1u;
+
+constexpr unsigned record_header_size = sizeof(uint32_t) + sizeof(uint8_t);
+
+/// Reads a value of type T from the given address.
+template <typename T>
+inline T load(const char* p)
+{
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  return value;
+}
+
+} // namespace binary_log
+
+} // namespace isrlog
+
+#endif // ISRLOG_BINARY_LOG_FORMAT_H
@@ -36,7 +36,7 @@ public:
 
   void format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) override;
 
-private:
+protected:
   void format_context_begin(const detail::log_entry_metadata& md,
                             fmt::string_view                  ctx_name,
                             unsigned                          size,
@@ -65,6 +65,7 @@ private:
                      unsigned            level,
                      fmt::memory_buffer& buffer) override;
 
+private:
   /// Returns the set name of current scope.
   const std::string& get_current_set_name() const
   {
@@ -20,8 +20,10 @@
  */
 
 #include "isrran/isrlog/isrlog.h"
+#include "formatters/binary_formatter.h"
 #include "formatters/json_formatter.h"
 #include "sinks/file_sink.h"
+#include "sinks/mmap_file_sink.h"
 #include "sinks/syslog_sink.h"
 #include "isrlog_instance.h"
 
@@ -105,6 +107,11 @@ std::unique_ptr<log_formatter> isrlog::create_json_formatter()
   return std::unique_ptr<log_formatter>(new json_formatter);
 }
 
+std::unique_ptr<log_formatter> isrlog::create_binary_formatter()
+{
+  return std::unique_ptr<log_formatter>(new binary_formatter);
+}
+
 ///
 /// Sink management function implementations.
 ///
@@ -178,6 +185,22 @@ sink& isrlog::fetch_file_sink(const std::string&             path,
   return *s;
 }
 
+sink& isrlog::fetch_binary_file_sink(const std::string& path, size_t chunk_size)
+{
+  assert(!path.empty() && "Empty path string");
+
+  if (auto* s = find_sink(path)) {
+    return *s;
+  }
+
+  auto& s = isrlog_instance::get().get_sink_repo().emplace(
+      std::piecewise_construct,
+      std::forward_as_tuple(path),
+      std::forward_as_tuple(new mmap_file_sink(path, chunk_size, create_binary_formatter())));
+
+  return *s;
+}
+
 sink& isrlog::fetch_syslog_sink(const std::string&             preamble_,
                                 syslog_local_type              log_local_,
                                 std::unique_ptr<log_formatter> f)
@@ -238,6 +261,9 @@ void isrlog::flush()
   }
 
   detail::log_entry cmd;
+  // The backend merges entries from different threads by timestamp, stamp the command so that it runs after all the
+  // entries logged before this call.
+  cmd.metadata.tp    = std::chrono::high_resolution_clock::now();
   cmd.metadata.store = nullptr;
   cmd.flush_cmd =
       std::unique_ptr<detail::flush_backend_cmd>(new detail::flush_backend_cmd{completion_flag, std::move(sinks)});
@@ -61,9 +61,9 @@ public:
   void stop() { worker.stop(); }
 
 private:
-  detail::work_queue<detail::log_entry> queue;
-  detail::dyn_arg_store_pool            arg_pool;
-  backend_worker                        worker{queue, arg_pool};
+  log_entry_queue            queue;
+  detail::dyn_arg_store_pool arg_pool;
+  backend_worker             worker{queue, arg_pool};
 };
 
 } // namespace isrlog
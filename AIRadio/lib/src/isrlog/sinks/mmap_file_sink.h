@@ -0,0 +1,153 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef ISRLOG_MMAP_FILE_SINK_H
+#define ISRLOG_MMAP_FILE_SINK_H
+
+#include "file_utils.h"
+#include "isrran/isrlog/sink.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace isrlog {
+
+/// This sink writes into a memory mapped file, so that each write is a plain memory copy and the kernel takes care of
+/// writing the pages back in the background. The file grows in chunks of the specified size and is trimmed to the
+/// written size on destruction. Data written before an abnormal termination is still in the page cache and reaches the
+/// file, followed by zero padding up to the end of the last chunk.
+class mmap_file_sink : public sink
+{
+public:
+  mmap_file_sink(std::string filename, size_t chunk_size, std::unique_ptr<log_formatter> f) :
+    sink(std::move(f)), filename(std::move(filename)), chunk_size(round_to_page(std::max<size_t>(chunk_size, 1)))
+  {}
+
+  ~mmap_file_sink() override { close(); }
+
+  mmap_file_sink(const mmap_file_sink& other) = delete;
+  mmap_file_sink& operator=(const mmap_file_sink& other) = delete;
+
+  detail::error_string write(detail::memory_buffer buffer) override
+  {
+    // Create a new file the first time we hit this method.
+    if (!is_file_created) {
+      is_file_created = true;
+      fd              = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) {
+        return file_utils::format_error(fmt::format("Unable to create log file \"{}\"", filename), errno);
+      }
+    }
+
+    // Do not bother doing any work when the file was closed on a previous error.
+    if (fd < 0) {
+      return {};
+    }
+
+    if (pos + buffer.size() > mapped_size) {
+      if (auto err_str = grow(pos + buffer.size())) {
+        close();
+        return err_str;
+      }
+    }
+
+    std::memcpy(base + pos, buffer.data(), buffer.size());
+    pos += buffer.size();
+
+    return {};
+  }
+
+  detail::error_string flush() override
+  {
+    if (!base || pos == synced_pos) {
+      return {};
+    }
+
+    // Start the write back of the pages touched since the last flush without waiting for it.
+    size_t start = round_down_to_page(synced_pos);
+    if (::msync(base + start, pos - start, MS_ASYNC) != 0) {
+      return file_utils::format_error(fmt::format("Error encountered while flushing log file \"{}\"", filename), errno);
+    }
+    synced_pos = pos;
+
+    return {};
+  }
+
+private:
+  static size_t page_size() { return ::sysconf(_SC_PAGESIZE); }
+  static size_t round_to_page(size_t n) { return (n + page_size() - 1) / page_size() * page_size(); }
+  static size_t round_down_to_page(size_t n) { return n / page_size() * page_size(); }
+
+  /// Extends the file and its mapping so that at least min_size bytes fit in it.
+  detail::error_string grow(size_t min_size)
+  {
+    size_t new_size = mapped_size;
+    while (new_size < min_size) {
+      new_size += chunk_size;
+    }
+
+    if (::ftruncate(fd, new_size) != 0) {
+      return file_utils::format_error(fmt::format("Unable to extend log file \"{}\"", filename), errno);
+    }
+
+    void* p = base ? ::mremap(base, mapped_size, new_size, MREMAP_MAYMOVE)
+                   : ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      return file_utils::format_error(fmt::format("Unable to map log file \"{}\"", filename), errno);
+    }
+    base        = static_cast<char*>(p);
+    mapped_size = new_size;
+
+    return {};
+  }
+
+  /// Unmaps and closes the file trimming it to the written size.
+  void close()
+  {
+    if (base) {
+      ::munmap(base, mapped_size);
+      base        = nullptr;
+      mapped_size = 0;
+    }
+    if (fd >= 0) {
+      if (::ftruncate(fd, pos) != 0) {
+        fmt::print(stderr, "isrLog error - Unable to trim log file \"{}\"\n", filename);
+      }
+      ::close(fd);
+      fd = -1;
+    }
+  }
+
+private:
+  const std::string filename;
+  const size_t      chunk_size;
+  int               fd              = -1;
+  char*             base            = nullptr;
+  size_t            mapped_size     = 0;
+  size_t            pos             = 0;
+  size_t            synced_pos      = 0;
+  bool              is_file_created = false;
+};
+
+} // namespace isrlog
+
+#endif // ISRLOG_MMAP_FILE_SINK_H
@@ -0,0 +1,118 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/// Renders binary log files, as written by isrlog::fetch_binary_file_sink, into text or JSON.
+///
+/// Usage: isrlog_decode [-j] [-o output_file] input_file
+
+#include "isrran/isrlog/isrlog.h"
+#include "formatters/binary_log_decoder.h"
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace isrlog;
+
+static void usage(const char* prog)
+{
+  fmt::print("Usage: {} [-j] [-o output_file] input_file\n"
+             "\t-j Render entries as JSON instead of plain text\n"
+             "\t-o Write the output to a file instead of stdout\n",
+             prog);
+}
+
+int main(int argc, char** argv)
+{
+  bool        json        = false;
+  const char* output_path = nullptr;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "jo:h")) != -1) {
+    switch (opt) {
+      case 'j':
+        json = true;
+        break;
+      case 'o':
+        output_path = optarg;
+        break;
+      default:
+        usage(argv[0]);
+        return -1;
+    }
+  }
+  if (optind + 1 != argc) {
+    usage(argv[0]);
+    return -1;
+  }
+  const char* input_path = argv[optind];
+
+  int fd = ::open(input_path, O_RDONLY);
+  if (fd < 0) {
+    fmt::print(stderr, "Unable to open \"{}\": {}\n", input_path, strerror(errno));
+    return -1;
+  }
+  struct stat st = {};
+  if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+    fmt::print(stderr, "Unable to read \"{}\"\n", input_path);
+    ::close(fd);
+    return -1;
+  }
+  void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    fmt::print(stderr, "Unable to map \"{}\": {}\n", input_path, strerror(errno));
+    return -1;
+  }
+  ::madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+  std::FILE* out = output_path ? std::fopen(output_path, "wb") : stdout;
+  if (!out) {
+    fmt::print(stderr, "Unable to create \"{}\": {}\n", output_path, strerror(errno));
+    ::munmap(data, st.st_size);
+    return -1;
+  }
+
+  binary_log_decoder decoder(json ? create_json_formatter() : create_text_formatter());
+  auto               write_output = [out](const fmt::memory_buffer& buffer) {
+    std::fwrite(buffer.data(), 1, buffer.size(), out);
+  };
+  auto err = decoder.decode(detail::memory_buffer(static_cast<const char*>(data), st.st_size), write_output);
+
+  if (out != stdout) {
+    std::fclose(out);
+  }
+  ::munmap(data, st.st_size);
+
+  if (err) {
+    fmt::print(stderr, "Error decoding \"{}\": {}\n", input_path, err.get_error());
+    return -1;
+  }
+  if (decoder.get_nof_truncated_bytes()) {
+    fmt::print(stderr,
+               "Warning: last {} bytes of \"{}\" belong to an incomplete record and were skipped\n",
+               decoder.get_nof_truncated_bytes(),
+               input_path);
+  }
+
+  return 0;
+}
@@ -0,0 +1,315 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/isrlog/trace_ring.h"
+#include "isrran/isrlog/bundled/fmt/format.h"
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace isrlog;
+
+std::atomic<bool> isrlog::detail::trace_ring_enabled{false};
+
+namespace {
+
+/// Raw event as stored in a ring. The fields are atomics so that the rings can be read while being written: the
+/// dump discards any event that may have been overwritten during the copy.
+struct trace_ring_entry {
+  std::atomic<uint64_t> timestamp;
+  /// Packs the point id (bits 0-15), the phase (bits 16-23) and the argument (bits 32-63).
+  std::atomic<uint64_t> data;
+};
+
+/// Ring owned by a single thread.
+struct thread_ring {
+  thread_ring(uint32_t size, int tid, std::string name) : entries(size), mask(size - 1), tid(tid), name(std::move(name))
+  {}
+
+  std::vector<trace_ring_entry> entries;
+  const uint64_t                mask;
+  std::atomic<uint64_t>         write_idx{0};
+  const int                     tid;
+  const std::string             name;
+};
+
+/// Instrumentation point description.
+struct trace_point {
+  const char* category;
+  const char* name;
+};
+
+/// Global state of the trace ring framework.
+struct trace_ring_state {
+  std::mutex                                mutex;
+  uint32_t                                  ring_size = 0;
+  std::vector<std::unique_ptr<thread_ring>> rings;
+  std::vector<trace_point>                  points;
+  // Reference pair to convert time stamp counter values into time.
+  uint64_t                              ref_ticks = 0;
+  std::chrono::steady_clock::time_point ref_time;
+  // Signal triggered dumps.
+  std::atomic<bool> dump_requested{false};
+  std::atomic<bool> watcher_running{false};
+  std::thread       watcher;
+};
+
+} // namespace
+
+static trace_ring_state& get_state()
+{
+  static trace_ring_state state;
+  return state;
+}
+
+/// Returns the current value of the time stamp counter, or of the steady clock in nanoseconds on architectures
+/// without one.
+static inline uint64_t read_ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+static uint32_t round_up_pow2(uint32_t n)
+{
+  uint32_t v = 1;
+  while (v < n) {
+    v <<= 1u;
+  }
+  return v;
+}
+
+void isrlog::trace_ring_init(uint32_t nof_events_per_thread)
+{
+  trace_ring_state&           state = get_state();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (state.ring_size) {
+    return;
+  }
+
+  state.ring_size = round_up_pow2(std::max(nof_events_per_thread, 2u));
+  state.ref_ticks = read_ticks();
+  state.ref_time  = std::chrono::steady_clock::now();
+  detail::trace_ring_enabled.store(true, std::memory_order_release);
+}
+
+bool isrlog::trace_ring_is_enabled()
+{
+  return detail::trace_ring_enabled.load(std::memory_order_relaxed);
+}
+
+uint16_t isrlog::detail::trace_ring_register(const char* category, const char* name)
+{
+  trace_ring_state&           state = get_state();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (state.points.size() == std::numeric_limits<uint16_t>::max()) {
+    // Out of ids, reuse the last one.
+    return state.points.size() - 1;
+  }
+  state.points.push_back({category, name});
+  return state.points.size() - 1;
+}
+
+/// Creates and registers the ring of the calling thread.
+static thread_ring* create_thread_ring()
+{
+  char name[32] = {};
+  ::pthread_getname_np(::pthread_self(), name, sizeof(name));
+
+  trace_ring_state&           state = get_state();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.rings.emplace_back(new thread_ring(state.ring_size, ::syscall(SYS_gettid), name));
+  return state.rings.back().get();
+}
+
+void isrlog::detail::trace_ring_push(uint16_t id, trace_ring_phase phase, uint32_t arg)
+{
+  static thread_local thread_ring* ring = nullptr;
+  if (ring == nullptr) {
+    ring = create_thread_ring();
+  }
+
+  uint64_t          idx   = ring->write_idx.load(std::memory_order_relaxed);
+  trace_ring_entry& entry = ring->entries[idx & ring->mask];
+  entry.timestamp.store(read_ticks(), std::memory_order_relaxed);
+  entry.data.store(uint64_t(id) | (uint64_t(phase) << 16u) | (uint64_t(arg) << 32u), std::memory_order_relaxed);
+  ring->write_idx.store(idx + 1, std::memory_order_release);
+}
+
+/// Returns the number of ticks per microsecond measured since initialization.
+static double measure_ticks_per_us(const trace_ring_state& state)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  // Make sure the measurement spans a reasonable interval.
+  while (std::chrono::steady_clock::now() - state.ref_time < std::chrono::milliseconds(10)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  uint64_t ticks   = read_ticks();
+  auto     elapsed = std::chrono::steady_clock::now() - state.ref_time;
+  double   us      = std::chrono::duration<double, std::micro>(elapsed).count();
+  return (ticks - state.ref_ticks) / us;
+#else
+  return 1000.0;
+#endif
+}
+
+/// Appends the events held in the given ring into the JSON buffer.
+static void dump_ring(thread_ring&                    ring,
+                      const std::vector<trace_point>& points,
+                      uint64_t                        ref_ticks,
+                      double                          ticks_per_us,
+                      int                             pid,
+                      fmt::memory_buffer&             buffer)
+{
+  fmt::format_to(buffer,
+                 ",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                 pid,
+                 ring.tid,
+                 ring.name);
+
+  uint64_t size  = ring.mask + 1;
+  uint64_t end   = ring.write_idx.load(std::memory_order_acquire);
+  uint64_t begin = (end > size) ? end - size : 0;
+
+  std::vector<std::pair<uint64_t, uint64_t> > copy;
+  copy.reserve(end - begin);
+  for (uint64_t i = begin; i != end; ++i) {
+    const trace_ring_entry& e = ring.entries[i & ring.mask];
+    copy.emplace_back(e.timestamp.load(std::memory_order_relaxed), e.data.load(std::memory_order_relaxed));
+  }
+
+  // Discard the events the writer may have overwritten while they were being copied, including the slot of the event
+  // being written right now.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t new_end  = ring.write_idx.load(std::memory_order_relaxed);
+  uint64_t first_ok = (new_end + 1 > size) ? new_end + 1 - size : 0;
+  uint64_t skip     = (first_ok > begin) ? std::min(first_ok - begin, end - begin) : 0;
+
+  static const char phase_str[] = {'B', 'E', 'i'};
+
+  for (uint64_t i = skip, e = copy.size(); i != e; ++i) {
+    uint64_t ticks = copy[i].first;
+    uint64_t data  = copy[i].second;
+    uint16_t id    = data & 0xffffu;
+    uint8_t  phase = (data >> 16u) & 0xffu;
+    uint32_t arg   = data >> 32u;
+    if (id >= points.size() || phase > 2) {
+      continue;
+    }
+
+    double ts = (int64_t(ticks - ref_ticks)) / ticks_per_us;
+    fmt::format_to(buffer,
+                   ",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"{}\",\"ts\":{:.3f},\"pid\":{},\"tid\":{}",
+                   points[id].name,
+                   points[id].category,
+                   phase_str[phase],
+                   ts,
+                   pid,
+                   ring.tid);
+    if (phase == uint8_t(detail::trace_ring_phase::instant)) {
+      fmt::format_to(buffer, ",\"s\":\"t\"");
+    }
+    fmt::format_to(buffer, ",\"args\":{{\"arg\":{}}}}}", arg);
+  }
+}
+
+bool isrlog::trace_ring_dump(const std::string& filename)
+{
+  trace_ring_state& state = get_state();
+  if (!trace_ring_is_enabled()) {
+    return false;
+  }
+
+  double ticks_per_us = measure_ticks_per_us(state);
+  int    pid          = ::getpid();
+
+  fmt::memory_buffer buffer;
+  fmt::format_to(buffer,
+                 "{{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+                 "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"name\":\"isrRAN\"}}}}",
+                 pid);
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (auto& ring : state.rings) {
+      dump_ring(*ring, state.points, state.ref_ticks, ticks_per_us, pid, buffer);
+    }
+  }
+  fmt::format_to(buffer, "\n]}}\n");
+
+  std::FILE* f = std::fopen(filename.c_str(), "w");
+  if (!f) {
+    fmt::print(stderr, "isrLog error - Unable to create trace file \"{}\"\n", filename);
+    return false;
+  }
+  bool ok = std::fwrite(buffer.data(), 1, buffer.size(), f) == buffer.size();
+  std::fclose(f);
+
+  return ok;
+}
+
+static void trace_ring_signal_handler(int)
+{
+  get_state().dump_requested.store(true, std::memory_order_relaxed);
+}
+
+void isrlog::trace_ring_dump_on_signal(const std::string& filename, int signum)
+{
+  trace_ring_state&           state = get_state();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (state.watcher_running) {
+    return;
+  }
+
+  state.watcher_running = true;
+  state.watcher         = std::thread([filename]() {
+    trace_ring_state& s = get_state();
+    // Dumping is not async signal safe, the handler only raises a flag which is polled here.
+    while (s.watcher_running) {
+      if (s.dump_requested.exchange(false)) {
+        trace_ring_dump(filename);
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+  });
+  ::signal(signum, trace_ring_signal_handler);
+}
+
+void isrlog::trace_ring_stop()
+{
+  trace_ring_state& state = get_state();
+  state.watcher_running   = false;
+  if (state.watcher.joinable()) {
+    state.watcher.join();
+  }
+}
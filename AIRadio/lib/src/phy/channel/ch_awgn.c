@@ -200,25 +200,27 @@ float isrran_ch_awgn_get_variance(float ebno_db, float rate)
   return isrran_convert_dB_to_amplitude(-esno_db);
 }
 
-void isrran_ch_awgn_c(const cf_t* x, cf_t* y, float variance, uint32_t len)
+// Number of Gaussian samples generated at once by the legacy AWGN functions
+#define AWGN_GAUSS_BLOCK 256
+
+static void ch_awgn_run(const float* x, float* y, float stddev, uint32_t len)
 {
-  cf_t     tmp;
-  uint32_t i;
-  float    stddev = sqrtf(variance);
-
-  for (i = 0; i < len; i++) {
-    __real__ tmp = rand_gauss();
-    __imag__ tmp = rand_gauss();
-    tmp *= stddev * (float)M_SQRT1_2;
-    y[i] = tmp + x[i];
+  float noise[AWGN_GAUSS_BLOCK];
+
+  for (uint32_t i = 0; i < len; i += AWGN_GAUSS_BLOCK) {
+    uint32_t n = ISRRAN_MIN(AWGN_GAUSS_BLOCK, len - i);
+    rand_gauss_vec(noise, n);
+    isrran_vec_sc_prod_fff(noise, stddev, noise, n);
+    isrran_vec_sum_fff(&x[i], noise, &y[i], n);
   }
 }
-void isrran_ch_awgn_f(const float* x, float* y, float variance, uint32_t len)
+
+void isrran_ch_awgn_c(const cf_t* x, cf_t* y, float variance, uint32_t len)
 {
-  uint32_t i;
-  float    stddev = sqrtf(variance);
+  ch_awgn_run((const float*)x, (float*)y, sqrtf(variance) * (float)M_SQRT1_2, 2 * len);
+}
 
-  for (i = 0; i < len; i++) {
-    y[i] = x[i] + stddev * rand_gauss();
-  }
+void isrran_ch_awgn_f(const float* x, float* y, float variance, uint32_t len)
+{
+  ch_awgn_run(x, y, sqrtf(variance), len);
 }
@@ -19,9 +19,12 @@
  *
  */
 
+#include <condition_variable>
 #include <cstdlib>
+#include <isrran/common/thread_pool.h>
 #include <isrran/phy/channel/channel.h>
 #include <isrran/isrran.h>
+#include <mutex>
 
 using namespace isrran;
 
@@ -43,15 +46,15 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels, is
   // Copy args
   args = channel_args;
 
-  // Allocate internal buffers
-  buffer_in  = isrran_vec_cf_malloc(buffer_size);
-  buffer_out = isrran_vec_cf_malloc(buffer_size);
-  if (!buffer_out || !buffer_in) {
-    ret = ISRRAN_ERROR;
-  }
-
   nof_channels = _nof_channels;
   for (uint32_t i = 0; i < nof_channels; i++) {
+    // Allocate internal buffers, every RF channel has its own so they can be processed concurrently
+    buffer_in[i]  = isrran_vec_cf_malloc(buffer_size);
+    buffer_out[i] = isrran_vec_cf_malloc(buffer_size);
+    if (!buffer_out[i] || !buffer_in[i]) {
+      ret = ISRRAN_ERROR;
+    }
+
     // Create fading channel
     if (channel_args.fading_enable && !channel_args.fading_model.empty() && channel_args.fading_model != "none" &&
         ret == ISRRAN_SUCCESS) {
@@ -73,13 +76,15 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels, is
     } else {
       delay[i] = nullptr;
     }
-  }
 
-  // Create AWGN channnel
-  if (channel_args.awgn_enable && ret == ISRRAN_SUCCESS) {
-    awgn = (isrran_channel_awgn_t*)calloc(sizeof(isrran_channel_awgn_t), 1);
-    ret  = isrran_channel_awgn_init(awgn, 1234);
-    isrran_channel_awgn_set_n0(awgn, args.awgn_signal_power_dBfs - args.awgn_snr_dB);
+    // Create AWGN channnel
+    if (channel_args.awgn_enable && ret == ISRRAN_SUCCESS) {
+      awgn[i] = (isrran_channel_awgn_t*)calloc(sizeof(isrran_channel_awgn_t), 1);
+      ret     = isrran_channel_awgn_init(awgn[i], 1234 + i);
+      isrran_channel_awgn_set_n0(awgn[i], args.awgn_signal_power_dBfs - args.awgn_snr_dB);
+    } else {
+      awgn[i] = nullptr;
+    }
   }
 
   // Create high speed train
@@ -101,19 +106,6 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels, is
 
 channel::~channel()
 {
-  if (buffer_in) {
-    free(buffer_in);
-  }
-
-  if (buffer_out) {
-    free(buffer_out);
-  }
-
-  if (awgn) {
-    isrran_channel_awgn_free(awgn);
-    free(awgn);
-  }
-
   if (hst) {
     isrran_channel_hst_free(hst);
     free(hst);
@@ -125,6 +117,19 @@ channel::~channel()
   }
 
   for (uint32_t i = 0; i < nof_channels; i++) {
+    if (buffer_in[i]) {
+      free(buffer_in[i]);
+    }
+
+    if (buffer_out[i]) {
+      free(buffer_out[i]);
+    }
+
+    if (awgn[i]) {
+      isrran_channel_awgn_free(awgn[i]);
+      free(awgn[i]);
+    }
+
     if (fading[i]) {
       isrran_channel_fading_free(fading[i]);
       free(fading[i]);
@@ -147,6 +152,39 @@ static inline cf_t local_cexpf(float phase)
 }
 }
 
+namespace {
+
+/// Counts the tasks of a batch and wakes up the caller when the last one finishes
+class channel_batch_sync
+{
+public:
+  explicit channel_batch_sync(uint32_t nof_tasks) : pending(nof_tasks) {}
+
+  void task_done()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending--;
+    if (pending == 0) {
+      cvar.notify_all();
+    }
+  }
+
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (pending > 0) {
+      cvar.wait(lock);
+    }
+  }
+
+private:
+  std::mutex              mutex;
+  std::condition_variable cvar;
+  uint32_t                pending;
+};
+
+} // namespace
+
 void channel::run(cf_t*                     in[ISRRAN_MAX_CHANNELS],
                   cf_t*                     out[ISRRAN_MAX_CHANNELS],
                   uint32_t                  len,
@@ -157,53 +195,121 @@ void channel::run(cf_t*                     in[ISRRAN_MAX_CHANNELS],
     return;
   }
 
+  // Process the RF channels concurrently if a pool is available
+  if (pool != nullptr && nof_channels > 1) {
+    batch_item_t item = {};
+    item.ch           = this;
+    item.len          = len;
+    item.t            = t;
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      item.in[i]  = in[i];
+      item.out[i] = out[i];
+    }
+    run_batch(*pool, &item, 1);
+    return;
+  }
+
+  run_begin(t);
+
   // For each channel
   for (uint32_t i = 0; i < nof_channels; i++) {
-    // Skip iteration if any buffer is null
-    if (in[i] == nullptr || out[i] == nullptr) {
-      continue;
-    }
+    run_port(i, in[i], out[i], len, t);
+  }
 
-    // If sampling rate is not set, copy input and skip rest of channel
-    if (current_srate == 0) {
-      if (in[i] != out[i]) {
-        isrran_vec_cf_copy(out[i], in[i], len);
-      }
-      continue;
-    }
+  run_end(len, t);
+}
 
-    // Copy input buffer
-    isrran_vec_cf_copy(buffer_in, in[i], len);
+void channel::run_batch(task_thread_pool& batch_pool, batch_item_t* items, uint32_t nof_items)
+{
+  uint32_t nof_tasks = 0;
+  for (uint32_t n = 0; n < nof_items; n++) {
+    items[n].ch->run_begin(items[n].t);
+    nof_tasks += items[n].ch->nof_channels;
+  }
 
-    if (hst) {
-      isrran_channel_hst_execute(hst, buffer_in, buffer_out, len, &t);
-      isrran_vec_sc_prod_ccc(buffer_out, local_cexpf(hst_init_phase), buffer_in, len);
+  channel_batch_sync sync(nof_tasks);
+  for (uint32_t n = 0; n < nof_items; n++) {
+    batch_item_t* item = &items[n];
+    for (uint32_t i = 0; i < item->ch->nof_channels; i++) {
+      batch_pool.push_task([item, i, &sync]() {
+        item->ch->run_port(i, item->in[i], item->out[i], item->len, item->t);
+        sync.task_done();
+      });
     }
+  }
+  sync.wait();
 
-    if (awgn) {
-      isrran_channel_awgn_run_c(awgn, buffer_in, buffer_out, len);
-      isrran_vec_cf_copy(buffer_in, buffer_out, len);
-    }
+  for (uint32_t n = 0; n < nof_items; n++) {
+    items[n].ch->run_end(items[n].len, items[n].t);
+  }
+}
 
-    if (fading[i]) {
-      isrran_channel_fading_execute(fading[i], buffer_in, buffer_out, len, t.full_secs + t.frac_secs);
-      isrran_vec_cf_copy(buffer_in, buffer_out, len);
-    }
+void channel::run_begin(const isrran_timestamp_t& t)
+{
+  // The doppler shift is shared by all the RF channels, compute it once
+  if (hst && current_srate != 0) {
+    isrran_channel_hst_update(hst, &t);
+  }
+}
 
-    if (delay[i]) {
-      isrran_channel_delay_execute(delay[i], buffer_in, buffer_out, len, &t);
-      isrran_vec_cf_copy(buffer_in, buffer_out, len);
-    }
+void channel::run_port(uint32_t i, const cf_t* in, cf_t* out, uint32_t len, const isrran_timestamp_t& t)
+{
+  // Skip iteration if any buffer is null
+  if (in == nullptr || out == nullptr) {
+    return;
+  }
 
-    if (rlf) {
-      isrran_channel_rlf_execute(rlf, buffer_in, buffer_out, len, &t);
-      isrran_vec_cf_copy(buffer_in, buffer_out, len);
+  // If sampling rate is not set, copy input and skip rest of channel
+  if (current_srate == 0) {
+    if (in != out) {
+      isrran_vec_cf_copy(out, in, len);
     }
+    return;
+  }
 
-    // Copy output buffer
-    isrran_vec_cf_copy(out[i], buffer_in, len);
+  // Every stage reads from src and writes into dst, then the buffers are swapped instead of copied
+  const cf_t* src   = in;
+  cf_t*       dst   = buffer_in[i];
+  cf_t*       spare = buffer_out[i];
+  auto        next  = [&src, &dst, &spare]() {
+    src = dst;
+    std::swap(dst, spare);
+  };
+
+  if (hst) {
+    isrran_channel_hst_apply(hst, src, dst, len);
+    isrran_vec_sc_prod_ccc(dst, local_cexpf(hst_init_phase), dst, len);
+    next();
   }
 
+  if (awgn[i]) {
+    isrran_channel_awgn_run_c(awgn[i], src, dst, len);
+    next();
+  }
+
+  if (fading[i]) {
+    isrran_channel_fading_execute(fading[i], src, dst, len, t.full_secs + t.frac_secs);
+    next();
+  }
+
+  if (delay[i]) {
+    isrran_channel_delay_execute(delay[i], src, dst, len, &t);
+    next();
+  }
+
+  if (rlf) {
+    isrran_channel_rlf_execute(rlf, src, dst, len, &t);
+    next();
+  }
+
+  // Copy output buffer
+  if (src != out) {
+    isrran_vec_cf_copy(out, src, len);
+  }
+}
+
+void channel::run_end(uint32_t len, const isrran_timestamp_t& t)
+{
   if (hst) {
     // Increment phase to keep it coherent between frames
     hst_init_phase += (2 * M_PI * len * hst->fs_hz / hst->srate_hz);
@@ -220,15 +326,17 @@ void channel::run(cf_t*                     in[ISRRAN_MAX_CHANNELS],
   }
 
   // Logging
-  std::stringstream str;
-  str << "Channel: t=" << t.full_secs + t.frac_secs << "s; ";
-  if (delay[0]) {
-    str << "delay=" << delay[0]->delay_us << "us; ";
-  }
-  if (hst) {
-    str << "hst=" << hst->fs_hz << "Hz; ";
+  if (logger.debug.enabled()) {
+    std::stringstream str;
+    str << "Channel: t=" << t.full_secs + t.frac_secs << "s; ";
+    if (delay[0]) {
+      str << "delay=" << delay[0]->delay_us << "us; ";
+    }
+    if (hst) {
+      str << "hst=" << hst->fs_hz << "Hz; ";
+    }
+    logger.debug("%s", str.str().c_str());
   }
-  logger.debug("%s", str.str().c_str());
 }
 
 void channel::set_srate(uint32_t srate)
@@ -257,7 +365,9 @@ void channel::set_srate(uint32_t srate)
 
 void channel::set_signal_power_dBfs(float power_dBfs)
 {
-  if (awgn != nullptr) {
-    isrran_channel_awgn_set_n0(awgn, power_dBfs - args.awgn_snr_dB);
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    if (awgn[i] != nullptr) {
+      isrran_channel_awgn_set_n0(awgn[i], power_dBfs - args.awgn_snr_dB);
+    }
   }
 }
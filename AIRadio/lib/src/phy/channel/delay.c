@@ -50,9 +50,33 @@ static inline uint32_t calculate_delay_nsamples(isrran_channel_delay_t* q)
   return (uint32_t)round(q->delay_us * (double)q->srate_hz / 1e6);
 }
 
-static inline uint32_t ringbuffer_available_nsamples(isrran_channel_delay_t* q)
+// Appends len samples to the delay line, zeros if in is NULL
+static void delay_line_write(isrran_channel_delay_t* q, const cf_t* in, uint32_t len)
 {
-  return isrran_ringbuffer_status(&q->rb) / sizeof(cf_t);
+  uint32_t tail = (q->line_head + q->line_count) % q->line_size;
+  uint32_t n1   = ISRRAN_MIN(len, q->line_size - tail);
+
+  if (in) {
+    isrran_vec_cf_copy(&q->line[tail], in, n1);
+    isrran_vec_cf_copy(q->line, &in[n1], len - n1);
+  } else {
+    isrran_vec_cf_zero(&q->line[tail], n1);
+    isrran_vec_cf_zero(q->line, len - n1);
+  }
+  q->line_count += len;
+}
+
+// Pops the len oldest samples from the delay line, they are discarded if out is NULL
+static void delay_line_read(isrran_channel_delay_t* q, cf_t* out, uint32_t len)
+{
+  uint32_t n1 = ISRRAN_MIN(len, q->line_size - q->line_head);
+
+  if (out) {
+    isrran_vec_cf_copy(out, &q->line[q->line_head], n1);
+    isrran_vec_cf_copy(&out[n1], q->line, len - n1);
+  }
+  q->line_head = (q->line_head + len) % q->line_size;
+  q->line_count -= len;
 }
 
 int isrran_channel_delay_init(isrran_channel_delay_t* q,
@@ -65,12 +89,13 @@ int isrran_channel_delay_init(isrran_channel_delay_t* q,
   // Calculate buffer size
   uint32_t buff_size = (uint32_t)ceilf(delay_max_us * (float)srate_max_hz / 1e6f);
 
-  // Create ring buffer
-  int ret = isrran_ringbuffer_init(&q->rb, sizeof(cf_t) * buff_size);
-
-  // Create zero buffer
-  q->zero_buffer = isrran_vec_cf_malloc(buff_size);
-  if (!q->zero_buffer) {
+  // Create delay line
+  int ret       = ISRRAN_SUCCESS;
+  q->line_size  = ISRRAN_MAX(buff_size, 1);
+  q->line_head  = 0;
+  q->line_count = 0;
+  q->line       = isrran_vec_cf_malloc(q->line_size);
+  if (!q->line) {
     ret = ISRRAN_ERROR;
   }
 
@@ -87,17 +112,17 @@ int isrran_channel_delay_init(isrran_channel_delay_t* q,
 
 void isrran_channel_delay_update_srate(isrran_channel_delay_t* q, uint32_t srate_hz)
 {
-  isrran_ringbuffer_reset(&q->rb);
-  q->srate_hz = srate_hz;
+  q->line_head  = 0;
+  q->line_count = 0;
+  q->srate_hz   = srate_hz;
 }
 
 void isrran_channel_delay_free(isrran_channel_delay_t* q)
 {
-  isrran_ringbuffer_free(&q->rb);
-
-  if (q->zero_buffer) {
-    free(q->zero_buffer);
+  if (q->line) {
+    free(q->line);
   }
+  q->line = NULL;
 }
 
 void isrran_channel_delay_execute(isrran_channel_delay_t*   q,
@@ -107,21 +132,19 @@ void isrran_channel_delay_execute(isrran_channel_delay_t*   q,
                                   const isrran_timestamp_t* ts)
 {
   q->delay_us                 = calculate_delay_us(q, ts);
-  q->delay_nsamples           = calculate_delay_nsamples(q);
-  uint32_t available_nsamples = ringbuffer_available_nsamples(q);
+  q->delay_nsamples           = ISRRAN_MIN(calculate_delay_nsamples(q), q->line_size);
+  uint32_t available_nsamples = q->line_count;
   uint32_t read_nsamples      = ISRRAN_MIN(q->delay_nsamples, len);
   uint32_t copy_nsamples      = (len > read_nsamples) ? (len - read_nsamples) : 0;
 
   if (available_nsamples < q->delay_nsamples) {
-    uint32_t nzeros = q->delay_nsamples - available_nsamples;
-    isrran_vec_cf_zero(q->zero_buffer, nzeros);
-    isrran_ringbuffer_write(&q->rb, q->zero_buffer, sizeof(cf_t) * nzeros);
+    delay_line_write(q, NULL, q->delay_nsamples - available_nsamples);
   } else if (available_nsamples > q->delay_nsamples) {
-    isrran_ringbuffer_read(&q->rb, q->zero_buffer, sizeof(cf_t) * (available_nsamples - q->delay_nsamples));
+    delay_line_read(q, NULL, available_nsamples - q->delay_nsamples);
   }
 
   // Read buffered samples
-  isrran_ringbuffer_read(&q->rb, out, sizeof(cf_t) * read_nsamples);
+  delay_line_read(q, out, read_nsamples);
 
   // Read other samples
   if (copy_nsamples) {
@@ -129,5 +152,5 @@ void isrran_channel_delay_execute(isrran_channel_delay_t*   q,
   }
 
   // Write new sampels
-  isrran_ringbuffer_write(&q->rb, (void*)&in[copy_nsamples], sizeof(cf_t) * read_nsamples);
+  delay_line_write(q, &in[copy_nsamples], read_nsamples);
 }
@@ -21,6 +21,7 @@
 
 #include "isrran/phy/channel/fading.h"
 #include "isrran/phy/utils/random.h"
+#include "isrran/phy/utils/simd.h"
 #include "isrran/phy/utils/vector.h"
 #include <math.h>
 #include <stdio.h>
@@ -160,28 +161,56 @@ static inline void generate_tap(float delay_ns, float power_db, float srate, cf_
   cf_t  a0        = amplitude / N;
 
   isrran_vec_gen_sine(a0, -O, buf, N);
+
+  // Store the response FFT-shifted, so the taps can be added without reordering
+  for (uint32_t i = 0; i < N / 2; i++) {
+    cf_t tmp       = buf[i];
+    buf[i]         = buf[i + N / 2];
+    buf[i + N / 2] = tmp;
+  }
 }
 
-static inline void generate_taps(isrran_channel_fading_t* q, float time)
+// Adds all the tap frequency responses, weighted by their doppler dispersion, in a single pass over h_freq
+static inline void sum_taps(isrran_channel_fading_t* q, const cf_t* a)
 {
-  // Generate taps
-  for (int i = 0; i < nof_taps[q->model]; i++) {
-    // Compute phase for the doppler dispersion
-    cf_t a = get_doppler_dispersion(q, time, q->doppler, q->coeff_alpha[i], q->coeff_a[i], q->coeff_b[i]);
+  uint32_t ntaps = nof_taps[q->model];
+  uint32_t i     = 0;
 
-    if (i) {
-      // Copy tap frequency response
-      isrran_vec_sc_prod_ccc(q->h_tap[i], a, q->temp, q->N);
+#if ISRRAN_SIMD_CF_SIZE
+  simd_cf_t a_simd[ISRRAN_CHANNEL_FADING_MAXTAPS];
+  for (uint32_t t = 0; t < ntaps; t++) {
+    a_simd[t] = isrran_simd_cf_set1(a[t]);
+  }
 
-      // Add to frequency response, shifts FFT at same time
-      isrran_vec_sum_ccc(q->h_freq, &q->temp[q->N / 2], q->h_freq, q->N / 2);
-      isrran_vec_sum_ccc(&q->h_freq[q->N / 2], q->temp, &q->h_freq[q->N / 2], q->N / 2);
-    } else {
-      // Copy tap frequency response
-      isrran_vec_sc_prod_ccc(&q->h_tap[i][q->N / 2], a, q->h_freq, q->N / 2);
-      isrran_vec_sc_prod_ccc(&q->h_tap[i][0], a, &q->h_freq[q->N / 2], q->N / 2);
+  for (; i + ISRRAN_SIMD_CF_SIZE <= q->N; i += ISRRAN_SIMD_CF_SIZE) {
+    simd_cf_t acc = isrran_simd_cf_prod(isrran_simd_cfi_load(&q->h_tap[0][i]), a_simd[0]);
+    for (uint32_t t = 1; t < ntaps; t++) {
+      acc = isrran_simd_cf_add(acc, isrran_simd_cf_prod(isrran_simd_cfi_load(&q->h_tap[t][i]), a_simd[t]));
+    }
+    isrran_simd_cfi_store(&q->h_freq[i], acc);
+  }
+#endif /* ISRRAN_SIMD_CF_SIZE */
+
+  for (; i < q->N; i++) {
+    cf_t acc = 0;
+    for (uint32_t t = 0; t < ntaps; t++) {
+      acc += a[t] * q->h_tap[t][i];
     }
+    q->h_freq[i] = acc;
   }
+}
+
+static inline void generate_taps(isrran_channel_fading_t* q, float time)
+{
+  cf_t a[ISRRAN_CHANNEL_FADING_MAXTAPS];
+
+  // Compute phase for the doppler dispersion of every tap
+  for (int i = 0; i < nof_taps[q->model]; i++) {
+    a[i] = get_doppler_dispersion(q, time, q->doppler, q->coeff_alpha[i], q->coeff_a[i], q->coeff_b[i]);
+  }
+
+  // Add tap frequency responses
+  sum_taps(q, a);
   // at this stage, q->h_freq should contain the frequency response
 }
 
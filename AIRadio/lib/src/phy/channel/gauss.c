@@ -19,19 +19,132 @@
  *
  */
 
+#include "gauss.h"
 #include <math.h>
+#include <pthread.h>
 #include <stdlib.h>
 
-float rand_gauss(void)
+/*
+ * Ziggurat method for normal variates, G. Marsaglia and W. W. Tsang, "The Ziggurat Method for Generating Random
+ * Variables", Journal of Statistical Software, 2000. Most samples cost a random integer, a table lookup and a multiply.
+ */
+#define GAUSS_ZIG_LAYERS 128
+#define GAUSS_ZIG_R 3.442619855899
+
+static uint32_t       gauss_kn[GAUSS_ZIG_LAYERS];
+static float          gauss_wn[GAUSS_ZIG_LAYERS];
+static float          gauss_fn[GAUSS_ZIG_LAYERS];
+static pthread_once_t gauss_tables_once = PTHREAD_ONCE_INIT;
+
+static void gauss_tables_init(void)
+{
+  const double m1 = 2147483648.0;
+  const double vn = 9.91256303526217e-3;
+  double       dn = GAUSS_ZIG_R;
+  double       tn = dn;
+  double       q  = vn / exp(-0.5 * dn * dn);
+
+  gauss_kn[0] = (uint32_t)((dn / q) * m1);
+  gauss_kn[1] = 0;
+
+  gauss_wn[0]                    = (float)(q / m1);
+  gauss_wn[GAUSS_ZIG_LAYERS - 1] = (float)(dn / m1);
+
+  gauss_fn[0]                    = 1.0f;
+  gauss_fn[GAUSS_ZIG_LAYERS - 1] = (float)exp(-0.5 * dn * dn);
+
+  for (int i = GAUSS_ZIG_LAYERS - 2; i >= 1; i--) {
+    dn              = sqrt(-2.0 * log(vn / dn + exp(-0.5 * dn * dn)));
+    gauss_kn[i + 1] = (uint32_t)((dn / tn) * m1);
+    tn              = dn;
+    gauss_fn[i]     = (float)exp(-0.5 * dn * dn);
+    gauss_wn[i]     = (float)(dn / m1);
+  }
+}
+
+// xorshift64* generator, returns the upper half of the product which has the best statistical quality
+static inline uint32_t gauss_rand32(uint64_t* state)
+{
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+  return (uint32_t)((x * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+// Uniform value in (0, 1)
+static inline float gauss_uni(uint64_t* state)
+{
+  return 0.5f + (float)(int32_t)gauss_rand32(state) * 0.2328306e-9f;
+}
+
+static inline uint32_t gauss_abs(int32_t hz)
+{
+  return (hz < 0) ? (uint32_t)0 - (uint32_t)hz : (uint32_t)hz;
+}
+
+// Slow path for the samples falling outside the rectangular part of a layer
+static float gauss_nfix(uint64_t* state, int32_t hz, uint32_t iz)
+{
+  const float r = (float)GAUSS_ZIG_R;
+
+  for (;;) {
+    float x = (float)hz * gauss_wn[iz];
+
+    // Tail of the distribution
+    if (iz == 0) {
+      float y;
+      do {
+        x = -logf(gauss_uni(state)) * (1.0f / r);
+        y = -logf(gauss_uni(state));
+      } while (y + y < x * x);
+      return (hz > 0) ? r + x : -r - x;
+    }
+
+    // Wedge between layers
+    if (gauss_fn[iz] + gauss_uni(state) * (gauss_fn[iz - 1] - gauss_fn[iz]) < expf(-0.5f * x * x)) {
+      return x;
+    }
+
+    hz = (int32_t)gauss_rand32(state);
+    iz = (uint32_t)hz & (GAUSS_ZIG_LAYERS - 1);
+    if (gauss_abs(hz) < gauss_kn[iz]) {
+      return (float)hz * gauss_wn[iz];
+    }
+  }
+}
+
+void rand_gauss_fill(uint64_t* state, float* out, uint32_t len)
 {
-  float v1, v2, s;
+  pthread_once(&gauss_tables_once, gauss_tables_init);
 
-  do {
-    v1 = 2.0 * (rand() / (float)RAND_MAX) - 1;
-    v2 = 2.0 * (rand() / (float)RAND_MAX) - 1;
+  for (uint32_t i = 0; i < len; i++) {
+    int32_t  hz = (int32_t)gauss_rand32(state);
+    uint32_t iz = (uint32_t)hz & (GAUSS_ZIG_LAYERS - 1);
+    out[i]      = (gauss_abs(hz) < gauss_kn[iz]) ? (float)hz * gauss_wn[iz] : gauss_nfix(state, hz, iz);
+  }
+}
 
-    s = v1 * v1 + v2 * v2;
-  } while (s >= 1.0 || s == 0.0);
+// Every thread keeps its own generator, seeded from rand() so srand() still makes runs reproducible
+static __thread uint64_t gauss_thread_state = 0;
 
-  return (v1 * sqrtf(-2.0 * log(s) / s));
+static inline uint64_t* gauss_get_thread_state(void)
+{
+  while (gauss_thread_state == 0) {
+    gauss_thread_state = ((uint64_t)rand() << 32) | (uint64_t)rand();
+  }
+  return &gauss_thread_state;
+}
+
+void rand_gauss_vec(float* out, uint32_t len)
+{
+  rand_gauss_fill(gauss_get_thread_state(), out, len);
+}
+
+float rand_gauss(void)
+{
+  float ret;
+  rand_gauss_fill(gauss_get_thread_state(), &ret, 1);
+  return ret;
 }
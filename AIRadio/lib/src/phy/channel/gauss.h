@@ -19,4 +19,13 @@
  *
  */
 
+#include <stdint.h>
+
 float rand_gauss(void);
+
+// Same as rand_gauss() for a block of samples
+void rand_gauss_vec(float* out, uint32_t len);
+
+/* Fills out with len zero-mean unit-variance Gaussian samples using the Ziggurat method. The caller owns the state,
+ * which must be non-zero, so independent generators can run concurrently. */
+void rand_gauss_fill(uint64_t* state, float* out, uint32_t len);
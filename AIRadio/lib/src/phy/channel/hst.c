@@ -48,11 +48,7 @@ void isrran_channel_hst_update_srate(isrran_channel_hst_t* q, uint32_t srate)
   }
 }
 
-void isrran_channel_hst_execute(isrran_channel_hst_t*     q,
-                                cf_t*                     in,
-                                cf_t*                     out,
-                                uint32_t                  len,
-                                const isrran_timestamp_t* ts)
+void isrran_channel_hst_update(isrran_channel_hst_t* q, const isrran_timestamp_t* ts)
 {
   if (q && q->srate_hz) {
     // Convert period from seconds to samples
@@ -79,12 +75,27 @@ void isrran_channel_hst_execute(isrran_channel_hst_t*     q,
 
     // Calculate doppler shift
     q->fs_hz = q->fd_hz * costheta;
+  }
+}
 
+void isrran_channel_hst_apply(const isrran_channel_hst_t* q, const cf_t* in, cf_t* out, uint32_t len)
+{
+  if (q && q->srate_hz) {
     // Apply doppler shift, assume the doppler does not vary in a sub-frame
     isrran_vec_apply_cfo(in, -q->fs_hz / q->srate_hz, out, len);
   }
 }
 
+void isrran_channel_hst_execute(isrran_channel_hst_t*     q,
+                                cf_t*                     in,
+                                cf_t*                     out,
+                                uint32_t                  len,
+                                const isrran_timestamp_t* ts)
+{
+  isrran_channel_hst_update(q, ts);
+  isrran_channel_hst_apply(q, in, out, len);
+}
+
 void isrran_channel_hst_free(isrran_channel_hst_t* q)
 {
   if (q) {
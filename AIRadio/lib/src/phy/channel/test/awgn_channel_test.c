@@ -261,6 +261,33 @@ int main(int argc, char** argv)
     n0 += n0_step;
   }
 
+  // Check the Gaussian generator used by isrran_ch_awgn_c
+  {
+    struct timeval t[3] = {};
+    gettimeofday(&t[1], NULL);
+    isrran_ch_awgn_c(input_buffer, output_buffer, 1.0f, nof_samples);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+
+    float power_dB = isrran_convert_power_to_dB(isrran_vec_avg_power_cf(output_buffer, nof_samples));
+    if (fabsf(power_dB) > tolerance) {
+      printf("-- failed: isrran_ch_awgn_c power %.3f dB\n", power_dB);
+      ret = ISRRAN_ERROR;
+    }
+
+    float a2 = anderson((float*)output_buffer, nof_samples, help_buffer);
+    if ((nof_samples > 100 && a2 > 1) || !isfinite(a2)) {
+      printf("-- failed: isrran_ch_awgn_c A2 = %f > 1: not Gaussian\n", a2);
+      ret = ISRRAN_ERROR;
+    }
+
+    double elapsed_us = t[0].tv_usec + t[0].tv_sec * 1000000.0;
+    printf("isrran_ch_awgn_c: power=%.3f dB; A2=%.3f; %.1f MSps\n",
+           power_dB,
+           a2,
+           isnormal(elapsed_us) ? nof_samples / elapsed_us : 0.0);
+  }
+
   // Print result and exit
   double msps = 0;
   if (count_us) {
@@ -0,0 +1,191 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/common/test_common.h"
+#include "isrran/common/thread_pool.h"
+#include "isrran/phy/channel/channel.h"
+#include "isrran/phy/utils/random.h"
+#include "isrran/phy/utils/vector.h"
+#include <chrono>
+#include <unistd.h>
+#include <vector>
+
+static uint32_t    nof_instances = 8;
+static uint32_t    nof_ports     = 2;
+static uint32_t    nof_threads   = 4;
+static uint32_t    nof_sf        = 200;
+static uint32_t    srate_hz      = 1920000;
+static std::string fading_model  = "epa5";
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [iptnsm]\n", prog);
+  printf("\t-i Number of channel instances [Default %d]\n", nof_instances);
+  printf("\t-p Number of RF channels per instance [Default %d]\n", nof_ports);
+  printf("\t-t Number of worker threads [Default %d]\n", nof_threads);
+  printf("\t-n Number of subframes [Default %d]\n", nof_sf);
+  printf("\t-s Sampling rate in Hz [Default %d]\n", srate_hz);
+  printf("\t-m Fading model [Default %s]\n", fading_model.c_str());
+}
+
+static int parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "iptnsm")) != -1) {
+    switch (opt) {
+      case 'i':
+        nof_instances = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'p':
+        nof_ports = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 't':
+        nof_threads = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'n':
+        nof_sf = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 's':
+        srate_hz = (uint32_t)strtof(argv[optind], nullptr);
+        break;
+      case 'm':
+        fading_model = argv[optind];
+        break;
+      default:
+        usage(argv[0]);
+        return ISRRAN_ERROR;
+    }
+  }
+  return ISRRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  if (parse_args(argc, argv) < ISRRAN_SUCCESS) {
+    return ISRRAN_ERROR;
+  }
+  TESTASSERT(nof_ports > 0 && nof_ports <= ISRRAN_MAX_CHANNELS);
+
+  isrlog::basic_logger& logger = isrlog::fetch_basic_logger("CHAN", false);
+  logger.set_level(isrlog::basic_levels::warning);
+  isrlog::init();
+
+  isrran::channel::args_t args;
+  args.enable        = true;
+  args.awgn_enable   = true;
+  args.awgn_snr_dB   = 20.0f;
+  args.fading_enable = true;
+  args.fading_model  = fading_model;
+  args.delay_enable  = true;
+  args.hst_enable    = true;
+
+  // Two identical sets of instances, one processed sequentially and the other in batches
+  std::vector<std::unique_ptr<isrran::channel> > serial, batch;
+  for (uint32_t n = 0; n < nof_instances; n++) {
+    serial.emplace_back(new isrran::channel(args, nof_ports, logger));
+    batch.emplace_back(new isrran::channel(args, nof_ports, logger));
+    serial.back()->set_srate(srate_hz);
+    batch.back()->set_srate(srate_hz);
+  }
+
+  uint32_t                         sf_len = srate_hz / 1000;
+  std::vector<std::vector<cf_t*> > in(nof_instances), out_serial(nof_instances), out_batch(nof_instances);
+  for (uint32_t n = 0; n < nof_instances; n++) {
+    for (uint32_t p = 0; p < nof_ports; p++) {
+      in[n].push_back(isrran_vec_cf_malloc(sf_len));
+      out_serial[n].push_back(isrran_vec_cf_malloc(sf_len));
+      out_batch[n].push_back(isrran_vec_cf_malloc(sf_len));
+      TESTASSERT(in[n][p] != nullptr && out_serial[n][p] != nullptr && out_batch[n][p] != nullptr);
+    }
+  }
+
+  isrran::task_thread_pool pool(nof_threads);
+
+  isrran_random_t                            random     = isrran_random_init(0x1234);
+  isrran_timestamp_t                         ts         = {};
+  std::chrono::nanoseconds                   serial_dur = {}, batch_dur = {};
+  std::vector<isrran::channel::batch_item_t> items(nof_instances);
+
+  for (uint32_t sf = 0; sf < nof_sf; sf++) {
+    for (uint32_t n = 0; n < nof_instances; n++) {
+      for (uint32_t p = 0; p < nof_ports; p++) {
+        isrran_random_uniform_complex_dist_vector(random, in[n][p], sf_len, -1.0f, +1.0f);
+      }
+    }
+
+    // Sequential processing
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < nof_instances; n++) {
+      serial[n]->run(in[n].data(), out_serial[n].data(), sf_len, ts);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    // All instances and RF channels at once
+    for (uint32_t n = 0; n < nof_instances; n++) {
+      items[n].ch  = batch[n].get();
+      items[n].len = sf_len;
+      items[n].t   = ts;
+      for (uint32_t p = 0; p < nof_ports; p++) {
+        items[n].in[p]  = in[n][p];
+        items[n].out[p] = out_batch[n][p];
+      }
+    }
+    isrran::channel::run_batch(pool, items.data(), nof_instances);
+    auto t2 = std::chrono::steady_clock::now();
+
+    serial_dur += t1 - t0;
+    batch_dur += t2 - t1;
+
+    // Every channel instance has its own state, so the result must not depend on the processing order
+    for (uint32_t n = 0; n < nof_instances; n++) {
+      for (uint32_t p = 0; p < nof_ports; p++) {
+        TESTASSERT(memcmp(out_serial[n][p], out_batch[n][p], sizeof(cf_t) * sf_len) == 0);
+      }
+    }
+
+    isrran_timestamp_add(&ts, 0, 0.001);
+  }
+
+  pool.stop();
+
+  double nof_samples = (double)nof_sf * nof_instances * nof_ports * sf_len;
+  double serial_us   = std::chrono::duration_cast<std::chrono::microseconds>(serial_dur).count();
+  double batch_us    = std::chrono::duration_cast<std::chrono::microseconds>(batch_dur).count();
+  printf("Test instances=%d; ports=%d; threads=%d; model=%s; srate_hz=%d; serial %.1f MSps; batch %.1f MSps\n",
+         nof_instances,
+         nof_ports,
+         nof_threads,
+         fading_model.c_str(),
+         srate_hz,
+         serial_us > 0 ? nof_samples / serial_us : 0.0,
+         batch_us > 0 ? nof_samples / batch_us : 0.0);
+
+  for (uint32_t n = 0; n < nof_instances; n++) {
+    for (uint32_t p = 0; p < nof_ports; p++) {
+      free(in[n][p]);
+      free(out_serial[n][p]);
+      free(out_batch[n][p]);
+    }
+  }
+  isrran_random_free(random);
+
+  return ISRRAN_SUCCESS;
+}
@@ -281,3 +281,97 @@ int isrran_enb_ul_get_pusch(isrran_enb_ul_t*    q,
 
   return isrran_pusch_decode(&q->pusch, ul_sf, cfg, &q->chest_res, q->sf_symbols, res);
 }
+
+int isrran_enb_ul_pusch_init(isrran_enb_ul_pusch_t* q, uint32_t max_prb)
+{
+  int ret = ISRRAN_ERROR_INVALID_INPUTS;
+
+  if (q != NULL) {
+    ret = ISRRAN_ERROR;
+
+    bzero(q, sizeof(isrran_enb_ul_pusch_t));
+
+    q->chest_res.ce = isrran_vec_cf_malloc(ISRRAN_SF_LEN_RE(max_prb, ISRRAN_CP_NORM));
+    if (!q->chest_res.ce) {
+      perror("malloc");
+      goto clean_exit;
+    }
+
+    if (isrran_pusch_init_enb(&q->pusch, max_prb)) {
+      ERROR("Error creating PUSCH object");
+      goto clean_exit;
+    }
+
+    if (isrran_chest_ul_init(&q->chest, max_prb)) {
+      ERROR("Error initiating channel estimator");
+      goto clean_exit;
+    }
+
+    ret = ISRRAN_SUCCESS;
+  } else {
+    ERROR("Invalid parameters");
+  }
+
+clean_exit:
+  if (ret == ISRRAN_ERROR) {
+    isrran_enb_ul_pusch_free(q);
+  }
+  return ret;
+}
+
+void isrran_enb_ul_pusch_free(isrran_enb_ul_pusch_t* q)
+{
+  if (q) {
+    isrran_pusch_free(&q->pusch);
+    isrran_chest_ul_free(&q->chest);
+
+    if (q->chest_res.ce) {
+      free(q->chest_res.ce);
+    }
+    bzero(q, sizeof(isrran_enb_ul_pusch_t));
+  }
+}
+
+int isrran_enb_ul_pusch_set_cell(isrran_enb_ul_pusch_t*             q,
+                                 isrran_enb_ul_t*                   enb_ul,
+                                 isrran_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
+                                 isrran_refsignal_isr_cfg_t*        isr_cfg)
+{
+  if (q == NULL || enb_ul == NULL || !isrran_cell_isvalid(&enb_ul->cell)) {
+    return ISRRAN_ERROR_INVALID_INPUTS;
+  }
+
+  q->enb_ul = enb_ul;
+
+  if (isrran_pusch_set_cell(&q->pusch, enb_ul->cell)) {
+    ERROR("Error creating PUSCH object");
+    return ISRRAN_ERROR;
+  }
+
+  if (isrran_chest_ul_set_cell(&q->chest, enb_ul->cell)) {
+    ERROR("Error initiating channel estimator");
+    return ISRRAN_ERROR;
+  }
+
+  isrran_chest_ul_pregen(&q->chest, pusch_cfg, isr_cfg);
+
+  // Inherit the LLR representation of the main decoder
+  q->pusch.llr_is_8bit        = enb_ul->pusch.llr_is_8bit;
+  q->pusch.ul_sch.llr_is_8bit = enb_ul->pusch.ul_sch.llr_is_8bit;
+
+  return ISRRAN_SUCCESS;
+}
+
+int isrran_enb_ul_pusch_decode(isrran_enb_ul_pusch_t* q,
+                               isrran_ul_sf_cfg_t*    ul_sf,
+                               isrran_pusch_cfg_t*    cfg,
+                               isrran_pusch_res_t*    res)
+{
+  if (q == NULL || q->enb_ul == NULL) {
+    return ISRRAN_ERROR_INVALID_INPUTS;
+  }
+
+  isrran_chest_ul_estimate_pusch(&q->chest, ul_sf, cfg, q->enb_ul->sf_symbols, &q->chest_res);
+
+  return isrran_pusch_decode(&q->pusch, ul_sf, cfg, &q->chest_res, q->enb_ul->sf_symbols, res);
+}
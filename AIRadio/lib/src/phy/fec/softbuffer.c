@@ -19,6 +19,7 @@
  *
  */
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -29,6 +30,9 @@
 #include "isrran/phy/fec/softbuffer.h"
 #include "isrran/phy/fec/turbo/turbodecoder_gen.h"
 #include "isrran/phy/phch/ra.h"
+#include "isrran/phy/utils/debug.h"
+#include "isrran/phy/utils/hugepage.h"
+#include "isrran/phy/utils/simd.h"
 #include "isrran/phy/utils/vector.h"
 
 #define MAX_PDSCH_RE(cp) (2 * ISRRAN_CP_NSYMB(cp) * 12)
@@ -47,11 +51,251 @@ int isrran_softbuffer_rx_init(isrran_softbuffer_rx_t* q, uint32_t nof_prb)
 }
 
 int isrran_softbuffer_rx_init_guru(isrran_softbuffer_rx_t* q, uint32_t max_cb, uint32_t max_cb_size)
+{
+  isrran_softbuffer_rx_args_t args = {};
+  args.max_cb                      = max_cb;
+  args.max_cb_size                 = max_cb_size;
+
+  return isrran_softbuffer_rx_init_args(q, &args);
+}
+
+/*
+ * Code block buffers of the on-demand soft-buffers. They are shared by all the soft-buffers, with a free list per
+ * buffer size. Each buffer holds the soft bits of a code block followed by its decoded data.
+ *
+ * Each thread keeps its own cache of free buffers per size, so that attaching and releasing code blocks does not lock.
+ * The caches are refilled from and spilled to the shared lists SOFTBUFFER_POOL_BATCH buffers at a time, and flushed to
+ * the shared lists when their thread exits.
+ */
+#define SOFTBUFFER_POOL_NOF_SIZES 8
+#define SOFTBUFFER_POOL_BATCH 16
+
+typedef struct {
+  uint32_t block_size;
+  uint32_t nof_free;
+  void*    free_list;
+} softbuffer_pool_list_t;
+
+typedef struct {
+  softbuffer_pool_list_t lists[SOFTBUFFER_POOL_NOF_SIZES]; // Same index as the shared list of each size
+} softbuffer_pool_cache_t;
+
+static pthread_mutex_t                  softbuffer_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static softbuffer_pool_list_t           softbuffer_pool_lists[SOFTBUFFER_POOL_NOF_SIZES];
+static isrran_softbuffer_pool_stats_t   softbuffer_pool_stats;
+static __thread softbuffer_pool_cache_t softbuffer_pool_cache;
+static pthread_key_t                    softbuffer_pool_key;
+static pthread_once_t                   softbuffer_pool_once = PTHREAD_ONCE_INIT;
+
+static uint32_t softbuffer_rx_llr_size(uint32_t max_cb_size, bool llr_8bit)
+{
+  uint32_t size = llr_8bit ? max_cb_size : (uint32_t)sizeof(int16_t) * max_cb_size;
+
+  // Keeps the decoded data aligned when it follows the soft bits
+  return ISRRAN_CEIL(size, ISRRAN_SIMD_BIT_ALIGN) * ISRRAN_SIMD_BIT_ALIGN;
+}
+
+static uint32_t softbuffer_rx_block_size(uint32_t max_cb_size, bool llr_8bit)
+{
+  return softbuffer_rx_llr_size(max_cb_size, llr_8bit) + max_cb_size / 8;
+}
+
+// Must be called with the pool mutex locked
+static softbuffer_pool_list_t* softbuffer_pool_find(uint32_t block_size)
+{
+  for (uint32_t i = 0; i < SOFTBUFFER_POOL_NOF_SIZES; i++) {
+    if (softbuffer_pool_lists[i].block_size == 0) {
+      softbuffer_pool_lists[i].block_size = block_size;
+    }
+    if (softbuffer_pool_lists[i].block_size == block_size) {
+      return &softbuffer_pool_lists[i];
+    }
+  }
+  ERROR("Error soft-buffer pool is limited to %d buffer sizes, buffers of %d bytes can not be allocated",
+        SOFTBUFFER_POOL_NOF_SIZES,
+        block_size);
+  return NULL;
+}
+
+// Moves up to nof_blocks free buffers from one list to another
+static void softbuffer_pool_move(softbuffer_pool_list_t* from, softbuffer_pool_list_t* to, uint32_t nof_blocks)
+{
+  for (uint32_t i = 0; i < nof_blocks && from->free_list != NULL; i++) {
+    void* block     = from->free_list;
+    from->free_list = *(void**)block;
+    *(void**)block  = to->free_list;
+    to->free_list   = block;
+    from->nof_free--;
+    to->nof_free++;
+  }
+}
+
+// Returns the free buffers cached by an exiting thread to the shared lists
+static void softbuffer_pool_cache_flush(void* arg)
+{
+  softbuffer_pool_cache_t* cache = (softbuffer_pool_cache_t*)arg;
+
+  pthread_mutex_lock(&softbuffer_pool_mutex);
+  for (uint32_t i = 0; i < SOFTBUFFER_POOL_NOF_SIZES; i++) {
+    softbuffer_pool_move(&cache->lists[i], &softbuffer_pool_lists[i], cache->lists[i].nof_free);
+  }
+  pthread_mutex_unlock(&softbuffer_pool_mutex);
+}
+
+static void softbuffer_pool_key_init(void)
+{
+  pthread_key_create(&softbuffer_pool_key, softbuffer_pool_cache_flush);
+}
+
+// Returns the cache of the calling thread for a buffer size, or NULL if the pool does not support more sizes
+static softbuffer_pool_list_t* softbuffer_pool_cache_find(uint32_t block_size)
+{
+  for (uint32_t i = 0; i < SOFTBUFFER_POOL_NOF_SIZES; i++) {
+    if (softbuffer_pool_cache.lists[i].block_size == block_size) {
+      return &softbuffer_pool_cache.lists[i];
+    }
+  }
+
+  // First buffer of this size in the thread
+  pthread_once(&softbuffer_pool_once, softbuffer_pool_key_init);
+  pthread_setspecific(softbuffer_pool_key, &softbuffer_pool_cache);
+
+  pthread_mutex_lock(&softbuffer_pool_mutex);
+  softbuffer_pool_list_t* list = softbuffer_pool_find(block_size);
+  pthread_mutex_unlock(&softbuffer_pool_mutex);
+  if (list == NULL) {
+    return NULL;
+  }
+
+  softbuffer_pool_list_t* cache = &softbuffer_pool_cache.lists[list - softbuffer_pool_lists];
+  cache->block_size             = block_size;
+  return cache;
+}
+
+static void softbuffer_pool_count_used(void)
+{
+  uint32_t used = __atomic_add_fetch(&softbuffer_pool_stats.nof_used, 1, __ATOMIC_RELAXED);
+  uint32_t peak = __atomic_load_n(&softbuffer_pool_stats.peak_used, __ATOMIC_RELAXED);
+  while (used > peak &&
+         !__atomic_compare_exchange_n(
+             &softbuffer_pool_stats.peak_used, &peak, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+static void softbuffer_pool_count_allocated(uint32_t block_size)
+{
+  __atomic_add_fetch(&softbuffer_pool_stats.nof_blocks, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&softbuffer_pool_stats.nof_bytes, block_size, __ATOMIC_RELAXED);
+}
+
+static void* softbuffer_pool_alloc(uint32_t block_size)
+{
+  softbuffer_pool_list_t* cache = softbuffer_pool_cache_find(block_size);
+  if (cache == NULL) {
+    return NULL;
+  }
+
+  if (cache->free_list == NULL) {
+    pthread_mutex_lock(&softbuffer_pool_mutex);
+    softbuffer_pool_move(&softbuffer_pool_lists[cache - softbuffer_pool_cache.lists], cache, SOFTBUFFER_POOL_BATCH);
+    pthread_mutex_unlock(&softbuffer_pool_mutex);
+  }
+
+  void* block = cache->free_list;
+  if (block != NULL) {
+    cache->free_list = *(void**)block;
+    cache->nof_free--;
+  } else {
+    block = isrran_hugepage_malloc(block_size);
+    if (block == NULL) {
+      return NULL;
+    }
+    softbuffer_pool_count_allocated(block_size);
+  }
+  softbuffer_pool_count_used();
+
+  return block;
+}
+
+static void softbuffer_pool_release(void* block, uint32_t block_size)
+{
+  // The size was registered when the buffer was allocated
+  softbuffer_pool_list_t* cache = softbuffer_pool_cache_find(block_size);
+  *(void**)block                = cache->free_list;
+  cache->free_list              = block;
+  cache->nof_free++;
+
+  if (cache->nof_free > 2 * SOFTBUFFER_POOL_BATCH) {
+    pthread_mutex_lock(&softbuffer_pool_mutex);
+    softbuffer_pool_move(cache, &softbuffer_pool_lists[cache - softbuffer_pool_cache.lists], SOFTBUFFER_POOL_BATCH);
+    pthread_mutex_unlock(&softbuffer_pool_mutex);
+  }
+  __atomic_sub_fetch(&softbuffer_pool_stats.nof_used, 1, __ATOMIC_RELAXED);
+}
+
+int isrran_softbuffer_pool_reserve(uint32_t max_cb_size, bool llr_8bit, uint32_t nof_cb)
+{
+  uint32_t block_size = softbuffer_rx_block_size(max_cb_size, llr_8bit);
+  int      ret        = ISRRAN_SUCCESS;
+
+  pthread_mutex_lock(&softbuffer_pool_mutex);
+  softbuffer_pool_list_t* list = softbuffer_pool_find(block_size);
+  for (uint32_t i = 0; i < nof_cb; i++) {
+    void* block = (list != NULL) ? isrran_hugepage_malloc(block_size) : NULL;
+    if (block == NULL) {
+      ret = ISRRAN_ERROR;
+      break;
+    }
+    *(void**)block  = list->free_list;
+    list->free_list = block;
+    list->nof_free++;
+    softbuffer_pool_count_allocated(block_size);
+  }
+  pthread_mutex_unlock(&softbuffer_pool_mutex);
+
+  return ret;
+}
+
+void isrran_softbuffer_pool_get_stats(isrran_softbuffer_pool_stats_t* stats)
+{
+  if (stats == NULL) {
+    return;
+  }
+  stats->nof_blocks = __atomic_load_n(&softbuffer_pool_stats.nof_blocks, __ATOMIC_RELAXED);
+  stats->nof_used   = __atomic_load_n(&softbuffer_pool_stats.nof_used, __ATOMIC_RELAXED);
+  stats->peak_used  = __atomic_load_n(&softbuffer_pool_stats.peak_used, __ATOMIC_RELAXED);
+  stats->nof_bytes  = __atomic_load_n(&softbuffer_pool_stats.nof_bytes, __ATOMIC_RELAXED);
+}
+
+// Attaches pool buffers to the first nof_cb code blocks of an on-demand soft-buffer and releases the others
+static void softbuffer_rx_attach(isrran_softbuffer_rx_t* q, uint32_t nof_cb)
+{
+  uint32_t llr_size   = softbuffer_rx_llr_size(q->max_cb_size, q->llr_8bit);
+  uint32_t block_size = softbuffer_rx_block_size(q->max_cb_size, q->llr_8bit);
+
+  for (uint32_t i = 0; i < q->max_cb; i++) {
+    if (i < nof_cb && q->buffer_f[i] == NULL) {
+      uint8_t* block = softbuffer_pool_alloc(block_size);
+      if (block == NULL) {
+        ERROR("Error allocating soft-buffer code block %d", i);
+        return;
+      }
+      q->buffer_f[i] = (int16_t*)block;
+      q->data[i]     = block + llr_size;
+    } else if (i >= nof_cb && q->buffer_f[i] != NULL) {
+      softbuffer_pool_release(q->buffer_f[i], block_size);
+      q->buffer_f[i] = NULL;
+      q->data[i]     = NULL;
+    }
+  }
+}
+
+int isrran_softbuffer_rx_init_args(isrran_softbuffer_rx_t* q, const isrran_softbuffer_rx_args_t* args)
 {
   int ret = ISRRAN_ERROR;
 
-  // Protect pointer
-  if (!q) {
+  // Protect pointers
+  if (!q || !args) {
     return ISRRAN_ERROR_INVALID_INPUTS;
   }
 
@@ -59,8 +303,10 @@ int isrran_softbuffer_rx_init_guru(isrran_softbuffer_rx_t* q, uint32_t max_cb, u
   ISRRAN_MEM_ZERO(q, isrran_softbuffer_rx_t, 1);
 
   // Set internal attributes
-  q->max_cb      = max_cb;
-  q->max_cb_size = max_cb_size;
+  q->max_cb      = args->max_cb;
+  q->max_cb_size = args->max_cb_size;
+  q->llr_8bit    = args->llr_8bit;
+  q->on_demand   = args->on_demand;
 
   q->buffer_f = ISRRAN_MEM_ALLOC(int16_t*, q->max_cb);
   if (!q->buffer_f) {
@@ -82,14 +328,15 @@ int isrran_softbuffer_rx_init_guru(isrran_softbuffer_rx_t* q, uint32_t max_cb, u
     goto clean_exit;
   }
 
-  for (uint32_t i = 0; i < q->max_cb; i++) {
-    q->buffer_f[i] = isrran_vec_i16_malloc(q->max_cb_size);
+  // On-demand soft-buffers take their code block buffers from the pool when they are reset for a transport block
+  for (uint32_t i = 0; i < q->max_cb && !q->on_demand; i++) {
+    q->buffer_f[i] = isrran_hugepage_malloc(softbuffer_rx_llr_size(q->max_cb_size, q->llr_8bit));
     if (!q->buffer_f[i]) {
       perror("malloc");
       goto clean_exit;
     }
 
-    q->data[i] = isrran_vec_u8_malloc(q->max_cb_size / 8);
+    q->data[i] = isrran_hugepage_malloc(q->max_cb_size / 8);
     if (!q->data[i]) {
       perror("malloc");
       goto clean_exit;
@@ -112,10 +359,13 @@ clean_exit:
 void isrran_softbuffer_rx_free(isrran_softbuffer_rx_t* q)
 {
   if (q) {
+    if (q->buffer_f && q->on_demand) {
+      softbuffer_rx_attach(q, 0);
+    }
     if (q->buffer_f) {
       for (uint32_t i = 0; i < q->max_cb; i++) {
         if (q->buffer_f[i]) {
-          free(q->buffer_f[i]);
+          isrran_hugepage_free(q->buffer_f[i]);
         }
       }
       free(q->buffer_f);
@@ -123,7 +373,7 @@ void isrran_softbuffer_rx_free(isrran_softbuffer_rx_t* q)
     if (q->data) {
       for (uint32_t i = 0; i < q->max_cb; i++) {
         if (q->data[i]) {
-          free(q->data[i]);
+          isrran_hugepage_free(q->data[i]);
         }
       }
       free(q->data);
@@ -144,7 +394,8 @@ void isrran_softbuffer_rx_reset_tbs(isrran_softbuffer_rx_t* q, uint32_t tbs)
 
 void isrran_softbuffer_rx_reset(isrran_softbuffer_rx_t* q)
 {
-  isrran_softbuffer_rx_reset_cb(q, q->max_cb);
+  // On-demand soft-buffers return all their code block buffers to the pool
+  isrran_softbuffer_rx_reset_cb(q, q->on_demand ? 0 : q->max_cb);
 }
 
 void isrran_softbuffer_rx_reset_cb(isrran_softbuffer_rx_t* q, uint32_t nof_cb)
@@ -153,9 +404,16 @@ void isrran_softbuffer_rx_reset_cb(isrran_softbuffer_rx_t* q, uint32_t nof_cb)
     if (nof_cb > q->max_cb) {
       nof_cb = q->max_cb;
     }
+    if (q->on_demand) {
+      softbuffer_rx_attach(q, nof_cb);
+    }
     for (uint32_t i = 0; i < nof_cb; i++) {
       if (q->buffer_f[i]) {
-        isrran_vec_i16_zero(q->buffer_f[i], q->max_cb_size);
+        if (q->llr_8bit) {
+          isrran_vec_i8_zero((int8_t*)q->buffer_f[i], q->max_cb_size);
+        } else {
+          isrran_vec_i16_zero(q->buffer_f[i], q->max_cb_size);
+        }
       }
       if (q->data[i]) {
         isrran_vec_u8_zero(q->data[i], q->max_cb_size / 8);
@@ -212,7 +470,7 @@ int isrran_softbuffer_tx_init_guru(isrran_softbuffer_tx_t* q, uint32_t max_cb, u
 
   // TODO: Use HARQ buffer limitation based on UE category
   for (uint32_t i = 0; i < q->max_cb; i++) {
-    q->buffer_b[i] = isrran_vec_u8_malloc(q->max_cb_size);
+    q->buffer_b[i] = isrran_hugepage_malloc(q->max_cb_size);
     if (!q->buffer_b[i]) {
       perror("malloc");
       return ISRRAN_ERROR;
@@ -230,7 +488,7 @@ void isrran_softbuffer_tx_free(isrran_softbuffer_tx_t* q)
     if (q->buffer_b) {
       for (uint32_t i = 0; i < q->max_cb; i++) {
         if (q->buffer_b[i]) {
-          free(q->buffer_b[i]);
+          isrran_hugepage_free(q->buffer_b[i]);
         }
       }
       free(q->buffer_b);
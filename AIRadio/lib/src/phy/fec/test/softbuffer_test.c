@@ -0,0 +1,364 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/isrran.h"
+#include "isrran/phy/utils/simd.h"
+#include "isrran/support/isrran_test.h"
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static uint32_t nof_tb  = 100;
+static float    snr_db  = 0.0f;
+static uint32_t mcs_idx = 9;
+static uint32_t nof_prb = 50;
+
+static const uint32_t rv_sequence[4] = {0, 2, 3, 1};
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nsmp]\n", prog);
+  printf("\t-n number of transport blocks [Default %d]\n", nof_tb);
+  printf("\t-s SNR in dB of each transmission [Default %.1f]\n", snr_db);
+  printf("\t-m MCS index [Default %d]\n", mcs_idx);
+  printf("\t-p number of PRB [Default %d]\n", nof_prb);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nsmp")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_tb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'm':
+        mcs_idx = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static int test_pool()
+{
+  isrran_softbuffer_pool_stats_t stats0, stats;
+  isrran_softbuffer_pool_get_stats(&stats0);
+
+  isrran_softbuffer_rx_args_t args = {};
+  args.max_cb                      = 4;
+  args.max_cb_size                 = SOFTBUFFER_SIZE;
+  args.llr_8bit                    = true;
+  args.on_demand                   = true;
+
+  // On-demand soft-buffers hold no code block until they are reset for a transport block
+  isrran_softbuffer_rx_t q1 = {}, q2 = {};
+  TESTASSERT(isrran_softbuffer_rx_init_args(&q1, &args) == ISRRAN_SUCCESS);
+  TESTASSERT(isrran_softbuffer_rx_init_args(&q2, &args) == ISRRAN_SUCCESS);
+  for (uint32_t i = 0; i < args.max_cb; i++) {
+    TESTASSERT(q1.buffer_f[i] == NULL && q1.data[i] == NULL);
+  }
+  isrran_softbuffer_pool_get_stats(&stats);
+  TESTASSERT(stats.nof_used == stats0.nof_used && stats.nof_blocks == stats0.nof_blocks);
+
+  // A TBS of 3 code blocks attaches 3 buffers
+  isrran_softbuffer_rx_reset_tbs(&q1, 15000);
+  for (uint32_t i = 0; i < 3; i++) {
+    TESTASSERT(q1.buffer_f[i] != NULL && ISRRAN_IS_ALIGNED(q1.buffer_f[i]) && ISRRAN_IS_ALIGNED(q1.data[i]));
+    TESTASSERT(q1.data[i] >= (uint8_t*)q1.buffer_f[i] + SOFTBUFFER_SIZE);
+  }
+  TESTASSERT(q1.buffer_f[3] == NULL);
+  isrran_softbuffer_pool_get_stats(&stats);
+  TESTASSERT(stats.nof_used == stats0.nof_used + 3 && stats.peak_used >= stats.nof_used);
+
+  // A smaller TBS releases the extra buffers, a reset releases them all
+  isrran_softbuffer_rx_reset_tbs(&q1, 1000);
+  TESTASSERT(q1.buffer_f[0] != NULL && q1.buffer_f[1] == NULL);
+  isrran_softbuffer_rx_reset(&q1);
+  TESTASSERT(q1.buffer_f[0] == NULL);
+  isrran_softbuffer_pool_get_stats(&stats);
+  TESTASSERT(stats.nof_used == stats0.nof_used);
+
+  // The released buffers are reused by other soft-buffers
+  uint32_t nof_blocks = stats.nof_blocks;
+  isrran_softbuffer_rx_reset_cb(&q2, 3);
+  isrran_softbuffer_pool_get_stats(&stats);
+  TESTASSERT(stats.nof_blocks == nof_blocks && stats.nof_used == stats0.nof_used + 3);
+
+  // Reserved buffers are used by soft-buffers of the same size and soft bit width
+  TESTASSERT(isrran_softbuffer_pool_reserve(SOFTBUFFER_SIZE, false, 2) == ISRRAN_SUCCESS);
+  isrran_softbuffer_pool_get_stats(&stats);
+  TESTASSERT(stats.nof_blocks == nof_blocks + 2);
+  args.llr_8bit = false;
+  isrran_softbuffer_rx_t q3 = {};
+  TESTASSERT(isrran_softbuffer_rx_init_args(&q3, &args) == ISRRAN_SUCCESS);
+  isrran_softbuffer_rx_reset_cb(&q3, 2);
+  isrran_softbuffer_pool_get_stats(&stats);
+  TESTASSERT(stats.nof_blocks == nof_blocks + 2 && stats.nof_used == stats0.nof_used + 5);
+
+  isrran_softbuffer_rx_free(&q1);
+  isrran_softbuffer_rx_free(&q2);
+  isrran_softbuffer_rx_free(&q3);
+  isrran_softbuffer_pool_get_stats(&stats);
+  TESTASSERT(stats.nof_used == stats0.nof_used);
+
+  return ISRRAN_SUCCESS;
+}
+
+// Attaches the code blocks of an on-demand soft-buffer and releases them, from a thread of its own
+static void* pool_thread(void* arg)
+{
+  isrran_softbuffer_rx_args_t args = {};
+  args.max_cb                      = 4;
+  args.max_cb_size                 = SOFTBUFFER_SIZE / 2;
+  args.llr_8bit                    = true;
+  args.on_demand                   = true;
+
+  isrran_softbuffer_rx_t q = {};
+  if (isrran_softbuffer_rx_init_args(&q, &args) == ISRRAN_SUCCESS) {
+    isrran_softbuffer_rx_reset_cb(&q, 3);
+    *(bool*)arg = q.buffer_f[2] != NULL;
+  }
+  isrran_softbuffer_rx_free(&q);
+  return NULL;
+}
+
+static int test_pool_threads()
+{
+  isrran_softbuffer_pool_stats_t stats0, stats;
+  isrran_softbuffer_pool_get_stats(&stats0);
+
+  // The buffers cached by a thread are returned to the shared pool when it exits, and reused by the next thread
+  for (uint32_t i = 0; i < 2; i++) {
+    pthread_t thread;
+    bool      attached = false;
+    TESTASSERT(pthread_create(&thread, NULL, pool_thread, &attached) == 0);
+    TESTASSERT(pthread_join(thread, NULL) == 0);
+    TESTASSERT(attached);
+    isrran_softbuffer_pool_get_stats(&stats);
+    TESTASSERT(stats.nof_blocks == stats0.nof_blocks + 3 && stats.nof_used == stats0.nof_used);
+  }
+
+  return ISRRAN_SUCCESS;
+}
+
+static int test_saturation()
+{
+  // Combining a strong soft bit several times must not flip its sign
+  uint32_t cb_idx  = isrran_cbsegm_cbindex(6144);
+  uint32_t out_len = 3 * 6144 + 12;
+  int8_t*  input   = isrran_vec_i8_malloc(out_len);
+  int8_t*  output  = isrran_vec_i8_malloc(SOFTBUFFER_SIZE);
+  TESTASSERT(input != NULL && output != NULL);
+
+  isrran_rm_turbo_gentables();
+  uint32_t nof_wrong = 0;
+  for (int8_t x = -100; x <= 100; x += 200) {
+    for (uint32_t i = 0; i < out_len; i++) {
+      input[i] = x;
+    }
+    isrran_vec_i8_zero(output, out_len);
+    for (uint32_t rv = 0; rv < 4; rv++) {
+      TESTASSERT(isrran_rm_turbo_rx_lut_8bit(input, output, out_len, cb_idx, rv) == ISRRAN_SUCCESS);
+    }
+    for (uint32_t i = 0; i < out_len; i++) {
+      nof_wrong += (output[i] * x < 0) ? 1 : 0;
+    }
+  }
+  TESTASSERT(nof_wrong == 0);
+
+  free(input);
+  free(output);
+  return ISRRAN_SUCCESS;
+}
+
+typedef struct {
+  uint32_t nof_errors;   // Transport blocks not decoded after all the transmissions
+  uint32_t nof_tx;       // Transmissions of all the transport blocks
+  uint64_t memory_bytes; // Soft-buffer memory while a transport block is being received
+} harq_result_t;
+
+// Transmits nof_tb transport blocks with HARQ over PDSCH and AWGN, storing the soft bits with 8 or 16 bits
+static int run_harq(bool llr_8bit, harq_result_t* result)
+{
+  isrran_cell_t cell   = {};
+  cell.nof_prb         = nof_prb;
+  cell.nof_ports       = 1;
+  cell.cp              = ISRRAN_CP_NORM;
+  cell.phich_length    = ISRRAN_PHICH_NORM;
+  cell.phich_resources = ISRRAN_PHICH_R_1_6;
+
+  isrran_dl_sf_cfg_t dl_sf = {};
+  dl_sf.tti                = 1;
+  dl_sf.cfi                = 1;
+
+  // A single transport block over all the PRB, the second one is disabled
+  isrran_dci_dl_t dci         = {};
+  dci.format                  = ISRRAN_DCI_FORMAT1A;
+  dci.rnti                    = 1234;
+  dci.type0_alloc.rbg_bitmask = 0xffffffff;
+  dci.tb[0].mcs_idx           = mcs_idx;
+  dci.tb[1].mcs_idx           = 0;
+  dci.tb[1].rv                = 1;
+
+  isrran_pdsch_cfg_t cfg = {};
+  TESTASSERT(isrran_ra_dl_dci_to_grant(&cell, &dl_sf, ISRRAN_TM1, false, &dci, &cfg.grant) == ISRRAN_SUCCESS);
+  cfg.rnti     = dci.rnti;
+  uint32_t tbs = (uint32_t)cfg.grant.tb[0].tbs;
+
+  isrran_pdsch_t pdsch_tx = {}, pdsch_rx = {};
+  TESTASSERT(isrran_pdsch_init_enb(&pdsch_tx, nof_prb) == ISRRAN_SUCCESS);
+  TESTASSERT(isrran_pdsch_set_cell(&pdsch_tx, cell) == ISRRAN_SUCCESS);
+  TESTASSERT(isrran_pdsch_init_ue(&pdsch_rx, nof_prb, 1) == ISRRAN_SUCCESS);
+  TESTASSERT(isrran_pdsch_set_cell(&pdsch_rx, cell) == ISRRAN_SUCCESS);
+  pdsch_rx.llr_is_8bit        = llr_8bit;
+  pdsch_rx.dl_sch.llr_is_8bit = llr_8bit;
+
+  isrran_chest_dl_res_t chest_res = {};
+  TESTASSERT(isrran_chest_dl_res_init(&chest_res, nof_prb) == ISRRAN_SUCCESS);
+  isrran_chest_dl_res_set_identity(&chest_res);
+
+  // The 16-bit soft-buffer is allocated for the largest TBS of the cell, as in the eNB
+  isrran_softbuffer_tx_t      tx   = {};
+  isrran_softbuffer_rx_t      rx   = {};
+  isrran_softbuffer_rx_args_t args = {};
+  args.max_cb_size                 = SOFTBUFFER_SIZE;
+  args.llr_8bit                    = true;
+  args.on_demand                   = true;
+  TESTASSERT(isrran_softbuffer_tx_init(&tx, nof_prb) == ISRRAN_SUCCESS);
+  if (llr_8bit) {
+    args.max_cb = tx.max_cb;
+    TESTASSERT(isrran_softbuffer_rx_init_args(&rx, &args) == ISRRAN_SUCCESS);
+  } else {
+    TESTASSERT(isrran_softbuffer_rx_init(&rx, nof_prb) == ISRRAN_SUCCESS);
+  }
+
+  isrran_channel_awgn_t awgn;
+  TESTASSERT(isrran_channel_awgn_init(&awgn, 1234) == ISRRAN_SUCCESS);
+  TESTASSERT(isrran_channel_awgn_set_n0(&awgn, -snr_db) == ISRRAN_SUCCESS);
+
+  uint32_t           nof_re                          = ISRRAN_NOF_RE(cell);
+  cf_t*              tx_symbols[ISRRAN_MAX_PORTS]    = {};
+  cf_t*              rx_symbols[ISRRAN_MAX_PORTS]    = {};
+  uint8_t*           data_tx[ISRRAN_MAX_CODEWORDS]   = {};
+  isrran_pdsch_res_t pdsch_res[ISRRAN_MAX_CODEWORDS] = {};
+  tx_symbols[0]                                      = isrran_vec_cf_malloc(nof_re);
+  rx_symbols[0]                                      = isrran_vec_cf_malloc(nof_re);
+  data_tx[0]                                         = isrran_vec_u8_malloc(tbs / 8 + 4); // The TB CRC is appended
+  pdsch_res[0].payload                               = isrran_vec_u8_malloc(tbs / 8 + 4);
+  TESTASSERT(tx_symbols[0] && rx_symbols[0] && data_tx[0] && pdsch_res[0].payload);
+
+  isrran_softbuffer_pool_stats_t stats0, stats;
+  isrran_softbuffer_pool_get_stats(&stats0);
+
+  ISRRAN_MEM_ZERO(result, harq_result_t, 1);
+  srand(0);
+  for (uint32_t n = 0; n < nof_tb; n++) {
+    for (uint32_t i = 0; i < tbs / 8; i++) {
+      data_tx[0][i] = (uint8_t)(rand() & 0xff);
+    }
+    isrran_softbuffer_tx_reset_tbs(&tx, tbs);
+    isrran_softbuffer_rx_reset_tbs(&rx, tbs);
+    if (n == 0) {
+      isrran_softbuffer_pool_get_stats(&stats);
+      result->memory_bytes = llr_8bit ? stats.nof_bytes - stats0.nof_bytes
+                                      : (uint64_t)rx.max_cb * (2 * SOFTBUFFER_SIZE + SOFTBUFFER_SIZE / 8);
+    }
+
+    pdsch_res[0].crc = false;
+    for (uint32_t tx_nb = 0; tx_nb < 4 && !pdsch_res[0].crc; tx_nb++) {
+      cfg.grant.tb[0].rv = rv_sequence[tx_nb];
+      isrran_vec_cf_zero(tx_symbols[0], nof_re);
+      // The transmit and receive soft-buffers are in a union
+      cfg.softbuffers.tx[0] = &tx;
+      TESTASSERT(isrran_pdsch_encode(&pdsch_tx, &dl_sf, &cfg, data_tx, tx_symbols) == ISRRAN_SUCCESS);
+      isrran_channel_awgn_run_c(&awgn, tx_symbols[0], rx_symbols[0], nof_re);
+      cfg.softbuffers.rx[0] = &rx;
+      TESTASSERT(isrran_pdsch_decode(&pdsch_rx, &dl_sf, &cfg, &chest_res, rx_symbols, pdsch_res) == ISRRAN_SUCCESS);
+      result->nof_tx++;
+    }
+    if (pdsch_res[0].crc) {
+      TESTASSERT(memcmp(data_tx[0], pdsch_res[0].payload, tbs / 8) == 0);
+    } else {
+      result->nof_errors++;
+    }
+  }
+
+  free(tx_symbols[0]);
+  free(rx_symbols[0]);
+  free(data_tx[0]);
+  free(pdsch_res[0].payload);
+  isrran_channel_awgn_free(&awgn);
+  isrran_softbuffer_tx_free(&tx);
+  isrran_softbuffer_rx_free(&rx);
+  isrran_chest_dl_res_free(&chest_res);
+  isrran_pdsch_free(&pdsch_tx);
+  isrran_pdsch_free(&pdsch_rx);
+  return ISRRAN_SUCCESS;
+}
+
+static int test_memory_vs_bler()
+{
+  harq_result_t res16, res8;
+  TESTASSERT(run_harq(false, &res16) == ISRRAN_SUCCESS);
+  TESTASSERT(run_harq(true, &res8) == ISRRAN_SUCCESS);
+
+  printf("       memory(B)  tx/TB  residual BLER\n");
+  printf("16-bit %9" PRIu64 "  %5.2f  %5.3f\n",
+         res16.memory_bytes,
+         (float)res16.nof_tx / nof_tb,
+         (float)res16.nof_errors / nof_tb);
+  printf(" 8-bit %9" PRIu64 "  %5.2f  %5.3f\n",
+         res8.memory_bytes,
+         (float)res8.nof_tx / nof_tb,
+         (float)res8.nof_errors / nof_tb);
+
+  // The on-demand 8-bit storage takes less than half the memory with a similar number of transmissions
+  TESTASSERT(res8.memory_bytes * 2 < res16.memory_bytes);
+  TESTASSERT(res8.nof_tx <= res16.nof_tx + res16.nof_tx / 10);
+  TESTASSERT(res8.nof_errors <= res16.nof_errors + nof_tb / 20);
+
+  return ISRRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  // The pool blocks are counted by the HARQ test before other tests leave free blocks in the pool
+  TESTASSERT(test_memory_vs_bler() == ISRRAN_SUCCESS);
+  TESTASSERT(test_pool() == ISRRAN_SUCCESS);
+  TESTASSERT(test_pool_threads() == ISRRAN_SUCCESS);
+  TESTASSERT(test_saturation() == ISRRAN_SUCCESS);
+
+  printf("Ok\n");
+  return ISRRAN_SUCCESS;
+}
@@ -67,6 +67,13 @@ int isrran_rm_turbo_rx_lut_avx_8bit(int8_t*   input,
 #define NCOLS 32
 #define NROWS_MAX NCOLS
 
+/* Combines an 8-bit soft bit with saturation, so that the retransmissions of a strong bit do not flip its sign */
+static inline void rm_turbo_sat_add_8bit(int8_t* output, int8_t x)
+{
+  int16_t sum = (int16_t)*output + x;
+  *output     = (int8_t)(sum > INT8_MAX ? INT8_MAX : (sum < -INT8_MAX ? -INT8_MAX : sum));
+}
+
 static uint8_t RM_PERM_TC[NCOLS] = {0, 16, 8, 24, 4, 20, 12, 28, 2, 18, 10, 26, 6, 22, 14, 30,
                                     1, 17, 9, 25, 5, 21, 13, 29, 3, 19, 11, 27, 7, 23, 15, 31};
 
@@ -472,7 +479,7 @@ int isrran_rm_turbo_rx_lut_8bit(int8_t* input, int8_t* output, uint32_t in_len,
     uint32_t  out_len = 3 * isrran_cbsegm_cbsize(cb_idx) + 12;
 
     for (int i = 0; i < in_len; i++) {
-      output[deinter[i % out_len]] += input[i];
+      rm_turbo_sat_add_8bit(&output[deinter[i % out_len]], input[i]);
     }
     return 0;
 #endif
@@ -576,12 +583,12 @@ int isrran_rm_turbo_rx_lut_sse(int16_t*  input,
 #define SAVE_OUTPUT_SSE_8(j)                                                                                           \
   x = (int8_t)_mm_extract_epi8(xVal, j);                                                                               \
   l = (uint16_t)_mm_extract_epi16(lutVal1, j);                                                                         \
-  output[l] += x;
+  rm_turbo_sat_add_8bit(&output[l], x);
 
 #define SAVE_OUTPUT_SSE_8_2(j)                                                                                         \
   x = (int8_t)_mm_extract_epi8(xVal, j + 8);                                                                           \
   l = (uint16_t)_mm_extract_epi16(lutVal2, j);                                                                         \
-  output[l] += x;
+  rm_turbo_sat_add_8bit(&output[l], x);
 
 int isrran_rm_turbo_rx_lut_sse_8bit(int8_t*   input,
                                     int8_t*   output,
@@ -629,7 +636,7 @@ int isrran_rm_turbo_rx_lut_sse_8bit(int8_t*   input,
         SAVE_OUTPUT_SSE_8_2(7);
       }
       for (int i = 16 * (in_len / 16); i < in_len; i++) {
-        output[deinter[i % out_len]] += input[i];
+        rm_turbo_sat_add_8bit(&output[deinter[i % out_len]], input[i]);
       }
     } else {
       int intCnt   = 16;
@@ -667,12 +674,12 @@ int isrran_rm_turbo_rx_lut_sse_8bit(int8_t*   input,
           /* Copy last elements */
           if ((out_len % 16) == 12) {
             for (int j = (nwrapps + 1) * out_len - 12; j < (nwrapps + 1) * out_len; j++) {
-              output[deinter[j % out_len]] += input[j];
+              rm_turbo_sat_add_8bit(&output[deinter[j % out_len]], input[j]);
               inputCnt++;
             }
           } else {
             for (int j = (nwrapps + 1) * out_len - 4; j < (nwrapps + 1) * out_len; j++) {
-              output[deinter[j % out_len]] += input[j];
+              rm_turbo_sat_add_8bit(&output[deinter[j % out_len]], input[j]);
               inputCnt++;
             }
           }
@@ -684,7 +691,7 @@ int isrran_rm_turbo_rx_lut_sse_8bit(int8_t*   input,
         }
       }
       for (int i = inputCnt; i < in_len; i++) {
-        output[deinter[i % out_len]] += input[i];
+        rm_turbo_sat_add_8bit(&output[deinter[i % out_len]], input[i]);
       }
     }
 
@@ -813,12 +820,12 @@ int isrran_rm_turbo_rx_lut_avx(int16_t*  input,
 #define SAVE_OUTPUT8(j)                                                                                                \
   x = (int8_t)_mm256_extract_epi8(xVal, j);                                                                            \
   l = (uint16_t)_mm256_extract_epi16(lutVal1, j);                                                                      \
-  output[l] += x;
+  rm_turbo_sat_add_8bit(&output[l], x);
 
 #define SAVE_OUTPUT8_2(j)                                                                                              \
   x = (int8_t)_mm256_extract_epi8(xVal, j + 8);                                                                        \
   l = (uint16_t)_mm256_extract_epi16(lutVal2, j);                                                                      \
-  output[l] += x;
+  rm_turbo_sat_add_8bit(&output[l], x);
 
 int isrran_rm_turbo_rx_lut_avx_8bit(int8_t*   input,
                                     int8_t*   output,
@@ -884,7 +891,7 @@ int isrran_rm_turbo_rx_lut_avx_8bit(int8_t*   input,
         SAVE_OUTPUT8_2(15);
       }
       for (int i = 32 * (in_len / 32); i < in_len; i++) {
-        output[deinter[i % out_len]] += input[i];
+        rm_turbo_sat_add_8bit(&output[deinter[i % out_len]], input[i]);
       }
     } else {
       printf("wraps not implemented!\n");
@@ -942,7 +949,7 @@ int isrran_rm_turbo_rx_lut_avx_8bit(int8_t*   input,
           printf("warning rate matching wrapping remainder %d\n", out_len % 32);
           /* Copy last elements */
           for (int j = (nwrapps + 1) * out_len - (out_len % 32); j < (nwrapps + 1) * out_len; j++) {
-            output[deinter[j % out_len]] += input[j];
+            rm_turbo_sat_add_8bit(&output[deinter[j % out_len]], input[j]);
             inputCnt++;
           }
           /* And wrap pointers */
@@ -953,7 +960,7 @@ int isrran_rm_turbo_rx_lut_avx_8bit(int8_t*   input,
         }
       }
       for (int i = inputCnt; i < in_len; i++) {
-        output[deinter[i % out_len]] += input[i];
+        rm_turbo_sat_add_8bit(&output[deinter[i % out_len]], input[i]);
       }
 #endif
     }
@@ -390,6 +390,12 @@ bool decode_tb_cb(isrran_sch_t*           q,
   for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
     /* Do not process blocks with CRC Ok */
     if (softbuffer->cb_crc[cb_idx] == false) {
+      // On-demand soft buffers only hold the code blocks they were reset for
+      if (softbuffer->buffer_f[cb_idx] == NULL) {
+        ERROR("Error soft buffer has no memory for CB#%d", cb_idx);
+        return false;
+      }
+
       uint32_t cb_len     = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
       uint32_t cb_len_idx = cb_idx < cb_segm->C1 ? cb_segm->K1_idx : cb_segm->K2_idx;
 
@@ -544,6 +550,11 @@ static int decode_tb(isrran_sch_t*           q,
     return ISRRAN_ERROR_INVALID_INPUTS;
   }
 
+  if (softbuffer->llr_8bit && !q->llr_is_8bit) {
+    ERROR("Error soft buffer with 8-bit soft bits requires the 8-bit decoder");
+    return ISRRAN_ERROR_INVALID_INPUTS;
+  }
+
   // Process Codeblocks
   bool cb_crc_ok = decode_tb_cb(q, softbuffer, cb_segm, Qm, rv, nof_e_bits, e_bits, data);
 
@@ -611,11 +611,7 @@ static int sch_nr_decode(isrran_sch_nr_t*        q,
   uint32_t j = 0;
   for (uint32_t r = 0; r < cfg.C; r++) {
     bool    decoded   = tb->softbuffer.rx->cb_crc[r];
-    int8_t* rm_buffer = (int8_t*)tb->softbuffer.tx->buffer_b[r];
-    if (!rm_buffer) {
-      ERROR("Error: soft-buffer provided NULL buffer for cb_idx=%d", r);
-      return ISRRAN_ERROR;
-    }
+    int8_t* rm_buffer = (int8_t*)tb->softbuffer.rx->buffer_f[r];
 
     // Skip CB if mask indicates no transmission of the CB
     if (!cfg.mask[r]) {
@@ -637,6 +633,13 @@ static int sch_nr_decode(isrran_sch_nr_t*        q,
       continue;
     }
 
+    // On-demand soft-buffers have no buffer for the CB if the pool was exhausted, the CB fails and so does the TB
+    if (!rm_buffer) {
+      ERROR("Error: soft-buffer provided NULL buffer for cb_idx=%d", r);
+      input_ptr += E;
+      continue;
+    }
+
     // LDPC Rate matching
     SCH_INFO_RX("RM CB %d: E=%d; F=%d; BG=%d; Z=%d; RV=%d; Qm=%d; Nref=%d;",
                 r,
@@ -30,6 +30,9 @@
 // Enable to measure execution time
 #define NOF_CE_SYMBOLS ISRRAN_NOF_RE(cell)
 
+#define HUGEPAGE_ARENA_SIZE (16 * 1024 * 1024)
+#define HUGEPAGE_HEAP_SIZE (64 * 1024 * 1024)
+
 static isrran_cell_t cell = {
     6,                  // nof_prb
     1,                  // nof_ports
@@ -56,6 +59,8 @@ static int         M                            = 1;
 static bool        enable_256qam                = false;
 static bool        use_8_bit                    = false;
 
+static isrran_hugepage_mode_t hugepage_mode = ISRRAN_HUGEPAGE_NONE;
+
 void usage(char* prog)
 {
   printf("Usage: %s [fmMbcsrtRFpnwav] \n", prog);
@@ -78,12 +83,14 @@ void usage(char* prog)
   printf("\t-j Enable PDSCH decoder coworker\n");
   printf("\t-v [set isrran_verbose to debug, default none]\n");
   printf("\t-q Enable/Disable 256QAM modulation (default %s)\n", enable_256qam ? "enabled" : "disabled");
+  printf("\t-H Huge pages for the buffers: none, thp or hugetlb [Default %s]\n",
+         isrran_hugepage_mode_string(hugepage_mode));
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "fmMcsbrtRFpnqawvXxj")) != -1) {
+  while ((opt = getopt(argc, argv, "fmMcsbrtRFpnqawvXxjH")) != -1) {
     switch (opt) {
       case 'f':
         input_file = argv[optind];
@@ -142,6 +149,12 @@ void parse_args(int argc, char** argv)
       case 'q':
         enable_256qam ^= true;
         break;
+      case 'H':
+        if (isrran_hugepage_mode_parse(argv[optind], &hugepage_mode) != ISRRAN_SUCCESS) {
+          usage(argv[0]);
+          exit(-1);
+        }
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -230,6 +243,12 @@ int main(int argc, char** argv)
 
   parse_args(argc, argv);
 
+  // Must be enabled before allocating the buffers
+  if (isrran_hugepage_init(hugepage_mode, HUGEPAGE_ARENA_SIZE, HUGEPAGE_HEAP_SIZE) != ISRRAN_SUCCESS) {
+    ERROR("Error initialising huge pages");
+    exit(-1);
+  }
+
   if (tm == ISRRAN_TM1) {
     cell.nof_ports = 1;
     mcs[1]         = 0;
@@ -491,6 +510,8 @@ int main(int argc, char** argv)
     pdsch_res[i].payload        = data_rx[i];
   }
 
+  int      dtlb_fd     = isrran_dtlb_counter_open();
+  uint64_t dtlb_misses = isrran_dtlb_counter_read(dtlb_fd);
   gettimeofday(&t[1], NULL);
   for (uint32_t k = 0; k < M; k++) {
     for (uint32_t i = 0; i < ISRRAN_MAX_CODEWORDS; i++) {
@@ -511,6 +532,16 @@ int main(int argc, char** argv)
          (float)t[0].tv_usec / M,
          (float)(pdsch_cfg.grant.tb[0].tbs + pdsch_cfg.grant.tb[1].tbs) / 1000.0f,
          (float)(pdsch_cfg.grant.tb[0].tbs + pdsch_cfg.grant.tb[1].tbs) * M / t[0].tv_usec);
+  dtlb_misses = isrran_dtlb_counter_read(dtlb_fd) - dtlb_misses;
+  if (dtlb_fd >= 0) {
+    printf("dTLB load misses per decode: %.1f\n", (float)dtlb_misses / M);
+  }
+  isrran_dtlb_counter_close(dtlb_fd);
+  if (hugepage_mode != ISRRAN_HUGEPAGE_NONE) {
+    char hugepage_str[256];
+    isrran_hugepage_stats_info(hugepage_str, sizeof(hugepage_str));
+    printf("%s\n", hugepage_str);
+  }
 
   /* If there is an error in PDSCH decode */
   if (r) {
@@ -593,6 +624,7 @@ quit:
     }
   }
   isrran_random_free(random_gen);
+  isrran_hugepage_exit();
   if (ret) {
     printf("Error\n");
   } else {
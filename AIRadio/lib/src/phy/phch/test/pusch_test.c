@@ -57,6 +57,11 @@ int          riv           = -1;
 uint32_t     mcs_idx       = 0;
 bool         enable_64_qam = false;
 
+isrran_hugepage_mode_t hugepage_mode = ISRRAN_HUGEPAGE_NONE;
+
+#define HUGEPAGE_ARENA_SIZE (16 * 1024 * 1024)
+#define HUGEPAGE_HEAP_SIZE (64 * 1024 * 1024)
+
 void usage(char* prog)
 {
   printf("Usage: %s [csrnfvmtF] \n", prog);
@@ -84,6 +89,8 @@ void usage(char* prog)
   printf("\n\tOther parameters:\n");
   printf("\t\t-p enable_64qam [Default %s]\n", enable_64_qam ? "enabled" : "disabled");
   printf("\t\t-s number of subframes [Default %d]\n", subframe);
+  printf("\t\t-H huge pages for the buffers: none, thp or hugetlb [Default %s]\n",
+         isrran_hugepage_mode_string(hugepage_mode));
   printf("\t-v [set isrran_verbose to debug, default none]\n");
 }
 
@@ -139,7 +146,7 @@ void parse_extensive_param(char* param, char* arg)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "msLFrncpvf")) != -1) {
+  while ((opt = getopt(argc, argv, "msLFrncpvfH")) != -1) {
     switch (opt) {
       case 'm':
         mcs_idx = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -172,6 +179,12 @@ void parse_args(int argc, char** argv)
       case 'v':
         increase_isrran_verbose_level();
         break;
+      case 'H':
+        if (isrran_hugepage_mode_parse(argv[optind], &hugepage_mode) != ISRRAN_SUCCESS) {
+          usage(argv[0]);
+          exit(-1);
+        }
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -194,6 +207,7 @@ int main(int argc, char** argv)
   isrran_softbuffer_tx_t softbuffer_tx = {};
   isrran_softbuffer_rx_t softbuffer_rx = {};
   isrran_crc_t           crc_tb;
+  int                    dtlb_fd       = -1;
 
   ZERO_OBJECT(uci_data_tx);
   ZERO_OBJECT(crc_tb);
@@ -205,6 +219,12 @@ int main(int argc, char** argv)
 
   parse_args(argc, argv);
 
+  // Must be enabled before allocating the buffers
+  if (isrran_hugepage_init(hugepage_mode, HUGEPAGE_ARENA_SIZE, HUGEPAGE_HEAP_SIZE) != ISRRAN_SUCCESS) {
+    ERROR("Error initialising huge pages");
+    exit(-1);
+  }
+
   dci.freq_hop_fl = freq_hop;
   if (riv >= 0) {
     dci.type2_alloc.riv = (uint32_t)riv;
@@ -283,6 +303,8 @@ int main(int argc, char** argv)
   cfg.enable_64qam     = enable_64_qam;
   uint64_t decode_us   = 0;
   uint64_t decode_bits = 0;
+  uint64_t dtlb_misses = 0;
+  dtlb_fd              = isrran_dtlb_counter_open();
 
   for (int n = 0; n < subframe; n++) {
     ret = ISRRAN_SUCCESS;
@@ -328,9 +350,11 @@ int main(int argc, char** argv)
     cfg.softbuffers.rx           = &softbuffer_rx;
     memcpy(&cfg.uci_cfg, &uci_data_tx.cfg, sizeof(isrran_uci_cfg_t));
 
+    uint64_t dtlb_start = isrran_dtlb_counter_read(dtlb_fd);
     gettimeofday(&t[1], NULL);
     int r = isrran_pusch_decode(&pusch_rx, &ul_sf, &cfg, &chest_res, sf_symbols, &pusch_res);
     gettimeofday(&t[2], NULL);
+    dtlb_misses += isrran_dtlb_counter_read(dtlb_fd) - dtlb_start;
     if (r) {
       printf("Error returned while decoding\n");
       ret = ISRRAN_ERROR;
@@ -399,6 +423,14 @@ int main(int argc, char** argv)
   }
 
   printf("Decoded Rate: %f Mbps\n", (double)decode_bits / (double)decode_us);
+  if (dtlb_fd >= 0 && subframe > 0) {
+    printf("dTLB load misses per decode: %.1f\n", (double)dtlb_misses / subframe);
+  }
+  if (hugepage_mode != ISRRAN_HUGEPAGE_NONE) {
+    char hugepage_str[256];
+    isrran_hugepage_stats_info(hugepage_str, sizeof(hugepage_str));
+    printf("%s\n", hugepage_str);
+  }
 quit:
   isrran_chest_ul_res_free(&chest_res);
   isrran_pusch_free(&pusch_tx);
@@ -415,6 +447,8 @@ quit:
   if (data_rx) {
     free(data_rx);
   }
+  isrran_dtlb_counter_close(dtlb_fd);
+  isrran_hugepage_exit();
   if (ret) {
     printf("Error\n");
   } else {
@@ -21,8 +21,11 @@
 
 #include "isrran/phy/resampling/resample_arb.h"
 #include "isrran/phy/utils/debug.h"
+#include "isrran/phy/utils/simd.h"
 #include "isrran/phy/utils/vector.h"
 #include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 
 // clang-format off
@@ -101,10 +104,57 @@ float isrran_resample_arb_polyfilt[ISRRAN_RESAMPLE_ARB_N][ISRRAN_RESAMPLE_ARB_M]
 {0.000722236729272,  -0.032053439082436,   0.171322660416961,   0.704261032406613,   0.188481383863832,  -0.033395686652146,   0.000657994314549 ,  0.000002955485215}};
 
 // clang-format on
-static inline cf_t isrran_resample_arb_dot_prod(cf_t* x, float* y, int len)
+// Number of interleaved (real, imaginary) taps of a polyphase filter row
+#define RESAMPLE_ARB_TAPS_LEN (2 * ISRRAN_RESAMPLE_ARB_M)
+
+// Complex by real dot product of M samples, taps are interleaved so both components share the same multiplier
+static inline cf_t isrran_resample_arb_dot_prod(const cf_t* x, const float* taps)
+{
+  const float* xp = (const float*)x;
+#if ISRRAN_SIMD_F_SIZE
+  simd_f_t acc = isrran_simd_f_set1(0.0f);
+  for (int i = 0; i < RESAMPLE_ARB_TAPS_LEN; i += ISRRAN_SIMD_F_SIZE) {
+    acc = isrran_simd_f_add(acc, isrran_simd_f_mul(isrran_simd_f_loadu(&xp[i]), isrran_simd_f_loadu(&taps[i])));
+  }
+
+  float sum[ISRRAN_SIMD_F_SIZE] isrran_simd_aligned;
+  isrran_simd_f_store(sum, acc);
+
+  float re = 0.0f, im = 0.0f;
+  for (int i = 0; i < ISRRAN_SIMD_F_SIZE; i += 2) {
+    re += sum[i];
+    im += sum[i + 1];
+  }
+#else  /* ISRRAN_SIMD_F_SIZE */
+  float re = 0.0f, im = 0.0f;
+  for (int i = 0; i < RESAMPLE_ARB_TAPS_LEN; i += 2) {
+    re += xp[i] * taps[i];
+    im += xp[i + 1] * taps[i + 1];
+  }
+#endif /* ISRRAN_SIMD_F_SIZE */
+  return re + im * _Complex_I;
+}
+
+// Writes a polyphase filter row with every tap duplicated for the real and imaginary components
+static void isrran_resample_arb_interleave_taps(const float* row_a, const float* row_b, float frac, float* taps)
 {
-  cf_t res1 = isrran_vec_dot_prod_cfc(x, y, len);
-  return res1;
+  for (int i = 0; i < ISRRAN_RESAMPLE_ARB_M; i++) {
+    float tap       = row_a[i] + (row_b[i] - row_a[i]) * frac;
+    taps[2 * i]     = tap;
+    taps[2 * i + 1] = tap;
+  }
+}
+
+// Interleaved copy of isrran_resample_arb_polyfilt, filled once by the first initialised resampler
+static float isrran_resample_arb_polyfilt_cf[ISRRAN_RESAMPLE_ARB_N][RESAMPLE_ARB_TAPS_LEN] isrran_simd_aligned;
+static pthread_once_t isrran_resample_arb_polyfilt_once = PTHREAD_ONCE_INIT;
+
+static void isrran_resample_arb_polyfilt_cf_init(void)
+{
+  for (int i = 0; i < ISRRAN_RESAMPLE_ARB_N; i++) {
+    isrran_resample_arb_interleave_taps(
+        isrran_resample_arb_polyfilt[i], isrran_resample_arb_polyfilt[i], 0.0f, isrran_resample_arb_polyfilt_cf[i]);
+  }
 }
 
 // Right-shift our window of samples
@@ -124,11 +174,118 @@ void isrran_resample_arb_init(isrran_resample_arb_t* q, float rate, bool interpo
   q->rate        = rate;
   q->interpolate = interpolate;
   q->step        = (1 / rate) * ISRRAN_RESAMPLE_ARB_N;
+
+  pthread_once(&isrran_resample_arb_polyfilt_once, isrran_resample_arb_polyfilt_cf_init);
+
+  q->up         = 0;
+  q->down       = 0;
+  q->phase      = 0;
+  q->skip       = 0;
+  q->phase_cnt  = NULL;
+  q->phase_taps = NULL;
+}
+
+int isrran_resample_arb_init_ratio(isrran_resample_arb_t* q, uint32_t up, uint32_t down, bool interpolate)
+{
+  if (q == NULL || up == 0 || down == 0) {
+    return ISRRAN_ERROR_INVALID_INPUTS;
+  }
+
+  isrran_resample_arb_init(q, (float)up / (float)down, interpolate);
+
+  q->up         = up;
+  q->down       = down;
+  q->phase_cnt  = calloc(up, sizeof(uint32_t));
+  q->phase_taps = isrran_vec_f_malloc(up * RESAMPLE_ARB_TAPS_LEN);
+  if (q->phase_cnt == NULL || q->phase_taps == NULL) {
+    ERROR("Error allocating resampler phases");
+    isrran_resample_arb_free(q);
+    return ISRRAN_ERROR;
+  }
+
+  // Output k sits at k * N * down / up filter rows from the first one, the pattern repeats every up outputs
+  for (uint32_t k = 0; k < up; k++) {
+    uint64_t pos  = (uint64_t)k * ISRRAN_RESAMPLE_ARB_N * down;
+    uint64_t rem  = pos % ((uint64_t)ISRRAN_RESAMPLE_ARB_N * up);
+    uint32_t idx  = (uint32_t)(rem / up);
+    float    frac = interpolate ? (float)(rem % up) / (float)up : 0.0f;
+
+    q->phase_cnt[k] = (uint32_t)(pos / ((uint64_t)ISRRAN_RESAMPLE_ARB_N * up));
+    isrran_resample_arb_interleave_taps(isrran_resample_arb_polyfilt[idx],
+                                        isrran_resample_arb_polyfilt[(idx + 1) % ISRRAN_RESAMPLE_ARB_N],
+                                        frac,
+                                        &q->phase_taps[k * RESAMPLE_ARB_TAPS_LEN]);
+  }
+
+  return ISRRAN_SUCCESS;
+}
+
+void isrran_resample_arb_free(isrran_resample_arb_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+  if (q->phase_cnt) {
+    free(q->phase_cnt);
+  }
+  if (q->phase_taps) {
+    free(q->phase_taps);
+  }
+  q->phase_cnt  = NULL;
+  q->phase_taps = NULL;
+}
+
+// Resample a block of input data using the precomputed phases
+static int isrran_resample_arb_compute_ratio(isrran_resample_arb_t* q, cf_t* input, cf_t* output, int n_in)
+{
+  cf_t     window[ISRRAN_RESAMPLE_ARB_M];
+  int      n_out = 0;
+  uint32_t phase = q->phase;
+  int      base  = (int)q->skip - (int)q->phase_cnt[phase];
+  int      cnt   = (int)q->skip;
+
+  while (cnt < n_in) {
+    const cf_t* filter_input;
+    if (cnt < ISRRAN_RESAMPLE_ARB_M) {
+      // The window straddles the previous block
+      memcpy(window, &q->reg[cnt], (ISRRAN_RESAMPLE_ARB_M - cnt) * sizeof(cf_t));
+      memcpy(&window[ISRRAN_RESAMPLE_ARB_M - cnt], input, cnt * sizeof(cf_t));
+      filter_input = window;
+    } else {
+      filter_input = &input[cnt - ISRRAN_RESAMPLE_ARB_M];
+    }
+
+    output[n_out++] = isrran_resample_arb_dot_prod(filter_input, &q->phase_taps[phase * RESAMPLE_ARB_TAPS_LEN]);
+
+    phase++;
+    if (phase == q->up) {
+      phase = 0;
+      base += (int)q->down;
+    }
+    cnt = base + (int)q->phase_cnt[phase];
+  }
+
+  // Keep the last M samples for the next block
+  if (n_in >= ISRRAN_RESAMPLE_ARB_M) {
+    memcpy(q->reg, &input[n_in - ISRRAN_RESAMPLE_ARB_M], ISRRAN_RESAMPLE_ARB_M * sizeof(cf_t));
+  } else if (n_in > 0) {
+    memmove(q->reg, &q->reg[n_in], (ISRRAN_RESAMPLE_ARB_M - n_in) * sizeof(cf_t));
+    memcpy(&q->reg[ISRRAN_RESAMPLE_ARB_M - n_in], input, n_in * sizeof(cf_t));
+  }
+
+  q->phase = phase;
+  q->skip  = (uint32_t)(cnt - n_in);
+
+  return n_out;
 }
 
 // Resample a block of input data
 int isrran_resample_arb_compute(isrran_resample_arb_t* q, cf_t* input, cf_t* output, int n_in)
 {
+  if (q->phase_taps != NULL) {
+    return isrran_resample_arb_compute_ratio(q, input, output, n_in);
+  }
+
   int   cnt   = 0;
   int   n_out = 0;
   int   idx   = 0;
@@ -146,10 +303,10 @@ int isrran_resample_arb_compute(isrran_resample_arb_t* q, cf_t* input, cf_t* out
       filter_input = &input[cnt - ISRRAN_RESAMPLE_ARB_M];
     }
 
-    res1 = isrran_resample_arb_dot_prod(filter_input, isrran_resample_arb_polyfilt[idx], ISRRAN_RESAMPLE_ARB_M);
+    res1 = isrran_resample_arb_dot_prod(filter_input, isrran_resample_arb_polyfilt_cf[idx]);
     if (q->interpolate) {
-      res2 = isrran_resample_arb_dot_prod(
-          filter_input, isrran_resample_arb_polyfilt[(idx + 1) % ISRRAN_RESAMPLE_ARB_N], ISRRAN_RESAMPLE_ARB_M);
+      res2 = isrran_resample_arb_dot_prod(filter_input,
+                                          isrran_resample_arb_polyfilt_cf[(idx + 1) % ISRRAN_RESAMPLE_ARB_N]);
     }
 
     *output = (q->interpolate) ? (res1 + (res2 - res1) * frac) : res1;
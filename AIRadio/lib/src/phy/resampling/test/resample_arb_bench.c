@@ -29,31 +29,100 @@
 #include "isrran/phy/resampling/resample_arb.h"
 #include "isrran/isrran.h"
 
-#define ITERATIONS 10000
+static int      N           = 9000;
+static uint32_t up          = 24;
+static uint32_t down        = 25;
+static int      iterations  = 10000;
+static bool     interpolate = false;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [nudit]\n", prog);
+  printf("\t-n number of input samples per block [Default %d]\n", N);
+  printf("\t-u interpolation factor [Default %d]\n", up);
+  printf("\t-d decimation factor [Default %d]\n", down);
+  printf("\t-i interpolate between filter rows [Default %s]\n", interpolate ? "yes" : "no");
+  printf("\t-t number of iterations [Default %d]\n", iterations);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nudit")) != -1) {
+    switch (opt) {
+      case 'n':
+        N = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 'u':
+        up = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'd':
+        down = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'i':
+        interpolate = true;
+        break;
+      case 't':
+        iterations = (int)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Runs the resampler and prints the input and output throughput of a single core
+static void bench(const char* name, isrran_resample_arb_t* r, cf_t* in, cf_t* out)
+{
+  int     n_out = 0;
+  clock_t start = clock();
+  for (int xx = 0; xx < iterations; xx++) {
+    n_out = isrran_resample_arb_compute(r, in, out, N);
+  }
+  double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+  if (secs <= 0.0) {
+    secs = 1.0 / CLOCKS_PER_SEC;
+  }
+
+  printf("%-10s %.2f us/block, input %.2f Msps/core, output %.2f Msps/core\n",
+         name,
+         secs * 1e6 / iterations,
+         (double)N * iterations / secs / 1e6,
+         (double)n_out * iterations / secs / 1e6);
+}
+
 int main(int argc, char** argv)
 {
-  int   N    = 9000;
-  float rate = 24.0 / 25.0;
-  cf_t* in   = isrran_vec_cf_malloc(N);
-  cf_t* out  = isrran_vec_cf_malloc(N);
+  parse_args(argc, argv);
+
+  cf_t* in  = isrran_vec_cf_malloc(N);
+  cf_t* out = isrran_vec_cf_malloc(N * up / down + 2 * up);
+  if (!in || !out) {
+    perror("malloc");
+    exit(-1);
+  }
 
   for (int i = 0; i < N; i++)
     in[i] = sin(i * 2 * M_PI / 100);
 
+  printf("Resampling %d samples by %d/%d, interpolate=%s, %d iterations\n",
+         N,
+         up,
+         down,
+         interpolate ? "yes" : "no",
+         iterations);
+
   isrran_resample_arb_t r;
-  isrran_resample_arb_init(&r, rate, 0);
+  isrran_resample_arb_init(&r, (float)up / (float)down, interpolate);
+  bench("arbitrary", &r, in, out);
 
-  clock_t start = clock(), diff;
-  for (int xx = 0; xx < ITERATIONS; xx++) {
-    isrran_resample_arb_compute(&r, in, out, N);
+  if (isrran_resample_arb_init_ratio(&r, up, down, interpolate)) {
+    printf("Error initialising rational resampler\n");
+    exit(-1);
   }
-  diff = clock() - start;
-
-  diff       = diff / ITERATIONS;
-  int   msec = diff * 1000 / CLOCKS_PER_SEC;
-  float thru = (CLOCKS_PER_SEC / (float)diff) * (N / 1e6);
-  printf("Time taken %d seconds %d milliseconds\n", msec / 1000, msec % 1000);
-  printf("Rate = %f MS/sec\n", thru);
+  bench("rational", &r, in, out);
+  isrran_resample_arb_free(&r);
 
   free(in);
   free(out);
@@ -22,6 +22,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 #include <time.h>
 #include <unistd.h>
@@ -29,6 +30,22 @@
 #include "isrran/phy/resampling/resample_arb.h"
 #include "isrran/isrran.h"
 
+static void check_interp(cf_t* in, cf_t* out, int n_out, float rate, int delay)
+{
+  for (int i = delay + 1; i < n_out; i++) {
+    float idx   = i / rate;
+    int   pre   = floor(idx) - delay;
+    int   post  = ceil(idx) - delay;
+    int   round = roundf(idx) - delay;
+    float diff  = fabs(creal(in[pre]) - creal(in[post]));
+    float diff2 = fabs(creal(out[i]) - creal(in[round]));
+    if (diff2 > diff && pre != post) {
+      printf("Interpolation failed at index %f\n", idx);
+      exit(-1);
+    }
+  }
+}
+
 int main(int argc, char** argv)
 {
   int   N     = 100;  // Number of sinwave samples
@@ -57,23 +74,35 @@ int main(int argc, char** argv)
     isrran_resample_arb_t r;
     isrran_resample_arb_init(&r, rate, 0);
     int n_out = isrran_resample_arb_compute(&r, in, out, N);
+    check_interp(in, out, n_out, rate, delay);
 
-    // Check interp values
-    for (int i = delay + 1; i < n_out; i++) {
-      float idx   = i / rate;
-      int   pre   = floor(idx) - delay;
-      int   post  = ceil(idx) - delay;
-      int   round = roundf(idx) - delay;
-      float diff  = fabs(creal(in[pre]) - creal(in[post]));
-      float diff2 = fabs(creal(out[i]) - creal(in[round]));
-      if (diff2 > diff && pre != post) {
-        printf("Interpolation failed at index %f\n", idx);
-        exit(-1);
-      }
+    // Resample with the precomputed rational phases
+    if (isrran_resample_arb_init_ratio(&r, up, (uint32_t)down, false)) {
+      printf("Error initialising rational resampler\n");
+      exit(-1);
+    }
+    n_out = isrran_resample_arb_compute(&r, in, out, N);
+    check_interp(in, out, n_out, rate, delay);
+
+    // Resampling in two blocks must produce the same samples as in one
+    cf_t* out2 = isrran_vec_cf_malloc(N);
+    if (!out2) {
+      perror("malloc");
+      exit(-1);
+    }
+    isrran_resample_arb_free(&r);
+    isrran_resample_arb_init_ratio(&r, up, (uint32_t)down, false);
+    int n_out2 = isrran_resample_arb_compute(&r, in, out2, N / 3);
+    n_out2 += isrran_resample_arb_compute(&r, &in[N / 3], &out2[n_out2], N - N / 3);
+    if (n_out2 != n_out || memcmp(out, out2, n_out * sizeof(cf_t)) != 0) {
+      printf("Block resampling mismatch (%d/%d samples)\n", n_out2, n_out);
+      exit(-1);
     }
+    isrran_resample_arb_free(&r);
 
     free(in);
     free(out);
+    free(out2);
   }
 
   printf("Ok\n");
@@ -29,8 +29,17 @@
 #include <isrran/phy/utils/vector.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <time.h>
 #include <unistd.h>
 
+typedef struct {
+  uint32_t base_srate;
+  bool     rx_mmap;        // map the receive files in memory
+  uint64_t rx_offset;      // number of samples to skip at the beginning of the receive files
+  bool     rx_interleaved; // the first receive file holds all the channels interleaved
+  bool     realtime;       // pace the reception to the sampling rate instead of running as fast as possible
+} rf_file_args_t;
+
 typedef struct {
   // Common attributes
   char*            devname;
@@ -59,6 +68,12 @@ typedef struct {
   // Rx timestamp
   uint64_t next_rx_ts;
 
+  // Replay options and statistics
+  bool            rx_interleaved;
+  bool            realtime;
+  bool            rx_started;
+  struct timespec rx_start_time;
+
   pthread_mutex_t tx_config_mutex;
   pthread_mutex_t rx_config_mutex;
   pthread_mutex_t decim_mutex;
@@ -71,6 +86,12 @@ typedef struct {
 
 static void update_rates(rf_file_handler_t* handler, double srate);
 
+static int rf_file_open_file_args(void**                h,
+                                  FILE**                rx_files,
+                                  FILE**                tx_files,
+                                  uint32_t              nof_channels,
+                                  const rf_file_args_t* args);
+
 void rf_file_info(char* id, const char* format, ...)
 {
 #if VERBOSE
@@ -179,12 +200,41 @@ int rf_file_open_multi(char* args, void** h, uint32_t nof_channels)
   FILE* tx_files[ISRRAN_MAX_CHANNELS] = {NULL};
 
   if (h && nof_channels <= ISRRAN_MAX_CHANNELS) {
-    uint32_t base_srate = FILE_BASERATE_DEFAULT_HZ;
+    rf_file_args_t file_args = {};
+    file_args.base_srate     = FILE_BASERATE_DEFAULT_HZ;
+    file_args.rx_mmap        = true;
 
     // parse args
     if (args && strlen(args)) {
       // base_srate
-      parse_uint32(args, "base_srate", -1, &base_srate);
+      parse_uint32(args, "base_srate", -1, &file_args.base_srate);
+
+      // rx_mmap
+      uint32_t rx_mmap = 1;
+      parse_uint32(args, "rx_mmap", -1, &rx_mmap);
+      file_args.rx_mmap = (rx_mmap != 0);
+
+      // rx_offset, parsed as string to support offsets beyond 32 bit
+      char rx_offset[RF_PARAM_LEN] = {};
+      if (parse_string(args, "rx_offset", -1, rx_offset) == ISRRAN_SUCCESS) {
+        file_args.rx_offset = strtoull(rx_offset, NULL, 10);
+      }
+
+      // rx_interleaved
+      uint32_t rx_interleaved = 0;
+      parse_uint32(args, "rx_interleaved", -1, &rx_interleaved);
+      file_args.rx_interleaved = (rx_interleaved != 0);
+
+      // clock
+      char clock[RF_PARAM_LEN] = {};
+      if (parse_string(args, "clock", -1, clock) == ISRRAN_SUCCESS) {
+        if (strcmp(clock, "realtime") == 0) {
+          file_args.realtime = true;
+        } else if (strcmp(clock, "freerun") != 0) {
+          fprintf(stderr, "[file] Error: invalid clock '%s', valid options are 'freerun' and 'realtime'\n", clock);
+          goto clean_exit;
+        }
+      }
     } else {
       fprintf(stderr, "[file] Error: RF device args are required for file-based no-RF module\n");
       goto clean_exit;
@@ -219,7 +269,7 @@ int rf_file_open_multi(char* args, void** h, uint32_t nof_channels)
     }
 
     // defer further initialization to open_file method
-    ret = rf_file_open_file(h, rx_files, tx_files, nof_channels, base_srate);
+    ret = rf_file_open_file_args(h, rx_files, tx_files, nof_channels, &file_args);
     if (ret != ISRRAN_SUCCESS) {
       goto clean_exit;
     }
@@ -243,6 +293,17 @@ clean_exit:
 }
 
 int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_channels, uint32_t base_srate)
+{
+  rf_file_args_t args = {};
+  args.base_srate     = base_srate;
+  return rf_file_open_file_args(h, rx_files, tx_files, nof_channels, &args);
+}
+
+static int rf_file_open_file_args(void**                h,
+                                  FILE**                rx_files,
+                                  FILE**                tx_files,
+                                  uint32_t              nof_channels,
+                                  const rf_file_args_t* args)
 {
   int ret = ISRRAN_ERROR;
 
@@ -256,7 +317,9 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
     }
     memset(handler, 0, sizeof(rf_file_handler_t));
     *h                        = handler;
-    handler->base_srate       = base_srate;
+    handler->base_srate       = args->base_srate;
+    handler->rx_interleaved   = args->rx_interleaved;
+    handler->realtime         = args->realtime;
     handler->info.max_rx_gain = FILE_MAX_GAIN_DB;
     handler->info.min_rx_gain = FILE_MIN_GAIN_DB;
     handler->info.max_tx_gain = FILE_MAX_GAIN_DB;
@@ -294,11 +357,16 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
     rx_opts.sample_format = FILERF_TYPE_FC32;
     tx_opts.sample_format = FILERF_TYPE_FC32;
 
+    rx_opts.use_mmap = args->rx_mmap;
+    rx_opts.offset   = args->rx_offset * (args->rx_interleaved ? nof_channels : 1);
+
     update_rates(handler, 1.92e6);
 
     // Create channels
     for (int i = 0; i < handler->nof_channels; i++) {
-      if (rx_files != NULL && rx_files[i] != NULL) {
+      if (handler->rx_interleaved && i > 0) {
+        // all channels are received from the first file
+      } else if (rx_files != NULL && rx_files[i] != NULL) {
         rx_opts.file = rx_files[i];
         if (rf_file_rx_open(&handler->receiver[i], rx_opts) != ISRRAN_SUCCESS) {
           fprintf(stderr, "[file] Error: opening receiver\n");
@@ -320,7 +388,8 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
         handler->tx_off = true;
       }
 
-      if (!handler->transmitter[i].running && !handler->receiver[i].running) {
+      bool rx_running = handler->receiver[handler->rx_interleaved ? 0 : i].running;
+      if (!handler->transmitter[i].running && !rx_running) {
         fprintf(stderr, "[file] Error: Neither tx nor rx specificed for channel %d.\n", i);
         goto clean_exit;
       }
@@ -357,6 +426,24 @@ int rf_file_close(void* h)
 
   rf_file_info(handler->id, "Closing ...\n");
 
+  // report the achieved replay rate
+  if (handler->rx_started && handler->receiver[0].running && handler->next_rx_ts > 0) {
+    struct timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed = (double)(now.tv_sec - handler->rx_start_time.tv_sec) +
+                     (double)(now.tv_nsec - handler->rx_start_time.tv_nsec) * 1e-9;
+    if (elapsed > 0.0) {
+      double srate = (double)handler->next_rx_ts / elapsed;
+      fprintf(stdout,
+              "[file] %s received %" PRIu64 " samples in %.3f s (%.2f Msps, %.2fx real time)\n",
+              handler->id,
+              handler->next_rx_ts,
+              elapsed,
+              srate / 1e6,
+              srate / handler->base_srate);
+    }
+  }
+
   // close receiver+transmitter and release related resources (except for the file handles)
   for (int i = 0; i < handler->nof_channels; i++) {
     rf_file_tx_close(&handler->transmitter[i]);
@@ -552,6 +639,12 @@ int rf_file_recv_with_time_multi(void*    h,
   if (h) {
     rf_file_handler_t* handler = (rf_file_handler_t*)h;
 
+    // Start the replay clock with the first reception
+    if (!handler->rx_started) {
+      clock_gettime(CLOCK_MONOTONIC, &handler->rx_start_time);
+      handler->rx_started = true;
+    }
+
     // Map ports to data buffers according to the selected frequencies
     pthread_mutex_lock(&handler->rx_config_mutex);
     bool  mapped[ISRRAN_MAX_CHANNELS]  = {}; // Mapped mask, set to true when the physical channel is used
@@ -561,8 +654,15 @@ int rf_file_recv_with_time_multi(void*    h,
     for (uint32_t logical = 0; logical < handler->nof_channels; logical++) {
       bool unmatched = true;
 
+      // Interleaved files have no frequency per channel, map them in order
+      if (handler->rx_interleaved) {
+        buffers[logical] = (cf_t*)data[logical];
+        continue;
+      }
+
       // For each physical channel...
       for (uint32_t physical = 0; physical < handler->nof_channels; physical++) {
+
         // Consider a match if the physical channel is NOT mapped and the frequency match
         if (!mapped[physical] && rf_file_rx_match_freq(&handler->receiver[physical], handler->rx_freq_mhz[logical])) {
           // Not mapped and matched frequency with receiver
@@ -629,8 +729,26 @@ int rf_file_recv_with_time_multi(void*    h,
     }
 
     // copy from rx buffer as many samples as requested into provided buffer
-    bool    completed                  = false;
+    bool    completed                  = handler->rx_interleaved;
     int32_t count[ISRRAN_MAX_CHANNELS] = {};
+    while (handler->rx_interleaved && count[0] < nsamples_baserate) {
+      // All channels come from the first receiver
+      cf_t* ptr[ISRRAN_MAX_CHANNELS] = {};
+      for (uint32_t i = 0; i < handler->nof_channels; i++) {
+        ptr[i] = &((decim_factor != 1 || buffers[i] == NULL) ? handler->buffer_decimation[i] : buffers[i])[count[0]];
+      }
+      int32_t n = rf_file_rx_baseband_interleaved(
+          &handler->receiver[0], ptr, handler->nof_channels, nsamples_baserate - count[0]);
+      if (n > 0) {
+        count[0] += n;
+      } else {
+        if (n != ISRRAN_ERROR_RX_EOF) {
+          fprintf(stderr, "Error: receiving data.\n");
+        }
+        ret = n;
+        goto clean_exit;
+      }
+    }
     while (!completed) {
       uint32_t completed_count = 0;
 
@@ -704,6 +822,18 @@ int rf_file_recv_with_time_multi(void*    h,
 
     // update rx time
     update_ts(handler, &handler->next_rx_ts, nsamples_baserate, "rx");
+
+    // In real time mode, wait until the received samples would have been acquired by a radio
+    if (handler->realtime) {
+      struct timespec deadline = handler->rx_start_time;
+      deadline.tv_sec += handler->next_rx_ts / handler->base_srate;
+      deadline.tv_nsec += ((handler->next_rx_ts % handler->base_srate) * 1000000000ULL) / handler->base_srate;
+      if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+      }
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+    }
   }
 
   ret = nsamples;
@@ -64,14 +64,20 @@ ISRRAN_API void rf_file_register_error_handler(void* h, isrran_rf_error_handler_
 ISRRAN_API int rf_file_open(char* args, void** h);
 
 /**
- * @brief This function is not supported for file-based RF abstraction
+ * @brief Opens the files given in the device arguments
  *
- * Use @c rf_file_open_file() to open this device
+ * Besides the rx_file/tx_file per channel and base_srate, the following arguments control the replay of captures:
+ * - rx_mmap=0|1: maps the receive files in memory with huge page sized readahead (default 1)
+ * - rx_offset=N: skips the first N samples of each receive file (per channel if interleaved)
+ * - rx_interleaved=0|1: rx_file0 holds all the channels interleaved sample by sample (default 0)
+ * - clock=freerun|realtime: receive as fast as possible, or paced to base_srate (default freerun)
  *
- * @param args not used
- * @param h not used
- * @param nof_channels not used
- * @return ISRRAN_ERROR_INVALID_COMMAND
+ * The achieved receive rate is printed when the device is closed.
+ *
+ * @param args device arguments
+ * @param h pointer to the device handler
+ * @param nof_channels number of channels
+ * @return ISRRAN_SUCCESS or ISRRAN_ERROR
  */
 ISRRAN_API int rf_file_open_multi(char* args, void** h, uint32_t nof_channels);
 
@@ -20,9 +20,66 @@
  */
 
 #include "rf_file_imp_trx.h"
+#include <isrran/phy/common/phy_common.h>
 #include <isrran/phy/utils/vector.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Requests the kernel to read ahead the samples following the read position and drops the mapping of the samples
+// already consumed, so replaying large captures does not grow the resident memory
+static void rf_file_rx_readahead(rf_file_rx_t* q)
+{
+  if (q->map_pos + FILE_READAHEAD_SIZE / 2 > q->readahead_pos && q->readahead_pos < q->map_len) {
+    size_t len = ISRRAN_MIN(FILE_READAHEAD_SIZE, q->map_len - q->readahead_pos);
+    madvise(q->map + q->readahead_pos, len, MADV_WILLNEED);
+    q->readahead_pos += len;
+  }
+
+  size_t consumed = (q->map_pos / FILE_READAHEAD_ALIGN) * FILE_READAHEAD_ALIGN;
+  if (consumed > q->released_pos + FILE_READAHEAD_SIZE) {
+    madvise(q->map + q->released_pos, consumed - q->released_pos, MADV_DONTNEED);
+    q->released_pos = consumed;
+  }
+}
+
+// Maps the file in memory and starts reading the given number of bytes after its current position, returns
+// ISRRAN_ERROR if it is not a regular file
+static int rf_file_rx_map(rf_file_rx_t* q, size_t offset)
+{
+  int         fd = fileno(q->file);
+  struct stat st = {};
+  if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+    return ISRRAN_ERROR;
+  }
+
+  off_t pos = ftello(q->file);
+  if (pos < 0 || pos >= st.st_size) {
+    return ISRRAN_ERROR;
+  }
+
+  void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED) {
+    return ISRRAN_ERROR;
+  }
+  madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+  // Only honoured by kernels supporting huge pages for read-only file mappings, ignore the result
+  madvise(map, (size_t)st.st_size, MADV_HUGEPAGE);
+#endif
+
+  // madvise() ranges must start at a page boundary, the read ahead and released positions are kept aligned
+  q->map           = (uint8_t*)map;
+  q->map_len       = (size_t)st.st_size;
+  q->map_pos       = ISRRAN_MIN((size_t)pos + offset, q->map_len);
+  q->readahead_pos = (q->map_pos / FILE_READAHEAD_ALIGN) * FILE_READAHEAD_ALIGN;
+  q->released_pos  = q->readahead_pos;
+  rf_file_rx_readahead(q);
+
+  return ISRRAN_SUCCESS;
+}
 
 int rf_file_rx_open(rf_file_rx_t* q, rf_file_opts_t opts)
 {
@@ -39,6 +96,14 @@ int rf_file_rx_open(rf_file_rx_t* q, rf_file_opts_t opts)
     // Assign file
     q->file = opts.file;
 
+    // Map the file if possible, otherwise fall back to stdio
+    if (opts.use_mmap && rf_file_rx_map(q, (size_t)opts.offset * sizeof(cf_t)) == ISRRAN_SUCCESS) {
+      rf_file_info(q->id, "Mapped %zu B of receive file\n", q->map_len);
+    } else if (opts.offset > 0 && fseeko(q->file, (off_t)(opts.offset * sizeof(cf_t)), SEEK_CUR) != 0) {
+      fprintf(stderr, "Error: skipping %" PRIu64 " samples of receive file\n", opts.offset);
+      goto clean_exit;
+    }
+
     // Configure formats
     q->sample_format = opts.sample_format;
     q->frequency_mhz = opts.frequency_mhz;
@@ -69,11 +134,29 @@ clean_exit:
   return ret;
 }
 
+// Returns a pointer to up to nsamples mapped samples and advances the read position
+static cf_t* rf_file_rx_map_read(rf_file_rx_t* q, uint32_t* nsamples)
+{
+  *nsamples = ISRRAN_MIN(*nsamples, NBYTES2NSAMPLES(q->map_len - q->map_pos));
+  cf_t* ptr = (cf_t*)(q->map + q->map_pos);
+  q->map_pos += NSAMPLES2NBYTES(*nsamples);
+  rf_file_rx_readahead(q);
+  return ptr;
+}
+
 int rf_file_rx_baseband(rf_file_rx_t* q, cf_t* buffer, uint32_t nsamples)
 {
   uint32_t sample_sz = sizeof(cf_t);
 
-  int ret = fread(buffer, sample_sz, nsamples, q->file);
+  int ret = 0;
+  if (q->map) {
+    cf_t* ptr = rf_file_rx_map_read(q, &nsamples);
+    memcpy(buffer, ptr, NSAMPLES2NBYTES(nsamples));
+    ret = (int)nsamples;
+  } else {
+    ret = fread(buffer, sample_sz, nsamples, q->file);
+  }
+
   if (ret > 0) {
     return ret;
   } else {
@@ -81,6 +164,53 @@ int rf_file_rx_baseband(rf_file_rx_t* q, cf_t* buffer, uint32_t nsamples)
   }
 }
 
+static void rf_file_rx_deinterleave(const cf_t* src, cf_t** buffers, uint32_t nof_channels, uint32_t nsamples)
+{
+  for (uint32_t c = 0; c < nof_channels; c++) {
+    cf_t* dst = buffers[c];
+    for (uint32_t i = 0; i < nsamples; i++) {
+      dst[i] = src[i * nof_channels + c];
+    }
+  }
+}
+
+int rf_file_rx_baseband_interleaved(rf_file_rx_t* q, cf_t** buffers, uint32_t nof_channels, uint32_t nsamples)
+{
+  if (nof_channels == 0 || nof_channels > ISRRAN_MAX_CHANNELS) {
+    return ISRRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t nsamples_all = nsamples * nof_channels;
+  uint32_t count        = 0;
+  if (q->map) {
+    // Deinterleave straight from the mapped file
+    const cf_t* ptr = rf_file_rx_map_read(q, &nsamples_all);
+    count           = nsamples_all / nof_channels;
+    rf_file_rx_deinterleave(ptr, buffers, nof_channels, count);
+  } else {
+    // Read whole sample groups in chunks that fit in the temporal buffer
+    while (count < nsamples) {
+      uint32_t n = ISRRAN_MIN(nsamples - count, NBYTES2NSAMPLES(FILE_MAX_BUFFER_SIZE) / nof_channels);
+      n          = fread(q->temp_buffer, NSAMPLES2NBYTES(nof_channels), n, q->file);
+      if (n == 0) {
+        break;
+      }
+      cf_t* dst[ISRRAN_MAX_CHANNELS] = {};
+      for (uint32_t c = 0; c < nof_channels; c++) {
+        dst[c] = &buffers[c][count];
+      }
+      rf_file_rx_deinterleave(q->temp_buffer, dst, nof_channels, n);
+      count += n;
+    }
+  }
+
+  if (count > 0) {
+    return (int)count;
+  } else {
+    return ISRRAN_ERROR_RX_EOF;
+  }
+}
+
 bool rf_file_rx_match_freq(rf_file_rx_t* q, uint32_t freq_hz)
 {
   bool ret = false;
@@ -103,5 +233,10 @@ void rf_file_rx_close(rf_file_rx_t* q)
     free(q->temp_buffer_convert);
   }
 
+  if (q->map) {
+    munmap(q->map, q->map_len);
+    q->map = NULL;
+  }
+
   // not touching q->file as we don't know if we need to close it ourselves
 }
@@ -39,6 +39,8 @@
 #define FILE_ID_STRLEN 16
 #define FILE_MAX_GAIN_DB (30.0f)
 #define FILE_MIN_GAIN_DB (0.0f)
+#define FILE_READAHEAD_ALIGN (2 * 1024 * 1024) // readahead in huge page sized chunks
+#define FILE_READAHEAD_SIZE (32 * FILE_READAHEAD_ALIGN)
 
 typedef enum { FILERF_TYPE_FC32 = 0, FILERF_TYPE_SC16 } rf_file_format_t;
 
@@ -66,6 +68,13 @@ typedef struct {
   cf_t*            temp_buffer;
   void*            temp_buffer_convert;
   uint32_t         frequency_mhz;
+
+  // Memory mapped file, NULL if the samples are read with stdio
+  uint8_t* map;
+  size_t   map_len;
+  size_t   map_pos;       // read position in bytes
+  size_t   readahead_pos; // end of the range requested to the kernel
+  size_t   released_pos;  // start of the range still mapped in memory
 } rf_file_rx_t;
 
 typedef struct {
@@ -73,6 +82,8 @@ typedef struct {
   rf_file_format_t sample_format;
   FILE*            file;
   uint32_t         frequency_mhz;
+  bool             use_mmap; // map the receive file in memory instead of reading it with stdio
+  uint64_t         offset;   // number of samples to skip from the current file position
 } rf_file_opts_t;
 
 /*
@@ -108,6 +119,14 @@ ISRRAN_API int rf_file_rx_open(rf_file_rx_t* q, rf_file_opts_t opts);
 
 ISRRAN_API int rf_file_rx_baseband(rf_file_rx_t* q, cf_t* buffer, uint32_t nsamples);
 
+/**
+ * Reads nsamples samples per channel from a file holding nof_channels interleaved channels (sample 0 of each channel,
+ * then sample 1 of each channel...) and deinterleaves them into the channel buffers.
+ * Returns the number of samples per channel read or ISRRAN_ERROR_RX_EOF.
+ */
+ISRRAN_API int
+rf_file_rx_baseband_interleaved(rf_file_rx_t* q, cf_t** buffers, uint32_t nof_channels, uint32_t nsamples);
+
 ISRRAN_API bool rf_file_rx_match_freq(rf_file_rx_t* q, uint32_t freq_hz);
 
 ISRRAN_API void rf_file_rx_close(rf_file_rx_t* q);
@@ -231,6 +231,70 @@ int param_test(const char* args_param, const int num_channels)
   return ISRRAN_SUCCESS;
 }
 
+// Writes NOF_RX_ANT interleaved channels where each sample encodes its channel and index, and reads them back
+int interleaved_test(bool use_mmap, uint32_t offset, const char* clock)
+{
+  const uint32_t nof_samples = SF_LEN * 10;
+
+  FILE* f = fopen("rx_interleaved", "wb");
+  if (f == NULL) {
+    return ISRRAN_ERROR;
+  }
+  for (uint32_t i = 0; i < nof_samples; i++) {
+    for (uint32_t c = 0; c < NOF_RX_ANT; c++) {
+      cf_t sample = (float)i + _Complex_I * (float)c;
+      fwrite(&sample, sizeof(cf_t), 1, f);
+    }
+  }
+  fclose(f);
+
+  char rf_args[RF_PARAM_LEN] = {};
+  snprintf(rf_args,
+           RF_PARAM_LEN,
+           "rx_file=rx_interleaved,rx_interleaved=1,rx_mmap=%d,rx_offset=%d,clock=%s,base_srate=1.92e6",
+           use_mmap ? 1 : 0,
+           offset,
+           clock);
+
+  printf("opening rx device with args=%s\n", rf_args);
+  if (isrran_rf_open_devname(&ue_radio, "file", rf_args, NOF_RX_ANT)) {
+    fprintf(stderr, "Error opening rf\n");
+    return ISRRAN_ERROR;
+  }
+
+  // receive until the end of file
+  int      ret     = ISRRAN_SUCCESS;
+  uint32_t nof_rx  = 0;
+  void*    data_ptr[ISRRAN_MAX_PORTS] = {NULL};
+  for (uint32_t c = 0; c < NOF_RX_ANT; c++) {
+    data_ptr[c] = ue_rx_buffer[c];
+  }
+  while (isrran_rf_recv_with_time_multi(&ue_radio, data_ptr, SF_LEN, true, NULL, NULL) == SF_LEN) {
+    for (uint32_t c = 0; c < NOF_RX_ANT; c++) {
+      for (uint32_t i = 0; i < SF_LEN; i++) {
+        cf_t expected = (float)(offset + nof_rx + i) + _Complex_I * (float)c;
+        if (ue_rx_buffer[c][i] != expected) {
+          fprintf(stderr, "data mismatch in channel %d, sample %d\n", c, nof_rx + i);
+          ret = ISRRAN_ERROR;
+          goto exit;
+        }
+      }
+    }
+    nof_rx += SF_LEN;
+  }
+
+  // the last partial subframe is discarded
+  if (nof_rx != ((nof_samples - offset) / SF_LEN) * SF_LEN) {
+    fprintf(stderr, "received %d samples, expected %d\n", nof_rx, nof_samples - offset);
+    ret = ISRRAN_ERROR;
+  }
+
+exit:
+  isrran_rf_close(&ue_radio);
+  remove("rx_interleaved");
+  return ret;
+}
+
 void create_file(const char* filename)
 {
   FILE* f = fopen(filename, "w");
@@ -288,6 +352,14 @@ int main()
     return ISRRAN_ERROR;
   }
 
+  // interleaved replay, read with stdio and memory mapped, with and without offset
+  if (interleaved_test(false, 0, "freerun") != ISRRAN_SUCCESS || interleaved_test(true, 0, "freerun") != ISRRAN_SUCCESS ||
+      interleaved_test(false, 100, "freerun") != ISRRAN_SUCCESS ||
+      interleaved_test(true, SF_LEN + 100, "realtime") != ISRRAN_SUCCESS) {
+    fprintf(stderr, "Interleaved replay test failed!\n");
+    return ISRRAN_ERROR;
+  }
+
 #if NOF_RX_ANT == 1
   // single tx, single rx with continuous transmissions (no decimation, no timed tx)
   if (run_test("rx_file=tx_file0,base_srate=1.92e6", "tx_file=tx_file0,base_srate=1.92e6", false) != ISRRAN_SUCCESS) {
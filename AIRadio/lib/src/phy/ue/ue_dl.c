@@ -383,6 +383,52 @@ int isrran_ue_dl_decode_fft_estimate_noguru(isrran_ue_dl_t*     q,
   }
 }
 
+int isrran_ue_dl_copy_estimate(isrran_ue_dl_t* q, const isrran_ue_dl_t* src, isrran_dl_sf_cfg_t* sf)
+{
+  if (q == NULL || src == NULL || sf == NULL) {
+    return ISRRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (q->cell.id != src->cell.id || q->cell.nof_prb != src->cell.nof_prb ||
+      q->nof_rx_antennas != src->nof_rx_antennas) {
+    ERROR("Copying estimate between different cells (PCI %d/%d, %d/%d PRB, %d/%d antennas)",
+          q->cell.id,
+          src->cell.id,
+          q->cell.nof_prb,
+          src->cell.nof_prb,
+          q->nof_rx_antennas,
+          src->nof_rx_antennas);
+    return ISRRAN_ERROR;
+  }
+
+  /* Resource grid */
+  for (uint32_t j = 0; j < q->nof_rx_antennas; j++) {
+    isrran_vec_cf_copy(q->sf_symbols[j], src->sf_symbols[j], CURRENT_SFLEN_RE);
+  }
+
+  /* Channel estimates, keeping the buffers owned by q */
+  cf_t* ce[ISRRAN_MAX_PORTS][ISRRAN_MAX_PORTS];
+  memcpy(ce, q->chest_res.ce, sizeof(ce));
+  uint32_t nof_re = ISRRAN_MIN(q->chest_res.nof_re, src->chest_res.nof_re);
+  q->chest_res    = src->chest_res;
+  memcpy(q->chest_res.ce, ce, sizeof(ce));
+  q->chest_res.nof_re = nof_re;
+  for (uint32_t i = 0; i < q->cell.nof_ports; i++) {
+    for (uint32_t j = 0; j < q->nof_rx_antennas; j++) {
+      isrran_vec_cf_copy(q->chest_res.ce[i][j], src->chest_res.ce[i][j], nof_re);
+    }
+  }
+
+  /* The mi value may differ between UEs in TDD, so the PDCCH LLR are extracted again */
+  set_mi_value(q, sf, NULL);
+  if (isrran_pdcch_extract_llr(&q->pdcch, sf, &q->chest_res, q->sf_symbols)) {
+    ERROR("Extracting PDCCH LLR");
+    return ISRRAN_ERROR;
+  }
+
+  return ISRRAN_SUCCESS;
+}
+
 static bool find_dci(isrran_dci_msg_t* dci_msg, uint32_t nof_dci_msg, isrran_dci_msg_t* match)
 {
   bool     found    = false;
@@ -0,0 +1,362 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <linux/perf_event.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "isrran/phy/common/phy_common.h"
+#include "isrran/phy/utils/debug.h"
+#include "isrran/phy/utils/hugepage.h"
+#include "isrran/phy/utils/simd.h"
+#include "isrran/phy/utils/vector.h"
+
+#ifndef MADV_COLLAPSE
+#define MADV_COLLAPSE 25
+#endif
+
+// Arena blocks are multiples of the SIMD alignment. Small blocks have one size class per multiple, larger blocks have
+// four size classes per power of two, wasting at most 25% of the block
+#define ARENA_UNIT ISRRAN_SIMD_BIT_ALIGN
+#define ARENA_NOF_LINEAR_CLASSES 16
+#define ARENA_NOF_CLASSES 256
+
+// Keeps the large PHY buffers in the reserved heap rather than in individual mappings
+#define HEAP_MMAP_THRESHOLD (32 * 1024 * 1024)
+
+// glibc default of M_TOP_PAD, restored once the heap is reserved
+#define HEAP_DEFAULT_TOP_PAD (128 * 1024)
+
+#define HUGEPAGE_ALIGN_DOWN(X) ((uintptr_t)(X) & ~(ISRRAN_HUGEPAGE_SIZE - 1))
+#define HUGEPAGE_ALIGN_UP(X) HUGEPAGE_ALIGN_DOWN((uintptr_t)(X) + ISRRAN_HUGEPAGE_SIZE - 1)
+
+typedef struct {
+  uint8_t* base;
+  size_t   size;
+  size_t   top;
+  bool     hugetlb;
+  uint8_t* block_class; // Size class of each allocated block, indexed by its offset in units
+  void*    free_list[ARENA_NOF_CLASSES];
+} hugepage_arena_t;
+
+static isrran_hugepage_mode_t  hugepage_mode = ISRRAN_HUGEPAGE_NONE;
+static pthread_mutex_t         hugepage_mutex = PTHREAD_MUTEX_INITIALIZER;
+static hugepage_arena_t        arena;
+static isrran_hugepage_stats_t stats;
+
+static uint32_t arena_class(size_t units)
+{
+  if (units <= ARENA_NOF_LINEAR_CLASSES) {
+    return units - 1;
+  }
+  uint32_t shift = (63 - __builtin_clzl(units - 1)) - 2;
+  uint32_t mant  = ((units - 1) >> shift) + 1;
+  return ARENA_NOF_LINEAR_CLASSES + (shift - 2) * 4 + (mant - 5);
+}
+
+static size_t arena_class_size(uint32_t c)
+{
+  if (c < ARENA_NOF_LINEAR_CLASSES) {
+    return (c + 1) * ARENA_UNIT;
+  }
+  uint32_t shift = (c - ARENA_NOF_LINEAR_CLASSES) / 4 + 2;
+  size_t   mant  = (c - ARENA_NOF_LINEAR_CLASSES) % 4 + 5;
+  return (mant << shift) * ARENA_UNIT;
+}
+
+static int arena_init(isrran_hugepage_mode_t mode, size_t size)
+{
+  void* base = MAP_FAILED;
+  if (mode == ISRRAN_HUGEPAGE_HUGETLB) {
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (base == MAP_FAILED) {
+      fprintf(stderr,
+              "Warning: Could not map %zu MB of huge pages, using transparent huge pages instead. Reserve them in "
+              "/proc/sys/vm/nr_hugepages\n",
+              size / (1024 * 1024));
+    }
+  }
+  arena.hugetlb = base != MAP_FAILED;
+
+  if (!arena.hugetlb) {
+    // Over-map to align the arena to the huge page size, otherwise its ends can not be backed by huge pages
+    uint8_t* raw = mmap(NULL, size + ISRRAN_HUGEPAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+      ERROR("Error mapping %zu bytes for the huge page arena", size);
+      return ISRRAN_ERROR;
+    }
+    uint8_t* aligned = (uint8_t*)HUGEPAGE_ALIGN_UP(raw);
+    if (aligned > raw) {
+      munmap(raw, aligned - raw);
+    }
+    munmap(aligned + size, raw + ISRRAN_HUGEPAGE_SIZE - aligned);
+    if (madvise(aligned, size, MADV_HUGEPAGE) != 0) {
+      fprintf(stderr, "Warning: Transparent huge pages are not available\n");
+    }
+    base = aligned;
+  }
+
+  arena.block_class = calloc(size / ARENA_UNIT, sizeof(uint8_t));
+  if (arena.block_class == NULL) {
+    munmap(base, size);
+    return ISRRAN_ERROR;
+  }
+  arena.base = base;
+  arena.size = size;
+  arena.top  = 0;
+  memset(arena.free_list, 0, sizeof(arena.free_list));
+  return ISRRAN_SUCCESS;
+}
+
+// Grows the main heap by heap_size bytes and advises its free top once for transparent huge pages, so that the large
+// buffers allocated next by the main thread with isrran_vec_malloc() are carved from huge pages. The malloc thresholds
+// are process-wide: buffers up to HEAP_MMAP_THRESHOLD stay in the heap and the reserved top is never trimmed
+static void heap_reserve(size_t heap_size)
+{
+  mallopt(M_MMAP_THRESHOLD, HEAP_MMAP_THRESHOLD);
+  mallopt(M_TRIM_THRESHOLD, heap_size + HEAP_MMAP_THRESHOLD);
+  mallopt(M_TOP_PAD, heap_size);
+  uint8_t*  probe = malloc(ISRRAN_MIN(heap_size, HEAP_MMAP_THRESHOLD / 2));
+  uintptr_t begin = HUGEPAGE_ALIGN_UP(probe);
+  uintptr_t end   = HUGEPAGE_ALIGN_DOWN(sbrk(0));
+  free(probe);
+  mallopt(M_TOP_PAD, HEAP_DEFAULT_TOP_PAD);
+
+  // The pages are not populated yet, they are backed by huge pages on first touch or when locked
+  if (probe == NULL || end <= begin || madvise((void*)begin, end - begin, MADV_HUGEPAGE) != 0) {
+    fprintf(stderr, "Warning: Could not advise the heap for transparent huge pages\n");
+    return;
+  }
+  stats.advised_bytes = end - begin;
+}
+
+const char* isrran_hugepage_mode_string(isrran_hugepage_mode_t mode)
+{
+  switch (mode) {
+    case ISRRAN_HUGEPAGE_NONE:
+      return "none";
+    case ISRRAN_HUGEPAGE_THP:
+      return "thp";
+    case ISRRAN_HUGEPAGE_HUGETLB:
+      return "hugetlb";
+    default:
+      return "invalid";
+  }
+}
+
+int isrran_hugepage_mode_parse(const char* str, isrran_hugepage_mode_t* mode)
+{
+  if (str == NULL || mode == NULL) {
+    return ISRRAN_ERROR_INVALID_INPUTS;
+  }
+  for (isrran_hugepage_mode_t m = ISRRAN_HUGEPAGE_NONE; m <= ISRRAN_HUGEPAGE_HUGETLB; m++) {
+    if (strcasecmp(str, isrran_hugepage_mode_string(m)) == 0) {
+      *mode = m;
+      return ISRRAN_SUCCESS;
+    }
+  }
+  return ISRRAN_ERROR;
+}
+
+int isrran_hugepage_init(isrran_hugepage_mode_t mode, size_t arena_size, size_t heap_size)
+{
+  if (mode == ISRRAN_HUGEPAGE_NONE) {
+    return ISRRAN_SUCCESS;
+  }
+  if (mode > ISRRAN_HUGEPAGE_HUGETLB) {
+    return ISRRAN_ERROR_INVALID_INPUTS;
+  }
+
+  pthread_mutex_lock(&hugepage_mutex);
+  if (hugepage_mode != ISRRAN_HUGEPAGE_NONE) {
+    pthread_mutex_unlock(&hugepage_mutex);
+    ERROR("Huge pages are already enabled");
+    return ISRRAN_ERROR;
+  }
+
+  arena_size = HUGEPAGE_ALIGN_UP(arena_size);
+  if (arena_size > 0 && arena_init(mode, arena_size) != ISRRAN_SUCCESS) {
+    pthread_mutex_unlock(&hugepage_mutex);
+    return ISRRAN_ERROR;
+  }
+
+  memset(&stats, 0, sizeof(stats));
+  if (heap_size > 0) {
+    heap_reserve(HUGEPAGE_ALIGN_UP(heap_size));
+  }
+
+  hugepage_mode = mode;
+  pthread_mutex_unlock(&hugepage_mutex);
+  return ISRRAN_SUCCESS;
+}
+
+void isrran_hugepage_exit(void)
+{
+  pthread_mutex_lock(&hugepage_mutex);
+  if (arena.base != NULL) {
+    munmap(arena.base, arena.size);
+    free(arena.block_class);
+  }
+  memset(&arena, 0, sizeof(arena));
+  hugepage_mode = ISRRAN_HUGEPAGE_NONE;
+  pthread_mutex_unlock(&hugepage_mutex);
+}
+
+isrran_hugepage_mode_t isrran_hugepage_get_mode(void)
+{
+  return hugepage_mode;
+}
+
+void* isrran_hugepage_malloc(size_t size)
+{
+  if (arena.base != NULL && size > 0) {
+    uint32_t c          = arena_class((size + ARENA_UNIT - 1) / ARENA_UNIT);
+    size_t   class_size = arena_class_size(c);
+    uint8_t* ptr        = NULL;
+
+    pthread_mutex_lock(&hugepage_mutex);
+    if (c < ARENA_NOF_CLASSES && arena.free_list[c] != NULL) {
+      ptr                = arena.free_list[c];
+      arena.free_list[c] = *(void**)ptr;
+    } else if (c < ARENA_NOF_CLASSES && arena.top + class_size <= arena.size) {
+      ptr = arena.base + arena.top;
+      arena.top += class_size;
+    }
+    if (ptr != NULL) {
+      arena.block_class[(ptr - arena.base) / ARENA_UNIT] = c;
+      stats.arena_used += class_size;
+      stats.arena_peak = ISRRAN_MAX(stats.arena_peak, stats.arena_used);
+      stats.nof_allocs++;
+    } else {
+      stats.nof_fallbacks++;
+    }
+    pthread_mutex_unlock(&hugepage_mutex);
+
+    if (ptr != NULL) {
+      return ptr;
+    }
+  }
+  return isrran_vec_malloc(size);
+}
+
+void isrran_hugepage_free(void* ptr)
+{
+  uint8_t* p = (uint8_t*)ptr;
+  if (arena.base != NULL && p >= arena.base && p < arena.base + arena.size) {
+    pthread_mutex_lock(&hugepage_mutex);
+    uint32_t c         = arena.block_class[(p - arena.base) / ARENA_UNIT];
+    *(void**)p         = arena.free_list[c];
+    arena.free_list[c] = p;
+    stats.arena_used -= arena_class_size(c);
+    stats.nof_frees++;
+    pthread_mutex_unlock(&hugepage_mutex);
+    return;
+  }
+  free(ptr);
+}
+
+static uint64_t anon_huge_bytes(void)
+{
+  FILE* f = fopen("/proc/self/smaps_rollup", "r");
+  if (f == NULL) {
+    return 0;
+  }
+  char     line[128];
+  uint64_t kb = 0;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+      break;
+    }
+  }
+  fclose(f);
+  return kb * 1024;
+}
+
+void isrran_hugepage_get_stats(isrran_hugepage_stats_t* s)
+{
+  if (s == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&hugepage_mutex);
+  *s               = stats;
+  s->mode          = hugepage_mode;
+  s->arena_hugetlb = arena.hugetlb;
+  s->arena_size    = arena.size;
+  pthread_mutex_unlock(&hugepage_mutex);
+  s->anon_huge_bytes = anon_huge_bytes();
+}
+
+uint32_t isrran_hugepage_stats_info(char* str, uint32_t str_len)
+{
+  isrran_hugepage_stats_t s;
+  isrran_hugepage_get_stats(&s);
+
+  int n = snprintf(str,
+                   str_len,
+                   "hugepages=%s, arena=%luMB (%s), used=%luKB, peak=%luKB, allocs=%lu, frees=%lu, fallbacks=%lu, "
+                   "advised=%luMB, thp=%luMB",
+                   isrran_hugepage_mode_string(s.mode),
+                   s.arena_size / (1024 * 1024),
+                   s.arena_hugetlb ? "hugetlb" : "thp",
+                   s.arena_used / 1024,
+                   s.arena_peak / 1024,
+                   s.nof_allocs,
+                   s.nof_frees,
+                   s.nof_fallbacks,
+                   s.advised_bytes / (1024 * 1024),
+                   s.anon_huge_bytes / (1024 * 1024));
+  return (n < 0) ? 0 : ISRRAN_MIN((uint32_t)n, str_len);
+}
+
+int isrran_dtlb_counter_open(void)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type           = PERF_TYPE_HW_CACHE;
+  attr.size           = sizeof(attr);
+  attr.config         = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+uint64_t isrran_dtlb_counter_read(int fd)
+{
+  uint64_t count = 0;
+  if (fd < 0 || read(fd, &count, sizeof(count)) != sizeof(count)) {
+    return 0;
+  }
+  return count;
+}
+
+void isrran_dtlb_counter_close(int fd)
+{
+  if (fd >= 0) {
+    close(fd);
+  }
+}
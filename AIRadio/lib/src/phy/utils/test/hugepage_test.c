@@ -0,0 +1,140 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/phy/utils/hugepage.h"
+#include "isrran/phy/fec/softbuffer.h"
+#include "isrran/phy/utils/simd.h"
+#include "isrran/phy/utils/vector.h"
+#include "isrran/support/isrran_test.h"
+#include <string.h>
+#include <unistd.h>
+
+#define ARENA_SIZE (2 * ISRRAN_HUGEPAGE_SIZE)
+#define HEAP_SIZE (4 * ISRRAN_HUGEPAGE_SIZE)
+
+static int test_mode_parse()
+{
+  isrran_hugepage_mode_t mode = ISRRAN_HUGEPAGE_NONE;
+  TESTASSERT(isrran_hugepage_mode_parse("thp", &mode) == ISRRAN_SUCCESS && mode == ISRRAN_HUGEPAGE_THP);
+  TESTASSERT(isrran_hugepage_mode_parse("HugeTLB", &mode) == ISRRAN_SUCCESS && mode == ISRRAN_HUGEPAGE_HUGETLB);
+  TESTASSERT(isrran_hugepage_mode_parse("none", &mode) == ISRRAN_SUCCESS && mode == ISRRAN_HUGEPAGE_NONE);
+  TESTASSERT(isrran_hugepage_mode_parse("1g", &mode) == ISRRAN_ERROR);
+  return ISRRAN_SUCCESS;
+}
+
+static int test_disabled()
+{
+  // Without arena, the buffers come from the heap
+  TESTASSERT(isrran_hugepage_get_mode() == ISRRAN_HUGEPAGE_NONE);
+  void* ptr = isrran_hugepage_malloc(1000);
+  TESTASSERT(ptr != NULL && ISRRAN_IS_ALIGNED(ptr));
+  isrran_hugepage_free(ptr);
+
+  isrran_hugepage_stats_t stats;
+  isrran_hugepage_get_stats(&stats);
+  TESTASSERT(stats.arena_size == 0 && stats.nof_allocs == 0);
+  return ISRRAN_SUCCESS;
+}
+
+static int test_arena(isrran_hugepage_mode_t mode)
+{
+  TESTASSERT(isrran_hugepage_init(mode, ARENA_SIZE - 1000, HEAP_SIZE) == ISRRAN_SUCCESS);
+  TESTASSERT(isrran_hugepage_get_mode() == mode);
+  TESTASSERT(isrran_hugepage_init(mode, ARENA_SIZE, 0) == ISRRAN_ERROR);
+
+  isrran_hugepage_stats_t stats;
+  isrran_hugepage_get_stats(&stats);
+  TESTASSERT(stats.arena_size == ARENA_SIZE);
+
+  // Blocks of different sizes are aligned and do not overlap
+  const uint32_t sizes[] = {1, 100, 4096, 6144 * 3 * 2, 100000};
+  uint8_t*       ptr[5];
+  for (uint32_t i = 0; i < 5; i++) {
+    ptr[i] = isrran_hugepage_malloc(sizes[i]);
+    TESTASSERT(ptr[i] != NULL && ISRRAN_IS_ALIGNED(ptr[i]));
+    memset(ptr[i], (int)i + 1, sizes[i]);
+  }
+  for (uint32_t i = 0; i < 5; i++) {
+    TESTASSERT(ptr[i][0] == i + 1 && ptr[i][sizes[i] - 1] == i + 1);
+  }
+  isrran_hugepage_get_stats(&stats);
+  TESTASSERT(stats.nof_allocs == 5 && stats.nof_fallbacks == 0);
+  TESTASSERT(stats.arena_used >= 100000 + 6144 * 3 * 2 + 4096 && stats.arena_used == stats.arena_peak);
+
+  // A released block is reused by the next allocation of the same size class
+  isrran_hugepage_free(ptr[3]);
+  uint8_t* again = isrran_hugepage_malloc(sizes[3] - 10);
+  TESTASSERT(again == ptr[3]);
+
+  // Allocations that do not fit in the arena come from the heap
+  void* big = isrran_hugepage_malloc(ARENA_SIZE);
+  TESTASSERT(big != NULL && ISRRAN_IS_ALIGNED(big));
+  isrran_hugepage_get_stats(&stats);
+  TESTASSERT(stats.nof_fallbacks == 1);
+  isrran_hugepage_free(big);
+
+  for (uint32_t i = 0; i < 5; i++) {
+    isrran_hugepage_free(ptr[i]);
+  }
+  isrran_hugepage_get_stats(&stats);
+  TESTASSERT(stats.arena_used == 0 && stats.nof_frees == 6);
+
+  // The softbuffers are allocated from the arena
+  isrran_softbuffer_rx_t rx = {};
+  isrran_softbuffer_tx_t tx = {};
+  TESTASSERT(isrran_softbuffer_rx_init_guru(&rx, 2, 1024) == ISRRAN_SUCCESS);
+  TESTASSERT(isrran_softbuffer_tx_init_guru(&tx, 2, 1024) == ISRRAN_SUCCESS);
+  isrran_hugepage_get_stats(&stats);
+  TESTASSERT(stats.nof_allocs == 6 + 2 * 2 + 2);
+  isrran_softbuffer_rx_free(&rx);
+  isrran_softbuffer_tx_free(&tx);
+  isrran_hugepage_get_stats(&stats);
+  TESTASSERT(stats.arena_used == 0);
+
+  // The heap reserved at init is advised for transparent huge pages, the large buffers allocated next come from it
+  TESTASSERT(stats.advised_bytes >= HEAP_SIZE - 2 * ISRRAN_HUGEPAGE_SIZE);
+  cf_t* buffer = isrran_vec_cf_malloc(ISRRAN_HUGEPAGE_SIZE / sizeof(cf_t));
+  TESTASSERT(buffer != NULL);
+  isrran_vec_cf_zero(buffer, ISRRAN_HUGEPAGE_SIZE / sizeof(cf_t));
+  TESTASSERT((uint8_t*)buffer + ISRRAN_HUGEPAGE_SIZE <= (uint8_t*)sbrk(0));
+  free(buffer);
+
+  char str[256];
+  TESTASSERT(isrran_hugepage_stats_info(str, sizeof(str)) > 0);
+  printf("%s\n", str);
+
+  isrran_hugepage_exit();
+  TESTASSERT(isrran_hugepage_get_mode() == ISRRAN_HUGEPAGE_NONE);
+  return ISRRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  TESTASSERT(test_mode_parse() == ISRRAN_SUCCESS);
+  TESTASSERT(test_disabled() == ISRRAN_SUCCESS);
+
+  // Without huge pages reserved in the system, the HUGETLB arena falls back to transparent huge pages
+  TESTASSERT(test_arena(ISRRAN_HUGEPAGE_THP) == ISRRAN_SUCCESS);
+  TESTASSERT(test_arena(ISRRAN_HUGEPAGE_HUGETLB) == ISRRAN_SUCCESS);
+
+  printf("Ok\n");
+  return ISRRAN_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/**
+ * ASN.1 codec benchmark. Representative RRC, S1AP and NGAP messages are unpacked and packed repeatedly, and the
+ * encoding throughput is reported in messages/s for each of them. The decoding of a fresh message, including its
+ * destruction, is also compared with the members allocated from the heap and from a per-message arena.
+ */
+
+#include "isrran/asn1/ngap.h"
+#include "isrran/asn1/rrc.h"
+#include "isrran/asn1/s1ap.h"
+#include <chrono>
+#include <getopt.h>
+#include <vector>
+
+using namespace asn1;
+
+static uint32_t nof_repetitions = 100000;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [n]\n", prog);
+  printf("\t-n Number of times each message is unpacked and packed [Default %d]\n", nof_repetitions);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "n")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+template <typename Msg>
+static void run_bench(const char* name, const std::vector<uint8_t>& encoded)
+{
+  Msg                  msg;
+  std::vector<uint8_t> buffer(4096);
+
+  auto tstart = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_repetitions; ++i) {
+    cbit_ref bref(encoded.data(), encoded.size());
+    if (msg.unpack(bref) != ISRASN_SUCCESS) {
+      printf("Error unpacking %s\n", name);
+      exit(-1);
+    }
+  }
+  auto tunpack = std::chrono::steady_clock::now();
+
+  bit_ref bref;
+  for (uint32_t i = 0; i < nof_repetitions; ++i) {
+    bref = bit_ref(buffer.data(), buffer.size());
+    if (msg.pack(bref) != ISRASN_SUCCESS) {
+      printf("Error packing %s\n", name);
+      exit(-1);
+    }
+  }
+  auto tpack = std::chrono::steady_clock::now();
+
+  if ((size_t)bref.distance_bytes() != encoded.size() or
+      not std::equal(encoded.begin(), encoded.end(), buffer.begin())) {
+    printf("Error: %s is not packed as the original message\n", name);
+    exit(-1);
+  }
+
+  double unpack_secs = std::chrono::duration<double>(tunpack - tstart).count();
+  double pack_secs   = std::chrono::duration<double>(tpack - tunpack).count();
+  printf("%-26s %4zd bytes  unpack %9.0f msg/s %7.1f Mbit/s  pack %9.0f msg/s %7.1f Mbit/s\n",
+         name,
+         encoded.size(),
+         nof_repetitions / unpack_secs,
+         nof_repetitions * encoded.size() * 8 / unpack_secs / 1e6,
+         nof_repetitions / pack_secs,
+         nof_repetitions * encoded.size() * 8 / pack_secs / 1e6);
+
+  // Each message is decoded into a fresh object, as done by the eNB and MME handlers
+  tstart = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_repetitions; ++i) {
+    Msg      heap_msg;
+    cbit_ref heap_bref(encoded.data(), encoded.size());
+    if (heap_msg.unpack(heap_bref) != ISRASN_SUCCESS) {
+      printf("Error unpacking %s\n", name);
+      exit(-1);
+    }
+  }
+  auto theap = std::chrono::steady_clock::now();
+
+  uint64_t nof_allocations = 0;
+  for (uint32_t i = 0; i < nof_repetitions; ++i) {
+    arena    msg_arena;
+    Msg      arena_msg;
+    cbit_ref arena_bref(encoded.data(), encoded.size());
+    if (unpack_in_arena(arena_msg, arena_bref, msg_arena) != ISRASN_SUCCESS) {
+      printf("Error unpacking %s\n", name);
+      exit(-1);
+    }
+    nof_allocations += msg_arena.nof_allocations();
+  }
+  auto tarena = std::chrono::steady_clock::now();
+
+  double heap_secs  = std::chrono::duration<double>(theap - tstart).count();
+  double arena_secs = std::chrono::duration<double>(tarena - theap).count();
+  printf("%-26s new msg    heap   %9.0f msg/s  arena %9.0f msg/s  %5.1f allocations/msg\n",
+         "",
+         nof_repetitions / heap_secs,
+         nof_repetitions / arena_secs,
+         (double)nof_allocations / nof_repetitions);
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  isrlog::init();
+
+  printf("%d repetitions per message\n", nof_repetitions);
+
+  // RRCConnectionSetup
+  run_bench<rrc::dl_ccch_msg_s>("RRC ConnSetup", {0x60, 0x12, 0x98, 0x0b, 0xfd, 0xd2, 0x04, 0xfa, 0x18,
+                                                  0x3e, 0xd5, 0xe6, 0xc2, 0x59, 0x90, 0xc1, 0xa6, 0x00,
+                                                  0x01, 0x31, 0x40, 0x42, 0x50, 0x80, 0x00, 0xf8});
+
+  // RRCConnectionReconfiguration, with the Attach Accept NAS PDU
+  run_bench<rrc::dl_dcch_msg_s>(
+      "RRC ConnReconfiguration",
+      {0x20, 0x16, 0x00, 0x82, 0x00, 0x4a, 0x27, 0x50, 0x89, 0x30, 0x3c, 0x02, 0x07, 0x42, 0x02, 0x3e, 0x06, 0x00, 0x02,
+       0xf8, 0x39, 0x00, 0x07, 0x00, 0x1d, 0x52, 0x36, 0xc1, 0x01, 0x07, 0x07, 0x06, 0x73, 0x72, 0x73, 0x61, 0x70, 0x6e,
+       0x05, 0x01, 0xac, 0x10, 0x00, 0x02, 0x27, 0x08, 0x80, 0x00, 0x0d, 0x04, 0x08, 0x08, 0x08, 0x08, 0x50, 0x0b, 0xf6,
+       0x02, 0xf8, 0x39, 0x00, 0x01, 0x1a, 0x26, 0xb1, 0x8f, 0x01, 0x13, 0x02, 0xf8, 0x39, 0x00, 0x01, 0x23, 0x05, 0xf4,
+       0x26, 0xb1, 0x8f, 0x01, 0x62, 0x7c, 0x1f, 0x50, 0x29, 0x8e, 0x90, 0xf1, 0xcc, 0x82, 0xa2, 0x60, 0x00, 0x12, 0xa0,
+       0x00});
+
+  // S1AP InitialContextSetupRequest, with the Attach Accept NAS PDU
+  run_bench<s1ap::s1ap_pdu_c>(
+      "S1AP InitialContextSetup",
+      {0x00, 0x09, 0x00, 0x80, 0xc6, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x02, 0x00, 0x64, 0x00, 0x08, 0x00, 0x02, 0x00,
+       0x01, 0x00, 0x42, 0x00, 0x0a, 0x18, 0x3b, 0x9a, 0xca, 0x00, 0x60, 0x3b, 0x9a, 0xca, 0x00, 0x00, 0x18, 0x00, 0x78,
+       0x00, 0x00, 0x34, 0x00, 0x73, 0x45, 0x00, 0x09, 0x3c, 0x0f, 0x80, 0x0a, 0x00, 0x21, 0xf0, 0xb7, 0x36, 0x1c, 0x56,
+       0x64, 0x27, 0x3e, 0x5b, 0x04, 0xb7, 0x02, 0x07, 0x42, 0x02, 0x3e, 0x06, 0x00, 0x09, 0xf1, 0x07, 0x00, 0x07, 0x00,
+       0x37, 0x52, 0x66, 0xc1, 0x01, 0x09, 0x1b, 0x07, 0x74, 0x65, 0x73, 0x74, 0x31, 0x32, 0x33, 0x06, 0x6d, 0x6e, 0x63,
+       0x30, 0x37, 0x30, 0x06, 0x6d, 0x63, 0x63, 0x39, 0x30, 0x31, 0x04, 0x67, 0x70, 0x72, 0x73, 0x05, 0x01, 0xc0, 0xa8,
+       0x03, 0x02, 0x27, 0x0e, 0x80, 0x80, 0x21, 0x0a, 0x03, 0x00, 0x00, 0x0a, 0x81, 0x06, 0x08, 0x08, 0x08, 0x08, 0x50,
+       0x0b, 0xf6, 0x09, 0xf1, 0x07, 0x80, 0x01, 0x01, 0xf6, 0x7e, 0x72, 0x69, 0x13, 0x09, 0xf1, 0x07, 0x00, 0x01, 0x23,
+       0x05, 0xf4, 0xf6, 0x7e, 0x72, 0x69, 0x00, 0x6b, 0x00, 0x05, 0x18, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x49, 0x00, 0x20,
+       0x45, 0x25, 0xe4, 0x9a, 0x77, 0xc8, 0xd5, 0xcf, 0x26, 0x33, 0x63, 0xeb, 0x5b, 0xb9, 0xc3, 0x43, 0x9b, 0x9e, 0xb3,
+       0x86, 0x1f, 0xa8, 0xa7, 0xcf, 0x43, 0x54, 0x07, 0xae, 0x42, 0x2b, 0x63, 0xb9});
+
+  // NGAP PDUSessionResourceSetupRequest
+  run_bench<ngap::ngap_pdu_c>(
+      "NGAP PDUSessionResSetup",
+      {0x00, 0x1d, 0x00, 0x6c, 0x00, 0x00, 0x04, 0x00, 0x0a, 0x00, 0x02, 0x00, 0x01, 0x00, 0x55, 0x00, 0x02, 0x00, 0x01,
+       0x00, 0x26, 0x00, 0x2e, 0x2d, 0x7e, 0x00, 0x68, 0x01, 0x00, 0x25, 0x2e, 0x01, 0x00, 0xc2, 0x11, 0x00, 0x06, 0x01,
+       0x00, 0x03, 0x30, 0x01, 0x01, 0x06, 0x06, 0x03, 0xe8, 0x06, 0x03, 0xe8, 0x29, 0x05, 0x01, 0xc0, 0xa8, 0x0c, 0x7b,
+       0x25, 0x08, 0x07, 0x64, 0x65, 0x66, 0x61, 0x75, 0x6c, 0x74, 0x12, 0x01, 0x00, 0x4a, 0x00, 0x27, 0x00, 0x00, 0x01,
+       0x00, 0x00, 0x21, 0x00, 0x00, 0x03, 0x00, 0x8b, 0x00, 0x0a, 0x01, 0xf0, 0xc0, 0xa8, 0x11, 0xd2, 0x00, 0x00, 0x00,
+       0x01, 0x00, 0x86, 0x00, 0x01, 0x10, 0x00, 0x88, 0x00, 0x07, 0x00, 0x01, 0x00, 0x00, 0x09, 0x00, 0x00});
+
+  return 0;
+}
@@ -668,6 +668,174 @@ void test_varlength_field_pack()
   TESTASSERT_EQ(17, bref.distance()); // accounts for length determinant and 1 byte of data
 }
 
+void test_arena()
+{
+  asn1::arena arena;
+  {
+    dyn_array<int>                d;
+    ext_array<uint8_t>            e;
+    copy_ptr<dyn_array<uint32_t>> p;
+    {
+      arena_scope scope(arena);
+      d.resize(10);
+      e.resize(100);
+      p.set_present();
+      p->resize(3);
+      std::iota(d.data(), d.data() + d.size(), 0);
+      std::iota(e.data(), e.data() + e.size(), 0);
+      (*p)[2] = 5;
+    }
+    TESTASSERT_EQ(4, arena.nof_allocations());
+    TESTASSERT_EQ(0, arena.nof_chunks());
+    TESTASSERT(detail::is_arena_allocated(d.data()) and detail::is_arena_allocated(e.data()));
+    TESTASSERT(detail::is_arena_allocated(p.get()));
+
+    // Outside of the scope, the copies and moves allocate from the heap
+    dyn_array<int>                d2(d);
+    ext_array<uint8_t>            e2(std::move(e));
+    copy_ptr<dyn_array<uint32_t>> p2(std::move(p));
+    TESTASSERT(not detail::is_arena_allocated(d2.data()) and not detail::is_arena_allocated(e2.data()));
+    TESTASSERT(not detail::is_arena_allocated(p2.get()));
+    TESTASSERT(d2 == d);
+    TESTASSERT_EQ(100, e2.size());
+    TESTASSERT_EQ(99, e2[99]);
+    TESTASSERT_EQ(5, (*p2)[2]);
+    TESTASSERT_EQ(4, arena.nof_allocations());
+
+    // Allocations that do not fit in the inline storage take new chunks
+    {
+      arena_scope scope(arena);
+      d.resize(arena::inline_size);
+    }
+    TESTASSERT_EQ(1, arena.nof_chunks());
+    TESTASSERT_EQ(9, d[9]);
+  }
+
+  // copy_ptr also owns objects allocated with new, and release() hands out objects that can be deleted
+  {
+    copy_ptr<dyn_array<uint32_t>> p;
+    {
+      arena_scope scope(arena);
+      p.set_present();
+      p->resize(2);
+      copy_ptr<dyn_array<uint32_t>> q(new dyn_array<uint32_t>(3));
+      copy_ptr<dyn_array<uint32_t>> q2(std::move(q));
+      TESTASSERT_EQ(3, q2->size());
+      q.reset(new dyn_array<uint32_t>(4));
+      q2 = q;
+      TESTASSERT(detail::is_arena_allocated(q2.get()));
+      TESTASSERT_EQ(4, q2->size());
+    }
+    TESTASSERT(detail::is_arena_allocated(p.get()));
+    dyn_array<uint32_t>* r = p.release();
+    TESTASSERT(r != nullptr and p.get() == nullptr);
+    TESTASSERT_EQ(2, r->size());
+    delete r;
+  }
+
+  // Growth of an ext_array that is already in the heap
+  ext_array<int> e;
+  for (int i = 0; i < 100; ++i) {
+    e.push_back(i);
+  }
+  for (int i = 0; i < 100; ++i) {
+    TESTASSERT_EQ(i, e[i]);
+  }
+}
+
+// Octet at a time packing, used as reference for the word accesses of bit_ref
+int ref_pack(uint8_t*& ptr, uint8_t& offset, const uint8_t* max_ptr, uint64_t val, uint32_t n_bits)
+{
+  while (n_bits > 0) {
+    if (ptr >= max_ptr) {
+      return ISRASN_ERROR_ENCODE_FAIL;
+    }
+    val              = val & ((1ul << n_bits) - 1ul);
+    uint8_t keepmask = ((uint8_t)-1) - (uint8_t)((1u << (8u - offset)) - 1u);
+    if ((uint32_t)(8 - offset) > n_bits) {
+      *ptr = ((*ptr) & keepmask) + static_cast<uint8_t>(val << (8u - offset - n_bits));
+      offset += n_bits;
+      n_bits = 0;
+    } else {
+      *ptr = (*ptr & keepmask) + static_cast<uint8_t>(val >> (n_bits - 8u + offset));
+      n_bits -= (8 - offset);
+      offset = 0;
+      ptr++;
+    }
+  }
+  return ISRASN_SUCCESS;
+}
+
+void test_bit_ref_word_access()
+{
+  std::uniform_int_distribution<uint32_t> nbits_dist(0, 63);
+  std::uniform_int_distribution<uint64_t> val_dist;
+  std::uniform_int_distribution<uint32_t> octet_dist(0, 255);
+
+  for (uint32_t buf_size = 1; buf_size < 48; ++buf_size) {
+    // The buffers start with the same random content, which must only be overwritten where the bits are packed
+    std::vector<uint8_t> buf(buf_size), ref_buf(buf_size);
+    for (uint32_t i = 0; i < buf_size; ++i) {
+      buf[i] = ref_buf[i] = octet_dist(g);
+    }
+    bit_ref               bref(buf.data(), buf_size);
+    uint8_t*              ref_ptr    = ref_buf.data();
+    uint8_t               ref_offset = 0;
+    std::vector<uint64_t> vals;
+    std::vector<uint32_t> nbits;
+    while (true) {
+      uint32_t n   = nbits_dist(g);
+      uint64_t val = val_dist(g);
+      int      ret = bref.pack(val, n);
+      TESTASSERT_EQ(ref_pack(ref_ptr, ref_offset, ref_buf.data() + buf_size, val, n), ret);
+      TESTASSERT(buf == ref_buf);
+      if (ret != ISRASN_SUCCESS) {
+        break;
+      }
+      TESTASSERT_EQ((int)(ref_ptr - ref_buf.data()) * 8 + ref_offset, bref.distance());
+      vals.push_back(n > 0 ? (val & ((1ul << n) - 1ul)) : 0);
+      nbits.push_back(n);
+    }
+
+    cbit_ref cbref(buf.data(), buf_size);
+    for (uint32_t i = 0; i < vals.size(); ++i) {
+      uint64_t val = 1;
+      TESTASSERT_EQ(ISRASN_SUCCESS, cbref.unpack(val, nbits[i]));
+      TESTASSERT_EQ(vals[i], val);
+    }
+    uint32_t nof_left = buf_size * 8 - cbref.distance();
+    if (nof_left < 64) {
+      uint64_t val;
+      TESTASSERT_EQ(ISRASN_ERROR_DECODE_FAIL, cbref.unpack(val, nof_left + 1));
+    }
+  }
+
+  // octet strings with every bit offset, packed in word chunks
+  for (uint32_t offset = 0; offset < 8; ++offset) {
+    for (uint32_t nof_bytes = 0; nof_bytes < 40; ++nof_bytes) {
+      std::vector<uint8_t> octets(nof_bytes), buf(nof_bytes + 1), ref_buf(nof_bytes + 1), unpacked(nof_bytes);
+      for (uint32_t i = 0; i < nof_bytes; ++i) {
+        octets[i] = octet_dist(g);
+      }
+      bit_ref  bref(buf.data(), buf.size());
+      uint8_t* ref_ptr    = ref_buf.data();
+      uint8_t  ref_offset = 0;
+      TESTASSERT_EQ(ISRASN_SUCCESS, bref.pack(0x5a, offset));
+      TESTASSERT_EQ(ISRASN_SUCCESS, bref.pack_bytes(octets.data(), nof_bytes));
+      ref_pack(ref_ptr, ref_offset, ref_buf.data() + ref_buf.size(), 0x5a, offset);
+      for (uint8_t octet : octets) {
+        ref_pack(ref_ptr, ref_offset, ref_buf.data() + ref_buf.size(), octet, 8);
+      }
+      TESTASSERT(buf == ref_buf);
+
+      cbit_ref cbref(buf.data(), buf.size());
+      TESTASSERT_EQ(ISRASN_SUCCESS, cbref.advance_bits(offset));
+      TESTASSERT_EQ(ISRASN_SUCCESS, cbref.unpack_bytes(unpacked.data(), nof_bytes));
+      TESTASSERT(unpacked == octets);
+    }
+  }
+}
+
 int main()
 {
   // Setup the log spy to intercept error and warning log entries.
@@ -697,6 +865,8 @@ int main()
   TESTASSERT(test_enum() == 0);
   TESTASSERT(test_big_integers() == 0);
   test_varlength_field_pack();
+  test_bit_ref_word_access();
+  test_arena();
   //  TESTASSERT(test_json_writer()==0);
 
   isrlog::flush();
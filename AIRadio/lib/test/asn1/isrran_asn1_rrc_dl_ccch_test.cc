@@ -19,9 +19,11 @@
  *
  */
 
+#include "isrran/asn1/asn1_msg_template.h"
 #include "isrran/asn1/rrc/dl_ccch_msg.h"
 #include "isrran/common/bcd_helpers.h"
 #include <iostream>
+#include <random>
 
 using namespace asn1;
 using namespace asn1::rrc;
@@ -82,6 +84,85 @@ int rrc_conn_setup_test1()
   return 0;
 }
 
+// RRCConnectionSetup encoded from a template, with per-UE SR and CQI resources
+int rrc_conn_setup_template_test()
+{
+  uint8_t rrc_msg[] = {0x60, 0x12, 0x98, 0x0b, 0xfd, 0xd2, 0x04, 0xfa, 0x18, 0x3e, 0xd5, 0xe6, 0xc2,
+                       0x59, 0x90, 0xc1, 0xa6, 0x00, 0x01, 0x31, 0x40, 0x42, 0x50, 0x80, 0x00, 0xf8};
+
+  cbit_ref      bref(&rrc_msg[0], sizeof(rrc_msg));
+  dl_ccch_msg_s dl_ccch_msg;
+  TESTASSERT(dl_ccch_msg.unpack(bref) == ISRASN_SUCCESS);
+
+  using tmpl_t = encoded_msg_template<dl_ccch_msg_s>;
+  auto setup   = [](dl_ccch_msg_s& msg) -> rrc_conn_setup_s& { return msg.msg.c1().rrc_conn_setup(); };
+  auto phy_cfg = [setup](dl_ccch_msg_s& msg) -> phys_cfg_ded_s& {
+    return setup(msg).crit_exts.c1().rrc_conn_setup_r8().rr_cfg_ded.phys_cfg_ded;
+  };
+  std::vector<tmpl_t::field_t> fields = {
+      {[setup](dl_ccch_msg_s& msg, uint32_t v) { setup(msg).rrc_transaction_id = v; }, 0, 3},
+      {[phy_cfg](dl_ccch_msg_s& msg, uint32_t v) { phy_cfg(msg).sched_request_cfg.setup().sr_pucch_res_idx = v; },
+       0,
+       2047},
+      {[phy_cfg](dl_ccch_msg_s& msg, uint32_t v) { phy_cfg(msg).sched_request_cfg.setup().sr_cfg_idx = v; }, 0, 157},
+      {[phy_cfg](dl_ccch_msg_s& msg, uint32_t v) {
+         phy_cfg(msg).cqi_report_cfg.cqi_report_periodic.setup().cqi_pucch_res_idx = v;
+       },
+       0,
+       1185},
+      {[phy_cfg](dl_ccch_msg_s& msg, uint32_t v) {
+         phy_cfg(msg).cqi_report_cfg.cqi_report_periodic.setup().cqi_pmi_cfg_idx = v;
+       },
+       0,
+       1023}};
+  tmpl_t tmpl;
+  TESTASSERT(tmpl.build(dl_ccch_msg, fields));
+
+  // TEST: the template encoding matches the packing of the whole message
+  std::mt19937          rng(0);
+  isrran::byte_buffer_t pdu, expected;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    std::vector<uint32_t> values;
+    for (const tmpl_t::field_t& f : fields) {
+      values.push_back(std::uniform_int_distribution<uint32_t>{f.lb, f.ub}(rng));
+      f.set(dl_ccch_msg, values.back());
+    }
+    TESTASSERT(tmpl.encode(pdu, values));
+
+    bit_ref bref2(expected.msg, expected.get_tailroom());
+    TESTASSERT(dl_ccch_msg.pack(bref2) == ISRASN_SUCCESS);
+    expected.N_bytes = bref2.distance_bytes();
+    TESTASSERT(pdu.N_bytes == expected.N_bytes);
+    TESTASSERT(memcmp(pdu.msg, expected.msg, pdu.N_bytes) == 0);
+  }
+
+  // TEST: values out of range are not encoded
+  std::vector<uint32_t> values = {0, 0, 158, 0, 0};
+  TESTASSERT(not tmpl.encode(pdu, values));
+
+  // TEST: a message that differs from the template in a field that is not patched is not matched by its encoding
+  values = {1, 2, 3, 4, 5};
+  for (uint32_t i = 0; i < fields.size(); ++i) {
+    fields[i].set(dl_ccch_msg, values[i]);
+  }
+  TESTASSERT(tmpl.encode(pdu, values) and tmpl.matches(dl_ccch_msg, pdu));
+  bool& simul_ack_cqi = phy_cfg(dl_ccch_msg).cqi_report_cfg.cqi_report_periodic.setup().simul_ack_nack_and_cqi;
+  simul_ack_cqi       = not simul_ack_cqi;
+  TESTASSERT(tmpl.encode(pdu, values) and not tmpl.matches(dl_ccch_msg, pdu));
+  simul_ack_cqi = not simul_ack_cqi;
+
+  // TEST: optional fields that are not always present can not be patched
+  auto set_ri = [phy_cfg](dl_ccch_msg_s& msg, uint32_t v) {
+    auto& cqi_setup              = phy_cfg(msg).cqi_report_cfg.cqi_report_periodic.setup();
+    cqi_setup.ri_cfg_idx_present = v > 0;
+    cqi_setup.ri_cfg_idx         = v;
+  };
+  std::vector<tmpl_t::field_t> opt_fields = {{set_ri, 0, 1023}};
+  TESTASSERT(not tmpl.build(dl_ccch_msg, opt_fields) and tmpl.empty());
+
+  return 0;
+}
+
 // Only packing implemented
 int rrc_reestablishment_reject_test()
 {
@@ -120,6 +201,7 @@ int main(int argc, char** argv)
   isrlog::init();
 
   TESTASSERT(rrc_conn_setup_test1() == 0);
+  TESTASSERT(rrc_conn_setup_template_test() == 0);
   TESTASSERT(rrc_reestablishment_reject_test() == 0);
 
   return 0;
@@ -93,6 +93,26 @@ int test_init_ctxt_setup_req()
 
   TESTASSERT(test_pack_unpack_consistency(pdu) == ISRASN_SUCCESS);
 
+  // Decode in an arena and copy the message out of it, before the arena is released
+  s1ap_pdu_c pdu_copy;
+  {
+    asn1::arena arena;
+    s1ap_pdu_c  arena_pdu;
+    {
+      asn1::arena_scope scope(arena);
+      cbit_ref          arena_bref(&s1ap_msg[0], sizeof(s1ap_msg));
+      TESTASSERT(arena_pdu.unpack(arena_bref) == ISRASN_SUCCESS);
+    }
+    TESTASSERT(arena.nof_allocations() > 0);
+    TESTASSERT_EQ(0, arena.nof_chunks());
+    pdu_copy = arena_pdu;
+  }
+  uint8_t buffer[512];
+  bit_ref bref2(&buffer[0], sizeof(buffer));
+  TESTASSERT(pdu_copy.pack(bref2) == ISRASN_SUCCESS);
+  TESTASSERT_EQ(sizeof(s1ap_msg), (size_t)bref2.distance_bytes());
+  TESTASSERT(memcmp(buffer, s1ap_msg, sizeof(s1ap_msg)) == 0);
+
   return ISRRAN_SUCCESS;
 }
 
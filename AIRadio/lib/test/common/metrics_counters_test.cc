@@ -0,0 +1,146 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include "isrran/common/metrics_counters.h"
+#include "isrran/common/test_common.h"
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace isrran;
+
+enum class test_counter { pkts, bits, sinr_sum, sinr_samples, nof_counters };
+
+using test_counters_t        = metrics_counters<test_counter>;
+using test_counters_reader_t = metrics_counters_reader<test_counter>;
+
+int test_increments()
+{
+  test_counters_t        counters;
+  test_counters_reader_t reader;
+
+  // Nothing counted
+  reader.update(counters);
+  TESTASSERT(reader.get(test_counter::pkts) == 0);
+  TESTASSERT(reader.average(test_counter::sinr_sum, test_counter::sinr_samples) == 0.0f);
+
+  // Each read returns the increments of its period
+  counters.add(test_counter::pkts);
+  counters.add(test_counter::bits, 1000);
+  reader.update(counters);
+  TESTASSERT(reader.get(test_counter::pkts) == 1);
+  TESTASSERT(reader.get(test_counter::bits) == 1000);
+
+  counters.add(test_counter::pkts);
+  counters.add(test_counter::pkts);
+  reader.update(counters);
+  TESTASSERT(reader.get(test_counter::pkts) == 2);
+  TESTASSERT(reader.get(test_counter::bits) == 0);
+
+  reader.update(counters);
+  TESTASSERT(reader.get(test_counter::pkts) == 0);
+
+  // The totals are kept across reads
+  TESTASSERT(counters.read()[(uint32_t)test_counter::pkts] == 3);
+
+  return ISRRAN_SUCCESS;
+}
+
+int test_averages()
+{
+  test_counters_t        counters;
+  test_counters_reader_t reader;
+
+  // Negative samples
+  counters.add_sample(test_counter::sinr_sum, test_counter::sinr_samples, -10.5f);
+  counters.add_sample(test_counter::sinr_sum, test_counter::sinr_samples, 2.25f);
+  reader.update(counters);
+  TESTASSERT(reader.get(test_counter::sinr_samples) == 2);
+  TESTASSERT(std::abs(reader.average(test_counter::sinr_sum, test_counter::sinr_samples) + 4.125f) < 1e-3f);
+
+  // Non finite samples are discarded
+  counters.add_sample(test_counter::sinr_sum, test_counter::sinr_samples, NAN);
+  counters.add_sample(test_counter::sinr_sum, test_counter::sinr_samples, -INFINITY);
+  counters.add_sample(test_counter::sinr_sum, test_counter::sinr_samples, 7.0f);
+  reader.update(counters);
+  TESTASSERT(reader.get(test_counter::sinr_samples) == 1);
+  TESTASSERT(std::abs(reader.average(test_counter::sinr_sum, test_counter::sinr_samples) - 7.0f) < 1e-3f);
+
+  // A sum sharing its number of samples with other sums counts non finite samples as zero
+  counters.add_sample(test_counter::sinr_sum, INFINITY);
+  counters.add_sample(test_counter::sinr_sum, 4.0f);
+  counters.add(test_counter::sinr_samples, 2);
+  reader.update(counters);
+  TESTASSERT(std::abs(reader.average(test_counter::sinr_sum, test_counter::sinr_samples) - 2.0f) < 1e-3f);
+
+  return ISRRAN_SUCCESS;
+}
+
+int test_concurrent_writers()
+{
+  const uint32_t nof_threads = 8, nof_adds = 100000;
+
+  test_counters_t        counters;
+  test_counters_reader_t reader;
+  uint64_t               nof_read = 0;
+
+  // The metrics thread reads while the workers count
+  std::atomic<bool> running{true};
+  std::thread       metrics_thread([&counters, &reader, &running, &nof_read]() {
+    while (running) {
+      reader.update(counters);
+      nof_read += reader.get(test_counter::pkts);
+    }
+  });
+
+  std::vector<std::thread> workers;
+  for (uint32_t i = 0; i < nof_threads; ++i) {
+    workers.emplace_back([&counters]() {
+      for (uint32_t j = 0; j < nof_adds; ++j) {
+        counters.add(test_counter::pkts);
+        counters.add(test_counter::bits, 8);
+      }
+    });
+  }
+  for (std::thread& t : workers) {
+    t.join();
+  }
+  running = false;
+  metrics_thread.join();
+
+  // No increment is lost, nor reported twice
+  reader.update(counters);
+  nof_read += reader.get(test_counter::pkts);
+  TESTASSERT(nof_read == nof_threads * nof_adds);
+  TESTASSERT(counters.read()[(uint32_t)test_counter::bits] == 8 * nof_threads * nof_adds);
+
+  return ISRRAN_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_increments() == ISRRAN_SUCCESS);
+  TESTASSERT(test_averages() == ISRRAN_SUCCESS);
+  TESTASSERT(test_concurrent_writers() == ISRRAN_SUCCESS);
+  printf("Success\n");
+  return 0;
+}
@@ -130,6 +130,79 @@ int test_socket_handler()
   return 0;
 }
 
+int test_udp_batch_handler()
+{
+  auto& logger = isrlog::fetch_basic_logger("GTPU", false);
+
+  std::atomic<int>      counter = {0};
+  std::atomic<uint32_t> nof_bytes{0};
+
+  isrran::unique_socket  server_socket, client_socket;
+  isrran::socket_manager sockhandler;
+  int                    server_port = 2152;
+  const char*            server_addr = "127.0.100.1";
+  using namespace isrran::net_utils;
+
+  TESTASSERT(server_socket.open_socket(addr_family::ipv4, socket_type::datagram, protocol_type::UDP));
+  TESTASSERT(server_socket.bind_addr(server_addr, server_port));
+  TESTASSERT(client_socket.open_socket(addr_family::ipv4, socket_type::datagram, protocol_type::UDP));
+  TESTASSERT(client_socket.bind_addr("127.0.0.1", 0));
+
+  sockaddr_in server_addrin = server_socket.get_addr_in();
+  uint8_t     buf[128]      = {};
+  int32_t     nof_pdus      = 100;
+  uint32_t    total_bytes   = 0;
+
+  auto send_pdu = [&](int32_t i) {
+    buf[0]         = (uint8_t)i;
+    size_t  len    = 1 + i % sizeof(buf);
+    ssize_t n_sent = sendto(client_socket.fd(), buf, len, 0, (struct sockaddr*)&server_addrin, sizeof(server_addrin));
+    total_bytes += len;
+    return n_sent == (ssize_t)len;
+  };
+
+  // Datagrams pending before registration must be read, as they do not generate an edge
+  for (int32_t i = 0; i < nof_pdus / 2; ++i) {
+    TESTASSERT(send_pdu(i));
+  }
+
+  // register server Rx handler with a batch smaller than the pending datagrams
+  auto pdu_handler = [&logger, &counter, &nof_bytes](isrran::unique_byte_buffer_t pdu, const sockaddr_in& from) {
+    logger.info(pdu->msg, pdu->N_bytes, "Received msg from %s:", get_ip(from).c_str());
+    nof_bytes += pdu->N_bytes;
+    counter++;
+  };
+  rx_thread_tester rx_tester;
+  TESTASSERT(sockhandler.add_edge_socket_handler(
+      server_socket.fd(), isrran::make_sdu_batch_handler(logger, rx_tester.task_queue, pdu_handler, 8)));
+
+  for (int32_t i = nof_pdus / 2; i < nof_pdus; ++i) {
+    TESTASSERT(send_pdu(i));
+    if (i % 10 == 0) {
+      usleep(1000);
+    }
+  }
+
+  uint32_t time_elapsed = 0;
+  while (counter != nof_pdus) {
+    usleep(100);
+    time_elapsed += 100;
+    if (time_elapsed > 3000000) {
+      // too much time has passed
+      return -1;
+    }
+  }
+  TESTASSERT(nof_bytes == total_bytes);
+
+  // Once removed, the socket is not read anymore
+  TESTASSERT(sockhandler.remove_socket(server_socket.fd()));
+  TESTASSERT(send_pdu(0));
+  usleep(10000);
+  TESTASSERT(counter == nof_pdus);
+
+  return 0;
+}
+
 int test_sctp_bind_error()
 {
   isrran::unique_socket sock;
@@ -157,6 +230,7 @@ int main()
   isrlog::init();
 
   TESTASSERT(test_socket_handler() == 0);
+  TESTASSERT(test_udp_batch_handler() == 0);
   TESTASSERT(test_sctp_bind_error() == 0);
 
   return 0;
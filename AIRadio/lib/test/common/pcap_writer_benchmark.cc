@@ -0,0 +1,196 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/common/mac_pcap.h"
+#include "isrran/common/pcap_writer.h"
+#include <chrono>
+#include <getopt.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace isrran;
+
+static uint32_t    nof_pdus    = 1000000;
+static uint32_t    pdu_size    = 1500;
+static uint32_t    nof_threads = 4;
+static std::string directory   = "/tmp";
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [nstd]\n", prog);
+  printf("\t-n Number of PDUs [Default %d]\n", nof_pdus);
+  printf("\t-s PDU size in bytes [Default %d]\n", pdu_size);
+  printf("\t-t Number of threads queueing PDUs into the MAC PCAP [Default %d]\n", nof_threads);
+  printf("\t-d Directory of the capture files [Default %s]\n", directory.c_str());
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nstd")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_pdus = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 's':
+        pdu_size = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 't':
+        nof_threads = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'd':
+        directory = argv[optind];
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static void print_rate(const char* name, uint64_t nof_written, std::chrono::steady_clock::duration elapsed)
+{
+  double secs = std::chrono::duration<double>(elapsed).count();
+  printf("%-28s %10.0f PDU/s %8.1f MB/s\n", name, nof_written / secs, nof_written * (double)pdu_size / secs / 1e6);
+}
+
+/// Writes the PDUs with the stdio based functions used before the PCAP writer.
+static void bench_stdio(const std::vector<uint8_t>& pdu, MAC_Context_Info_t& context)
+{
+  std::string filename = directory + "/pcap_bench_stdio.pcap";
+  FILE*       file     = DLT_PCAP_Open(UDP_DLT, filename.c_str());
+  if (file == nullptr) {
+    return;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_pdus; i++) {
+    LTE_PCAP_MAC_UDP_WritePDU(file, &context, pdu.data(), pdu.size());
+  }
+  DLT_PCAP_Close(file);
+  print_rate("stdio", nof_pdus, std::chrono::steady_clock::now() - start);
+  unlink(filename.c_str());
+}
+
+static void bench_writer(const std::vector<uint8_t>& pdu, MAC_Context_Info_t& context, bool use_io_uring, bool pcapng)
+{
+  std::string      filename = directory + (pcapng ? "/pcap_bench_writer.pcapng" : "/pcap_bench_writer.pcap");
+  pcap_writer_args args     = {};
+  args.use_io_uring         = use_io_uring;
+  args.pcapng               = pcapng;
+
+  pcap_writer writer(isrlog::fetch_basic_logger("PCAP"));
+  if (writer.open(filename, {{UDP_DLT, "mac-lte"}}, args) != ISRRAN_SUCCESS) {
+    return;
+  }
+
+  // The ring is released on close
+  std::string name = std::string("pcap_writer ") + (writer.is_io_uring_enabled() ? "io_uring" : "writev") +
+                     (pcapng ? " pcapng" : "");
+
+  uint8_t header[PCAP_CONTEXT_HEADER_MAX];
+  auto    start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_pdus; i++) {
+    int header_len = LTE_PCAP_MAC_UDP_PACK_HEADER(&context, pdu.size(), header, sizeof(header));
+    writer.write_pdu(0, header, header_len, pdu.data(), pdu.size());
+  }
+  writer.close();
+
+  print_rate(name.c_str(), nof_pdus, std::chrono::steady_clock::now() - start);
+  unlink(filename.c_str());
+}
+
+/// Counts the records of a classic pcap file.
+static uint64_t count_records(const std::string& filename)
+{
+  FILE* file = fopen(filename.c_str(), "r");
+  if (file == nullptr) {
+    return 0;
+  }
+
+  uint64_t      count  = 0;
+  pcap_hdr_t    header = {};
+  pcaprec_hdr_t record = {};
+  if (fread(&header, sizeof(header), 1, file) == 1) {
+    while (fread(&record, sizeof(record), 1, file) == 1 && fseek(file, record.incl_len, SEEK_CUR) == 0) {
+      count++;
+    }
+  }
+  fclose(file);
+  return count;
+}
+
+/// Queues the PDUs into a MAC PCAP from several threads at full speed, as the PHY workers do, and reports the rate
+/// of PDUs that made it into the file.
+static void bench_mac_pcap(const std::vector<uint8_t>& pdu)
+{
+  std::string filename = directory + "/pcap_bench_mac.pcap";
+  mac_pcap    pcap;
+  if (pcap.open(filename) != ISRRAN_SUCCESS) {
+    return;
+  }
+
+  auto                     start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < nof_threads; t++) {
+    threads.emplace_back([&pcap, &pdu, t]() {
+      for (uint32_t i = t; i < nof_pdus; i += nof_threads) {
+        pcap.write_dl_crnti(const_cast<uint8_t*>(pdu.data()), pdu.size(), 0x46, true, i % 10240, 0);
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  pcap.close();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  uint64_t nof_written = count_records(filename);
+  print_rate("mac_pcap", nof_written, elapsed);
+  printf("%-28s %10.2f %%\n", "mac_pcap dropped", 100.0 * (nof_pdus - nof_written) / nof_pdus);
+  unlink(filename.c_str());
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  // Drop warnings are counted from the file contents, keep the console clean
+  isrlog::fetch_basic_logger("MAC", false).set_level(isrlog::basic_levels::error);
+  isrlog::init();
+
+  std::vector<uint8_t> pdu(pdu_size, 0xab);
+  MAC_Context_Info_t   context = {};
+  context.radioType            = FDD_RADIO;
+  context.direction            = DIRECTION_DOWNLINK;
+  context.rntiType             = C_RNTI;
+  context.rnti                 = 0x46;
+
+  printf("Writing %d PDUs of %d bytes\n", nof_pdus, pdu_size);
+  bench_stdio(pdu, context);
+  bench_writer(pdu, context, false, false);
+  bench_writer(pdu, context, true, false);
+  bench_writer(pdu, context, true, true);
+  bench_mac_pcap(pdu);
+
+  isrlog::flush();
+  return 0;
+}
@@ -0,0 +1,271 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/common/mac_pcap.h"
+#include "isrran/common/pcap_writer.h"
+#include "isrran/common/test_common.h"
+#include <fstream>
+#include <iterator>
+
+using namespace isrran;
+
+static const uint32_t pdu_len = 1000;
+
+/// Record read back from a capture file.
+struct pcap_record_t {
+  uint32_t             if_idx;
+  std::vector<uint8_t> data;
+};
+
+static std::vector<uint8_t> read_file(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+template <typename T>
+static T load(const std::vector<uint8_t>& buf, size_t offset)
+{
+  T value = {};
+  if (offset + sizeof(T) <= buf.size()) {
+    memcpy(&value, &buf[offset], sizeof(T));
+  }
+  return value;
+}
+
+/// Parses a classic pcap file, returns false if it is malformed.
+static bool parse_pcap(const std::string& filename, uint32_t dlt, std::vector<pcap_record_t>& records)
+{
+  std::vector<uint8_t> buf = read_file(filename);
+  if (buf.size() < sizeof(pcap_hdr_t) || load<uint32_t>(buf, 0) != 0xa1b2c3d4 || load<uint32_t>(buf, 20) != dlt) {
+    return false;
+  }
+
+  size_t offset = sizeof(pcap_hdr_t);
+  while (offset < buf.size()) {
+    pcaprec_hdr_t hdr = load<pcaprec_hdr_t>(buf, offset);
+    offset += sizeof(pcaprec_hdr_t);
+    if (offset + hdr.incl_len > buf.size() || hdr.incl_len != hdr.orig_len) {
+      return false;
+    }
+    records.push_back({0, std::vector<uint8_t>(&buf[offset], &buf[offset] + hdr.incl_len)});
+    offset += hdr.incl_len;
+  }
+  return true;
+}
+
+/// Parses a pcapng file, returns false if it is malformed.
+static bool parse_pcapng(const std::string&          filename,
+                         std::vector<pcap_interface>& interfaces,
+                         std::vector<pcap_record_t>&  records)
+{
+  std::vector<uint8_t> buf = read_file(filename);
+  if (load<uint32_t>(buf, 0) != 0x0a0d0d0a || load<uint32_t>(buf, 8) != 0x1a2b3c4d) {
+    return false;
+  }
+
+  size_t offset = 0;
+  while (offset < buf.size()) {
+    uint32_t type = load<uint32_t>(buf, offset);
+    uint32_t len  = load<uint32_t>(buf, offset + 4);
+    if (len < 12 || len % 4 != 0 || offset + len > buf.size() || load<uint32_t>(buf, offset + len - 4) != len) {
+      return false;
+    }
+
+    if (type == 1) {
+      pcap_interface itf = {load<uint16_t>(buf, offset + 8), ""};
+      if (len > 20 && load<uint16_t>(buf, offset + 16) == 2) {
+        uint16_t name_len = load<uint16_t>(buf, offset + 18);
+        itf.name.assign((const char*)&buf[offset + 20], name_len);
+      }
+      interfaces.push_back(itf);
+    } else if (type == 6) {
+      uint32_t if_idx  = load<uint32_t>(buf, offset + 8);
+      uint32_t cap_len = load<uint32_t>(buf, offset + 20);
+      if (if_idx >= interfaces.size() || 28 + cap_len + 4 > len) {
+        return false;
+      }
+      records.push_back({if_idx, std::vector<uint8_t>(&buf[offset + 28], &buf[offset + 28] + cap_len)});
+    }
+    offset += len;
+  }
+  return true;
+}
+
+/// Checks that a record holds the header and the PDU written by write_records().
+static bool check_record(const pcap_record_t& record, uint32_t idx)
+{
+  if (record.data.size() != 4 + pdu_len) {
+    return false;
+  }
+  uint32_t header = load<uint32_t>(record.data, 0);
+  return header == idx && record.data[4] == (uint8_t)idx && record.data.back() == (uint8_t)idx;
+}
+
+static void write_records(pcap_writer& writer, uint32_t nof_records, uint32_t nof_interfaces)
+{
+  std::vector<uint8_t> pdu(pdu_len);
+  for (uint32_t i = 0; i < nof_records; i++) {
+    std::fill(pdu.begin(), pdu.end(), (uint8_t)i);
+    writer.write_pdu(i % nof_interfaces, (const uint8_t*)&i, sizeof(i), pdu.data(), pdu.size());
+  }
+}
+
+int test_pcap_file(bool use_io_uring)
+{
+  const std::string filename = "pcap_writer_test.pcap";
+  const uint32_t    N        = 2000;
+
+  pcap_writer_args args = {};
+  args.buffer_size      = 128 * 1024;
+  args.use_io_uring     = use_io_uring;
+
+  pcap_writer writer(isrlog::fetch_basic_logger("PCAP"));
+  TESTASSERT(writer.open(filename, {{UDP_DLT, "udp"}}, args) == ISRRAN_SUCCESS);
+  TESTASSERT(writer.open(filename, {{UDP_DLT, "udp"}}, args) != ISRRAN_SUCCESS); // open again will fail
+  isrran::console("Writing %s with %s\n", filename.c_str(), writer.is_io_uring_enabled() ? "io_uring" : "writev");
+
+  // Write over 2 MB through 4 buffers of 128 kB
+  write_records(writer, N, 1);
+  TESTASSERT(writer.get_nof_records() == N);
+  writer.close();
+
+  std::vector<pcap_record_t> records;
+  TESTASSERT(parse_pcap(filename, UDP_DLT, records));
+  TESTASSERT(records.size() == N);
+  for (uint32_t i = 0; i < N; i++) {
+    TESTASSERT(check_record(records[i], i));
+  }
+
+  remove(filename.c_str());
+  return ISRRAN_SUCCESS;
+}
+
+int test_pcapng_file()
+{
+  const std::string filename = "pcap_writer_test.pcapng";
+  const uint32_t    N        = 500;
+
+  pcap_writer_args args = {};
+  args.pcapng           = true;
+
+  pcap_writer writer(isrlog::fetch_basic_logger("PCAP"));
+  TESTASSERT(writer.open(filename, {{UDP_DLT, "mac-lte"}, {MAC_LTE_DLT, "mac"}}, args) == ISRRAN_SUCCESS);
+  write_records(writer, N, 2);
+  TESTASSERT(writer.write_pdu(2, nullptr, 0, nullptr, 0) != ISRRAN_SUCCESS); // invalid interface
+  writer.close();
+
+  std::vector<pcap_interface> interfaces;
+  std::vector<pcap_record_t>  records;
+  TESTASSERT(parse_pcapng(filename, interfaces, records));
+  TESTASSERT(interfaces.size() == 2);
+  TESTASSERT(interfaces[0].dlt == UDP_DLT && interfaces[0].name == "mac-lte");
+  TESTASSERT(interfaces[1].dlt == MAC_LTE_DLT && interfaces[1].name == "mac");
+  TESTASSERT(records.size() == N);
+  for (uint32_t i = 0; i < N; i++) {
+    TESTASSERT(records[i].if_idx == i % 2);
+    TESTASSERT(check_record(records[i], i));
+  }
+
+  remove(filename.c_str());
+  return ISRRAN_SUCCESS;
+}
+
+int test_size_rotation()
+{
+  const std::string filename = "pcap_writer_rotation_test.pcap";
+  const uint32_t    N        = 1000;
+
+  pcap_writer_args args = {};
+  args.rotate_size      = 100 * 1024;
+
+  pcap_writer writer(isrlog::fetch_basic_logger("PCAP"));
+  TESTASSERT(writer.open(filename, {{UDP_DLT, "udp"}}, args) == ISRRAN_SUCCESS);
+  write_records(writer, N, 1);
+  writer.close();
+
+  // Each file holds 100 kB at most
+  TESTASSERT(writer.get_nof_files() > 1);
+  TESTASSERT(writer.get_filename(2) == "pcap_writer_rotation_test_2.pcap");
+  uint32_t idx = 0;
+  for (uint32_t f = 0; f < writer.get_nof_files(); f++) {
+    std::string                name = writer.get_filename(f);
+    std::vector<pcap_record_t> records;
+    TESTASSERT(read_file(name).size() <= args.rotate_size);
+    TESTASSERT(parse_pcap(name, UDP_DLT, records));
+    TESTASSERT(not records.empty());
+    for (const pcap_record_t& record : records) {
+      TESTASSERT(check_record(record, idx++));
+    }
+    remove(name.c_str());
+  }
+  TESTASSERT(idx == N);
+
+  return ISRRAN_SUCCESS;
+}
+
+int test_mac_pcap()
+{
+  const std::string filename = "pcap_writer_mac_test.pcap";
+  const uint32_t    N        = 300;
+
+  std::array<uint8_t, 150> pdu = {};
+  pdu[0]                       = 0x21;
+
+  mac_pcap pcap;
+  TESTASSERT(pcap.open(filename) == ISRRAN_SUCCESS);
+  for (uint32_t i = 0; i < N; i++) {
+    pcap.write_ul_crnti(pdu.data(), pdu.size(), 0x46, 0, i % 10240, 0);
+    pcap.write_dl_crnti_nr(pdu.data(), pdu.size(), 0x4601, 0, i % 10240);
+  }
+  TESTASSERT(pcap.close() == ISRRAN_SUCCESS);
+
+  // Records start with a dummy UDP header followed by the start string of the RAT
+  std::vector<pcap_record_t> records;
+  TESTASSERT(parse_pcap(filename, UDP_DLT, records));
+  TESTASSERT(records.size() == 2 * N);
+  uint32_t nof_lte = 0, nof_nr = 0;
+  for (const pcap_record_t& record : records) {
+    std::string start_string((const char*)&record.data[8], 7);
+    nof_lte += (start_string == MAC_LTE_START_STRING) ? 1 : 0;
+    nof_nr += (start_string.compare(0, 6, MAC_NR_START_STRING) == 0) ? 1 : 0;
+    TESTASSERT(std::equal(pdu.begin(), pdu.end(), record.data.end() - pdu.size()));
+  }
+  TESTASSERT(nof_lte == N && nof_nr == N);
+
+  remove(filename.c_str());
+  return ISRRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  isrlog::fetch_basic_logger("PCAP", false).set_level(isrlog::basic_levels::info);
+  isrlog::init();
+
+  TESTASSERT(test_pcap_file(true) == ISRRAN_SUCCESS);
+  TESTASSERT(test_pcap_file(false) == ISRRAN_SUCCESS);
+  TESTASSERT(test_pcapng_file() == ISRRAN_SUCCESS);
+  TESTASSERT(test_size_rotation() == ISRRAN_SUCCESS);
+  TESTASSERT(test_mac_pcap() == ISRRAN_SUCCESS);
+
+  isrlog::flush();
+  return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * S1-U receive benchmark. A local UDP traffic generator sends GTP-U sized datagrams to a socket registered in the
+ * socket_manager, which forwards them to a task queue as the eNB GTP-U does. The single datagram (recvfrom) and the
+ * batched (recvmmsg) handlers are compared in packets/s and CPU time spent per packet by the receive side.
+ */
+
+#include "isrran/common/network_utils.h"
+#include "isrran/common/task_scheduler.h"
+#include <atomic>
+#include <chrono>
+#include <getopt.h>
+#include <sys/resource.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+
+using namespace isrran;
+
+static uint32_t nof_pkts    = 1000000;
+static uint32_t pkt_size    = 100;
+static uint32_t batch_size  = 32;
+static uint32_t server_port = 2152;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [nsbp]\n", prog);
+  printf("\t-n Number of datagrams sent by the traffic generator [Default %d]\n", nof_pkts);
+  printf("\t-s Datagram size in bytes [Default %d]\n", pkt_size);
+  printf("\t-b Maximum number of datagrams per recvmmsg call [Default %d]\n", batch_size);
+  printf("\t-p S1-U port [Default %d]\n", server_port);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nsbp")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_pkts = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 's':
+        pkt_size = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'b':
+        batch_size = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      case 'p':
+        server_port = (uint32_t)strtol(argv[optind], nullptr, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static double thread_cpu_secs()
+{
+  timespec ts = {};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double process_cpu_secs()
+{
+  rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+static void run_bench(const char* name, bool batched)
+{
+  auto& logger = isrlog::fetch_basic_logger("GTPU", false);
+
+  net_utils::socket_type   dgram = net_utils::socket_type::datagram;
+  net_utils::protocol_type udp   = net_utils::protocol_type::UDP;
+  unique_socket            server_socket, client_socket;
+  if (not server_socket.open_socket(net_utils::addr_family::ipv4, dgram, udp) or
+      not server_socket.bind_addr("127.0.0.1", server_port) or
+      not client_socket.open_socket(net_utils::addr_family::ipv4, dgram, udp)) {
+    printf("Error opening sockets\n");
+    exit(-1);
+  }
+  int rcvbuf = 8 * 1024 * 1024;
+  setsockopt(server_socket.fd(), SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+  // Consumer of the GTP-U queue, counting the received PDUs
+  task_scheduler        task_sched;
+  task_queue_handle     queue = task_sched.make_task_queue();
+  std::atomic<uint32_t> nof_rx{0};
+  std::atomic<double>   consumer_cpu{0};
+  std::thread           consumer([&task_sched, &consumer_cpu]() {
+    while (task_sched.run_next_task()) {
+    }
+    consumer_cpu = thread_cpu_secs();
+  });
+
+  socket_manager sockets;
+  auto           rx_callback = [&nof_rx](unique_byte_buffer_t pdu, const sockaddr_in& from) {
+    nof_rx.fetch_add(1, std::memory_order_relaxed);
+  };
+  if (batched) {
+    sockets.add_edge_socket_handler(server_socket.fd(), make_sdu_batch_handler(logger, queue, rx_callback, batch_size));
+  } else {
+    sockets.add_socket_handler(server_socket.fd(), make_sdu_handler(logger, queue, rx_callback));
+  }
+
+  double cpu_start = process_cpu_secs();
+  auto   tstart    = std::chrono::steady_clock::now();
+
+  // Traffic generator
+  std::atomic<double> generator_cpu{0};
+  std::thread         generator([&client_socket, &server_socket, &generator_cpu]() {
+    std::vector<uint8_t> pkt(pkt_size, 0x5a);
+    sockaddr_in          dst = server_socket.get_addr_in();
+    for (uint32_t i = 0; i < nof_pkts; ++i) {
+      sendto(client_socket.fd(), pkt.data(), pkt.size(), 0, (sockaddr*)&dst, sizeof(dst));
+    }
+    generator_cpu = thread_cpu_secs();
+  });
+  generator.join();
+
+  // Wait until the receive side is idle
+  uint32_t last_rx = 0;
+  auto     tend    = std::chrono::steady_clock::now();
+  do {
+    last_rx = nof_rx;
+    tend    = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  } while (nof_rx != last_rx);
+
+  sockets.stop();
+  task_sched.stop();
+  consumer.join();
+
+  double rx_cpu = process_cpu_secs() - cpu_start - generator_cpu - consumer_cpu;
+  double secs   = std::chrono::duration<double>(tend - tstart).count();
+  printf("%-10s rx=%8d (%5.1f%%) %10.0f pkt/s %8.3f us/pkt CPU\n",
+         name,
+         last_rx,
+         100.0 * last_rx / nof_pkts,
+         last_rx / secs,
+         last_rx > 0 ? rx_cpu * 1e6 / last_rx : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  isrlog::init();
+
+  printf("%d datagrams of %d bytes\n", nof_pkts, pkt_size);
+  run_bench("recvfrom", false);
+  run_bench("recvmmsg", true);
+
+  return 0;
+}
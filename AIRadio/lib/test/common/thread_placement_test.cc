@@ -0,0 +1,195 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/adt/pool/fixed_size_pool.h"
+#include "isrran/common/numa.h"
+#include "isrran/common/test_common.h"
+#include "isrran/common/threads.h"
+#include <thread>
+#include <vector>
+
+using namespace isrran;
+
+int test_cpu_list()
+{
+  cpu_set_t cpus;
+  TESTASSERT(numa::parse_cpu_list("0-3,8, 10-11", cpus));
+  TESTASSERT(CPU_COUNT(&cpus) == 7);
+  TESTASSERT(CPU_ISSET(0, &cpus) and CPU_ISSET(3, &cpus) and CPU_ISSET(8, &cpus) and CPU_ISSET(11, &cpus));
+  TESTASSERT(not CPU_ISSET(4, &cpus));
+  TESTASSERT(numa::cpu_list_to_string(cpus) == "0-3,8,10-11");
+
+  TESTASSERT(numa::parse_cpu_list("", cpus));
+  TESTASSERT(CPU_COUNT(&cpus) == 0);
+  TESTASSERT(numa::cpu_list_to_string(cpus).empty());
+
+  TESTASSERT(not numa::parse_cpu_list("a", cpus));
+  TESTASSERT(not numa::parse_cpu_list("3-1", cpus));
+  TESTASSERT(not numa::parse_cpu_list("1-", cpus));
+  TESTASSERT(not numa::parse_cpu_list("2x", cpus));
+  TESTASSERT(not numa::parse_cpu_list("100000", cpus));
+
+  return ISRRAN_SUCCESS;
+}
+
+int test_topology()
+{
+  TESTASSERT(numa::nof_nodes() >= 1);
+  TESTASSERT(numa::current_node() < numa::nof_nodes());
+
+  // Every CPU belongs to the node reported for it
+  for (uint32_t n = 0; n < numa::nof_nodes(); n++) {
+    cpu_set_t cpus = numa::node_cpus(n);
+    for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &cpus)) {
+        TESTASSERT(numa::cpu_node(cpu) == n);
+      }
+    }
+    if (CPU_COUNT(&cpus) > 0) {
+      TESTASSERT(numa::cpu_set_node(cpus) == (int)n);
+    }
+  }
+
+  return ISRRAN_SUCCESS;
+}
+
+class placed_thread : public thread
+{
+public:
+  placed_thread() : thread("PLACED") {}
+
+  int cpu = -1;
+
+protected:
+  void run_thread() override { cpu = sched_getcpu(); }
+};
+
+int test_placement()
+{
+  // Pin the stack role to the last CPU the process may run on
+  cpu_set_t allowed;
+  TESTASSERT(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+  int last_cpu = -1;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &allowed)) {
+      last_cpu = cpu;
+    }
+  }
+  TESTASSERT(last_cpu >= 0);
+
+  thread_placement&       placement = thread_placement::get_instance();
+  thread_placement_args_t args      = {};
+  TESTASSERT(placement.configure(args));
+  TESTASSERT(not placement.is_configured());
+
+  args.stack_cpus = "0-";
+  TESTASSERT(not placement.configure(args));
+  if (sysconf(_SC_NPROCESSORS_CONF) < CPU_SETSIZE) {
+    args.stack_cpus = std::to_string(CPU_SETSIZE - 1);
+    TESTASSERT(not placement.configure(args));
+  }
+
+  args.stack_cpus = std::to_string(last_cpu);
+  TESTASSERT(placement.configure(args));
+  TESTASSERT(placement.is_configured());
+  TESTASSERT(placement.get_node(thread_role::stack) == (int)numa::cpu_node(last_cpu));
+  TESTASSERT(placement.get_node(thread_role::rf) == -1);
+
+  // A thread of the role runs on the configured CPU, a thread without role keeps the inherited affinity
+  placed_thread t;
+  t.set_role(thread_role::stack);
+  t.start();
+  t.wait_thread_finish();
+  TESTASSERT(t.cpu == last_cpu);
+
+  placed_thread t2;
+  t2.start();
+  t2.wait_thread_finish();
+  TESTASSERT(t2.cpu >= 0 and CPU_ISSET(t2.cpu, &allowed));
+
+  // The scoped placement restores the affinity of the calling thread
+  {
+    scoped_thread_placement scoped(thread_role::stack);
+    TESTASSERT(sched_getcpu() == last_cpu);
+  }
+  cpu_set_t restored;
+  TESTASSERT(sched_getaffinity(0, sizeof(restored), &restored) == 0);
+  TESTASSERT(CPU_EQUAL(&restored, &allowed));
+
+  std::string report = placement.get_report();
+  TESTASSERT(report.find("PLACED") != std::string::npos);
+  TESTASSERT(report.find("rf         unpinned") != std::string::npos);
+  printf("%s", report.c_str());
+
+  return ISRRAN_SUCCESS;
+}
+
+int test_numa_pool()
+{
+  // Split the blocks in two arenas, whether or not the system has two nodes
+  numa::set_memory_nodes({0, 1});
+
+  const size_t pool_size = 256;
+  using pool_t           = concurrent_fixed_memory_pool<1024, true>;
+  pool_t* pool           = pool_t::get_instance(pool_size);
+  TESTASSERT(pool->size() == pool_size);
+
+  // All the blocks can be allocated from one thread, using the other arena once the local one is depleted
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < pool_size; ++i) {
+    void* b = pool->allocate_node(1024);
+    TESTASSERT(b != nullptr);
+    blocks.push_back(b);
+  }
+  TESTASSERT(pool->allocate_node(1024) == nullptr);
+
+  // Blocks released in another thread go back to their arenas and can be allocated again
+  std::thread t([pool, &blocks]() {
+    for (void* b : blocks) {
+      pool->deallocate_node(b);
+    }
+  });
+  t.join();
+  blocks.clear();
+  for (size_t i = 0; i < pool_size; ++i) {
+    void* b = pool->allocate_node(1024);
+    TESTASSERT(b != nullptr);
+    blocks.push_back(b);
+  }
+  for (void* b : blocks) {
+    pool->deallocate_node(b);
+  }
+  pool->print_all_buffers();
+
+  numa::set_memory_nodes({});
+  return ISRRAN_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_cpu_list() == ISRRAN_SUCCESS);
+  TESTASSERT(test_topology() == ISRRAN_SUCCESS);
+  TESTASSERT(test_placement() == ISRRAN_SUCCESS);
+  TESTASSERT(test_numa_pool() == ISRRAN_SUCCESS);
+
+  printf("Success\n");
+  return 0;
+}
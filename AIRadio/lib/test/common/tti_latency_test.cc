@@ -0,0 +1,143 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/common/test_common.h"
+#include "isrran/common/tti_latency.h"
+#include <thread>
+#include <vector>
+
+using namespace isrran;
+
+int test_buckets()
+{
+  // Buckets are monotonic and their representative value is within 12.5% of the latencies they hold
+  uint32_t prev = 0;
+  for (uint32_t latency = 0; latency < 1000000; latency++) {
+    uint32_t bucket = tti_latency::latency_to_bucket(latency);
+    TESTASSERT(bucket >= prev);
+    TESTASSERT(bucket < tti_latency::nof_buckets);
+    uint32_t value = tti_latency::bucket_to_latency(bucket);
+    TESTASSERT(value <= latency + latency / 8 + 1 and value + latency / 8 + 1 >= latency);
+    prev = bucket;
+  }
+  TESTASSERT(tti_latency::latency_to_bucket(UINT32_MAX) == tti_latency::nof_buckets - 1);
+
+  return ISRRAN_SUCCESS;
+}
+
+int test_percentiles()
+{
+  tti_latency           latency(3000);
+  tti_latency_metrics_t metrics = {};
+
+  // Nothing recorded
+  latency.get_metrics(metrics);
+  TESTASSERT(metrics.deadline_us == 3000);
+  TESTASSERT(metrics[tti_stage::rf_tx].nof_samples == 0);
+
+  // Stages of unknown TTIs are ignored
+  latency.record(tti_stage::rf_rx, 1);
+  latency.tti_start(2);
+  latency.record(tti_stage::rf_rx, 2 + 64);
+  latency.get_metrics(metrics);
+  TESTASSERT(metrics[tti_stage::rf_rx].nof_samples == 0);
+
+  // The stages complete right after the TTI start
+  for (uint32_t tti = 0; tti < 1000; tti++) {
+    latency.tti_start(tti);
+    latency.record(tti_stage::rf_rx, tti);
+    latency.record(tti_stage::rf_tx, tti);
+  }
+  // A late TTI, beyond the p99.9
+  latency.tti_start(1000);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  latency.record(tti_stage::rf_tx, 1000);
+
+  latency.get_metrics(metrics);
+  TESTASSERT(metrics[tti_stage::rf_rx].nof_samples == 1000);
+  TESTASSERT(metrics[tti_stage::rf_rx].nof_deadline_misses == 0);
+  TESTASSERT(metrics[tti_stage::rf_tx].nof_samples == 1001);
+  TESTASSERT(metrics[tti_stage::rf_tx].nof_deadline_misses == 1);
+  TESTASSERT(metrics[tti_stage::rf_tx].p50_us < 1000);
+  TESTASSERT(metrics[tti_stage::rf_tx].p999_us < 1000);
+  TESTASSERT(metrics[tti_stage::rf_tx].max_us >= 5000 * 7 / 8);
+  TESTASSERT(metrics[tti_stage::ul_decode].nof_samples == 0);
+
+  // The statistics cover the period since the previous call
+  latency.get_metrics(metrics);
+  TESTASSERT(metrics[tti_stage::rf_tx].nof_samples == 0);
+  TESTASSERT(metrics[tti_stage::rf_tx].nof_deadline_misses == 0);
+  TESTASSERT(metrics[tti_stage::rf_tx].max_us == 0);
+
+  return ISRRAN_SUCCESS;
+}
+
+int test_concurrent_threads()
+{
+  const uint32_t nof_threads = 8, nof_ttis = 10000;
+
+  tti_latency latency(3000);
+  for (uint32_t tti = 0; tti < 64; tti++) {
+    latency.tti_start(tti);
+  }
+
+  // Worker threads record while the metrics are read
+  std::atomic<bool> running = {true};
+  uint64_t          total   = 0;
+  std::thread       reader([&]() {
+    tti_latency_metrics_t metrics = {};
+    while (running) {
+      latency.get_metrics(metrics);
+      total += metrics[tti_stage::dl_encode].nof_samples;
+    }
+  });
+
+  std::vector<std::thread> workers;
+  for (uint32_t t = 0; t < nof_threads; t++) {
+    workers.emplace_back([&latency]() {
+      for (uint32_t i = 0; i < nof_ttis; i++) {
+        latency.record(tti_stage::dl_encode, i % 64);
+      }
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+  running = false;
+  reader.join();
+
+  tti_latency_metrics_t metrics = {};
+  latency.get_metrics(metrics);
+  total += metrics[tti_stage::dl_encode].nof_samples;
+  TESTASSERT(total == nof_threads * nof_ttis);
+
+  return ISRRAN_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_buckets() == ISRRAN_SUCCESS);
+  TESTASSERT(test_percentiles() == ISRRAN_SUCCESS);
+  TESTASSERT(test_concurrent_threads() == ISRRAN_SUCCESS);
+
+  printf("Success\n");
+  return 0;
+}
@@ -20,7 +20,10 @@
  */
 
 #include "isrran/isrlog/isrlog.h"
+#include <algorithm>
 #include <atomic>
+#include <cstdlib>
+#include <numeric>
 #include <sys/resource.h>
 #include <thread>
 
@@ -68,32 +71,59 @@ static void busy_wait(std::chrono::milliseconds interval)
   }
 }
 
+/// Results collected by each thread of the benchmark.
+struct thread_results {
+  /// Average time per log call of each burst of entries.
+  std::vector<uint64_t> burst;
+  /// Time taken by each individual log call.
+  std::vector<uint64_t> single;
+};
+
 /// Worker function used for each thread of the benchmark to generate and measure the time taken for each log entry.
-static void run_thread(log_channel& c, std::vector<uint64_t>& results, std::atomic<unsigned>& ctx_counter)
+static void run_thread(log_channel& c, thread_results& results, std::atomic<unsigned>& ctx_counter)
 {
   for (unsigned iter = 0; iter != num_iterations; ++iter) {
     context_switch_checker ctx_checker(ctx_counter);
 
     auto begin = std::chrono::steady_clock::now();
+    auto last  = begin;
     for (unsigned entry_num = 0; entry_num != num_entries_per_iter; ++entry_num) {
       double d = entry_num;
       c("ISRLOG latency benchmark: int: %u, double: %f, string: %s", iter, d, "test");
+
+      auto now = std::chrono::steady_clock::now();
+      results.single.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+      last = now;
     }
-    auto end = std::chrono::steady_clock::now();
 
-    results.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / num_entries_per_iter);
+    results.burst.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(last - begin).count() /
+                            num_entries_per_iter);
 
     busy_wait(std::chrono::milliseconds(4));
   }
 }
 
+/// Sorts the input samples and prints their percentiles.
+static void print_percentiles(const char* label, std::vector<uint64_t>& results)
+{
+  std::sort(results.begin(), results.end());
+  fmt::print("{:<13}|{:6}|{:6}|{:6}|{:6}|{:8}|{:7}|\n",
+             label,
+             results[static_cast<size_t>(results.size() * 0.5)],
+             results[static_cast<size_t>(results.size() * 0.75)],
+             results[static_cast<size_t>(results.size() * 0.9)],
+             results[static_cast<size_t>(results.size() * 0.99)],
+             results[static_cast<size_t>(results.size() * 0.999)],
+             results.back());
+}
+
 /// This function runs the latency benchmark generating log entries using the specified number of threads.
 static void benchmark(unsigned num_threads)
 {
-  std::vector<std::vector<uint64_t> > thread_results;
-  thread_results.resize(num_threads);
-  for (auto& v : thread_results) {
-    v.reserve(num_iterations);
+  std::vector<thread_results> results_per_thread(num_threads);
+  for (auto& r : results_per_thread) {
+    r.burst.reserve(num_iterations);
+    r.single.reserve(num_iterations * num_entries_per_iter);
   }
 
   auto& s       = isrlog::fetch_file_sink("isrlog_latency_benchmark.txt");
@@ -106,39 +136,55 @@ static void benchmark(unsigned num_threads)
 
   std::atomic<unsigned> ctx_counter(0);
   for (unsigned i = 0; i != num_threads; ++i) {
-    workers.emplace_back(run_thread, std::ref(channel), std::ref(thread_results[i]), std::ref(ctx_counter));
+    workers.emplace_back(run_thread, std::ref(channel), std::ref(results_per_thread[i]), std::ref(ctx_counter));
   }
   for (auto& w : workers) {
     w.join();
   }
 
-  std::vector<uint64_t> results;
-  results.reserve(num_threads * num_iterations);
-  for (const auto& v : thread_results) {
-    results.insert(results.end(), v.begin(), v.end());
+  std::vector<uint64_t> burst;
+  std::vector<uint64_t> single;
+  burst.reserve(num_threads * num_iterations);
+  single.reserve(num_threads * num_iterations * num_entries_per_iter);
+  for (const auto& r : results_per_thread) {
+    burst.insert(burst.end(), r.burst.begin(), r.burst.end());
+    single.insert(single.end(), r.single.begin(), r.single.end());
   }
-  std::sort(results.begin(), results.end());
+  uint64_t total = std::accumulate(single.begin(), single.end(), uint64_t(0));
 
   fmt::print("ISRLOG Frontend Latency Benchmark - logging with {} thread{}\n"
              "All values in nanoseconds\n"
-             "Percentiles: | 50th | 75th | 90th | 99th | 99.9th | Worst |\n"
-             "             |{:6}|{:6}|{:6}|{:6}|{:8}|{:7}|\n"
-             "Context switches: {} in {} of generated entries\n\n",
+             "Percentiles: | 50th | 75th | 90th | 99th | 99.9th | Worst |\n",
              num_threads,
-             (num_threads > 1) ? "s" : "",
-             results[static_cast<size_t>(results.size() * 0.5)],
-             results[static_cast<size_t>(results.size() * 0.75)],
-             results[static_cast<size_t>(results.size() * 0.9)],
-             results[static_cast<size_t>(results.size() * 0.99)],
-             results[static_cast<size_t>(results.size() * 0.999)],
-             results.back(),
+             (num_threads > 1) ? "s" : "");
+  print_percentiles("  Burst avg  ", burst);
+  print_percentiles("  Single call", single);
+  fmt::print("Mean: {:.1f} ns per log call\n"
+             "Context switches: {} in {} of generated entries\n\n",
+             double(total) / single.size(),
              ctx_counter,
              num_threads * num_iterations * num_entries_per_iter);
+
+  // Let the backend drain the entries of this run before starting the next one.
+  isrlog::flush();
 }
 
-int main()
+/// Runs the benchmark for each number of concurrent producer threads given in the command line, e.g.
+/// "isrlog_frontend_latency 1 2 4 8". Defaults to 1, 2 and 4 threads.
+int main(int argc, char** argv)
 {
-  for (auto n : {1, 2, 4}) {
+  std::vector<unsigned> nof_threads;
+  for (int i = 1; i < argc; ++i) {
+    unsigned n = std::strtoul(argv[i], nullptr, 10);
+    if (n) {
+      nof_threads.push_back(n);
+    }
+  }
+  if (nof_threads.empty()) {
+    nof_threads = {1, 2, 4};
+  }
+
+  for (auto n : nof_threads) {
     benchmark(n);
   }
 
@@ -0,0 +1,201 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "src/isrlog/formatters/binary_formatter.h"
+#include "src/isrlog/formatters/binary_log_decoder.h"
+#include "isrran/isrlog/detail/log_entry_metadata.h"
+#include "testing_helpers.h"
+#include <cstring>
+#include <numeric>
+
+using namespace isrlog;
+
+/// Helper to build a log entry.
+static detail::log_entry_metadata build_log_entry_metadata(const char*                                         fmtstring,
+                                                           fmt::dynamic_format_arg_store<fmt::printf_context>* store)
+{
+  // Create a time point 50000us from epoch.
+  using tp_ty = std::chrono::time_point<std::chrono::high_resolution_clock>;
+  tp_ty tp(std::chrono::microseconds(50000));
+
+  return {tp, {10, true}, fmtstring, store, "ABC", 'Z'};
+}
+
+/// Decodes the input binary stream into text.
+static std::string decode_to_text(const fmt::memory_buffer& input)
+{
+  binary_log_decoder decoder(std::unique_ptr<log_formatter>(new text_formatter));
+  std::string        result;
+  auto               err = decoder.decode(detail::memory_buffer(input.data(), input.size()),
+                            [&result](const fmt::memory_buffer& out) { result.append(out.data(), out.size()); });
+  if (err) {
+    return err.get_error();
+  }
+  return result;
+}
+
+static bool when_entry_is_decoded_then_output_matches_text_formatter()
+{
+  const char* fmtstring = "int: %d, hex: %x, ll: %lld, u: %u, dbl: %.3f, chr: %c, str: %s, cstr: %s, ptr: %p";
+
+  fmt::dynamic_format_arg_store<fmt::printf_context> store;
+  store.push_back(-5);
+  store.push_back(-1);
+  store.push_back(-1234567890123LL);
+  store.push_back(4000000000u);
+  store.push_back(3.14159);
+  store.push_back('x');
+  store.push_back(std::string("hello"));
+  store.push_back("world");
+  store.push_back(reinterpret_cast<const void*>(0x1234));
+
+  auto entry = build_log_entry_metadata(fmtstring, &store);
+  entry.hex_dump.resize(20);
+  std::iota(entry.hex_dump.begin(), entry.hex_dump.end(), 0);
+  auto entry_copy = entry;
+
+  fmt::memory_buffer expected;
+  text_formatter{}.format(std::move(entry_copy), expected);
+
+  fmt::memory_buffer binary;
+  binary_formatter{}.format(std::move(entry), binary);
+
+  ASSERT_EQ(decode_to_text(binary), fmt::to_string(expected));
+
+  return true;
+}
+
+static bool when_entry_has_no_arguments_or_optional_fields_then_decoding_matches()
+{
+  auto entry            = build_log_entry_metadata("Text without arguments %d", nullptr);
+  entry.log_name        = "";
+  entry.log_tag         = '\0';
+  entry.context.enabled = false;
+  auto entry_copy       = entry;
+
+  fmt::memory_buffer expected;
+  text_formatter{}.format(std::move(entry_copy), expected);
+
+  fmt::memory_buffer binary;
+  binary_formatter{}.format(std::move(entry), binary);
+
+  ASSERT_EQ(decode_to_text(binary), fmt::to_string(expected));
+
+  return true;
+}
+
+static bool when_format_string_is_repeated_then_it_is_only_defined_once()
+{
+  binary_formatter   formatter;
+  fmt::memory_buffer binary;
+
+  fmt::dynamic_format_arg_store<fmt::printf_context> store;
+  store.push_back(1);
+  formatter.format(build_log_entry_metadata("Value %d", &store), binary);
+  size_t first_size = binary.size();
+  formatter.format(build_log_entry_metadata("Value %d", &store), binary);
+  size_t second_size = binary.size() - first_size;
+
+  // The second entry reuses the format string and channel name definitions.
+  ASSERT_EQ(second_size < first_size, true);
+  ASSERT_EQ(decode_to_text(binary),
+            std::string("1970-01-01T00:00:00.050000 [ABC    ] [Z] [   10] Value 1\n"
+                        "1970-01-01T00:00:00.050000 [ABC    ] [Z] [   10] Value 1\n"));
+
+  return true;
+}
+
+static bool when_format_string_memory_is_reused_then_new_contents_are_decoded()
+{
+  binary_formatter   formatter;
+  fmt::memory_buffer binary;
+
+  char fmtstring[16];
+  std::strcpy(fmtstring, "First");
+  formatter.format(build_log_entry_metadata(fmtstring, nullptr), binary);
+  std::strcpy(fmtstring, "Second");
+  formatter.format(build_log_entry_metadata(fmtstring, nullptr), binary);
+
+  ASSERT_EQ(decode_to_text(binary),
+            std::string("1970-01-01T00:00:00.050000 [ABC    ] [Z] [   10] First\n"
+                        "1970-01-01T00:00:00.050000 [ABC    ] [Z] [   10] Second\n"));
+
+  return true;
+}
+
+namespace {
+DECLARE_METRIC("SNR", snr_t, float, "dB");
+DECLARE_METRIC_SET("RF", rf_set, snr_t);
+using ctx_t = isrlog::build_context_type<rf_set>;
+} // namespace
+
+static bool when_context_is_formatted_then_it_is_decoded_as_text()
+{
+  ctx_t ctx("Context");
+  ctx.get<rf_set>().write<snr_t>(5.5);
+
+  fmt::dynamic_format_arg_store<fmt::printf_context> store;
+  store.push_back(88);
+
+  fmt::memory_buffer expected;
+  text_formatter{}.format_ctx(ctx, build_log_entry_metadata("Text %d", &store), expected);
+
+  fmt::memory_buffer binary;
+  binary_formatter{}.format_ctx(ctx, build_log_entry_metadata("Text %d", &store), binary);
+
+  ASSERT_EQ(decode_to_text(binary), fmt::to_string(expected));
+
+  return true;
+}
+
+static bool when_stream_is_truncated_then_complete_records_are_decoded()
+{
+  binary_formatter   formatter;
+  fmt::memory_buffer binary;
+
+  formatter.format(build_log_entry_metadata("First", nullptr), binary);
+  size_t first_size = binary.size();
+  formatter.format(build_log_entry_metadata("Second", nullptr), binary);
+
+  binary_log_decoder decoder(std::unique_ptr<log_formatter>(new text_formatter));
+  std::string        result;
+  auto               err = decoder.decode(detail::memory_buffer(binary.data(), first_size + 3),
+                            [&result](const fmt::memory_buffer& out) { result.append(out.data(), out.size()); });
+
+  ASSERT_EQ(bool(err), false);
+  ASSERT_EQ(result, std::string("1970-01-01T00:00:00.050000 [ABC    ] [Z] [   10] First\n"));
+  ASSERT_EQ(decoder.get_nof_entries(), 1);
+  ASSERT_EQ(decoder.get_nof_truncated_bytes() > 0, true);
+
+  return true;
+}
+
+int main()
+{
+  TEST_FUNCTION(when_entry_is_decoded_then_output_matches_text_formatter);
+  TEST_FUNCTION(when_entry_has_no_arguments_or_optional_fields_then_decoding_matches);
+  TEST_FUNCTION(when_format_string_is_repeated_then_it_is_only_defined_once);
+  TEST_FUNCTION(when_format_string_memory_is_reused_then_new_contents_are_decoded);
+  TEST_FUNCTION(when_context_is_formatted_then_it_is_decoded_as_text);
+  TEST_FUNCTION(when_stream_is_truncated_then_complete_records_are_decoded);
+
+  return 0;
+}
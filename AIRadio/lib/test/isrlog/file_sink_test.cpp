@@ -21,6 +21,7 @@
 
 #include "file_test_utils.h"
 #include "src/isrlog/sinks/file_sink.h"
+#include "src/isrlog/sinks/mmap_file_sink.h"
 #include "test_dummies.h"
 #include "testing_helpers.h"
 
@@ -107,10 +108,34 @@ static bool when_data_written_exceeds_size_threshold_then_new_file_is_created()
   return true;
 }
 
+static bool when_data_is_written_to_mmap_file_then_contents_are_valid()
+{
+  file_test_utils::scoped_file_deleter deleter(log_filename);
+
+  std::vector<std::string> entries;
+  {
+    // Use a small chunk size so that the file has to grow several times.
+    mmap_file_sink file(log_filename, 4096, std::unique_ptr<log_formatter>(new test_dummies::log_formatter_dummy));
+    for (unsigned i = 0; i != 1000; ++i) {
+      std::string entry = "Test log entry - " + std::to_string(i) + '\n';
+      file.write(detail::memory_buffer(entry));
+      entries.push_back(entry);
+    }
+    file.flush();
+  }
+
+  // The file gets trimmed to the written size when the sink is destroyed.
+  ASSERT_EQ(file_test_utils::file_exists(log_filename), true);
+  ASSERT_EQ(file_test_utils::compare_file_contents(log_filename, entries), true);
+
+  return true;
+}
+
 int main()
 {
   TEST_FUNCTION(when_data_is_written_to_file_then_contents_are_valid);
   TEST_FUNCTION(when_data_written_exceeds_size_threshold_then_new_file_is_created);
+  TEST_FUNCTION(when_data_is_written_to_mmap_file_then_contents_are_valid);
 
   return 0;
 }
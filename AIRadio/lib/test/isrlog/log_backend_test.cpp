@@ -22,6 +22,7 @@
 #include "src/isrlog/log_backend_impl.h"
 #include "test_dummies.h"
 #include "testing_helpers.h"
+#include <thread>
 
 using namespace isrlog;
 
@@ -233,6 +234,46 @@ static bool when_empty_handler_is_used_then_backend_does_not_crash()
   return true;
 }
 
+static bool when_entries_are_pushed_from_several_threads_then_they_are_processed_in_timestamp_order()
+{
+  test_dummies::sink_dummy s;
+  log_backend_impl         backend;
+
+  constexpr unsigned nof_threads = 4;
+  constexpr unsigned nof_entries = 100;
+
+  std::vector<int64_t>     processed;
+  std::vector<std::thread> producers;
+  // Entries are pushed before starting the backend so that every thread queue holds a full interleaved sequence.
+  for (unsigned i = 0; i != nof_threads; ++i) {
+    producers.emplace_back([&backend, &s, &processed, i]() {
+      for (unsigned j = 0; j != nof_entries; ++j) {
+        auto entry        = build_log_entry(&s, backend.alloc_arg_store());
+        entry.metadata.tp = decltype(entry.metadata.tp)(std::chrono::microseconds(j * nof_threads + i));
+        entry.format_func = [&processed](detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) {
+          auto us = std::chrono::duration_cast<std::chrono::microseconds>(metadata.tp.time_since_epoch());
+          processed.push_back(us.count());
+        };
+        backend.push(std::move(entry));
+      }
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+
+  backend.start();
+  // Stop the backend to ensure the entries have been processed.
+  backend.stop();
+
+  ASSERT_EQ(processed.size(), nof_threads * nof_entries);
+  for (unsigned i = 0; i != processed.size(); ++i) {
+    ASSERT_EQ(processed[i], int64_t(i));
+  }
+
+  return true;
+}
+
 int main()
 {
   TEST_FUNCTION(when_backend_is_started_then_is_started_returns_true);
@@ -243,6 +284,7 @@ int main()
   TEST_FUNCTION(when_sink_write_fails_then_error_handler_is_invoked);
   TEST_FUNCTION(when_handler_is_set_after_start_then_handler_is_not_used);
   TEST_FUNCTION(when_empty_handler_is_used_then_backend_does_not_crash);
+  TEST_FUNCTION(when_entries_are_pushed_from_several_threads_then_they_are_processed_in_timestamp_order);
 
   return 0;
 }
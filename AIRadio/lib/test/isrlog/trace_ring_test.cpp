@@ -0,0 +1,104 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "isrran/isrlog/trace_ring.h"
+#include "file_test_utils.h"
+#include "testing_helpers.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace isrlog;
+
+static constexpr char trace_filename[] = "trace_ring_test.json";
+
+/// Returns the contents of the specified file.
+static std::string read_file(const std::string& path)
+{
+  std::ifstream     file(path);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+/// Returns the number of occurrences of str in text.
+static unsigned count_occurrences(const std::string& text, const std::string& str)
+{
+  unsigned count = 0;
+  for (size_t pos = text.find(str); pos != std::string::npos; pos = text.find(str, pos + str.size())) {
+    ++count;
+  }
+  return count;
+}
+
+static bool when_tracing_is_disabled_then_no_events_are_recorded()
+{
+  ASSERT_EQ(trace_ring_is_enabled(), false);
+  {
+    trace_ring_event("test", "disabled", 0);
+  }
+  ASSERT_EQ(trace_ring_dump(trace_filename), false);
+
+  return true;
+}
+
+static bool when_events_are_recorded_then_dump_holds_them()
+{
+  file_test_utils::scoped_file_deleter deleter(trace_filename);
+
+  // Rings of 8 events.
+  trace_ring_init(8);
+
+  std::thread t([]() {
+    ::pthread_setname_np(::pthread_self(), "TRACE_TEST");
+    trace_ring_event("test", "other_thread", 7);
+  });
+  t.join();
+
+  // Record 5 pairs of events plus an instant one: the dump skips the slot that may be under write, so only the last 7
+  // events of the ring are kept.
+  for (uint32_t i = 0; i != 5; ++i) {
+    trace_ring_event("test", "scoped", i);
+  }
+  trace_ring_instant("test", "instant", 42);
+
+  ASSERT_EQ(trace_ring_dump(trace_filename), true);
+
+  std::string json = read_file(trace_filename);
+  ASSERT_EQ(json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), size_t(0));
+  ASSERT_EQ(count_occurrences(json, "\"name\":\"other_thread\""), 2);
+  ASSERT_EQ(count_occurrences(json, "\"name\":\"TRACE_TEST\""), 1);
+  ASSERT_EQ(count_occurrences(json, "\"name\":\"scoped\""), 6);
+  ASSERT_EQ(count_occurrences(json, "\"args\":{\"arg\":1}"), 0);
+  ASSERT_EQ(count_occurrences(json, "\"args\":{\"arg\":2}"), 2);
+  ASSERT_EQ(count_occurrences(json, "\"name\":\"instant\",\"cat\":\"test\",\"ph\":\"i\""), 1);
+  ASSERT_EQ(count_occurrences(json, "\"args\":{\"arg\":42}"), 1);
+
+  return true;
+}
+
+int main()
+{
+  TEST_FUNCTION(when_tracing_is_disabled_then_no_events_are_recorded);
+  TEST_FUNCTION(when_events_are_recorded_then_dump_holds_them);
+
+  return 0;
+}
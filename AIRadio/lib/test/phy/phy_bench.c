@@ -0,0 +1,940 @@
+/**
+ * Copyright 2013-2022 iSignal Research Labs Pvt Ltd.
+ *
+ * This file is part of isrRAN.
+ *
+ * isrRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * isrRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Multi-UE PHY throughput benchmark. Every slot the PRBs of the carrier are split among the UEs with random weights
+ * and each UE gets a random MCS. The data channels of both directions are processed end to end:
+ *
+ *   DL: enb_dl / gnb_dl -> channel -> ue_dl / ue_dl_nr
+ *   UL: ue_ul / ue_ul_nr (one per UE, added up) -> channel -> enb_ul / gnb_ul
+ *
+ * The grants are known by both ends, control channels are not transmitted. The slots are distributed among the
+ * worker threads, each with its own PHY objects. The CPU time of the stages (transmitter encode, receiver FFT and
+ * channel estimation, receiver decode) is measured per thread and reported, together with the BLER and throughput,
+ * as a JSON object.
+ */
+
+#include "isrran/isrran.h"
+#include "isrran/phy/channel/ch_awgn.h"
+#include "isrran/phy/gnb/gnb_dl.h"
+#include "isrran/phy/gnb/gnb_ul.h"
+#include "isrran/phy/phch/ra_nr.h"
+#include "isrran/phy/phch/ra_ul_nr.h"
+#include "isrran/phy/ue/ue_dl_nr.h"
+#include "isrran/phy/ue/ue_ul_nr.h"
+#include "isrran/phy/utils/debug.h"
+#include "isrran/phy/utils/random.h"
+#include "isrran/phy/utils/vector.h"
+#include <getopt.h>
+#include <pthread.h>
+#include <time.h>
+
+#define BENCH_MAX_UES 32
+#define BENCH_MAX_TB_BYTES (ISRRAN_SLOT_MAX_NOF_BITS_NR / 8)
+#define BENCH_RNTI 0x4601
+#define BENCH_LTE_CFI 2
+
+typedef enum { BENCH_STAGE_ENCODE = 0, BENCH_STAGE_FFT, BENCH_STAGE_DECODE, BENCH_NOF_STAGES } bench_stage_t;
+
+static const char* bench_stage_names[BENCH_NOF_STAGES] = {"tx_encode", "rx_fft_estimate", "rx_decode"};
+
+typedef struct {
+  uint64_t nof_slots;
+  uint64_t nof_tb;
+  uint64_t nof_tb_errors;
+  uint64_t nof_bits;
+  uint64_t nof_bits_ok;
+  uint64_t cpu_ns[BENCH_NOF_STAGES];
+} bench_stats_t;
+
+typedef struct {
+  uint32_t start;
+  uint32_t len;
+  uint32_t mcs;
+} bench_grant_t;
+
+typedef struct {
+  uint32_t        id;
+  uint32_t        slot_begin;
+  uint32_t        slot_end;
+  isrran_random_t random;
+
+  isrran_channel_awgn_t awgn;
+  cf_t*                 tx_buffer[ISRRAN_MAX_PORTS];
+  cf_t*                 rx_buffer[ISRRAN_MAX_PORTS];
+  cf_t*                 ue_ul_buffer;
+
+  uint8_t*               data_tx[BENCH_MAX_UES];
+  uint8_t*               data_rx[BENCH_MAX_UES];
+  isrran_softbuffer_tx_t softbuffer_tx[BENCH_MAX_UES];
+  isrran_softbuffer_rx_t softbuffer_rx[BENCH_MAX_UES];
+
+  // LTE
+  isrran_enb_dl_t enb_dl;
+  isrran_ue_dl_t  ue_dl;
+  isrran_ue_ul_t  ue_ul;
+  isrran_enb_ul_t enb_ul;
+
+  // NR
+  isrran_gnb_dl_t   gnb_dl;
+  isrran_ue_dl_nr_t ue_dl_nr;
+  isrran_ue_ul_nr_t ue_ul_nr;
+  isrran_gnb_ul_t   gnb_ul;
+
+  bench_stats_t dl;
+  bench_stats_t ul;
+  int           ret;
+} bench_worker_t;
+
+static bool        is_nr       = true;
+static bool        run_dl      = true;
+static bool        run_ul      = true;
+static uint32_t    nof_prb     = 0; // Set to 0 for the RAT default
+static uint32_t    nof_ues     = 4;
+static uint32_t    mcs_min     = 0;
+static uint32_t    mcs_max     = 27;
+static uint32_t    nof_threads = 1;
+static uint32_t    nof_slots   = 100;
+static float       snr_db      = NAN; // SNR in dB, NAN for no noise
+static uint32_t    seed        = 0;
+static const char* output_file = NULL;
+
+static isrran_cell_t cell = {.nof_prb         = 50,
+                             .nof_ports       = 1,
+                             .id              = 1,
+                             .cp              = ISRRAN_CP_NORM,
+                             .phich_resources = ISRRAN_PHICH_R_1,
+                             .phich_length    = ISRRAN_PHICH_NORM};
+
+static isrran_carrier_nr_t carrier = ISRRAN_DEFAULT_CARRIER_NR;
+
+// No group nor sequence hopping, cyclic shift 0
+static isrran_refsignal_dmrs_pusch_cfg_t dmrs_pusch_cfg = {};
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [RdPumMtnsSov]\n", prog);
+  printf("\t-R Radio access technology (lte, nr) [Default %s]\n", is_nr ? "nr" : "lte");
+  printf("\t-d Direction (dl, ul, both) [Default both]\n");
+  printf("\t-P Number of carrier PRB, 0 for 50 (LTE) or 52 (NR) [Default %d]\n", nof_prb);
+  printf("\t-u Number of UEs scheduled every slot [Default %d]\n", nof_ues);
+  printf("\t-m Minimum MCS [Default %d]\n", mcs_min);
+  printf("\t-M Maximum MCS [Default %d]\n", mcs_max);
+  printf("\t-t Number of worker threads [Default %d]\n", nof_threads);
+  printf("\t-n Number of slots [Default %d]\n", nof_slots);
+  printf("\t-s SNR in dB, no noise if not provided\n");
+  printf("\t-S Random seed [Default %d]\n", seed);
+  printf("\t-o JSON report file [Default stdout]\n");
+  printf("\t-v [set isrran_verbose to debug, default none]\n");
+}
+
+static int parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "RdPumMtnsSov")) != -1) {
+    switch (opt) {
+      case 'R':
+        is_nr = strcmp(argv[optind], "lte") != 0;
+        break;
+      case 'd':
+        run_dl = strcmp(argv[optind], "ul") != 0;
+        run_ul = strcmp(argv[optind], "dl") != 0;
+        break;
+      case 'P':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'u':
+        nof_ues = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        mcs_min = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'M':
+        mcs_max = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 't':
+        nof_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_slots = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'S':
+        seed = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'o':
+        output_file = argv[optind];
+        break;
+      case 'v':
+        increase_isrran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        return ISRRAN_ERROR;
+    }
+  }
+
+  if (nof_prb == 0) {
+    nof_prb = is_nr ? 52 : 50;
+  }
+  if (nof_ues == 0 || nof_ues > BENCH_MAX_UES || nof_ues > nof_prb) {
+    ERROR("Invalid number of UEs (%d), it must be between 1 and %d", nof_ues, ISRRAN_MIN(BENCH_MAX_UES, nof_prb));
+    return ISRRAN_ERROR;
+  }
+  if (mcs_min > mcs_max || mcs_max > 28) {
+    ERROR("Invalid MCS range [%d, %d]", mcs_min, mcs_max);
+    return ISRRAN_ERROR;
+  }
+  if (nof_threads == 0) {
+    nof_threads = 1;
+  }
+
+  return ISRRAN_SUCCESS;
+}
+
+static uint64_t thread_cpu_ns(void)
+{
+  struct timespec ts = {};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t buffer_len(void)
+{
+  return is_nr ? ISRRAN_SF_LEN_PRB_NR(nof_prb) : ISRRAN_SF_LEN_PRB(nof_prb);
+}
+
+/*
+ * Splits the carrier PRB among the UEs in contiguous chunks proportional to random weights. Every UE gets at least one
+ * PRB. LTE PUSCH allocations are shrunk to the closest valid DFT precoding size.
+ */
+static void gen_grants(bench_worker_t* w, bool is_ul, bench_grant_t grants[BENCH_MAX_UES])
+{
+  uint32_t weights[BENCH_MAX_UES] = {};
+  uint32_t total                  = 0;
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    weights[u] = (uint32_t)isrran_random_uniform_int_dist(w->random, 1, 4);
+    total += weights[u];
+  }
+
+  uint32_t start = 0;
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    uint32_t remaining = nof_prb - start - (nof_ues - u - 1);
+    uint32_t len       = (u == nof_ues - 1) ? remaining : (nof_prb * weights[u]) / total;
+    len                = ISRRAN_MAX(1, ISRRAN_MIN(len, remaining));
+
+    grants[u].start = start;
+    grants[u].len   = len;
+    grants[u].mcs   = (uint32_t)isrran_random_uniform_int_dist(w->random, (int)mcs_min, (int)mcs_max);
+    start += len;
+
+    if (is_ul && !is_nr) {
+      while (grants[u].len > 1 && !isrran_dft_precoding_valid_prb(grants[u].len)) {
+        grants[u].len--;
+      }
+    }
+  }
+}
+
+static void run_channel(bench_worker_t* w)
+{
+  uint32_t len = buffer_len();
+  if (!isnan(snr_db)) {
+    float n0_dBfs = isrran_convert_power_to_dB(isrran_vec_avg_power_cf(w->tx_buffer[0], len)) - snr_db;
+    isrran_channel_awgn_set_n0(&w->awgn, n0_dBfs);
+    isrran_channel_awgn_run_c(&w->awgn, w->tx_buffer[0], w->rx_buffer[0], len);
+  } else {
+    isrran_vec_cf_copy(w->rx_buffer[0], w->tx_buffer[0], len);
+  }
+}
+
+static void check_tb(bench_stats_t* stats, bench_worker_t* w, uint32_t ue, uint32_t tbs, bool crc)
+{
+  stats->nof_tb++;
+  stats->nof_bits += tbs;
+  if (crc && memcmp(w->data_tx[ue], w->data_rx[ue], tbs / 8) == 0) {
+    stats->nof_bits_ok += tbs;
+  } else {
+    stats->nof_tb_errors++;
+    INFO("Worker %d: UE %d failed to decode TB of %d bits", w->id, ue, tbs);
+  }
+}
+
+static void stage_end(bench_stats_t* stats, bench_stage_t stage, uint64_t* t)
+{
+  uint64_t now = thread_cpu_ns();
+  stats->cpu_ns[stage] += now - *t;
+  *t = now;
+}
+
+/*
+ * LTE grants do not limit the code rate, the maximum of 0.93 (TS 36.213 7.1.7) is applied here as a scheduler would
+ */
+static bool lte_code_rate_valid(const isrran_ra_tb_t* tb)
+{
+  return tb->tbs + 24 <= 0.93f * tb->nof_bits;
+}
+
+static int bench_dl_lte(bench_worker_t* w, uint32_t slot)
+{
+  bench_grant_t grants[BENCH_MAX_UES] = {};
+  gen_grants(w, false, grants);
+
+  isrran_dl_sf_cfg_t dl_sf = {};
+  dl_sf.tti                = slot % 10240;
+  dl_sf.cfi                = BENCH_LTE_CFI;
+  dl_sf.sf_type            = ISRRAN_SF_NORM;
+
+  isrran_pdsch_cfg_t pdsch_cfg[BENCH_MAX_UES] = {};
+  uint64_t           t                        = thread_cpu_ns();
+
+  isrran_enb_dl_put_base(&w->enb_dl, &dl_sf);
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    isrran_dci_dl_t dci = {};
+    dci.rnti            = BENCH_RNTI + u;
+    dci.format          = ISRRAN_DCI_FORMAT1A;
+    dci.alloc_type      = ISRRAN_RA_ALLOC_TYPE2;
+    dci.type2_alloc.riv = isrran_ra_type2_to_riv(grants[u].len, grants[u].start, nof_prb);
+    dci.tb[0].rv        = 0;
+    dci.tb[0].ndi       = 0;
+    dci.tb[0].cw_idx    = 0;
+    dci.tb[1].mcs_idx   = 0;
+    dci.tb[1].rv        = 1;
+
+    // Small allocations with high MCS exceed the maximum code rate, step down the MCS until the grant is valid
+    isrran_pdsch_grant_t* grant = &pdsch_cfg[u].grant;
+    bool                  valid = false;
+    dci.tb[0].mcs_idx           = grants[u].mcs + 1;
+    while (!valid && dci.tb[0].mcs_idx > 0) {
+      dci.tb[0].mcs_idx--;
+      valid = isrran_ra_dl_dci_to_grant(&cell, &dl_sf, ISRRAN_TM1, false, &dci, grant) == ISRRAN_SUCCESS &&
+              lte_code_rate_valid(&grant->tb[0]);
+    }
+    if (!valid) {
+      ERROR("Error computing DL grant for %d PRB", grants[u].len);
+      return ISRRAN_ERROR;
+    }
+
+    isrran_random_byte_vector(w->random, w->data_tx[u], pdsch_cfg[u].grant.tb[0].tbs / 8);
+    isrran_softbuffer_tx_reset(&w->softbuffer_tx[u]);
+    pdsch_cfg[u].softbuffers.tx[0] = &w->softbuffer_tx[u];
+    pdsch_cfg[u].power_scale       = true;
+    pdsch_cfg[u].p_a               = 0.0f;
+    pdsch_cfg[u].p_b               = 0;
+    pdsch_cfg[u].rnti              = dci.rnti;
+
+    uint8_t* data[ISRRAN_MAX_CODEWORDS] = {w->data_tx[u]};
+    if (isrran_enb_dl_put_pdsch(&w->enb_dl, &pdsch_cfg[u], data) < ISRRAN_SUCCESS) {
+      ERROR("Error putting PDSCH");
+      return ISRRAN_ERROR;
+    }
+  }
+  isrran_enb_dl_gen_signal(&w->enb_dl);
+  stage_end(&w->dl, BENCH_STAGE_ENCODE, &t);
+
+  run_channel(w);
+
+  isrran_ue_dl_cfg_t ue_dl_cfg             = {};
+  ue_dl_cfg.cfg.tm                         = ISRRAN_TM1;
+  ue_dl_cfg.chest_cfg.filter_coef[0]       = 4;
+  ue_dl_cfg.chest_cfg.filter_coef[1]       = 1;
+  ue_dl_cfg.chest_cfg.filter_type          = ISRRAN_CHEST_FILTER_GAUSS;
+  ue_dl_cfg.chest_cfg.noise_alg            = ISRRAN_NOISE_ALG_REFS;
+  ue_dl_cfg.chest_cfg.rsrp_neighbour       = false;
+  ue_dl_cfg.chest_cfg.estimator_alg        = ISRRAN_ESTIMATOR_ALG_AVERAGE;
+  ue_dl_cfg.chest_cfg.cfo_estimate_enable  = false;
+  ue_dl_cfg.chest_cfg.cfo_estimate_sf_mask = false;
+  ue_dl_cfg.chest_cfg.sync_error_enable    = false;
+
+  t = thread_cpu_ns();
+  if (isrran_ue_dl_decode_fft_estimate(&w->ue_dl, &dl_sf, &ue_dl_cfg) < ISRRAN_SUCCESS) {
+    ERROR("Error estimating DL channel");
+    return ISRRAN_ERROR;
+  }
+  stage_end(&w->dl, BENCH_STAGE_FFT, &t);
+
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    isrran_pdsch_cfg_t* cfg = &pdsch_cfg[u];
+    cfg->softbuffers.rx[0]  = &w->softbuffer_rx[u];
+    cfg->decoder_type       = ISRRAN_MIMO_DECODER_MMSE;
+    cfg->max_nof_iterations = 10;
+    isrran_softbuffer_rx_reset(cfg->softbuffers.rx[0]);
+
+    isrran_pdsch_res_t res[ISRRAN_MAX_CODEWORDS] = {};
+    res[0].payload                               = w->data_rx[u];
+    if (isrran_ue_dl_decode_pdsch(&w->ue_dl, &dl_sf, cfg, res) < ISRRAN_SUCCESS) {
+      ERROR("Error decoding PDSCH");
+      return ISRRAN_ERROR;
+    }
+    check_tb(&w->dl, w, u, cfg->grant.tb[0].tbs, res[0].crc);
+  }
+  stage_end(&w->dl, BENCH_STAGE_DECODE, &t);
+
+  return ISRRAN_SUCCESS;
+}
+
+static int bench_ul_lte(bench_worker_t* w, uint32_t slot)
+{
+  bench_grant_t grants[BENCH_MAX_UES] = {};
+  gen_grants(w, true, grants);
+
+  isrran_ul_sf_cfg_t ul_sf = {};
+  ul_sf.tti                = slot % 10240;
+
+  isrran_pusch_hopping_cfg_t hopping                  = {};
+  isrran_ue_ul_cfg_t         ue_ul_cfg[BENCH_MAX_UES] = {};
+  uint32_t                   len                      = buffer_len();
+  uint64_t                   t                        = thread_cpu_ns();
+
+  isrran_vec_cf_zero(w->tx_buffer[0], len);
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    isrran_dci_ul_t dci = {};
+    dci.rnti            = BENCH_RNTI + u;
+    dci.type2_alloc.riv = isrran_ra_type2_to_riv(grants[u].len, grants[u].start, nof_prb);
+    dci.freq_hop_fl     = ISRRAN_RA_PUSCH_HOP_DISABLED;
+    dci.tb.mcs_idx      = grants[u].mcs + 1;
+    dci.tb.rv           = 0;
+    dci.n_dmrs          = 0;
+
+    isrran_pusch_cfg_t* pusch = &ue_ul_cfg[u].ul_cfg.pusch;
+    bool                valid = false;
+    while (!valid && dci.tb.mcs_idx > 0) {
+      dci.tb.mcs_idx--;
+      valid = isrran_ra_ul_dci_to_grant(&cell, &ul_sf, &hopping, &dci, &pusch->grant) == ISRRAN_SUCCESS &&
+              lte_code_rate_valid(&pusch->grant.tb);
+    }
+    if (!valid) {
+      ERROR("Error computing UL grant for %d PRB", grants[u].len);
+      return ISRRAN_ERROR;
+    }
+    pusch->rnti                  = dci.rnti;
+    pusch->enable_64qam          = true;
+    pusch->softbuffers.tx        = &w->softbuffer_tx[u];
+    ue_ul_cfg[u].ul_cfg.dmrs     = dmrs_pusch_cfg;
+    ue_ul_cfg[u].grant_available = true;
+    isrran_softbuffer_tx_reset(pusch->softbuffers.tx);
+    isrran_random_byte_vector(w->random, w->data_tx[u], pusch->grant.tb.tbs / 8);
+
+    isrran_pusch_data_t data = {};
+    data.ptr                 = w->data_tx[u];
+    if (isrran_ue_ul_encode(&w->ue_ul, &ul_sf, &ue_ul_cfg[u], &data) < ISRRAN_SUCCESS) {
+      ERROR("Error encoding PUSCH");
+      return ISRRAN_ERROR;
+    }
+    isrran_vec_sum_ccc(w->tx_buffer[0], w->ue_ul_buffer, w->tx_buffer[0], len);
+  }
+  stage_end(&w->ul, BENCH_STAGE_ENCODE, &t);
+
+  run_channel(w);
+
+  t = thread_cpu_ns();
+  isrran_enb_ul_fft(&w->enb_ul);
+  stage_end(&w->ul, BENCH_STAGE_FFT, &t);
+
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    isrran_pusch_cfg_t* cfg = &ue_ul_cfg[u].ul_cfg.pusch;
+    cfg->softbuffers.rx     = &w->softbuffer_rx[u];
+    cfg->max_nof_iterations = 10;
+    isrran_softbuffer_rx_reset(cfg->softbuffers.rx);
+
+    isrran_pusch_res_t res = {};
+    res.data               = w->data_rx[u];
+    if (isrran_enb_ul_get_pusch(&w->enb_ul, &ul_sf, cfg, &res) < ISRRAN_SUCCESS) {
+      ERROR("Error decoding PUSCH");
+      return ISRRAN_ERROR;
+    }
+    check_tb(&w->ul, w, u, cfg->grant.tb.tbs, res.crc);
+  }
+  stage_end(&w->ul, BENCH_STAGE_DECODE, &t);
+
+  return ISRRAN_SUCCESS;
+}
+
+static void sch_cfg_nr(isrran_sch_cfg_nr_t* cfg, uint32_t ue)
+{
+  cfg->dmrs.type                              = isrran_dmrs_sch_type_1;
+  cfg->dmrs.typeA_pos                         = isrran_dmrs_sch_typeA_pos_2;
+  cfg->dmrs.additional_pos                    = isrran_dmrs_sch_add_pos_2;
+  cfg->grant.nof_dmrs_cdm_groups_without_data = 1;
+  cfg->grant.rnti_type                        = isrran_rnti_type_c;
+  cfg->grant.rnti                             = BENCH_RNTI + ue;
+}
+
+static void prb_idx_nr(isrran_sch_grant_nr_t* grant, const bench_grant_t* g)
+{
+  for (uint32_t n = 0; n < ISRRAN_MAX_PRB_NR; n++) {
+    grant->prb_idx[n] = (n >= g->start && n < g->start + g->len);
+  }
+  grant->nof_prb = g->len;
+}
+
+static int bench_dl_nr(bench_worker_t* w, uint32_t slot)
+{
+  bench_grant_t grants[BENCH_MAX_UES] = {};
+  gen_grants(w, false, grants);
+
+  isrran_slot_cfg_t   slot_cfg                 = {.idx = slot};
+  isrran_sch_cfg_nr_t pdsch_cfg[BENCH_MAX_UES] = {};
+  uint64_t            t                        = thread_cpu_ns();
+
+  if (isrran_gnb_dl_base_zero(&w->gnb_dl) < ISRRAN_SUCCESS) {
+    ERROR("Error zeroing DL grid");
+    return ISRRAN_ERROR;
+  }
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    isrran_sch_cfg_nr_t* cfg = &pdsch_cfg[u];
+    sch_cfg_nr(cfg, u);
+    cfg->grant.S          = 1;
+    cfg->grant.L          = 13;
+    cfg->grant.nof_layers = 1;
+    cfg->grant.dci_format = isrran_dci_format_nr_1_0;
+    cfg->grant.beta_dmrs  = isrran_convert_dB_to_amplitude(3);
+    prb_idx_nr(&cfg->grant, &grants[u]);
+    if (isrran_ra_nr_fill_tb(cfg, &cfg->grant, grants[u].mcs, &cfg->grant.tb[0]) < ISRRAN_SUCCESS) {
+      ERROR("Error filling DL TB for %d PRB and MCS %d", grants[u].len, grants[u].mcs);
+      return ISRRAN_ERROR;
+    }
+
+    isrran_random_byte_vector(w->random, w->data_tx[u], cfg->grant.tb[0].tbs / 8);
+    isrran_softbuffer_tx_reset(&w->softbuffer_tx[u]);
+    cfg->grant.tb[0].softbuffer.tx = &w->softbuffer_tx[u];
+
+    uint8_t* data[ISRRAN_MAX_TB] = {w->data_tx[u]};
+    if (isrran_gnb_dl_pdsch_put(&w->gnb_dl, &slot_cfg, cfg, data) < ISRRAN_SUCCESS) {
+      ERROR("Error putting PDSCH");
+      return ISRRAN_ERROR;
+    }
+  }
+  isrran_gnb_dl_gen_signal(&w->gnb_dl);
+  stage_end(&w->dl, BENCH_STAGE_ENCODE, &t);
+
+  run_channel(w);
+
+  t = thread_cpu_ns();
+  isrran_ue_dl_nr_estimate_fft(&w->ue_dl_nr, &slot_cfg);
+  stage_end(&w->dl, BENCH_STAGE_FFT, &t);
+
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    isrran_sch_cfg_nr_t* cfg       = &pdsch_cfg[u];
+    cfg->grant.tb[0].softbuffer.rx = &w->softbuffer_rx[u];
+    isrran_softbuffer_rx_reset(cfg->grant.tb[0].softbuffer.rx);
+
+    isrran_pdsch_res_nr_t res = {};
+    res.tb[0].payload         = w->data_rx[u];
+    if (isrran_ue_dl_nr_decode_pdsch(&w->ue_dl_nr, &slot_cfg, cfg, &res) < ISRRAN_SUCCESS) {
+      ERROR("Error decoding PDSCH");
+      return ISRRAN_ERROR;
+    }
+    check_tb(&w->dl, w, u, cfg->grant.tb[0].tbs, res.tb[0].crc);
+  }
+  stage_end(&w->dl, BENCH_STAGE_DECODE, &t);
+
+  return ISRRAN_SUCCESS;
+}
+
+static int bench_ul_nr(bench_worker_t* w, uint32_t slot)
+{
+  bench_grant_t grants[BENCH_MAX_UES] = {};
+  gen_grants(w, true, grants);
+
+  isrran_slot_cfg_t   slot_cfg                 = {.idx = slot};
+  isrran_sch_cfg_nr_t pusch_cfg[BENCH_MAX_UES] = {};
+  uint32_t            len                      = buffer_len();
+  uint64_t            t                        = thread_cpu_ns();
+
+  isrran_vec_cf_zero(w->tx_buffer[0], len);
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    isrran_sch_cfg_nr_t* cfg = &pusch_cfg[u];
+    if (isrran_ra_ul_nr_pusch_time_resource_default_A(carrier.scs, 0, &cfg->grant) < ISRRAN_SUCCESS) {
+      ERROR("Error setting PUSCH time resource");
+      return ISRRAN_ERROR;
+    }
+    sch_cfg_nr(cfg, u);
+    cfg->grant.nof_layers = 1;
+    cfg->grant.dci_format = isrran_dci_format_nr_0_0;
+    prb_idx_nr(&cfg->grant, &grants[u]);
+    if (isrran_ra_nr_fill_tb(cfg, &cfg->grant, grants[u].mcs, &cfg->grant.tb[0]) < ISRRAN_SUCCESS) {
+      ERROR("Error filling UL TB for %d PRB and MCS %d", grants[u].len, grants[u].mcs);
+      return ISRRAN_ERROR;
+    }
+
+    isrran_random_byte_vector(w->random, w->data_tx[u], cfg->grant.tb[0].tbs / 8);
+    isrran_softbuffer_tx_reset(&w->softbuffer_tx[u]);
+    cfg->grant.tb[0].softbuffer.tx = &w->softbuffer_tx[u];
+
+    isrran_pusch_data_nr_t data = {};
+    data.payload[0]             = w->data_tx[u];
+    if (isrran_ue_ul_nr_encode_pusch(&w->ue_ul_nr, &slot_cfg, cfg, &data) < ISRRAN_SUCCESS) {
+      ERROR("Error encoding PUSCH");
+      return ISRRAN_ERROR;
+    }
+    isrran_vec_sum_ccc(w->tx_buffer[0], w->ue_ul_buffer, w->tx_buffer[0], len);
+  }
+  stage_end(&w->ul, BENCH_STAGE_ENCODE, &t);
+
+  run_channel(w);
+
+  t = thread_cpu_ns();
+  if (isrran_gnb_ul_fft(&w->gnb_ul) < ISRRAN_SUCCESS) {
+    ERROR("Error running UL FFT");
+    return ISRRAN_ERROR;
+  }
+  stage_end(&w->ul, BENCH_STAGE_FFT, &t);
+
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    isrran_sch_cfg_nr_t* cfg       = &pusch_cfg[u];
+    cfg->grant.tb[0].softbuffer.rx = &w->softbuffer_rx[u];
+    isrran_softbuffer_rx_reset(cfg->grant.tb[0].softbuffer.rx);
+
+    isrran_pusch_res_nr_t res = {};
+    res.tb[0].payload         = w->data_rx[u];
+    if (isrran_gnb_ul_get_pusch(&w->gnb_ul, &slot_cfg, cfg, &cfg->grant, &res) < ISRRAN_SUCCESS) {
+      ERROR("Error decoding PUSCH");
+      return ISRRAN_ERROR;
+    }
+    check_tb(&w->ul, w, u, cfg->grant.tb[0].tbs, res.tb[0].crc);
+  }
+  stage_end(&w->ul, BENCH_STAGE_DECODE, &t);
+
+  return ISRRAN_SUCCESS;
+}
+
+static int worker_init_lte(bench_worker_t* w)
+{
+  if (isrran_enb_dl_init(&w->enb_dl, w->tx_buffer, nof_prb) || isrran_enb_dl_set_cell(&w->enb_dl, cell)) {
+    ERROR("Error initiating eNb DL");
+    return ISRRAN_ERROR;
+  }
+  if (isrran_ue_dl_init(&w->ue_dl, w->rx_buffer, nof_prb, 1) || isrran_ue_dl_set_cell(&w->ue_dl, cell)) {
+    ERROR("Error initiating UE DL");
+    return ISRRAN_ERROR;
+  }
+  if (isrran_ue_ul_init(&w->ue_ul, w->ue_ul_buffer, nof_prb) || isrran_ue_ul_set_cell(&w->ue_ul, cell)) {
+    ERROR("Error initiating UE UL");
+    return ISRRAN_ERROR;
+  }
+  if (isrran_enb_ul_init(&w->enb_ul, w->rx_buffer[0], nof_prb) ||
+      isrran_enb_ul_set_cell(&w->enb_ul, cell, &dmrs_pusch_cfg, NULL)) {
+    ERROR("Error initiating eNb UL");
+    return ISRRAN_ERROR;
+  }
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    if (isrran_softbuffer_tx_init(&w->softbuffer_tx[u], nof_prb) ||
+        isrran_softbuffer_rx_init(&w->softbuffer_rx[u], nof_prb)) {
+      ERROR("Error initiating softbuffers");
+      return ISRRAN_ERROR;
+    }
+  }
+  return ISRRAN_SUCCESS;
+}
+
+static int worker_init_nr(bench_worker_t* w)
+{
+  isrran_gnb_dl_args_t gnb_dl_args = {};
+  gnb_dl_args.nof_tx_antennas      = 1;
+  gnb_dl_args.nof_max_prb          = nof_prb;
+  gnb_dl_args.srate_hz             = ISRRAN_SUBC_SPACING_NR(carrier.scs) * isrran_min_symbol_sz_rb(nof_prb);
+  gnb_dl_args.pdsch.max_prb        = nof_prb;
+  gnb_dl_args.pdsch.max_layers     = 1;
+  if (isrran_gnb_dl_init(&w->gnb_dl, w->tx_buffer, &gnb_dl_args) || isrran_gnb_dl_set_carrier(&w->gnb_dl, &carrier)) {
+    ERROR("Error initiating gNb DL");
+    return ISRRAN_ERROR;
+  }
+
+  isrran_ue_dl_nr_args_t ue_dl_args = {};
+  ue_dl_args.nof_rx_antennas        = 1;
+  ue_dl_args.nof_max_prb            = nof_prb;
+  ue_dl_args.pdsch.max_prb          = nof_prb;
+  ue_dl_args.pdsch.max_layers       = 1;
+  if (isrran_ue_dl_nr_init(&w->ue_dl_nr, w->rx_buffer, &ue_dl_args) ||
+      isrran_ue_dl_nr_set_carrier(&w->ue_dl_nr, &carrier)) {
+    ERROR("Error initiating UE DL NR");
+    return ISRRAN_ERROR;
+  }
+
+  isrran_ue_ul_nr_args_t ue_ul_args = {};
+  ue_ul_args.nof_max_prb            = nof_prb;
+  ue_ul_args.pusch.max_prb          = nof_prb;
+  ue_ul_args.pusch.max_layers       = 1;
+  if (isrran_ue_ul_nr_init(&w->ue_ul_nr, w->ue_ul_buffer, &ue_ul_args) ||
+      isrran_ue_ul_nr_set_carrier(&w->ue_ul_nr, &carrier)) {
+    ERROR("Error initiating UE UL NR");
+    return ISRRAN_ERROR;
+  }
+
+  isrran_gnb_ul_args_t gnb_ul_args = {};
+  gnb_ul_args.nof_max_prb          = nof_prb;
+  gnb_ul_args.pusch.max_prb        = nof_prb;
+  gnb_ul_args.pusch.max_layers     = 1;
+  gnb_ul_args.pusch_min_snr_dB     = -10.0f;
+  if (isrran_gnb_ul_init(&w->gnb_ul, w->rx_buffer[0], &gnb_ul_args) ||
+      isrran_gnb_ul_set_carrier(&w->gnb_ul, &carrier)) {
+    ERROR("Error initiating gNb UL");
+    return ISRRAN_ERROR;
+  }
+
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    if (isrran_softbuffer_tx_init_guru(
+            &w->softbuffer_tx[u], ISRRAN_SCH_NR_MAX_NOF_CB_LDPC, ISRRAN_LDPC_MAX_LEN_ENCODED_CB) ||
+        isrran_softbuffer_rx_init_guru(
+            &w->softbuffer_rx[u], ISRRAN_SCH_NR_MAX_NOF_CB_LDPC, ISRRAN_LDPC_MAX_LEN_ENCODED_CB)) {
+      ERROR("Error initiating softbuffers");
+      return ISRRAN_ERROR;
+    }
+  }
+  return ISRRAN_SUCCESS;
+}
+
+static int worker_init(bench_worker_t* w, uint32_t id)
+{
+  w->id     = id;
+  w->random = isrran_random_init(seed + id);
+  if (w->random == NULL || isrran_channel_awgn_init(&w->awgn, seed + id)) {
+    ERROR("Error initiating random generators");
+    return ISRRAN_ERROR;
+  }
+
+  // Single antenna port at both ends
+  uint32_t len    = buffer_len();
+  w->tx_buffer[0] = isrran_vec_cf_malloc(len);
+  w->rx_buffer[0] = isrran_vec_cf_malloc(len);
+  w->ue_ul_buffer = isrran_vec_cf_malloc(len);
+  if (w->tx_buffer[0] == NULL || w->rx_buffer[0] == NULL || w->ue_ul_buffer == NULL) {
+    ERROR("Error allocating buffers");
+    return ISRRAN_ERROR;
+  }
+
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    w->data_tx[u] = isrran_vec_u8_malloc(BENCH_MAX_TB_BYTES);
+    w->data_rx[u] = isrran_vec_u8_malloc(BENCH_MAX_TB_BYTES);
+    if (w->data_tx[u] == NULL || w->data_rx[u] == NULL) {
+      ERROR("Error allocating data buffers");
+      return ISRRAN_ERROR;
+    }
+  }
+
+  return is_nr ? worker_init_nr(w) : worker_init_lte(w);
+}
+
+static void worker_free(bench_worker_t* w)
+{
+  if (is_nr) {
+    isrran_gnb_dl_free(&w->gnb_dl);
+    isrran_ue_dl_nr_free(&w->ue_dl_nr);
+    isrran_ue_ul_nr_free(&w->ue_ul_nr);
+    isrran_gnb_ul_free(&w->gnb_ul);
+  } else {
+    isrran_enb_dl_free(&w->enb_dl);
+    isrran_ue_dl_free(&w->ue_dl);
+    isrran_ue_ul_free(&w->ue_ul);
+    isrran_enb_ul_free(&w->enb_ul);
+  }
+  for (uint32_t u = 0; u < nof_ues; u++) {
+    isrran_softbuffer_tx_free(&w->softbuffer_tx[u]);
+    isrran_softbuffer_rx_free(&w->softbuffer_rx[u]);
+    free(w->data_tx[u]);
+    free(w->data_rx[u]);
+  }
+  for (uint32_t p = 0; p < ISRRAN_MAX_PORTS; p++) {
+    free(w->tx_buffer[p]);
+    free(w->rx_buffer[p]);
+  }
+  free(w->ue_ul_buffer);
+  isrran_channel_awgn_free(&w->awgn);
+  if (w->random) {
+    isrran_random_free(w->random);
+  }
+}
+
+static void* worker_run(void* arg)
+{
+  bench_worker_t* w = (bench_worker_t*)arg;
+
+  for (uint32_t slot = w->slot_begin; slot < w->slot_end && w->ret == ISRRAN_SUCCESS; slot++) {
+    if (run_dl) {
+      w->ret = is_nr ? bench_dl_nr(w, slot) : bench_dl_lte(w, slot);
+      w->dl.nof_slots++;
+    }
+    if (run_ul && w->ret == ISRRAN_SUCCESS) {
+      w->ret = is_nr ? bench_ul_nr(w, slot) : bench_ul_lte(w, slot);
+      w->ul.nof_slots++;
+    }
+  }
+
+  return NULL;
+}
+
+static void stats_add(bench_stats_t* total, const bench_stats_t* s)
+{
+  total->nof_slots += s->nof_slots;
+  total->nof_tb += s->nof_tb;
+  total->nof_tb_errors += s->nof_tb_errors;
+  total->nof_bits += s->nof_bits;
+  total->nof_bits_ok += s->nof_bits_ok;
+  for (uint32_t i = 0; i < BENCH_NOF_STAGES; i++) {
+    total->cpu_ns[i] += s->cpu_ns[i];
+  }
+}
+
+static void print_stats(FILE* f, const char* name, const bench_stats_t* s, double slot_duration_s, bool last)
+{
+  uint64_t cpu_ns = 0;
+  for (uint32_t i = 0; i < BENCH_NOF_STAGES; i++) {
+    cpu_ns += s->cpu_ns[i];
+  }
+  double nof_slots = ISRRAN_MAX(1, s->nof_slots);
+
+  fprintf(f, "  \"%s\": {\n", name);
+  fprintf(f, "    \"nof_tb\": %" PRIu64 ",\n", s->nof_tb);
+  fprintf(f, "    \"nof_tb_errors\": %" PRIu64 ",\n", s->nof_tb_errors);
+  fprintf(f, "    \"bler\": %.6f,\n", s->nof_tb ? (double)s->nof_tb_errors / s->nof_tb : 0.0);
+  fprintf(f, "    \"granted_mbps\": %.3f,\n", s->nof_bits / (nof_slots * slot_duration_s) / 1e6);
+  fprintf(f, "    \"processed_mbps\": %.3f,\n", cpu_ns ? s->nof_bits_ok * 1e3 / cpu_ns : 0.0);
+  fprintf(f, "    \"cpu_us_per_slot\": {\n");
+  for (uint32_t i = 0; i < BENCH_NOF_STAGES; i++) {
+    fprintf(f, "      \"%s\": %.3f,\n", bench_stage_names[i], s->cpu_ns[i] / 1e3 / nof_slots);
+  }
+  fprintf(f, "      \"total\": %.3f\n", cpu_ns / 1e3 / nof_slots);
+  fprintf(f, "    }\n");
+  fprintf(f, "  }%s\n", last ? "" : ",");
+}
+
+int main(int argc, char** argv)
+{
+  int              ret     = ISRRAN_ERROR;
+  bench_worker_t** workers = NULL;
+  pthread_t*       threads = NULL;
+  FILE*            f       = stdout;
+
+  if (parse_args(argc, argv) < ISRRAN_SUCCESS) {
+    return ISRRAN_ERROR;
+  }
+
+  cell.nof_prb    = nof_prb;
+  carrier.nof_prb = nof_prb;
+
+  workers = calloc(nof_threads, sizeof(bench_worker_t*));
+  threads = calloc(nof_threads, sizeof(pthread_t));
+  if (workers == NULL || threads == NULL) {
+    ERROR("Error allocating workers");
+    goto clean_exit;
+  }
+
+  // The PHY objects are initialised sequentially, FFT planning is not thread safe
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    workers[i] = isrran_vec_malloc(sizeof(bench_worker_t));
+    if (workers[i] == NULL) {
+      ERROR("Error allocating worker");
+      goto clean_exit;
+    }
+    memset(workers[i], 0, sizeof(bench_worker_t));
+    workers[i]->slot_begin = (nof_slots * i) / nof_threads;
+    workers[i]->slot_end   = (nof_slots * (i + 1)) / nof_threads;
+    if (worker_init(workers[i], i) < ISRRAN_SUCCESS) {
+      goto clean_exit;
+    }
+  }
+
+  struct timespec start = {}, end = {};
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    if (pthread_create(&threads[i], NULL, worker_run, workers[i])) {
+      ERROR("Error creating thread");
+      nof_threads = i;
+      goto clean_exit;
+    }
+  }
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double wall_s = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+  bench_stats_t dl = {}, ul = {};
+  bool          failed = false;
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    stats_add(&dl, &workers[i]->dl);
+    stats_add(&ul, &workers[i]->ul);
+    failed |= workers[i]->ret != ISRRAN_SUCCESS;
+  }
+
+  if (output_file) {
+    f = fopen(output_file, "w");
+    if (f == NULL) {
+      ERROR("Error opening %s", output_file);
+      goto clean_exit;
+    }
+  }
+
+  double slot_duration_s = is_nr ? 1e-3 / (1U << (uint32_t)carrier.scs) : 1e-3;
+  fprintf(f, "{\n");
+  fprintf(f, "  \"rat\": \"%s\",\n", is_nr ? "nr" : "lte");
+  fprintf(f, "  \"nof_prb\": %d,\n", nof_prb);
+  fprintf(f, "  \"nof_ues\": %d,\n", nof_ues);
+  fprintf(f, "  \"mcs_min\": %d,\n", mcs_min);
+  fprintf(f, "  \"mcs_max\": %d,\n", mcs_max);
+  fprintf(f, "  \"nof_threads\": %d,\n", nof_threads);
+  fprintf(f, "  \"nof_slots\": %d,\n", nof_slots);
+  if (!isnan(snr_db)) {
+    fprintf(f, "  \"snr_db\": %.1f,\n", snr_db);
+  } else {
+    fprintf(f, "  \"snr_db\": null,\n");
+  }
+  fprintf(f, "  \"wall_s\": %.6f,\n", wall_s);
+  fprintf(f, "  \"realtime_factor\": %.3f%s\n", nof_slots * slot_duration_s / wall_s, run_dl || run_ul ? "," : "");
+  if (run_dl) {
+    print_stats(f, "dl", &dl, slot_duration_s, !run_ul);
+  }
+  if (run_ul) {
+    print_stats(f, "ul", &ul, slot_duration_s, true);
+  }
+  fprintf(f, "}\n");
+  if (f != stdout) {
+    fclose(f);
+  }
+
+  // Without noise every transport block must be decoded
+  if (failed) {
+    ERROR("Benchmark aborted");
+  } else if (isnan(snr_db) && (dl.nof_tb_errors || ul.nof_tb_errors)) {
+    ERROR("Failed to decode %" PRIu64 " DL and %" PRIu64 " UL transport blocks without noise",
+          dl.nof_tb_errors,
+          ul.nof_tb_errors);
+  } else {
+    ret = ISRRAN_SUCCESS;
+  }
+
+clean_exit:
+  if (workers) {
+    for (uint32_t i = 0; i < nof_threads; i++) {
+      if (workers[i]) {
+        worker_free(workers[i]);
+        free(workers[i]);
+      }
+    }
+    free(workers);
+  }
+  free(threads);
+
+  return ret;
+}
@@ -45,6 +45,7 @@ static uint32_t mcs                     = 20;
 static int      cross_carrier_indicator = -1;
 static bool     enable_256qam           = false;
 static float    snr_db                  = NAN; // SNR in dB
+static bool     share_estimate          = false;
 
 void usage(char* prog)
 {
@@ -58,6 +59,7 @@ void usage(char* prog)
   printf("\t-t Transmission mode: 1,2,3,4 [Default %d]\n", transmission_mode + 1);
   printf("\t-m mcs [Default %d]\n", mcs);
   printf("\t-S SNR in dB [Default %+.2f]\n", snr_db);
+  printf("\t-g Decode from an estimate copied from another UE [Default %s]\n", share_estimate ? "yes" : "no");
   printf("\tAdvanced parameters:\n");
   if (cross_carrier_indicator >= 0) {
     printf("\t\t-a carrier-indicator [Default %d]\n", cross_carrier_indicator);
@@ -96,7 +98,7 @@ void parse_args(int argc, char** argv)
     nof_rx_ant     = 2;
   }
 
-  while ((opt = getopt(argc, argv, "cfapndvqstmES")) != -1) {
+  while ((opt = getopt(argc, argv, "cfapndvqstmESg")) != -1) {
     switch (opt) {
       case 't':
         transmission_mode = (uint32_t)strtol(argv[optind], NULL, 10) - 1;
@@ -142,6 +144,9 @@ void parse_args(int argc, char** argv)
       case 'q':
         enable_256qam = (enable_256qam) ? false : true;
         break;
+      case 'g':
+        share_estimate = true;
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -201,13 +206,24 @@ quit:
 }
 
 int work_ue(isrran_ue_dl_t*     ue_dl,
+            isrran_ue_dl_t*     ue_dl_host,
             isrran_dl_sf_cfg_t* sf_cfg_dl,
             isrran_ue_dl_cfg_t* ue_dl_cfg,
             isrran_dci_dl_t*    dci_dl,
             uint32_t            sf_idx,
             isrran_pdsch_res_t  pdsch_res[ISRRAN_MAX_CODEWORDS])
 {
-  if (isrran_ue_dl_decode_fft_estimate(ue_dl, sf_cfg_dl, ue_dl_cfg) < 0) {
+  if (ue_dl_host) {
+    // Demodulate in the host and decode from its estimate
+    if (isrran_ue_dl_decode_fft_estimate(ue_dl_host, sf_cfg_dl, ue_dl_cfg) < 0) {
+      ERROR("Getting host PDCCH FFT estimate sf_idx=%d", sf_idx);
+      return ISRRAN_ERROR;
+    }
+    if (isrran_ue_dl_copy_estimate(ue_dl, ue_dl_host, sf_cfg_dl) < 0) {
+      ERROR("Copying host estimate sf_idx=%d", sf_idx);
+      return ISRRAN_ERROR;
+    }
+  } else if (isrran_ue_dl_decode_fft_estimate(ue_dl, sf_cfg_dl, ue_dl_cfg) < 0) {
     ERROR("Getting PDCCH FFT estimate sf_idx=%d", sf_idx);
     return ISRRAN_ERROR;
   }
@@ -320,6 +336,7 @@ int main(int argc, char** argv)
 {
   isrran_enb_dl_t*        enb_dl      = isrran_vec_malloc(sizeof(isrran_enb_dl_t));
   isrran_ue_dl_t*         ue_dl       = isrran_vec_malloc(sizeof(isrran_ue_dl_t));
+  isrran_ue_dl_t*         ue_dl_host  = NULL;
   isrran_random_t         random      = isrran_random_init(0);
   struct timeval          t[3]        = {};
   size_t                  tx_nof_bits = 0, rx_nof_bits = 0;
@@ -428,6 +445,19 @@ int main(int argc, char** argv)
     goto quit;
   }
 
+  if (share_estimate) {
+    ue_dl_host = isrran_vec_malloc(sizeof(isrran_ue_dl_t));
+    if (!ue_dl_host || isrran_ue_dl_init(ue_dl_host, signal_buffer, cell.nof_prb, nof_rx_ant)) {
+      ERROR("Error initiating host UE downlink");
+      goto quit;
+    }
+
+    if (isrran_ue_dl_set_cell(ue_dl_host, cell)) {
+      ERROR("Error setting host UE downlink cell");
+      goto quit;
+    }
+  }
+
   /*
    * Create PDCCH Allocations
    */
@@ -617,7 +647,7 @@ int main(int argc, char** argv)
       pdsch_res[i].crc                      = false;
       ue_dl_cfg.cfg.pdsch.softbuffers.rx[i] = softbuffer_rx[i];
     }
-    if (work_ue(ue_dl, &sf_cfg_dl, &ue_dl_cfg, dci_dl, sf_idx, pdsch_res)) {
+    if (work_ue(ue_dl, ue_dl_host, &sf_cfg_dl, &ue_dl_cfg, dci_dl, sf_idx, pdsch_res)) {
       goto quit;
     }
 
@@ -711,6 +741,10 @@ quit:
   if (ue_dl) {
     free(ue_dl);
   }
+  if (ue_dl_host) {
+    isrran_ue_dl_free(ue_dl_host);
+    free(ue_dl_host);
+  }
   isrran_channel_awgn_free(&awgn);
 
   if (ret) {
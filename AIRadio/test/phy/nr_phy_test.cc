@@ -94,6 +94,7 @@ test_bench::args_t::args_t(int argc, char** argv)
         ("gnb.phy.log.hex_limit",   bpo::value<int>(&gnb_phy.log.phy_hex_limit)->default_value(0),             "gNb PHY log hex limit")
         ("gnb.phy.log.id_preamble", bpo::value<std::string>(&gnb_phy.log.id_preamble)->default_value("GNB/"),  "gNb PHY log ID preamble")
         ("gnb.phy.pusch.max_iter",  bpo::value<uint32_t>(&gnb_phy.pusch_max_its)->default_value(10),      "PUSCH LDPC max number of iterations")
+        ("gnb.phy.nof_ul_threads",  bpo::value<uint32_t>(&gnb_phy.nof_ul_threads)->default_value(0),      "Number of UL threads, enables pipelined UL/DL processing if not zero")
         ;
 
   options_ue_phy.add_options()